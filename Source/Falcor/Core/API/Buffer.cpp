@@ -383,14 +383,8 @@ cuda_utils::ExternalMemory* Buffer::getCudaMemory() const
 }
 #endif
 
-inline pybind11::ndarray<pybind11::numpy> buffer_to_numpy(const Buffer& self)
+inline pybind11::ndarray<pybind11::numpy> buffer_ndarray(const Buffer& self, void* cpuData, pybind11::handle owner)
 {
-    size_t bufferSize = self.getSize();
-    void* cpuData = new uint8_t[bufferSize];
-    self.getBlob(cpuData, 0, bufferSize);
-
-    pybind11::capsule owner(cpuData, [](void* p) noexcept { delete[] reinterpret_cast<uint8_t*>(p); });
-
     if (auto dtype = resourceFormatToDtype(self.getFormat()))
     {
         uint32_t channelCount = getFormatChannelCount(self.getFormat());
@@ -407,13 +401,38 @@ inline pybind11::ndarray<pybind11::numpy> buffer_to_numpy(const Buffer& self)
     }
     else
     {
-        pybind11::size_t shape[1] = {bufferSize};
+        pybind11::size_t shape[1] = {self.getSize()};
         return pybind11::ndarray<pybind11::numpy>(
             cpuData, 1, shape, owner, nullptr, pybind11::dtype<uint8_t>(), pybind11::device::cpu::value
         );
     }
 }
 
+inline pybind11::ndarray<pybind11::numpy> buffer_to_numpy(const Buffer& self, bool copy)
+{
+    if (!copy)
+    {
+        // Zero-copy view of the mapped memory. The capsule holds a reference to the buffer,
+        // the view becomes invalid if the buffer is explicitly unmapped.
+        FALCOR_CHECK(
+            self.getMemoryType() == MemoryType::ReadBack || self.getMemoryType() == MemoryType::Upload,
+            "Zero-copy views are only supported for buffers created with MemoryType::ReadBack or MemoryType::Upload."
+        );
+        void* cpuData = self.map();
+        pybind11::capsule owner(
+            new ref<Buffer>(const_cast<Buffer*>(&self)), [](void* p) noexcept { delete reinterpret_cast<ref<Buffer>*>(p); }
+        );
+        return buffer_ndarray(self, cpuData, owner);
+    }
+
+    size_t bufferSize = self.getSize();
+    void* cpuData = new uint8_t[bufferSize];
+    self.getBlob(cpuData, 0, bufferSize);
+
+    pybind11::capsule owner(cpuData, [](void* p) noexcept { delete[] reinterpret_cast<uint8_t*>(p); });
+    return buffer_ndarray(self, cpuData, owner);
+}
+
 inline void buffer_from_numpy(Buffer& self, pybind11::ndarray<pybind11::numpy> data)
 {
     FALCOR_CHECK(isNdarrayContiguous(data), "numpy array is not contiguous");
@@ -478,7 +497,8 @@ FALCOR_SCRIPT_BINDING(Buffer)
     buffer.def_property_readonly("element_count", &Buffer::getElementCount);
     buffer.def_property_readonly("struct_size", &Buffer::getStructSize);
 
-    buffer.def("to_numpy", buffer_to_numpy);
+    // The returned arrays reference memory kept alive by their owner capsule, numpy doesn't need to copy them again.
+    buffer.def("to_numpy", buffer_to_numpy, "copy"_a = true, pybind11::return_value_policy::reference);
     buffer.def("from_numpy", buffer_from_numpy, "data"_a);
 #if FALCOR_HAS_CUDA
     buffer.def("to_torch", buffer_to_torch, "shape"_a, "dtype"_a = DataType::float32);
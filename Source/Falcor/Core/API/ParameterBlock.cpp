@@ -252,9 +252,11 @@ ParameterBlock::~ParameterBlock() {}
 ParameterBlock::ParameterBlock(ref<Device> pDevice, const ref<const ProgramReflection>& pReflector)
     : mpDevice(pDevice.get()), mpProgramVersion(pReflector->getProgramVersion()), mpReflector(pReflector->getDefaultParameterBlock())
 {
-    FALCOR_GFX_CALL(mpDevice->getGfxDevice()->createMutableRootShaderObject(
-        pReflector->getProgramVersion()->getKernels(mpDevice, nullptr)->getGfxProgram(), mpShaderObject.writeRef()
-    ));
+    {
+        auto pKernels = mpProgramVersion->getKernels(mpDevice, nullptr);
+        auto lock = mpProgramVersion->lockSlangSession();
+        FALCOR_GFX_CALL(mpDevice->getGfxDevice()->createMutableRootShaderObject(pKernels->getGfxProgram(), mpShaderObject.writeRef()));
+    }
     initializeResourceBindings();
     createConstantBuffers(getRootVar());
 }
@@ -266,9 +268,12 @@ ParameterBlock::ParameterBlock(
 )
     : mpDevice(pDevice.get()), mpProgramVersion(pProgramVersion), mpReflector(pReflection)
 {
-    FALCOR_GFX_CALL(mpDevice->getGfxDevice()->createMutableShaderObjectFromTypeLayout(
-        pReflection->getElementType()->getSlangTypeLayout(), mpShaderObject.writeRef()
-    ));
+    {
+        auto lock = mpProgramVersion ? mpProgramVersion->lockSlangSession() : std::unique_lock<std::mutex>();
+        FALCOR_GFX_CALL(mpDevice->getGfxDevice()->createMutableShaderObjectFromTypeLayout(
+            pReflection->getElementType()->getSlangTypeLayout(), mpShaderObject.writeRef()
+        ));
+    }
     initializeResourceBindings();
     createConstantBuffers(getRootVar());
 }
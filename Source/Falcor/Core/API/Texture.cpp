@@ -38,6 +38,7 @@
 #include "Utils/Threading.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Image/ImageIO.h"
+#include "Utils/Image/TextureAnalyzer.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Scripting/ndarray.h"
 #include "Core/Pass/FullScreenPass.h"
@@ -367,9 +368,13 @@ ref<Texture> Texture::createFromFile(
     bool generateMipLevels,
     bool loadAsSrgb,
     ResourceBindFlags bindFlags,
-    Bitmap::ImportFlags importFlags
+    Bitmap::ImportFlags importFlags,
+    std::optional<TextureAnalysisResult>* pAnalysis
 )
 {
+    if (pAnalysis)
+        *pAnalysis = std::nullopt;
+
     if (!std::filesystem::exists(path))
     {
         logWarning("Error when loading image file. File '{}' does not exist.", path);
@@ -399,12 +404,23 @@ ref<Texture> Texture::createFromFile(
                 texFormat = linearToSrgbFormat(texFormat);
             }
 
+            // Analyze the decoded image while it is still in CPU memory.
+            // Textures that are constant in all channels are uploaded as a single texel, sampling it returns the same value.
+            bool isConstant = false;
+            if (pAnalysis)
+            {
+                *pAnalysis = TextureAnalyzer::analyzeImage(
+                    pBitmap->getData(), pBitmap->getWidth(), pBitmap->getHeight(), pBitmap->getRowPitch(), texFormat
+                );
+                isConstant = *pAnalysis && (*pAnalysis)->isConstant(TextureChannelFlags::RGBA);
+            }
+
             pTex = pDevice->createTexture2D(
-                pBitmap->getWidth(),
-                pBitmap->getHeight(),
+                isConstant ? 1 : pBitmap->getWidth(),
+                isConstant ? 1 : pBitmap->getHeight(),
                 texFormat,
                 1,
-                generateMipLevels ? Texture::kMaxPossible : 1,
+                (generateMipLevels && !isConstant) ? Texture::kMaxPossible : 1,
                 pBitmap->getData(),
                 bindFlags
             );
@@ -841,7 +857,8 @@ FALCOR_SCRIPT_BINDING(Texture)
     texture.def_property_readonly("array_size", &Texture::getArraySize);
     texture.def_property_readonly("sample_count", &Texture::getSampleCount);
 
-    texture.def("to_numpy", texture_to_numpy, "mip_level"_a = 0, "array_slice"_a = 0);
+    // The returned array owns its memory through a capsule, numpy doesn't need to copy it again.
+    texture.def("to_numpy", texture_to_numpy, "mip_level"_a = 0, "array_slice"_a = 0, pybind11::return_value_policy::reference);
     texture.def("from_numpy", texture_from_numpy, "data"_a, "mip_level"_a = 0, "array_slice"_a = 0);
 }
 } // namespace Falcor
@@ -34,12 +34,14 @@
 #include "Core/Macros.h"
 #include "Utils/Image/Bitmap.h"
 #include <filesystem>
+#include <optional>
 #include <fstd/span.h>
 
 namespace Falcor
 {
 class Sampler;
 class RenderContext;
+struct TextureAnalysisResult;
 
 /**
  * Abstracts the API texture objects
@@ -184,6 +186,9 @@ public:
      * @param[in] loadAsSrgb Load the texture using sRGB format. Only valid for 3 or 4 component textures.
      * @param[in] bindFlags The bind flags to create the texture with.
      * @param[in] importFlags Optional flags for the file import.
+     * @param[out] pAnalysis Optional. If set, the decoded image is analyzed on the CPU before upload (see TextureAnalyzer::analyzeImage).
+     * Images that are constant in all channels are then uploaded as a single texel. Set to std::nullopt if the image could not be
+     * analyzed (e.g. DDS files).
      * @return A new texture, or nullptr if the texture failed to load.
      */
     static ref<Texture> createFromFile(
@@ -192,7 +197,8 @@ public:
         bool generateMipLevels,
         bool loadAsSrgb,
         ResourceBindFlags bindFlags = ResourceBindFlags::ShaderResource,
-        Bitmap::ImportFlags importFlags = Bitmap::ImportFlags::None
+        Bitmap::ImportFlags importFlags = Bitmap::ImportFlags::None,
+        std::optional<TextureAnalysisResult>* pAnalysis = nullptr
     );
 
     gfx::ITextureResource* getGfxTextureResource() const { return mGfxTextureResource; }
@@ -33,11 +33,13 @@
 
 #include <gtk/gtk.h>
 
+#include <cstdio>
 #include <iostream>
 #include <unistd.h>
 #include <signal.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/resource.h>
 #include <pwd.h>
 #ifndef _GNU_SOURCE
 #define _GNU_SOURCE // needed for dladdr()
@@ -579,13 +581,25 @@ void OSServices::stop() {}
 
 size_t getCurrentRSS()
 {
-    FALCOR_UNIMPLEMENTED();
-    return 0;
+    // The second field of /proc/self/statm is the number of resident pages.
+    FILE* pFile = fopen("/proc/self/statm", "r");
+    if (!pFile)
+        return 0;
+    unsigned long long totalPages = 0;
+    unsigned long long residentPages = 0;
+    int count = fscanf(pFile, "%llu %llu", &totalPages, &residentPages);
+    fclose(pFile);
+    if (count != 2)
+        return 0;
+    return (size_t)residentPages * (size_t)sysconf(_SC_PAGESIZE);
 }
 
 size_t getPeakRSS()
 {
-    FALCOR_UNIMPLEMENTED();
-    return 0;
+    // ru_maxrss is reported in kilobytes on Linux.
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return (size_t)usage.ru_maxrss * 1024;
 }
 } // namespace Falcor
@@ -43,6 +43,7 @@
 
 #include <slang.h>
 
+#include <chrono>
 #include <set>
 
 namespace Falcor
@@ -84,6 +85,9 @@ Program::Program(ref<Device> pDevice, ProgramDesc desc, DefineList defineList)
 
 Program::~Program()
 {
+    // Background compilations refer to this program, so they need to finish first.
+    waitForPendingVersions();
+
     mpDevice->getProgramManager()->unregisterProgramForReload(this);
 
     // Invalidate program versions.
@@ -318,6 +322,36 @@ const ref<const ProgramVersion>& Program::getActiveVersion() const
 
 bool Program::link() const
 {
+    dropStalePendingVersions();
+
+    // Use the result of a background compilation if one was enqueued for the current defines.
+    // On failure we compile again below to report the errors, with the option to retry.
+    if (auto it = mPendingVersions.find(ProgramVersionKey{mDefineList, mTypeConformanceList}); it != mPendingVersions.end())
+    {
+        std::shared_future<ProgramVersionCompileResult> future = std::move(it->second);
+        mPendingVersions.erase(it);
+        ProgramVersionCompileResult result;
+        try
+        {
+            result = future.get();
+        }
+        catch (const std::exception&)
+        {
+            // Ignore, the error is reported when compiling again below.
+        }
+        if (result.pVersion)
+        {
+            if (!result.log.empty())
+            {
+                logWarning("Warnings in program:\n{}\n{}", getProgramDescString(), result.log);
+            }
+
+            mFileTimeMap = std::move(result.fileTimeMap);
+            mpActiveVersion = result.pVersion;
+            return true;
+        }
+    }
+
     while (1)
     {
         // Create the program
@@ -347,12 +381,35 @@ bool Program::link() const
 
 void Program::reset()
 {
+    waitForPendingVersions();
+    mPendingVersions.clear();
     mpActiveVersion = nullptr;
     mProgramVersions.clear();
     mFileTimeMap.clear();
     mLinkRequired = true;
 }
 
+void Program::waitForPendingVersions() const
+{
+    for (const auto& [key, future] : mPendingVersions)
+        future.wait();
+}
+
+void Program::dropStalePendingVersions() const
+{
+    // Background compilations for other defines than the current ones are not used by link().
+    // Compilations still in flight refer to this program, they are dropped once they have finished.
+    const ProgramVersionKey currentKey{mDefineList, mTypeConformanceList};
+    for (auto it = mPendingVersions.begin(); it != mPendingVersions.end();)
+    {
+        const bool isStale = it->first < currentKey || currentKey < it->first;
+        if (isStale && it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            it = mPendingVersions.erase(it);
+        else
+            ++it;
+    }
+}
+
 void Program::breakStrongReferenceToDevice()
 {
     mpDevice.breakStrongReference();
@@ -36,6 +36,7 @@
 #include "Core/API/RtStateObject.h"
 #include "Core/State/StateGraph.h"
 #include <filesystem>
+#include <future>
 #include <memory>
 #include <string_view>
 #include <string>
@@ -570,6 +571,16 @@ struct ProgramDesc
  * This class manages different versions of the same program. Different versions means same shader files, different macro definitions.
  * This allows simple usage in case different macros are required - for example static vs. animated models.
  */
+/**
+ * Result of compiling a program version, see ProgramManager::enqueueProgramVersion().
+ */
+struct ProgramVersionCompileResult
+{
+    ref<const ProgramVersion> pVersion;                   ///< The program version, or nullptr if compilation failed.
+    std::string log;                                      ///< Compiler diagnostics.
+    std::unordered_map<std::string, time_t> fileTimeMap; ///< Modification times of the files the version depends on.
+};
+
 class FALCOR_API Program : public Object
 {
     FALCOR_OBJECT(Program)
@@ -788,6 +799,8 @@ protected:
     // We are doing lazy compilation, so these are mutable
     mutable bool mLinkRequired = true;
     mutable std::map<ProgramVersionKey, ref<const ProgramVersion>> mProgramVersions;
+    /// Program versions enqueued for background compilation, consumed by link().
+    mutable std::map<ProgramVersionKey, std::shared_future<ProgramVersionCompileResult>> mPendingVersions;
     mutable ref<const ProgramVersion> mpActiveVersion;
     void markDirty() { mLinkRequired = true; }
 
@@ -798,6 +811,8 @@ protected:
 
     bool checkIfFilesChanged();
     void reset();
+    void waitForPendingVersions() const;
+    void dropStalePendingVersions() const;
 
     using StateGraph = Falcor::StateGraph<ref<RtStateObject>, void*>;
     StateGraph mRtsoGraph;
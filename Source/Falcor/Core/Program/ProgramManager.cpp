@@ -29,10 +29,16 @@
 #include "Core/API/Device.h"
 #include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
+#include "Utils/Threading.h"
 #include "Utils/Timing/CpuTimer.h"
 
+#include <BS_thread_pool/BS_thread_pool.hpp>
 #include <slang.h>
 
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
+
 namespace Falcor
 {
 
@@ -70,6 +76,50 @@ inline SlangStage getSlangStage(ShaderType type)
     }
 }
 
+namespace
+{
+/// Maximum number of threads used for background compilation of program versions.
+/// Each thread owns a Slang global session, which has a noticeable memory footprint.
+const uint32_t kMaxCompileThreadCount = 8;
+} // namespace
+
+/**
+ * Thread pool for background compilation of program versions.
+ * Slang global sessions are not thread-safe, so each worker thread lazily creates its own. This is why compilation
+ * uses a small dedicated pool instead of the global task scheduler, which would create a session on every worker.
+ * The versions compiled by a worker are used on the main thread while the worker keeps compiling on the same session,
+ * so each session has a mutex that is held for every use (see ProgramVersion::lockSlangSession()).
+ */
+struct ProgramManager::CompileWorkers
+{
+    struct Session
+    {
+        Slang::ComPtr<slang::IGlobalSession> pGlobalSession;
+        std::shared_ptr<std::mutex> pMutex = std::make_shared<std::mutex>();
+    };
+
+    std::mutex mutex;
+    std::unordered_map<std::thread::id, Session> sessions;
+    std::string hlslLanguagePrelude;
+    // Declared last so the threads are joined before the sessions are released.
+    BS::thread_pool threadPool;
+
+    CompileWorkers(uint32_t threadCount) : threadPool(threadCount) {}
+
+    const Session& getSession()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& session = sessions[std::this_thread::get_id()];
+        if (!session.pGlobalSession)
+        {
+            slang::createGlobalSession(session.pGlobalSession.writeRef());
+            FALCOR_CHECK(session.pGlobalSession, "Failed to create Slang global session.");
+            session.pGlobalSession->setLanguagePrelude(SLANG_SOURCE_LANGUAGE_HLSL, hlslLanguagePrelude.c_str());
+        }
+        return session;
+    }
+};
+
 inline std::string getSlangProfileString(ShaderModel shaderModel)
 {
     return fmt::format("sm_{}_{}", getShaderModelMajorVersion(shaderModel), getShaderModelMinorVersion(shaderModel));
@@ -113,24 +163,76 @@ ProgramManager::ProgramManager(Device* pDevice) : mpDevice(pDevice)
     };
 
     addGlobalDefines(globalDefines);
+}
 
+ProgramManager::~ProgramManager()
+{
+    waitForEnqueuedProgramVersions();
 }
 
 ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& program, std::string& log) const
+{
+    ProgramVersionCompileResult result = createProgramVersion(program, program.getDefineList(), mpDevice->getSlangGlobalSession());
+    program.mFileTimeMap = std::move(result.fileTimeMap);
+    log += result.log;
+    return result.pVersion;
+}
+
+void ProgramManager::enqueueProgramVersion(const Program& program)
+{
+    program.dropStalePendingVersions();
+
+    Program::ProgramVersionKey key{program.getDefineList(), program.mTypeConformanceList};
+    if (program.mProgramVersions.count(key) || program.mPendingVersions.count(key))
+        return;
+
+    if (!mpCompileWorkers)
+    {
+        uint32_t threadCount = std::clamp(Threading::getThreadCount(), 1u, kMaxCompileThreadCount);
+        mpCompileWorkers = std::make_unique<CompileWorkers>(threadCount);
+        mpCompileWorkers->hlslLanguagePrelude = getHlslLanguagePrelude();
+    }
+
+    // The worker compiles against a copy of the defines, so the program can be modified while the compilation is pending.
+    // Everything else it reads from the program is immutable after creation.
+    auto task = [this, pProgram = &program, defineList = key.defineList]()
+    {
+        const CompileWorkers::Session& session = mpCompileWorkers->getSession();
+        std::lock_guard<std::mutex> lock(*session.pMutex);
+        return createProgramVersion(*pProgram, defineList, session.pGlobalSession, session.pMutex);
+    };
+    program.mPendingVersions.emplace(std::move(key), mpCompileWorkers->threadPool.submit(std::move(task)).share());
+}
+
+void ProgramManager::waitForEnqueuedProgramVersions()
+{
+    if (mpCompileWorkers)
+        mpCompileWorkers->threadPool.wait_for_tasks();
+}
+
+ProgramVersionCompileResult ProgramManager::createProgramVersion(
+    const Program& program,
+    const DefineList& defineList,
+    slang::IGlobalSession* pSlangGlobalSession,
+    std::shared_ptr<std::mutex> pSlangSessionMutex
+) const
 {
     CpuTimer timer;
     timer.update();
 
-    auto pSlangRequest = createSlangCompileRequest(program);
+    ProgramVersionCompileResult result;
+    std::string& log = result.log;
+
+    auto pSlangRequest = createSlangCompileRequest(program, defineList, pSlangGlobalSession);
     if (pSlangRequest == nullptr)
-        return nullptr;
+        return result;
 
     SlangResult slangResult = spCompile(pSlangRequest);
     log += spGetDiagnosticOutput(pSlangRequest);
     if (SLANG_FAILED(slangResult))
     {
         spDestroyCompileRequest(pSlangRequest);
-        return nullptr;
+        return result;
     }
 
     Slang::ComPtr<slang::IComponentType> pSlangGlobalScope;
@@ -169,7 +271,7 @@ ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& pr
     {
         std::string depFilePath = spGetDependencyFilePath(pSlangRequest, ii);
         if (std::filesystem::exists(depFilePath))
-            program.mFileTimeMap[depFilePath] = getFileModifiedTime(depFilePath);
+            result.fileTimeMap[depFilePath] = getFileModifiedTime(depFilePath);
     }
 
     // Note: the `ProgramReflection` needs to be able to refer back to the
@@ -201,20 +303,26 @@ ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& pr
     ref<const ProgramReflection> pReflector;
     if (!doSlangReflection(*pVersion, pSlangGlobalScope, pSlangEntryPoints, pReflector, log))
     {
-        return nullptr;
+        return result;
     }
 
     auto descStr = program.getProgramDescString();
-    pVersion->init(program.getDefineList(), pReflector, descStr, pSlangEntryPoints);
+    pVersion->init(defineList, pReflector, descStr, pSlangEntryPoints);
 
     timer.update();
     double time = timer.delta();
-    mCompilationStats.programVersionCount++;
-    mCompilationStats.programVersionTotalTime += time;
-    mCompilationStats.programVersionMaxTime = std::max(mCompilationStats.programVersionMaxTime, time);
+    {
+        std::lock_guard<std::mutex> lock(mCompilationStatsMutex);
+        mCompilationStats.programVersionCount++;
+        mCompilationStats.programVersionTotalTime += time;
+        mCompilationStats.programVersionMaxTime = std::max(mCompilationStats.programVersionMaxTime, time);
+    }
     logDebug("Created program version in {:.3f} s: {}", timer.delta(), descStr);
 
-    return pVersion;
+    // Set the session mutex last, the caller holds it while compiling.
+    pVersion->mpSlangSessionMutex = std::move(pSlangSessionMutex);
+    result.pVersion = pVersion;
+    return result;
 }
 
 ref<const ProgramKernels> ProgramManager::createProgramKernels(
@@ -227,6 +335,9 @@ ref<const ProgramKernels> ProgramManager::createProgramKernels(
     CpuTimer timer;
     timer.update();
 
+    // Linking and code generation use the session the version was compiled on.
+    auto sessionLock = programVersion.lockSlangSession();
+
     auto pSlangGlobalScope = programVersion.getSlangGlobalScope();
     auto pSlangSession = pSlangGlobalScope->getSession();
 
@@ -500,6 +611,7 @@ ref<const ProgramKernels> ProgramManager::createProgramKernels(
 
     timer.update();
     double time = timer.delta();
+    std::lock_guard<std::mutex> lock(mCompilationStatsMutex);
     mCompilationStats.programKernelsCount++;
     mCompilationStats.programKernelsTotalTime += time;
     mCompilationStats.programKernelsMaxTime = std::max(mCompilationStats.programKernelsMaxTime, time);
@@ -558,6 +670,18 @@ std::string ProgramManager::getHlslLanguagePrelude() const
 void ProgramManager::setHlslLanguagePrelude(const std::string& prelude)
 {
     mpDevice->getSlangGlobalSession()->setLanguagePrelude(SLANG_SOURCE_LANGUAGE_HLSL, prelude.c_str());
+
+    if (mpCompileWorkers)
+    {
+        waitForEnqueuedProgramVersions();
+        std::lock_guard<std::mutex> lock(mpCompileWorkers->mutex);
+        mpCompileWorkers->hlslLanguagePrelude = prelude;
+        for (auto& [id, session] : mpCompileWorkers->sessions)
+        {
+            std::lock_guard<std::mutex> sessionLock(*session.pMutex);
+            session.pGlobalSession->setLanguagePrelude(SLANG_SOURCE_LANGUAGE_HLSL, prelude.c_str());
+        }
+    }
 }
 
 void ProgramManager::registerProgramForReload(Program* program)
@@ -572,6 +696,8 @@ void ProgramManager::unregisterProgramForReload(Program* program)
 
 bool ProgramManager::reloadAllPrograms(bool forceReload)
 {
+    waitForEnqueuedProgramVersions();
+
     bool hasReloaded = false;
 
     for (auto program : mLoadedPrograms)
@@ -588,12 +714,14 @@ bool ProgramManager::reloadAllPrograms(bool forceReload)
 
 void ProgramManager::addGlobalDefines(const DefineList& defineList)
 {
+    waitForEnqueuedProgramVersions();
     mGlobalDefineList.add(defineList);
     reloadAllPrograms(true);
 }
 
 void ProgramManager::removeGlobalDefines(const DefineList& defineList)
 {
+    waitForEnqueuedProgramVersions();
     mGlobalDefineList.remove(defineList);
     reloadAllPrograms(true);
 }
@@ -610,6 +738,7 @@ bool ProgramManager::isGenerateDebugInfoEnabled()
 
 void ProgramManager::setForcedCompilerFlags(ForcedCompilerFlags forcedCompilerFlags)
 {
+    waitForEnqueuedProgramVersions();
     mForcedCompilerFlags = forcedCompilerFlags;
     reloadAllPrograms(true);
 }
@@ -619,9 +748,48 @@ ProgramManager::ForcedCompilerFlags ProgramManager::getForcedCompilerFlags()
     return mForcedCompilerFlags;
 }
 
-SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& program) const
+ProgramManager::CompilationStats ProgramManager::getCompilationStats() const
+{
+    CompilationStats stats;
+    {
+        std::lock_guard<std::mutex> lock(mCompilationStatsMutex);
+        stats = mCompilationStats;
+    }
+
+    // The target code is persisted by the GFX shader cache, which keys its entries on the linked program.
+    // That covers the source, the defines and the type conformances of the program.
+    Slang::ComPtr<gfx::IShaderCache> pShaderCache;
+    if (SLANG_SUCCEEDED(mpDevice->getGfxDevice()->queryInterface(SlangUUID SLANG_UUID_IShaderCache, (void**)pShaderCache.writeRef())))
+    {
+        gfx::ShaderCacheStats shaderCacheStats = {};
+        if (SLANG_SUCCEEDED(pShaderCache->getShaderCacheStats(&shaderCacheStats)))
+        {
+            stats.shaderCacheHitCount = shaderCacheStats.hitCount;
+            stats.shaderCacheMissCount = shaderCacheStats.missCount;
+        }
+    }
+
+    return stats;
+}
+
+void ProgramManager::resetCompilationStats()
+{
+    {
+        std::lock_guard<std::mutex> lock(mCompilationStatsMutex);
+        mCompilationStats = {};
+    }
+
+    Slang::ComPtr<gfx::IShaderCache> pShaderCache;
+    if (SLANG_SUCCEEDED(mpDevice->getGfxDevice()->queryInterface(SlangUUID SLANG_UUID_IShaderCache, (void**)pShaderCache.writeRef())))
+        pShaderCache->resetShaderCacheStats();
+}
+
+SlangCompileRequest* ProgramManager::createSlangCompileRequest(
+    const Program& program,
+    const DefineList& defineList,
+    slang::IGlobalSession* pSlangGlobalSession
+) const
 {
-    slang::IGlobalSession* pSlangGlobalSession = mpDevice->getSlangGlobalSession();
     FALCOR_ASSERT(pSlangGlobalSession);
 
     slang::SessionDesc sessionDesc;
@@ -711,7 +879,7 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
     // Add global followed by program specific defines.
     for (const auto& shaderDefine : mGlobalDefineList)
         addSlangDefine(shaderDefine.first.c_str(), shaderDefine.second.c_str());
-    for (const auto& shaderDefine : program.getDefineList())
+    for (const auto& shaderDefine : defineList)
         addSlangDefine(shaderDefine.first.c_str(), shaderDefine.second.c_str());
 
     // Add a `#define`s based on the target and shader model.
@@ -764,8 +932,6 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
     pSlangGlobalSession->createSession(sessionDesc, pSlangSession.writeRef());
     FALCOR_ASSERT(pSlangSession);
 
-    program.mFileTimeMap.clear(); // TODO @skallweit
-
     SlangCompileRequest* pSlangRequest = nullptr;
     pSlangSession->createCompileRequest(&pSlangRequest);
     FALCOR_ASSERT(pSlangRequest);
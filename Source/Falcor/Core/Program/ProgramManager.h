@@ -31,6 +31,7 @@
 #include "Core/API/fwd.h"
 
 #include <memory>
+#include <mutex>
 
 namespace Falcor
 {
@@ -39,6 +40,7 @@ class FALCOR_API ProgramManager
 {
 public:
     ProgramManager(Device* pDevice);
+    ~ProgramManager();
 
     /**
      * Defines flags that should be forcefully disabled or enabled on all shaders.
@@ -58,6 +60,10 @@ public:
         double programKernelsMaxTime = 0.0;
         double programVersionTotalTime = 0.0;
         double programKernelsTotalTime = 0.0;
+        /// Lookups in the persistent shader cache (Device::Desc::shaderCachePath) that found up-to-date target code.
+        size_t shaderCacheHitCount = 0;
+        /// Lookups in the persistent shader cache that had to generate the target code.
+        size_t shaderCacheMissCount = 0;
     };
 
     ProgramDesc applyForcedCompilerFlags(ProgramDesc desc) const;
@@ -66,6 +72,21 @@ public:
 
     ref<const ProgramVersion> createProgramVersion(const Program& program, std::string& log) const;
 
+    /**
+     * Enqueue compilation of the program version for the current defines of a program on a background thread.
+     * Compilation of independent programs runs in parallel, each worker thread using its own Slang global session.
+     * The program blocks on the result the first time the version is needed (see Program::getActiveVersion()).
+     * Enqueuing a version that is already compiled or pending does nothing. Finished compilations for defines that are
+     * no longer current are dropped.
+     * @param[in] program The program. The program waits for pending compilations when it is destroyed.
+     */
+    void enqueueProgramVersion(const Program& program);
+
+    /**
+     * Wait for all enqueued program versions to finish compiling.
+     */
+    void waitForEnqueuedProgramVersions();
+
     ref<const ProgramKernels> createProgramKernels(
         const Program& program,
         const ProgramVersion& programVersion,
@@ -141,16 +162,30 @@ public:
      */
     ForcedCompilerFlags getForcedCompilerFlags();
 
-    const CompilationStats& getCompilationStats() { return mCompilationStats; }
-    void resetCompilationStats() { mCompilationStats = {}; }
+    CompilationStats getCompilationStats() const;
+    void resetCompilationStats();
 
 private:
-    SlangCompileRequest* createSlangCompileRequest(const Program& program) const;
+    struct CompileWorkers;
+
+    ProgramVersionCompileResult createProgramVersion(
+        const Program& program,
+        const DefineList& defineList,
+        slang::IGlobalSession* pSlangGlobalSession,
+        std::shared_ptr<std::mutex> pSlangSessionMutex = nullptr
+    ) const;
+    SlangCompileRequest* createSlangCompileRequest(
+        const Program& program,
+        const DefineList& defineList,
+        slang::IGlobalSession* pSlangGlobalSession
+    ) const;
 
     Device* mpDevice;
 
     std::vector<Program*> mLoadedPrograms;
     mutable CompilationStats mCompilationStats;
+    mutable std::mutex mCompilationStatsMutex;
+    std::unique_ptr<CompileWorkers> mpCompileWorkers;
 
     DefineList mGlobalDefineList;
     std::vector<std::string> mGlobalCompilerArguments;
@@ -169,6 +169,16 @@ ProgramVersion::ProgramVersion(Program* pProgram, slang::IComponentType* pSlangG
     FALCOR_ASSERT(pProgram);
 }
 
+ProgramVersion::~ProgramVersion()
+{
+    // Releasing the Slang objects touches the global session, so do it while holding the session lock.
+    auto lock = lockSlangSession();
+    mpKernels.clear();
+    mpReflector = nullptr;
+    mpSlangEntryPoints.clear();
+    mpSlangGlobalScope = nullptr;
+}
+
 void ProgramVersion::init(
     const DefineList& defineList,
     const ref<const ProgramReflection>& pReflector,
@@ -251,6 +261,11 @@ ref<const ProgramKernels> ProgramVersion::getKernels(Device* pDevice, ProgramVar
     }
 }
 
+std::unique_lock<std::mutex> ProgramVersion::lockSlangSession() const
+{
+    return mpSlangSessionMutex ? std::unique_lock<std::mutex>(*mpSlangSessionMutex) : std::unique_lock<std::mutex>();
+}
+
 slang::ISession* ProgramVersion::getSlangSession() const
 {
     return getSlangGlobalScope()->getSession();
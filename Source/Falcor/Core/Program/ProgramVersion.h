@@ -34,6 +34,7 @@
 #include "Core/API/Types.h"
 #include "Core/API/Handles.h"
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -245,6 +246,8 @@ class ProgramVersion : public Object
 {
     FALCOR_OBJECT(ProgramVersion)
 public:
+    virtual ~ProgramVersion() override;
+
     /**
      * Get the program that this version was created from
      */
@@ -276,6 +279,14 @@ public:
     // TODO @skallweit passing pDevice here is a bit of a WAR
     ref<const ProgramKernels> getKernels(Device* pDevice, ProgramVars const* pVars) const;
 
+    /**
+     * Lock the Slang global session the version was compiled on.
+     * Versions compiled in the background share the session of a compile worker, which keeps compiling other versions
+     * on it. Every use of the Slang objects of such a version must hold this lock. Versions compiled on the device
+     * session are only used on the main thread and return an empty lock.
+     */
+    std::unique_lock<std::mutex> lockSlangSession() const;
+
     slang::ISession* getSlangSession() const;
     slang::IComponentType* getSlangGlobalScope() const;
     slang::IComponentType* getSlangEntryPoint(uint32_t index) const;
@@ -302,6 +313,8 @@ protected:
     std::string mName;
     Slang::ComPtr<slang::IComponentType> mpSlangGlobalScope;
     std::vector<Slang::ComPtr<slang::IComponentType>> mpSlangEntryPoints;
+    /// Mutex of the compile worker session the version was compiled on, nullptr for the device session.
+    std::shared_ptr<std::mutex> mpSlangSessionMutex;
 
     // Cached version of compiled kernels for this program version
     mutable std::unordered_map<std::string, ref<const ProgramKernels>> mpKernels;
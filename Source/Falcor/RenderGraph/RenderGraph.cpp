@@ -120,6 +120,8 @@ void RenderGraph::setScene(const ref<Scene>& pScene)
     {
         it.second.pPass->setScene(mpDevice->getRenderContext(), pScene);
     }
+    // Passes may change their reflection based on the scene
+    mCompilerCache.clear();
     mRecompile = true;
 }
 
@@ -139,7 +141,11 @@ uint32_t RenderGraph::addPass(const ref<RenderPass>& pPass, const std::string& p
     uint32_t passIndex = mpGraph->addNode();
     mNameToIndex[passName] = passIndex;
 
-    pPass->mPassChangedCB = [this]() { mRecompile = true; };
+    pPass->mPassChangedCB = [this, pPass = pPass.get()]()
+    {
+        mCompilerCache.invalidate(pPass);
+        mRecompile = true;
+    };
     pPass->mName = passName;
 
     if (mpScene)
@@ -167,6 +173,7 @@ void RenderGraph::removePass(const std::string& name)
     // Remove all the edges, indices and pass-data associated with this pass
     for (const auto& outputName : outputsToDelete)
         unmarkOutput(outputName);
+    mCompilerCache.invalidate(mNodeData[index].pPass.get());
     mNameToIndex.erase(name);
     mNodeData.erase(index);
     const auto& removedEdges = mpGraph->removeNode(index);
@@ -184,10 +191,15 @@ void RenderGraph::updatePass(const std::string& passName, const Properties& prop
 
     // Recreate pass without changing graph using new dictionary
     auto pOldPass = pPassIt->second.pPass;
+    mCompilerCache.invalidate(pOldPass.get());
     std::string passTypeName = pOldPass->getType();
     auto pPass = RenderPass::create(passTypeName, mpDevice, props);
     pPassIt->second.pPass = pPass;
-    pPass->mPassChangedCB = [this]() { mRecompile = true; };
+    pPass->mPassChangedCB = [this, pPass = pPass.get()]()
+    {
+        mCompilerCache.invalidate(pPass);
+        mRecompile = true;
+    };
     pPass->mName = pOldPass->getName();
 
     if (mpScene)
@@ -421,16 +433,36 @@ std::vector<std::string> RenderGraph::getUnmarkedOutputs() const
     return outputs;
 }
 
+void RenderGraph::setResourceAliasingEnabled(bool enabled)
+{
+    if (mCompilerDeps.aliasTransientResources == enabled)
+        return;
+    mCompilerDeps.aliasTransientResources = enabled;
+    mRecompile = true;
+}
+
+ResourceCache::AllocationStats RenderGraph::getResourceAllocationStats() const
+{
+    return mpExe ? mpExe->getResourceAllocationStats() : ResourceCache::AllocationStats();
+}
+
 bool RenderGraph::compile(RenderContext* pRenderContext, std::string& log)
 {
     if (!mRecompile)
         return true;
-    mpExe = nullptr;
+
+    // Keep the previous result alive during compilation so that its resources can be reused
+    auto pPrevExe = std::move(mpExe);
 
     try
     {
-        mpExe = RenderGraphCompiler::compile(*this, pRenderContext, mCompilerDeps);
+        mpExe = RenderGraphCompiler::compile(*this, pRenderContext, mCompilerDeps, &mCompilerCache, pPrevExe.get());
         mRecompile = false;
+
+        // Start compiling the programs of all passes in the background.
+        RenderGraphExe::Context c{
+            pRenderContext, mPassesDictionary, mCompilerDeps.defaultResourceProps.dims, mCompilerDeps.defaultResourceProps.format};
+        mpExe->prewarmPrograms(c);
         return true;
     }
     catch (const std::exception& e)
@@ -734,6 +766,7 @@ FALCOR_SCRIPT_BINDING(RenderGraph)
     // RenderGraph
     pybind11::class_<RenderGraph, ref<RenderGraph>> renderGraph(m, "RenderGraph");
     renderGraph.def_property("name", &RenderGraph::getName, &RenderGraph::setName);
+    renderGraph.def_property("resource_aliasing", &RenderGraph::isResourceAliasingEnabled, &RenderGraph::setResourceAliasingEnabled);
 
     renderGraph.def(
         "create_pass",
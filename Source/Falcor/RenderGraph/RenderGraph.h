@@ -301,6 +301,24 @@ public:
      */
     void setName(const std::string& name) { mName = name; }
 
+    /**
+     * Enable/disable aliasing of transient resources.
+     * If enabled, pass outputs with compatible format, size and bind flags share the same resource when their lifetimes in the
+     * execution order don't overlap. Graph outputs, internal and persistent fields are never aliased.
+     */
+    void setResourceAliasingEnabled(bool enabled);
+
+    /**
+     * Check if aliasing of transient resources is enabled.
+     */
+    bool isResourceAliasingEnabled() const { return mCompilerDeps.aliasTransientResources; }
+
+    /**
+     * Get memory statistics for the resources allocated by the last graph compilation.
+     * Returns default-initialized statistics if the graph hasn't been compiled yet.
+     */
+    ResourceCache::AllocationStats getResourceAllocationStats() const;
+
     /**
      * Compile the graph.
      */
@@ -377,6 +395,7 @@ private:
     Dictionary mPassesDictionary;                    ///< Dictionary used to communicate between passes.
     std::unique_ptr<RenderGraphExe> mpExe;           ///< Helper for allocating resources and executing the graph.
     RenderGraphCompiler::Dependencies mCompilerDeps; ///< Data needed by the graph compiler.
+    RenderGraphCompiler::Cache mCompilerCache;       ///< Results of previous compilations, used for incremental recompilation.
     bool mRecompile = false; ///< Set to true to trigger a recompilation after any graph changes (topology/scene/size/passes/etc.)
 
     friend class RenderGraphUI;
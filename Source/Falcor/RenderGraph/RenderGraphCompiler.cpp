@@ -30,29 +30,41 @@
 #include "RenderPasses/ResolvePass.h"
 #include "Core/Error.h"
 #include "Utils/Algorithm/DirectedGraphTraversal.h"
+#include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
 
 namespace Falcor
 {
 namespace
 {
+// Passes are typically reflected with a couple of different compile data per compilation (with and without connected resources).
+const size_t kMaxCachedReflectionsPerPass = 4;
+
 bool canAutoResolve(const RenderPassReflection::Field& src, const RenderPassReflection::Field& dst)
 {
     return src.getSampleCount() > 1 && dst.getSampleCount() == 1;
 }
+
+bool isSameCompileData(const RenderPass::CompileData& a, const RenderPass::CompileData& b)
+{
+    return all(a.defaultTexDims == b.defaultTexDims) && a.defaultTexFormat == b.defaultTexFormat &&
+           a.connectedResources == b.connectedResources;
+}
 } // namespace
 
-RenderGraphCompiler::RenderGraphCompiler(RenderGraph& graph, const Dependencies& dependencies)
-    : mGraph(graph), mpDevice(graph.getDevice()), mDependencies(dependencies)
+RenderGraphCompiler::RenderGraphCompiler(RenderGraph& graph, const Dependencies& dependencies, Cache* pCache)
+    : mGraph(graph), mpDevice(graph.getDevice()), mDependencies(dependencies), mpCache(pCache)
 {}
 
 std::unique_ptr<RenderGraphExe> RenderGraphCompiler::compile(
     RenderGraph& graph,
     RenderContext* pRenderContext,
-    const Dependencies& dependencies
+    const Dependencies& dependencies,
+    Cache* pCache,
+    const RenderGraphExe* pPreviousExe
 )
 {
-    RenderGraphCompiler c = RenderGraphCompiler(graph, dependencies);
+    RenderGraphCompiler c = RenderGraphCompiler(graph, dependencies, pCache);
 
     // Register the external resources
     auto pResourcesCache = std::make_unique<ResourceCache>();
@@ -64,7 +76,9 @@ std::unique_ptr<RenderGraphExe> RenderGraphCompiler::compile(
     if (c.insertAutoPasses())
         c.resolveExecutionOrder();
     c.validateGraph();
-    c.allocateResources(pRenderContext->getDevice(), pResourcesCache.get());
+    c.allocateResources(
+        pRenderContext->getDevice(), pResourcesCache.get(), pPreviousExe ? pPreviousExe->mpResourceCache.get() : nullptr
+    );
 
     auto pExe = std::make_unique<RenderGraphExe>();
     pExe->mExecutionList.reserve(c.mExecutionList.size());
@@ -75,9 +89,76 @@ std::unique_ptr<RenderGraphExe> RenderGraphCompiler::compile(
     }
     c.restoreCompilationChanges();
     pExe->mpResourceCache = std::move(pResourcesCache);
+
+    logDebug(
+        "RenderGraphCompiler: Reflected {} passes ({} cached), compiled {} passes ({} cached).",
+        c.mStats.reflectCount + c.mStats.cachedReflectCount,
+        c.mStats.cachedReflectCount,
+        c.mStats.compileCount + c.mStats.cachedCompileCount,
+        c.mStats.cachedCompileCount
+    );
     return pExe;
 }
 
+RenderPassReflection RenderGraphCompiler::reflectPass(const ref<RenderPass>& pPass, const RenderPass::CompileData& compileData)
+{
+    if (!mpCache)
+    {
+        mStats.reflectCount++;
+        return pPass->reflect(compileData);
+    }
+
+    auto it = mpCache->passes.find(pPass.get());
+    if (it != mpCache->passes.end())
+    {
+        for (const auto& [data, reflection] : it->second.reflections)
+        {
+            if (isSameCompileData(data, compileData))
+            {
+                mStats.cachedReflectCount++;
+                return reflection;
+            }
+        }
+    }
+
+    // Note that the pass may invalidate its cache entry while being reflected, so look it up again afterwards
+    mStats.reflectCount++;
+    RenderPassReflection reflection = pPass->reflect(compileData);
+    auto& entry = mpCache->passes[pPass.get()];
+    entry.pPass = pPass;
+    if (entry.reflections.size() >= kMaxCachedReflectionsPerPass)
+        entry.reflections.erase(entry.reflections.begin());
+    entry.reflections.emplace_back(compileData, reflection);
+    return reflection;
+}
+
+void RenderGraphCompiler::compilePass(RenderContext* pRenderContext, const ref<RenderPass>& pPass, const RenderPass::CompileData& compileData)
+{
+    if (mpCache)
+    {
+        auto it = mpCache->passes.find(pPass.get());
+        if (it != mpCache->passes.end() && it->second.compiledData && isSameCompileData(*it->second.compiledData, compileData))
+        {
+            mStats.cachedCompileCount++;
+            return;
+        }
+        auto& entry = mpCache->passes[pPass.get()];
+        entry.pPass = pPass;
+        entry.compiledData.reset();
+    }
+
+    mStats.compileCount++;
+    pPass->compile(pRenderContext, compileData);
+
+    // Only record the result if the pass didn't invalidate its cache entry while being compiled
+    if (mpCache)
+    {
+        auto it = mpCache->passes.find(pPass.get());
+        if (it != mpCache->passes.end())
+            it->second.compiledData = compileData;
+    }
+}
+
 void RenderGraphCompiler::validateGraph() const
 {
     std::string err;
@@ -167,7 +248,7 @@ void RenderGraphCompiler::resolveExecutionOrder()
         if (participatingPasses.find(node) != participatingPasses.end())
         {
             const auto pData = mGraph.mNodeData[node];
-            mExecutionList.push_back({node, pData.pPass, pData.name, pData.pPass->reflect(compileData)});
+            mExecutionList.push_back({node, pData.pPass, pData.name, reflectPass(pData.pPass, compileData)});
         }
     }
 }
@@ -261,7 +342,7 @@ bool RenderGraphCompiler::insertAutoPasses()
     return addedPasses;
 }
 
-void RenderGraphCompiler::allocateResources(ref<Device> pDevice, ResourceCache* pResourceCache)
+void RenderGraphCompiler::allocateResources(ref<Device> pDevice, ResourceCache* pResourceCache, const ResourceCache* pPreviousResourceCache)
 {
     // Build list to look up execution order index from the pass
     std::unordered_map<RenderPass*, uint32_t> passToIndex;
@@ -336,13 +417,27 @@ void RenderGraphCompiler::allocateResources(ref<Device> pDevice, ResourceCache*
             std::string srcFieldName = mGraph.mNodeData[pEdge->getSourceNode()].name + '.' + edgeData.srcField;
             std::string dstFieldName = mGraph.mNodeData[nodeIndex].name + '.' + dstField.getName();
 
-            const auto& pSrcPass = mGraph.mNodeData[pEdge->getSourceNode()].pPass.get();
-            const auto& srcReflection = mExecutionList[passToIndex.at(pSrcPass)].reflector;
-            pResourceCache->registerField(dstFieldName, dstField, passToIndex[pSrcPass], srcFieldName);
+            // The resource is in use until the consuming pass has executed
+            pResourceCache->registerField(dstFieldName, dstField, uint32_t(i), srcFieldName);
         }
     }
 
-    pResourceCache->allocateResources(pDevice, mDependencies.defaultResourceProps);
+    pResourceCache->allocateResources(
+        pDevice, mDependencies.defaultResourceProps, mDependencies.aliasTransientResources, pPreviousResourceCache
+    );
+
+    if (mDependencies.aliasTransientResources)
+    {
+        const auto& stats = pResourceCache->getAllocationStats();
+        logInfo(
+            "RenderGraphCompiler: Aliased {} fields into {} resources. Estimated memory {} before, {} after (peak live {}).",
+            stats.fieldCount,
+            stats.resourceCount,
+            formatByteSize(stats.bytesBefore),
+            formatByteSize(stats.bytesAfter),
+            formatByteSize(stats.peakLiveBytes)
+        );
+    }
 }
 
 void RenderGraphCompiler::restoreCompilationChanges()
@@ -450,7 +545,7 @@ void RenderGraphCompiler::compilePasses(RenderContext* pRenderContext)
         {
             try
             {
-                p.pPass->compile(pRenderContext, prepPassCompilationData(p));
+                compilePass(pRenderContext, p.pPass, prepPassCompilationData(p));
             }
             catch (const std::exception& e)
             {
@@ -466,7 +561,7 @@ void RenderGraphCompiler::compilePasses(RenderContext* pRenderContext)
         bool changed = false;
         for (auto& p : mExecutionList)
         {
-            auto newR = p.pPass->reflect(prepPassCompilationData(p));
+            auto newR = reflectPass(p.pPass, prepPassCompilationData(p));
             if (newR != p.reflector)
             {
                 p.reflector = newR;
@@ -31,7 +31,9 @@
 #include "ResourceCache.h"
 #include "RenderGraphExe.h"
 #include "Core/Macros.h"
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -46,15 +48,64 @@ public:
     {
         ResourceCache::DefaultProperties defaultResourceProps;
         ResourceCache::ResourcesMap externalResources;
+        bool aliasTransientResources = false; ///< Share resources between fields with compatible descriptions and disjoint lifetimes.
     };
-    static std::unique_ptr<RenderGraphExe> compile(RenderGraph& graph, RenderContext* pRenderContext, const Dependencies& dependencies);
+
+    /**
+     * Results of previous compilations, used to skip redundant work when the graph is recompiled.
+     * Reflection results are cached per pass and keyed on the compile data passed to reflect(). A pass is only compiled again
+     * if the compile data (default properties and reflection of its connected resources) changed since its last compilation.
+     * Passes must be invalidated when their internal state changes in a way that affects reflect() or compile().
+     */
+    struct Cache
+    {
+        struct PassEntry
+        {
+            ref<RenderPass> pPass; ///< Keeps the pass alive so that its address can't be reused while the entry exists.
+            std::vector<std::pair<RenderPass::CompileData, RenderPassReflection>> reflections; ///< Reflection results per compile data.
+            std::optional<RenderPass::CompileData> compiledData; ///< Compile data of the last successful compile() call.
+        };
+        std::unordered_map<const RenderPass*, PassEntry> passes;
+
+        /// Invalidate the cached results of a single pass.
+        void invalidate(const RenderPass* pPass) { passes.erase(pPass); }
+
+        /// Invalidate the cached results of all passes.
+        void clear() { passes.clear(); }
+    };
+
+    /**
+     * Compile a render graph.
+     * @param[in] graph The render graph.
+     * @param[in] pRenderContext The render context.
+     * @param[in] dependencies Data needed by the compiler.
+     * @param[in] pCache Optional. Cache of results from previous compilations. It is updated with the results of this compilation.
+     * @param[in] pPreviousExe Optional. Result of the previous compilation. Resources with matching descriptions are reused.
+     * @return The compiled graph. Throws an exception if compilation failed.
+     */
+    static std::unique_ptr<RenderGraphExe> compile(
+        RenderGraph& graph,
+        RenderContext* pRenderContext,
+        const Dependencies& dependencies,
+        Cache* pCache = nullptr,
+        const RenderGraphExe* pPreviousExe = nullptr
+    );
 
 private:
-    RenderGraphCompiler(RenderGraph& graph, const Dependencies& dependencies);
+    RenderGraphCompiler(RenderGraph& graph, const Dependencies& dependencies, Cache* pCache);
 
     RenderGraph& mGraph;
     ref<Device> mpDevice;
     const Dependencies& mDependencies;
+    Cache* mpCache;
+
+    struct
+    {
+        uint32_t reflectCount = 0;
+        uint32_t cachedReflectCount = 0;
+        uint32_t compileCount = 0;
+        uint32_t cachedCompileCount = 0;
+    } mStats;
 
     struct PassData
     {
@@ -75,9 +126,11 @@ private:
     void resolveExecutionOrder();
     void compilePasses(RenderContext* pRenderContext);
     bool insertAutoPasses();
-    void allocateResources(ref<Device> pDevice, ResourceCache* pResourceCache);
+    void allocateResources(ref<Device> pDevice, ResourceCache* pResourceCache, const ResourceCache* pPreviousResourceCache);
     void validateGraph() const;
     void restoreCompilationChanges();
     RenderPass::CompileData prepPassCompilationData(const PassData& passData);
+    RenderPassReflection reflectPass(const ref<RenderPass>& pPass, const RenderPass::CompileData& compileData);
+    void compilePass(RenderContext* pRenderContext, const ref<RenderPass>& pPass, const RenderPass::CompileData& compileData);
 };
 } // namespace Falcor
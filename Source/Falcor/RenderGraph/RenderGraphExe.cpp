@@ -43,6 +43,15 @@ void RenderGraphExe::execute(const Context& ctx)
     }
 }
 
+void RenderGraphExe::prewarmPrograms(const Context& ctx)
+{
+    for (const auto& pass : mExecutionList)
+    {
+        RenderData renderData(pass.name, *mpResourceCache, ctx.passesDictionary, ctx.defaultTexDims, ctx.defaultTexFormat);
+        pass.pPass->prewarmPrograms(ctx.pRenderContext, renderData);
+    }
+}
+
 void RenderGraphExe::renderUI(RenderContext* pRenderContext, Gui::Widgets& widget)
 {
     for (const auto& p : mExecutionList)
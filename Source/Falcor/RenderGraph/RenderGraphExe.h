@@ -59,6 +59,11 @@ public:
      */
     void execute(const Context& ctx);
 
+    /**
+     * Let the passes enqueue their programs for background compilation, see RenderPass::prewarmPrograms().
+     */
+    void prewarmPrograms(const Context& ctx);
+
     /**
      * Render the UI
      */
@@ -99,6 +104,11 @@ public:
      */
     void setInput(const std::string& name, const ref<Resource>& pResource);
 
+    /**
+     * Get memory statistics of the resource cache.
+     */
+    const ResourceCache::AllocationStats& getResourceAllocationStats() const { return mpResourceCache->getAllocationStats(); }
+
 private:
     friend class RenderGraphCompiler;
 
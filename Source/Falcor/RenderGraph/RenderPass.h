@@ -173,6 +173,15 @@ public:
      */
     virtual void compile(RenderContext* pRenderContext, const CompileData& compileData) {}
 
+    /**
+     * Called at the end of render graph compilation, after the graph resources have been allocated.
+     * The render data is the same that execute() receives, so defines that depend on the connected resources are known.
+     * Passes can set the defines of the programs they use in execute() and enqueue them for background compilation using
+     * ProgramManager::enqueueProgramVersion(), so that the programs of all passes compile in parallel.
+     * The programs block at first use until their compilation has finished.
+     */
+    virtual void prewarmPrograms(RenderContext* pRenderContext, const RenderData& renderData) {}
+
     /**
      * Executes the pass.
      */
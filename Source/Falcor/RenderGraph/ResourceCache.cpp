@@ -30,6 +30,9 @@
 #include "Core/API/Texture.h"
 #include "Core/API/Buffer.h"
 #include "Utils/Logger.h"
+#include "Utils/Algorithm/IntervalPacking.h"
+#include "Utils/Math/Common.h"
+#include <algorithm>
 
 namespace Falcor
 {
@@ -37,6 +40,7 @@ void ResourceCache::reset()
 {
     mNameToIndex.clear();
     mResourceData.clear();
+    mAllocatedResources.clear();
 }
 
 const ref<Resource>& ResourceCache::getResource(const std::string& name) const
@@ -106,7 +110,8 @@ void ResourceCache::registerField(
         FALCOR_ASSERT(mNameToIndex.count(name) == 0);
         mNameToIndex[name] = (uint32_t)mResourceData.size();
         bool resolveBindFlags = (field.getBindFlags() == ResourceBindFlags::None);
-        mResourceData.push_back({field, {timePoint, timePoint}, nullptr, resolveBindFlags, name});
+        bool persistent = is_set(field.getFlags(), RenderPassReflection::Field::Flags::Persistent);
+        mResourceData.push_back({field, {timePoint, timePoint}, nullptr, resolveBindFlags, name, persistent});
     }
     else // Add alias
     {
@@ -116,30 +121,33 @@ void ResourceCache::registerField(
         mergeTimePoint(mResourceData[index].lifetime, timePoint);
         mResourceData[index].pResource = nullptr;
         mResourceData[index].resolveBindFlags = mResourceData[index].resolveBindFlags || (field.getBindFlags() == ResourceBindFlags::None);
+        mResourceData[index].persistent =
+            mResourceData[index].persistent || is_set(field.getFlags(), RenderPassReflection::Field::Flags::Persistent);
     }
 }
 
-inline ref<Resource> createResourceForPass(
-    ref<Device> pDevice,
+namespace
+{
+ResourceCache::ResourceDesc resolveResourceDesc(
+    Device* pDevice,
     const ResourceCache::DefaultProperties& params,
     const RenderPassReflection::Field& field,
-    bool resolveBindFlags,
-    const std::string& resourceName
+    bool resolveBindFlags
 )
 {
-    uint32_t width = field.getWidth() ? field.getWidth() : params.dims.x;
-    uint32_t height = field.getHeight() ? field.getHeight() : params.dims.y;
-    uint32_t depth = field.getDepth() ? field.getDepth() : 1;
-    uint32_t sampleCount = field.getSampleCount() ? field.getSampleCount() : 1;
-    auto bindFlags = field.getBindFlags();
-    auto arraySize = field.getArraySize();
-    auto mipLevels = field.getMipCount();
-
-    ResourceFormat format = ResourceFormat::Unknown;
+    ResourceCache::ResourceDesc desc;
+    desc.type = field.getType();
+    desc.width = field.getWidth() ? field.getWidth() : params.dims.x;
+    desc.height = field.getHeight() ? field.getHeight() : params.dims.y;
+    desc.depth = field.getDepth() ? field.getDepth() : 1;
+    desc.sampleCount = field.getSampleCount() ? field.getSampleCount() : 1;
+    desc.arraySize = field.getArraySize();
+    desc.mipLevels = field.getMipCount();
+    desc.bindFlags = field.getBindFlags();
 
     if (field.getType() != RenderPassReflection::Field::Type::RawBuffer)
     {
-        format = field.getFormat() == ResourceFormat::Unknown ? params.format : field.getFormat();
+        desc.format = field.getFormat() == ResourceFormat::Unknown ? params.format : field.getFormat();
         if (resolveBindFlags)
         {
             ResourceBindFlags mask = ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource;
@@ -147,41 +155,82 @@ inline ref<Resource> createResourceForPass(
             bool isInternal = is_set(field.getVisibility(), RenderPassReflection::Field::Visibility::Internal);
             if (isOutput || isInternal)
                 mask |= ResourceBindFlags::DepthStencil | ResourceBindFlags::RenderTarget;
-            auto supported = pDevice->getFormatBindFlags(format);
+            auto supported = pDevice->getFormatBindFlags(desc.format);
             mask &= supported;
-            bindFlags |= mask;
+            desc.bindFlags |= mask;
         }
     }
     else // RawBuffer
     {
         if (resolveBindFlags)
-            bindFlags = ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource;
+            desc.bindFlags = ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource;
     }
+
+    return desc;
+}
+
+/**
+ * Estimate the memory footprint of a resource. This ignores any alignment and padding done by the driver.
+ */
+uint64_t estimateResourceSize(const ResourceCache::ResourceDesc& desc)
+{
+    if (desc.type == RenderPassReflection::Field::Type::RawBuffer)
+        return desc.width;
+
+    uint64_t bytesPerBlock = getFormatBytesPerBlock(desc.format);
+    uint32_t widthRatio = getFormatWidthCompressionRatio(desc.format);
+    uint32_t heightRatio = getFormatHeightCompressionRatio(desc.format);
+    uint32_t faces = desc.type == RenderPassReflection::Field::Type::TextureCube ? 6 : 1;
+
+    uint64_t size = 0;
+    uint32_t width = desc.width;
+    uint32_t height = desc.height;
+    uint32_t depth = desc.depth;
+    for (uint32_t mip = 0; mip < desc.mipLevels; mip++)
+    {
+        uint64_t blocksX = div_round_up(width, widthRatio);
+        uint64_t blocksY = div_round_up(height, heightRatio);
+        size += blocksX * blocksY * depth * bytesPerBlock;
+        if (width == 1 && height == 1 && depth == 1)
+            break;
+        width = std::max(1u, width / 2);
+        height = std::max(1u, height / 2);
+        depth = std::max(1u, depth / 2);
+    }
+
+    return size * desc.arraySize * faces * desc.sampleCount;
+}
+
+ref<Resource> createResource(ref<Device> pDevice, const ResourceCache::ResourceDesc& desc, const std::string& resourceName)
+{
     ref<Resource> pResource;
 
-    switch (field.getType())
+    switch (desc.type)
     {
     case RenderPassReflection::Field::Type::RawBuffer:
-        pResource = pDevice->createBuffer(width, bindFlags, MemoryType::DeviceLocal);
+        pResource = pDevice->createBuffer(desc.width, desc.bindFlags, MemoryType::DeviceLocal);
         break;
     case RenderPassReflection::Field::Type::Texture1D:
-        pResource = pDevice->createTexture1D(width, format, arraySize, mipLevels, nullptr, bindFlags);
+        pResource = pDevice->createTexture1D(desc.width, desc.format, desc.arraySize, desc.mipLevels, nullptr, desc.bindFlags);
         break;
     case RenderPassReflection::Field::Type::Texture2D:
-        if (sampleCount > 1)
+        if (desc.sampleCount > 1)
         {
-            pResource = pDevice->createTexture2DMS(width, height, format, sampleCount, arraySize, bindFlags);
+            pResource =
+                pDevice->createTexture2DMS(desc.width, desc.height, desc.format, desc.sampleCount, desc.arraySize, desc.bindFlags);
         }
         else
         {
-            pResource = pDevice->createTexture2D(width, height, format, arraySize, mipLevels, nullptr, bindFlags);
+            pResource =
+                pDevice->createTexture2D(desc.width, desc.height, desc.format, desc.arraySize, desc.mipLevels, nullptr, desc.bindFlags);
         }
         break;
     case RenderPassReflection::Field::Type::Texture3D:
-        pResource = pDevice->createTexture3D(width, height, depth, format, mipLevels, nullptr, bindFlags);
+        pResource = pDevice->createTexture3D(desc.width, desc.height, desc.depth, desc.format, desc.mipLevels, nullptr, desc.bindFlags);
         break;
     case RenderPassReflection::Field::Type::TextureCube:
-        pResource = pDevice->createTextureCube(width, height, format, arraySize, mipLevels, nullptr, bindFlags);
+        pResource =
+            pDevice->createTextureCube(desc.width, desc.height, desc.format, desc.arraySize, desc.mipLevels, nullptr, desc.bindFlags);
         break;
     default:
         FALCOR_UNREACHABLE();
@@ -190,15 +239,91 @@ inline ref<Resource> createResourceForPass(
     pResource->setName(resourceName);
     return pResource;
 }
+} // namespace
 
-void ResourceCache::allocateResources(ref<Device> pDevice, const DefaultProperties& params)
+void ResourceCache::allocateResources(
+    ref<Device> pDevice,
+    const DefaultProperties& params,
+    bool aliasTransientResources,
+    const ResourceCache* pPrevious
+)
 {
-    for (auto& data : mResourceData)
+    // Collect the fields that need a resource and resolve their descriptions.
+    std::vector<uint32_t> pending;
+    std::vector<ResourceDesc> descs;
+    std::vector<ResourceDesc> classes;
+    std::vector<IntervalPacking::Item> items;
+
+    for (uint32_t i = 0; i < (uint32_t)mResourceData.size(); i++)
     {
-        if ((data.pResource == nullptr) && (data.field.isValid()))
+        auto& data = mResourceData[i];
+        if ((data.pResource != nullptr) || (data.field.isValid() == false))
+            continue;
+
+        ResourceDesc desc = resolveResourceDesc(pDevice.get(), params, data.field, data.resolveBindFlags);
+        auto it = std::find(classes.begin(), classes.end(), desc);
+        uint32_t compatibilityClass = (uint32_t)std::distance(classes.begin(), it);
+        if (it == classes.end())
+            classes.push_back(desc);
+
+        // Graph outputs are registered with a lifetime extending to the end of the execution (see RenderGraphCompiler).
+        // They, as well as internal and persistent fields, keep their content between frames and can't share a resource.
+        bool isInternal = is_set(data.field.getVisibility(), RenderPassReflection::Field::Visibility::Internal);
+        bool isGraphOutput = data.lifetime.second == uint32_t(-1);
+        bool aliasable = aliasTransientResources && !isInternal && !isGraphOutput && !data.persistent;
+
+        IntervalPacking::Item item;
+        item.begin = data.lifetime.first;
+        item.end = data.lifetime.second;
+        item.compatibilityClass = compatibilityClass;
+        item.size = estimateResourceSize(desc);
+        item.aliasable = aliasable;
+
+        pending.push_back(i);
+        descs.push_back(desc);
+        items.push_back(item);
+    }
+
+    IntervalPacking::Result packing = IntervalPacking::pack(items);
+
+    // Create one resource per slot and assign it to all fields packed into that slot.
+    std::vector<ref<Resource>> slotResources(packing.getSlotCount());
+    std::vector<std::string> slotNames(packing.getSlotCount());
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        std::string& slotName = slotNames[packing.slots[i]];
+        slotName += (slotName.empty() ? "" : "|") + mResourceData[pending[i]].name;
+    }
+
+    uint32_t reusedCount = 0;
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        uint32_t slot = packing.slots[i];
+        if (slotResources[slot] == nullptr)
         {
-            data.pResource = createResourceForPass(pDevice, params, data.field, data.resolveBindFlags, data.name);
+            // Reuse the resource from the previous allocation if it was created for the same fields and description.
+            const std::string& name = slotNames[slot];
+            if (pPrevious)
+            {
+                auto it = pPrevious->mAllocatedResources.find(name);
+                if (it != pPrevious->mAllocatedResources.end() && it->second.first == descs[i])
+                {
+                    slotResources[slot] = it->second.second;
+                    reusedCount++;
+                }
+            }
+            if (slotResources[slot] == nullptr)
+                slotResources[slot] = createResource(pDevice, descs[i], name);
+            mAllocatedResources[name] = {descs[i], slotResources[slot]};
         }
+        mResourceData[pending[i]].pResource = slotResources[slot];
     }
+
+    mAllocationStats.fieldCount = (uint32_t)pending.size();
+    mAllocationStats.resourceCount = packing.getSlotCount();
+    mAllocationStats.reusedCount = reusedCount;
+    mAllocationStats.bytesBefore = packing.bytesBefore;
+    mAllocationStats.bytesAfter = packing.bytesAfter;
+    mAllocationStats.peakLiveBytes = packing.peakLiveBytes;
 }
 } // namespace Falcor
@@ -51,6 +51,44 @@ public:
         ResourceFormat format = ResourceFormat::Unknown; ///< Format to use for texture creation
     };
 
+    /**
+     * Fully resolved description of a resource created for one or more fields.
+     * Fields resolving to the same description can share a resource.
+     */
+    struct ResourceDesc
+    {
+        RenderPassReflection::Field::Type type = RenderPassReflection::Field::Type::Texture2D;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t depth = 0;
+        uint32_t sampleCount = 0;
+        uint32_t arraySize = 0;
+        uint32_t mipLevels = 0;
+        ResourceFormat format = ResourceFormat::Unknown;
+        ResourceBindFlags bindFlags = ResourceBindFlags::None;
+
+        bool operator==(const ResourceDesc& other) const
+        {
+            return type == other.type && width == other.width && height == other.height && depth == other.depth &&
+                   sampleCount == other.sampleCount && arraySize == other.arraySize && mipLevels == other.mipLevels &&
+                   format == other.format && bindFlags == other.bindFlags;
+        }
+        bool operator!=(const ResourceDesc& other) const { return !(*this == other); }
+    };
+
+    /**
+     * Memory statistics for the last allocateResources() call.
+     */
+    struct AllocationStats
+    {
+        uint32_t fieldCount = 0;    ///< Number of resources requested by the graph fields.
+        uint32_t resourceCount = 0; ///< Number of resources used by the fields.
+        uint32_t reusedCount = 0;   ///< Number of resources reused from a previous allocation instead of being created.
+        uint64_t bytesBefore = 0;   ///< Estimated memory if every field gets its own resource.
+        uint64_t bytesAfter = 0;    ///< Estimated memory of the created resources.
+        uint64_t peakLiveBytes = 0; ///< Estimated memory live at the busiest point of the execution order.
+    };
+
     /**
      * Add/Remove reference to a graph input resource not owned by the cache
      * @param[in] name The resource's name
@@ -86,8 +124,24 @@ public:
     /**
      * Allocate all resources that need to be created/updated.
      * This includes new resources, resources whose properties have been updated since last allocation call.
+     * @param[in] pDevice GPU device.
+     * @param[in] params Default resource properties.
+     * @param[in] aliasTransientResources If true, fields with compatible descriptions and non-overlapping lifetimes share a single
+     * resource. Graph outputs, internal and persistent fields are never aliased.
+     * @param[in] pPrevious Optional. Cache from a previous compilation of the graph. Its resources are reused if both the set of fields
+     * sharing a resource and the resolved resource description are unchanged.
+     */
+    void allocateResources(
+        ref<Device> pDevice,
+        const DefaultProperties& params,
+        bool aliasTransientResources = false,
+        const ResourceCache* pPrevious = nullptr
+    );
+
+    /**
+     * Get memory statistics for the last allocateResources() call.
      */
-    void allocateResources(ref<Device> pDevice, const DefaultProperties& params);
+    const AllocationStats& getAllocationStats() const { return mAllocationStats; }
 
     /**
      * Clears all registered field/resource properties and allocated resources.
@@ -102,6 +156,7 @@ private:
         ref<Resource> pResource;                // The resource
         bool resolveBindFlags;                  // Whether or not we should resolve the field's bind-flags before creating the resource
         std::string name;                       // Full name of the resource, including the pass name
+        bool persistent;                        // Whether or not any of the aliased fields requires the resource to persist across frames
     };
 
     // Resources and properties for fields within (and therefore owned by) a render graph
@@ -110,6 +165,11 @@ private:
 
     // References to output resources not to be allocated by the render graph
     ResourcesMap mExternalResources;
+
+    // Resources created by allocateResources(), keyed by resource name (the names of all fields sharing the resource)
+    std::unordered_map<std::string, std::pair<ResourceDesc, ref<Resource>>> mAllocatedResources;
+
+    AllocationStats mAllocationStats;
 };
 
 } // namespace Falcor
@@ -29,7 +29,6 @@
 #include "EmissiveLightSampler.h"
 #include "Core/Macros.h"
 #include "Scene/Lights/LightCollection.h"
-#include <random>
 #include <vector>
 
 namespace Falcor
@@ -79,7 +78,6 @@ namespace Falcor
         // Internal state
         bool                            mNeedsRebuild = true;   ///< Trigger rebuild on the next call to update(). We should always build on the first call, so the initial value is true.
 
-        std::mt19937                    mAliasTableRng;
         AliasTable                      mTriangleTable;
     };
 }
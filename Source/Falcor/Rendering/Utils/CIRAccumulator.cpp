@@ -0,0 +1,240 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "CIRAccumulator.h"
+#include "Core/Error.h"
+#include "Utils/Threading.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+    namespace
+    {
+        const size_t kPathsPerTask = 4096;
+        const double kPi = 3.14159265358979323846;
+        const uint32_t kMaxAngleBins = 0xffffff;
+
+        uint64_t packBinKey(uint32_t delayBin, uint32_t angleBin, uint32_t bounceOrder)
+        {
+            return ((uint64_t)delayBin << 32) | ((uint64_t)angleBin << 8) | bounceOrder;
+        }
+
+        /** Per-path data computed in parallel before the paths are stored in order.
+        */
+        struct PathSample
+        {
+            double gain;
+            double delay;
+            uint64_t key;
+            bool valid;
+        };
+    }
+
+    uint16_t CompactCIRRecord::quantizeAngle(float angle)
+    {
+        float t = angle / (float)kPi;
+        if (!(t > 0.f)) return 0; // Also handles NaN.
+        return (uint16_t)std::lround(std::min(t, 1.f) * 65535.f);
+    }
+
+    float CompactCIRRecord::dequantizeAngle(uint16_t value)
+    {
+        return value * (float)(kPi / 65535.0);
+    }
+
+    double computeCIRPathGain(const CIRPathData& path, const CIRStaticParameters& params)
+    {
+        const double d = path.pathLength;
+        if (!(d > 0.0) || !std::isfinite(d)) return 0.0;
+        if (!(path.receptionAngle <= params.receiverFOV)) return 0.0;
+
+        const double cosPhi = std::cos((double)path.emissionAngle);
+        const double cosTheta = std::cos((double)path.receptionAngle);
+        if (!(cosPhi > 0.0) || !(cosTheta > 0.0)) return 0.0;
+
+        const double m = params.ledLambertianOrder;
+        double gain = (m + 1.0) / (2.0 * kPi) * std::pow(cosPhi, m) * cosTheta * params.receiverArea / (d * d);
+        gain *= (double)params.opticalFilterGain * params.opticalConcentration * path.reflectanceProduct;
+        return (std::isfinite(gain) && gain > 0.0) ? gain : 0.0;
+    }
+
+    CIRAccumulator::CIRAccumulator(const Desc& desc)
+        : mDesc(desc)
+    {
+        FALCOR_CHECK(mDesc.staticParams.lightSpeed > 0.f, "Light speed must be positive.");
+        FALCOR_CHECK(!mDesc.mergePaths || mDesc.delayBinWidth > 0.0, "Delay bin width must be positive.");
+        FALCOR_CHECK(
+            !mDesc.mergePaths || (mDesc.angleBinCount > 0 && mDesc.angleBinCount <= kMaxAngleBins),
+            "Angle bin count must be in [1, {}].",
+            kMaxAngleBins
+        );
+    }
+
+    void CIRAccumulator::addFrame(const CIRPathData* pPaths, size_t pathCount)
+    {
+        FALCOR_CHECK(pPaths != nullptr || pathCount == 0, "'pPaths' must not be null.");
+        mFrameCount++;
+        mPathCount += pathCount;
+        if (pathCount == 0) return;
+
+        // Compute delay, gain and bin of all paths in parallel.
+        const double lightSpeed = mDesc.staticParams.lightSpeed;
+        std::vector<PathSample> samples(pathCount);
+        Threading::parallelFor(0, (pathCount + kPathsPerTask - 1) / kPathsPerTask,
+            [&](size_t block)
+            {
+                const size_t end = std::min((block + 1) * kPathsPerTask, pathCount);
+                for (size_t i = block * kPathsPerTask; i < end; i++)
+                {
+                    const CIRPathData& path = pPaths[i];
+                    PathSample& s = samples[i];
+                    s.gain = computeCIRPathGain(path, mDesc.staticParams);
+                    s.delay = (double)path.pathLength / lightSpeed;
+                    s.key = 0;
+                    s.valid = s.gain > 0.0;
+                    if (s.valid && mDesc.mergePaths)
+                    {
+                        double delayBin = std::floor(s.delay / mDesc.delayBinWidth);
+                        s.valid = delayBin >= 0.0 && delayBin < 4294967296.0;
+                        double angle = std::max((double)path.receptionAngle, 0.0);
+                        uint32_t angleBin = std::min((uint32_t)(angle / kPi * mDesc.angleBinCount), mDesc.angleBinCount - 1);
+                        uint32_t bounceOrder = mDesc.separateBounceOrders ? std::min(path.reflectionCount, 255u) : 0;
+                        if (s.valid) s.key = packBinKey((uint32_t)delayBin, angleBin, bounceOrder);
+                    }
+                }
+            }
+        );
+
+        // Store in input order so that the sums are deterministic.
+        for (size_t i = 0; i < pathCount; i++)
+        {
+            const PathSample& s = samples[i];
+            if (!s.valid)
+            {
+                mSkippedPathCount++;
+                continue;
+            }
+
+            mTotalGain += s.gain;
+            if (mDesc.mergePaths)
+            {
+                BinData& bin = mBins[s.key];
+                bin.count++;
+                bin.gainSum += s.gain;
+                bin.delaySum += s.delay;
+            }
+            else
+            {
+                const CIRPathData& path = pPaths[i];
+                CompactCIRRecord record = {};
+                record.delay = (float)s.delay;
+                record.gain = (float)s.gain;
+                record.emissionAngle = CompactCIRRecord::quantizeAngle(path.emissionAngle);
+                record.receptionAngle = CompactCIRRecord::quantizeAngle(path.receptionAngle);
+                record.bounceOrder = (uint8_t)std::min(path.reflectionCount, 255u);
+                record.flags = (uint8_t)(path.flags & 0xff);
+                mRecords.push_back(record);
+            }
+        }
+    }
+
+    void CIRAccumulator::reset()
+    {
+        mFrameCount = 0;
+        mPathCount = 0;
+        mSkippedPathCount = 0;
+        mTotalGain = 0.0;
+        mRecords = {};
+        mBins = {};
+    }
+
+    size_t CIRAccumulator::getMemoryUsage() const
+    {
+        // Hash map nodes hold the value and a next pointer, plus one pointer per bucket.
+        size_t nodeBytes = sizeof(std::pair<const uint64_t, BinData>) + sizeof(void*);
+        size_t binBytes = mBins.size() * nodeBytes + mBins.bucket_count() * sizeof(void*);
+        return mRecords.capacity() * sizeof(CompactCIRRecord) + binBytes;
+    }
+
+    std::vector<CIRAccumulator::Bin> CIRAccumulator::getBins() const
+    {
+        std::vector<std::pair<uint64_t, BinData>> sorted(mBins.begin(), mBins.end());
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        std::vector<Bin> bins;
+        bins.reserve(sorted.size());
+        for (const auto& [key, data] : sorted)
+        {
+            Bin bin;
+            bin.delayBin = (uint32_t)(key >> 32);
+            bin.angleBin = (uint32_t)(key >> 8) & 0xffffff;
+            bin.bounceOrder = (uint8_t)(key & 0xff);
+            bin.count = data.count;
+            bin.gainSum = data.gainSum;
+            bin.delaySum = data.delaySum;
+            bins.push_back(bin);
+        }
+        return bins;
+    }
+
+    std::vector<double> CIRAccumulator::computeImpulseResponse(double binWidth, uint32_t binCount) const
+    {
+        FALCOR_CHECK(binWidth > 0.0, "Bin width must be positive.");
+        std::vector<double> h(binCount, 0.0);
+        if (mFrameCount == 0) return h;
+
+        auto addGain = [&](double index, double gain)
+        {
+            if (index >= 0.0 && index < binCount) h[(size_t)index] += gain;
+        };
+
+        if (mDesc.mergePaths)
+        {
+            // If the histogram bins are aligned with the delay bins, each delay bin maps to exactly one histogram bin.
+            const double ratio = binWidth / mDesc.delayBinWidth;
+            const double binsPerBin = std::round(ratio);
+            const bool aligned = binsPerBin >= 1.0 && std::abs(ratio - binsPerBin) <= 1e-9 * ratio;
+
+            // Accumulate in key order so the floating-point sums do not depend on the hash map iteration order.
+            for (const Bin& bin : getBins())
+            {
+                double index = aligned ? (double)(bin.delayBin / (uint64_t)binsPerBin) : std::floor(bin.delaySum / bin.count / binWidth);
+                addGain(index, bin.gainSum);
+            }
+        }
+        else
+        {
+            for (const CompactCIRRecord& record : mRecords)
+                addGain(std::floor(record.delay / binWidth), record.gain);
+        }
+
+        for (double& value : h)
+            value /= (double)mFrameCount;
+        return h;
+    }
+}
@@ -0,0 +1,164 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "PixelStats.h"
+#include "Core/Macros.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Falcor
+{
+    /** Compact CIR path record holding only what is needed for impulse response analysis.
+        16 bytes compared to the 150+ bytes of CIRPathData.
+    */
+    struct CompactCIRRecord
+    {
+        float delay;                ///< Propagation delay d/c (s).
+        float gain;                 ///< Channel DC gain of the path (see computeCIRPathGain()).
+        uint16_t emissionAngle;     ///< Emission angle quantized over [0, pi] (see quantizeAngle()).
+        uint16_t receptionAngle;    ///< Reception angle quantized over [0, pi] (see quantizeAngle()).
+        uint8_t bounceOrder;        ///< Number of reflections, clamped to 255.
+        uint8_t flags;              ///< Bits 0-7 of CIRPathData::flags.
+        uint16_t reserved;
+
+        static uint16_t quantizeAngle(float angle);
+        static float dequantizeAngle(uint16_t value);
+    };
+    static_assert(sizeof(CompactCIRRecord) == 16);
+
+    /** Compute the channel DC gain of a single path with the Lambertian VLC channel model:
+        H = (m + 1) / (2 pi) * cos^m(phi) * cos(theta) * A / d^2 * T_s * g * r
+        where phi/theta are the emission/reception angles, d is the path length and r is the reflectance product.
+        Paths outside the receiver field of view have zero gain.
+        \param[in] path CIR path.
+        \param[in] params Static channel parameters.
+        \return Gain of the path, or zero for paths without a valid length.
+    */
+    FALCOR_API double computeCIRPathGain(const CIRPathData& path, const CIRStaticParameters& params);
+
+    /** CPU ingestion stage that reduces raw CIR paths to a compact form for accumulation over many frames.
+
+        In record mode every path with non-zero gain is stored as a CompactCIRRecord.
+        In merge mode paths that fall into the same delay bin, reception angle bin and bounce order
+        are merged into a single bin. Each bin keeps the path count and the sums of gain and delay
+        in double precision, so the accumulated impulse response is the same as the one computed
+        from the raw paths.
+
+        Paths with invalid length or delay and paths with zero gain contribute nothing to h(t). They
+        are counted but not stored.
+    */
+    class FALCOR_API CIRAccumulator
+    {
+    public:
+        struct Desc
+        {
+            CIRStaticParameters staticParams;   ///< Channel parameters used to compute delay and gain.
+            bool mergePaths = true;             ///< Merge paths into bins. If false, keep one compact record per path.
+            double delayBinWidth = 1e-10;       ///< Width of the delay bins in seconds (merge mode only).
+            uint32_t angleBinCount = 1;         ///< Number of reception angle bins over [0, pi] (merge mode only).
+            bool separateBounceOrders = true;   ///< Keep different bounce orders in separate bins (merge mode only).
+        };
+
+        struct Bin
+        {
+            uint32_t delayBin = 0;      ///< Delay bin index. Covers [delayBin, delayBin + 1) * delayBinWidth.
+            uint32_t angleBin = 0;      ///< Reception angle bin index.
+            uint8_t bounceOrder = 0;    ///< Bounce order, or 0 if bounce orders are not separated.
+            uint64_t count = 0;         ///< Number of merged paths.
+            double gainSum = 0.0;       ///< Sum of the path gains.
+            double delaySum = 0.0;      ///< Sum of the path delays (s).
+
+            double getMeanDelay() const { return count > 0 ? delaySum / count : 0.0; }
+        };
+
+        explicit CIRAccumulator(const Desc& desc);
+
+        const Desc& getDesc() const { return mDesc; }
+
+        /** Add the paths of one frame.
+            \param[in] pPaths Array of CIR paths.
+            \param[in] pathCount Number of paths.
+        */
+        void addFrame(const CIRPathData* pPaths, size_t pathCount);
+
+        /** Remove all accumulated data.
+        */
+        void reset();
+
+        uint64_t getFrameCount() const { return mFrameCount; }
+        uint64_t getPathCount() const { return mPathCount; }
+        uint64_t getSkippedPathCount() const { return mSkippedPathCount; }
+
+        /** Returns the number of stored records (record mode) or bins (merge mode).
+        */
+        size_t getStoredCount() const { return mDesc.mergePaths ? mBins.size() : mRecords.size(); }
+
+        /** Returns an estimate of the CPU memory used for the accumulated data in bytes.
+        */
+        size_t getMemoryUsage() const;
+
+        /** Returns the sum of the gains of all accumulated paths.
+        */
+        double getTotalGain() const { return mTotalGain; }
+
+        /** Returns the stored records (record mode only).
+        */
+        const std::vector<CompactCIRRecord>& getRecords() const { return mRecords; }
+
+        /** Returns the merged bins sorted by delay, angle and bounce order (merge mode only).
+        */
+        std::vector<Bin> getBins() const;
+
+        /** Compute the impulse response histogram averaged over the accumulated frames.
+            Bin k holds the gain sum of all paths with delay in [k, k + 1) * binWidth divided by the frame count.
+            In merge mode, the result is exact if binWidth is an integer multiple of Desc::delayBinWidth.
+            Otherwise merged bins are placed by their mean delay.
+            \param[in] binWidth Histogram bin width in seconds.
+            \param[in] binCount Number of histogram bins. Later delays are not included.
+            \return Impulse response histogram.
+        */
+        std::vector<double> computeImpulseResponse(double binWidth, uint32_t binCount) const;
+
+    private:
+        struct BinData
+        {
+            uint64_t count = 0;
+            double gainSum = 0.0;
+            double delaySum = 0.0;
+        };
+
+        Desc mDesc;
+        uint64_t mFrameCount = 0;
+        uint64_t mPathCount = 0;
+        uint64_t mSkippedPathCount = 0;
+        double mTotalGain = 0.0;
+        std::vector<CompactCIRRecord> mRecords;
+        std::unordered_map<uint64_t, BinData> mBins;
+    };
+}
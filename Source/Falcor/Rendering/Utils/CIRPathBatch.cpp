@@ -0,0 +1,325 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "CIRPathBatch.h"
+#include "Core/Error.h"
+#include "Utils/Threading.h"
+#include "Utils/Math/ScalarMath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <emmintrin.h>
+#define FALCOR_CIR_BATCH_SSE2 1
+#else
+#define FALCOR_CIR_BATCH_SSE2 0
+#endif
+
+namespace Falcor
+{
+    namespace
+    {
+        const size_t kPathsPerTask = 4096;
+
+        // Must match PixelStats::decompressVertex() and PixelStats::validateCIRVertexData().
+        const float kErrorMarker = 0.666f;
+        const float kMaxWorldCoordinate = 1000000.0f;
+
+        // A half with all exponent bits set is infinite or NaN. Finite halves are always below the
+        // 100km distance limit of PixelStats::decompressVertex(), so this is the only check needed.
+        const uint32_t kHalfExponentMask = 0x7c00;
+
+        // The compressed vertices are read as one contiguous array of words.
+        static_assert(sizeof(CIRPathData::CompressedVertex) == 2 * sizeof(uint32_t));
+        static_assert(
+            offsetof(CIRPathData, vertexCount) == offsetof(CIRPathData, compressedVertices) + 7 * sizeof(CIRPathData::CompressedVertex)
+        );
+        static_assert(offsetof(CIRPathData, basePosition) == offsetof(CIRPathData, vertexCount) + sizeof(uint32_t));
+
+        bool isBasePositionValid(const float3& p)
+        {
+            return std::isfinite(p.x) && std::isfinite(p.y) && std::isfinite(p.z) &&
+                std::abs(p.x) <= kMaxWorldCoordinate && std::abs(p.y) <= kMaxWorldCoordinate && std::abs(p.z) <= kMaxWorldCoordinate;
+        }
+
+        /** Same criteria as CIRPathData::isValid() without the per-path logging.
+        */
+        bool passesRanges(const CIRPathData& p, const CIRBatchFilter& f)
+        {
+            if (p.pathLength < 0.f || p.emittedPower < 0.f || p.emissionAngle < 0.f || p.receptionAngle < 0.f || p.reflectanceProduct < 0.f)
+                return false;
+
+            return p.pathLength >= f.minPathLength && p.pathLength <= f.maxPathLength &&
+                p.emissionAngle >= f.minAngle && p.emissionAngle <= f.maxAngle &&
+                p.receptionAngle >= f.minAngle && p.receptionAngle <= f.maxAngle &&
+                p.reflectanceProduct >= f.minReflectance && p.reflectanceProduct <= f.maxReflectance &&
+                p.emittedPower >= f.minEmittedPower && p.emittedPower <= f.maxEmittedPower;
+        }
+
+#if FALCOR_CIR_BATCH_SSE2
+        /** Convert four halves (one per 32-bit lane, upper bits zero) to floats. Exact for all inputs including denormals, inf and NaN.
+        */
+        __m128 halfToFloat(__m128i h)
+        {
+            const __m128i maskNoSign = _mm_set1_epi32(0x7fff);
+            const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
+            const __m128i wasInfNaN = _mm_set1_epi32(0x7bff);
+            const __m128 expInfNaN = _mm_castsi128_ps(_mm_set1_epi32(255 << 23));
+
+            __m128i expMant = _mm_and_si128(maskNoSign, h);
+            __m128i sign = _mm_slli_epi32(_mm_xor_si128(h, expMant), 16);
+            __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expMant, 13)), magic);
+            __m128 infNaNExp = _mm_and_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(expMant, wasInfNaN)), expInfNaN);
+            return _mm_or_ps(scaled, _mm_or_ps(_mm_castsi128_ps(sign), infNaNExp));
+        }
+
+        __m128i isHalfInfOrNaN(__m128i h)
+        {
+            const __m128i expMask = _mm_set1_epi32(kHalfExponentMask);
+            return _mm_cmpeq_epi32(_mm_and_si128(h, expMask), expMask);
+        }
+
+        /** Decompress four vertices from their packed words.
+            \return Bit mask of the active lanes that failed to decompress.
+        */
+        uint32_t decodeVertices4(__m128i xs, __m128i ys, __m128i active, const float3& base, float* pX, float* pY, float* pZ)
+        {
+            const __m128i lowMask = _mm_set1_epi32(0xffff);
+            const __m128 marker = _mm_set1_ps(kErrorMarker);
+
+            // Inactive lanes are zeroed first. They may contain small integers (e.g. vertexCount), which would be
+            // converted through float denormals and take a slow microcode path on many CPUs.
+            xs = _mm_and_si128(xs, active);
+            ys = _mm_and_si128(ys, active);
+            __m128i hx = _mm_and_si128(xs, lowMask);
+            __m128i hy = _mm_srli_epi32(xs, 16);
+            __m128i hz = _mm_and_si128(ys, lowMask);
+            __m128i invalid = _mm_or_si128(_mm_or_si128(isHalfInfOrNaN(hx), isHalfInfOrNaN(hy)), isHalfInfOrNaN(hz));
+            __m128 invalidPs = _mm_castsi128_ps(invalid);
+            __m128 activePs = _mm_castsi128_ps(active);
+
+            auto finish = [&](__m128i h, float b, float* pDst)
+            {
+                __m128 v = _mm_add_ps(halfToFloat(h), _mm_set1_ps(b));
+                v = _mm_or_ps(_mm_and_ps(invalidPs, marker), _mm_andnot_ps(invalidPs, v));
+                _mm_storeu_ps(pDst, _mm_and_ps(activePs, v));
+            };
+            finish(hx, base.x, pX);
+            finish(hy, base.y, pY);
+            finish(hz, base.z, pZ);
+
+            return (uint32_t)_mm_movemask_ps(_mm_and_ps(invalidPs, activePs));
+        }
+
+        /** Decompress all vertex slots of a path into kVertexStride consecutive floats per component.
+            \return Number of active vertices that failed to decompress.
+        */
+        uint32_t decodePath(const CIRPathData& path, uint32_t vertexCount, float* pX, float* pY, float* pZ)
+        {
+            // Words are x0 y0 x1 y1 ... x6 y6. The last load also covers vertexCount, which is masked out.
+            const uint32_t* pWords = &path.compressedVertices[0].x;
+            __m128 w0 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(pWords + 0)));
+            __m128 w1 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(pWords + 4)));
+            __m128 w2 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(pWords + 8)));
+            __m128 w3 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(pWords + 12)));
+
+            __m128i count = _mm_set1_epi32((int)vertexCount);
+            __m128i active0 = _mm_cmplt_epi32(_mm_setr_epi32(0, 1, 2, 3), count);
+            __m128i active1 = _mm_cmplt_epi32(_mm_setr_epi32(4, 5, 6, 7), count);
+
+            uint32_t invalid = decodeVertices4(
+                _mm_castps_si128(_mm_shuffle_ps(w0, w1, _MM_SHUFFLE(2, 0, 2, 0))),
+                _mm_castps_si128(_mm_shuffle_ps(w0, w1, _MM_SHUFFLE(3, 1, 3, 1))),
+                active0, path.basePosition, pX, pY, pZ
+            );
+            invalid |= decodeVertices4(
+                _mm_castps_si128(_mm_shuffle_ps(w2, w3, _MM_SHUFFLE(2, 0, 2, 0))),
+                _mm_castps_si128(_mm_shuffle_ps(w2, w3, _MM_SHUFFLE(3, 1, 3, 1))),
+                active1, path.basePosition, pX + 4, pY + 4, pZ + 4
+            ) << 4;
+
+            uint32_t invalidCount = 0;
+            for (; invalid != 0; invalid &= invalid - 1)
+                invalidCount++;
+            return invalidCount;
+        }
+#else
+        uint32_t decodePath(const CIRPathData& path, uint32_t vertexCount, float* pX, float* pY, float* pZ)
+        {
+            uint32_t invalidCount = 0;
+            for (uint32_t v = 0; v < CIRVertexBatch::kVertexStride; v++)
+            {
+                float3 p(0.f);
+                if (v < vertexCount)
+                {
+                    const CIRPathData::CompressedVertex& c = path.compressedVertices[v];
+                    uint32_t hx = c.x & 0xffff, hy = c.x >> 16, hz = c.y & 0xffff;
+                    if ((hx & kHalfExponentMask) == kHalfExponentMask || (hy & kHalfExponentMask) == kHalfExponentMask ||
+                        (hz & kHalfExponentMask) == kHalfExponentMask)
+                    {
+                        p = float3(kErrorMarker);
+                        invalidCount++;
+                    }
+                    else
+                    {
+                        p = path.basePosition + float3(math::f16tof32(hx), math::f16tof32(hy), math::f16tof32(hz));
+                    }
+                }
+                pX[v] = p.x;
+                pY[v] = p.y;
+                pZ[v] = p.z;
+            }
+            return invalidCount;
+        }
+#endif
+
+        void addStats(CIRBatchStats& dst, const CIRBatchStats& src)
+        {
+            dst.outputPaths += src.outputPaths;
+            dst.decodedVertices += src.decodedVertices;
+            dst.invalidVertices += src.invalidVertices;
+            dst.invalidPaths += src.invalidPaths;
+        }
+
+        template<typename T>
+        void moveRange(std::vector<T>& v, size_t dst, size_t src, size_t count)
+        {
+            std::memmove(v.data() + dst, v.data() + src, count * sizeof(T));
+        }
+    }
+
+    void CIRVertexBatch::clear()
+    {
+        pathIndices.clear();
+        flags.clear();
+        vertexCounts.clear();
+        vertexDataValid.clear();
+        x.clear();
+        y.clear();
+        z.clear();
+    }
+
+    CIRBatchStats decompressCIRPaths(const CIRPathData* pPaths, size_t pathCount, const CIRBatchFilter& filter, CIRVertexBatch& batch)
+    {
+        FALCOR_CHECK(pPaths != nullptr || pathCount == 0, "'pPaths' must not be null.");
+        FALCOR_CHECK(pathCount <= std::numeric_limits<uint32_t>::max(), "Too many CIR paths ({}).", pathCount);
+        if (filter.useRanges)
+        {
+            FALCOR_CHECK(filter.minPathLength >= 0.f && filter.maxPathLength >= filter.minPathLength &&
+                filter.minEmittedPower >= 0.f && filter.maxEmittedPower >= filter.minEmittedPower &&
+                filter.minAngle >= 0.f && filter.maxAngle >= filter.minAngle &&
+                filter.minReflectance >= 0.f && filter.maxReflectance >= filter.minReflectance,
+                "Invalid CIR filter ranges.");
+        }
+
+        const uint32_t kStride = CIRVertexBatch::kVertexStride;
+        batch.pathIndices.resize(pathCount);
+        batch.flags.resize(pathCount);
+        batch.vertexCounts.resize(pathCount);
+        batch.vertexDataValid.resize(pathCount);
+        batch.x.resize(pathCount * kStride);
+        batch.y.resize(pathCount * kStride);
+        batch.z.resize(pathCount * kStride);
+
+        // Decode and filter each block in parallel. Selected paths are compacted to the start of their block.
+        const size_t blockCount = (pathCount + kPathsPerTask - 1) / kPathsPerTask;
+        std::vector<CIRBatchStats> blockStats(blockCount);
+        Threading::parallelFor(0, blockCount,
+            [&](size_t block)
+            {
+                const size_t begin = block * kPathsPerTask;
+                const size_t end = std::min(begin + kPathsPerTask, pathCount);
+                CIRBatchStats& stats = blockStats[block];
+                size_t out = begin;
+
+                for (size_t i = begin; i < end; i++)
+                {
+                    const CIRPathData& path = pPaths[i];
+                    if ((path.flags & filter.requiredFlags) != filter.requiredFlags || (path.flags & filter.excludedFlags) != 0)
+                        continue;
+                    if (filter.useRanges && !passesRanges(path, filter))
+                        continue;
+
+                    uint32_t vertexCount = std::min(path.vertexCount, CIRVertexBatch::kMaxVertices);
+                    const size_t slot = out * kStride;
+                    uint32_t invalidVertices = decodePath(path, vertexCount, &batch.x[slot], &batch.y[slot], &batch.z[slot]);
+                    bool valid = path.vertexCount <= CIRVertexBatch::kMaxVertices && invalidVertices == 0 &&
+                        isBasePositionValid(path.basePosition);
+
+                    stats.decodedVertices += vertexCount;
+                    stats.invalidVertices += invalidVertices;
+                    if (!valid)
+                    {
+                        stats.invalidPaths++;
+                        if (filter.requireValidVertexData)
+                            continue; // The slot is overwritten by the next selected path.
+                    }
+
+                    batch.pathIndices[out] = (uint32_t)i;
+                    batch.flags[out] = path.flags;
+                    batch.vertexCounts[out] = vertexCount;
+                    batch.vertexDataValid[out] = valid ? 1 : 0;
+                    out++;
+                }
+                stats.outputPaths = out - begin;
+            }
+        );
+
+        // Move the compacted blocks together. Blocks only move towards the front, so this is done in order.
+        CIRBatchStats result;
+        result.inputPaths = pathCount;
+        for (size_t block = 0; block < blockCount; block++)
+        {
+            const size_t src = block * kPathsPerTask;
+            const size_t dst = result.outputPaths;
+            const size_t count = blockStats[block].outputPaths;
+            if (dst != src && count > 0)
+            {
+                moveRange(batch.pathIndices, dst, src, count);
+                moveRange(batch.flags, dst, src, count);
+                moveRange(batch.vertexCounts, dst, src, count);
+                moveRange(batch.vertexDataValid, dst, src, count);
+                moveRange(batch.x, dst * kStride, src * kStride, count * kStride);
+                moveRange(batch.y, dst * kStride, src * kStride, count * kStride);
+                moveRange(batch.z, dst * kStride, src * kStride, count * kStride);
+            }
+            addStats(result, blockStats[block]);
+        }
+
+        batch.pathIndices.resize(result.outputPaths);
+        batch.flags.resize(result.outputPaths);
+        batch.vertexCounts.resize(result.outputPaths);
+        batch.vertexDataValid.resize(result.outputPaths);
+        batch.x.resize(result.outputPaths * kStride);
+        batch.y.resize(result.outputPaths * kStride);
+        batch.z.resize(result.outputPaths * kStride);
+
+        return result;
+    }
+}
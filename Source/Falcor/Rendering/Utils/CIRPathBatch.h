@@ -0,0 +1,129 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "PixelStats.h"
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Falcor
+{
+    /** Selection criteria for batch decompression of CIR paths.
+        The default settings keep all paths.
+    */
+    struct CIRBatchFilter
+    {
+        uint32_t requiredFlags = 0;             ///< Flag bits that must all be set (see CIRPathData::flags).
+        uint32_t excludedFlags = 0;             ///< Flag bits that must all be cleared.
+        bool requireValidVertexData = false;    ///< Drop paths whose vertex data fails validation.
+
+        /** Range criteria matching CIRPathData::isValid(). Only applied if useRanges is set.
+        */
+        bool useRanges = false;
+        float minPathLength = 0.f;
+        float maxPathLength = std::numeric_limits<float>::max();
+        float minEmittedPower = 0.f;
+        float maxEmittedPower = std::numeric_limits<float>::max();
+        float minAngle = 0.f;
+        float maxAngle = std::numeric_limits<float>::max();
+        float minReflectance = 0.f;
+        float maxReflectance = std::numeric_limits<float>::max();
+
+        /** Keep only NEE paths (isNEEPath flag set).
+        */
+        static CIRBatchFilter neePaths() { CIRBatchFilter f; f.requiredFlags = 0x2; return f; }
+
+        /** Keep only regular paths (isNEEPath flag cleared).
+        */
+        static CIRBatchFilter regularPaths() { CIRBatchFilter f; f.excludedFlags = 0x2; return f; }
+    };
+
+    /** Decompressed vertices of a batch of CIR paths in columnar (SoA) layout.
+
+        The vertices of the i-th path in the batch are stored at
+        [i * kVertexStride, i * kVertexStride + vertexCounts[i]) in the x, y and z arrays.
+        Unused vertex slots are zero. Vertices that fail to decompress hold the same error
+        marker (0.666, 0.666, 0.666) as PixelStats::decompressVertex().
+
+        A batch can be reused across calls to decompressCIRPaths() to avoid reallocation.
+    */
+    struct CIRVertexBatch
+    {
+        static constexpr uint32_t kMaxVertices = 7;
+        static constexpr uint32_t kVertexStride = 8;
+
+        std::vector<uint32_t> pathIndices;      ///< Index of each path in the source array.
+        std::vector<uint32_t> flags;            ///< Copy of CIRPathData::flags.
+        std::vector<uint32_t> vertexCounts;     ///< Number of stored vertices (clamped to kMaxVertices).
+        std::vector<uint8_t> vertexDataValid;   ///< 1 if the vertex data passed validation (see PixelStats::validateCIRVertexData()).
+        std::vector<float> x;                   ///< Vertex x coordinates in world space.
+        std::vector<float> y;                   ///< Vertex y coordinates in world space.
+        std::vector<float> z;                   ///< Vertex z coordinates in world space.
+
+        size_t getPathCount() const { return pathIndices.size(); }
+
+        float3 getVertex(size_t pathIndex, uint32_t vertexIndex) const
+        {
+            size_t i = pathIndex * kVertexStride + vertexIndex;
+            return float3(x[i], y[i], z[i]);
+        }
+
+        void clear();
+    };
+
+    /** Statistics returned by decompressCIRPaths().
+    */
+    struct CIRBatchStats
+    {
+        size_t inputPaths = 0;          ///< Number of paths in the input.
+        size_t outputPaths = 0;         ///< Number of paths that passed the filter.
+        size_t decodedVertices = 0;     ///< Number of vertices decompressed.
+        size_t invalidVertices = 0;     ///< Number of vertices that decompressed to non-finite values.
+        size_t invalidPaths = 0;        ///< Number of paths with invalid vertex data.
+    };
+
+    /** Decompress and validate the vertices of a batch of CIR paths in a single pass.
+        This is the batched equivalent of calling PixelStats::validateCIRVertexData() and
+        PixelStats::decompressPathVertices() per path. The paths are processed in parallel
+        and the vertex unpacking uses SIMD where available. The only difference to the per-path
+        validation is that a vertex which decodes exactly to the error marker is not rejected.
+        \param[in] pPaths Array of CIR paths.
+        \param[in] pathCount Number of paths.
+        \param[in] filter Selection criteria. Paths that are rejected are not stored in the batch.
+        \param[out] batch Decompressed vertices of the selected paths, in input order.
+        \return Statistics about the processed paths.
+    */
+    FALCOR_API CIRBatchStats decompressCIRPaths(
+        const CIRPathData* pPaths,
+        size_t pathCount,
+        const CIRBatchFilter& filter,
+        CIRVertexBatch& batch
+    );
+}
@@ -26,13 +26,17 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "PixelStats.h"
+#include "CIRAccumulator.h"
+#include "CIRPathBatch.h"
 #include "Core/API/RenderContext.h"
 #include "Scene/Scene.h"
 #include "Scene/Camera/Camera.h"
 #include "Scene/Lights/Light.h"
 #include "Utils/Math/FalcorMath.h"
 #include "Utils/Logger.h"
+#include "Utils/Timing/CpuTimer.h"
 #include "Utils/Scripting/ScriptBindings.h"
+#include "Utils/Scripting/ndarray.h"
 #include <sstream>
 #include <iomanip>
 #include <fstream>
@@ -70,6 +74,70 @@ namespace Falcor
             d["avgRayWavelength"] = stats.avgRayWavelength;
             return d;
         }
+
+        /** Copy the batch-decompressed vertices of a path.
+        */
+        void getBatchVertices(const CIRVertexBatch& batch, size_t pathIndex, std::vector<float3>& vertices)
+        {
+            vertices.clear();
+            for (uint32_t v = 0; v < batch.vertexCounts[pathIndex]; v++)
+                vertices.push_back(batch.getVertex(pathIndex, v));
+        }
+
+        /** Create a NumPy structured dtype matching the memory layout of CIRPathData.
+            DLPack has no structured types, so the view is created through NumPy.
+        */
+        pybind11::object getCIRPathDataDtype()
+        {
+            pybind11::list names, formats, offsets;
+            auto addField = [&](const char* name, const char* format, size_t offset)
+            {
+                names.append(name);
+                formats.append(format);
+                offsets.append(offset);
+            };
+            addField("pathLength", "<f4", offsetof(CIRPathData, pathLength));
+            addField("emissionAngle", "<f4", offsetof(CIRPathData, emissionAngle));
+            addField("receptionAngle", "<f4", offsetof(CIRPathData, receptionAngle));
+            addField("reflectanceProduct", "<f4", offsetof(CIRPathData, reflectanceProduct));
+            addField("reflectionCount", "<u4", offsetof(CIRPathData, reflectionCount));
+            addField("emittedPower", "<f4", offsetof(CIRPathData, emittedPower));
+            addField("originalEmittedPower", "<f4", offsetof(CIRPathData, originalEmittedPower));
+            addField("pixelX", "<u4", offsetof(CIRPathData, pixelX));
+            addField("pixelY", "<u4", offsetof(CIRPathData, pixelY));
+            addField("pathIndex", "<u4", offsetof(CIRPathData, pathIndex));
+            addField("flags", "<u4", offsetof(CIRPathData, flags));
+            addField("compressedVertices", "(7,2)<u4", offsetof(CIRPathData, compressedVertices));
+            addField("vertexCount", "<u4", offsetof(CIRPathData, vertexCount));
+            addField("basePosition", "(3,)<f4", offsetof(CIRPathData, basePosition));
+            addField("lightSourcePosition", "(4,)<f4", offsetof(CIRPathData, lightSourcePosition));
+            addField("primaryRayPdfW", "<f4", offsetof(CIRPathData, primaryRayPdfW));
+            addField("radianceRGBA", "(4,)<f4", offsetof(CIRPathData, radianceRGBA));
+
+            pybind11::dict desc;
+            desc["names"] = names;
+            desc["formats"] = formats;
+            desc["offsets"] = offsets;
+            desc["itemsize"] = sizeof(CIRPathData);
+            return pybind11::module::import("numpy").attr("dtype")(desc);
+        }
+
+        /** Create a zero-copy NumPy view of CIR path data. The view shares ownership of the data.
+        */
+        pybind11::object toNumpy(std::shared_ptr<const std::vector<CIRPathData>> pData)
+        {
+            using SharedData = std::shared_ptr<const std::vector<CIRPathData>>;
+            if (!pData || pData->empty()) return pybind11::module::import("numpy").attr("empty")(0, getCIRPathDataDtype());
+
+            // Export the raw bytes through DLPack and reinterpret them with the structured dtype.
+            void* pBytes = const_cast<CIRPathData*>(pData->data());
+            pybind11::size_t shape[1] = {pData->size() * sizeof(CIRPathData)};
+            pybind11::capsule owner(new SharedData(std::move(pData)), [](void* p) noexcept { delete reinterpret_cast<SharedData*>(p); });
+            pybind11::ndarray<pybind11::numpy> byteArray(
+                pBytes, 1, shape, owner, nullptr, pybind11::dtype<uint8_t>(), pybind11::device::cpu::value
+            );
+            return pybind11::cast(byteArray, pybind11::return_value_policy::reference).attr("view")(getCIRPathDataDtype());
+        }
     }
 
     PixelStats::PixelStats(ref<Device> pDevice)
@@ -78,8 +146,13 @@ namespace Falcor
         mpComputeRayCount = ComputePass::create(mpDevice, kComputeRayCountFilename, "main");
     }
 
+    PixelStats::~PixelStats() = default;
+
     void PixelStats::beginFrame(RenderContext* pRenderContext, const uint2& frameDim)
     {
+        // Accumulate the CIR paths of the previous frame before its readback is discarded.
+        if (mCIRAccumulationEnabled && mCIRRawDataPending) copyCIRRawDataToCPU();
+
         // Prepare state.
         FALCOR_ASSERT(!mRunning);
         mRunning = true;
@@ -92,6 +165,12 @@ namespace Falcor
         mStatsBuffersValid = false;
         mRayCountTextureValid = false;
         mCIRRawDataValid = false;
+        mCIRSummaryPending = false;
+        mCIRRawDataPending = false;
+
+        // Keep the readback cost of the previous frame for display.
+        mLastCIRReadbackTime = mCIRReadbackTime;
+        mCIRReadbackTime = CIRReadbackTime();
 
         if (mEnabled)
         {
@@ -189,10 +268,20 @@ namespace Falcor
             // Process raw CIR data collection if enabled
             if (mCollectionMode == PixelStatsCollectionMode::RawData || mCollectionMode == PixelStatsCollectionMode::Both)
             {
-                // Copy counter to readback buffer
-                pRenderContext->copyBufferRegion(mpCIRCounterReadback.get(), 0, mpCIRCounterBuffer.get(), 0, sizeof(uint32_t));
+                // Copy counters to the summary readback buffer. This is all the UI and stats need.
+                auto copyCounter = [&](CIRSummaryField field, const ref<Buffer>& pCounter)
+                {
+                    uint64_t offset = (uint64_t)field * sizeof(uint32_t);
+                    pRenderContext->copyBufferRegion(mpCIRSummaryReadback.get(), offset, pCounter.get(), 0, sizeof(uint32_t));
+                };
+                copyCounter(CIRSummaryField::PathCount, mpCIRCounterBuffer);
+
+                // P1 optimization: Copy path type counters
+                if (mpNEEPathCounterBuffer) copyCounter(CIRSummaryField::NEEPathCount, mpNEEPathCounterBuffer);
+                if (mpRegularPathCounterBuffer) copyCounter(CIRSummaryField::RegularPathCount, mpRegularPathCounterBuffer);
 
-                // Copy raw data to readback buffer using runtime struct stride to avoid layout mismatch
+                // Copy raw data to readback buffer using runtime struct stride to avoid layout mismatch.
+                // The copy runs asynchronously on the GPU, the CPU only maps it on explicit request (export/getCIRRawData()).
                 pRenderContext->copyBufferRegion(
                     mpCIRRawDataReadback.get(),
                     0,
@@ -201,15 +290,8 @@ namespace Falcor
                     (size_t)mMaxCIRPathsPerFrame * (size_t)mpCIRRawDataBuffer->getStructSize()
                 );
 
-                // P1 optimization: Copy path type counters to readback buffers
-                if (mpNEEPathCounterBuffer && mpNEEPathCounterReadback)
-                {
-                    pRenderContext->copyBufferRegion(mpNEEPathCounterReadback.get(), 0, mpNEEPathCounterBuffer.get(), 0, sizeof(uint32_t));
-                }
-                if (mpRegularPathCounterBuffer && mpRegularPathCounterReadback)
-                {
-                    pRenderContext->copyBufferRegion(mpRegularPathCounterReadback.get(), 0, mpRegularPathCounterBuffer.get(), 0, sizeof(uint32_t));
-                }
+                mCIRSummaryPending = true;
+                mCIRRawDataPending = true;
             }
 
             // Submit command list and insert signal.
@@ -292,11 +374,6 @@ namespace Falcor
                         ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess,
                         MemoryType::DeviceLocal
                     );
-                    mpCIRCounterReadback = mpDevice->createBuffer(
-                        sizeof(uint32_t),
-                        ResourceBindFlags::None,
-                        MemoryType::ReadBack
-                    );
                     logInfo("Created CIR counter buffer: {} bytes", sizeof(uint32_t));
                 }
 
@@ -308,11 +385,6 @@ namespace Falcor
                         ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess,
                         MemoryType::DeviceLocal
                     );
-                    mpNEEPathCounterReadback = mpDevice->createBuffer(
-                        sizeof(uint32_t),
-                        ResourceBindFlags::None,
-                        MemoryType::ReadBack
-                    );
                     logInfo("Created NEE path counter buffer");
                 }
 
@@ -323,12 +395,17 @@ namespace Falcor
                         ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess,
                         MemoryType::DeviceLocal
                     );
-                    mpRegularPathCounterReadback = mpDevice->createBuffer(
-                        sizeof(uint32_t),
+                    logInfo("Created regular path counter buffer");
+                }
+
+                if (!mpCIRSummaryReadback)
+                {
+                    // Path counters packed into one buffer so that the UI only needs a single small map per frame.
+                    mpCIRSummaryReadback = mpDevice->createBuffer(
+                        (size_t)CIRSummaryField::Count * sizeof(uint32_t),
                         ResourceBindFlags::None,
                         MemoryType::ReadBack
                     );
-                    logInfo("Created regular path counter buffer");
                 }
 
                 // Direct binding following PixelInspectorPass pattern - variables always exist now
@@ -410,12 +487,16 @@ namespace Falcor
                     mCIRExportFormat = (CIRExportFormat)format;
                 }
 
-                // CIR raw data controls
-                copyCIRRawDataToCPU();
+                // CIR counters. Only the small summary buffer is read back here, the raw data is read on export.
+                copyCIRSummaryToCPU();
 
-                // Display filtered CIR paths count with original count for reference
-                uint32_t filteredCount = mCIRRawDataValid ? static_cast<uint32_t>(mCIRRawData.size()) : 0;
-                if (mCIRFilteringEnabled) {
+                // Display filtered CIR paths count with original count for reference.
+                // The filtered count is only known if the raw data of this frame has been read back.
+                uint32_t filteredCount = mCIRRawDataValid ? static_cast<uint32_t>(mpCIRRawData->size()) : 0;
+                if (!mCIRRawDataValid) {
+                    widget.text(fmt::format("CIR paths: {} collected", mCollectedCIRPaths));
+                    widget.tooltip("Shows collected CIR paths count from the GPU counter. Filtering runs when raw data is read back.");
+                } else if (mCIRFilteringEnabled) {
                     widget.text(fmt::format("CIR paths: {} filtered / {} collected", filteredCount, mCollectedCIRPaths));
                     widget.tooltip("Shows filtered CIR paths count vs total collected paths");
                 } else {
@@ -423,6 +504,10 @@ namespace Falcor
                     widget.tooltip("Shows collected CIR paths count (no filtering applied)");
                 }
 
+                widget.text(fmt::format("Readback CPU time: {:.3f} ms summary, {:.3f} ms raw data ({} records)",
+                    mLastCIRReadbackTime.summaryMs, mLastCIRReadbackTime.rawDataMs, mLastCIRReadbackTime.rawDataRecords));
+                widget.tooltip("CPU time spent on CIR readback in the previous frame. Raw data is only read back on export.");
+
                 // NEE-CIR: Display buffer usage information
                 if (mCollectedCIRPaths > 0)
                 {
@@ -447,7 +532,7 @@ namespace Falcor
                     uint32_t neeCircCount = 0;
                     if (mCIRRawDataValid)
                     {
-                        for (const auto& data : mCIRRawData)
+                        for (const auto& data : *mpCIRRawData)
                         {
                             if (data.getHitEmissiveSurface()) neeCircCount++;
                         }
@@ -472,6 +557,21 @@ namespace Falcor
                     exportCIRData("cir_data.txt", mpScene);
                 }
 
+                if (auto group = widget.group("CIR Accumulation"))
+                {
+                    group.checkbox("Accumulate CIR", mCIRAccumulationEnabled);
+                    group.tooltip("Merge the CIR paths of every frame into delay/angle/bounce bins. Reads back the raw data every frame.");
+
+                    if (mpCIRAccumulator)
+                    {
+                        group.text(fmt::format("Frames: {}, paths: {}, bins: {}", mpCIRAccumulator->getFrameCount(),
+                            mpCIRAccumulator->getPathCount(), mpCIRAccumulator->getStoredCount()));
+                        group.text(fmt::format("Memory: {:.1f} KB, total gain: {:.3e}", mpCIRAccumulator->getMemoryUsage() / 1024.0,
+                            mpCIRAccumulator->getTotalGain()));
+                        if (group.button("Reset accumulation")) resetCIRAccumulation();
+                    }
+                }
+
                 // P0/P1 optimization: NEE Path Filtering UI
                 if (auto group = widget.group("NEE Path Filtering")) {
                     group.checkbox("Collect NEE Paths Only", mCIRCollectNEEOnly);
@@ -483,7 +583,7 @@ namespace Falcor
                     }
 
                     // P1: Display path type statistics from GPU counters
-                    copyCIRRawDataToCPU(); // Ensure latest data is available
+                    copyCIRSummaryToCPU(); // Ensure latest counters are available
 
                     group.text(fmt::format("NEE Paths: {}", mStats.neePathsCollected));
                     group.tooltip("Number of NEE (Next Event Estimation) paths collected from GPU counter");
@@ -800,175 +900,194 @@ namespace Falcor
         }
     }
 
-    void PixelStats::copyCIRRawDataToCPU()
+    void PixelStats::copyCIRSummaryToCPU()
     {
         FALCOR_ASSERT(!mRunning);
-        if (mWaitingForData && (mCollectionMode == PixelStatsCollectionMode::RawData || mCollectionMode == PixelStatsCollectionMode::Both))
+        if (!mCIRSummaryPending) return;
+
+        auto startTime = CpuTimer::getCurrentTimePoint();
+
+        // Wait for signal.
+        mpFence->wait();
+
+        try
         {
-            // Wait for signal.
-            mpFence->wait();
+            const uint32_t* summary = static_cast<const uint32_t*>(mpCIRSummaryReadback->map());
+            uint32_t actualPathCount = summary[(uint32_t)CIRSummaryField::PathCount];
+            mCollectedCIRPaths = std::min(actualPathCount, mMaxCIRPathsPerFrame);
+
+            // P1 optimization: Read path type counters
+            if (mpNEEPathCounterBuffer) mStats.neePathsCollected = summary[(uint32_t)CIRSummaryField::NEEPathCount];
+            if (mpRegularPathCounterBuffer) mStats.regularPathsCollected = summary[(uint32_t)CIRSummaryField::RegularPathCount];
+            mpCIRSummaryReadback->unmap();
+
+            // Calculate path statistics
+            mStats.totalPathsAttempted = mStats.neePathsCollected + mStats.regularPathsCollected;
+            if (mStats.totalPathsAttempted > 0)
+            {
+                mStats.neePathRatio = (float)mStats.neePathsCollected / (float)mStats.totalPathsAttempted;
+            }
+            else
+            {
+                mStats.neePathRatio = 0.0f;
+            }
 
-            try
+            // NEE-CIR: Buffer usage monitoring and overflow detection
+            if (actualPathCount > mMaxCIRPathsPerFrame)
             {
-                // Map the counter buffer to get actual path count
-                const uint32_t* counterData = static_cast<const uint32_t*>(mpCIRCounterReadback->map());
-                if (counterData)
-                {
-                    uint32_t actualPathCount = *counterData;
-                    mCollectedCIRPaths = std::min(actualPathCount, mMaxCIRPathsPerFrame);
-                    mpCIRCounterReadback->unmap();
+                uint32_t overflowCount = actualPathCount - mMaxCIRPathsPerFrame;
+                float overflowPercentage = (float)overflowCount / (float)actualPathCount * 100.0f;
+                logWarning("CIR buffer overflow: {} paths attempted, {} collected, {} lost ({:.1f}%)",
+                          actualPathCount, mCollectedCIRPaths, overflowCount, overflowPercentage);
+            }
+            else if (actualPathCount > mMaxCIRPathsPerFrame * 0.9f) // Warn at 90% usage
+            {
+                float usagePercentage = (float)actualPathCount / (float)mMaxCIRPathsPerFrame * 100.0f;
+                logInfo("CIR buffer usage high: {:.1f}% ({}/{})", usagePercentage, actualPathCount, mMaxCIRPathsPerFrame);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            logError("PixelStats: Error reading CIR summary: " + std::string(e.what()));
+            mCollectedCIRPaths = 0;
+        }
 
-                    // P1 optimization: Read path type counters
-                    if (mpNEEPathCounterReadback)
-                    {
-                        const uint32_t* neeCounterData = static_cast<const uint32_t*>(mpNEEPathCounterReadback->map());
-                        if (neeCounterData)
-                        {
-                            mStats.neePathsCollected = *neeCounterData;
-                            mpNEEPathCounterReadback->unmap();
-                        }
-                    }
+        mCIRSummaryPending = false;
+        mCIRReadbackTime.summaryMs += CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+    }
 
-                    if (mpRegularPathCounterReadback)
-                    {
-                        const uint32_t* regularCounterData = static_cast<const uint32_t*>(mpRegularPathCounterReadback->map());
-                        if (regularCounterData)
-                        {
-                            mStats.regularPathsCollected = *regularCounterData;
-                            mpRegularPathCounterReadback->unmap();
-                        }
-                    }
+    void PixelStats::copyCIRRawDataToCPU()
+    {
+        FALCOR_ASSERT(!mRunning);
 
-                    // Calculate path statistics
-                    mStats.totalPathsAttempted = mStats.neePathsCollected + mStats.regularPathsCollected;
-                    if (mStats.totalPathsAttempted > 0)
-                    {
-                        mStats.neePathRatio = (float)mStats.neePathsCollected / (float)mStats.totalPathsAttempted;
-                    }
-                    else
-                    {
-                        mStats.neePathRatio = 0.0f;
-                    }
+        // The path count comes from the summary. The raw data is mapped at most once per frame.
+        copyCIRSummaryToCPU();
+        if (mCIRRawDataPending)
+        {
+            auto startTime = CpuTimer::getCurrentTimePoint();
 
-                    // NEE-CIR: Buffer usage monitoring and overflow detection
-                    if (actualPathCount > mMaxCIRPathsPerFrame)
-                    {
-                        uint32_t overflowCount = actualPathCount - mMaxCIRPathsPerFrame;
-                        float overflowPercentage = (float)overflowCount / (float)actualPathCount * 100.0f;
-                        logWarning("CIR buffer overflow: {} paths attempted, {} collected, {} lost ({:.1f}%)",
-                                  actualPathCount, mCollectedCIRPaths, overflowCount, overflowPercentage);
-                    }
-                    else if (actualPathCount > mMaxCIRPathsPerFrame * 0.9f) // Warn at 90% usage
+            try
+            {
+                if (mCollectedCIRPaths > 0)
+                {
+                    // Map the raw data buffer
+                    const CIRPathData* rawData = static_cast<const CIRPathData*>(mpCIRRawDataReadback->map());
+                    if (rawData)
                     {
-                        float usagePercentage = (float)actualPathCount / (float)mMaxCIRPathsPerFrame * 100.0f;
-                        logInfo("CIR buffer usage high: {:.1f}% ({}/{})", usagePercentage, actualPathCount, mMaxCIRPathsPerFrame);
-                    }
+                        std::vector<CIRPathData>& cirRawData = getWritableCIRRawData();
+                        cirRawData.clear();
+                        cirRawData.reserve(mCollectedCIRPaths);
 
-                    if (mCollectedCIRPaths > 0)
-                    {
-                        // Map the raw data buffer
-                        const CIRPathData* rawData = static_cast<const CIRPathData*>(mpCIRRawDataReadback->map());
-                        if (rawData)
-                        {
-                            mCIRRawData.clear();
-                            mCIRRawData.reserve(mCollectedCIRPaths);
+                        // NEW FILTERING LOGIC: Apply CPU-side filtering once
+                        // Data that passes this filter goes directly to both statistics and raw data
+                        // without additional validation
+                        uint32_t filteredCount = 0;
+                        uint32_t totalCount = static_cast<uint32_t>(mCollectedCIRPaths);
 
-                            // NEW FILTERING LOGIC: Apply CPU-side filtering once
-                            // Data that passes this filter goes directly to both statistics and raw data
-                            // without additional validation
-                            uint32_t filteredCount = 0;
-                            uint32_t totalCount = static_cast<uint32_t>(mCollectedCIRPaths);
+                        for (uint32_t i = 0; i < mCollectedCIRPaths; i++)
+                        {
+                            try {
+                                // Apply CPU-side filtering with configurable criteria
+                                bool shouldInclude = true;
+                                if (mCIRFilteringEnabled)
+                                {
+                                    shouldInclude = rawData[i].isValid(mCIRMinPathLength, mCIRMaxPathLength,
+                                                                      mCIRMinEmittedPower, mCIRMaxEmittedPower,
+                                                                      mCIRMinAngle, mCIRMaxAngle,
+                                                                      mCIRMinReflectance, mCIRMaxReflectance);
+                                }
 
-                            for (uint32_t i = 0; i < mCollectedCIRPaths; i++)
-                            {
-                                try {
-                                    // Apply CPU-side filtering with configurable criteria
-                                    bool shouldInclude = true;
-                                    if (mCIRFilteringEnabled)
-                                    {
-                                        shouldInclude = rawData[i].isValid(mCIRMinPathLength, mCIRMaxPathLength,
-                                                                          mCIRMinEmittedPower, mCIRMaxEmittedPower,
-                                                                          mCIRMinAngle, mCIRMaxAngle,
-                                                                          mCIRMinReflectance, mCIRMaxReflectance);
-                                    }
-
-                                    if (shouldInclude)
-                                    {
-                                        mCIRRawData.push_back(rawData[i]);
-                                        filteredCount++;
-                                    }
-                                } catch (const std::exception& e) {
-                                    logError("CIR filtering error at index " + std::to_string(i) + ": " + std::string(e.what()));
-                                    // Continue processing other data points
-                                    continue;
+                                if (shouldInclude)
+                                {
+                                    cirRawData.push_back(rawData[i]);
+                                    filteredCount++;
                                 }
+                            } catch (const std::exception& e) {
+                                logError("CIR filtering error at index " + std::to_string(i) + ": " + std::string(e.what()));
+                                // Continue processing other data points
+                                continue;
                             }
+                        }
 
-                            // Log filtering statistics with frequency control
-                            if (totalCount > 0) {
-                                float filterRatio = static_cast<float>(filteredCount) / totalCount;
-
-                                // Increment frame counter
-                                mCIRLogFrameCounter++;
-
-                                // Check if we should log this frame (based on interval and change detection)
-                                bool shouldLog = mCIRDetailedLogging &&
-                                               (mCIRLogFrameCounter % mCIRLogInterval == 0 ||
-                                                filteredCount != mLastCIRFilteredCount);
-
-                                if (shouldLog) {
-                                    // Log detailed filtering information
-                                    logInfo("CIR filtering details:");
-                                    logInfo("  - Filtering enabled: {}", mCIRFilteringEnabled ? "Yes" : "No");
-                                    logInfo("  - Path length range: [{:.2f}, {:.2f}] m", mCIRMinPathLength, mCIRMaxPathLength);
-                                    logInfo("  - Emitted power range: [{:.2e}, {:.2e}] W", mCIRMinEmittedPower, mCIRMaxEmittedPower);
-                                    logInfo("  - Angle range: [{:.3f}, {:.3f}] rad", mCIRMinAngle, mCIRMaxAngle);
-                                    logInfo("  - Reflectance range: [{:.3f}, {:.3f}]", mCIRMinReflectance, mCIRMaxReflectance);
-                                    logInfo("  - Total paths collected: {}", totalCount);
-                                    logInfo("  - Paths after filtering: {}", filteredCount);
-
-                                    if (filterRatio < 0.1f) {
-                                        logWarning("CIR filtering: Only {:.1f}% of data passed filters ({}/{})",
-                                                  filterRatio * 100.0f, filteredCount, totalCount);
-                                    }
-
-                                    // Update last filtered count for change detection
-                                    mLastCIRFilteredCount = filteredCount;
+                        // Log filtering statistics with frequency control
+                        if (totalCount > 0) {
+                            float filterRatio = static_cast<float>(filteredCount) / totalCount;
+
+                            // Increment frame counter
+                            mCIRLogFrameCounter++;
+
+                            // Check if we should log this frame (based on interval and change detection)
+                            bool shouldLog = mCIRDetailedLogging &&
+                                           (mCIRLogFrameCounter % mCIRLogInterval == 0 ||
+                                            filteredCount != mLastCIRFilteredCount);
+
+                            if (shouldLog) {
+                                // Log detailed filtering information
+                                logInfo("CIR filtering details:");
+                                logInfo("  - Filtering enabled: {}", mCIRFilteringEnabled ? "Yes" : "No");
+                                logInfo("  - Path length range: [{:.2f}, {:.2f}] m", mCIRMinPathLength, mCIRMaxPathLength);
+                                logInfo("  - Emitted power range: [{:.2e}, {:.2e}] W", mCIRMinEmittedPower, mCIRMaxEmittedPower);
+                                logInfo("  - Angle range: [{:.3f}, {:.3f}] rad", mCIRMinAngle, mCIRMaxAngle);
+                                logInfo("  - Reflectance range: [{:.3f}, {:.3f}]", mCIRMinReflectance, mCIRMaxReflectance);
+                                logInfo("  - Total paths collected: {}", totalCount);
+                                logInfo("  - Paths after filtering: {}", filteredCount);
+
+                                if (filterRatio < 0.1f) {
+                                    logWarning("CIR filtering: Only {:.1f}% of data passed filters ({}/{})",
+                                              filterRatio * 100.0f, filteredCount, totalCount);
                                 }
+
+                                // Update last filtered count for change detection
+                                mLastCIRFilteredCount = filteredCount;
                             }
+                        }
 
-                            mpCIRRawDataReadback->unmap();
-                            mCIRRawDataValid = true;
+                        mpCIRRawDataReadback->unmap();
+                        mCIRRawDataValid = true;
 
-                            // Only log summary if detailed logging is enabled and it's time to log
-                            if (mCIRDetailedLogging && (mCIRLogFrameCounter % mCIRLogInterval == 0 || filteredCount != mLastCIRFilteredCount))
+                        // Only log summary if detailed logging is enabled and it's time to log
+                        if (mCIRDetailedLogging && (mCIRLogFrameCounter % mCIRLogInterval == 0 || filteredCount != mLastCIRFilteredCount))
+                        {
+                            if (mCIRFilteringEnabled)
                             {
-                                if (mCIRFilteringEnabled)
-                                {
-                                    logInfo("PixelStats: CPU-filtered {} valid CIR paths out of {} total (configurable criteria)",
-                                           filteredCount, totalCount);
-                                }
-                                else
-                                {
-                                    logInfo("PixelStats: Collected {} CIR paths (filtering disabled)",
-                                           filteredCount);
-                                }
+                                logInfo("PixelStats: CPU-filtered {} valid CIR paths out of {} total (configurable criteria)",
+                                       filteredCount, totalCount);
+                            }
+                            else
+                            {
+                                logInfo("PixelStats: Collected {} CIR paths (filtering disabled)",
+                                       filteredCount);
                             }
                         }
                     }
-                    else
-                    {
-                        mCIRRawData.clear();
-                        mCIRRawDataValid = false;
-                    }
+                }
+                else
+                {
+                    getWritableCIRRawData().clear();
+                    mCIRRawDataValid = false;
                 }
             }
             catch (const std::exception& e)
             {
                 logError("PixelStats: Error reading CIR raw data: " + std::string(e.what()));
-                mCIRRawData.clear();
-                mCollectedCIRPaths = 0;
+                getWritableCIRRawData().clear();
+                mCIRRawDataValid = false;
+            }
+
+            if (mCIRAccumulationEnabled)
+            {
+                if (!mpCIRAccumulator)
+                {
+                    CIRAccumulator::Desc desc;
+                    if (mpScene) desc.staticParams = computeCIRStaticParameters(mpScene, mFrameDim);
+                    mpCIRAccumulator = std::make_unique<CIRAccumulator>(desc);
+                }
+                mpCIRAccumulator->addFrame(mpCIRRawData->data(), mCIRRawDataValid ? mpCIRRawData->size() : 0);
             }
+
+            mCIRRawDataPending = false;
+            mCIRReadbackTime.rawDataMs += CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+            mCIRReadbackTime.rawDataRecords += mCollectedCIRPaths;
         }
     }
 
@@ -979,21 +1098,35 @@ namespace Falcor
         {
             return false;
         }
-        outData = mCIRRawData;
+        outData = *mpCIRRawData;
         return true;
     }
 
+    std::shared_ptr<const std::vector<CIRPathData>> PixelStats::getCIRRawDataShared()
+    {
+        copyCIRRawDataToCPU();
+        if (!mCIRRawDataValid) return nullptr;
+        return mpCIRRawData;
+    }
+
+    std::vector<CIRPathData>& PixelStats::getWritableCIRRawData()
+    {
+        // Python views share ownership of the current vector. Refill a new one instead of modifying data under them.
+        if (mpCIRRawData.use_count() > 1) mpCIRRawData = std::make_shared<std::vector<CIRPathData>>();
+        return *mpCIRRawData;
+    }
+
     uint32_t PixelStats::getCIRPathCount()
     {
         copyCIRRawDataToCPU();
-        return mCIRRawDataValid ? static_cast<uint32_t>(mCIRRawData.size()) : 0;
+        return mCIRRawDataValid ? static_cast<uint32_t>(mpCIRRawData->size()) : 0;
     }
 
     bool PixelStats::exportCIRData(const std::string& filename, const ref<Scene>& pScene)
     {
         // Copy and filter CIR data using CPU-side configurable criteria
         copyCIRRawDataToCPU();
-        if (!mCIRRawDataValid || mCIRRawData.empty())
+        if (!mCIRRawDataValid || mpCIRRawData->empty())
         {
             logWarning("PixelStats::exportCIRData() - No valid CIR data to export after CPU filtering.");
             return false;
@@ -1031,9 +1164,9 @@ namespace Falcor
             file << std::fixed << std::setprecision(6);
 
             // Write filtered path data (no additional validation needed)
-            for (size_t i = 0; i < mCIRRawData.size(); i++)
+            for (size_t i = 0; i < mpCIRRawData->size(); i++)
             {
-                const auto& data = mCIRRawData[i];
+                const auto& data = (*mpCIRRawData)[i];
                 file << i << ","
                      << data.pixelX << ","
                      << data.pixelY << ","
@@ -1046,7 +1179,7 @@ namespace Falcor
             }
 
             file.close();
-            logInfo("PixelStats: Exported {} CPU-filtered CIR paths to {}", mCIRRawData.size(), filename);
+            logInfo("PixelStats: Exported {} CPU-filtered CIR paths to {}", mpCIRRawData->size(), filename);
             return true;
         }
         catch (const std::exception& e)
@@ -1301,7 +1434,7 @@ namespace Falcor
     bool PixelStats::exportCIRDataWithFormat(const std::string& filename, CIRExportFormat format, const ref<Scene>& pScene)
     {
         copyCIRRawDataToCPU();
-        if (!mCIRRawDataValid || mCIRRawData.empty())
+        if (!mCIRRawDataValid || mpCIRRawData->empty())
         {
             logWarning("PixelStats::exportCIRDataWithFormat() - No valid CIR data to export.");
             return false;
@@ -1335,7 +1468,7 @@ namespace Falcor
             if (success)
             {
                 logInfo("PixelStats: Exported {} CIR paths in {} format to {}",
-                       mCIRRawData.size(),
+                       mpCIRRawData->size(),
                        format == CIRExportFormat::CSV ? "CSV" :
                        format == CIRExportFormat::JSONL ? "JSONL" : "TXT",
                        filename);
@@ -1401,21 +1534,28 @@ namespace Falcor
         file << "Vertex1_X,Vertex1_Y,Vertex1_Z,Vertex2_X,Vertex2_Y,Vertex2_Z,Vertex3_X,Vertex3_Y,Vertex3_Z,";
         file << "Vertex4_X,Vertex4_Y,Vertex4_Z,Vertex5_X,Vertex5_Y,Vertex5_Z,Vertex6_X,Vertex6_Y,Vertex6_Z,Vertex7_X,Vertex7_Y,Vertex7_Z\n";
 
+        // Decompress and validate the vertices of all paths in one batch. Only paths that fail validation
+        // go through the per-path legacy handling below.
+        CIRVertexBatch vertexBatch;
+        decompressCIRPaths(mpCIRRawData->data(), mpCIRRawData->size(), CIRBatchFilter(), vertexBatch);
+        std::vector<float3> vertices;
+
         // Write data rows with vertex information
         file << std::fixed << std::setprecision(6);
-        for (size_t i = 0; i < mCIRRawData.size(); i++)
+        for (size_t i = 0; i < mpCIRRawData->size(); i++)
         {
             // Create a copy for potential modification (backward compatibility)
-            CIRPathData data = mCIRRawData[i];
+            CIRPathData data = (*mpCIRRawData)[i];
+            const bool useBatchVertices = vertexBatch.vertexDataValid[i] && supportsVertexData(data);
 
             // Handle legacy data if needed
-            handleLegacyData(data);
+            if (!useBatchVertices) handleLegacyData(data);
 
             // TASK 3: Validate CIR data including originalEmittedPower
             validateCIRDataForExport(data, i);
 
             // Validate vertex data integrity (log warnings for invalid data but continue export)
-            if (!validateCIRVertexData(data))
+            if (!useBatchVertices && !validateCIRVertexData(data))
             {
                 logWarning("PixelStats: Invalid vertex data in path {}, using default values", i);
                 handleLegacyData(data); // Force default values for invalid data
@@ -1450,7 +1590,8 @@ namespace Falcor
                 file << lightPos.x << "," << lightPos.y << "," << lightPos.z << ",";
 
                 // Decompress and write vertices (up to 7 vertices)
-                std::vector<float3> vertices = decompressPathVertices(data);
+                if (useBatchVertices) getBatchVertices(vertexBatch, i, vertices);
+                else vertices = decompressPathVertices(data);
                 for (uint32_t v = 0; v < 7; v++)
                 {
                     if (v < vertices.size())
@@ -1496,18 +1637,25 @@ namespace Falcor
         file << "\"optical_concentration\":" << std::fixed << std::setprecision(1) << staticParams.opticalConcentration;
         file << "}}\n";
 
+        // Decompress and validate the vertices of all paths in one batch. Only paths that fail validation
+        // go through the per-path legacy handling below.
+        CIRVertexBatch vertexBatch;
+        decompressCIRPaths(mpCIRRawData->data(), mpCIRRawData->size(), CIRBatchFilter(), vertexBatch);
+        std::vector<float3> vertices;
+
         // Write path data as JSON objects with vertex information
         file << std::fixed << std::setprecision(6);
-        for (size_t i = 0; i < mCIRRawData.size(); i++)
+        for (size_t i = 0; i < mpCIRRawData->size(); i++)
         {
             // Create a copy for potential modification (backward compatibility)
-            CIRPathData data = mCIRRawData[i];
+            CIRPathData data = (*mpCIRRawData)[i];
+            const bool useBatchVertices = vertexBatch.vertexDataValid[i] && supportsVertexData(data);
 
             // Handle legacy data if needed
-            handleLegacyData(data);
+            if (!useBatchVertices) handleLegacyData(data);
 
             // Validate vertex data integrity (log warnings for invalid data but continue export)
-            if (!validateCIRVertexData(data))
+            if (!useBatchVertices && !validateCIRVertexData(data))
             {
                 logWarning("PixelStats: Invalid vertex data in path {}, using default values", i);
                 handleLegacyData(data); // Force default values for invalid data
@@ -1545,7 +1693,8 @@ namespace Falcor
                 file << "\"vertices\":[";
 
                 // Decompress and write vertices
-                std::vector<float3> vertices = decompressPathVertices(data);
+                if (useBatchVertices) getBatchVertices(vertexBatch, i, vertices);
+                else vertices = decompressPathVertices(data);
                 for (uint32_t v = 0; v < vertices.size(); v++)
                 {
                     file << "{\"index\":" << v << ",\"position\":["
@@ -1596,17 +1745,24 @@ namespace Falcor
         file << "#\n";
         file << std::fixed << std::setprecision(6);
 
+        // Decompress and validate the vertices of all paths in one batch. Only paths that fail validation
+        // go through the per-path legacy handling below.
+        CIRVertexBatch vertexBatch;
+        decompressCIRPaths(mpCIRRawData->data(), mpCIRRawData->size(), CIRBatchFilter(), vertexBatch);
+        std::vector<float3> vertices;
+
         // Write path data with vertex information
-        for (size_t i = 0; i < mCIRRawData.size(); i++)
+        for (size_t i = 0; i < mpCIRRawData->size(); i++)
         {
             // Create a copy for potential modification (backward compatibility)
-            CIRPathData data = mCIRRawData[i];
+            CIRPathData data = (*mpCIRRawData)[i];
+            const bool useBatchVertices = vertexBatch.vertexDataValid[i] && supportsVertexData(data);
 
             // Handle legacy data if needed
-            handleLegacyData(data);
+            if (!useBatchVertices) handleLegacyData(data);
 
             // Validate vertex data integrity (log warnings for invalid data but continue export)
-            if (!validateCIRVertexData(data))
+            if (!useBatchVertices && !validateCIRVertexData(data))
             {
                 logWarning("PixelStats: Invalid vertex data in path {}, using default values", i);
                 handleLegacyData(data); // Force default values for invalid data
@@ -1641,7 +1797,8 @@ namespace Falcor
                 file << "," << lightPos.x << "," << lightPos.y << "," << lightPos.z;
 
                 // Decompress and write vertices
-                std::vector<float3> vertices = decompressPathVertices(data);
+                if (useBatchVertices) getBatchVertices(vertexBatch, i, vertices);
+                else vertices = decompressPathVertices(data);
                 for (uint32_t v = 0; v < vertices.size(); v++)
                 {
                     file << "," << vertices[v].x << "," << vertices[v].y << "," << vertices[v].z;
@@ -1842,8 +1999,15 @@ namespace Falcor
         }
     }
 
+    void PixelStats::resetCIRAccumulation()
+    {
+        mpCIRAccumulator.reset();
+    }
+
     FALCOR_SCRIPT_BINDING(PixelStats)
     {
+        using namespace pybind11::literals;
+
         pybind11::class_<PixelStats> pixelStats(m, "PixelStats");
         pixelStats.def_property("enabled", &PixelStats::isEnabled, &PixelStats::setEnabled);
         pixelStats.def_property_readonly("stats", [](PixelStats* pPixelStats) {
@@ -1851,5 +2015,14 @@ namespace Falcor
             pPixelStats->getStats(stats);
             return toPython(stats);
         });
+        pixelStats.def_property("cirAccumulation", &PixelStats::isCIRAccumulationEnabled, &PixelStats::setCIRAccumulationEnabled);
+        pixelStats.def("resetCIRAccumulation", &PixelStats::resetCIRAccumulation);
+        pixelStats.def("getCIRImpulseResponse", [](PixelStats* pPixelStats, double binWidth, uint32_t binCount) {
+            const CIRAccumulator* pAccumulator = pPixelStats->getCIRAccumulator();
+            return pAccumulator ? pAccumulator->computeImpulseResponse(binWidth, binCount) : std::vector<double>(binCount, 0.0);
+        }, "binWidth"_a, "binCount"_a);
+        // Zero-copy structured view of the filtered CIR paths of the last frame. Fields match CIRPathData.
+        pixelStats.def("getCIRRawData", [](PixelStats* pPixelStats) { return toNumpy(pPixelStats->getCIRRawDataShared()); });
+        pixelStats.def_property_readonly_static("cirPathDataDtype", [](pybind11::object) { return getCIRPathDataDtype(); });
     }
 }
@@ -49,6 +49,7 @@ namespace Falcor
     class Scene;
     class Camera;
     class Light;
+    class CIRAccumulator;
 
     // Forward declaration for CIR path data structure
     struct CIRPathData
@@ -228,6 +229,7 @@ namespace Falcor
         };
 
         PixelStats(ref<Device> pDevice);
+        ~PixelStats();
 
         void setEnabled(bool enabled) { mEnabled = enabled; }
         bool isEnabled() const { return mEnabled; }
@@ -288,6 +290,12 @@ namespace Falcor
         */
         bool getCIRRawData(std::vector<CIRPathData>& outData);
 
+        /** Get the CIR path data of the last frame without copying it.
+            The returned data is never modified, later frames are written to a new vector while it is referenced.
+            \return Shared CIR path data, or nullptr if no data is available.
+        */
+        std::shared_ptr<const std::vector<CIRPathData>> getCIRRawDataShared();
+
         /** Get the number of CIR paths collected in the last frame.
             \return Number of paths collected, or 0 if no data available.
         */
@@ -323,9 +331,27 @@ namespace Falcor
         */
         CIRStaticParameters computeCIRStaticParameters(const ref<Scene>& pScene, const uint2& frameDim);
 
+        /** Enable accumulation of the CIR paths of every frame in compact binned form (see CIRAccumulator).
+            The raw data is then read back every frame. The accumulator is created with the static
+            parameters of the current scene on the first accumulated frame.
+            \param[in] enabled True to enable accumulation.
+        */
+        void setCIRAccumulationEnabled(bool enabled) { mCIRAccumulationEnabled = enabled; }
+        bool isCIRAccumulationEnabled() const { return mCIRAccumulationEnabled; }
+
+        /** Returns the CIR accumulator, or nullptr if no frame has been accumulated yet.
+        */
+        const CIRAccumulator* getCIRAccumulator() const { return mpCIRAccumulator.get(); }
+
+        /** Discard all accumulated CIR data.
+        */
+        void resetCIRAccumulation();
+
     protected:
         void copyStatsToCPU();
+        void copyCIRSummaryToCPU();
         void copyCIRRawDataToCPU();
+        std::vector<CIRPathData>& getWritableCIRRawData();
         void computeRayCountTexture(RenderContext* pRenderContext);
 
         // Helper methods for static parameter computation
@@ -350,6 +376,7 @@ namespace Falcor
         float3 decompressVertex(const CIRPathData::CompressedVertex& compressed, const float3& basePosition) const;
 
         /** Decompress all vertices in a CIRPathData structure.
+            Use decompressCIRPaths() in CIRPathBatch.h to process many paths at once.
             \param cirData CIR path data containing compressed vertices
             \return Vector of decompressed world space vertex positions
         */
@@ -447,18 +474,36 @@ namespace Falcor
         // CIR raw data collection buffers
         ref<Buffer>                         mpCIRRawDataBuffer;             ///< GPU buffer for raw CIR path data.
         ref<Buffer>                         mpCIRCounterBuffer;             ///< GPU buffer for path counter.
-        ref<Buffer>                         mpCIRRawDataReadback;           ///< CPU-readable buffer for CIR raw data.
-        ref<Buffer>                         mpCIRCounterReadback;           ///< CPU-readable buffer for path counter.
+        ref<Buffer>                         mpCIRRawDataReadback;           ///< CPU-readable buffer for CIR raw data. Only mapped on explicit request (export/getCIRRawData()).
 
         // P1 optimization: Path type counter buffers
         ref<Buffer>                         mpNEEPathCounterBuffer;         ///< GPU buffer for NEE path counter.
         ref<Buffer>                         mpRegularPathCounterBuffer;     ///< GPU buffer for regular path counter.
-        ref<Buffer>                         mpNEEPathCounterReadback;       ///< CPU-readable buffer for NEE path counter.
-        ref<Buffer>                         mpRegularPathCounterReadback;   ///< CPU-readable buffer for regular path counter.
+
+        // CIR summary readback. The counters are copied into one small buffer so that the UI and stats never map the raw data.
+        enum class CIRSummaryField : uint32_t { PathCount, NEEPathCount, RegularPathCount, Count };
+        ref<Buffer>                         mpCIRSummaryReadback;           ///< CPU-readable buffer for the CIR counters (one uint32_t per CIRSummaryField).
+        bool                                mCIRSummaryPending = false;     ///< True if the summary of the last frame has not been read back yet.
+        bool                                mCIRRawDataPending = false;     ///< True if the raw data of the last frame has not been read back yet.
 
         bool                                mCIRRawDataValid = false;       ///< True if raw CIR data is valid.
         uint32_t                            mCollectedCIRPaths = 0;         ///< Number of CIR paths collected in last frame.
-        std::vector<CIRPathData>            mCIRRawData;                    ///< CPU copy of raw CIR data.
+        /// CPU copy of raw CIR data. Shared with Python views, see getWritableCIRRawData().
+        std::shared_ptr<std::vector<CIRPathData>> mpCIRRawData = std::make_shared<std::vector<CIRPathData>>();
+
+        // CPU cost of the CIR readback.
+        struct CIRReadbackTime
+        {
+            double summaryMs = 0.0;                                         ///< Time spent waiting for and reading the summary.
+            double rawDataMs = 0.0;                                         ///< Time spent waiting for, reading and filtering the raw data.
+            uint32_t rawDataRecords = 0;                                    ///< Number of raw records read back.
+        };
+        CIRReadbackTime                     mCIRReadbackTime;               ///< CPU time spent on CIR readback in the current frame.
+        CIRReadbackTime                     mLastCIRReadbackTime;           ///< CPU time spent on CIR readback in the previous frame.
+
+        // CIR accumulation
+        bool                                mCIRAccumulationEnabled = false; ///< Accumulate the CIR paths of every frame.
+        std::unique_ptr<CIRAccumulator>     mpCIRAccumulator;               ///< Compact binned CIR data accumulated over frames.
 
         ref<ComputePass>                    mpComputeRayCount;              ///< Pass for computing per-pixel total ray count.
     };
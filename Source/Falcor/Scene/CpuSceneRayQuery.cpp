@@ -0,0 +1,216 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "CpuSceneRayQuery.h"
+#include "Scene.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include "Utils/Threading.h"
+#include <algorithm>
+
+namespace Falcor
+{
+CpuSceneRayQuery::CpuSceneRayQuery(const Scene& scene)
+{
+    const auto& meshGroups = scene.mMeshGroups;
+    mBlases.resize(meshGroups.size());
+
+    // Build the bottom-level hierarchies in parallel.
+    auto buildBlas = [&](size_t groupIndex)
+    {
+        const auto& meshGroup = meshGroups[groupIndex];
+        Blas& blas = mBlases[groupIndex];
+        blas.isStatic = meshGroup.isStatic;
+
+        std::vector<float3> positions;
+        std::vector<uint32_t> indices;
+        for (MeshID meshID : meshGroup.meshList)
+        {
+            const MeshDesc& desc = scene.getMesh(meshID);
+            blas.triangleOffsets.push_back((uint32_t)(indices.size() / 3));
+
+            // Load vertices from the global vertex buffer. Note that the mesh local vbOffset addresses into the global buffer.
+            const uint32_t vertexOffset = (uint32_t)positions.size();
+            for (uint32_t i = 0; i < desc.vertexCount; i++)
+                positions.push_back(scene.mMeshStaticData[desc.vbOffset + i].position);
+
+            const uint32_t triangleCount = desc.getTriangleCount();
+            if (desc.useVertexIndices())
+            {
+                const uint8_t* pIndexData = reinterpret_cast<const uint8_t*>(&scene.mMeshIndexData[desc.ibOffset]);
+                for (uint32_t i = 0; i < 3 * triangleCount; i++)
+                {
+                    uint32_t index = desc.use16BitIndices() ? reinterpret_cast<const uint16_t*>(pIndexData)[i]
+                                                            : reinterpret_cast<const uint32_t*>(pIndexData)[i];
+                    indices.push_back(vertexOffset + index);
+                }
+            }
+            else
+            {
+                for (uint32_t i = 0; i < 3 * triangleCount; i++)
+                    indices.push_back(vertexOffset + i);
+            }
+        }
+
+        blas.bvh.build(positions, indices);
+    };
+    Threading::parallelFor(0, meshGroups.size(), buildBlas);
+
+    for (const auto& blas : mBlases)
+        mTriangleCount += blas.bvh.getTriangleCount();
+
+    // Create the instances in the same order as the GPU acceleration structure (see Scene::fillInstanceDesc()).
+    uint32_t instanceID = 0;
+    for (size_t groupIndex = 0; groupIndex < meshGroups.size(); groupIndex++)
+    {
+        const auto& meshList = meshGroups[groupIndex].meshList;
+        FALCOR_ASSERT(!meshList.empty());
+        size_t instanceCount = scene.mMeshIdToInstanceIds[meshList[0].get()].size();
+        for (size_t i = 0; i < instanceCount; i++)
+        {
+            Instance instance;
+            instance.blasIndex = (uint32_t)groupIndex;
+            instance.instanceID = instanceID;
+            mInstances.push_back(instance);
+            instanceID += (uint32_t)meshList.size();
+        }
+    }
+
+    updateTransforms(scene);
+
+    logDebug(
+        "CpuSceneRayQuery: Built {} bottom-level hierarchies with {} triangles and {} instances.",
+        mBlases.size(),
+        mTriangleCount,
+        mInstances.size()
+    );
+}
+
+void CpuSceneRayQuery::updateTransforms(const Scene& scene)
+{
+    const auto& globalMatrices = scene.getAnimationController()->getGlobalMatrices();
+
+    std::vector<AABB> instanceBounds(mInstances.size());
+    for (size_t i = 0; i < mInstances.size(); i++)
+    {
+        Instance& instance = mInstances[i];
+        const Blas& blas = mBlases[instance.blasIndex];
+
+        // Static meshes are pre-transformed to world space. For other meshes, all meshes in an instance share the same transform.
+        float4x4 objectToWorld = float4x4::identity();
+        if (!blas.isStatic)
+        {
+            const uint32_t matrixID = scene.getGeometryInstance(instance.instanceID).globalMatrixID;
+            objectToWorld = globalMatrices[matrixID];
+        }
+        instance.worldToObject = inverse(objectToWorld);
+        instanceBounds[i] = blas.bvh.getBounds().transform(objectToWorld);
+    }
+
+    mTlas.build(instanceBounds);
+}
+
+CpuSceneRayQuery::Hit CpuSceneRayQuery::intersectClosest(const Ray& ray) const
+{
+    Hit hit;
+    float tMax = ray.tMax;
+    mTlas.traverse(
+        ray,
+        tMax,
+        [&](uint32_t offset, float& tFar)
+        {
+            const Instance& instance = mInstances[mTlas.getPrimitiveIndices()[offset]];
+            Ray objectRay = transformRay(ray, instance);
+            objectRay.tMax = tFar;
+            TriangleBVH::Hit blasHit = mBlases[instance.blasIndex].bvh.intersectClosest(objectRay);
+            if (blasHit.isValid())
+            {
+                tFar = blasHit.t;
+                hit = getHit(instance, blasHit);
+            }
+            return false;
+        }
+    );
+    return hit;
+}
+
+bool CpuSceneRayQuery::intersectAny(const Ray& ray) const
+{
+    float tMax = ray.tMax;
+    return mTlas.traverse(
+        ray,
+        tMax,
+        [&](uint32_t offset, float& tFar)
+        {
+            const Instance& instance = mInstances[mTlas.getPrimitiveIndices()[offset]];
+            Ray objectRay = transformRay(ray, instance);
+            objectRay.tMax = tFar;
+            return mBlases[instance.blasIndex].bvh.intersectAny(objectRay);
+        }
+    );
+}
+
+void CpuSceneRayQuery::intersectClosest(fstd::span<const Ray> rays, fstd::span<Hit> hits) const
+{
+    FALCOR_CHECK(rays.size() == hits.size(), "Ray count ({}) and hit count ({}) don't match.", rays.size(), hits.size());
+    Threading::parallelFor(0, rays.size(), [&](size_t i) { hits[i] = intersectClosest(rays[i]); });
+}
+
+void CpuSceneRayQuery::intersectAny(fstd::span<const Ray> rays, fstd::span<uint8_t> hits) const
+{
+    FALCOR_CHECK(rays.size() == hits.size(), "Ray count ({}) and hit count ({}) don't match.", rays.size(), hits.size());
+    Threading::parallelFor(0, rays.size(), [&](size_t i) { hits[i] = intersectAny(rays[i]) ? 1 : 0; });
+}
+
+Ray CpuSceneRayQuery::transformRay(const Ray& ray, const Instance& instance) const
+{
+    if (mBlases[instance.blasIndex].isStatic)
+        return ray;
+
+    // The direction is not normalized, so hit distances are the same in world and object space.
+    Ray objectRay = ray;
+    objectRay.origin = transformPoint(instance.worldToObject, ray.origin);
+    objectRay.dir = transformVector(instance.worldToObject, ray.dir);
+    return objectRay;
+}
+
+CpuSceneRayQuery::Hit CpuSceneRayQuery::getHit(const Instance& instance, const TriangleBVH::Hit& blasHit) const
+{
+    // Find the mesh in the group that contains the triangle.
+    const auto& triangleOffsets = mBlases[instance.blasIndex].triangleOffsets;
+    auto it = std::upper_bound(triangleOffsets.begin(), triangleOffsets.end(), blasHit.triangleIndex);
+    FALCOR_ASSERT(it != triangleOffsets.begin());
+    uint32_t geometryIndex = (uint32_t)(it - triangleOffsets.begin()) - 1;
+
+    Hit hit;
+    hit.t = blasHit.t;
+    hit.barycentrics = blasHit.barycentrics;
+    hit.instanceID = instance.instanceID + geometryIndex;
+    hit.primitiveIndex = blasHit.triangleIndex - triangleOffsets[geometryIndex];
+    return hit;
+}
+} // namespace Falcor
@@ -0,0 +1,138 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Geometry/BVH4.h"
+#include "Utils/Geometry/TriangleBVH.h"
+#include "Utils/Math/Matrix.h"
+#include "Utils/Math/Ray.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Falcor
+{
+class Scene;
+
+/**
+ * CPU ray queries against the triangle meshes of a scene.
+ *
+ * The acceleration structure mirrors the one used for GPU ray tracing: each mesh group becomes a bottom-level
+ * BVH built from the scene's global vertex and index data, and a top-level BVH is built over the instances of
+ * the mesh groups using the current instance transforms. Hits report the same geometry instance ID and primitive
+ * index as the GPU, so the results can be used as a CPU reference.
+ *
+ * Vertices are taken from the static vertex data, so skinned and vertex animated meshes are in their bind pose.
+ * Curves, SDF grids and custom primitives are not supported.
+ */
+class FALCOR_API CpuSceneRayQuery
+{
+public:
+    static constexpr uint32_t kInvalidIndex = 0xffffffff;
+
+    struct Hit
+    {
+        float t = std::numeric_limits<float>::infinity(); ///< Hit distance along the ray.
+        float2 barycentrics = float2(0.f);                ///< Barycentric weights of vertices 1 and 2 (same convention as DXR).
+        uint32_t instanceID = kInvalidIndex;              ///< Geometry instance ID, see Scene::getGeometryInstance().
+        uint32_t primitiveIndex = kInvalidIndex;          ///< Triangle index within the mesh.
+
+        bool isValid() const { return instanceID != kInvalidIndex; }
+    };
+
+    /**
+     * Build the acceleration structures for a scene.
+     * @param[in] scene The scene.
+     */
+    CpuSceneRayQuery(const Scene& scene);
+
+    /**
+     * Rebuild the top-level hierarchy with the current instance transforms of the scene, for example after animation.
+     * @param[in] scene The scene, must be the same scene the query was created with.
+     */
+    void updateTransforms(const Scene& scene);
+
+    uint32_t getTriangleCount() const { return mTriangleCount; }
+    uint32_t getInstanceCount() const { return (uint32_t)mInstances.size(); }
+
+    /**
+     * Find the closest hit along a ray.
+     * @param[in] ray Ray in world space. Hits are reported in the interval [ray.tMin, ray.tMax].
+     * @return Closest hit, invalid if the ray misses.
+     */
+    Hit intersectClosest(const Ray& ray) const;
+
+    /**
+     * Check whether a ray hits any geometry.
+     * @param[in] ray Ray in world space. Hits are reported in the interval [ray.tMin, ray.tMax].
+     * @return True if the ray hits any geometry.
+     */
+    bool intersectAny(const Ray& ray) const;
+
+    /**
+     * Find the closest hits along a batch of rays, processing the rays in parallel.
+     * @param[in] rays Rays in world space.
+     * @param[out] hits Closest hit for each ray. Must have the same size as rays.
+     */
+    void intersectClosest(fstd::span<const Ray> rays, fstd::span<Hit> hits) const;
+
+    /**
+     * Check whether rays in a batch hit any geometry, processing the rays in parallel.
+     * @param[in] rays Rays in world space.
+     * @param[out] hits 1 if the ray hits any geometry, 0 otherwise. Must have the same size as rays.
+     */
+    void intersectAny(fstd::span<const Ray> rays, fstd::span<uint8_t> hits) const;
+
+private:
+    /// Bottom-level hierarchy for a mesh group.
+    struct Blas
+    {
+        TriangleBVH bvh;
+        bool isStatic = false;                  ///< True if the meshes are pre-transformed to world space.
+        std::vector<uint32_t> triangleOffsets;  ///< Offset of the first triangle of each mesh in the group.
+    };
+
+    /// Instance of a mesh group.
+    struct Instance
+    {
+        uint32_t blasIndex = 0;
+        uint32_t instanceID = 0;    ///< Geometry instance ID of the first mesh in the group.
+        float4x4 worldToObject;
+    };
+
+    Ray transformRay(const Ray& ray, const Instance& instance) const;
+    Hit getHit(const Instance& instance, const TriangleBVH::Hit& blasHit) const;
+
+    std::vector<Blas> mBlases;
+    std::vector<Instance> mInstances;
+    BVH4 mTlas;
+    uint32_t mTriangleCount = 0;
+};
+} // namespace Falcor
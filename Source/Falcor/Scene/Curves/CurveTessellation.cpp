@@ -32,6 +32,7 @@
 #include "Utils/Math/CubicSpline.h"
 #include "Utils/Math/Matrix.h"
 #include "Utils/Math/Quaternion.h"
+#include "Utils/Threading.h"
 #include <cmath>
 
 namespace Falcor
@@ -59,21 +60,40 @@ namespace Falcor
 
     struct CubicSplineCache
     {
-        CubicSpline<float3> optSplinePoints;
-        CubicSpline<float>  optSplineWidths;
-        CubicSpline<float2> optSplineUVs;
-
         CubicSpline<float3> splinePoints;
         CubicSpline<float>  splineWidths;
         CubicSpline<float2> splineUVs;
     };
 
+    /// Per-thread scratch memory for processing strands.
+    struct StrandScratch
+    {
+        StrandArrays strandArrays;
+        StrandArrays sampledStrandArrays;
+        CubicSplineCache splineCache;
+    };
+
+    /// Tessellation layout of the kept strands.
+    struct StrandLayout
+    {
+        std::vector<uint32_t> inputOffsets;    ///< Offset of the first control point of each kept strand in the input arrays.
+        std::vector<uint32_t> subdivCounts;    ///< Number of sub-segments per cubic segment for each kept strand.
+        std::vector<uint32_t> sampleOffsets;   ///< Prefix sum over the number of output samples per kept strand (size strandCount + 1).
+
+        uint32_t getStrandCount() const { return (uint32_t)inputOffsets.size(); }
+        uint32_t getSampleCount(uint32_t strand) const { return sampleOffsets[strand + 1] - sampleOffsets[strand]; }
+        uint32_t getTotalSampleCount() const { return sampleOffsets.back(); }
+    };
+
     namespace
     {
         // Curves tessellated to quad-tubes have the width somewhere between curveWidth and (curveWidth / sqrt(2)), depending on the viewing angle.
         // To achieve curveWidth on average, however, we need to scale the initial curveWidth by 1.11 (the number was deducted numerically).
         const float kMeshCompensationScale = 1.11f;
 
+        // Number of strands processed by a single task.
+        const uint32_t kStrandsPerTask = 64;
+
         float4 transformSphere(const float4x4& xform, const float4& sphere)
         {
             // Spheres are represented as (center.x, center.y, center.z, radius).
@@ -98,7 +118,25 @@ namespace Falcor
             return std::max(w, (float)std::numeric_limits<float16_t>::min());
         }
 
-        void optimizeStrandGeometry(CubicSplineCache& splineCache, const CurveArrays& curveArrays, StrandArrays& strandArrays, StrandArrays& optimizedStrandArrays, uint32_t pointOffset, uint32_t subdivPerSegment, uint32_t keepOneEveryXVerticesPerStrand, float widthScale)
+        /// Number of samples of a strand with the given number of (deduplicated) control points.
+        inline uint32_t getStrandSampleCount(uint32_t vertexCount, uint32_t subdivPerSegment, uint32_t keepOneEveryXVerticesPerStrand)
+        {
+            return div_round_up(subdivPerSegment * (vertexCount - 1), keepOneEveryXVerticesPerStrand) + 1;
+        }
+
+        /// Count the control points of a strand after removing consecutive duplicates.
+        uint32_t countUniqueControlPoints(const float3* controlPoints, uint32_t vertexCount)
+        {
+            uint32_t count = 1;
+            for (uint32_t j = 0; j < vertexCount - 1; j++)
+            {
+                if (any(controlPoints[j] != controlPoints[j + 1])) count++;
+            }
+            return count;
+        }
+
+        /// Copy the control points of a strand to the strand arrays, removing consecutive duplicates.
+        void removeDuplicateControlPoints(const CurveArrays& curveArrays, StrandArrays& strandArrays, uint32_t pointOffset)
         {
             strandArrays.controlPoints.clear();
             strandArrays.UVs.clear();
@@ -119,51 +157,153 @@ namespace Falcor
             strandArrays.controlPoints.push_back(curveArrays.controlPoints[pointOffset + strandArrays.vertexCount - 1]);
             strandArrays.widths.push_back(curveArrays.widths[pointOffset + strandArrays.vertexCount - 1]);
             if (curveArrays.UVs) strandArrays.UVs.push_back(curveArrays.UVs[pointOffset + strandArrays.vertexCount - 1]);
+        }
 
-            optimizedStrandArrays.vertexCount = static_cast<uint32_t>(strandArrays.controlPoints.size());
-
-            const CubicSpline<float3>& splinePoints = splineCache.optSplinePoints.setup(strandArrays.controlPoints.data(), optimizedStrandArrays.vertexCount);
-            const CubicSpline<float>& splineWidths = splineCache.optSplineWidths.setup(strandArrays.widths.data(), optimizedStrandArrays.vertexCount);
-
-            uint32_t tmpCount = 0;
-            for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
+        /** Sample a spline at the strand's tessellation points.
+            Sample s = j * subdivPerSegment + k (at parameter k / subdivPerSegment of segment j) is kept if s is a multiple of keepOneEveryXVerticesPerStrand.
+            The end point of the strand is always kept.
+            \param[out] results Sampled values, getStrandSampleCount() elements.
+        */
+        template<typename T>
+        void sampleSpline(const CubicSpline<T>& spline, uint32_t segmentCount, uint32_t subdivPerSegment, uint32_t keepOneEveryXVerticesPerStrand, T* results)
+        {
+            if (keepOneEveryXVerticesPerStrand == 1)
             {
+                // Evaluate the same parameter for all segments at once.
                 for (uint32_t k = 0; k < subdivPerSegment; k++)
                 {
-                    if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                    {
-                        float t = (float)k / (float)subdivPerSegment;
-                        optimizedStrandArrays.controlPoints.push_back(splinePoints.interpolate(j, t));
-                        optimizedStrandArrays.widths.push_back(sanitizeWidth(kMeshCompensationScale * widthScale * splineWidths.interpolate(j, t)));
-                    }
-                    tmpCount++;
+                    float t = (float)k / (float)subdivPerSegment;
+                    spline.interpolateSections(0, segmentCount, t, results + k, subdivPerSegment);
+                }
+            }
+            else
+            {
+                uint32_t i = 0;
+                for (uint32_t sample = 0; sample < segmentCount * subdivPerSegment; sample += keepOneEveryXVerticesPerStrand)
+                {
+                    float t = (float)(sample % subdivPerSegment) / (float)subdivPerSegment;
+                    results[i++] = spline.interpolate(sample / subdivPerSegment, t);
                 }
             }
 
             // Always keep the last vertex.
-            optimizedStrandArrays.controlPoints.push_back(splinePoints.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
-            optimizedStrandArrays.widths.push_back(sanitizeWidth(kMeshCompensationScale * widthScale * splineWidths.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f)));
+            results[div_round_up(segmentCount * subdivPerSegment, keepOneEveryXVerticesPerStrand)] = spline.interpolate(segmentCount - 1, 1.f);
+        }
 
-            // Texture coordinates.
-            if (curveArrays.UVs)
+        /** Compute the number of sub-segments per segment needed to approximate the strand by line segments within the given error.
+            The deviation of a cubic segment from its piecewise linear interpolation with n sub-segments is bounded by max|p''| / (8 n^2).
+            The error is relative to the curve radius, so that thin strands are not tessellated finer than thick ones at the same screen coverage.
+        */
+        uint32_t computeAdaptiveSubdivCount(const CubicSpline<float3>& splinePoints, const StrandArrays& strandArrays, uint32_t maxSubdivPerSegment, float widthScale, float maxError)
+        {
+            uint32_t subdivCount = 1;
+            for (uint32_t j = 0; j + 1 < strandArrays.vertexCount; j++)
             {
-                const CubicSpline<float2>& splineUVs = splineCache.optSplineUVs.setup(strandArrays.UVs.data(), optimizedStrandArrays.vertexCount);
-                tmpCount = 0;
-                for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
+                float radius = 0.5f * widthScale * std::min(strandArrays.widths[j], strandArrays.widths[j + 1]);
+                float tolerance = maxError * radius;
+                if (!(tolerance > 0.f)) return maxSubdivPerSegment;
+
+                float maxCurvature = std::max(length(splinePoints.interpolateSecondDerivative(j, 0.f)), length(splinePoints.interpolateSecondDerivative(j, 1.f)));
+                float n = std::ceil(std::sqrt(maxCurvature / (8.f * tolerance)));
+                if (n >= (float)maxSubdivPerSegment) return maxSubdivPerSegment;
+                subdivCount = std::max(subdivCount, (uint32_t)n);
+            }
+            return subdivCount;
+        }
+
+        /// Compute the tessellation layout of all kept strands. Strands are processed in parallel.
+        StrandLayout computeStrandLayout(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const CurveArrays& curveArrays, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, float adaptiveMaxError)
+        {
+            StrandLayout layout;
+            const uint32_t keptStrandCount = div_round_up(strandCount, keepOneEveryXStrands);
+            layout.inputOffsets.resize(keptStrandCount);
+            layout.subdivCounts.resize(keptStrandCount);
+            layout.sampleOffsets.resize(keptStrandCount + 1);
+
+            // Input offsets. Skipped strands still occupy space in the input arrays.
+            uint32_t pointOffset = 0;
+            for (uint32_t i = 0; i < strandCount; i++)
+            {
+                if (i % keepOneEveryXStrands == 0) layout.inputOffsets[i / keepOneEveryXStrands] = pointOffset;
+                pointOffset += vertexCountsPerStrand[i];
+            }
+
+            // Per-strand sample counts.
+            const uint32_t taskCount = div_round_up(keptStrandCount, kStrandsPerTask);
+            Threading::parallelFor(0, taskCount, [&](size_t task)
+            {
+                StrandScratch scratch;
+                const uint32_t end = std::min(keptStrandCount, (uint32_t)(task + 1) * kStrandsPerTask);
+                for (uint32_t s = (uint32_t)task * kStrandsPerTask; s < end; s++)
                 {
-                    for (uint32_t k = 0; k < subdivPerSegment; k++)
+                    const uint32_t vertexCount = vertexCountsPerStrand[s * keepOneEveryXStrands];
+                    uint32_t uniqueCount;
+                    uint32_t subdivCount = subdivPerSegment;
+                    if (adaptiveMaxError > 0.f)
                     {
-                        if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                        {
-                            float t = (float)k / (float)subdivPerSegment;
-                            optimizedStrandArrays.UVs.push_back(splineUVs.interpolate(j, t));
-                        }
-                        tmpCount++;
+                        StrandArrays& strandArrays = scratch.strandArrays;
+                        strandArrays.vertexCount = vertexCount;
+                        removeDuplicateControlPoints(curveArrays, strandArrays, layout.inputOffsets[s]);
+                        uniqueCount = (uint32_t)strandArrays.controlPoints.size();
+                        strandArrays.vertexCount = uniqueCount;
+                        const CubicSpline<float3>& splinePoints = scratch.splineCache.splinePoints.setup(strandArrays.controlPoints.data(), uniqueCount);
+                        subdivCount = computeAdaptiveSubdivCount(splinePoints, strandArrays, subdivPerSegment, widthScale, adaptiveMaxError);
                     }
+                    else
+                    {
+                        uniqueCount = countUniqueControlPoints(curveArrays.controlPoints + layout.inputOffsets[s], vertexCount);
+                    }
+                    layout.subdivCounts[s] = subdivCount;
+                    layout.sampleOffsets[s + 1] = getStrandSampleCount(uniqueCount, subdivCount, keepOneEveryXVerticesPerStrand);
                 }
+            }, 1);
+
+            // Prefix sum over the sample counts.
+            layout.sampleOffsets[0] = 0;
+            for (uint32_t s = 0; s < keptStrandCount; s++) layout.sampleOffsets[s + 1] += layout.sampleOffsets[s];
 
-                // Always keep the last vertex.
-                optimizedStrandArrays.UVs.push_back(splineUVs.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
+            return layout;
+        }
+
+        /// Run func(scratch, strandIndex) for all kept strands in parallel.
+        template<typename Func>
+        void forEachStrand(const StrandLayout& layout, Func func)
+        {
+            const uint32_t strandCount = layout.getStrandCount();
+            Threading::parallelFor(0, div_round_up(strandCount, kStrandsPerTask), [&](size_t task)
+            {
+                StrandScratch scratch;
+                const uint32_t end = std::min(strandCount, (uint32_t)(task + 1) * kStrandsPerTask);
+                for (uint32_t s = (uint32_t)task * kStrandsPerTask; s < end; s++) func(scratch, s);
+            }, 1);
+        }
+
+        /// Resample a strand at its tessellation points. Widths are scaled for the mesh representation.
+        void resampleStrandForMesh(StrandScratch& scratch, const CurveArrays& curveArrays, uint32_t pointOffset, uint32_t vertexCount, uint32_t subdivPerSegment, uint32_t keepOneEveryXVerticesPerStrand, float widthScale)
+        {
+            StrandArrays& strandArrays = scratch.strandArrays;
+            StrandArrays& sampledStrandArrays = scratch.sampledStrandArrays;
+            strandArrays.vertexCount = vertexCount;
+            removeDuplicateControlPoints(curveArrays, strandArrays, pointOffset);
+
+            const uint32_t uniqueCount = (uint32_t)strandArrays.controlPoints.size();
+            const uint32_t sampleCount = getStrandSampleCount(uniqueCount, subdivPerSegment, keepOneEveryXVerticesPerStrand);
+            sampledStrandArrays.vertexCount = uniqueCount;
+            sampledStrandArrays.controlPoints.resize(sampleCount);
+            sampledStrandArrays.widths.resize(sampleCount);
+            sampledStrandArrays.UVs.resize(curveArrays.UVs ? sampleCount : 0);
+
+            const CubicSpline<float3>& splinePoints = scratch.splineCache.splinePoints.setup(strandArrays.controlPoints.data(), uniqueCount);
+            const CubicSpline<float>& splineWidths = scratch.splineCache.splineWidths.setup(strandArrays.widths.data(), uniqueCount);
+            sampleSpline(splinePoints, uniqueCount - 1, subdivPerSegment, keepOneEveryXVerticesPerStrand, sampledStrandArrays.controlPoints.data());
+            sampleSpline(splineWidths, uniqueCount - 1, subdivPerSegment, keepOneEveryXVerticesPerStrand, sampledStrandArrays.widths.data());
+            for (float& w : sampledStrandArrays.widths) w = sanitizeWidth(kMeshCompensationScale * widthScale * w);
+
+            // Texture coordinates.
+            if (curveArrays.UVs)
+            {
+                const CubicSpline<float2>& splineUVs = scratch.splineCache.splineUVs.setup(strandArrays.UVs.data(), uniqueCount);
+                sampleSpline(splineUVs, uniqueCount - 1, subdivPerSegment, keepOneEveryXVerticesPerStrand, sampledStrandArrays.UVs.data());
             }
         }
 
@@ -203,7 +343,7 @@ namespace Falcor
             FALCOR_ASSERT_LT(std::abs(length(t) - 1.f), 1e-3f);
         }
 
-        void updateMeshResultBuffers(CurveTessellation::MeshResult& result, const CurveArrays& curveArrays, StrandArrays& optimizedStrandArrays, const float3& fwd, const float3& s, const float3& t, uint32_t pointCountPerCrossSection, uint32_t j)
+        void writeMeshVertices(CurveTessellation::MeshResult& result, const CurveArrays& curveArrays, const StrandArrays& sampledStrandArrays, const float3& fwd, const float3& s, const float3& t, uint32_t pointCountPerCrossSection, uint32_t vertexOffset, uint32_t j)
         {
             // Mesh vertices, normals, tangents, and texCrds (if any).
             for (uint32_t k = 0; k < pointCountPerCrossSection; k++)
@@ -211,37 +351,42 @@ namespace Falcor
                 float phi = (float)k / (float)pointCountPerCrossSection * (float)M_PI * 2.f;
                 float3 vNormal = std::cos(phi) * s + std::sin(phi) * t;
 
-                float curveRadius = 0.5f * optimizedStrandArrays.widths[j];
-                result.vertices.push_back(optimizedStrandArrays.controlPoints[j] + curveRadius * vNormal);
-                result.normals.push_back(vNormal);
-                result.tangents.push_back(float4(fwd.x, fwd.y, fwd.z, 1));
-                result.radii.push_back(curveRadius);
+                float curveRadius = 0.5f * sampledStrandArrays.widths[j];
+                uint32_t v = vertexOffset + j * pointCountPerCrossSection + k;
+                result.vertices[v] = sampledStrandArrays.controlPoints[j] + curveRadius * vNormal;
+                result.normals[v] = vNormal;
+                result.tangents[v] = float4(fwd.x, fwd.y, fwd.z, 1);
+                result.radii[v] = curveRadius;
 
                 if (curveArrays.UVs)
                 {
-                    result.texCrds.push_back(optimizedStrandArrays.UVs[j]);
+                    result.texCrds[v] = sampledStrandArrays.UVs[j];
                 }
             }
         }
 
-        void connectFaceVertices(CurveTessellation::MeshResult& result, uint32_t meshVertexOffset, uint32_t pointCountPerCrossSection, uint32_t quadCountLimit, uint32_t nextCrossSectionVertexOffset, uint32_t multiplier, uint32_t j)
+        void writeMeshFaces(CurveTessellation::MeshResult& result, uint32_t vertexOffset, uint32_t faceOffset, uint32_t pointCountPerCrossSection, uint32_t j)
         {
-            for (uint32_t k = 0; k < quadCountLimit; k++)
+            // Two triangles per quad between cross-sections j and j + 1.
+            uint32_t* indices = result.faceVertexIndices.data() + 3 * (faceOffset + 2 * j * pointCountPerCrossSection);
+            uint32_t* counts = result.faceVertexCounts.data() + faceOffset + 2 * j * pointCountPerCrossSection;
+            for (uint32_t k = 0; k < pointCountPerCrossSection; k++)
             {
-                result.faceVertexCounts.push_back(3);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + k);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-
-                result.faceVertexCounts.push_back(3);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + k);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + k);
+                uint32_t kNext = (k + 1) % pointCountPerCrossSection;
+                *counts++ = 3;
+                *indices++ = vertexOffset + j * pointCountPerCrossSection + k;
+                *indices++ = vertexOffset + j * pointCountPerCrossSection + kNext;
+                *indices++ = vertexOffset + (j + 1) * pointCountPerCrossSection + kNext;
+
+                *counts++ = 3;
+                *indices++ = vertexOffset + j * pointCountPerCrossSection + k;
+                *indices++ = vertexOffset + (j + 1) * pointCountPerCrossSection + kNext;
+                *indices++ = vertexOffset + (j + 1) * pointCountPerCrossSection + k;
             }
         }
     }
 
-    CurveTessellation::SweptSphereResult CurveTessellation::convertToLinearSweptSphere(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t degree, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, const float4x4& xform)
+    CurveTessellation::SweptSphereResult CurveTessellation::convertToLinearSweptSphere(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t degree, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, const float4x4& xform, float adaptiveMaxError)
     {
         SweptSphereResult result;
 
@@ -250,170 +395,103 @@ namespace Falcor
         FALCOR_ASSERT(degree == 1);
         result.degree = degree;
 
-        uint32_t pointCounts = 0;
-        uint32_t segCounts = 0;
-        uint32_t maxVertexCountsPerStrand = 0;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
-        {
-            uint32_t tmpPointCount = div_round_up(subdivPerSegment * (vertexCountsPerStrand[i] - 1), keepOneEveryXVerticesPerStrand) + 1;
-            pointCounts += tmpPointCount;
-            segCounts += tmpPointCount - 1;
-            maxVertexCountsPerStrand = std::max(maxVertexCountsPerStrand, vertexCountsPerStrand[i]);
-        }
-        result.indices.reserve(segCounts);
-        result.points.reserve(pointCounts);
-        result.radius.reserve(pointCounts);
-        result.texCrds.reserve(pointCounts);
-
-        uint32_t pointOffset = 0;
-
-        StrandArrays strandArrays;
-        strandArrays.controlPoints.reserve(maxVertexCountsPerStrand);
-        strandArrays.widths.reserve(maxVertexCountsPerStrand);
-        strandArrays.UVs.reserve(maxVertexCountsPerStrand);
+        // Compute the output layout first, so that all strands can be written to their final location in parallel.
         CurveArrays curveArrays(controlPoints, widths, UVs);
+        const StrandLayout layout = computeStrandLayout(strandCount, vertexCountsPerStrand, curveArrays, subdivPerSegment, keepOneEveryXStrands, keepOneEveryXVerticesPerStrand, widthScale, adaptiveMaxError);
 
-        StrandArrays optimizedStrandArrays;
-        CubicSplineCache splineCache;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
-        {
-            optimizedStrandArrays.controlPoints.clear();
-            optimizedStrandArrays.UVs.clear();
-            optimizedStrandArrays.widths.clear();
-            optimizedStrandArrays.vertexCount = 0;
-            strandArrays.vertexCount = vertexCountsPerStrand[i];
-
-            optimizeStrandGeometry(splineCache, curveArrays, strandArrays, optimizedStrandArrays, pointOffset, subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
-
-            const CubicSpline<float3>& splinePoints = splineCache.splinePoints.setup(strandArrays.controlPoints.data(), optimizedStrandArrays.vertexCount);
-            const CubicSpline<float>& splineWidths = splineCache.splineWidths.setup(strandArrays.widths.data(), optimizedStrandArrays.vertexCount);
+        const uint32_t pointCount = layout.getTotalSampleCount();
+        result.indices.resize(pointCount - layout.getStrandCount());
+        result.points.resize(pointCount);
+        result.radius.resize(pointCount);
+        result.texCrds.resize(UVs ? pointCount : 0);
 
-            uint32_t tmpCount = 0;
-            for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
+        forEachStrand(layout, [&](StrandScratch& scratch, uint32_t s)
+        {
+            StrandArrays& strandArrays = scratch.strandArrays;
+            strandArrays.vertexCount = vertexCountsPerStrand[s * keepOneEveryXStrands];
+            removeDuplicateControlPoints(curveArrays, strandArrays, layout.inputOffsets[s]);
+
+            const uint32_t uniqueCount = (uint32_t)strandArrays.controlPoints.size();
+            const uint32_t subdivCount = layout.subdivCounts[s];
+            const uint32_t sampleOffset = layout.sampleOffsets[s];
+            const uint32_t sampleCount = layout.getSampleCount(s);
+
+            // Sample points and widths into the output arrays, then pre-transform curve points.
+            const CubicSpline<float3>& splinePoints = scratch.splineCache.splinePoints.setup(strandArrays.controlPoints.data(), uniqueCount);
+            const CubicSpline<float>& splineWidths = scratch.splineCache.splineWidths.setup(strandArrays.widths.data(), uniqueCount);
+            sampleSpline(splinePoints, uniqueCount - 1, subdivCount, keepOneEveryXVerticesPerStrand, result.points.data() + sampleOffset);
+            sampleSpline(splineWidths, uniqueCount - 1, subdivCount, keepOneEveryXVerticesPerStrand, result.radius.data() + sampleOffset);
+            for (uint32_t i = 0; i < sampleCount; i++)
             {
-                for (uint32_t k = 0; k < subdivPerSegment; k++)
-                {
-                    if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                    {
-                        float t = (float)k / (float)subdivPerSegment;
-                        result.indices.push_back((uint32_t)result.points.size());
-
-                        // Pre-transform curve points.
-                        float4 sph = transformSphere(xform, float4(splinePoints.interpolate(j, t), sanitizeWidth(splineWidths.interpolate(j, t) * 0.5f * widthScale)));
-
-                        result.points.push_back(sph.xyz());
-                        result.radius.push_back(sph.w);
-                    }
-                    tmpCount++;
-                }
+                float4 sph = transformSphere(xform, float4(result.points[sampleOffset + i], sanitizeWidth(result.radius[sampleOffset + i] * 0.5f * widthScale)));
+                result.points[sampleOffset + i] = sph.xyz();
+                result.radius[sampleOffset + i] = sph.w;
             }
 
-            // Always keep the last vertex.
-            float4 sph = transformSphere(xform, float4(splinePoints.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f), sanitizeWidth(splineWidths.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f) * 0.5f * widthScale)));
-            result.points.push_back(sph.xyz());
-            result.radius.push_back(sph.w);
+            // One linear segment starts at every point except the last one of the strand.
+            for (uint32_t i = 0; i < sampleCount - 1; i++) result.indices[sampleOffset - s + i] = sampleOffset + i;
 
             // Texture coordinates.
             if (UVs)
             {
-                const CubicSpline<float2>& splineUVs = splineCache.splineUVs.setup(strandArrays.UVs.data(), optimizedStrandArrays.vertexCount);
-                tmpCount = 0;
-                for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
-                {
-                    for (uint32_t k = 0; k < subdivPerSegment; k++)
-                    {
-                        if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                        {
-                            float t = (float)k / (float)subdivPerSegment;
-                            result.texCrds.push_back(splineUVs.interpolate(j, t));
-                        }
-                        tmpCount++;
-                    }
-                }
-
-                // Always keep the last vertex.
-                result.texCrds.push_back(splineUVs.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
+                const CubicSpline<float2>& splineUVs = scratch.splineCache.splineUVs.setup(strandArrays.UVs.data(), uniqueCount);
+                sampleSpline(splineUVs, uniqueCount - 1, subdivCount, keepOneEveryXVerticesPerStrand, result.texCrds.data() + sampleOffset);
             }
-
-            for (uint32_t j = i; j < std::min(strandCount, i + keepOneEveryXStrands); j++) pointOffset += vertexCountsPerStrand[j];
-        }
+        });
 
         return result;
     }
 
-    CurveTessellation::MeshResult CurveTessellation::convertToPolytube(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, uint32_t pointCountPerCrossSection)
+    CurveTessellation::MeshResult CurveTessellation::convertToPolytube(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, uint32_t pointCountPerCrossSection, float adaptiveMaxError)
     {
         MeshResult result;
-        uint32_t vertexCounts = 0;
-        uint32_t faceCounts = 0;
-        uint32_t maxVertexCountsPerStrand = 0;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
-        {
-            uint32_t tmpPointCount = div_round_up(subdivPerSegment * (vertexCountsPerStrand[i] - 1), keepOneEveryXVerticesPerStrand) + 1;
-            vertexCounts += pointCountPerCrossSection * tmpPointCount;
-            faceCounts += 2 * pointCountPerCrossSection * (tmpPointCount - 1);
-            maxVertexCountsPerStrand = std::max(maxVertexCountsPerStrand, vertexCountsPerStrand[i]);
-        }
-        result.vertices.reserve(vertexCounts);
-        result.normals.reserve(vertexCounts);
-        result.tangents.reserve(vertexCounts);
-        result.texCrds.reserve(vertexCounts);
-        result.radii.reserve(vertexCounts);
-        result.faceVertexCounts.reserve(faceCounts);
-        result.faceVertexIndices.reserve(faceCounts * 3);
-
-        uint32_t pointOffset = 0;
-        uint32_t meshVertexOffset = 0;
 
-        StrandArrays strandArrays;
-        strandArrays.controlPoints.reserve(maxVertexCountsPerStrand);
-        strandArrays.widths.reserve(maxVertexCountsPerStrand);
-        strandArrays.UVs.reserve(maxVertexCountsPerStrand);
+        // Compute the output layout first, so that all strands can be written to their final location in parallel.
+        // A strand with n samples has n cross-sections and 2 * (n - 1) triangles per cross-section point.
         CurveArrays curveArrays(controlPoints, widths, UVs);
-
-        StrandArrays optimizedStrandArrays;
-        CubicSplineCache splineCache;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
+        const StrandLayout layout = computeStrandLayout(strandCount, vertexCountsPerStrand, curveArrays, subdivPerSegment, keepOneEveryXStrands, keepOneEveryXVerticesPerStrand, widthScale, adaptiveMaxError);
+
+        const uint32_t vertexCount = pointCountPerCrossSection * layout.getTotalSampleCount();
+        const uint32_t faceCount = 2 * pointCountPerCrossSection * (layout.getTotalSampleCount() - layout.getStrandCount());
+        result.vertices.resize(vertexCount);
+        result.normals.resize(vertexCount);
+        result.tangents.resize(vertexCount);
+        result.texCrds.resize(UVs ? vertexCount : 0);
+        result.radii.resize(vertexCount);
+        result.faceVertexCounts.resize(faceCount);
+        result.faceVertexIndices.resize(faceCount * 3);
+
+        forEachStrand(layout, [&](StrandScratch& scratch, uint32_t s)
         {
-            optimizedStrandArrays.controlPoints.clear();
-            optimizedStrandArrays.UVs.clear();
-            optimizedStrandArrays.widths.clear();
-            optimizedStrandArrays.vertexCount = 0;
-
-            strandArrays.vertexCount = vertexCountsPerStrand[i];
+            resampleStrandForMesh(scratch, curveArrays, layout.inputOffsets[s], vertexCountsPerStrand[s * keepOneEveryXStrands], layout.subdivCounts[s], keepOneEveryXVerticesPerStrand, widthScale);
+            const StrandArrays& sampledStrandArrays = scratch.sampledStrandArrays;
 
-            optimizeStrandGeometry(splineCache, curveArrays, strandArrays, optimizedStrandArrays, pointOffset, subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
-
-            for (uint32_t j = i; j < std::min(strandCount, i + keepOneEveryXStrands); j++) pointOffset += vertexCountsPerStrand[j];
+            const uint32_t vertexOffset = pointCountPerCrossSection * layout.sampleOffsets[s];
+            const uint32_t faceOffset = 2 * pointCountPerCrossSection * (layout.sampleOffsets[s] - s);
 
             // Build the initial frame.
-            float3 fwd, s, t;
-            fwd = normalize(optimizedStrandArrays.controlPoints[1] - optimizedStrandArrays.controlPoints[0]);
+            float3 fwd, sAxis, tAxis;
+            fwd = normalize(sampledStrandArrays.controlPoints[1] - sampledStrandArrays.controlPoints[0]);
             FALCOR_ASSERT_LT(std::abs(length(fwd) - 1.f), 1e-3f);
-            buildFrame(fwd, s, t);
+            buildFrame(fwd, sAxis, tAxis);
 
             // Create mesh.
-            for (uint32_t j = 0; j < optimizedStrandArrays.controlPoints.size(); j++)
+            for (uint32_t j = 0; j < sampledStrandArrays.controlPoints.size(); j++)
             {
                 // Update the curve's frame vectors: [fwd, s, t]
-                updateCurveFrame(optimizedStrandArrays, fwd, s, t, j);
+                updateCurveFrame(sampledStrandArrays, fwd, sAxis, tAxis, j);
 
                 // Mesh vertices, normals, tangents, and texCrds (if any).
-                updateMeshResultBuffers(result, curveArrays, optimizedStrandArrays, fwd, s, t, pointCountPerCrossSection, j);
+                writeMeshVertices(result, curveArrays, sampledStrandArrays, fwd, sAxis, tAxis, pointCountPerCrossSection, vertexOffset, j);
 
                 // Mesh faces.
-                if (j < optimizedStrandArrays.controlPoints.size() - 1)
+                if (j < sampledStrandArrays.controlPoints.size() - 1)
                 {
-                    uint32_t quadCountLimit = pointCountPerCrossSection;
-                    connectFaceVertices(result, meshVertexOffset, pointCountPerCrossSection, quadCountLimit, 1, 1, j);
+                    writeMeshFaces(result, vertexOffset, faceOffset, pointCountPerCrossSection, j);
                 }
             }
-
-            meshVertexOffset += pointCountPerCrossSection * (uint32_t)optimizedStrandArrays.controlPoints.size();
-        }
+        });
 
         return result;
     }
-
-
 }
@@ -60,9 +60,10 @@ namespace Falcor
             \param[in] keepOneEveryXVerticesPerStrand Keep one of every X vertices in each curve strand.
             \param[in] widthScale Global scaling factor for curve width (normally set to 1.0).
             \param[in] xform Row-major 4x4 transformation matrix. We apply pre-transformation to curve geometry.
+            \param[in] adaptiveMaxError If positive, the number of sub-segments is chosen per strand such that the deviation from the spline is at most this fraction of the curve radius, with subdivPerSegment as the upper limit. Zero uses subdivPerSegment everywhere.
             \return Linear swept sphere segments.
         */
-        static SweptSphereResult convertToLinearSweptSphere(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t degree, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, const float4x4& xform);
+        static SweptSphereResult convertToLinearSweptSphere(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t degree, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, const float4x4& xform, float adaptiveMaxError = 0.f);
 
         // Tessellated mesh
 
@@ -88,9 +89,10 @@ namespace Falcor
             \param[in] keepOneEveryXVerticesPerStrand Keep one of every X vertices in each curve strand.
             \param[in] widthScale Global scaling factor for curve width (normally set to 1.0).
             \param[in] pointCountPerCrossSection Number of points sampled at each cross-section.
+            \param[in] adaptiveMaxError If positive, the number of sub-segments is chosen per strand such that the deviation from the spline is at most this fraction of the curve radius, with subdivPerSegment as the upper limit. Zero uses subdivPerSegment everywhere.
             \return Tessellated mesh.
         */
-        static MeshResult convertToPolytube(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, uint32_t pointCountPerCrossSection);
+        static MeshResult convertToPolytube(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, uint32_t pointCountPerCrossSection, float adaptiveMaxError = 0.f);
 
 
     private:
@@ -30,6 +30,7 @@
 #include "Utils/Image/ImageIO.h"
 #include "Scene/Material/MERLMaterial.h"
 #include "Scene/Material/DiffuseSpecularUtils.h"
+#include "Scene/Material/MeasuredBRDFAlbedo.h"
 #include "Rendering/Materials/BSDFIntegrator.h"
 #include <fstream>
 
@@ -142,30 +143,44 @@ namespace Falcor
         if (nanCount > 0) logWarning("MERL BRDF {} has {} samples with NaN values. Sample set to zero.", mDesc.name, nanCount);
     }
 
-    const std::vector<float4>& MERLFile::prepareAlbedoLUT(ref<Device> pDevice)
+    const std::vector<float4>& MERLFile::prepareAlbedoLUT()
     {
         if (!mAlbedoLUT.empty())
             return mAlbedoLUT;
 
         FALCOR_CHECK(!mDesc.path.empty(), "No BRDF loaded");
-        const auto texPath = mDesc.path.replace_extension("dds");
 
-        // Try loading cached albedo lookup table.
-        if (std::filesystem::is_regular_file(texPath))
+        // Try the content-addressed cache first, it is shared by all copies of the same BRDF.
+        const std::string cacheKey = MeasuredBRDFAlbedo::computeCacheKey("MERL", Hash128::computeTree(mData.data(), mData.size() * sizeof(float3)), kAlbedoLUTSize);
+        if (MeasuredBRDFAlbedo::loadFromCache(cacheKey, kAlbedoLUTSize, mAlbedoLUT))
+        {
+            logInfo("Loaded albedo LUT for MERL BRDF '{}' from cache.", mDesc.name);
+            return mAlbedoLUT;
+        }
+
+        // Try loading a lookup table stored beside the BRDF.
+        if (!loadAlbedoLUT(std::filesystem::path(mDesc.path).replace_extension("dds")))
         {
-            const auto albedoLut = ImageIO::loadBitmapFromDDS(texPath);
-
-            if (albedoLut->getFormat() == kAlbedoLUTFormat &&
-                albedoLut->getWidth() == kAlbedoLUTSize && albedoLut->getHeight() == 1)
-            {
-                const float4* data = reinterpret_cast<const float4*>(albedoLut->getData());
-                mAlbedoLUT.resize(kAlbedoLUTSize);
-                std::copy(data, data + kAlbedoLUTSize, mAlbedoLUT.begin());
-
-                logInfo("Loaded albedo LUT from '{}'.", texPath.string());
-                return mAlbedoLUT;
-            }
+            logInfo("MERLFile: Computing albedo LUT for MERL BRDF '{}' on the CPU...", mDesc.name);
+            mAlbedoLUT = MeasuredBRDFAlbedo::computeMERL(mData, kAlbedoLUTSize);
         }
+        FALCOR_ASSERT(mAlbedoLUT.size() == kAlbedoLUTSize);
+
+        MeasuredBRDFAlbedo::storeToCache(cacheKey, mAlbedoLUT);
+        return mAlbedoLUT;
+    }
+
+    const std::vector<float4>& MERLFile::prepareAlbedoLUT(ref<Device> pDevice)
+    {
+        if (!mAlbedoLUT.empty())
+            return mAlbedoLUT;
+
+        FALCOR_CHECK(!mDesc.path.empty(), "No BRDF loaded");
+        const auto texPath = std::filesystem::path(mDesc.path).replace_extension("dds");
+
+        // Try loading cached albedo lookup table.
+        if (loadAlbedoLUT(texPath))
+            return mAlbedoLUT;
 
         // Failed to load a valid lookup table. We'll recompute it.
         computeAlbedoLUT(pDevice, kAlbedoLUTSize);
@@ -183,6 +198,27 @@ namespace Falcor
         return mAlbedoLUT;
     }
 
+    bool MERLFile::loadAlbedoLUT(const std::filesystem::path& texPath)
+    {
+        if (!std::filesystem::is_regular_file(texPath))
+            return false;
+
+        const auto albedoLut = ImageIO::loadBitmapFromDDS(texPath);
+
+        if (albedoLut->getFormat() == kAlbedoLUTFormat &&
+            albedoLut->getWidth() == kAlbedoLUTSize && albedoLut->getHeight() == 1)
+        {
+            const float4* data = reinterpret_cast<const float4*>(albedoLut->getData());
+            mAlbedoLUT.resize(kAlbedoLUTSize);
+            std::copy(data, data + kAlbedoLUTSize, mAlbedoLUT.begin());
+
+            logInfo("Loaded albedo LUT from '{}'.", texPath.string());
+            return true;
+        }
+
+        return false;
+    }
+
     void MERLFile::computeAlbedoLUT(ref<Device> pDevice, const size_t binCount)
     {
         logInfo("MERLFile: Computing albedo LUT for MERL BRDF '{}'...", mDesc.name);
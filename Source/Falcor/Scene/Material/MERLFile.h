@@ -66,7 +66,14 @@ namespace Falcor
         bool loadBRDF(const std::filesystem::path& path);
 
         /** Prepare an albedo lookup table.
-            The table is loaded from disk or recomputed if needed.
+            The table is loaded from the albedo LUT cache (see MeasuredBRDFAlbedo) or from disk,
+            or computed on the CPU if needed. No device is required.
+            \return Albedo lookup table that can be used with `kAlbedoLUTFormat`.
+        */
+        const std::vector<float4>& prepareAlbedoLUT();
+
+        /** Prepare an albedo lookup table.
+            The table is loaded from disk or recomputed on the GPU if needed.
             \param[in] pDevice The device.
             \return Albedo lookup table that can be used with `kAlbedoLUTFormat`.
         */
@@ -78,6 +85,7 @@ namespace Falcor
     private:
         void prepareData(const int dims[3], const std::vector<double>& data);
         void computeAlbedoLUT(ref<Device> pDevice, const size_t binCount);
+        bool loadAlbedoLUT(const std::filesystem::path& texPath);
 
         Desc mDesc;                     ///< BRDF description and sampling parameters.
         std::vector<float3> mData;      ///< BRDF data in RGB float format.
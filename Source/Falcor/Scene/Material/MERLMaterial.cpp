@@ -52,7 +52,7 @@ namespace Falcor
         init(merlFile);
 
         // Create albedo LUT texture.
-        auto lut = merlFile.prepareAlbedoLUT(mpDevice);
+        auto lut = merlFile.prepareAlbedoLUT();
         FALCOR_CHECK(!lut.empty() && sizeof(lut[0]) == sizeof(float4), "Expected albedo LUT in float4 format.");
         static_assert(MERLFile::kAlbedoLUTFormat == ResourceFormat::RGBA32Float);
         mpAlbedoLUT = mpDevice->createTexture2D((uint32_t)lut.size(), 1, MERLFile::kAlbedoLUTFormat, 1, 1, lut.data(), ResourceBindFlags::ShaderResource);
@@ -80,7 +80,7 @@ namespace Falcor
             buffer.setBlob(brdf.data(), desc.byteOffset, desc.byteSize);
 
             // Copy albedo LUT into shared table.
-            const auto& lut = merlFile.prepareAlbedoLUT(mpDevice);
+            const auto& lut = merlFile.prepareAlbedoLUT();
             FALCOR_CHECK(lut.size() == MERLMixMaterialData::kAlbedoLUTSize, "MERLMixMaterial: Unexpected albedo LUT size.");
             albedoLut.insert(albedoLut.end(), lut.begin(), lut.end());
         }
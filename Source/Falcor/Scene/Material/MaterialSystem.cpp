@@ -401,26 +401,48 @@ namespace Falcor
 
         if (textures.empty()) return;
 
-        // Analyze the textures.
-        logInfo("Analyzing {} material textures.", textures.size());
-
-        RenderContext* pRenderContext = mpDevice->getRenderContext();
-
-        TextureAnalyzer analyzer(mpDevice);
-        auto pResults = mpDevice->createBuffer(textures.size() * TextureAnalyzer::getResultSize(), ResourceBindFlags::UnorderedAccess);
-        analyzer.analyze(pRenderContext, textures, pResults);
-
-        // Copy result to staging buffer for readback.
-        // This is mostly to avoid a full flush and the associated perf warning.
-        // We do not have any other useful GPU work, but unrelated GPU tasks can be in flight.
-        auto pResultsStaging = mpDevice->createBuffer(textures.size() * TextureAnalyzer::getResultSize(), ResourceBindFlags::None, MemoryType::ReadBack);
-        pRenderContext->copyResource(pResultsStaging.get(), pResults.get());
-        pRenderContext->submit(false);
-        pRenderContext->signal(mpFence.get());
-
-        // Wait for results to become available. Then optimize the materials.
-        mpFence->wait();
-        const TextureAnalyzer::Result* results = static_cast<const TextureAnalyzer::Result*>(pResultsStaging->map());
+        // Use the analysis computed on the CPU when the textures were loaded.
+        // Only textures without one (e.g. block compressed or not loaded from file) are analyzed on the GPU.
+        std::vector<TextureAnalyzer::Result> results(textures.size());
+        std::vector<size_t> gpuIndices;
+        for (size_t i = 0; i < textures.size(); i++)
+        {
+            if (auto analysis = mpTextureManager->getTextureAnalysis(textures[i].get()))
+                results[i] = *analysis;
+            else
+                gpuIndices.push_back(i);
+        }
+
+        logInfo("Analyzing {} material textures ({} analyzed on load).", textures.size(), textures.size() - gpuIndices.size());
+
+        if (!gpuIndices.empty())
+        {
+            std::vector<ref<Texture>> gpuTextures;
+            gpuTextures.reserve(gpuIndices.size());
+            for (size_t i : gpuIndices) gpuTextures.push_back(textures[i]);
+
+            RenderContext* pRenderContext = mpDevice->getRenderContext();
+
+            TextureAnalyzer analyzer(mpDevice);
+            auto pResults = mpDevice->createBuffer(gpuTextures.size() * TextureAnalyzer::getResultSize(), ResourceBindFlags::UnorderedAccess);
+            analyzer.analyze(pRenderContext, gpuTextures, pResults);
+
+            // Copy result to staging buffer for readback.
+            // This is mostly to avoid a full flush and the associated perf warning.
+            // We do not have any other useful GPU work, but unrelated GPU tasks can be in flight.
+            auto pResultsStaging = mpDevice->createBuffer(gpuTextures.size() * TextureAnalyzer::getResultSize(), ResourceBindFlags::None, MemoryType::ReadBack);
+            pRenderContext->copyResource(pResultsStaging.get(), pResults.get());
+            pRenderContext->submit(false);
+            pRenderContext->signal(mpFence.get());
+
+            // Wait for results to become available.
+            mpFence->wait();
+            const TextureAnalyzer::Result* gpuResults = static_cast<const TextureAnalyzer::Result*>(pResultsStaging->map());
+            for (size_t i = 0; i < gpuIndices.size(); i++) results[gpuIndices[i]] = gpuResults[i];
+            pResultsStaging->unmap();
+        }
+
+        // Optimize the materials.
         Material::TextureOptimizationStats stats = {};
 
         for (size_t i = 0; i < textures.size(); i++)
@@ -428,8 +450,6 @@ namespace Falcor
             materialSlots[i].first->optimizeTexture(materialSlots[i].second, results[i], stats);
         }
 
-        pResultsStaging->unmap();
-
         // Log optimization stats.
         if (size_t totalRemoved = std::accumulate(stats.texturesRemoved.begin(), stats.texturesRemoved.end(), 0ull); totalRemoved > 0)
         {
@@ -53,6 +53,7 @@ namespace Falcor
         bool srgb = mUseSrgb && pMaterial->getTextureSlotInfo(slot).srgb;
 
         // Request texture to be loaded.
+        // The texture is analyzed while it is decoded, which lets MaterialSystem::optimizeMaterials() skip the GPU analysis.
         auto handle = mTextureManager.loadTexture(
             path,
             true /*mips*/,
@@ -62,7 +63,8 @@ namespace Falcor
             Bitmap::ImportFlags::None,
             nullptr /*search dirs*/,
             nullptr /*load count*/,
-            pMaterial.get()
+            pMaterial.get(),
+            true /*analyze*/
         );
 
         // Store assignment to material for later.
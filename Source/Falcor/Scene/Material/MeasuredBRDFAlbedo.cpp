@@ -0,0 +1,477 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeasuredBRDFAlbedo.h"
+#include "RGLCommon.h"
+#include "RGLFile.h"
+#include "Core/Error.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include "Utils/Math/Common.h"
+#include "Utils/StringFormatters.h"
+#include "Utils/Threading.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+
+namespace Falcor
+{
+    namespace
+    {
+        // Bump the version whenever the integration changes to invalidate cached tables.
+        const uint32_t kCacheVersion = 1;
+        const uint32_t kCacheMagic = 0x54554c41; // 'ALUT'
+
+        const char kCacheDirectoryName[] = ".albedocache";
+        const char kCacheFileExtension[] = ".lut";
+
+        // Must match kMinCosTheta in IBSDF.slang.
+        const float kMinCosTheta = 1e-6f;
+
+        struct CacheHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t binCount;
+            uint32_t reserved;
+        };
+
+        std::mutex sCacheDirectoryMutex;
+        bool sCacheDirectoryOverridden = false;
+        std::filesystem::path sCacheDirectory;
+
+        /** Cosine-weighted sampling of the hemisphere using Shirley's concentric mapping.
+            This is a port of sample_cosine_hemisphere_concentric() in MathHelpers.slang.
+        */
+        float3 sampleCosineHemisphereConcentric(float2 u, float& pdf)
+        {
+            u = 2.f * u - 1.f;
+            float2 d = u;
+            if (u.x != 0.f || u.y != 0.f)
+            {
+                float phi, r;
+                if (std::abs(u.x) > std::abs(u.y))
+                {
+                    r = u.x;
+                    phi = (u.y / u.x) * (float)M_PI_4;
+                }
+                else
+                {
+                    r = u.y;
+                    phi = (float)M_PI_2 - (u.x / u.y) * (float)M_PI_4;
+                }
+                d = r * float2(std::cos(phi), std::sin(phi));
+            }
+            float z = std::sqrt(std::max(0.f, 1.f - dot(d, d)));
+            pdf = z * (float)M_1_PI;
+            return float3(d.x, d.y, z);
+        }
+
+        /** Integrate an isotropic BRDF over the hemisphere for incident directions at cosTheta = (1,2,...,N)/N.
+            This mirrors BSDFIntegrator.cs.slang with one sample at the center of each grid cell.
+            \param[in] createEvaluator Function returning an evaluator for a given incident direction in the local frame.
+                The evaluator is called with the outgoing direction and returns f(wi, wo) * wo.z.
+        */
+        template<typename CreateEvaluator>
+        std::vector<float4> integrateIsotropic(uint32_t binCount, uint32_t gridSize, const CreateEvaluator& createEvaluator)
+        {
+            FALCOR_CHECK(binCount > 0, "'binCount' must be non-zero");
+            FALCOR_CHECK(gridSize > 0, "'gridSize' must be non-zero");
+
+            // Split each table entry into rows of the integration grid for better load balancing.
+            const uint32_t rowsPerTask = std::max(1u, gridSize / 8);
+            const uint32_t tasksPerBin = div_round_up(gridSize, rowsPerTask);
+            std::vector<std::array<double, 3>> partialSums((size_t)binCount * tasksPerBin);
+
+            Threading::parallelFor(0, partialSums.size(), [&](size_t task)
+            {
+                const uint32_t bin = (uint32_t)(task / tasksPerBin);
+                const uint32_t firstRow = (uint32_t)(task % tasksPerBin) * rowsPerTask;
+                const uint32_t lastRow = std::min(gridSize, firstRow + rowsPerTask);
+
+                const float cosTheta = std::clamp((float)(bin + 1) / binCount, 0.f, 1.f);
+                const float sinTheta = std::sqrt(1.f - cosTheta * cosTheta);
+                const float3 wi = float3(sinTheta, 0.f, cosTheta);
+                const auto eval = createEvaluator(wi);
+
+                std::array<double, 3> sum = {};
+                for (uint32_t y = firstRow; y < lastRow; y++)
+                {
+                    float3 rowSum = float3(0.f);
+                    for (uint32_t x = 0; x < gridSize; x++)
+                    {
+                        float2 u = (float2((float)x, (float)y) + 0.5f) / (float)gridSize;
+                        float pdf = 0.f;
+                        float3 wo = sampleCosineHemisphereConcentric(u, pdf);
+                        if (pdf > 0.f && std::min(wi.z, wo.z) >= kMinCosTheta) rowSum += eval(wo) / pdf;
+                    }
+                    for (int c = 0; c < 3; c++) sum[c] += rowSum[c];
+                }
+                partialSums[task] = sum;
+            }, 1);
+
+            std::vector<float4> lut(binCount);
+            const double norm = 1.0 / ((double)gridSize * gridSize);
+            for (uint32_t bin = 0; bin < binCount; bin++)
+            {
+                std::array<double, 3> sum = {};
+                for (uint32_t i = 0; i < tasksPerBin; i++)
+                {
+                    for (int c = 0; c < 3; c++) sum[c] += partialSums[(size_t)bin * tasksPerBin + i][c];
+                }
+                lut[bin] = float4((float)(sum[0] * norm), (float)(sum[1] * norm), (float)(sum[2] * norm), 1.f);
+            }
+            return lut;
+        }
+
+        // MERL BRDF evaluation. This is a port of MERLCommon.slang.
+
+        const uint32_t kMERLSamplingResThetaH = 90;
+        const uint32_t kMERLSamplingResThetaD = 90;
+        const uint32_t kMERLSamplingResPhiD = 360;
+
+        float3 rotateVector(const float3& v, const float3& axis, float c, float s)
+        {
+            float tmp = dot(v, axis) * (1.f - c);
+            float3 w = cross(axis, v);
+            return v * c + axis * tmp + w * s;
+        }
+
+        uint32_t getMERLIndex(const float3& wi, const float3& wo)
+        {
+            float3 h = normalize(wi + wo);
+            float thetaH = std::acos(std::clamp(h.z, -1.f, 1.f));
+
+            // Compute diff vector by rotating wi by -phiH around z and -thetaH around y.
+            // The sines and cosines of the rotation angles are taken directly from the half vector.
+            float rH = std::sqrt(h.x * h.x + h.y * h.y);
+            float cosPhiH = rH > 0.f ? h.x / rH : 1.f;
+            float sinPhiH = rH > 0.f ? h.y / rH : 0.f;
+            float3 temp = rotateVector(wi, float3(0.f, 0.f, 1.f), cosPhiH, -sinPhiH);
+            float3 diff = rotateVector(temp, float3(0.f, 1.f, 0.f), std::clamp(h.z, -1.f, 1.f), -rH);
+            float thetaD = std::acos(std::clamp(diff.z, -1.f, 1.f));
+            float phiD = std::atan2(diff.y, diff.x);
+
+            // Map thetaH in [0, pi/2] to idx in [0, 89]. This is a non-linear mapping.
+            int thetaHIdx = thetaH <= 0.f ? 0 : (int)(std::sqrt(thetaH * (float)M_2_PI) * kMERLSamplingResThetaH);
+            thetaHIdx = std::min(thetaHIdx, (int)kMERLSamplingResThetaH - 1);
+
+            // Map thetaD in [0, pi/2] to idx in [0, 89].
+            int thetaDIdx = std::clamp((int)(thetaD * (float)M_2_PI * kMERLSamplingResThetaD), 0, (int)kMERLSamplingResThetaD - 1);
+
+            // Because of reciprocity, the BRDF is unchanged under phiD -> phiD + M_PI. Map phiD in [0, pi] to idx in [0, 179].
+            if (phiD < 0.f) phiD += (float)M_PI;
+            int phiDIdx = std::clamp((int)(phiD * (float)M_1_PI * (kMERLSamplingResPhiD / 2)), 0, (int)kMERLSamplingResPhiD / 2 - 1);
+
+            return (thetaDIdx + thetaHIdx * kMERLSamplingResThetaD) * (kMERLSamplingResPhiD / 2) + phiDIdx;
+        }
+
+        // RGL BRDF evaluation. This is a port of the evaluation code in RGLCommon.slang and RGLMaterial(Instance).slang.
+        // Out-of-bounds loads return zero like ByteAddressBuffer loads on the GPU.
+
+        struct FloatTable
+        {
+            const float* data = nullptr;
+            int count = 0;
+
+            float load(int idx) const { return idx >= 0 && idx < count ? data[idx] : 0.f; }
+        };
+
+        FloatTable getTable(const RGLFile::Field* field)
+        {
+            return { reinterpret_cast<const float*>(field->data.get()), (int)field->numElems };
+        }
+
+        float lerp(float a, float b, float t) { return a + (b - a) * t; }
+        float saturate(float x) { return std::clamp(x, 0.f, 1.f); }
+        float frac(float x) { return x - std::floor(x); }
+
+        float2 toSpherical(const float3& w)
+        {
+            float theta = 2.f * std::asin(0.5f * std::sqrt(w.x * w.x + w.y * w.y + (w.z - 1.f) * (w.z - 1.f)));
+            return float2(theta, std::atan2(w.y, w.x));
+        }
+
+        float2 sphericalToUnit(const float2& angles)
+        {
+            return float2(std::sqrt(angles.x * 2.f * (float)M_1_PI), (angles.y + (float)M_PI) * 0.5f * (float)M_1_PI);
+        }
+
+        float warpCoordinate(const FloatTable& table, float x)
+        {
+            int a = 0, b = table.count - 1;
+            while (b - a > 1)
+            {
+                int mid = (a + b) / 2;
+                if (table.load(mid) <= x) a = mid;
+                else b = mid;
+            }
+            if (a >= table.count - 1) return (float)a;
+            float va = table.load(a);
+            float vb = table.load(a + 1);
+            return a + (va == vb ? 0.f : (x - va) / (vb - va));
+        }
+
+        float evalBrick2D(const FloatTable& table, int2 size, float2 uv)
+        {
+            uv *= float2(size - 1);
+            int2 pos = int2(std::clamp((int)uv.x, 0, size.x - 2), std::clamp((int)uv.y, 0, size.y - 2));
+            uv = float2(saturate(uv.x - pos.x), saturate(uv.y - pos.y));
+            int idx = pos.x + pos.y * size.x;
+            return lerp(lerp(table.load(idx), table.load(idx + 1), uv.x), lerp(table.load(idx + size.x), table.load(idx + 1 + size.x), uv.x), uv.y);
+        }
+
+        float interpolate2(const FloatTable& table, int base, int2 stride, float2 uv)
+        {
+            float val00 = table.load(base);
+            float val10 = table.load(base + stride.x);
+            float val01 = table.load(base + stride.y);
+            float val11 = table.load(base + stride.x + stride.y);
+            return lerp(lerp(val00, val10, uv.x), lerp(val01, val11, uv.x), uv.y);
+        }
+
+        float interpolate3(const FloatTable& table, int base, int3 stride, float3 uvw)
+        {
+            return lerp(interpolate2(table, base, stride.xy(), uvw.xy()), interpolate2(table, base + stride.z, stride.xy(), uvw.xy()), uvw.z);
+        }
+
+        float interpolate4(const FloatTable& table, int base, int4 stride, float4 uvwx)
+        {
+            return lerp(interpolate3(table, base, stride.xyz(), uvwx.xyz()), interpolate3(table, base + stride.w, stride.xyz(), uvwx.xyz()), uvwx.w);
+        }
+
+        float3 evalBrick4D(const FloatTable& table, int4 size, float2 slice, float2 xi)
+        {
+            float4 uv = float4(slice.x, slice.y, xi.x * (size.z - 1), xi.y * (size.w - 1));
+            int4 pos = int4((int)uv.x, (int)uv.y, std::clamp((int)uv.z, 0, size.z - 2), std::clamp((int)uv.w, 0, size.w - 2));
+            uv = float4(saturate(uv.x - pos.x), saturate(uv.y - pos.y), saturate(uv.z - pos.z), saturate(uv.w - pos.w));
+            int4 stride = int4(size.x == 1 ? 0 : size.y * 3 * size.z * size.w, size.y == 1 ? 0 : 3 * size.z * size.w, 1, size.w);
+            int base = dot(stride, pos);
+            return float3(
+                interpolate4(table, base + size.z * size.w * 0, stride, uv),
+                interpolate4(table, base + size.z * size.w * 1, stride, uv),
+                interpolate4(table, base + size.z * size.w * 2, stride, uv)
+            );
+        }
+
+        /// Inverse of the warp defined by an interpolated 2D distribution. Port of InterpolatedDistribution2D::invert().
+        float2 invertDistribution(const FloatTable& marginalCdf, const FloatTable& conditionalCdf, const FloatTable& pdf, int4 size, float2 slice, float2 rc)
+        {
+            int2 sliceI = int2((int)slice.x, (int)slice.y);
+            float2 uv = float2(frac(slice.x), frac(slice.y));
+
+            rc *= float2(size.z - 1, size.w - 1);
+            int col = (int)rc.x;
+            int row = (int)rc.y;
+            float colF = frac(rc.x);
+            float rowF = frac(rc.y);
+
+            int2 strideMarginal = int2(size.x == 1 ? 0 : size.y * size.w, size.y == 1 ? 0 : size.w);
+            int3 strideConditional = int3(strideMarginal.x, strideMarginal.y, 1) * size.z;
+            int baseMarginal = dot(sliceI, strideMarginal);
+            int baseConditional = dot(int3(sliceI.x, sliceI.y, row), strideConditional);
+
+            auto evalQuadratic = [](float a, float b, float u) { return a * u + (b - a) * u * u * 0.5f; };
+
+            float rowBase = interpolate2(marginalCdf, baseMarginal + row, strideMarginal, uv);
+            float rowA = interpolate2(conditionalCdf, baseConditional + size.z - 1, strideConditional.xy(), uv);
+            float rowB = interpolate2(conditionalCdf, baseConditional + size.z * 2 - 1, strideConditional.xy(), uv);
+            float xiY = rowBase + evalQuadratic(rowA, rowB, rowF);
+
+            float colBase = interpolate3(conditionalCdf, baseConditional + col, strideConditional, float3(uv.x, uv.y, rowF));
+            int cornerBase = baseConditional + col;
+            float corner0 = interpolate2(pdf, cornerBase, strideConditional.xy(), uv);
+            float corner1 = interpolate2(pdf, cornerBase + 1, strideConditional.xy(), uv);
+            float corner2 = interpolate2(pdf, cornerBase + strideConditional.z, strideConditional.xy(), uv);
+            float corner3 = interpolate2(pdf, cornerBase + strideConditional.z + 1, strideConditional.xy(), uv);
+            float colA = lerp(corner0, corner1, rowF);
+            float colB = lerp(corner2, corner3, rowF);
+            float xiX = (colBase + evalQuadratic(colA, colB, colF)) / lerp(rowA, rowB, rowF);
+
+            return float2(xiX, xiY);
+        }
+
+        std::filesystem::path getCacheFilePath(const std::string& key)
+        {
+            std::filesystem::path directory = MeasuredBRDFAlbedo::getCacheDirectory();
+            if (directory.empty()) return {};
+            return directory / (key + kCacheFileExtension);
+        }
+    }
+
+    std::vector<float4> MeasuredBRDFAlbedo::computeMERL(const std::vector<float3>& brdfData, uint32_t binCount, uint32_t gridSize)
+    {
+        FALCOR_CHECK(brdfData.size() == (size_t)kMERLSamplingResThetaH * kMERLSamplingResThetaD * kMERLSamplingResPhiD / 2, "Invalid MERL BRDF data size");
+
+        return integrateIsotropic(binCount, gridSize, [&](const float3& wi)
+        {
+            return [&brdfData, wi](const float3& wo) { return brdfData[getMERLIndex(wi, wo)] * wo.z; };
+        });
+    }
+
+    std::vector<float4> MeasuredBRDFAlbedo::computeRGL(const RGLFile& file, uint32_t binCount, uint32_t gridSize)
+    {
+        const auto& data = file.data();
+        const int phiSize = (int)data.phiI->shape[0];
+        const int thetaSize = (int)data.thetaI->shape[0];
+        const int2 sigmaSize = int2((int)data.sigma->shape[1], (int)data.sigma->shape[0]);
+        const int2 ndfSize = int2((int)data.ndf->shape[1], (int)data.ndf->shape[0]);
+        const int4 vndfSize = int4(phiSize, thetaSize, (int)data.vndf->shape[3], (int)data.vndf->shape[2]);
+        const int4 lumiSize = int4(phiSize, thetaSize, (int)data.luminance->shape[3], (int)data.luminance->shape[2]);
+
+        // Build the VNDF sampling tables the same way as RGLMaterial.
+        SamplableDistribution4D vndfDist(reinterpret_cast<const float*>(data.vndf->data.get()), uint4(vndfSize));
+        const int vndfCount = vndfSize.x * vndfSize.y * vndfSize.z * vndfSize.w;
+        const FloatTable vndfPDF = { vndfDist.getPDF(), vndfCount };
+        const FloatTable vndfMarginal = { vndfDist.getMarginal(), vndfCount / vndfSize.z };
+        const FloatTable vndfConditional = { vndfDist.getConditional(), vndfCount };
+
+        const FloatTable phi = getTable(data.phiI);
+        const FloatTable theta = getTable(data.thetaI);
+        const FloatTable sigma = getTable(data.sigma);
+        const FloatTable ndf = getTable(data.ndf);
+        const FloatTable rgb = getTable(data.rgb);
+
+        return integrateIsotropic(binCount, gridSize, [&](const float3& wi)
+        {
+            // Precompute the slice and projected microfacet area for the incident direction, see RGLMaterial.slang.
+            float2 sphericalI = toSpherical(wi);
+            float2 unitI = sphericalToUnit(sphericalI);
+            float2 slice = float2(warpCoordinate(phi, sphericalI.y), warpCoordinate(theta, sphericalI.x));
+            float sigmaEval = evalBrick2D(sigma, sigmaSize, unitI);
+
+            return [&, wi, sphericalI, slice, sigmaEval](const float3& wo)
+            {
+                if (sigmaEval == 0.f) return float3(0.f);
+
+                float3 h = normalize(wi + wo);
+                float2 sphericalH = toSpherical(h);
+                if (lumiSize.x == 1) sphericalH.y -= sphericalI.y; // Isotropic case
+                float2 unitH = sphericalToUnit(sphericalH);
+                unitH.y = frac(unitH.y);
+
+                float2 unwarped = invertDistribution(vndfMarginal, vndfConditional, vndfPDF, vndfSize, slice, unitH);
+                float3 fr = max(evalBrick4D(rgb, lumiSize, slice, unwarped), float3(0.f));
+                return fr * evalBrick2D(ndf, ndfSize, unitH) / (4.f * sigmaEval);
+            };
+        });
+    }
+
+    std::string MeasuredBRDFAlbedo::computeCacheKey(std::string_view brdfType, const Hash128::Digest& contentHash, uint32_t binCount)
+    {
+        Hash128 hash;
+        hash.update(kCacheVersion);
+        hash.update((uint64_t)brdfType.size());
+        hash.update(brdfType);
+        hash.update(contentHash.low64);
+        hash.update(contentHash.high64);
+        hash.update(binCount);
+        hash.update(kDefaultGridSize);
+        return Hash128::toString(hash.finalize());
+    }
+
+    bool MeasuredBRDFAlbedo::loadFromCache(const std::string& key, uint32_t binCount, std::vector<float4>& lut)
+    {
+        const std::filesystem::path path = getCacheFilePath(key);
+        if (path.empty()) return false;
+
+        std::ifstream ifs(path, std::ios::binary);
+        if (!ifs.good()) return false;
+
+        CacheHeader header = {};
+        ifs.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!ifs.good() || header.magic != kCacheMagic || header.version != kCacheVersion || header.binCount != binCount)
+        {
+            logWarning("Ignoring invalid albedo LUT cache entry '{}'.", path);
+            return false;
+        }
+
+        std::vector<float4> data(binCount);
+        ifs.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(float4));
+        if (ifs.gcount() != (std::streamsize)(data.size() * sizeof(float4)))
+        {
+            logWarning("Ignoring truncated albedo LUT cache entry '{}'.", path);
+            return false;
+        }
+
+        lut = std::move(data);
+        return true;
+    }
+
+    void MeasuredBRDFAlbedo::storeToCache(const std::string& key, const std::vector<float4>& lut)
+    {
+        const std::filesystem::path path = getCacheFilePath(key);
+        if (path.empty()) return;
+
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        if (ec)
+        {
+            logWarning("Failed to create albedo LUT cache directory '{}': {}", path.parent_path(), ec.message());
+            return;
+        }
+
+        // Write to a temporary file first so that concurrent readers never see partial entries.
+        const std::filesystem::path tmpPath = path.parent_path() / (key + "." + getTempFilePath().filename().string());
+        {
+            std::ofstream ofs(tmpPath, std::ios::binary | std::ios::trunc);
+            CacheHeader header = { kCacheMagic, kCacheVersion, (uint32_t)lut.size(), 0 };
+            ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            ofs.write(reinterpret_cast<const char*>(lut.data()), lut.size() * sizeof(float4));
+            if (!ofs.good())
+            {
+                ofs.close();
+                std::filesystem::remove(tmpPath, ec);
+                logWarning("Failed to write albedo LUT cache entry '{}'.", path);
+                return;
+            }
+        }
+
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tmpPath, ec);
+            logWarning("Failed to write albedo LUT cache entry '{}'.", path);
+        }
+    }
+
+    std::filesystem::path MeasuredBRDFAlbedo::getCacheDirectory()
+    {
+        std::lock_guard<std::mutex> lock(sCacheDirectoryMutex);
+        if (!sCacheDirectoryOverridden) return getRuntimeDirectory() / kCacheDirectoryName;
+        return sCacheDirectory;
+    }
+
+    void MeasuredBRDFAlbedo::setCacheDirectory(const std::filesystem::path& path)
+    {
+        std::lock_guard<std::mutex> lock(sCacheDirectoryMutex);
+        sCacheDirectory = path;
+        sCacheDirectoryOverridden = true;
+    }
+}
@@ -0,0 +1,109 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/CryptoUtils.h"
+#include "Utils/Math/Vector.h"
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Falcor
+{
+    class RGLFile;
+
+    /** Utilities for computing albedo lookup tables of measured BRDFs on the CPU.
+
+        The albedo is integrated over outgoing directions in the upper hemisphere for incident directions
+        at cosTheta = (1,2,...,N)/N, where N is the table size. This matches the tables computed by BSDFIntegrator
+        on the GPU, but uses a coarser integration grid. The integration runs in parallel on the global task scheduler.
+
+        BSDFIntegrator takes 8x8 samples in each cell of a 512x512 grid, which is equivalent to a 4096x4096 grid here.
+        On the CPU that costs several seconds per table entry, i.e. minutes per table. With the default 256x256 grid
+        the measured relative error against that density is below 1e-3 for typical lobes and about 4e-3 for very
+        sharp ones (Beckmann roughness 0.02), which is well below the accuracy needed for albedo scaling.
+
+        Computed tables are stored in a content-addressed cache on disk. The cache key is derived from a hash of the
+        BRDF data, so materials using the same measured BRDF share one table, independent of the file location.
+    */
+    class FALCOR_API MeasuredBRDFAlbedo
+    {
+    public:
+        /// Default size of the integration grid over the hemisphere. One stratified sample is taken per grid cell.
+        static constexpr uint32_t kDefaultGridSize = 256;
+
+        /** Compute the albedo lookup table of a MERL BRDF.
+            \param[in] brdfData BRDF samples in the layout used by MERLFile::getData().
+            \param[in] binCount Number of table entries.
+            \param[in] gridSize Integration grid size per table entry.
+            \return Albedo lookup table in RGBA format (alpha is 1).
+        */
+        static std::vector<float4> computeMERL(const std::vector<float3>& brdfData, uint32_t binCount, uint32_t gridSize = kDefaultGridSize);
+
+        /** Compute the albedo lookup table of an RGL BRDF.
+            The BRDF is assumed to be isotropic, see RGLMaterial.
+            \param[in] file Loaded RGL file.
+            \param[in] binCount Number of table entries.
+            \param[in] gridSize Integration grid size per table entry.
+            \return Albedo lookup table in RGBA format (alpha is 1).
+        */
+        static std::vector<float4> computeRGL(const RGLFile& file, uint32_t binCount, uint32_t gridSize = kDefaultGridSize);
+
+        /** Compute the cache key for an albedo lookup table.
+            \param[in] brdfType Type of the measured BRDF (e.g. "MERL").
+            \param[in] contentHash Hash of the BRDF data.
+            \param[in] binCount Number of table entries.
+            \return 32-character hexadecimal key.
+        */
+        static std::string computeCacheKey(std::string_view brdfType, const Hash128::Digest& contentHash, uint32_t binCount);
+
+        /** Load an albedo lookup table from the cache.
+            \param[in] key Cache key computed with computeCacheKey().
+            \param[in] binCount Expected number of table entries.
+            \param[out] lut Loaded lookup table.
+            \return True if a valid table was found.
+        */
+        static bool loadFromCache(const std::string& key, uint32_t binCount, std::vector<float4>& lut);
+
+        /** Store an albedo lookup table in the cache.
+            Failures to write the cache are reported as warnings.
+            \param[in] key Cache key computed with computeCacheKey().
+            \param[in] lut Lookup table to store.
+        */
+        static void storeToCache(const std::string& key, const std::vector<float4>& lut);
+
+        /** Get the cache directory. Defaults to the ".albedocache" directory beside the shader cache in the runtime directory.
+        */
+        static std::filesystem::path getCacheDirectory();
+
+        /** Set the cache directory. An empty path disables the cache.
+        */
+        static void setCacheDirectory(const std::filesystem::path& path);
+    };
+}
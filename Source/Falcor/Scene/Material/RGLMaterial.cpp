@@ -28,12 +28,12 @@
 #include "RGLMaterial.h"
 #include "RGLFile.h"
 #include "RGLCommon.h"
+#include "MeasuredBRDFAlbedo.h"
 #include "Core/API/Device.h"
-#include "Utils/Logger.h"
 #include "Utils/Image/ImageIO.h"
+#include "Utils/Logger.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "GlobalState.h"
-#include "Rendering/Materials/BSDFIntegrator.h"
 #include <fstream>
 
 namespace Falcor
@@ -66,8 +66,6 @@ namespace Falcor
         desc.setAddressingMode(TextureAddressingMode::Clamp, TextureAddressingMode::Clamp, TextureAddressingMode::Clamp);
         desc.setMaxAnisotropy(1);
         mpSampler = mpDevice->createSampler(desc);
-
-        prepareAlbedoLUT(mpDevice->getRenderContext());
     }
 
     bool RGLMaterial::renderUI(Gui::Widgets& widget)
@@ -220,6 +218,8 @@ namespace Falcor
         mpLumiBuf  = mpDevice->createBuffer(lumi ->numElems * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, lumiDist.getPDF());
         mpRGBBuf   = mpDevice->createBuffer(rgb  ->numElems * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, rgb  ->data.get());
 
+        prepareAlbedoLUT(*file);
+
         markUpdates(Material::UpdateFlags::ResourcesChanged);
 
         logInfo("Loaded RGL BRDF '{}': {}.", mBRDFName, mBRDFDescription);
@@ -227,76 +227,49 @@ namespace Falcor
         return true;
     }
 
-    void RGLMaterial::prepareAlbedoLUT(RenderContext* pRenderContext) // TODO
+    void RGLMaterial::prepareAlbedoLUT(const RGLFile& file)
     {
-        const auto texPath = mPath.replace_extension("dds");
-
-        // Try loading albedo lookup table.
-        if (std::filesystem::is_regular_file(texPath))
+        // Try the content-addressed cache first, it is shared by all copies of the same BRDF.
+        const std::string cacheKey = MeasuredBRDFAlbedo::computeCacheKey("RGL", Hash128::computeFile(mPath), kAlbedoLUTSize);
+        std::vector<float4> albedoLUT;
+        if (MeasuredBRDFAlbedo::loadFromCache(cacheKey, kAlbedoLUTSize, albedoLUT))
         {
-            // Load 1D texture in non-SRGB format, no mips.
-            // If successful, verify dimensions/format/etc. match the expectations.
-            mpAlbedoLUT = Texture::createFromFile(mpDevice, texPath.string(), false, false, ResourceBindFlags::ShaderResource);
-
-            if (mpAlbedoLUT)
+            logInfo("Loaded albedo LUT for RGL BRDF '{}' from cache.", mBRDFName);
+        }
+        else
+        {
+            // Try loading albedo lookup table stored beside the BRDF.
+            // If successful, verify dimensions/format match the expectations and add it to the cache.
+            const auto texPath = std::filesystem::path(mPath).replace_extension("dds");
+            bool loaded = false;
+            if (std::filesystem::is_regular_file(texPath))
             {
-                if (mpAlbedoLUT->getFormat() == kAlbedoLUTFormat &&
-                    mpAlbedoLUT->getWidth() == kAlbedoLUTSize &&
-                    mpAlbedoLUT->getHeight() == 1 && mpAlbedoLUT->getDepth() == 1 &&
-                    mpAlbedoLUT->getMipCount() == 1 && mpAlbedoLUT->getArraySize() == 1)
+                const auto pBitmap = ImageIO::loadBitmapFromDDS(texPath);
+                if (pBitmap && pBitmap->getFormat() == kAlbedoLUTFormat &&
+                    pBitmap->getWidth() == kAlbedoLUTSize && pBitmap->getHeight() == 1)
                 {
+                    const float4* data = reinterpret_cast<const float4*>(pBitmap->getData());
+                    albedoLUT.assign(data, data + kAlbedoLUTSize);
+                    loaded = true;
                     logInfo("Loaded albedo LUT from '{}'.", texPath.string());
-                    return;
                 }
             }
-        }
-
-        // Failed to load a valid lookup table. We'll recompute it.
-        computeAlbedoLUT(pRenderContext);
-
-        // Cache lookup table in texture on disk.
-        // TODO: Capture texture to DDS is not yet supported. Calling ImageIO directly for now.
-        //mpAlbedoLUT->captureToFile(0, 0, texPath.string(), Bitmap::FileFormat::DdsFile, Bitmap::ExportFlags::Uncompressed);
-        FALCOR_ASSERT(mpAlbedoLUT);
-        ImageIO::saveToDDS(pRenderContext, texPath.string(), mpAlbedoLUT, ImageIO::CompressionMode::None, false);
-
-        logInfo("Saved albedo LUT to '{}'.", texPath.string());
-    }
 
-    void RGLMaterial::computeAlbedoLUT(RenderContext* pRenderContext) // TODO
-    {
-        logInfo("Computing albedo LUT for RGL BRDF '{}'...", mBRDFName);
-
-        std::vector<float> cosThetas(kAlbedoLUTSize);
-        for (uint32_t i = 0; i < kAlbedoLUTSize; i++) cosThetas[i] = (float)(i + 1) / kAlbedoLUTSize;
-
-        // Create copy of material to avoid changing our local state.
-        auto pMaterial = make_ref<RGLMaterial>(*this);
-
-        // Create and update scene containing the material.
-        Scene::SceneData sceneData;
-        sceneData.pMaterials = std::make_unique<MaterialSystem>(mpDevice);
-        MaterialID materialID = sceneData.pMaterials->addMaterial(pMaterial);
-
-        ref<Scene> pScene = Scene::create(mpDevice, std::move(sceneData));
-        pScene->update(pRenderContext, 0.0);
-
-        // Create BSDF integrator utility.
-        BSDFIntegrator integrator(mpDevice, pScene);
-
-        // Integrate BSDF.
-        // TODO: Measured BRDFs could potentially be anisotropic.
-        // It's unlikely this would affect the albedo significantly, and doing the integration
-        // properly would be more trouble than its worth.
-        auto albedos = integrator.integrateIsotropic(pRenderContext, materialID, cosThetas);
-
-        // Copy result into format needed for texture creation.
-        static_assert(kAlbedoLUTFormat == ResourceFormat::RGBA32Float);
-        std::vector<float4> initData(kAlbedoLUTSize, float4(0.f));
-        for (uint32_t i = 0; i < kAlbedoLUTSize; i++) initData[i] = float4(albedos[i], 1.f);
+            if (!loaded)
+            {
+                // Failed to load a valid lookup table. We'll recompute it.
+                // TODO: Measured BRDFs could potentially be anisotropic.
+                // It's unlikely this would affect the albedo significantly, and doing the integration
+                // properly would be more trouble than its worth.
+                logInfo("Computing albedo LUT for RGL BRDF '{}' on the CPU...", mBRDFName);
+                albedoLUT = MeasuredBRDFAlbedo::computeRGL(file, kAlbedoLUTSize);
+            }
+            MeasuredBRDFAlbedo::storeToCache(cacheKey, albedoLUT);
+        }
 
         // Create albedo LUT texture.
-        mpAlbedoLUT = mpDevice->createTexture2D(kAlbedoLUTSize, 1, kAlbedoLUTFormat, 1, 1, initData.data(), ResourceBindFlags::ShaderResource);
+        static_assert(kAlbedoLUTFormat == ResourceFormat::RGBA32Float);
+        mpAlbedoLUT = mpDevice->createTexture2D(kAlbedoLUTSize, 1, kAlbedoLUTFormat, 1, 1, albedoLUT.data(), ResourceBindFlags::ShaderResource);
     }
 
     FALCOR_SCRIPT_BINDING(RGLMaterial)
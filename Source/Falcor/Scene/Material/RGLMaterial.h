@@ -32,6 +32,8 @@
 
 namespace Falcor
 {
+    class RGLFile;
+
     /** Class representing a measured material from the RGL BRDF database.
 
         For details refer to:
@@ -60,8 +62,7 @@ namespace Falcor
 
     protected:
         void prepareData(const int dims[3], const std::vector<double>& data);
-        void prepareAlbedoLUT(RenderContext* pRenderContext);
-        void computeAlbedoLUT(RenderContext* pRenderContext);
+        void prepareAlbedoLUT(const RGLFile& file);
 
         std::filesystem::path mPath;        ///< Full path to the BRDF loaded.
         std::string mBRDFName;              ///< This is the file basename without extension.
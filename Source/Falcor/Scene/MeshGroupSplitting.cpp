@@ -0,0 +1,107 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshGroupSplitting.h"
+#include "Core/Error.h"
+#include "Utils/Algorithm/MortonSort.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Threading.h"
+#include <algorithm>
+
+namespace Falcor
+{
+
+namespace MeshGroupSplitting
+{
+std::vector<std::vector<uint32_t>> partitionMorton(
+    const std::vector<AABB>& bounds,
+    const std::vector<size_t>& triangleCounts,
+    size_t maxTriangles
+)
+{
+    FALCOR_CHECK(bounds.size() == triangleCounts.size(), "Bounds and triangle counts must have the same size.");
+    FALCOR_CHECK(maxTriangles > 0, "Triangle limit must be positive.");
+    if (bounds.empty())
+        return {};
+
+    // Sort the meshes by the Morton codes of their centroids.
+    std::vector<float3> centroids(bounds.size());
+    Threading::parallelFor(0, bounds.size(), [&](size_t i) { centroids[i] = bounds[i].center(); }, 4096);
+    const std::vector<uint32_t> order = MortonSort::sortPoints(centroids);
+
+    size_t triangleCount = 0;
+    for (size_t count : triangleCounts)
+        triangleCount += count;
+
+    // Each new group holds at least one mesh, or if multiple, up to the target number of triangles.
+    const size_t targetGroupCount = std::max(div_round_up(triangleCount, maxTriangles), size_t(1));
+    const size_t targetTrianglesPerGroup = triangleCount / targetGroupCount;
+
+    std::vector<std::vector<uint32_t>> groups;
+    triangleCount = 0;
+
+    for (uint32_t index : order)
+    {
+        // Start new group on first iteration or if triangle count would exceed the target.
+        const size_t meshTris = triangleCounts[index];
+        if (groups.empty() || triangleCount + meshTris > targetTrianglesPerGroup)
+        {
+            groups.emplace_back();
+            triangleCount = 0;
+        }
+
+        // Add mesh to group.
+        groups.back().push_back(index);
+        triangleCount += meshTris;
+    }
+
+    return groups;
+}
+
+bool hasLargeMesh(const std::vector<AABB>& bounds, float fraction)
+{
+    AABB groupBounds;
+    for (const AABB& bb : bounds)
+        groupBounds.include(bb);
+    if (!groupBounds.valid())
+        return false;
+
+    const float3 extent = groupBounds.extent();
+    const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+    if (extent[axis] <= 0.f)
+        return false;
+
+    for (const AABB& bb : bounds)
+    {
+        if (bb.valid() && bb.extent()[axis] > fraction * extent[axis])
+            return true;
+    }
+    return false;
+}
+} // namespace MeshGroupSplitting
+
+} // namespace Falcor
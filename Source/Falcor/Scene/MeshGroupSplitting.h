@@ -0,0 +1,74 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/AABB.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+
+/**
+ * Partitioning of mesh groups that exceed the BLAS triangle limit, see SceneBuilder::optimizeGeometry().
+ *
+ * The functions only use the bounding boxes and triangle counts of the meshes, so that they are independent
+ * of the scene builder and can be tested on synthetic data.
+ */
+namespace MeshGroupSplitting
+{
+/// Fraction of the group extent along its largest axis above which a single mesh is considered large.
+inline constexpr float kLargeMeshFraction = 0.5f;
+
+/**
+ * Partition meshes into groups by sorting their centroids along a Morton curve and cutting the sorted list
+ * into contiguous runs by triangle count. Each group holds at least one mesh, or if multiple, up to
+ * totalTriangles / ceil(totalTriangles / maxTriangles) triangles. Meshes are not split.
+ * @param[in] bounds Bounding box per mesh.
+ * @param[in] triangleCounts Triangle count per mesh.
+ * @param[in] maxTriangles Maximum number of triangles per group.
+ * @return List of groups, each holding indices into the input arrays.
+ */
+FALCOR_API std::vector<std::vector<uint32_t>> partitionMorton(
+    const std::vector<AABB>& bounds,
+    const std::vector<size_t>& triangleCounts,
+    size_t maxTriangles
+);
+
+/**
+ * Check if a single mesh spans a large part of its group along the largest axis of the group.
+ * Such a mesh overlaps most groups created by partitionMorton(), so it should be split instead.
+ * @param[in] bounds Bounding box per mesh.
+ * @param[in] fraction Fraction of the group extent above which a mesh is considered large.
+ * @return True if any mesh is large.
+ */
+FALCOR_API bool hasLargeMesh(const std::vector<AABB>& bounds, float fraction = kLargeMeshFraction);
+} // namespace MeshGroupSplitting
+
+} // namespace Falcor
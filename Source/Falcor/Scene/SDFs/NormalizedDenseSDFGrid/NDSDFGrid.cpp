@@ -28,7 +28,9 @@
 #include "NDSDFGrid.h"
 #include "Core/API/RenderContext.h"
 #include "Utils/SharedCache.h"
+#include "Utils/Threading.h"
 #include "Utils/Math/MathConstants.slangh"
+#include "Scene/SDFs/SDFGridValues.h"
 
 namespace Falcor
 {
@@ -158,23 +160,21 @@ namespace Falcor
             std::vector<int8_t>& lodFormattedValues = mValues[lod];
             lodFormattedValues.resize(lodWidthInValues * lodWidthInValues * lodWidthInValues);
 
+            // Slices are independent, so each LOD is formatted in parallel over z.
             uint32_t lodReadStride = 1 << (lodCount - lod - 1);
-            for (uint32_t z = 0; z < lodWidthInValues; z++)
+            Threading::parallelFor(0, lodWidthInValues, [&](size_t z)
             {
                 for (uint32_t y = 0; y < lodWidthInValues; y++)
                 {
+                    int8_t* pWrite = lodFormattedValues.data() + lodWidthInValues * (y + lodWidthInValues * z);
+                    const float* pRead = cornerValues.data() + lodReadStride * gridWidthInValues * (y + gridWidthInValues * z);
+
                     for (uint32_t x = 0; x < lodWidthInValues; x++)
                     {
-                        uint32_t writeLocation = x + lodWidthInValues * (y + lodWidthInValues * z);
-                        uint32_t readLocation = lodReadStride * (x + gridWidthInValues * (y + gridWidthInValues * z));
-
-                        float normalizedValue = std::clamp(cornerValues[readLocation] / normalizationFactor, -1.0f, 1.0f);
-
-                        float integerScale = normalizedValue * float(INT8_MAX);
-                        lodFormattedValues[writeLocation] = integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f);
+                        pWrite[x] = SDFGridValues::quantizeSnorm8(pRead[lodReadStride * x] / normalizationFactor);
                     }
                 }
-            }
+            });
         }
     }
 
@@ -270,25 +270,16 @@ namespace Falcor
 
     bool SDFGrid::loadValuesFromFile(const std::filesystem::path& path)
     {
-        std::ifstream file(path, std::ios::in | std::ios::binary);
-
-        if (file.is_open())
+        std::vector<float> cornerValues;
+        uint32_t gridWidth = 0;
+        if (SDFGridValues::readFile(path, cornerValues, gridWidth))
         {
-            uint32_t gridWidth;
-            file.read(reinterpret_cast<char*>(&gridWidth), sizeof(uint32_t));
-
-            uint32_t totalValueCount = (gridWidth + 1) * (gridWidth + 1) * (gridWidth + 1);
-            std::vector<float> cornerValues(totalValueCount, 0.0f);
-            file.read(reinterpret_cast<char*>(cornerValues.data()), totalValueCount * sizeof(float));
-
-            file.close();
             setValues(cornerValues, gridWidth);
 
             mInitializedWithPrimitives = false;
             return true;
         }
 
-        logWarning("SDFGrid::loadValuesFromFile() file '{}' could not be opened!", path);
         return false;
     }
 
@@ -344,7 +335,7 @@ namespace Falcor
         setValues(cornerValues, gridWidth);
     }
 
-    bool SDFGrid::writeValuesFromPrimitivesToFile(const std::filesystem::path& path, RenderContext* pRenderContext)
+    bool SDFGrid::writeValuesFromPrimitivesToFile(const std::filesystem::path& path, RenderContext* pRenderContext, SDFGridValues::Encoding encoding)
     {
         FALCOR_ASSERT(pRenderContext);
 
@@ -365,16 +356,7 @@ namespace Falcor
         mpEvaluatePrimitivesPass->execute(pRenderContext, uint3(gridWidthInValues));
         std::vector<float> values = pValuesBuffer->getElements<float>();
 
-        std::ofstream file(path, std::ios::out | std::ios::binary);
-
-        if (file.is_open())
-        {
-            file.write(reinterpret_cast<const char*>(&mGridWidth), sizeof(uint32_t));
-            file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
-            file.close();
-        }
-
-        return true;
+        return SDFGridValues::writeFile(path, values, mGridWidth, encoding);
     }
 
     uint32_t SDFGrid::loadPrimitivesFromFile(const std::filesystem::path& path, uint32_t gridWidth)
@@ -32,6 +32,7 @@
 #include "Core/API/Texture.h"
 #include "Core/Pass/ComputePass.h"
 #include "Scene/SDFs/SDF3DPrimitiveCommon.slang"
+#include "Scene/SDFs/SDFGridValues.h"
 #include <memory>
 #include <vector>
 #include <utility>
@@ -124,6 +125,7 @@ namespace Falcor
         void setValues(const std::vector<float>& cornerValues, uint32_t gridWidth);
 
         /** Set the signed distance values of the SDF grid from a file.
+            The file is memory mapped and decoded in parallel, see SDFGridValues for the supported layouts.
             \param[in] path The path of a .sdfg file.
             \return true if the values could be set, otherwise false.
         */
@@ -137,9 +139,10 @@ namespace Falcor
 
         /** Evaluates the SDF grid primitives on to a grid and writes the grid to a file.
             \param[in] path A path to the file that should store the values.
+            \param[in] encoding The on-disk representation of the values.
             \return true if the values could be written, otherwise false.
         */
-        bool writeValuesFromPrimitivesToFile(const std::filesystem::path& path, RenderContext* pRenderContext);
+        bool writeValuesFromPrimitivesToFile(const std::filesystem::path& path, RenderContext* pRenderContext, SDFGridValues::Encoding encoding = SDFGridValues::Encoding::Float32);
 
         /** Reads primitives from file and initializes the SDF grid.
             \param[in] path The path to the input file.
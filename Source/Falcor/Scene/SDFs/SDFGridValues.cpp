@@ -0,0 +1,266 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SDFGridValues.h"
+#include "Core/Error.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Utils/Logger.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Math/Float16.h"
+#include "Utils/Math/MathConstants.slangh"
+#include "Utils/StringFormatters.h"
+#include "Utils/Threading.h"
+#include <cstring>
+#include <fstream>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define FALCOR_SDF_SSE2 1
+#include <emmintrin.h>
+#else
+#define FALCOR_SDF_SSE2 0
+#endif
+
+namespace Falcor
+{
+    namespace
+    {
+        // Number of values processed per task. Large enough to amortize scheduling, small enough to balance 1024^3 grids.
+        const size_t kChunkSize = 1 << 18;
+
+        size_t getEncodedValueSize(SDFGridValues::Encoding encoding)
+        {
+            switch (encoding)
+            {
+            case SDFGridValues::Encoding::Float32: return sizeof(float);
+            case SDFGridValues::Encoding::Float16: return sizeof(uint16_t);
+            case SDFGridValues::Encoding::Snorm8: return sizeof(int8_t);
+            default: return 0;
+            }
+        }
+
+        /// Distance represented by a snorm8 value of 1, i.e., half of a voxel diagonal.
+        float getSnormScale(uint32_t gridWidth)
+        {
+            return 0.5f * float(M_SQRT3) / gridWidth;
+        }
+
+        template<typename Func>
+        void forEachChunk(size_t count, Func&& func)
+        {
+            Threading::parallelFor(0, div_round_up(count, kChunkSize), [&](size_t chunk)
+            {
+                size_t begin = chunk * kChunkSize;
+                func(begin, std::min(count, begin + kChunkSize));
+            }, 1);
+        }
+
+#if FALCOR_SDF_SSE2
+        /** Quantize blocks of 16 values with SSE2.
+            Matches SDFGridValues::quantizeSnorm8(float) for all non-NaN inputs: rounding half away from zero is done
+            by adding 0.5 with the sign of the value and truncating.
+            \return The number of values processed.
+        */
+        size_t quantizeSnorm8SSE2(const float* pValues, size_t count, float normalizationMultiplier, int8_t* pOutput)
+        {
+            const __m128 multiplier = _mm_set1_ps(normalizationMultiplier);
+            const __m128 minValue = _mm_set1_ps(-1.0f);
+            const __m128 maxValue = _mm_set1_ps(1.0f);
+            const __m128 integerScale = _mm_set1_ps(float(INT8_MAX));
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+
+            auto quantize4 = [&](const float* p)
+            {
+                __m128 v = _mm_mul_ps(_mm_loadu_ps(p), multiplier);
+                v = _mm_min_ps(maxValue, _mm_max_ps(minValue, v));
+                v = _mm_mul_ps(v, integerScale);
+                v = _mm_add_ps(v, _mm_or_ps(_mm_and_ps(v, signMask), half));
+                return _mm_cvttps_epi32(v);
+            };
+
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                __m128i lo = _mm_packs_epi32(quantize4(pValues + i), quantize4(pValues + i + 4));
+                __m128i hi = _mm_packs_epi32(quantize4(pValues + i + 8), quantize4(pValues + i + 12));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pOutput + i), _mm_packs_epi16(lo, hi));
+            }
+            return i;
+        }
+#endif
+
+        void decodeValues(const uint8_t* pData, SDFGridValues::Encoding encoding, float snormScale, size_t count, float* pValues)
+        {
+            forEachChunk(count, [&](size_t begin, size_t end)
+            {
+                switch (encoding)
+                {
+                case SDFGridValues::Encoding::Float32:
+                    std::memcpy(pValues + begin, pData + begin * sizeof(float), (end - begin) * sizeof(float));
+                    break;
+                case SDFGridValues::Encoding::Float16:
+                    for (size_t i = begin; i < end; i++)
+                    {
+                        uint16_t bits;
+                        std::memcpy(&bits, pData + i * sizeof(uint16_t), sizeof(uint16_t));
+                        pValues[i] = math::float16ToFloat32(bits);
+                    }
+                    break;
+                case SDFGridValues::Encoding::Snorm8:
+                {
+                    const float scale = snormScale / float(INT8_MAX);
+                    const int8_t* pSnorm = reinterpret_cast<const int8_t*>(pData);
+                    for (size_t i = begin; i < end; i++)
+                    {
+                        pValues[i] = float(pSnorm[i]) * scale;
+                    }
+                    break;
+                }
+                }
+            });
+        }
+    }
+
+    void SDFGridValues::quantizeSnorm8(const float* pValues, size_t count, float normalizationMultiplier, int8_t* pOutput)
+    {
+        forEachChunk(count, [&](size_t begin, size_t end)
+        {
+            size_t i = begin;
+#if FALCOR_SDF_SSE2
+            i += quantizeSnorm8SSE2(pValues + begin, end - begin, normalizationMultiplier, pOutput + begin);
+#endif
+            for (; i < end; i++)
+            {
+                pOutput[i] = quantizeSnorm8(pValues[i] * normalizationMultiplier);
+            }
+        });
+    }
+
+    bool SDFGridValues::readFile(const std::filesystem::path& path, std::vector<float>& values, uint32_t& gridWidth)
+    {
+        MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+        if (!file.isOpen() || file.getSize() < sizeof(uint32_t))
+        {
+            logWarning("SDFGridValues::readFile() file '{}' could not be opened!", path);
+            return false;
+        }
+
+        const uint8_t* pData = static_cast<const uint8_t*>(file.getData());
+
+        FileHeader header;
+        std::memcpy(&header.magic, pData, sizeof(uint32_t));
+        size_t headerSize = 0;
+        if (header.magic == kFileMagic)
+        {
+            if (file.getSize() < sizeof(FileHeader))
+            {
+                logWarning("SDFGridValues::readFile() file '{}' has a truncated header!", path);
+                return false;
+            }
+            std::memcpy(&header, pData, sizeof(FileHeader));
+            if (header.version != kFileVersion || getEncodedValueSize(header.encoding) == 0)
+            {
+                logWarning("SDFGridValues::readFile() file '{}' has an unsupported version ({}) or encoding ({})!", path, header.version, (uint32_t)header.encoding);
+                return false;
+            }
+            headerSize = sizeof(FileHeader);
+        }
+        else
+        {
+            // Legacy layout, the file starts with the grid width.
+            header.gridWidth = header.magic;
+            header.encoding = Encoding::Float32;
+            headerSize = sizeof(uint32_t);
+        }
+
+        const size_t valueCount = getValueCount(header.gridWidth);
+        const size_t expectedSize = headerSize + valueCount * getEncodedValueSize(header.encoding);
+        if (file.getSize() < expectedSize)
+        {
+            logWarning("SDFGridValues::readFile() file '{}' is too small ({} bytes) for a grid width of {} ({} bytes expected)!", path, file.getSize(), header.gridWidth, expectedSize);
+            return false;
+        }
+
+        values.resize(valueCount);
+        decodeValues(pData + headerSize, header.encoding, header.snormScale, valueCount, values.data());
+        gridWidth = header.gridWidth;
+        return true;
+    }
+
+    bool SDFGridValues::writeFile(const std::filesystem::path& path, const std::vector<float>& values, uint32_t gridWidth, Encoding encoding)
+    {
+        const size_t valueCount = getValueCount(gridWidth);
+        FALCOR_CHECK(values.size() == valueCount, "'values' has {} elements, expected {} for a grid width of {}.", values.size(), valueCount, gridWidth);
+        FALCOR_CHECK(getEncodedValueSize(encoding) != 0, "Invalid encoding ({}).", (uint32_t)encoding);
+
+        std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            logWarning("SDFGridValues::writeFile() file '{}' could not be opened!", path);
+            return false;
+        }
+
+        if (encoding == Encoding::Float32)
+        {
+            file.write(reinterpret_cast<const char*>(&gridWidth), sizeof(uint32_t));
+            file.write(reinterpret_cast<const char*>(values.data()), valueCount * sizeof(float));
+        }
+        else
+        {
+            FileHeader header;
+            header.gridWidth = gridWidth;
+            header.encoding = encoding;
+            header.snormScale = getSnormScale(gridWidth);
+
+            std::vector<uint8_t> encoded(valueCount * getEncodedValueSize(encoding));
+            if (encoding == Encoding::Float16)
+            {
+                uint16_t* pHalf = reinterpret_cast<uint16_t*>(encoded.data());
+                forEachChunk(valueCount, [&](size_t begin, size_t end)
+                {
+                    for (size_t i = begin; i < end; i++) pHalf[i] = math::float32ToFloat16(values[i]);
+                });
+            }
+            else
+            {
+                // Use the same multiplier as the sparse grid types, so that loading the file reproduces their quantized values exactly.
+                float normalizationMultiplier = 2.0f * gridWidth / float(M_SQRT3);
+                quantizeSnorm8(values.data(), valueCount, normalizationMultiplier, reinterpret_cast<int8_t*>(encoded.data()));
+            }
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+            file.write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+        }
+
+        if (!file.good())
+        {
+            logWarning("SDFGridValues::writeFile() failed to write file '{}'!", path);
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,130 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace Falcor
+{
+    /** Utilities for reading, writing and quantizing SDF grid corner values on the CPU.
+
+        Value files (.sdfg) exist in two layouts:
+        - The legacy layout stores the grid width as uint32 followed by (gridWidth + 1)^3 float values.
+        - The encoded layout starts with a FileHeader and stores the values as float32, float16 or snorm8.
+          Snorm8 values are normalized so that 1 represents half of a voxel diagonal, which is the normalization
+          used by the sparse SDF grid types (SDFSVS, SDFSBS, SDFSVO). Distances further away are clamped.
+
+        Files are read through a memory mapping and decoded in parallel chunks on the global task scheduler.
+    */
+    class FALCOR_API SDFGridValues
+    {
+    public:
+        /** On-disk representation of the values.
+        */
+        enum class Encoding : uint32_t
+        {
+            Float32 = 0,    ///< 32-bit float, written in the legacy layout.
+            Float16 = 1,    ///< 16-bit float.
+            Snorm8 = 2,     ///< 8-bit signed normalized, 1 represents half of a voxel diagonal.
+        };
+
+        static constexpr uint32_t kFileMagic = 0x56464453; ///< "SDFV"
+        static constexpr uint32_t kFileVersion = 1;
+
+        /** Sparse set of bricks holding snorm8 corner values, as used by SDFSBS.
+            Values are normalized like the snorm8 encoding, i.e., 1 represents half of a voxel diagonal.
+        */
+        struct SparseBricks
+        {
+            uint32_t gridWidth = 0;             ///< Grid width in voxels.
+            uint32_t brickWidth = 0;            ///< Brick width in voxels.
+            std::vector<uint3> brickCoords;     ///< Coordinates of each brick in units of bricks.
+            std::vector<int8_t> values;         ///< (brickWidth + 1)^3 corner values per brick, x varies fastest.
+
+            uint32_t getBrickCount() const { return (uint32_t)brickCoords.size(); }
+            uint32_t getBricksPerAxis() const { return brickWidth > 0 ? (gridWidth + brickWidth - 1) / brickWidth : 0; }
+            size_t getValuesPerBrick() const { return getValueCount(brickWidth); }
+        };
+
+        struct FileHeader
+        {
+            uint32_t magic = kFileMagic;
+            uint32_t version = kFileVersion;
+            uint32_t gridWidth = 0;
+            Encoding encoding = Encoding::Float32;
+            float snormScale = 0.f;     ///< Distance represented by a snorm8 value of 1.
+            uint32_t reserved = 0;
+        };
+
+        /** Returns the number of corner values of a grid with the given width in voxels.
+        */
+        static size_t getValueCount(uint32_t gridWidth)
+        {
+            size_t gridWidthInValues = size_t(gridWidth) + 1;
+            return gridWidthInValues * gridWidthInValues * gridWidthInValues;
+        }
+
+        /** Quantize a normalized distance to snorm8. The value is clamped to [-1, 1] and rounded half away from zero.
+        */
+        static int8_t quantizeSnorm8(float normalizedValue)
+        {
+            float integerScale = std::clamp(normalizedValue, -1.0f, 1.0f) * float(INT8_MAX);
+            return integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f);
+        }
+
+        /** Quantize distances to snorm8 in parallel, using SSE2 where available.
+            The result is bitwise identical to calling quantizeSnorm8(pValues[i] * normalizationMultiplier) for each value.
+            \param[in] pValues Distances to quantize.
+            \param[in] count Number of values.
+            \param[in] normalizationMultiplier Multiplier mapping distances to the normalized range.
+            \param[out] pOutput Quantized values, must hold count values.
+        */
+        static void quantizeSnorm8(const float* pValues, size_t count, float normalizationMultiplier, int8_t* pOutput);
+
+        /** Read corner values from a value file in either layout.
+            \param[in] path The path of a .sdfg file.
+            \param[out] values The decoded corner values.
+            \param[out] gridWidth The grid width in voxels.
+            \return true if the file could be read, otherwise false.
+        */
+        static bool readFile(const std::filesystem::path& path, std::vector<float>& values, uint32_t& gridWidth);
+
+        /** Write corner values to a value file.
+            \param[in] path The path of the .sdfg file to write.
+            \param[in] values The corner values, must hold (gridWidth + 1)^3 values.
+            \param[in] gridWidth The grid width in voxels.
+            \param[in] encoding The on-disk representation. Float32 is written in the legacy layout.
+            \return true if the file could be written, otherwise false.
+        */
+        static bool writeFile(const std::filesystem::path& path, const std::vector<float>& values, uint32_t gridWidth, Encoding encoding = Encoding::Float32);
+    };
+}
@@ -0,0 +1,333 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SDFMeshBuilder.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include "Utils/Math/MathConstants.slangh"
+#include "Utils/Threading.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace Falcor
+{
+    namespace
+    {
+        /// Relative slack added to distance bounds derived from neighboring corners, to be robust to rounding.
+        const float kBoundSlack = 1.001f;
+
+        /** Weld vertices with identical positions.
+            \return Index of the welded vertex for each input vertex.
+        */
+        std::vector<uint32_t> weldVertices(fstd::span<const float3> positions, std::vector<float3>& weldedPositions)
+        {
+            std::vector<uint32_t> order(positions.size());
+            std::iota(order.begin(), order.end(), 0);
+            auto less = [&](uint32_t a, uint32_t b)
+            {
+                const float3& pa = positions[a];
+                const float3& pb = positions[b];
+                if (pa.x != pb.x) return pa.x < pb.x;
+                if (pa.y != pb.y) return pa.y < pb.y;
+                return pa.z < pb.z;
+            };
+            std::sort(order.begin(), order.end(), less);
+
+            std::vector<uint32_t> remap(positions.size());
+            weldedPositions.clear();
+            for (size_t i = 0; i < order.size(); i++)
+            {
+                if (i == 0 || less(order[i - 1], order[i])) weldedPositions.push_back(positions[order[i]]);
+                remap[order[i]] = (uint32_t)weldedPositions.size() - 1;
+            }
+            return remap;
+        }
+
+        /// Angle between two vectors, robust for small angles.
+        float angleBetween(const float3& a, const float3& b)
+        {
+            return std::atan2(length(cross(a, b)), dot(a, b));
+        }
+
+        bool containsSurface(const int8_t* pValues, uint32_t strideY, uint32_t strideZ)
+        {
+            bool hasNonPositive = false;
+            bool hasNonNegative = false;
+            for (uint32_t i = 0; i < 8; i++)
+            {
+                int8_t value = pValues[(i & 1) + ((i >> 1) & 1) * strideY + (i >> 2) * strideZ];
+                hasNonPositive |= value <= 0;
+                hasNonNegative |= value >= 0;
+            }
+            return hasNonPositive && hasNonNegative;
+        }
+    }
+
+    SDFMeshBuilder::SDFMeshBuilder(fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+    {
+        FALCOR_CHECK(indices.size() % 3 == 0, "Index count ({}) must be a multiple of 3.", indices.size());
+        for (uint32_t index : indices) FALCOR_CHECK(index < positions.size(), "Vertex index {} is out of range.", index);
+
+        std::vector<float3> weldedPositions;
+        std::vector<uint32_t> remap = weldVertices(positions, weldedPositions);
+
+        const size_t triangleCount = indices.size() / 3;
+        mIndices.resize(indices.size());
+        for (size_t i = 0; i < indices.size(); i++) mIndices[i] = remap[indices[i]];
+
+        mFaceNormals.resize(triangleCount);
+        mEdgeNormals.resize(3 * triangleCount);
+        mVertexNormals.assign(weldedPositions.size(), float3(0.f));
+
+        // Accumulate angle-weighted vertex normals and sum the face normals adjacent to each edge.
+        std::unordered_map<uint64_t, float3> edgeNormals;
+        auto edgeKey = [](uint32_t a, uint32_t b) { return (uint64_t(std::min(a, b)) << 32) | std::max(a, b); };
+
+        for (size_t t = 0; t < triangleCount; t++)
+        {
+            const uint32_t* pIndices = &mIndices[3 * t];
+            float3 v[3] = { weldedPositions[pIndices[0]], weldedPositions[pIndices[1]], weldedPositions[pIndices[2]] };
+            float3 n = cross(v[1] - v[0], v[2] - v[0]);
+            float len = length(n);
+            n = len > 0.f ? n / len : float3(0.f);
+            mFaceNormals[t] = n;
+
+            for (uint32_t i = 0; i < 3; i++)
+            {
+                const float3& p = v[i];
+                mVertexNormals[pIndices[i]] += angleBetween(v[(i + 1) % 3] - p, v[(i + 2) % 3] - p) * n;
+                edgeNormals.try_emplace(edgeKey(pIndices[i], pIndices[(i + 1) % 3]), float3(0.f)).first->second += n;
+            }
+        }
+
+        for (size_t t = 0; t < triangleCount; t++)
+        {
+            const uint32_t* pIndices = &mIndices[3 * t];
+            for (uint32_t i = 0; i < 3; i++) mEdgeNormals[3 * t + i] = edgeNormals.at(edgeKey(pIndices[i], pIndices[(i + 1) % 3]));
+        }
+
+        mBVH.build(weldedPositions, mIndices);
+    }
+
+    float SDFMeshBuilder::evaluate(const float3& p) const
+    {
+        return evaluateBounded(p, std::numeric_limits<float>::infinity());
+    }
+
+    float SDFMeshBuilder::evaluateBounded(const float3& p, float maxDistance) const
+    {
+        if (mBVH.empty()) return std::numeric_limits<float>::infinity();
+
+        TriangleBVH::ClosestPoint closest = mBVH.findClosestPoint(p, maxDistance);
+        if (!closest.isValid()) closest = mBVH.findClosestPoint(p);
+
+        // Select the pseudonormal of the closest feature. The barycentrics are exact in the vertex and edge regions.
+        const uint32_t t = closest.triangleIndex;
+        const float2 b = closest.barycentrics;
+        float3 normal;
+        if (b.x == 0.f && b.y == 0.f) normal = mVertexNormals[mIndices[3 * t]];
+        else if (b.x == 1.f && b.y == 0.f) normal = mVertexNormals[mIndices[3 * t + 1]];
+        else if (b.x == 0.f && b.y == 1.f) normal = mVertexNormals[mIndices[3 * t + 2]];
+        else if (b.y == 0.f) normal = mEdgeNormals[3 * t];
+        else if (b.x == 1.f - b.y) normal = mEdgeNormals[3 * t + 1];
+        else if (b.x == 0.f) normal = mEdgeNormals[3 * t + 2];
+        else normal = mFaceNormals[t];
+
+        return dot(p - closest.point, normal) < 0.f ? -closest.distance : closest.distance;
+    }
+
+    SDFGridValues::SparseBricks SDFMeshBuilder::buildBricks(uint32_t gridWidth, uint32_t brickWidth) const
+    {
+        FALCOR_CHECK(gridWidth > 0, "'gridWidth' must be non-zero.");
+        FALCOR_CHECK(brickWidth > 0, "'brickWidth' must be non-zero.");
+
+        SDFGridValues::SparseBricks bricks;
+        bricks.gridWidth = gridWidth;
+        bricks.brickWidth = brickWidth;
+        if (mBVH.empty()) return bricks;
+
+        const uint32_t bricksPerAxis = bricks.getBricksPerAxis();
+        const float voxelSize = 1.0f / gridWidth;
+
+        // Find candidate bricks by subdividing cubes of bricks top-down. A cube is kept if the mesh is closer to its center
+        // than half of its diagonal, plus one voxel diagonal to also keep bricks that only touch the surface at their boundary.
+        std::vector<uint3> nodes = { uint3(0) };
+        uint32_t nodeWidth = 1;
+        while (nodeWidth < bricksPerAxis) nodeWidth *= 2;
+
+        while (true)
+        {
+            const float nodeSize = float(nodeWidth * brickWidth) * voxelSize;
+            const float radius = 0.5f * float(M_SQRT3) * nodeSize + float(M_SQRT3) * voxelSize;
+
+            std::vector<uint8_t> keep(nodes.size());
+            Threading::parallelFor(0, nodes.size(), [&](size_t i)
+            {
+                float3 center = -0.5f + (float3(nodes[i]) + 0.5f) * nodeSize;
+                keep[i] = mBVH.findClosestPoint(center, radius).isValid() ? 1 : 0;
+            });
+
+            size_t keptCount = 0;
+            for (size_t i = 0; i < nodes.size(); i++)
+            {
+                if (keep[i]) nodes[keptCount++] = nodes[i];
+            }
+            nodes.resize(keptCount);
+
+            if (nodeWidth == 1) break;
+
+            std::vector<uint3> children;
+            children.reserve(nodes.size() * 8);
+            for (const uint3& node : nodes)
+            {
+                for (uint32_t c = 0; c < 8; c++)
+                {
+                    uint3 child = 2u * node + uint3(c & 1, (c >> 1) & 1, c >> 2);
+                    if (all(child * (nodeWidth / 2) < uint3(bricksPerAxis))) children.push_back(child);
+                }
+            }
+            nodes = std::move(children);
+            nodeWidth /= 2;
+        }
+
+        // Evaluate the corner values of the candidate bricks in parallel.
+        const uint32_t brickWidthInValues = brickWidth + 1;
+        const size_t valuesPerBrick = bricks.getValuesPerBrick();
+        const float normalizationMultiplier = 2.0f * gridWidth / float(M_SQRT3);
+
+        std::vector<int8_t> values(nodes.size() * valuesPerBrick);
+        std::vector<uint8_t> valid(nodes.size());
+        Threading::parallelFor(0, nodes.size(), [&](size_t i)
+        {
+            const uint3 brickOrigin = nodes[i] * brickWidth;
+            int8_t* pBrickValues = values.data() + i * valuesPerBrick;
+
+            for (uint32_t z = 0; z < brickWidthInValues; z++)
+            {
+                for (uint32_t y = 0; y < brickWidthInValues; y++)
+                {
+                    // The distance changes by at most one voxel between neighbors, which bounds the closest point search.
+                    float maxDistance = std::numeric_limits<float>::infinity();
+                    for (uint32_t x = 0; x < brickWidthInValues; x++)
+                    {
+                        float3 p = -0.5f + float3(brickOrigin + uint3(x, y, z)) * voxelSize;
+                        float d = evaluateBounded(p, maxDistance);
+                        maxDistance = (std::abs(d) + voxelSize) * kBoundSlack;
+                        pBrickValues[x + brickWidthInValues * (y + brickWidthInValues * z)] = SDFGridValues::quantizeSnorm8(d * normalizationMultiplier);
+                    }
+                }
+            }
+
+            // Only voxels inside of the grid are considered, matching the validity test of SDFSBS.
+            const uint3 voxelEnd = min(uint3(brickWidth), uint3(gridWidth) - brickOrigin);
+            bool brickValid = false;
+            for (uint32_t z = 0; z < voxelEnd.z && !brickValid; z++)
+            {
+                for (uint32_t y = 0; y < voxelEnd.y && !brickValid; y++)
+                {
+                    for (uint32_t x = 0; x < voxelEnd.x && !brickValid; x++)
+                    {
+                        brickValid = containsSurface(pBrickValues + x + brickWidthInValues * (y + brickWidthInValues * z), brickWidthInValues, brickWidthInValues * brickWidthInValues);
+                    }
+                }
+            }
+            valid[i] = brickValid ? 1 : 0;
+        });
+
+        // Compact the valid bricks.
+        size_t brickCount = 0;
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            if (!valid[i]) continue;
+            if (brickCount != i)
+            {
+                nodes[brickCount] = nodes[i];
+                std::copy_n(values.begin() + i * valuesPerBrick, valuesPerBrick, values.begin() + brickCount * valuesPerBrick);
+            }
+            brickCount++;
+        }
+        nodes.resize(brickCount);
+        values.resize(brickCount * valuesPerBrick);
+        values.shrink_to_fit();
+
+        bricks.brickCoords = std::move(nodes);
+        bricks.values = std::move(values);
+        return bricks;
+    }
+
+    std::vector<float> SDFMeshBuilder::buildValues(uint32_t gridWidth) const
+    {
+        FALCOR_CHECK(gridWidth > 0, "'gridWidth' must be non-zero.");
+
+        const uint32_t gridWidthInValues = gridWidth + 1;
+        const float voxelSize = 1.0f / gridWidth;
+        std::vector<float> values(SDFGridValues::getValueCount(gridWidth));
+
+        Threading::parallelFor(0, (size_t)gridWidthInValues * gridWidthInValues, [&](size_t row)
+        {
+            const uint32_t y = uint32_t(row % gridWidthInValues);
+            const uint32_t z = uint32_t(row / gridWidthInValues);
+            float* pRow = values.data() + row * gridWidthInValues;
+
+            float maxDistance = std::numeric_limits<float>::infinity();
+            for (uint32_t x = 0; x < gridWidthInValues; x++)
+            {
+                float d = evaluateBounded(-0.5f + float3(x, y, z) * voxelSize, maxDistance);
+                maxDistance = (std::abs(d) + voxelSize) * kBoundSlack;
+                // We don't care about distance further away than the length of the diagonal of the unit cube where the SDF grid is defined.
+                pRow[x] = std::clamp(d, -float(M_SQRT3), float(M_SQRT3));
+            }
+        });
+
+        return values;
+    }
+
+    std::vector<float3> SDFMeshBuilder::fitToGrid(fstd::span<const float3> positions, float margin)
+    {
+        FALCOR_CHECK(margin >= 0.f && margin < 0.5f, "'margin' ({}) must be in [0, 0.5).", margin);
+
+        float3 minPoint(std::numeric_limits<float>::infinity());
+        float3 maxPoint(-std::numeric_limits<float>::infinity());
+        for (const float3& p : positions)
+        {
+            minPoint = min(minPoint, p);
+            maxPoint = max(maxPoint, p);
+        }
+
+        std::vector<float3> result(positions.begin(), positions.end());
+        if (positions.empty()) return result;
+
+        const float3 center = 0.5f * (minPoint + maxPoint);
+        const float extent = std::max(std::max(maxPoint.x - minPoint.x, maxPoint.y - minPoint.y), maxPoint.z - minPoint.z);
+        const float scale = extent > 0.f ? (1.f - 2.f * margin) / extent : 1.f;
+        for (float3& p : result) p = (p - center) * scale;
+        return result;
+    }
+}
@@ -0,0 +1,101 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Scene/SDFs/SDFGridValues.h"
+#include "Utils/Geometry/TriangleBVH.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h>
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Builds signed distance fields from triangle meshes on the CPU.
+
+        Distances are computed with closest point queries against a BVH over the triangles. The sign is taken from the
+        angle-weighted pseudonormal of the closest feature (face, edge or vertex), see Baerentzen and Aanaes,
+        "Signed Distance Computation Using the Angle Weighted Pseudonormal", 2005. This requires a closed mesh
+        with consistent counter-clockwise winding when seen from the outside. Vertices with identical positions are
+        welded before the pseudonormals are computed, so meshes split along attribute seams are handled.
+
+        Positions are expected in the local space of the SDF grid, i.e., [-0.5, 0.5]^3, see fitToGrid().
+
+        buildBricks() only evaluates bricks in a narrow band around the surface. Candidate bricks are found by
+        subdividing the grid top-down and discarding regions that are further away from the mesh than their extent,
+        so memory and time scale with the surface area rather than the volume of the grid.
+    */
+    class FALCOR_API SDFMeshBuilder
+    {
+    public:
+        /** Create a builder for a triangle mesh.
+            \param[in] positions Vertex positions in the local space of the SDF grid.
+            \param[in] indices Vertex indices, three per triangle.
+        */
+        SDFMeshBuilder(fstd::span<const float3> positions, fstd::span<const uint32_t> indices);
+
+        /** Evaluate the signed distance at a point, positive outside of the mesh.
+            \param[in] p Point in the local space of the SDF grid.
+            \return Signed distance, +inf if the mesh is empty.
+        */
+        float evaluate(const float3& p) const;
+
+        /** Build the sparse set of bricks that contain the surface, in parallel over bricks.
+            Bricks are selected with the same criterion as SDFSBS uses for dense values, i.e., a brick is kept if any of its voxels
+            has corner values of both signs after quantization.
+            \param[in] gridWidth The grid width in voxels.
+            \param[in] brickWidth The brick width in voxels, must match the SDFSBS the bricks are used with.
+            \return The bricks, to be passed to SDFSBS::setBricks().
+        */
+        SDFGridValues::SparseBricks buildBricks(uint32_t gridWidth, uint32_t brickWidth) const;
+
+        /** Evaluate the signed distance at all corners of a dense grid, in parallel over rows.
+            The result can be passed to SDFGrid::setValues() for any grid type, but requires (gridWidth + 1)^3 values.
+            \param[in] gridWidth The grid width in voxels.
+            \return The corner values, clamped to [-sqrt(3), sqrt(3)].
+        */
+        std::vector<float> buildValues(uint32_t gridWidth) const;
+
+        /** Transform positions uniformly so that their bounds are centered in the SDF grid.
+            \param[in] positions Positions in any space.
+            \param[in] margin Distance from the bounds to the faces of the grid, in the local space of the grid.
+            \return Positions in the local space of the SDF grid.
+        */
+        static std::vector<float3> fitToGrid(fstd::span<const float3> positions, float margin = 0.05f);
+
+    private:
+        /// Signed distance, where maxDistance is a bound on the unsigned distance (the query is repeated without it if it is too tight).
+        float evaluateBounded(const float3& p, float maxDistance) const;
+
+        TriangleBVH mBVH;
+        std::vector<uint32_t> mIndices;         ///< Welded vertex indices, three per triangle.
+        std::vector<float3> mFaceNormals;       ///< Normalized face normal per triangle.
+        std::vector<float3> mEdgeNormals;       ///< Pseudonormal per triangle edge (v0v1, v1v2, v2v0).
+        std::vector<float3> mVertexNormals;     ///< Pseudonormal per welded vertex.
+    };
+}
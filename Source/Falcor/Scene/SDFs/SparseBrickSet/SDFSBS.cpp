@@ -29,9 +29,12 @@
 #include "Core/API/Device.h"
 #include "Core/API/RenderContext.h"
 #include "Core/API/IndirectCommands.h"
+#include "Utils/Math/AABB.h"
 #include "Utils/Math/MathHelpers.h"
 #include "Utils/Math/MathConstants.slangh"
 #include "Utils/SharedCache.h"
+#include "Utils/Threading.h"
+#include "Scene/SDFs/SDFGridValues.h"
 #include "Scene/SDFs/SDFVoxelTypes.slang"
 
 namespace Falcor
@@ -56,6 +59,96 @@ namespace Falcor
 
         // Chunk width must be equal to 4 for now.
         const uint32_t kChunkWidth = 4;
+
+        const uint32_t kCompressionWidth = 4;
+
+        // CPU version of compressBlock() in BC4Encode.slang, the two must produce identical blocks.
+        void fixBC4Range(int& minValue, int& maxValue, int steps)
+        {
+            if (maxValue - minValue < steps)
+            {
+                maxValue = std::min(minValue + steps, 127);
+                minValue = maxValue - minValue < steps ? std::max(-128, maxValue - steps) : minValue;
+            }
+        }
+
+        int fitBC4Codes(const int block[16], const int codes[8], uint32_t indices[16])
+        {
+            int err = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                int least = std::numeric_limits<int>::max();
+                uint32_t index = 0;
+                for (uint32_t j = 0; j < 8; ++j)
+                {
+                    int dist = block[i] - codes[j];
+                    dist *= dist;
+                    if (dist < least)
+                    {
+                        least = dist;
+                        index = j;
+                    }
+                }
+                indices[i] = index;
+                err += least;
+            }
+            return err;
+        }
+
+        uint64_t writeBC4Block(int alpha0, int alpha1, const uint32_t indices[16])
+        {
+            uint64_t compressedBlock = uint64_t(alpha0 & 0xff) | (uint64_t(alpha1 & 0xff) << 8);
+            for (int i = 0; i < 16; ++i)
+                compressedBlock |= uint64_t(indices[i] & 0x7) << (3 * i + 16);
+            return compressedBlock;
+        }
+
+        /** Compresses a 4x4 block of 8-bit snorm values, stored row by row.
+        */
+        uint64_t compressBC4Block(const int block[16])
+        {
+            int min5 = 127;
+            int max5 = -128;
+            int min7 = 127;
+            int max7 = -128;
+            for (int i = 0; i < 16; ++i)
+            {
+                min7 = std::min(min7, block[i]);
+                max7 = std::max(max7, block[i]);
+                if (block[i] != -128 && block[i] < min5) min5 = block[i];
+                if (block[i] != 127 && block[i] > max5) max5 = block[i];
+            }
+            min5 = std::min(min5, max5);
+            min7 = std::min(min7, max7);
+
+            fixBC4Range(min5, max5, 5);
+            fixBC4Range(min7, max7, 7);
+
+            int codes5[8] = { min5, max5, 0, 0, 0, 0, -128, 127 };
+            for (int i = 1; i < 5; ++i) codes5[1 + i] = ((5 - i) * min5 + i * max5) / 5;
+            int codes7[8] = { min7, max7 };
+            for (int i = 1; i < 7; ++i) codes7[1 + i] = ((7 - i) * min7 + i * max7) / 7;
+
+            uint32_t indices5[16];
+            uint32_t indices7[16];
+            int err5 = fitBC4Codes(block, codes5, indices5);
+            int err7 = fitBC4Codes(block, codes7, indices7);
+
+            // Endpoints are ordered to select the 5-value (alpha0 <= alpha1) or 7-value (alpha0 > alpha1) interpolation mode.
+            uint32_t swapped[16];
+            if (err5 <= err7)
+            {
+                if (min5 <= max5) return writeBC4Block(min5, max5, indices5);
+                for (int i = 0; i < 16; ++i) swapped[i] = indices5[i] == 0 ? 1 : indices5[i] == 1 ? 0 : indices5[i] <= 5 ? 7 - indices5[i] : indices5[i];
+                return writeBC4Block(max5, min5, swapped);
+            }
+            else
+            {
+                if (min7 >= max7) return writeBC4Block(min7, max7, indices7);
+                for (int i = 0; i < 16; ++i) swapped[i] = indices7[i] == 0 ? 1 : indices7[i] == 1 ? 0 : 9 - indices7[i];
+                return writeBC4Block(max7, min7, swapped);
+            }
+        }
     }
 
     struct SDFSBS::SharedData
@@ -99,6 +192,15 @@ namespace Falcor
 
     SDFGrid::UpdateFlags SDFSBS::update(RenderContext* pRenderContext)
     {
+        // Bricks set with setBricks() are not combined with primitives, they only need to be uploaded once.
+        if (mBuiltFromBricks)
+        {
+            if (mSparseBricks.brickCoords.empty()) return UpdateFlags::None;
+
+            createResourcesFromBricks();
+            return UpdateFlags::All;
+        }
+
         // No update is performed if the SDF grid isn't dirty or isn't constructed from primitives and should not be created as an empty grid.
         bool isEmpty = mPrimitives.empty() && !mpSDFGridTexture && !mWasEmpty;
         if ((!mPrimitivesDirty || (mPrimitives.empty() && !mHasGridRepresentation)) && !isEmpty) return UpdateFlags::None;
@@ -123,7 +225,12 @@ namespace Falcor
             mSDField.clear();
         }
 
-        if (!mPrimitives.empty())
+        if (mBuiltFromBricks)
+        {
+            FALCOR_CHECK(mPrimitives.empty(), "SDFSBS built from bricks can't be combined with primitives");
+            if (!mSparseBricks.brickCoords.empty()) createResourcesFromBricks();
+        }
+        else if (!mPrimitives.empty())
         {
             createResourcesFromPrimitivesAndSDField(pRenderContext, deleteScratchData);
         }
@@ -167,6 +274,140 @@ namespace Falcor
         var["normalizationFactor"] = 0.5f * float(M_SQRT3) / mGridWidth;
     }
 
+    void SDFSBS::setBricks(SDFGridValues::SparseBricks bricks)
+    {
+        FALCOR_CHECK(bricks.brickWidth == mBrickWidth, "Brick width ({}) does not match the brick width of the SBS ({})", bricks.brickWidth, mBrickWidth);
+        FALCOR_CHECK(bricks.gridWidth > 0, "'gridWidth' must be larger than 0");
+        FALCOR_CHECK(bricks.values.size() == (size_t)bricks.getBrickCount() * bricks.getValuesPerBrick(), "Expected {} brick values, got {}", (size_t)bricks.getBrickCount() * bricks.getValuesPerBrick(), bricks.values.size());
+        FALCOR_CHECK(mPrimitives.empty(), "SDFSBS::setBricks() can't be used on an SBS with primitives");
+
+        mGridWidth = bricks.gridWidth;
+        mSDField.clear();
+        mpSDFGridTexture.reset();
+        mHasGridRepresentation = false;
+        mInitializedWithPrimitives = false;
+
+        // Without bricks the SBS is treated as empty and a single brick without surface is created.
+        mBuiltFromBricks = bricks.getBrickCount() > 0;
+        if (!mBuiltFromBricks) logWarning("SDFSBS::setBricks() called without any bricks, the SBS will be empty.");
+        mWasEmpty = false;
+
+        mSparseBricks = std::move(bricks);
+    }
+
+    void SDFSBS::createResourcesFromBricks()
+    {
+        const uint32_t brickCount = mSparseBricks.getBrickCount();
+        const uint32_t brickWidthInValues = mBrickWidth + 1;
+        const uint32_t valuesPerBrick = mSparseBricks.getValuesPerBrick();
+        FALCOR_ASSERT(brickCount > 0 && mGridWidth == mSparseBricks.gridWidth);
+
+        mVirtualBricksPerAxis = mSparseBricks.getBricksPerAxis();
+        mBrickCount = brickCount;
+
+        // Create the indirection texture, bricks are stored in the order they were given.
+        {
+            std::vector<uint32_t> indirection((size_t)mVirtualBricksPerAxis * mVirtualBricksPerAxis * mVirtualBricksPerAxis, std::numeric_limits<uint32_t>::max());
+            for (uint32_t brickID = 0; brickID < brickCount; brickID++)
+            {
+                const uint3& coords = mSparseBricks.brickCoords[brickID];
+                FALCOR_CHECK(all(coords < uint3(mVirtualBricksPerAxis)), "Brick coords ({}, {}, {}) are outside of the grid", coords.x, coords.y, coords.z);
+                indirection[coords.x + (size_t)mVirtualBricksPerAxis * (coords.y + (size_t)mVirtualBricksPerAxis * coords.z)] = brickID;
+            }
+
+            mpIndirectionTexture = mpDevice->createTexture3D(mVirtualBricksPerAxis, mVirtualBricksPerAxis, mVirtualBricksPerAxis, ResourceFormat::R32Uint, 1, indirection.data(), ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
+            mpIndirectionTexture->setName("SDFSBS::IndirectionTextureValues");
+        }
+
+        // Create brick AABBs, see SDFSBSCreateBricksFromSDField.cs.slang.
+        {
+            std::vector<AABB> brickAABBs(brickCount);
+            const float oneOverGridWidth = 1.0f / float(mGridWidth);
+            for (uint32_t brickID = 0; brickID < brickCount; brickID++)
+            {
+                float3 brickAABBMin = -0.5f + float3(mSparseBricks.brickCoords[brickID] * mBrickWidth) * oneOverGridWidth;
+                float3 brickAABBMax = min(brickAABBMin + float(mBrickWidth) * oneOverGridWidth, float3(0.5f));
+                brickAABBs[brickID] = AABB(brickAABBMin, brickAABBMax);
+            }
+
+            mpBrickAABBsBuffer = mpDevice->createStructuredBuffer(sizeof(AABB), brickCount, ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, brickAABBs.data(), false);
+        }
+
+        // Create the brick texture with the same layout as createResourcesFromSDField().
+        {
+            uint32_t bricksAlongX = (uint32_t)std::ceil(std::sqrt((float)brickCount / brickWidthInValues));
+            uint32_t bricksAlongY = (uint32_t)std::ceil((float)brickCount / bricksAlongX);
+            mBricksPerAxis = uint2(bricksAlongX, bricksAlongY);
+
+            uint32_t textureWidth = brickWidthInValues * brickWidthInValues * bricksAlongX;
+            uint32_t textureHeight = brickWidthInValues * bricksAlongY;
+
+            // Values on the far faces of the grid are replaced by the maximum distance like on the GPU.
+            auto getValue = [&](uint32_t brickID, uint32_t x, uint32_t y, uint32_t z) -> int8_t
+            {
+                uint3 voxelGridCoords = mSparseBricks.brickCoords[brickID] * mBrickWidth + uint3(x, y, z);
+                if (any(voxelGridCoords >= uint3(mGridWidth))) return 127;
+                return mSparseBricks.values[(size_t)brickID * valuesPerBrick + x + brickWidthInValues * (y + brickWidthInValues * z)];
+            };
+
+            if (mCompressed)
+            {
+                const uint32_t blocksPerRow = textureWidth / kCompressionWidth;
+                std::vector<uint64_t> blocks((size_t)blocksPerRow * (textureHeight / kCompressionWidth), 0);
+
+                Threading::parallelFor(0, brickCount, [&](size_t i)
+                {
+                    const uint32_t brickID = (uint32_t)i;
+                    uint2 brickTextureCoords = uint2(brickID % bricksAlongX, brickID / bricksAlongX) * uint2(brickWidthInValues * brickWidthInValues, brickWidthInValues);
+                    int block[16];
+                    for (uint32_t z = 0; z < brickWidthInValues; ++z)
+                    {
+                        for (uint32_t y = 0; y < brickWidthInValues; y += kCompressionWidth)
+                        {
+                            for (uint32_t x = 0; x < brickWidthInValues; x += kCompressionWidth)
+                            {
+                                for (uint32_t bY = 0; bY < kCompressionWidth; ++bY)
+                                    for (uint32_t bX = 0; bX < kCompressionWidth; ++bX)
+                                        block[bY * kCompressionWidth + bX] = getValue(brickID, x + bX, y + bY, z);
+
+                                uint2 blockTextureCoords = (brickTextureCoords + uint2(x + z * brickWidthInValues, y)) / kCompressionWidth;
+                                blocks[blockTextureCoords.x + (size_t)blocksPerRow * blockTextureCoords.y] = compressBC4Block(block);
+                            }
+                        }
+                    }
+                });
+
+                mpBrickTexture = mpDevice->createTexture2D(textureWidth, textureHeight, ResourceFormat::BC4Snorm, 1, 1, blocks.data());
+                mBrickTextureDimensions = uint2(mpBrickTexture->getWidth(), mpBrickTexture->getHeight());
+            }
+            else
+            {
+                std::vector<int8_t> texels((size_t)textureWidth * textureHeight, 127);
+
+                Threading::parallelFor(0, brickCount, [&](size_t i)
+                {
+                    const uint32_t brickID = (uint32_t)i;
+                    uint2 brickTextureCoords = uint2(brickID % bricksAlongX, brickID / bricksAlongX) * uint2(brickWidthInValues * brickWidthInValues, brickWidthInValues);
+                    for (uint32_t z = 0; z < brickWidthInValues; ++z)
+                    {
+                        for (uint32_t y = 0; y < brickWidthInValues; ++y)
+                        {
+                            int8_t* pRow = texels.data() + (size_t)(brickTextureCoords.y + y) * textureWidth + brickTextureCoords.x + z * brickWidthInValues;
+                            for (uint32_t x = 0; x < brickWidthInValues; ++x) pRow[x] = getValue(brickID, x, y, z);
+                        }
+                    }
+                });
+
+                mpBrickTexture = mpDevice->createTexture2D(textureWidth, textureHeight, ResourceFormat::R8Snorm, 1, 1, texels.data(), ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource);
+                mBrickTextureDimensions = uint2(textureWidth, textureHeight);
+            }
+        }
+
+        // The CPU copy of the bricks is no longer needed.
+        mSparseBricks = {};
+        mWasEmpty = false;
+    }
+
     void SDFSBS::createResourcesFromSDField(RenderContext* pRenderContext, bool deleteScratchData)
     {
         FALCOR_ASSERT(mpSDFGridTexture && mpSDFGridTexture->getWidth() == mGridWidth + 1);
@@ -974,18 +1215,16 @@ namespace Falcor
 
     void SDFSBS::setValuesInternal(const std::vector<float>& cornerValues)
     {
+        mBuiltFromBricks = false;
+        mSparseBricks = {};
+
         uint32_t gridWidthInValues = mGridWidth + 1;
         uint32_t valueCount = gridWidthInValues * gridWidthInValues * gridWidthInValues;
         mSDField.resize(valueCount);
 
         // The grid is in the size [-1, 1] thus the longest distance that can be stored is sqrt(3) (the length from corner to corner)
         float normalizationFactor = 2.0f * mGridWidth / float(M_SQRT3);
-        for (uint32_t v = 0; v < valueCount; v++)
-        {
-            float normalizedValue = std::clamp(cornerValues[v] * normalizationFactor, -1.0f, 1.0f);
-            float integerScale = normalizedValue * float(INT8_MAX);
-            mSDField[v] = integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f);
-        }
+        SDFGridValues::quantizeSnorm8(cornerValues.data(), valueCount, normalizationFactor, mSDField.data());
     }
 
     void SDFSBS::createSDFGridTexture(RenderContext* pRenderContext, const std::vector<int8_t>& sdField)
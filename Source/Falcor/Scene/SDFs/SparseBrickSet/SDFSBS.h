@@ -51,6 +51,12 @@ namespace Falcor
 
         virtual UpdateFlags update(RenderContext* pRenderContext) override;
 
+        /** Set the bricks of the SBS directly, e.g., from SDFMeshBuilder::buildBricks(), without going through a dense value grid.
+            The GPU resources are created from the bricks on the next call to createResources().
+            \param[in] bricks The sparse bricks, the brick width must match the brick width of the SBS.
+        */
+        void setBricks(SDFGridValues::SparseBricks bricks);
+
         uint32_t getVirtualBrickCoordsBitCount() const { return mVirtualBrickCoordsBitCount; }
         uint32_t getBrickLocalVoxelCoordsBrickCount() const { return mBrickLocalVoxelCoordsBitCount; }
         bool isCompressed() const { return mCompressed; }
@@ -71,6 +77,7 @@ namespace Falcor
 
     protected:
         void createResourcesFromSDField(RenderContext* pRenderContext, bool deleteScratchData);
+        void createResourcesFromBricks();
         SDFGrid::UpdateFlags createResourcesFromPrimitivesAndSDField(RenderContext* pRenderContext, bool deleteScratchData);
 
         void expandSDFGridTexture(RenderContext* pRenderContext, bool deleteScratchData, uint32_t oldGridWidthInSDField, uint32_t gridWidthInSDField);
@@ -89,6 +96,7 @@ namespace Falcor
     private:
         // CPU data.
         std::vector<int8_t> mSDField;
+        SDFGridValues::SparseBricks mSparseBricks;      ///< Bricks set by setBricks(), released once the GPU resources are created.
 
         // Specs.
         uint32_t mDefaultGridWidth = 0;                 ///< The grid width used if the grid was not loaded from a file (it is empty).
@@ -106,6 +114,7 @@ namespace Falcor
         uint32_t mCurrentBakedPrimitiveCount = 0;
         bool mWasEmpty = false;
         bool mBuildEmptyGrid = false;
+        bool mBuiltFromBricks = false;
 
         // GPU data.
         ref<Buffer> mpBrickAABBsBuffer;                 ///< A compact buffer containing AABBs for each brick.
@@ -31,6 +31,7 @@
 #include "Utils/Math/MathHelpers.h"
 #include "Utils/Math/MathConstants.slangh"
 #include "Utils/SharedCache.h"
+#include "Scene/SDFs/SDFGridValues.h"
 #include "Scene/SDFs/SDFVoxelTypes.slang"
 
 namespace Falcor
@@ -414,12 +415,6 @@ namespace Falcor
         mValues.resize(valueCount);
 
         float normalizationMultipler = mGridWidth / (0.5f * float(M_SQRT3));
-        for (uint32_t v = 0; v < valueCount; v++)
-        {
-            float normalizedValue = std::clamp(cornerValues[v] * normalizationMultipler, -1.0f, 1.0f);
-
-            float integerScale = normalizedValue * float(INT8_MAX);
-            mValues[v] = integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f);
-        }
+        SDFGridValues::quantizeSnorm8(cornerValues.data(), valueCount, normalizationMultipler, mValues.data());
     }
 }
@@ -49,13 +49,12 @@
 #include "Utils/Timing/Profiler.h"
 #include "Utils/UI/InputTypes.h"
 #include "Utils/Scripting/ScriptWriter.h"
-#include "Utils/NumericRange.h"
+#include "Utils/Threading.h"
 
 #include <fstream>
 #include <numeric>
 #include <sstream>
 #include <algorithm>
-#include <execution>
 
 namespace Falcor
 {
@@ -145,6 +144,92 @@ namespace Falcor
         {
             return determinant(float3x3(m)) < 0.f;
         }
+
+        // Number of triangles per work item when computing UV tiles.
+        const uint32_t kUVTileChunkSize = 1u << 16;
+
+        /** Accumulates UV bounds per unit square tile in a flat open addressing hash table.
+            Consecutive triangles usually lie in the same tile, so the last accessed tile is checked first.
+        */
+        class UVTileAccumulator
+        {
+        public:
+            Rectangle largeTriangleTile; ///< Captures any triangles that span more than one unit square, e.g., for tiled textures.
+
+            Rectangle& getTile(const int2& key)
+            {
+                if (mLastIndex != kEmpty && all(mKeys[mLastIndex] == key)) return mTiles[mLastIndex];
+
+                if ((mKeys.size() + 1) * 2 > mTable.size()) rehash(std::max<size_t>(16, mTable.size() * 2));
+
+                const size_t mask = mTable.size() - 1;
+                for (size_t slot = hash(key) & mask;; slot = (slot + 1) & mask)
+                {
+                    uint32_t index = mTable[slot];
+                    if (index == kEmpty)
+                    {
+                        index = (uint32_t)mKeys.size();
+                        mTable[slot] = index;
+                        mKeys.push_back(key);
+                        mTiles.emplace_back();
+                    }
+                    if (all(mKeys[index] == key))
+                    {
+                        mLastIndex = index;
+                        return mTiles[index];
+                    }
+                }
+            }
+
+            void merge(const UVTileAccumulator& other)
+            {
+                for (size_t i = 0; i < other.mKeys.size(); ++i) getTile(other.mKeys[i]).include(other.mTiles[i]);
+                largeTriangleTile.include(other.largeTriangleTile);
+            }
+
+            /// Returns the tiles ordered by tile coordinates followed by the large triangle tile. Tiles inside the large triangle tile are skipped.
+            std::vector<Rectangle> getTiles() const
+            {
+                std::vector<uint32_t> order(mKeys.size());
+                std::iota(order.begin(), order.end(), 0);
+                std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return std::less<int2>()(mKeys[a], mKeys[b]); });
+
+                Rectangle largeTile = largeTriangleTile;
+                std::vector<Rectangle> result;
+                for (uint32_t index : order)
+                {
+                    if (largeTile.contains(mTiles[index])) continue;
+                    result.push_back(mTiles[index]);
+                }
+                if (largeTriangleTile.valid()) result.push_back(largeTriangleTile);
+                return result;
+            }
+
+        private:
+            static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+
+            static size_t hash(const int2& key)
+            {
+                return (uint32_t(key.x) * 0x9e3779b1u) ^ (uint32_t(key.y) * 0x85ebca77u);
+            }
+
+            void rehash(size_t tableSize)
+            {
+                mTable.assign(tableSize, kEmpty);
+                const size_t mask = tableSize - 1;
+                for (uint32_t index = 0; index < (uint32_t)mKeys.size(); ++index)
+                {
+                    size_t slot = hash(mKeys[index]) & mask;
+                    while (mTable[slot] != kEmpty) slot = (slot + 1) & mask;
+                    mTable[slot] = index;
+                }
+            }
+
+            std::vector<int2> mKeys;
+            std::vector<Rectangle> mTiles;
+            std::vector<uint32_t> mTable;
+            uint32_t mLastIndex = kEmpty;
+        };
     }
 
     const FileDialogFilterVec& Scene::getFileExtensionFilters()
@@ -236,7 +321,11 @@ namespace Falcor
         // Create vertex array objects for meshes and curves.
         createMeshVao(sceneData.meshDrawCount, sceneData.meshSkinningData);
         createCurveVao(mCurveIndexData, mCurveStaticData);
-        createMeshUVTiles(mMeshDesc);
+        // UV tiles are computed by SceneBuilder and stored in the scene cache, compute them here only if they are missing.
+        if (sceneData.meshUVTiles.size() == mMeshDesc.size())
+            mMeshUVTiles = std::move(sceneData.meshUVTiles);
+        else
+            mMeshUVTiles = computeMeshUVTiles(mMeshDesc, mMeshIndexData, mMeshStaticData);
 
         // Create animation controller.
         mpAnimationController = std::make_unique<AnimationController>(mpDevice, this, sceneData.meshSkinningData, sceneData.prevVertexCount, sceneData.animations);
@@ -549,91 +638,95 @@ namespace Falcor
         mpCurveVao = Vao::create(Vao::Topology::LineStrip, pLayout, pVBs, pIB, ResourceFormat::R32Uint);
     }
 
-    void Scene::createMeshUVTiles(const std::vector<MeshDesc>& meshDescs)
+    std::vector<std::vector<Rectangle>> Scene::computeMeshUVTiles(const std::vector<MeshDesc>& meshDescs, const SplitIndexBuffer& meshIndexData, const SplitVertexBuffer& meshStaticData)
     {
-        mMeshUVTiles.resize(meshDescs.size());
+        // Split the meshes into chunks of triangles, the chunks of a mesh are consecutive.
+        struct Chunk
+        {
+            uint32_t meshIndex;
+            uint32_t triangleBegin;
+            uint32_t triangleEnd;
+        };
+        std::vector<Chunk> chunks;
+        std::vector<size_t> meshChunkOffsets(meshDescs.size() + 1, 0);
+        for (uint32_t meshIndex = 0; meshIndex < (uint32_t)meshDescs.size(); ++meshIndex)
+        {
+            meshChunkOffsets[meshIndex] = chunks.size();
+            const uint32_t triangleCount = meshDescs[meshIndex].getTriangleCount();
+            for (uint32_t begin = 0; begin < triangleCount; begin += kUVTileChunkSize)
+                chunks.push_back({meshIndex, begin, std::min(begin + kUVTileChunkSize, triangleCount)});
+        }
+        meshChunkOffsets.back() = chunks.size();
 
-        auto processMeshTile = [&](size_t meshIndex)
+        // Accumulate the tiles of each chunk.
+        std::vector<UVTileAccumulator> partials(chunks.size());
+        Threading::parallelFor(0, chunks.size(), [&](size_t chunkIndex)
         {
-            const MeshDesc& desc = meshDescs[meshIndex];
-            // This tile captures any triangles that span more than one unit square, e.g., for tiled textures
-            Rectangle largeTriangleTile;
-            std::map<int2, Rectangle> tiles;
+            const Chunk& chunk = chunks[chunkIndex];
+            const MeshDesc& desc = meshDescs[chunk.meshIndex];
+            UVTileAccumulator& accumulator = partials[chunkIndex];
 
             const uint8_t* meshIndexData8 = nullptr;
             if (desc.useVertexIndices())
-                meshIndexData8 = reinterpret_cast<const uint8_t*>(&mMeshIndexData[desc.ibOffset]);
+                meshIndexData8 = reinterpret_cast<const uint8_t*>(&meshIndexData[desc.ibOffset]);
 
-            const uint tcount = desc.getTriangleCount();
-            for (uint tidx = 0; tidx < tcount; ++tidx)
+            for (uint32_t tidx = chunk.triangleBegin; tidx < chunk.triangleEnd; ++tidx)
             {
                 // Compute local vertex indices within the mesh.
-                uint32_t vidx[3] = {};
-                if (desc.useVertexIndices())
+                uint32_t vidx[3];
+                if (!meshIndexData8)
                 {
-                    FALCOR_ASSERT(meshIndexData8 != nullptr);
-                    if (desc.use16BitIndices())
-                    {
-                        uint byteOffset = tidx * 3 * sizeof(uint16_t);
-                        vidx[0] = reinterpret_cast<const uint16_t*>(meshIndexData8 + byteOffset)[0];
-                        vidx[1] = reinterpret_cast<const uint16_t*>(meshIndexData8 + byteOffset)[1];
-                        vidx[2] = reinterpret_cast<const uint16_t*>(meshIndexData8 + byteOffset)[2];
-                    }
-                    else
-                    {
-                        uint byteOffset = tidx * 3 * sizeof(uint32_t);
-                        vidx[0] = reinterpret_cast<const uint32_t*>(meshIndexData8 + byteOffset)[0];
-                        vidx[1] = reinterpret_cast<const uint32_t*>(meshIndexData8 + byteOffset)[1];
-                        vidx[2] = reinterpret_cast<const uint32_t*>(meshIndexData8 + byteOffset)[2];
-                    }
+                    vidx[0] = tidx * 3 + 0;
+                    vidx[1] = tidx * 3 + 1;
+                    vidx[2] = tidx * 3 + 2;
+                }
+                else if (desc.use16BitIndices())
+                {
+                    const uint16_t* indices = reinterpret_cast<const uint16_t*>(meshIndexData8) + (size_t)tidx * 3;
+                    vidx[0] = indices[0];
+                    vidx[1] = indices[1];
+                    vidx[2] = indices[2];
                 }
                 else
                 {
-                    uint baseIndex = tidx * 3;
-                    vidx[0] = baseIndex + 0;
-                    vidx[1] = baseIndex + 1;
-                    vidx[2] = baseIndex + 2;
+                    const uint32_t* indices = reinterpret_cast<const uint32_t*>(meshIndexData8) + (size_t)tidx * 3;
+                    vidx[0] = indices[0];
+                    vidx[1] = indices[1];
+                    vidx[2] = indices[2];
                 }
                 FALCOR_ASSERT(vidx[0] < desc.vertexCount);
                 FALCOR_ASSERT(vidx[1] < desc.vertexCount);
                 FALCOR_ASSERT(vidx[2] < desc.vertexCount);
 
-                // Load vertices from global vertex buffer.
+                // Only the texture coordinates are needed, which are stored unpacked.
                 // Note that the mesh local vbOffset is added to address into the global vertex buffer.
-                StaticVertexData vertices[3];
-                vertices[0] = mMeshStaticData[(size_t)desc.vbOffset + vidx[0]].unpack();
-                vertices[1] = mMeshStaticData[(size_t)desc.vbOffset + vidx[1]].unpack();
-                vertices[2] = mMeshStaticData[(size_t)desc.vbOffset + vidx[2]].unpack();
-
-                int2 v0 = int2(std::floor(vertices[0].texCrd[0]), std::floor(vertices[0].texCrd[1]));
-                int2 v1 = int2(std::floor(vertices[1].texCrd[0]), std::floor(vertices[1].texCrd[1]));
-                int2 v2 = int2(std::floor(vertices[2].texCrd[0]), std::floor(vertices[2].texCrd[1]));
-
-                Rectangle* tile;
-                if (all(v0 == v1 && v0 == v2))
-                    tile = &tiles[v0];
-                else
-                    tile = &largeTriangleTile;
-
-                tile->include(vertices[0].texCrd);
-                tile->include(vertices[1].texCrd);
-                tile->include(vertices[2].texCrd);
+                float2 texCrd[3];
+                for (uint32_t i = 0; i < 3; ++i)
+                    texCrd[i] = meshStaticData[(size_t)desc.vbOffset + vidx[i]].texCrd;
+
+                int2 v0 = int2(std::floor(texCrd[0][0]), std::floor(texCrd[0][1]));
+                int2 v1 = int2(std::floor(texCrd[1][0]), std::floor(texCrd[1][1]));
+                int2 v2 = int2(std::floor(texCrd[2][0]), std::floor(texCrd[2][1]));
+
+                Rectangle& tile = all(v0 == v1 && v0 == v2) ? accumulator.getTile(v0) : accumulator.largeTriangleTile;
+                tile.include(texCrd[0]);
+                tile.include(texCrd[1]);
+                tile.include(texCrd[2]);
             }
+        }, 1);
 
-            std::vector<Rectangle>& result = mMeshUVTiles[meshIndex];
-            for (auto& tile : tiles)
-            {
-                if (largeTriangleTile.contains(tile.second))
-                    continue;
-                result.push_back(tile.second);
-            }
-
-            if (largeTriangleTile.valid())
-                result.push_back(largeTriangleTile);
-        };
+        // Merge the chunks of each mesh.
+        std::vector<std::vector<Rectangle>> meshUVTiles(meshDescs.size());
+        Threading::parallelFor(0, meshDescs.size(), [&](size_t meshIndex)
+        {
+            const size_t begin = meshChunkOffsets[meshIndex];
+            const size_t end = meshChunkOffsets[meshIndex + 1];
+            if (begin == end) return;
+            for (size_t i = begin + 1; i < end; ++i) partials[begin].merge(partials[i]);
+            meshUVTiles[meshIndex] = partials[begin].getTiles();
+        });
 
-        auto range = NumericRange<size_t>(0, meshDescs.size());
-        std::for_each(std::execution::par_unseq, range.begin(), range.end(), processMeshTile);
+        return meshUVTiles;
     }
 
     void Scene::setSDFGridConfig()
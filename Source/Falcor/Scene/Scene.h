@@ -281,6 +281,8 @@ namespace Falcor
             SplitVertexBuffer meshStaticData;
             /// Additional vertex attributes for skinned meshes.
             std::vector<SkinningVertexData> meshSkinningData;
+            /// UV tiles per mesh, see getGeometryUVTiles(). Computed by the scene if empty.
+            std::vector<std::vector<Rectangle>> meshUVTiles;
 
             // Curve data
             std::vector<CurveDesc> curveDesc;                       ///< List of curve descriptors.
@@ -640,6 +642,16 @@ namespace Falcor
         */
         std::vector<Rectangle> getGeometryUVTiles(GlobalGeometryID geometryID) const;
 
+        /** Compute the UV tiles of all meshes, see getGeometryUVTiles().
+            Triangles are processed in parallel in fixed size chunks, so the work is balanced also for scenes with a few very large meshes.
+            This is called by SceneBuilder so that the result is stored in the scene cache.
+            \param[in] meshDescs Mesh descriptors.
+            \param[in] meshIndexData Vertex indices of all meshes.
+            \param[in] meshStaticData Vertex data of all meshes.
+            \return List of UV tiles per mesh.
+        */
+        static std::vector<std::vector<Rectangle>> computeMeshUVTiles(const std::vector<MeshDesc>& meshDescs, const SplitIndexBuffer& meshIndexData, const SplitVertexBuffer& meshStaticData);
+
         /** Get the type of a given geometry.
             \param[in] geometryID Global geometry ID.
             \return The type of the given geometry.
@@ -1141,6 +1153,7 @@ namespace Falcor
     private:
         friend class AnimationController;
         friend class AnimatedVertexCache;
+        friend class CpuSceneRayQuery;
 
         static constexpr uint32_t kStaticDataBufferIndex = 0;
         static constexpr uint32_t kDrawIdBufferIndex = kStaticDataBufferIndex + 1;
@@ -1148,7 +1161,6 @@ namespace Falcor
 
         void createMeshVao(uint32_t drawCount, const std::vector<SkinningVertexData>& skinningData);
         void createCurveVao(const std::vector<uint32_t>& indexData, const std::vector<StaticCurveVertexData>& staticData);
-        void createMeshUVTiles(const std::vector<MeshDesc>& meshDesc);
 
         void updateSceneDefines();
         DefineList getSceneSDFGridDefines() const;
@@ -27,22 +27,25 @@
  **************************************************************************/
 #include "SceneBuilder.h"
 #include "SceneCache.h"
+#include "MeshGroupSplitting.h"
 #include "Importer.h"
+#include "VertexTransform.h"
 #include "Curves/CurveConfig.h"
 #include "Material/StandardMaterial.h"
 #include "Lights/LED_Emissive.h"
+#include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
+#include "Utils/StringUtils.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Image/TextureAnalyzer.h"
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Math/MathHelpers.h"
 #include "Utils/ObjectIDPython.h"
-#include "Utils/NumericRange.h"
+#include "Utils/Threading.h"
 #include <mikktspace.h>
 #include <filesystem>
 #include <cmath>
-#include <execution>
 
 namespace Falcor
 {
@@ -56,6 +59,10 @@ namespace Falcor
         // We'll log a warning if the maximum quantization error exceeds this value.
         const float kMaxTexelError = 0.5f;
 
+        // The global geometry buffers are filled in batches holding approximately this many bytes of mesh local data.
+        // This bounds the memory that is committed in the global buffers before the mesh local data is released.
+        const size_t kGlobalBufferBatchByteSize = 256ull << 20;
+
         int largestAxis(const float3& v)
         {
             if (v.x >= v.y && v.x >= v.z) return 0;
@@ -63,6 +70,47 @@ namespace Falcor
             else return 2;
         }
 
+        /** Buckets of values keyed by sets of scene graph nodes.
+            Lookups hash the set contents instead of ordering whole sets as in std::map<std::set<NodeID>, T>.
+            Buckets are stored in the order they are first looked up, which keeps the result deterministic.
+            The bucket stores a pointer to the key, which must outlive the object.
+        */
+        template<typename T>
+        class InstanceSetBuckets
+        {
+        public:
+            using Bucket = std::pair<const std::set<NodeID>*, T>;
+
+            T& operator[](const std::set<NodeID>& instances)
+            {
+                auto [it, inserted] = mBucketIndex.try_emplace(&instances, mBuckets.size());
+                if (inserted) mBuckets.push_back({ &instances, T{} });
+                return mBuckets[it->second].second;
+            }
+
+            const std::vector<Bucket>& getBuckets() const { return mBuckets; }
+            size_t size() const { return mBuckets.size(); }
+
+        private:
+            struct Hash
+            {
+                size_t operator()(const std::set<NodeID>* pInstances) const
+                {
+                    size_t hash = pInstances->size();
+                    for (NodeID nodeID : *pInstances) hash ^= std::hash<NodeID>{}(nodeID) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+                    return hash;
+                }
+            };
+
+            struct Equal
+            {
+                bool operator()(const std::set<NodeID>* pLhs, const std::set<NodeID>* pRhs) const { return *pLhs == *pRhs; }
+            };
+
+            std::unordered_map<const std::set<NodeID>*, size_t, Hash, Equal> mBucketIndex;
+            std::vector<Bucket> mBuckets;
+        };
+
         class MikkTSpaceWrapper
         {
         public:
@@ -202,6 +250,54 @@ namespace Falcor
             return sha1.finalize();
 
         }
+
+        template<typename T>
+        uint64_t getVectorByteSize(const std::vector<T>& v)
+        {
+            return v.capacity() * sizeof(T);
+        }
+
+        /** Execute func(item, begin, end) for all elements of a list of items in parallel.
+            The elements of each item are split into chunks of at most kElementChunkSize elements,
+            so that both many small items and a few large items keep all threads busy.
+            \param[in] itemCount Number of items.
+            \param[in] getElementCount Function with signature size_t(size_t item) returning the number of elements of an item.
+            \param[in] func Function with signature void(size_t item, size_t begin, size_t end).
+        */
+        template<typename CountFunc, typename Func>
+        void parallelForElementChunks(size_t itemCount, CountFunc&& getElementCount, Func&& func)
+        {
+            const size_t kElementChunkSize = 16384;
+
+            struct Chunk
+            {
+                size_t item;
+                size_t begin;
+                size_t end;
+            };
+            std::vector<Chunk> chunks;
+            for (size_t item = 0; item < itemCount; item++)
+            {
+                const size_t elementCount = getElementCount(item);
+                for (size_t begin = 0; begin < elementCount; begin += kElementChunkSize)
+                {
+                    chunks.push_back({ item, begin, std::min(begin + kElementChunkSize, elementCount) });
+                }
+            }
+
+            Threading::parallelFor(0, chunks.size(), [&](size_t i)
+            {
+                func(chunks[i].item, chunks[i].begin, chunks[i].end);
+            }, 1);
+        }
+
+        /** Flip the winding of a range of triangles by swapping vertex index 0 and 1 of each triangle.
+        */
+        template<typename T>
+        void flipTriangleIndices(T* pIndices, size_t firstTriangle, size_t lastTriangle)
+        {
+            for (size_t i = 3 * firstTriangle; i < 3 * lastTriangle; i += 3) std::swap(pIndices[i], pIndices[i + 1]);
+        }
     }
 
     SceneBuilder::SceneBuilder(ref<Device> pDevice, const Settings& settings, Flags flags)
@@ -348,40 +444,60 @@ namespace Falcor
         // Post-process the scene data.
         TimeReport timeReport;
 
+        // Optional per-step memory report. This is enabled through the 'sceneBuilder:memoryReport' option and records
+        // the resident set size and the size of the geometry data held by the builder after each post-processing step.
+        std::unique_ptr<TimeReport> pMemoryReport;
+        if (mSettings.getOption("sceneBuilder:memoryReport", false))
+        {
+            pMemoryReport = std::make_unique<TimeReport>();
+            pMemoryReport->enableMemoryTracking();
+        }
+        auto measureStep = [&](const std::string& name)
+        {
+            if (pMemoryReport) pMemoryReport->measure(name, getTrackedByteSize());
+        };
+        auto runStep = [&](const std::string& name, void (SceneBuilder::*pStep)())
+        {
+            (this->*pStep)();
+            measureStep(name);
+        };
+
         // Prepare displacement maps. This either removes them (if requested in build flags)
         // or makes sure that normal maps are removed if displacement is in use.
-        prepareDisplacementMaps();
-
-        prepareSceneGraph();
-        prepareMeshes();
-        removeUnusedMeshes();
-        flattenStaticMeshInstances();
-        pretransformStaticMeshes();
-        unifyTriangleWinding();
-        optimizeSceneGraph();
-        calculateMeshBoundingBoxes();
-        createMeshGroups();
-        optimizeGeometry();
-        sortMeshes();
-        createGlobalBuffers();
-        createCurveGlobalBuffers();
-        collectVolumeGrids();
-        removeDuplicateSDFGrids();
+        runStep("prepareDisplacementMaps", &SceneBuilder::prepareDisplacementMaps);
+
+        runStep("prepareSceneGraph", &SceneBuilder::prepareSceneGraph);
+        runStep("prepareMeshes", &SceneBuilder::prepareMeshes);
+        runStep("removeUnusedMeshes", &SceneBuilder::removeUnusedMeshes);
+        runStep("flattenStaticMeshInstances", &SceneBuilder::flattenStaticMeshInstances);
+        runStep("pretransformStaticMeshes", &SceneBuilder::pretransformStaticMeshes);
+        runStep("unifyTriangleWinding", &SceneBuilder::unifyTriangleWinding);
+        runStep("optimizeSceneGraph", &SceneBuilder::optimizeSceneGraph);
+        runStep("calculateMeshBoundingBoxes", &SceneBuilder::calculateMeshBoundingBoxes);
+        runStep("createMeshGroups", &SceneBuilder::createMeshGroups);
+        runStep("optimizeGeometry", &SceneBuilder::optimizeGeometry);
+        runStep("sortMeshes", &SceneBuilder::sortMeshes);
+        runStep("createGlobalBuffers", &SceneBuilder::createGlobalBuffers);
+        runStep("createCurveGlobalBuffers", &SceneBuilder::createCurveGlobalBuffers);
+        runStep("collectVolumeGrids", &SceneBuilder::collectVolumeGrids);
+        runStep("removeDuplicateSDFGrids", &SceneBuilder::removeDuplicateSDFGrids);
 
         timeReport.measure("Post processing geometry");
 
-        optimizeMaterials();
-        removeDuplicateMaterials();
-        quantizeTexCoords();
+        runStep("optimizeMaterials", &SceneBuilder::optimizeMaterials);
+        runStep("removeDuplicateMaterials", &SceneBuilder::removeDuplicateMaterials);
+        runStep("quantizeTexCoords", &SceneBuilder::quantizeTexCoords);
 
         timeReport.measure("Optimizing materials");
 
         // Prepare scene resources.
-        createSceneGraph();
-        createMeshData();
-        createMeshBoundingBoxes();
-        createCurveData();
-        calculateCurveBoundingBoxes();
+        runStep("createSceneGraph", &SceneBuilder::createSceneGraph);
+        runStep("createMeshData", &SceneBuilder::createMeshData);
+        runStep("createMeshBoundingBoxes", &SceneBuilder::createMeshBoundingBoxes);
+        mSceneData.meshUVTiles = Scene::computeMeshUVTiles(mSceneData.meshDesc, mSceneData.meshIndexData, mSceneData.meshStaticData);
+        measureStep("computeMeshUVTiles");
+        runStep("createCurveData", &SceneBuilder::createCurveData);
+        runStep("calculateCurveBoundingBoxes", &SceneBuilder::calculateCurveBoundingBoxes);
 
         // Create instance data.
         uint32_t tlasInstanceIndex = 0;
@@ -389,6 +505,7 @@ namespace Falcor
         createCurveInstanceData(tlasInstanceIndex);
         // Adjust instance indices of SDF grid instances.
         for (auto& sdfInstanceData : mSceneData.sdfGridInstances) sdfInstanceData.instanceIndex = tlasInstanceIndex++;
+        measureStep("createInstanceData");
 
         mSceneData.useCompressedHitInfo = is_set(mFlags, Flags::UseCompressedHitInfo);
 
@@ -397,6 +514,7 @@ namespace Falcor
         {
             SceneCache::writeCache(mSceneData, mSceneCacheKey);
             timeReport.measure("Writing cache");
+            measureStep("writeCache");
         }
 
         // Create the scene object.
@@ -404,8 +522,20 @@ namespace Falcor
         mSceneData = {};
 
         timeReport.measure("Creating resources");
+        measureStep("Scene::create");
         timeReport.printToLog();
 
+        if (pMemoryReport)
+        {
+            pMemoryReport->addTotal();
+            logInfo("Scene builder memory report (peak resident set size {}):", formatByteSize(getPeakRSS()));
+            pMemoryReport->printToLog();
+
+            auto reportPath = mSettings.getOption("sceneBuilder:memoryReportPath", std::string());
+            if (!reportPath.empty())
+                pMemoryReport->writeJson(reportPath);
+        }
+
         return mpScene;
     }
 
@@ -713,13 +843,12 @@ namespace Falcor
             if (mesh.tangents.pData)
             {
                 FALCOR_ASSERT(mesh.tangents.frequency == Mesh::AttributeFrequency::FaceVarying);
-                NumericRange<uint32_t> range(0, mesh.indexCount);
-                std::for_each(std::execution::par_unseq, range.begin(), range.end(), [&](uint32_t fvIndex)
+                Threading::parallelFor(0, mesh.indexCount, [&](size_t fvIndex)
                 {
                     if (!any(isnan(mesh.tangents.pData[fvIndex])))
                         return;
-                    uint32_t faceIndex = fvIndex / 3;
-                    uint32_t vertexIndex = fvIndex % 3;
+                    uint32_t faceIndex = (uint32_t)fvIndex / 3;
+                    uint32_t vertexIndex = (uint32_t)fvIndex % 3;
                     float3 normal = mesh.getNormal(faceIndex, vertexIndex);
                     tangents[fvIndex] = float4(perp_stark(normal), 1.f);
                 });
@@ -1491,6 +1620,7 @@ namespace Falcor
 
         size_t flattenedInstanceCount = 0;
         std::vector<MeshSpec> newMeshes;
+        std::vector<MeshID> newMeshSources; // Source mesh of each new mesh. The vertex data is copied after the scene graph is updated.
 
         for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)mMeshes.size(); ++meshID)
         {
@@ -1505,6 +1635,12 @@ namespace Falcor
             FALCOR_ASSERT(!mesh.instances.empty());
             FALCOR_ASSERT(mesh.skinningData.empty() && mesh.skinningVertexCount == 0);
 
+            // Temporarily take the vertex data out of the mesh so that the copies below only copy the mesh description.
+            auto indexData = std::move(mesh.indexData);
+            auto staticData = std::move(mesh.staticData);
+            mesh.indexData.clear();
+            mesh.staticData.clear();
+
             std::set<NodeID> newInstances;  // Construct a new set of instances, rather than modifying the one we're iterating over
             uint32_t instCount = 0;
             for (auto instIter = mesh.instances.cbegin(); instIter != mesh.instances.cend(); ++instIter)
@@ -1529,7 +1665,7 @@ namespace Falcor
                 else
                 {
                     // There is more than once instance, either static or dynamic.
-                    // Create a copy of the mesh. This can be expensive.
+                    // Create a copy of the mesh. The vertex data is copied later in parallel.
                     meshCopy = mesh;
                     meshCopy.name = mesh.name + "[" + std::to_string(instCount++) + "]";
                     // Make newMesh point to the copy
@@ -1581,10 +1717,13 @@ namespace Falcor
                     newNode.meshes.push_back(newMeshID);
                     // Here, we do not insert nodeID into newInstances, effectively removing it.
                     // Add to vector of meshes to be appended to mMeshes
-                    newMeshes.push_back(*newMesh);
+                    newMeshes.push_back(std::move(meshCopy));
+                    newMeshSources.push_back(meshID);
                 }
             }
             mesh.instances = newInstances;
+            mesh.indexData = std::move(indexData);
+            mesh.staticData = std::move(staticData);
         }
 
         if (mMeshes.size() == 0)
@@ -1597,6 +1736,16 @@ namespace Falcor
             std::move(newMeshes.begin(), newMeshes.end(), std::back_inserter(mMeshes));
         }
 
+        // Copy the vertex data of the flattened instances.
+        const size_t firstNewMesh = mMeshes.size() - newMeshSources.size();
+        Threading::parallelFor(0, newMeshSources.size(), [&](size_t i)
+        {
+            const auto& srcMesh = mMeshes[newMeshSources[i].get()];
+            auto& dstMesh = mMeshes[firstNewMesh + i];
+            dstMesh.indexData = srcMesh.indexData;
+            dstMesh.staticData = srcMesh.staticData;
+        });
+
         if (flattenedInstanceCount > 0) logInfo("Flattened {} static instances.", flattenedInstanceCount);
     }
 
@@ -1673,7 +1822,7 @@ namespace Falcor
         NodeID identityNodeID = addNode(Node{ "Identity", float4x4::identity(), float4x4::identity() });
         auto& identityNode = mSceneGraph[identityNodeID.get()];
 
-        size_t transformedMeshCount = 0;
+        std::vector<std::pair<MeshID, VertexTransform>> meshTransforms;
         for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)mMeshes.size(); ++meshID)
         {
             auto& mesh = mMeshes[meshID.get()];
@@ -1698,31 +1847,21 @@ namespace Falcor
                 nodeID = mSceneGraph[nodeID.get()].parent;
             }
 
-            // Flip triangle winding flag if the transform flips the coordinate system handedness (negative determinant).
-            bool flippedWinding = determinant(float3x3(transform)) < 0.f;
-            if (flippedWinding) mesh.isFrontFaceCW = !mesh.isFrontFaceCW;
-
             // Transform vertices to world space if not already identity transform.
+            // The vertices are transformed in parallel after all meshes have been relinked.
             if (transform != float4x4::identity())
             {
                 FALCOR_ASSERT(!mesh.staticData.empty());
                 FALCOR_ASSERT((size_t)mesh.vertexCount == mesh.staticData.size());
 
-                float3x3 invTranspose3x3 = float3x3(transpose(inverse(transform)));
-                float3x3 transform3x3 = float3x3(transform);
+                VertexTransform vertexTransform(transform);
 
-                for (auto& v : mesh.staticData)
-                {
-                    v.position = transformPoint(transform, v.position);
-                    v.normal = normalize(transformVector(invTranspose3x3, v.normal));
-                    v.tangent = float4(normalize(transformVector(transform3x3, v.tangent.xyz())), v.tangent.w);
-                    // TODO: We should flip the sign of v.tangent.w if flippedWinding is true.
-                    // Leaving that out for now for consistency with the shader code that needs the same fix.
-
-                    v.curveRadius = length(transformVector(transform3x3, float3(v.curveRadius, 0.f, 0.f)));
-                }
+                // Flip triangle winding flag if the transform flips the coordinate system handedness (negative determinant).
+                // TODO: We should flip the sign of v.tangent.w if the winding is flipped.
+                // Leaving that out for now for consistency with the shader code that needs the same fix.
+                if (vertexTransform.flipsWinding()) mesh.isFrontFaceCW = !mesh.isFrontFaceCW;
 
-                transformedMeshCount++;
+                meshTransforms.emplace_back(meshID, vertexTransform);
             }
 
             // Unlink mesh from its previous transform node.
@@ -1739,38 +1878,16 @@ namespace Falcor
             mesh.instances.insert(identityNodeID);
         }
 
-        if (transformedMeshCount > 0) logInfo("Pre-transformed {} static meshes to world space.", transformedMeshCount);
-    }
-
-    void SceneBuilder::flipTriangleWinding(MeshSpec& mesh)
-    {
-        FALCOR_ASSERT(mesh.topology == Vao::Topology::TriangleList);
-
-        // Abort if mesh is non-indexed. Implement this code path when/if needed.
-        // Note that both static and dynamic vertices have to be swapped for dynamic meshes.
-        if (mesh.indexCount == 0)
-        {
-            FALCOR_THROW("SceneBuilder::flipTriangleWinding() is not implemented for non-indexed meshes");
-        }
-
-        // Flip winding of indexed mesh by swapping vertex index 0 and 1 for each triangle.
-        FALCOR_ASSERT(!mesh.indexData.empty());
-        FALCOR_ASSERT(mesh.indexCount % 3 == 0);
-
-        if (mesh.use16BitIndices)
-        {
-            FALCOR_ASSERT(mesh.indexCount <= mesh.indexData.size() * 2);
-            uint16_t* indices = reinterpret_cast<uint16_t*>(mesh.indexData.data());
-            for (size_t i = 0; i < mesh.indexCount; i += 3) std::swap(indices[i], indices[i + 1]);
-        }
-        else
-        {
-            FALCOR_ASSERT(mesh.indexCount == mesh.indexData.size());
-            uint32_t* indices = mesh.indexData.data();
-            for (size_t i = 0; i < mesh.indexCount; i += 3) std::swap(indices[i], indices[i + 1]);
-        }
+        // Transform the vertices. Large meshes are split into chunks so that all threads are kept busy.
+        parallelForElementChunks(meshTransforms.size(),
+            [&](size_t i) { return mMeshes[meshTransforms[i].first.get()].staticData.size(); },
+            [&](size_t i, size_t begin, size_t end)
+            {
+                auto& mesh = mMeshes[meshTransforms[i].first.get()];
+                meshTransforms[i].second.transform(mesh.staticData.data() + begin, end - begin);
+            });
 
-        mesh.isFrontFaceCW = !mesh.isFrontFaceCW;
+        if (!meshTransforms.empty()) logInfo("Pre-transformed {} static meshes to world space.", meshTransforms.size());
     }
 
     void SceneBuilder::updateSDFGridID(SdfGridID oldID, SdfGridID newID)
@@ -1794,6 +1911,30 @@ namespace Falcor
         }
     }
 
+    uint64_t SceneBuilder::getTrackedByteSize() const
+    {
+        uint64_t byteSize = getVectorByteSize(mSceneGraph) + getVectorByteSize(mMeshes) + getVectorByteSize(mCurves) + getVectorByteSize(mMeshGroups);
+        for (const auto& mesh : mMeshes)
+        {
+            byteSize += getVectorByteSize(mesh.indexData) + getVectorByteSize(mesh.staticData) + getVectorByteSize(mesh.skinningData);
+        }
+        for (const auto& curve : mCurves)
+        {
+            byteSize += getVectorByteSize(curve.indexData) + getVectorByteSize(curve.staticData);
+        }
+        for (const auto& meshGroup : mMeshGroups)
+        {
+            byteSize += getVectorByteSize(meshGroup.meshList);
+        }
+
+        byteSize += mSceneData.meshIndexData.getByteSize() + mSceneData.meshStaticData.getByteSize();
+        byteSize += getVectorByteSize(mSceneData.meshSkinningData);
+        byteSize += getVectorByteSize(mSceneData.meshDesc) + getVectorByteSize(mSceneData.meshInstanceData) + getVectorByteSize(mSceneData.sceneGraph);
+        byteSize += getVectorByteSize(mSceneData.curveIndexData) + getVectorByteSize(mSceneData.curveStaticData);
+        byteSize += getVectorByteSize(mSceneData.curveDesc) + getVectorByteSize(mSceneData.curveInstanceData);
+        return byteSize;
+    }
+
     void SceneBuilder::unifyTriangleWinding()
     {
         // This function makes the triangle winding for all meshes consistent in object space,
@@ -1807,20 +1948,43 @@ namespace Falcor
         // Note that this pass needs to run *after* pre-transformation of static meshes to world space,
         // as those transforms may flip the winding.
 
-        size_t flippedMeshCount = 0;
+        std::vector<uint32_t> flippedMeshIDs;
         for (uint32_t meshID = 0; meshID < (uint32_t)mMeshes.size(); meshID++)
         {
-            auto& mesh = mMeshes[meshID];
+            const auto& mesh = mMeshes[meshID];
 
             // Skip meshes that are already front face counter-clockwise.
             if (mesh.isFrontFaceCW == false) continue;
 
-            flipTriangleWinding(mesh);
-            FALCOR_ASSERT(!mesh.isFrontFaceCW);
+            FALCOR_ASSERT(mesh.topology == Vao::Topology::TriangleList);
+
+            // Abort if mesh is non-indexed. Implement this code path when/if needed.
+            // Note that both static and dynamic vertices have to be swapped for dynamic meshes.
+            if (mesh.indexCount == 0)
+            {
+                FALCOR_THROW("SceneBuilder::unifyTriangleWinding() is not implemented for non-indexed meshes");
+            }
 
-            flippedMeshCount++;
+            FALCOR_ASSERT(!mesh.indexData.empty());
+            FALCOR_ASSERT(mesh.indexCount % 3 == 0);
+            FALCOR_ASSERT(mesh.use16BitIndices ? mesh.indexCount <= mesh.indexData.size() * 2 : mesh.indexCount == mesh.indexData.size());
+
+            flippedMeshIDs.push_back(meshID);
         }
 
+        // Flip winding of the indexed meshes by swapping vertex index 0 and 1 for each triangle.
+        parallelForElementChunks(flippedMeshIDs.size(),
+            [&](size_t i) { return (size_t)mMeshes[flippedMeshIDs[i]].indexCount / 3; },
+            [&](size_t i, size_t begin, size_t end)
+            {
+                auto& mesh = mMeshes[flippedMeshIDs[i]];
+                if (mesh.use16BitIndices) flipTriangleIndices(reinterpret_cast<uint16_t*>(mesh.indexData.data()), begin, end);
+                else flipTriangleIndices(mesh.indexData.data(), begin, end);
+            });
+
+        for (uint32_t meshID : flippedMeshIDs) mMeshes[meshID].isFrontFaceCW = false;
+        size_t flippedMeshCount = flippedMeshIDs.size();
+
         if (flippedMeshCount > 0) logInfo("Flipped triangle winding for {} out of {} meshes.", flippedMeshCount, mMeshes.size());
     }
 
@@ -1898,8 +2062,9 @@ namespace Falcor
         // Classify instanced meshes.
         // The instanced meshes are grouped based on their lists of instances.
         // Meshes with an identical set of instances can be placed together in a BLAS.
-        std::map<std::set<NodeID>, meshList> instancesToMeshList;
-        std::map<std::set<NodeID>, meshList> displacedInstancesToMeshList;
+        // The sets are bucketed by hash and the groups are kept in the order they are first encountered.
+        InstanceSetBuckets<meshList> instancesToMeshList;
+        InstanceSetBuckets<meshList> displacedInstancesToMeshList;
         size_t instancedMeshCount = 0;
 
         for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)mMeshes.size(); ++meshID)
@@ -1917,22 +2082,21 @@ namespace Falcor
         }
 
         // Validate that each mesh is only indexed once.
-        std::set<MeshID> instancedMeshes;
+        std::vector<bool> isMeshGrouped(mMeshes.size(), false);
         size_t instancedCount = 0;
-        for (const auto& it : instancesToMeshList)
+        for (const auto* pBuckets : { &instancesToMeshList, &displacedInstancesToMeshList })
         {
-            instancedMeshes.insert(it.second.begin(), it.second.end());
-            instancedCount += it.second.size();
-        }
-        std::set<MeshID> displacedInstancedMeshes;
-        size_t displacedInstancedCount = 0;
-        for (const auto& it : displacedInstancesToMeshList)
-        {
-            displacedInstancedMeshes.insert(it.second.begin(), it.second.end());
-            displacedInstancedCount += it.second.size();
+            for (const auto& it : pBuckets->getBuckets())
+            {
+                for (MeshID meshID : it.second)
+                {
+                    if (isMeshGrouped[meshID.get()]) FALCOR_THROW("Error in instanced mesh grouping logic");
+                    isMeshGrouped[meshID.get()] = true;
+                }
+                instancedCount += it.second.size();
+            }
         }
-        if ((instancedCount + displacedInstancedCount) != instancedMeshCount ||
-            (instancedMeshes.size() + displacedInstancedMeshes.size()) != instancedMeshCount) FALCOR_THROW("Error in instanced mesh grouping logic");
+        if (instancedCount != instancedMeshCount) FALCOR_THROW("Error in instanced mesh grouping logic");
 
         logInfo("Found {} static non-instanced meshes, arranged in 1 mesh group.", staticMeshes.size());
         logInfo("Found {} displaced non-instanced meshes, arranged in 1 mesh group.", staticDisplacedMeshes.size());
@@ -1966,7 +2130,7 @@ namespace Falcor
         }
 
         // Instanced static and dynamic meshes are grouped based on instance lists.
-        for (const auto& it : instancesToMeshList)
+        for (const auto& it : instancesToMeshList.getBuckets())
         {
             addMeshes(it.second, false, false, is_set(mFlags, Flags::RTDontMergeInstanced));
         }
@@ -1984,7 +2148,7 @@ namespace Falcor
         }
 
         // Instanced displaced meshes are grouped based on instance lists.
-        for (const auto& it : displacedInstancesToMeshList)
+        for (const auto& it : displacedInstancesToMeshList.getBuckets())
         {
             addMeshes(it.second, false, true, is_set(mFlags, Flags::RTDontMergeInstanced));
         }
@@ -2333,8 +2497,8 @@ namespace Falcor
             return MeshGroupList{ meshGroup };
 
         // Recursively split the left and right mesh groups.
-        MeshGroup leftGroup{ std::move(leftMeshes), meshGroup.isStatic };
-        MeshGroup rightGroup{ std::move(rightMeshes), meshGroup.isStatic };
+        MeshGroup leftGroup{ std::move(leftMeshes), meshGroup.isStatic, meshGroup.isDisplaced };
+        MeshGroup rightGroup{ std::move(rightMeshes), meshGroup.isStatic, meshGroup.isDisplaced };
 
         MeshGroupList leftList = splitMeshGroupMidpointMeshes(leftGroup);
         MeshGroupList rightList = splitMeshGroupMidpointMeshes(rightGroup);
@@ -2348,6 +2512,47 @@ namespace Falcor
         return leftList;
     }
 
+    SceneBuilder::MeshGroupList SceneBuilder::splitMeshGroupMorton(MeshGroup& meshGroup)
+    {
+        // This function sorts the meshes of a group along the Morton curve of their centroids
+        // and partitions the sorted list into contiguous runs based on triangle count.
+        // Consecutive meshes on the curve are close in space, so the groups are spatially compact.
+        // Individual meshes are not split, so if a single mesh spans a large part of the group,
+        // we fall back on splitting at the midpoint, which splits meshes that straddle the splitting plane.
+
+        // Early out if splitting is not needed or possible.
+        size_t triangleCount = 0;
+        if (!needsSplit(meshGroup, triangleCount)) return MeshGroupList{ std::move(meshGroup) };
+
+        const std::vector<MeshID>& meshes = meshGroup.meshList;
+        std::vector<AABB> bounds(meshes.size());
+        std::vector<size_t> triangleCounts(meshes.size());
+        for (size_t i = 0; i < meshes.size(); i++)
+        {
+            const auto& mesh = mMeshes[meshes[i].get()];
+            bounds[i] = mesh.boundingBox;
+            triangleCounts[i] = mesh.getTriangleCount();
+        }
+
+        // A large mesh would overlap most of the groups created below, so split the meshes at the midpoint instead.
+        if (MeshGroupSplitting::hasLargeMesh(bounds)) return splitMeshGroupMidpointMeshes(meshGroup);
+
+        // Sort the meshes along the Morton curve and cut the sorted list by triangle count.
+        auto partition = MeshGroupSplitting::partitionMorton(bounds, triangleCounts, kMaxTrianglesPerBLAS);
+        FALCOR_ASSERT(!partition.empty());
+
+        MeshGroupList groups;
+        groups.reserve(partition.size());
+        for (const auto& indices : partition)
+        {
+            MeshGroup& group = groups.emplace_back(MeshGroup{ std::vector<MeshID>(), meshGroup.isStatic, meshGroup.isDisplaced });
+            group.meshList.reserve(indices.size());
+            for (uint32_t index : indices) group.meshList.push_back(meshes[index]);
+        }
+
+        return groups;
+    }
+
     void SceneBuilder::optimizeGeometry()
     {
         // This function optimizes the geometry for raytracing performance and memory usage.
@@ -2360,6 +2565,11 @@ namespace Falcor
         //  - Split large mesh groups (BLASes) into multiple smaller ones.
         //  - Split large meshes into smaller to reduce spatial overlap between BLASes.
         //  - Sort meshes into BLASes based on spatial locality.
+        //
+        // Groups are split by sorting the meshes along a Morton curve and cutting the sorted list by triangle count.
+        // This is a single non-recursive pass that scales to scenes with a large number of meshes.
+        // Groups where a single mesh spans a large part of the group are split at the midpoint instead,
+        // which also splits the large meshes.
 
         MeshGroupList optimizedGroups;
 
@@ -2367,7 +2577,8 @@ namespace Falcor
         {
             //auto groups = splitMeshGroupSimple(meshGroup);
             //auto groups = splitMeshGroupMedian(meshGroup);
-            auto groups = splitMeshGroupMidpointMeshes(meshGroup);
+            //auto groups = splitMeshGroupMidpointMeshes(meshGroup);
+            auto groups = splitMeshGroupMorton(meshGroup);
 
             if (groups.size() > 1) logWarning("SceneBuilder::optimizeGeometry() performance warning - Mesh group was split into {} groups.", groups.size());
 
@@ -2432,11 +2643,23 @@ namespace Falcor
         FALCOR_ASSERT(mSceneData.meshSkinningData.empty());
 
         const bool isIndexed = !is_set(mFlags, Flags::NonIndexedVertices);
-
-        // Count total number of vertex and index data elements.
+        const size_t meshCount = mMeshes.size();
+
+        // The data is moved in two passes. The first pass computes the size and location of each mesh's data in the
+        // global buffers. The second pass packs the data into place and releases the mesh local data right away.
+        // The global buffers are reserved up front but only committed batch by batch, so the resident memory
+        // stays close to the final size instead of holding both the mesh local and global copies at the end.
+        std::vector<size_t> staticVertexCounts(meshCount);
+        std::vector<size_t> indexCounts(isIndexed ? meshCount : 0);
         size_t totalSkinningVertexCount = 0;
-        for (auto& mesh : mMeshes)
+        for (size_t i = 0; i < meshCount; ++i)
         {
+            auto& mesh = mMeshes[i];
+            staticVertexCounts[i] = mesh.staticData.size();
+            if (isIndexed) indexCounts[i] = mesh.indexData.size();
+
+            mesh.skinningVertexOffset = (uint32_t)totalSkinningVertexCount;
+            mesh.prevVertexOffset = mesh.skinningVertexOffset;
             totalSkinningVertexCount += mesh.skinningData.size();
             mSceneData.prevVertexCount += mesh.prevVertexCount;
         }
@@ -2450,39 +2673,66 @@ namespace Falcor
         mSceneData.meshIndexData.setName("mMeshIndexData");
         mSceneData.meshStaticData.setName("meshStaticData");
 
+        const std::vector<uint32_t> staticVertexOffsets = mSceneData.meshStaticData.allocateRanges(staticVertexCounts);
+        const std::vector<uint32_t> indexOffsets = mSceneData.meshIndexData.allocateRanges(indexCounts);
         mSceneData.meshSkinningData.reserve(totalSkinningVertexCount);
 
-        // Copy all vertex and index data into the global buffers.
-        for (auto& mesh : mMeshes)
-        {
-            mesh.skinningVertexOffset = (uint32_t)mSceneData.meshSkinningData.size();
-            mesh.prevVertexOffset = mesh.skinningVertexOffset;
-
-            // Insert the static vertex data in the global array.
-            // The vertices are automatically converted to their packed format in this step.
-            mesh.staticVertexOffset = mSceneData.meshStaticData.insert(mesh.staticData.begin(), mesh.staticData.end());
+        std::vector<PackedStaticVertexData*> staticDataPtrs(meshCount, nullptr);
+        std::vector<uint32_t*> indexDataPtrs(meshCount, nullptr);
 
-            if (isIndexed)
+        size_t batchBegin = 0;
+        while (batchBegin < meshCount)
+        {
+            // Gather a batch of meshes and commit their ranges in the global buffers.
+            size_t batchEnd = batchBegin;
+            size_t batchByteSize = 0;
+            size_t skinningDataEnd = mSceneData.meshSkinningData.size();
+            while (batchEnd < meshCount && (batchEnd == batchBegin || batchByteSize < kGlobalBufferBatchByteSize))
             {
-                mesh.indexOffset = mSceneData.meshIndexData.insert(mesh.indexData.begin(), mesh.indexData.end());
+                auto& mesh = mMeshes[batchEnd];
+                mesh.staticVertexOffset = staticVertexOffsets[batchEnd];
+                staticDataPtrs[batchEnd] = mSceneData.meshStaticData.commitRange(mesh.staticVertexOffset, staticVertexCounts[batchEnd]);
+                if (isIndexed)
+                {
+                    mesh.indexOffset = indexOffsets[batchEnd];
+                    indexDataPtrs[batchEnd] = mSceneData.meshIndexData.commitRange(mesh.indexOffset, indexCounts[batchEnd]);
+                }
+                FALCOR_ASSERT(!mesh.isSkinned() || !mesh.skinningData.empty());
+                skinningDataEnd = std::max(skinningDataEnd, (size_t)mesh.skinningVertexOffset + mesh.skinningData.size());
+
+                batchByteSize += getVectorByteSize(mesh.staticData) + getVectorByteSize(mesh.indexData) + getVectorByteSize(mesh.skinningData);
+                batchEnd++;
             }
+            mSceneData.meshSkinningData.resize(skinningDataEnd);
 
-            if (mesh.isSkinned())
+            // Pack the data into place. The vertices are automatically converted to their packed format in this step.
+            Threading::parallelFor(batchBegin, batchEnd, [&](size_t i)
             {
-                FALCOR_ASSERT(!mesh.skinningData.empty());
-                mSceneData.meshSkinningData.insert(mSceneData.meshSkinningData.end(), mesh.skinningData.begin(), mesh.skinningData.end());
+                auto& mesh = mMeshes[i];
+
+                PackedStaticVertexData* pStaticData = staticDataPtrs[i];
+                for (size_t v = 0; v < mesh.staticData.size(); ++v) pStaticData[v].pack(mesh.staticData[v]);
 
-                // Patch vertex index references.
-                for (uint32_t i = 0; i < mesh.skinningData.size(); ++i)
+                if (isIndexed)
                 {
-                    mSceneData.meshSkinningData[mesh.skinningVertexOffset + i].staticIndex += mesh.staticVertexOffset;
+                    std::copy(mesh.indexData.begin(), mesh.indexData.end(), indexDataPtrs[i]);
                 }
-            }
 
-            // Free the mesh local data.
-            mesh.indexData.clear();
-            mesh.staticData.clear();
-            mesh.skinningData.clear();
+                // Copy skinning data and patch vertex index references.
+                for (size_t v = 0; v < mesh.skinningData.size(); ++v)
+                {
+                    SkinningVertexData& skinningData = mSceneData.meshSkinningData[mesh.skinningVertexOffset + v];
+                    skinningData = mesh.skinningData[v];
+                    skinningData.staticIndex += mesh.staticVertexOffset;
+                }
+
+                // Free the mesh local data.
+                std::vector<uint32_t>().swap(mesh.indexData);
+                std::vector<StaticVertexData>().swap(mesh.staticData);
+                std::vector<SkinningVertexData>().swap(mesh.skinningData);
+            });
+
+            batchBegin = batchEnd;
         }
 
         // Initialize offsets for prev vertex data for vertex-animated meshes
@@ -2539,8 +2789,8 @@ namespace Falcor
             mSceneData.curveIndexData.insert(mSceneData.curveIndexData.end(), curve.indexData.begin(), curve.indexData.end());
 
             // Free the curve local data.
-            curve.indexData.clear();
-            curve.staticData.clear();
+            std::vector<uint32_t>().swap(curve.indexData);
+            std::vector<StaticCurveVertexData>().swap(curve.staticData);
         }
     }
 
@@ -798,9 +798,13 @@ namespace Falcor
         void updateLinkedObjects(NodeID oldNodeID, NodeID newNodeID);
         bool collapseNodes(NodeID parentNodeID, NodeID childNodeID);
         bool mergeNodes(NodeID dstNodeID, NodeID srcNodeID);
-        void flipTriangleWinding(MeshSpec& mesh);
         void updateSDFGridID(SdfGridID oldID, SdfGridID newID);
 
+        /** Returns the number of bytes held by the CPU-side geometry containers (mesh/curve data, scene graph and global buffers).
+            This is a tally of vector capacities used for memory instrumentation, it excludes materials and textures.
+        */
+        uint64_t getTrackedByteSize() const;
+
         /** Split a mesh by the given axis-aligned splitting plane.
             \return Pair of optional mesh IDs for the meshes on the left and right side, respectively.
         */
@@ -816,6 +820,7 @@ namespace Falcor
         MeshGroupList splitMeshGroupSimple(MeshGroup& meshGroup) const;
         MeshGroupList splitMeshGroupMedian(MeshGroup& meshGroup) const;
         MeshGroupList splitMeshGroupMidpointMeshes(MeshGroup& meshGroup);
+        MeshGroupList splitMeshGroupMorton(MeshGroup& meshGroup);
 
         // Post processing
         void prepareDisplacementMaps();
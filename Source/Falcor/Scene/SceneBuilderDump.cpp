@@ -28,8 +28,8 @@
 #include "SceneBuilderDump.h"
 #include "Scene/SceneBuilder.h"
 #include "Utils/Math/FNVHash.h"
+#include "Utils/Threading.h"
 #include <fmt/format.h>
-#include <BS_thread_pool/BS_thread_pool.hpp>
 
 /// SceneBuilder printing is split off to its own file to avoid polluting the SceneBuilder.cpp with debug prints
 
@@ -286,14 +286,8 @@ std::map<std::string, std::string> SceneBuilderDump::getDebugContent(const Scene
         result[name] = std::move(res);
     };
 
-    BS::thread_pool threadPool;
-
-    for (size_t i = 0; i < sortedMeshes.size(); ++i)
-        threadPool.push_task([&,i]{ genMesh(i); });
-    for (size_t i = 0; i < sortedCurves.size(); ++i)
-        threadPool.push_task([&,i]{ genCurve(i); });
-
-    threadPool.wait_for_tasks();
+    Threading::parallelFor(0, sortedMeshes.size(), [&](size_t i) { genMesh(i); }, 1);
+    Threading::parallelFor(0, sortedCurves.size(), [&](size_t i) { genCurve(i); }, 1);
 
     return result;
 }
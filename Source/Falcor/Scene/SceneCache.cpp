@@ -43,7 +43,7 @@ namespace Falcor
         /** Specfies the current cache file version.
             This needs to be incremented every time the file format changes!
         */
-        const uint32_t kVersion = 25;
+        const uint32_t kVersion = 26;
 
         /** Scene cache directory (subdirectory in the application data directory).
         */
@@ -378,6 +378,8 @@ namespace Falcor
         writeSplitBuffer(stream, sceneData.meshIndexData);
         writeSplitBuffer(stream, sceneData.meshStaticData);
         stream.write(sceneData.meshSkinningData);
+        stream.write((uint32_t)sceneData.meshUVTiles.size());
+        for (const auto& tiles : sceneData.meshUVTiles) stream.write(tiles);
 
         writeMarker(stream, "Curves");
         stream.write(sceneData.curveDesc);
@@ -504,6 +506,8 @@ namespace Falcor
         readSplitBuffer(stream, sceneData.meshIndexData);
         readSplitBuffer(stream, sceneData.meshStaticData);
         stream.read(sceneData.meshSkinningData);
+        sceneData.meshUVTiles.resize(stream.read<uint32_t>());
+        for (auto& tiles : sceneData.meshUVTiles) stream.read(tiles);
 
         readMarker(stream, "Curves");
         stream.read(sceneData.curveDesc);
@@ -0,0 +1,129 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "VertexTransform.h"
+#include "Utils/Math/MatrixMath.h"
+#include "Utils/Math/VectorMath.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define FALCOR_VERTEX_TRANSFORM_SSE2 1
+#include <emmintrin.h>
+#else
+#define FALCOR_VERTEX_TRANSFORM_SSE2 0
+#endif
+
+namespace Falcor
+{
+    namespace
+    {
+        float3 transformRadius(const float3x4& m, float radius)
+        {
+            // Same as length(transformVector(float3x3(m), float3(radius, 0.f, 0.f))).
+            return float3(m[0][0] * radius, m[1][0] * radius, m[2][0] * radius);
+        }
+
+#if FALCOR_VERTEX_TRANSFORM_SSE2
+        /** Columns of a 3x4 matrix, each padded to 4 floats.
+            Products are summed in the same order as dot() so that results match the scalar path.
+        */
+        struct Columns
+        {
+            __m128 c[4];
+
+            Columns(const float3x4& m)
+            {
+                for (int i = 0; i < 4; i++) c[i] = _mm_setr_ps(m[0][i], m[1][i], m[2][i], 0.f);
+            }
+
+            Columns(const float3x3& m)
+            {
+                for (int i = 0; i < 3; i++) c[i] = _mm_setr_ps(m[0][i], m[1][i], m[2][i], 0.f);
+                c[3] = _mm_setzero_ps();
+            }
+
+            __m128 transformVector(const float3& v) const
+            {
+                __m128 r = _mm_add_ps(_mm_mul_ps(c[0], _mm_set1_ps(v.x)), _mm_mul_ps(c[1], _mm_set1_ps(v.y)));
+                return _mm_add_ps(r, _mm_mul_ps(c[2], _mm_set1_ps(v.z)));
+            }
+
+            __m128 transformPoint(const float3& v) const
+            {
+                return _mm_add_ps(transformVector(v), c[3]);
+            }
+        };
+
+        float3 toFloat3(__m128 v)
+        {
+            alignas(16) float f[4];
+            _mm_store_ps(f, v);
+            return float3(f[0], f[1], f[2]);
+        }
+#endif
+    }
+
+    VertexTransform::VertexTransform(const float4x4& transform)
+        : mTransform(transform)
+        , mNormalTransform(float3x3(transpose(inverse(transform))))
+        , mFlipsWinding(determinant(float3x3(transform)) < 0.f)
+    {
+    }
+
+    void VertexTransform::transform(StaticVertexData* pVertices, size_t count) const
+    {
+#if FALCOR_VERTEX_TRANSFORM_SSE2
+        const Columns transformColumns(mTransform);
+        const Columns normalColumns(mNormalTransform);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            StaticVertexData& v = pVertices[i];
+            v.position = toFloat3(transformColumns.transformPoint(v.position));
+            v.normal = normalize(toFloat3(normalColumns.transformVector(v.normal)));
+            v.tangent = float4(normalize(toFloat3(transformColumns.transformVector(v.tangent.xyz()))), v.tangent.w);
+            v.curveRadius = length(transformRadius(mTransform, v.curveRadius));
+        }
+#else
+        transformScalar(pVertices, count);
+#endif
+    }
+
+    void VertexTransform::transformScalar(StaticVertexData* pVertices, size_t count) const
+    {
+        const float3x3 transform3x3 = float3x3(mTransform);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            StaticVertexData& v = pVertices[i];
+            const float4 p(v.position, 1.f);
+            v.position = float3(dot(mTransform[0], p), dot(mTransform[1], p), dot(mTransform[2], p));
+            v.normal = normalize(transformVector(mNormalTransform, v.normal));
+            v.tangent = float4(normalize(transformVector(transform3x3, v.tangent.xyz())), v.tangent.w);
+            v.curveRadius = length(transformRadius(mTransform, v.curveRadius));
+        }
+    }
+}
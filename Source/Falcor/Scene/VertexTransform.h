@@ -0,0 +1,70 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SceneTypes.slang"
+#include "Core/Macros.h"
+#include "Utils/Math/Matrix.h"
+#include "Utils/Math/Vector.h"
+#include <cstddef>
+
+namespace Falcor
+{
+    /** Affine transform of static vertex data, used to pre-transform meshes to world space on the CPU.
+
+        Only the upper 3x4 part of the transform is used, i.e., the transform is assumed to be affine.
+        Positions are transformed by the 3x4 matrix, normals by the inverse transpose of the 3x3 part and
+        tangents by the 3x3 part. Normals and tangents are renormalized and curve radii are scaled.
+        The SSE2 path sums the products in the same order as transformPoint()/transformVector(), so both paths give the same results.
+    */
+    class FALCOR_API VertexTransform
+    {
+    public:
+        explicit VertexTransform(const float4x4& transform);
+
+        /** Returns true if the transform flips the coordinate system handedness (negative determinant).
+        */
+        bool flipsWinding() const { return mFlipsWinding; }
+
+        /** Transform vertices in place. Uses SSE2 where available.
+            \param[in,out] pVertices Vertices to transform.
+            \param[in] count Number of vertices.
+        */
+        void transform(StaticVertexData* pVertices, size_t count) const;
+
+        /** Transform vertices in place without SIMD. Used as reference.
+            \param[in,out] pVertices Vertices to transform.
+            \param[in] count Number of vertices.
+        */
+        void transformScalar(StaticVertexData* pVertices, size_t count) const;
+
+    private:
+        float3x4 mTransform;        ///< Upper 3x4 part of the transform.
+        float3x3 mNormalTransform;  ///< Inverse transpose of the upper 3x3 part.
+        bool mFlipsWinding = false;
+    };
+}
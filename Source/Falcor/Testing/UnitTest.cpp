@@ -43,10 +43,15 @@
 #include <fmt/color.h>
 #include <pugixml.hpp>
 #include <BS_thread_pool/BS_thread_pool_light.hpp>
+#include <nlohmann/json.hpp>
 
 #include <algorithm>
 #include <chrono>
+#include <exception>
+#include <fstream>
+#include <numeric>
 #include <regex>
+#include <thread>
 #include <cstdint>
 
 namespace Falcor
@@ -61,6 +66,7 @@ struct TestDesc
     unittest::Options options;
     CPUTestFunc cpuFunc;
     GPUTestFunc gpuFunc;
+    BenchmarkFunc benchmarkFunc;
 };
 
 struct TestResult
@@ -76,6 +82,7 @@ struct TestResult
     std::vector<std::string> messages;
     std::string extraMessage;
     uint64_t elapsedMS = 0;
+    std::vector<BenchmarkResult> benchmarks;
 };
 
 static std::vector<TestDesc>& getTestRegistry()
@@ -143,6 +150,16 @@ void registerGPUTest(std::filesystem::path path, std::string name, unittest::Opt
     getTestRegistry().push_back(desc);
 }
 
+void registerBenchmark(std::filesystem::path path, std::string name, unittest::Options options, BenchmarkFunc func)
+{
+    TestDesc desc;
+    desc.path = std::move(path);
+    desc.name = std::move(name);
+    desc.options = std::move(options);
+    desc.benchmarkFunc = std::move(func);
+    getTestRegistry().push_back(desc);
+}
+
 /// Prints the UnitTest report line, making sure it is always printed to the console once.
 template<typename... Args>
 void reportLine(const std::string_view format, Args&&... args)
@@ -162,6 +179,85 @@ void reportLine(const std::string_view format, Args&&... args)
     logInfo(report);
 }
 
+inline std::string formatBenchmarkTime(double ns)
+{
+    if (ns < 1e3)
+        return fmt::format("{:.2f} ns", ns);
+    if (ns < 1e6)
+        return fmt::format("{:.2f} us", ns * 1e-3);
+    if (ns < 1e9)
+        return fmt::format("{:.2f} ms", ns * 1e-6);
+    return fmt::format("{:.2f} s", ns * 1e-9);
+}
+
+inline std::string formatThroughput(double perSecond, const char* unit)
+{
+    const char* prefixes[] = {"", "K", "M", "G", "T"};
+    size_t prefix = 0;
+    while (perSecond >= 1000.0 && prefix + 1 < std::size(prefixes))
+    {
+        perSecond /= 1000.0;
+        ++prefix;
+    }
+    return fmt::format("{:.2f} {}{}/s", perSecond, prefixes[prefix], unit);
+}
+
+/// Benchmark options and baseline results shared by all benchmarks of a run.
+struct BenchmarkSession
+{
+    BenchmarkOptions options;
+    std::map<std::string, double> baselineMedianNS;
+};
+
+/**
+ * Load the median times of a benchmark report written by writeBenchmarkReport().
+ * @param[in] path File path.
+ * @return Median time in nanoseconds per case name.
+ */
+inline std::map<std::string, double> loadBenchmarkBaseline(const std::filesystem::path& path)
+{
+    std::ifstream ifs(path);
+    if (!ifs.good())
+        FALCOR_THROW("Failed to open benchmark baseline '{}'.", path.string());
+
+    std::map<std::string, double> baseline;
+    nlohmann::json json = nlohmann::json::parse(ifs);
+    for (const auto& benchmark : json.at("benchmarks"))
+        baseline[benchmark.at("name").get<std::string>()] = benchmark.at("median_ns").get<double>();
+    return baseline;
+}
+
+/**
+ * Write benchmark results in JSON format. The file can be used as a baseline for later runs.
+ * @param[in] path File path.
+ * @param[in] report List of tests/results.
+ */
+inline void writeBenchmarkReport(const std::filesystem::path& path, const std::vector<std::pair<Test, TestResult>>& report)
+{
+    nlohmann::json benchmarks = nlohmann::json::array();
+    for (const auto& [test, result] : report)
+    {
+        for (const BenchmarkResult& benchmark : result.benchmarks)
+        {
+            benchmarks.push_back({
+                {"name", benchmark.name},
+                {"iterations", benchmark.iterations},
+                {"samples", benchmark.samples},
+                {"min_ns", benchmark.minNS},
+                {"median_ns", benchmark.medianNS},
+                {"p95_ns", benchmark.p95NS},
+                {"mean_ns", benchmark.meanNS},
+                {"items_per_second", benchmark.itemsPerSecond},
+                {"bytes_per_second", benchmark.bytesPerSecond},
+            });
+        }
+    }
+
+    nlohmann::json json = {{"version", getLongVersionString()}, {"benchmarks", std::move(benchmarks)}};
+    std::ofstream ofs(path);
+    ofs << json.dump(4) << std::endl;
+}
+
 /**
  * Write a test report in JUnit's XML format.
  * @param[in] path File path.
@@ -211,7 +307,7 @@ inline void writeXmlReport(const std::filesystem::path& path, const std::vector<
     doc.save_file(path.native().c_str());
 }
 
-inline TestResult runTest(const Test& test, DevicePool& devicePool)
+inline TestResult runTest(const Test& test, DevicePool& devicePool, const BenchmarkSession& benchmarkSession)
 {
     if (!test.skipMessage.empty())
         return {TestResult::Status::Skipped, {test.skipMessage}};
@@ -243,6 +339,15 @@ inline TestResult runTest(const Test& test, DevicePool& devicePool)
             pDevice->wait();
             devicePool.releaseDevice(std::move(pDevice));
         }
+        else if (test.benchmarkFunc)
+        {
+            BenchmarkContext benchmarkCtx(
+                benchmarkSession.options, fmt::format("{}:{}", test.suiteName, test.name), benchmarkSession.baselineMedianNS
+            );
+            test.benchmarkFunc(benchmarkCtx);
+            result.messages = benchmarkCtx.getFailureMessages();
+            result.benchmarks = benchmarkCtx.getResults();
+        }
     }
     catch (const SkippingTestException& e)
     {
@@ -282,7 +387,7 @@ inline TestResult runTest(const Test& test, DevicePool& devicePool)
     return result;
 }
 
-inline int32_t runTestsParallel(const RunOptions& options)
+inline int32_t runTestsParallel(const RunOptions& options, const BenchmarkSession& benchmarkSession)
 {
     // Abort on Ctrl-C.
     std::atomic<bool> abort{false};
@@ -308,44 +413,52 @@ inline int32_t runTestsParallel(const RunOptions& options)
 
     reportLine("[==========] Running {} test{}.", tests.size(), plural(tests.size(), "s"));
 
-    for (size_t testIndex = 0; testIndex < tests.size(); ++testIndex)
+    auto runAndReport = [&abort, &tests, &results, &devicePool, &benchmarkSession](size_t testIndex)
     {
-        threadPool.push_task(
-            [&abort, &tests, &results, &devicePool, testIndex]()
-            {
-                if (abort)
-                    return;
+        if (abort)
+            return;
 
-                const Test& test = tests[testIndex];
-                TestResult& result = results[testIndex];
-                std::string repeats;
+        const Test& test = tests[testIndex];
+        TestResult& result = results[testIndex];
+        std::string repeats;
 
-                reportLine("[ RUN      ] {}:{}{}", test.suiteName, test.name, repeats);
+        reportLine("[ RUN      ] {}:{}{}", test.suiteName, test.name, repeats);
 
-                result = runTest(test, devicePool);
+        result = runTest(test, devicePool, benchmarkSession);
 
-                std::string statusTag;
-                switch (result.status)
-                {
-                case TestResult::Status::Passed:
-                    statusTag = "[       OK ]";
-                    break;
-                case TestResult::Status::Failed:
-                    statusTag = "[  FAILED  ]";
-                    break;
-                case TestResult::Status::Skipped:
-                    statusTag = "[  SKIPPED ]";
-                    break;
-                }
-                if (!result.extraMessage.empty())
-                    reportLine("{}", result.extraMessage);
-                reportLine("{} {}:{}{} ({} ms)", statusTag, test.suiteName, test.name, repeats, result.elapsedMS);
-            }
-        );
+        std::string statusTag;
+        switch (result.status)
+        {
+        case TestResult::Status::Passed:
+            statusTag = "[       OK ]";
+            break;
+        case TestResult::Status::Failed:
+            statusTag = "[  FAILED  ]";
+            break;
+        case TestResult::Status::Skipped:
+            statusTag = "[  SKIPPED ]";
+            break;
+        }
+        if (!result.extraMessage.empty())
+            reportLine("{}", result.extraMessage);
+        reportLine("{} {}:{}{} ({} ms)", statusTag, test.suiteName, test.name, repeats, result.elapsedMS);
+    };
+
+    // Benchmarks are deferred and run one at a time after the other tests to get stable timings.
+    std::vector<size_t> benchmarkIndices;
+    for (size_t testIndex = 0; testIndex < tests.size(); ++testIndex)
+    {
+        if (tests[testIndex].benchmarkFunc)
+            benchmarkIndices.push_back(testIndex);
+        else
+            threadPool.push_task(runAndReport, testIndex);
     }
 
     threadPool.wait_for_tasks();
 
+    for (size_t testIndex : benchmarkIndices)
+        runAndReport(testIndex);
+
     if (abort)
     {
         reportLine("[ ABORTED  ]");
@@ -355,6 +468,14 @@ inline int32_t runTestsParallel(const RunOptions& options)
     auto endTime = std::chrono::steady_clock::now();
     uint64_t totalMS = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
 
+    if (!options.benchmark.jsonReportPath.empty())
+    {
+        std::vector<std::pair<Test, TestResult>> report;
+        for (size_t testIndex : benchmarkIndices)
+            report.emplace_back(tests[testIndex], results[testIndex]);
+        writeBenchmarkReport(options.benchmark.jsonReportPath, report);
+    }
+
     int32_t failureCount = 0;
     for (const auto& result : results)
         failureCount += result.status == TestResult::Status::Failed ? 1 : 0;
@@ -374,7 +495,7 @@ inline int32_t runTestsParallel(const RunOptions& options)
     return failureCount;
 }
 
-inline int32_t runTestsSerial(const RunOptions& options)
+inline int32_t runTestsSerial(const RunOptions& options, const BenchmarkSession& benchmarkSession)
 {
     // Abort on Ctrl-C.
     std::atomic<bool> abort{false};
@@ -430,7 +551,7 @@ inline int32_t runTestsSerial(const RunOptions& options)
                 if (options.repeat > 1)
                     repeats = fmt::format("[{}/{}]", repeatIndex + 1, options.repeat);
                 reportLine("[ RUN      ] {}:{}{}", suiteName, test.name, repeats);
-                TestResult result = runTest(test, devicePool);
+                TestResult result = runTest(test, devicePool, benchmarkSession);
                 report.emplace_back(test, result);
 
                 std::string statusTag;
@@ -473,6 +594,8 @@ inline int32_t runTestsSerial(const RunOptions& options)
 
     if (!options.xmlReportPath.empty())
         writeXmlReport(options.xmlReportPath, report);
+    if (!options.benchmark.jsonReportPath.empty())
+        writeBenchmarkReport(options.benchmark.jsonReportPath, report);
 
     reportLine(
         "[==========] {} test{} from {} test suite{} ran. ({} ms total)",
@@ -507,7 +630,13 @@ int32_t runTests(const RunOptions& options)
     Threading::start();
     Scripting::start();
 
-    int32_t failureCount = options.parallel > 1 ? runTestsParallel(options) : runTestsSerial(options);
+    BenchmarkSession benchmarkSession;
+    benchmarkSession.options = options.benchmark;
+    if (!options.benchmark.baselinePath.empty())
+        benchmarkSession.baselineMedianNS = loadBenchmarkBaseline(options.benchmark.baselinePath);
+
+    int32_t failureCount =
+        options.parallel > 1 ? runTestsParallel(options, benchmarkSession) : runTestsSerial(options, benchmarkSession);
 
     Scripting::shutdown();
     Threading::shutdown();
@@ -531,8 +660,9 @@ std::vector<Test> enumerateTests()
         test.deviceType = Device::Type::Default;
         test.cpuFunc = desc.cpuFunc;
         test.gpuFunc = desc.gpuFunc;
+        test.benchmarkFunc = desc.benchmarkFunc;
 
-        if (test.cpuFunc)
+        if (test.cpuFunc || test.benchmarkFunc)
         {
             tests.push_back(test);
         }
@@ -724,6 +854,129 @@ void GPUUnitTestContext::runProgram(const uint3& dimensions)
     mpDevice->getRenderContext()->dispatch(mpState.get(), mpVars.get(), groups);
 }
 
+///////////////////////////////////////////////////////////////////////////
+
+BenchmarkResult BenchmarkContext::runBatches(const std::string& name, const std::function<void(uint64_t)>& batch)
+{
+    BenchmarkResult result;
+    result.name = name.empty() ? mTestName : fmt::format("{}/{}", mTestName, name);
+    std::vector<double> samplesNS;
+
+    auto measure = [&]()
+    {
+        auto timeBatchMS = [&](uint64_t iterations)
+        {
+            auto startTime = std::chrono::steady_clock::now();
+            batch(iterations);
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        };
+
+        // Warmup while calibrating the iteration count, which grows until a batch runs for at least the minimum sample time.
+        uint64_t iterations = 1;
+        double warmupMS = 0.0;
+        while (true)
+        {
+            double timeMS = timeBatchMS(iterations);
+            warmupMS += timeMS;
+            if (timeMS < mOptions.minSampleTimeMS)
+            {
+                double scale = timeMS > 0.0 ? 1.2 * mOptions.minSampleTimeMS / timeMS : 10.0;
+                iterations = std::max(iterations + 1, (uint64_t)(iterations * std::min(scale, 10.0)));
+            }
+            else if (warmupMS >= mOptions.warmupTimeMS)
+            {
+                break;
+            }
+        }
+
+        result.iterations = iterations;
+        for (uint32_t i = 0; i < std::max(mOptions.sampleCount, 1u); ++i)
+            samplesNS.push_back(timeBatchMS(iterations) * 1e6 / iterations);
+    };
+
+    if (mOptions.affinityMask != 0)
+    {
+        // Measure on a separate pinned thread. This leaves the affinity of the test thread unchanged.
+        std::exception_ptr exception;
+        std::thread thread(
+            [&]()
+            {
+                setThreadAffinity(getCurrentThread(), mOptions.affinityMask);
+                try
+                {
+                    measure();
+                }
+                catch (...)
+                {
+                    exception = std::current_exception();
+                }
+            }
+        );
+        thread.join();
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+    else
+    {
+        measure();
+    }
+
+    std::sort(samplesNS.begin(), samplesNS.end());
+    auto percentile = [&](double p)
+    {
+        double position = p * (samplesNS.size() - 1);
+        size_t index = (size_t)position;
+        size_t next = std::min(index + 1, samplesNS.size() - 1);
+        return samplesNS[index] + (samplesNS[next] - samplesNS[index]) * (position - index);
+    };
+
+    result.samples = (uint32_t)samplesNS.size();
+    result.minNS = samplesNS.front();
+    result.medianNS = percentile(0.5);
+    result.p95NS = percentile(0.95);
+    result.meanNS = std::accumulate(samplesNS.begin(), samplesNS.end(), 0.0) / samplesNS.size();
+    if (mItemsPerIteration > 0)
+        result.itemsPerSecond = mItemsPerIteration * 1e9 / result.medianNS;
+    if (mBytesPerIteration > 0)
+        result.bytesPerSecond = mBytesPerIteration * 1e9 / result.medianNS;
+
+    std::string line = fmt::format(
+        "[   BENCH  ] {}: median {}, min {}, p95 {}",
+        result.name,
+        formatBenchmarkTime(result.medianNS),
+        formatBenchmarkTime(result.minNS),
+        formatBenchmarkTime(result.p95NS)
+    );
+    if (result.itemsPerSecond > 0.0)
+        line += ", " + formatThroughput(result.itemsPerSecond, "items");
+    if (result.bytesPerSecond > 0.0)
+        line += ", " + formatThroughput(result.bytesPerSecond, "B");
+
+    double change = 0.0;
+    if (auto it = mBaselineMedianNS.find(result.name); it != mBaselineMedianNS.end() && it->second > 0.0)
+    {
+        result.baselineNS = it->second;
+        change = result.medianNS / result.baselineNS - 1.0;
+        line += fmt::format(", {:+.1f}% vs. baseline", change * 100.0);
+    }
+    reportLine("{}", line);
+
+    if (result.baselineNS > 0.0 && change > mOptions.regressionThreshold)
+    {
+        reportFailure(fmt::format(
+            "Benchmark '{}' regressed: median {} vs. baseline {} ({:+.1f}%, threshold {:.1f}%).",
+            result.name,
+            formatBenchmarkTime(result.medianNS),
+            formatBenchmarkTime(result.baselineNS),
+            change * 100.0,
+            mOptions.regressionThreshold * 100.0
+        ));
+    }
+
+    mResults.push_back(result);
+    return result;
+}
+
 } // namespace unittest
 
 /**
@@ -798,4 +1051,19 @@ CPU_TEST(TestTags, TAGS("tag1", "tag2", "tag3"))
     EXPECT(true);
 }
 
+CPU_BENCHMARK(TestBenchmark)
+{
+    std::vector<uint32_t> data(1024, 1);
+    ctx.setItemsPerIteration(data.size());
+    const auto& result = ctx.run("sum", [&]() { doNotOptimize(std::accumulate(data.begin(), data.end(), 0u)); });
+
+    EXPECT_EQ(result.name, "UnitTest.cpp:TestBenchmark/sum");
+    EXPECT_GE(result.iterations, 1u);
+    EXPECT_GE(result.samples, 1u);
+    EXPECT_LE(result.minNS, result.medianNS);
+    EXPECT_LE(result.medianNS, result.p95NS);
+    EXPECT_GT(result.itemsPerSecond, 0.0);
+    EXPECT_EQ(result.bytesPerSecond, 0.0);
+}
+
 } // namespace Falcor
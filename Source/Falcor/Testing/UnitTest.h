@@ -37,6 +37,10 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#if FALCOR_MSVC
+#include <intrin.h>
+#endif
+
 #include <filesystem>
 #include <functional>
 #include <map>
@@ -84,6 +88,17 @@ public:
     SkippingTestException(const std::string& what) : std::runtime_error(what.c_str()) {}
 };
 
+struct BenchmarkOptions
+{
+    uint32_t sampleCount = 10;            ///< Number of timed samples per benchmark case.
+    double minSampleTimeMS = 10.0;        ///< The iteration count is calibrated so that each sample runs at least this long.
+    double warmupTimeMS = 20.0;           ///< Minimum time spent running a case before sampling starts.
+    uint32_t affinityMask = 0;            ///< If non-zero, cases are measured on a thread pinned to these cores.
+    std::filesystem::path jsonReportPath; ///< If set, benchmark results are written to this JSON file.
+    std::filesystem::path baselinePath;   ///< If set, results are compared against this JSON file written by a previous run.
+    double regressionThreshold = 0.1;     ///< Relative increase of the median time over the baseline that fails a benchmark.
+};
+
 struct RunOptions
 {
     Device::Desc deviceDesc;
@@ -93,15 +108,18 @@ struct RunOptions
     std::filesystem::path xmlReportPath;
     uint32_t parallel = 1;
     uint32_t repeat = 1;
+    BenchmarkOptions benchmark;
 };
 
 FALCOR_API int32_t runTests(const RunOptions& options);
 
 class CPUUnitTestContext;
 class GPUUnitTestContext;
+class BenchmarkContext;
 
 using CPUTestFunc = std::function<void(CPUUnitTestContext& ctx)>;
 using GPUTestFunc = std::function<void(GPUUnitTestContext& ctx)>;
+using BenchmarkFunc = std::function<void(BenchmarkContext& ctx)>;
 
 struct Test
 {
@@ -113,6 +131,7 @@ struct Test
 
     CPUTestFunc cpuFunc;
     GPUTestFunc gpuFunc;
+    BenchmarkFunc benchmarkFunc;
 };
 
 /// Enumerate all tests.
@@ -153,6 +172,89 @@ private:
 class FALCOR_API CPUUnitTestContext : public UnitTestContext
 {};
 
+/// Statistics of a single benchmark case. Times are per iteration.
+struct BenchmarkResult
+{
+    std::string name;            ///< Full case name (suite:test or suite:test/case).
+    uint64_t iterations = 0;     ///< Iterations per sample.
+    uint32_t samples = 0;        ///< Number of timed samples.
+    double minNS = 0.0;          ///< Fastest sample.
+    double medianNS = 0.0;       ///< Median sample.
+    double p95NS = 0.0;          ///< 95th percentile sample.
+    double meanNS = 0.0;         ///< Mean over all samples.
+    double itemsPerSecond = 0.0; ///< Item throughput at the median time, 0 if no item count was set.
+    double bytesPerSecond = 0.0; ///< Byte throughput at the median time, 0 if no byte count was set.
+    double baselineNS = 0.0;     ///< Median time of the baseline, 0 if there is no baseline.
+};
+
+/**
+ * Context of a CPU_BENCHMARK. Each call to run() measures one benchmark case.
+ * The context also supports the regular EXPECT/ASSERT macros.
+ */
+class FALCOR_API BenchmarkContext : public CPUUnitTestContext
+{
+public:
+    BenchmarkContext(BenchmarkOptions options, std::string testName, std::map<std::string, double> baselineMedianNS = {})
+        : mOptions(std::move(options)), mTestName(std::move(testName)), mBaselineMedianNS(std::move(baselineMedianNS))
+    {}
+
+    /**
+     * Set the number of items processed by one iteration of the cases that follow. Used to report throughput.
+     */
+    void setItemsPerIteration(uint64_t items) { mItemsPerIteration = items; }
+
+    /**
+     * Set the number of bytes processed by one iteration of the cases that follow. Used to report throughput.
+     */
+    void setBytesPerIteration(uint64_t bytes) { mBytesPerIteration = bytes; }
+
+    /**
+     * Measure a benchmark case. The function is first run for warmup while the number of iterations per sample
+     * is calibrated, then the configured number of samples is timed.
+     * @param[in] name Case name. Used in reports and to match baseline results. Can be empty if there is only one case.
+     * @param[in] func Function to measure. Use doNotOptimize() to keep results alive.
+     * @return Statistics of the case.
+     */
+    template<typename Func>
+    BenchmarkResult run(const std::string& name, Func&& func)
+    {
+        return runBatches(
+            name,
+            [&func](uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; ++i)
+                    func();
+            }
+        );
+    }
+
+    const std::vector<BenchmarkResult>& getResults() const { return mResults; }
+
+private:
+    BenchmarkResult runBatches(const std::string& name, const std::function<void(uint64_t)>& batch);
+
+    BenchmarkOptions mOptions;
+    std::string mTestName;
+    std::map<std::string, double> mBaselineMedianNS;
+    uint64_t mItemsPerIteration = 0;
+    uint64_t mBytesPerIteration = 0;
+    std::vector<BenchmarkResult> mResults;
+};
+
+/**
+ * Prevent the compiler from optimizing away the computation of a value in a benchmark.
+ */
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+#if FALCOR_MSVC
+    (void)*reinterpret_cast<const volatile char*>(&value);
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "m"(value) : "memory");
+#endif
+}
+
 class FALCOR_API GPUUnitTestContext : public UnitTestContext
 {
 public:
@@ -351,6 +453,7 @@ void applyArgs(Options& options, Args&&... args)
 
 FALCOR_API void registerCPUTest(std::filesystem::path path, std::string name, unittest::Options options, CPUTestFunc func);
 FALCOR_API void registerGPUTest(std::filesystem::path path, std::string name, unittest::Options options, GPUTestFunc func);
+FALCOR_API void registerBenchmark(std::filesystem::path path, std::string name, unittest::Options options, BenchmarkFunc func);
 
 /**
  * StreamSink is a utility class used by the testing framework that either
@@ -533,6 +636,8 @@ inline std::optional<std::string> createBinaryMessage(std::string_view lhsStr, s
 using UnitTestContext = unittest::UnitTestContext;
 using CPUUnitTestContext = unittest::CPUUnitTestContext;
 using GPUUnitTestContext = unittest::GPUUnitTestContext;
+using BenchmarkContext = unittest::BenchmarkContext;
+using unittest::doNotOptimize;
 
 /**
  * Macro to define a CPU unit test. The optional arguments include:
@@ -609,6 +714,38 @@ using GPUUnitTestContext = unittest::GPUUnitTestContext;
     } RegisterGPUTest##name;                                                    \
     static void GPUUnitTest##name(GPUUnitTestContext& ctx) /* over to the user for the braces */
 
+/**
+ * Macro to define a CPU benchmark. Takes the same optional arguments as CPU_TEST.
+ * The body receives a BenchmarkContext `ctx` and measures one or more cases with ctx.run():
+ *
+ * CPU_BENCHMARK(Sort)
+ * {
+ *     std::vector<uint32_t> data = createData();
+ *     ctx.setItemsPerIteration(data.size());
+ *     ctx.run("std::sort", [&]() { auto copy = data; std::sort(copy.begin(), copy.end()); doNotOptimize(copy); });
+ * }
+ *
+ * The results (min/median/p95 time and throughput) are reported per case. They can be written to
+ * a JSON file and compared against a baseline, see BenchmarkOptions.
+ *
+ * Note: All benchmarks are implicitly tagged with "cpu" and "benchmark".
+ */
+#define CPU_BENCHMARK(name, ...)                                                   \
+    static void CPUBenchmark##name(BenchmarkContext& ctx);                         \
+    struct CPUBenchmarkRegisterer##name                                            \
+    {                                                                              \
+        CPUBenchmarkRegisterer##name()                                             \
+        {                                                                          \
+            std::filesystem::path path = __FILE__;                                 \
+            unittest::Options options;                                             \
+            applyArgs(options, ##__VA_ARGS__);                                     \
+            options.tags.insert("cpu");                                            \
+            options.tags.insert("benchmark");                                      \
+            unittest::registerBenchmark(path, #name, options, CPUBenchmark##name); \
+        }                                                                          \
+    } RegisterCPUBenchmark##name;                                                  \
+    static void CPUBenchmark##name(BenchmarkContext& ctx) /* over to the user for the braces */
+
 // clang-format off
 
 /// Used as an argument of CPU_TEST/GPU_TEST to tag a test with a set of strings.
@@ -0,0 +1,172 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace Falcor
+{
+
+/**
+ * Greedy packing of lifetime intervals into a minimal set of shared slots.
+ *
+ * Each item describes an object (typically a GPU resource) that is live during the inclusive
+ * time range [begin, end]. Items with the same compatibility class and non-overlapping lifetimes
+ * can share a slot. Items are processed in order of their start time and placed in the first free
+ * slot of their class, which is equivalent to greedy interval graph coloring and is optimal
+ * per compatibility class.
+ *
+ * The algorithm has no GPU dependencies, it only computes the assignment.
+ */
+class IntervalPacking
+{
+public:
+    struct Item
+    {
+        uint32_t begin = 0;              ///< First time point where the item is live.
+        uint32_t end = 0;                ///< Last time point where the item is live (inclusive).
+        uint32_t compatibilityClass = 0; ///< Only items with the same class can share a slot.
+        uint64_t size = 0;               ///< Size of the item in bytes.
+        bool aliasable = true;           ///< If false, the item is always given its own slot.
+    };
+
+    struct Result
+    {
+        std::vector<uint32_t> slots;     ///< Slot index per item.
+        std::vector<uint64_t> slotSizes; ///< Size in bytes per slot.
+        uint64_t bytesBefore = 0;        ///< Total bytes if every item is allocated separately.
+        uint64_t bytesAfter = 0;         ///< Total bytes if every slot is allocated separately.
+        uint64_t peakLiveBytes = 0;      ///< Maximum number of bytes live at any time point (lower bound for bytesAfter).
+
+        uint32_t getSlotCount() const { return (uint32_t)slotSizes.size(); }
+    };
+
+    /**
+     * Pack items into slots.
+     * @param[in] items List of items. Items with begin > end are treated as being live at a single time point.
+     * @return Slot assignment and memory statistics.
+     */
+    static Result pack(const std::vector<Item>& items)
+    {
+        Result result;
+        result.slots.resize(items.size());
+
+        std::vector<uint32_t> order(items.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(
+            order.begin(),
+            order.end(),
+            [&](uint32_t a, uint32_t b)
+            {
+                if (getBegin(items[a]) != getBegin(items[b]))
+                    return getBegin(items[a]) < getBegin(items[b]);
+                return getEnd(items[a]) < getEnd(items[b]);
+            }
+        );
+
+        struct Slot
+        {
+            uint32_t compatibilityClass;
+            uint32_t busyUntil;
+            bool aliasable;
+        };
+        std::vector<Slot> slots;
+
+        for (uint32_t i : order)
+        {
+            const Item& item = items[i];
+            result.bytesBefore += item.size;
+
+            uint32_t slotIndex = (uint32_t)slots.size();
+            if (item.aliasable)
+            {
+                for (uint32_t s = 0; s < (uint32_t)slots.size(); s++)
+                {
+                    const Slot& slot = slots[s];
+                    if (slot.aliasable && slot.compatibilityClass == item.compatibilityClass && slot.busyUntil < getBegin(item))
+                    {
+                        slotIndex = s;
+                        break;
+                    }
+                }
+            }
+
+            if (slotIndex == slots.size())
+            {
+                slots.push_back({item.compatibilityClass, getEnd(item), item.aliasable});
+                result.slotSizes.push_back(item.size);
+            }
+            else
+            {
+                slots[slotIndex].busyUntil = getEnd(item);
+                result.slotSizes[slotIndex] = std::max(result.slotSizes[slotIndex], item.size);
+            }
+            result.slots[i] = slotIndex;
+        }
+
+        for (uint64_t size : result.slotSizes)
+            result.bytesAfter += size;
+
+        result.peakLiveBytes = computePeakLiveBytes(items);
+        return result;
+    }
+
+    /**
+     * Compute the maximum number of bytes that are live at the same time point.
+     */
+    static uint64_t computePeakLiveBytes(const std::vector<Item>& items)
+    {
+        // Sweep over start/end events. Ends are processed after starts at the same time point since lifetimes are inclusive.
+        std::vector<std::pair<uint64_t, int64_t>> events;
+        events.reserve(items.size() * 2);
+        for (const Item& item : items)
+        {
+            events.emplace_back(2 * (uint64_t)getBegin(item), (int64_t)item.size);
+            events.emplace_back(2 * (uint64_t)getEnd(item) + 1, -(int64_t)item.size);
+        }
+        std::sort(events.begin(), events.end());
+
+        int64_t live = 0;
+        int64_t peak = 0;
+        for (const auto& [time, delta] : events)
+        {
+            live += delta;
+            peak = std::max(peak, live);
+        }
+        return (uint64_t)peak;
+    }
+
+private:
+    static uint32_t getBegin(const Item& item) { return std::min(item.begin, item.end); }
+    static uint32_t getEnd(const Item& item) { return std::max(item.begin, item.end); }
+};
+
+} // namespace Falcor
@@ -0,0 +1,231 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Utils/Threading.h"
+#include "Utils/Math/AABB.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Math/Vector.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+
+/**
+ * Spatial sorting of points along a Morton (Z-order) curve.
+ *
+ * Points are quantized to a 21-bit grid per axis within their bounding box and the bits are interleaved
+ * into 63-bit Morton codes. Sorting by code places points that are close in space close in the sequence,
+ * so contiguous runs of the sorted sequence form spatially compact clusters.
+ *
+ * The codes are sorted with a stable least-significant-digit radix sort. Histograms and scatters are
+ * computed per block of keys in parallel on the global thread pool; the result is identical to a
+ * serial stable sort independent of the thread count.
+ */
+class MortonSort
+{
+public:
+    static constexpr uint32_t kBitsPerAxis = 21;
+
+    /**
+     * Spread the lower 21 bits of a value so that there are two zero bits between each bit.
+     */
+    static uint64_t expandBits(uint64_t v)
+    {
+        v &= 0x1fffff;
+        v = (v | (v << 32)) & 0x1f00000000ffffull;
+        v = (v | (v << 16)) & 0x1f0000ff0000ffull;
+        v = (v | (v << 8)) & 0x100f00f00f00f00full;
+        v = (v | (v << 4)) & 0x10c30c30c30c30c3ull;
+        v = (v | (v << 2)) & 0x1249249249249249ull;
+        return v;
+    }
+
+    /**
+     * Compute the 63-bit Morton code of a point.
+     * @param[in] p Point.
+     * @param[in] bounds Bounding box used for quantization. Points outside are clamped, degenerate axes map to zero.
+     * @return Morton code with the x bits in the lowest position of each triplet.
+     */
+    static uint64_t encode(const float3& p, const AABB& bounds) { return encode(p, bounds.minPoint, getScale(bounds)); }
+
+    /**
+     * Compute Morton codes for a list of points quantized within their common bounding box.
+     * @param[in] points List of points.
+     * @return Morton code per point.
+     */
+    static std::vector<uint64_t> computeCodes(const std::vector<float3>& points)
+    {
+        AABB bounds;
+        for (const float3& p : points)
+            bounds.include(p);
+
+        const float3 origin = bounds.minPoint;
+        const float3 scale = getScale(bounds);
+
+        std::vector<uint64_t> codes(points.size());
+        Threading::parallelFor(
+            0, points.size(), [&](size_t i) { codes[i] = encode(points[i], origin, scale); }, kBlockSize
+        );
+        return codes;
+    }
+
+    /**
+     * Compute the stable sort order of a list of keys.
+     * @param[in] keys List of keys.
+     * @return Permutation such that keys[order[i]] is non-decreasing. Equal keys keep their original order.
+     */
+    static std::vector<uint32_t> sort(const std::vector<uint64_t>& keys)
+    {
+        const size_t count = keys.size();
+        std::vector<uint64_t> srcKeys(keys), dstKeys(count);
+        std::vector<uint32_t> srcOrder(count), dstOrder(count);
+        for (size_t i = 0; i < count; ++i)
+            srcOrder[i] = (uint32_t)i;
+        if (count <= 1)
+            return srcOrder;
+
+        // Digits where all keys agree do not change the order and are skipped.
+        uint64_t orBits = 0, andBits = ~0ull;
+        for (uint64_t key : keys)
+        {
+            orBits |= key;
+            andBits &= key;
+        }
+        const uint64_t varyingBits = orBits ^ andBits;
+
+        const size_t blockCount = div_round_up(count, kBlockSize);
+        std::vector<size_t> offsets(blockCount * kRadix);
+
+        for (uint32_t shift = 0; shift < 64; shift += kRadixBits)
+        {
+            if (((varyingBits >> shift) & (kRadix - 1)) == 0)
+                continue;
+
+            auto getDigit = [shift](uint64_t key) { return (size_t)((key >> shift) & (kRadix - 1)); };
+
+            // Count digits per block.
+            Threading::parallelFor(
+                0,
+                blockCount,
+                [&](size_t block)
+                {
+                    size_t* pCounts = &offsets[block * kRadix];
+                    const uint64_t* pSrcKeys = srcKeys.data();
+                    std::fill_n(pCounts, kRadix, 0);
+                    const size_t end = std::min(count, (block + 1) * kBlockSize);
+                    for (size_t i = block * kBlockSize; i < end; ++i)
+                        pCounts[getDigit(pSrcKeys[i])]++;
+                },
+                1
+            );
+
+            // Exclusive prefix sum in (digit, block) order turns the counts into scatter offsets.
+            size_t sum = 0;
+            for (size_t digit = 0; digit < kRadix; ++digit)
+            {
+                for (size_t block = 0; block < blockCount; ++block)
+                {
+                    size_t& offset = offsets[block * kRadix + digit];
+                    const size_t digitCount = offset;
+                    offset = sum;
+                    sum += digitCount;
+                }
+            }
+
+            // Scatter each block to its offsets. Blocks write disjoint ranges and keep their relative order.
+            Threading::parallelFor(
+                0,
+                blockCount,
+                [&](size_t block)
+                {
+                    size_t* pOffsets = &offsets[block * kRadix];
+                    const uint64_t* pSrcKeys = srcKeys.data();
+                    const uint32_t* pSrcOrder = srcOrder.data();
+                    uint64_t* pDstKeys = dstKeys.data();
+                    uint32_t* pDstOrder = dstOrder.data();
+                    const size_t end = std::min(count, (block + 1) * kBlockSize);
+                    for (size_t i = block * kBlockSize; i < end; ++i)
+                    {
+                        const uint64_t key = pSrcKeys[i];
+                        const size_t dst = pOffsets[getDigit(key)]++;
+                        pDstKeys[dst] = key;
+                        pDstOrder[dst] = pSrcOrder[i];
+                    }
+                },
+                1
+            );
+
+            srcKeys.swap(dstKeys);
+            srcOrder.swap(dstOrder);
+        }
+
+        return srcOrder;
+    }
+
+    /**
+     * Compute the order of a list of points along the Morton curve of their bounding box.
+     * @param[in] points List of points.
+     * @return Permutation of point indices in Morton order.
+     */
+    static std::vector<uint32_t> sortPoints(const std::vector<float3>& points) { return sort(computeCodes(points)); }
+
+private:
+    // 11-bit digits sort 63-bit codes in six passes.
+    static constexpr uint32_t kRadixBits = 11;
+    static constexpr size_t kRadix = size_t(1) << kRadixBits;
+    static constexpr size_t kBlockSize = 16384;
+
+    static float3 getScale(const AABB& bounds)
+    {
+        const float3 extent = bounds.extent();
+        float3 scale;
+        for (int i = 0; i < 3; ++i)
+            scale[i] = (extent[i] > 0.f && std::isfinite(extent[i])) ? float(1u << kBitsPerAxis) / extent[i] : 0.f;
+        return scale;
+    }
+
+    static uint64_t encode(const float3& p, const float3& origin, const float3& scale)
+    {
+        const float kMaxCell = float((1u << kBitsPerAxis) - 1);
+        uint64_t code = 0;
+        for (int i = 0; i < 3; ++i)
+        {
+            // Written so that NaN maps to cell zero.
+            const float cell = (p[i] - origin[i]) * scale[i];
+            const uint64_t q = cell > 0.f ? (uint64_t)std::min(cell, kMaxCell) : 0;
+            code |= expandBits(q) << i;
+        }
+        return code;
+    }
+};
+
+} // namespace Falcor
@@ -26,110 +26,173 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "CryptoUtils.h"
+#include "Core/Error.h"
+#include "Utils/StringFormatters.h"
+#include "Utils/Threading.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <iomanip>
 #include <sstream>
+#include <vector>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define FALCOR_HASH_X86 1
+#include <immintrin.h>
+#if FALCOR_MSVC
+#include <intrin.h>
+#define FALCOR_HASH_TARGET(features)
+#else
+#include <cpuid.h>
+#define FALCOR_HASH_TARGET(features) __attribute__((target(features)))
+#endif
+#else
+#define FALCOR_HASH_X86 0
+#endif
 
 namespace Falcor
 {
-SHA1::SHA1() : mIndex(0), mBits(0)
+namespace
 {
-    mState[0] = 0x67452301;
-    mState[1] = 0xefcdab89;
-    mState[2] = 0x98badcfe;
-    mState[3] = 0x10325476;
-    mState[4] = 0xc3d2e1f0;
-}
-
-void SHA1::update(uint8_t byte)
+struct CpuFeatures
 {
-    addByte(byte);
-    mBits += 8;
-}
+    bool sha = false;  ///< SHA extensions including the SSSE3/SSE4.1 instructions used alongside them.
+    bool avx2 = false; ///< AVX2 with OS support for saving YMM registers.
+};
 
-void SHA1::update(const void* data, size_t len)
+CpuFeatures detectCpuFeatures()
 {
-    if (!data)
-        return;
-
-    const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data);
-
-    // Fill up buffer if not full.
-    while (len > 0 && mIndex != 0)
-    {
-        update(*ptr++);
-        len--;
-    }
-
-    // Process full blocks.
-    while (len >= sizeof(mBuf))
+    CpuFeatures features;
+#if FALCOR_HASH_X86
+    uint32_t regs1[4] = {};
+    uint32_t regs7[4] = {};
+#if FALCOR_MSVC
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    std::memcpy(regs1, info, sizeof(regs1));
+    if (maxLeaf >= 7)
     {
-        processBlock(ptr);
-        ptr += sizeof(mBuf);
-        len -= sizeof(mBuf);
-        mBits += sizeof(mBuf) * 8;
+        __cpuidex(info, 7, 0);
+        std::memcpy(regs7, info, sizeof(regs7));
     }
+#else
+    unsigned int maxLeaf = __get_cpuid_max(0, nullptr);
+    __get_cpuid(1, &regs1[0], &regs1[1], &regs1[2], &regs1[3]);
+    if (maxLeaf >= 7)
+        __get_cpuid_count(7, 0, &regs7[0], &regs7[1], &regs7[2], &regs7[3]);
+#endif
+    const bool ssse3 = regs1[2] & (1u << 9);
+    const bool sse41 = regs1[2] & (1u << 19);
+    const bool osxsave = regs1[2] & (1u << 27);
+    const bool avx = regs1[2] & (1u << 28);
+    features.sha = ssse3 && sse41 && (regs7[1] & (1u << 29));
 
-    // Process remaining bytes.
-    while (len > 0)
+    if (osxsave && avx)
     {
-        update(*ptr++);
-        len--;
+#if FALCOR_MSVC
+        uint64_t xcr0 = _xgetbv(0);
+#else
+        uint32_t xcr0Lo, xcr0Hi;
+        __asm__("xgetbv" : "=a"(xcr0Lo), "=d"(xcr0Hi) : "c"(0));
+        uint64_t xcr0 = ((uint64_t)xcr0Hi << 32) | xcr0Lo;
+#endif
+        // Check that the OS saves XMM and YMM state.
+        features.avx2 = (xcr0 & 0x6) == 0x6 && (regs7[1] & (1u << 5));
     }
+#endif
+    return features;
 }
 
-SHA1::MD SHA1::finalize()
+const CpuFeatures& getCpuFeatures()
 {
-    // Finalize with 0x80, some zero padding and the length in bits.
-    addByte(0x80);
-    while (mIndex % 64 != 56)
-    {
-        addByte(0);
-    }
-    for (int i = 7; i >= 0; --i)
-    {
-        addByte(mBits >> i * 8);
-    }
+    static const CpuFeatures features = detectCpuFeatures();
+    return features;
+}
 
-    MD md;
-    for (int i = 0; i < 5; i++)
-    {
-        for (int j = 3; j >= 0; j--)
-        {
-            md[i * 4 + j] = (mState[i] >> ((3 - j) * 8)) & 0xff;
-        }
-    }
+std::atomic<bool> gAccelerationEnabled{true};
 
-    return md;
+bool useSHAExtensions()
+{
+    return getCpuFeatures().sha && gAccelerationEnabled.load(std::memory_order_relaxed);
 }
 
-SHA1::MD SHA1::compute(const void* data, size_t len)
+bool useAVX2()
 {
-    SHA1 sha1;
-    sha1.update(data, len);
-    return sha1.finalize();
+    return getCpuFeatures().avx2 && gAccelerationEnabled.load(std::memory_order_relaxed);
 }
 
-std::string SHA1::toString(const SHA1::MD& sha1)
+template<size_t N>
+std::string toHexString(const std::array<uint8_t, N>& bytes)
 {
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0') << std::setw(2);
-    for (auto c : sha1)
-        ss << (int)c;
-    return ss.str();
+    static const char kHexDigits[] = "0123456789abcdef";
+    std::string str(2 * N, '0');
+    for (size_t i = 0; i < N; i++)
+    {
+        str[2 * i] = kHexDigits[bytes[i] >> 4];
+        str[2 * i + 1] = kHexDigits[bytes[i] & 0xf];
+    }
+    return str;
 }
 
-void SHA1::addByte(uint8_t byte)
+/**
+ * Helper for the Merkle-Damgard style buffering shared by SHA-1 and SHA-256.
+ * Appends data to the partial block buffer and forwards complete blocks to the block function.
+ */
+template<typename ProcessBlocks>
+void updateBlocks(uint8_t* buf, uint32_t& index, uint64_t& bits, const uint8_t* ptr, size_t len, ProcessBlocks processBlocks)
 {
-    mBuf[mIndex++] = byte;
+    bits += (uint64_t)len * 8;
+
+    // Fill up buffer if not empty.
+    if (index != 0)
+    {
+        size_t count = std::min(len, (size_t)(64 - index));
+        std::memcpy(buf + index, ptr, count);
+        index += (uint32_t)count;
+        ptr += count;
+        len -= count;
+        if (index < 64)
+            return;
+        processBlocks(buf, 1);
+        index = 0;
+    }
 
-    if (mIndex >= sizeof(mBuf))
+    // Process full blocks directly from the input.
+    if (size_t blockCount = len / 64; blockCount > 0)
     {
-        mIndex = 0;
-        processBlock(mBuf);
+        processBlocks(ptr, blockCount);
+        ptr += blockCount * 64;
+        len -= blockCount * 64;
     }
+
+    // Buffer remaining bytes.
+    std::memcpy(buf + index, ptr, len);
+    index += (uint32_t)len;
 }
 
-void SHA1::processBlock(const uint8_t* ptr)
+/**
+ * Append the final padding and the message length in bits (big-endian).
+ */
+template<typename ProcessBlocks>
+void finalizeBlocks(uint8_t* buf, uint32_t index, uint64_t bits, ProcessBlocks processBlocks)
+{
+    buf[index++] = 0x80;
+    if (index > 56)
+    {
+        std::memset(buf + index, 0, 64 - index);
+        processBlocks(buf, 1);
+        index = 0;
+    }
+    std::memset(buf + index, 0, 56 - index);
+    for (int i = 0; i < 8; i++)
+        buf[56 + i] = (uint8_t)(bits >> ((7 - i) * 8));
+    processBlocks(buf, 1);
+}
+
+void sha1BlockPortable(uint32_t state[5], const uint8_t* ptr)
 {
     auto rol32 = [](uint32_t x, uint32_t n) { return (x << n) | (x >> (32 - n)); };
 
@@ -141,11 +204,11 @@ void SHA1::processBlock(const uint8_t* ptr)
     const uint32_t c2 = 0x8f1bbcdc;
     const uint32_t c3 = 0xca62c1d6;
 
-    uint32_t a = mState[0];
-    uint32_t b = mState[1];
-    uint32_t c = mState[2];
-    uint32_t d = mState[3];
-    uint32_t e = mState[4];
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+    uint32_t e = state[4];
 
     uint32_t w[16];
 
@@ -251,10 +314,921 @@ void SHA1::processBlock(const uint8_t* ptr)
 #undef SHA1_ROUND_3
 #undef SHA1_ROUND_4
 
-    mState[0] += a;
-    mState[1] += b;
-    mState[2] += c;
-    mState[3] += d;
-    mState[4] += e;
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+#if FALCOR_HASH_X86
+FALCOR_HASH_TARGET("sha,sse4.1,ssse3")
+void sha1BlocksSHAExt(uint32_t state[5], const uint8_t* ptr, size_t blockCount)
+{
+    const __m128i kMask = _mm_set_epi64x(0x0001020304050607ull, 0x08090a0b0c0d0e0full);
+
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)state), 0x1b);
+    __m128i e0 = _mm_set_epi32((int)state[4], 0, 0, 0);
+
+    for (; blockCount > 0; blockCount--, ptr += 64)
+    {
+        const __m128i abcdSave = abcd;
+        const __m128i e0Save = e0;
+        __m128i msg[4];
+        __m128i e[2] = {e0, e0};
+
+        // Each group computes 4 rounds. The message schedule for group t + 1..3 is computed interleaved with group t.
+        // clang-format off
+#define SHA1_GROUP(t)                                                                               \
+    if (t < 4) msg[t % 4] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(ptr + 16 * t)), kMask); \
+    e[t % 2] = t == 0 ? _mm_add_epi32(e[0], msg[0]) : _mm_sha1nexte_epu32(e[t % 2], msg[t % 4]);  \
+    e[(t + 1) % 2] = abcd;                                                                          \
+    if (t >= 3 && t <= 18) msg[(t + 1) % 4] = _mm_sha1msg2_epu32(msg[(t + 1) % 4], msg[t % 4]);     \
+    abcd = _mm_sha1rnds4_epu32(abcd, e[t % 2], t / 5);                                              \
+    if (t >= 1 && t <= 16) msg[(t + 3) % 4] = _mm_sha1msg1_epu32(msg[(t + 3) % 4], msg[t % 4]);     \
+    if (t >= 2 && t <= 17) msg[(t + 2) % 4] = _mm_xor_si128(msg[(t + 2) % 4], msg[t % 4]);
+        // clang-format on
+
+        SHA1_GROUP(0);
+        SHA1_GROUP(1);
+        SHA1_GROUP(2);
+        SHA1_GROUP(3);
+        SHA1_GROUP(4);
+        SHA1_GROUP(5);
+        SHA1_GROUP(6);
+        SHA1_GROUP(7);
+        SHA1_GROUP(8);
+        SHA1_GROUP(9);
+        SHA1_GROUP(10);
+        SHA1_GROUP(11);
+        SHA1_GROUP(12);
+        SHA1_GROUP(13);
+        SHA1_GROUP(14);
+        SHA1_GROUP(15);
+        SHA1_GROUP(16);
+        SHA1_GROUP(17);
+        SHA1_GROUP(18);
+        SHA1_GROUP(19);
+
+#undef SHA1_GROUP
+
+        e0 = _mm_sha1nexte_epu32(e[0], e0Save);
+        abcd = _mm_add_epi32(abcd, abcdSave);
+    }
+
+    _mm_storeu_si128((__m128i*)state, _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
+#endif
+
+// clang-format off
+const uint32_t kSHA256RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+// clang-format on
+
+void sha256BlockPortable(uint32_t state[8], const uint8_t* ptr)
+{
+    auto ror32 = [](uint32_t x, uint32_t n) { return (x >> n) | (x << (32 - n)); };
+
+    uint32_t w[64];
+    for (size_t i = 0; i < 16; i++)
+        w[i] = ((uint32_t)ptr[4 * i] << 24) | ((uint32_t)ptr[4 * i + 1] << 16) | ((uint32_t)ptr[4 * i + 2] << 8) | (uint32_t)ptr[4 * i + 3];
+    for (size_t i = 16; i < 64; i++)
+    {
+        uint32_t s0 = ror32(w[i - 15], 7) ^ ror32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ror32(w[i - 2], 17) ^ ror32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (size_t i = 0; i < 64; i++)
+    {
+        uint32_t s1 = ror32(e, 6) ^ ror32(e, 11) ^ ror32(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t t1 = h + s1 + ch + kSHA256RoundConstants[i] + w[i];
+        uint32_t s0 = ror32(a, 2) ^ ror32(a, 13) ^ ror32(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = s0 + maj;
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+#if FALCOR_HASH_X86
+FALCOR_HASH_TARGET("sha,sse4.1,ssse3")
+void sha256BlocksSHAExt(uint32_t state[8], const uint8_t* ptr, size_t blockCount)
+{
+    const __m128i kMask = _mm_set_epi64x(0x0c0d0e0f08090a0bull, 0x0405060700010203ull);
+
+    // The SHA extensions operate on the state in ABEF/CDGH order.
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[0]), 0xb1); // CDAB
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[4]), 0x1b); // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0); // CDGH
+
+    for (; blockCount > 0; blockCount--, ptr += 64)
+    {
+        const __m128i abefSave = state0;
+        const __m128i cdghSave = state1;
+        __m128i msg[4];
+        __m128i wk;
+
+        // Each group computes 4 rounds. The message schedule for group t + 1..3 is computed interleaved with group t.
+        // clang-format off
+#define SHA256_GROUP(t)                                                                                              \
+    if (t < 4) msg[t % 4] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(ptr + 16 * t)), kMask);                  \
+    wk = _mm_add_epi32(msg[t % 4], _mm_loadu_si128((const __m128i*)&kSHA256RoundConstants[4 * t]));                  \
+    state1 = _mm_sha256rnds2_epu32(state1, state0, wk);                                                              \
+    if (t >= 3 && t <= 14)                                                                                           \
+    {                                                                                                                \
+        msg[(t + 1) % 4] = _mm_add_epi32(msg[(t + 1) % 4], _mm_alignr_epi8(msg[t % 4], msg[(t + 3) % 4], 4));     \
+        msg[(t + 1) % 4] = _mm_sha256msg2_epu32(msg[(t + 1) % 4], msg[t % 4]);                                    \
+    }                                                                                                                \
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(wk, 0x0e));                                    \
+    if (t >= 1 && t <= 12) msg[(t + 3) % 4] = _mm_sha256msg1_epu32(msg[(t + 3) % 4], msg[t % 4]);
+        // clang-format on
+
+        SHA256_GROUP(0);
+        SHA256_GROUP(1);
+        SHA256_GROUP(2);
+        SHA256_GROUP(3);
+        SHA256_GROUP(4);
+        SHA256_GROUP(5);
+        SHA256_GROUP(6);
+        SHA256_GROUP(7);
+        SHA256_GROUP(8);
+        SHA256_GROUP(9);
+        SHA256_GROUP(10);
+        SHA256_GROUP(11);
+        SHA256_GROUP(12);
+        SHA256_GROUP(13);
+        SHA256_GROUP(14);
+        SHA256_GROUP(15);
+
+#undef SHA256_GROUP
+
+        state0 = _mm_add_epi32(state0, abefSave);
+        state1 = _mm_add_epi32(state1, cdghSave);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1b); // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xb1); // DCHG
+    _mm_storeu_si128((__m128i*)&state[0], _mm_blend_epi16(tmp, state1, 0xf0)); // DCBA
+    _mm_storeu_si128((__m128i*)&state[4], _mm_alignr_epi8(state1, tmp, 8)); // HGFE
+}
+#endif
+
+// XXH3 constants and building blocks. See https://github.com/Cyan4973/xxHash for the reference implementation.
+
+constexpr size_t kXXHStripeLen = 64;
+constexpr size_t kXXHSecretConsumeRate = 8;
+constexpr size_t kXXHSecretSize = 192;
+constexpr size_t kXXHSecretLimit = kXXHSecretSize - kXXHStripeLen;
+constexpr size_t kXXHStripesPerBlock = kXXHSecretLimit / kXXHSecretConsumeRate;
+constexpr size_t kXXHBlockLen = kXXHStripeLen * kXXHStripesPerBlock;
+constexpr size_t kXXHSecretLastAccStart = 7;
+constexpr size_t kXXHSecretMergeAccsStart = 11;
+constexpr size_t kXXHMidSizeMax = 240;
+constexpr size_t kXXHMidSizeStartOffset = 3;
+constexpr size_t kXXHMidSizeLastOffset = 17;
+constexpr size_t kXXHSecretSizeMin = 136;
+
+constexpr uint32_t kPrime32_1 = 0x9e3779b1u;
+constexpr uint32_t kPrime32_2 = 0x85ebca77u;
+constexpr uint32_t kPrime32_3 = 0xc2b2ae3du;
+constexpr uint64_t kPrime64_1 = 0x9e3779b185ebca87ull;
+constexpr uint64_t kPrime64_2 = 0xc2b2ae3d27d4eb4full;
+constexpr uint64_t kPrime64_3 = 0x165667b19e3779f9ull;
+constexpr uint64_t kPrime64_4 = 0x85ebca77c2b2ae63ull;
+constexpr uint64_t kPrime64_5 = 0x27d4eb2f165667c5ull;
+constexpr uint64_t kPrimeMx1 = 0x165667919e3779f9ull;
+constexpr uint64_t kPrimeMx2 = 0x9fb21c651e98df25ull;
+
+// clang-format off
+alignas(64) const uint8_t kXXHSecret[kXXHSecretSize] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+const uint64_t kXXHInitAcc[8] = {
+    kPrime32_3, kPrime64_1, kPrime64_2, kPrime64_3, kPrime64_4, kPrime32_2, kPrime64_5, kPrime32_1,
+};
+// clang-format on
+
+inline uint32_t readLE32(const uint8_t* p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t readLE64(const uint8_t* p)
+{
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t swap32(uint32_t x)
+{
+    return ((x << 24) & 0xff000000u) | ((x << 8) & 0x00ff0000u) | ((x >> 8) & 0x0000ff00u) | ((x >> 24) & 0x000000ffu);
+}
+
+inline uint64_t swap64(uint64_t x)
+{
+    return ((uint64_t)swap32((uint32_t)x) << 32) | swap32((uint32_t)(x >> 32));
+}
+
+inline uint32_t rotl32(uint32_t x, int r)
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+inline Hash128::Digest mult64to128(uint64_t lhs, uint64_t rhs)
+{
+#if FALCOR_MSVC
+    uint64_t hi;
+    uint64_t lo = _umul128(lhs, rhs, &hi);
+    return {lo, hi};
+#else
+    unsigned __int128 product = (unsigned __int128)lhs * rhs;
+    return {(uint64_t)product, (uint64_t)(product >> 64)};
+#endif
+}
+
+inline uint64_t mul128Fold64(uint64_t lhs, uint64_t rhs)
+{
+    Hash128::Digest product = mult64to128(lhs, rhs);
+    return product.low64 ^ product.high64;
+}
+
+inline uint64_t xorShift64(uint64_t v, int shift)
+{
+    return v ^ (v >> shift);
+}
+
+inline uint64_t xxh64Avalanche(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= kPrime64_2;
+    h ^= h >> 29;
+    h *= kPrime64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+inline uint64_t xxh3Avalanche(uint64_t h)
+{
+    h = xorShift64(h, 37);
+    h *= kPrimeMx1;
+    h = xorShift64(h, 32);
+    return h;
+}
+
+inline uint64_t mix16B(const uint8_t* input, const uint8_t* secret)
+{
+    return mul128Fold64(readLE64(input) ^ readLE64(secret), readLE64(input + 8) ^ readLE64(secret + 8));
+}
+
+inline Hash128::Digest mix32B(Hash128::Digest acc, const uint8_t* input1, const uint8_t* input2, const uint8_t* secret)
+{
+    acc.low64 += mix16B(input1, secret);
+    acc.low64 ^= readLE64(input2) + readLE64(input2 + 8);
+    acc.high64 += mix16B(input2, secret + 16);
+    acc.high64 ^= readLE64(input1) + readLE64(input1 + 8);
+    return acc;
+}
+
+Hash128::Digest hashLen0To16(const uint8_t* input, size_t len, const uint8_t* secret)
+{
+    if (len > 8)
+    {
+        uint64_t bitflipl = readLE64(secret + 32) ^ readLE64(secret + 40);
+        uint64_t bitfliph = readLE64(secret + 48) ^ readLE64(secret + 56);
+        uint64_t inputLo = readLE64(input);
+        uint64_t inputHi = readLE64(input + len - 8);
+        Hash128::Digest m128 = mult64to128(inputLo ^ inputHi ^ bitflipl, kPrime64_1);
+        m128.low64 += (uint64_t)(len - 1) << 54;
+        inputHi ^= bitfliph;
+        m128.high64 += inputHi + (uint64_t)(uint32_t)inputHi * (kPrime32_2 - 1);
+        m128.low64 ^= swap64(m128.high64);
+        Hash128::Digest h128 = mult64to128(m128.low64, kPrime64_2);
+        h128.high64 += m128.high64 * kPrime64_2;
+        return {xxh3Avalanche(h128.low64), xxh3Avalanche(h128.high64)};
+    }
+    if (len >= 4)
+    {
+        uint64_t input64 = readLE32(input) + ((uint64_t)readLE32(input + len - 4) << 32);
+        uint64_t bitflip = readLE64(secret + 16) ^ readLE64(secret + 24);
+        Hash128::Digest m128 = mult64to128(input64 ^ bitflip, kPrime64_1 + (len << 2));
+        m128.high64 += m128.low64 << 1;
+        m128.low64 ^= m128.high64 >> 3;
+        m128.low64 = xorShift64(m128.low64, 35);
+        m128.low64 *= kPrimeMx2;
+        m128.low64 = xorShift64(m128.low64, 28);
+        m128.high64 = xxh3Avalanche(m128.high64);
+        return m128;
+    }
+    if (len > 0)
+    {
+        uint32_t combinedl = ((uint32_t)input[0] << 16) | ((uint32_t)input[len >> 1] << 24) | (uint32_t)input[len - 1] | ((uint32_t)len << 8);
+        uint32_t combinedh = rotl32(swap32(combinedl), 13);
+        uint64_t bitflipl = readLE32(secret) ^ readLE32(secret + 4);
+        uint64_t bitfliph = readLE32(secret + 8) ^ readLE32(secret + 12);
+        return {xxh64Avalanche(combinedl ^ bitflipl), xxh64Avalanche(combinedh ^ bitfliph)};
+    }
+    return {xxh64Avalanche(readLE64(secret + 64) ^ readLE64(secret + 72)), xxh64Avalanche(readLE64(secret + 80) ^ readLE64(secret + 88))};
+}
+
+Hash128::Digest finalizeMidSize(Hash128::Digest acc, size_t len)
+{
+    uint64_t low64 = acc.low64 + acc.high64;
+    uint64_t high64 = acc.low64 * kPrime64_1 + acc.high64 * kPrime64_4 + (uint64_t)len * kPrime64_2;
+    return {xxh3Avalanche(low64), 0 - xxh3Avalanche(high64)};
+}
+
+Hash128::Digest hashLen17To128(const uint8_t* input, size_t len, const uint8_t* secret)
+{
+    Hash128::Digest acc = {len * kPrime64_1, 0};
+    if (len > 32)
+    {
+        if (len > 64)
+        {
+            if (len > 96)
+                acc = mix32B(acc, input + 48, input + len - 64, secret + 96);
+            acc = mix32B(acc, input + 32, input + len - 48, secret + 64);
+        }
+        acc = mix32B(acc, input + 16, input + len - 32, secret + 32);
+    }
+    acc = mix32B(acc, input, input + len - 16, secret);
+    return finalizeMidSize(acc, len);
+}
+
+Hash128::Digest hashLen129To240(const uint8_t* input, size_t len, const uint8_t* secret)
+{
+    Hash128::Digest acc = {len * kPrime64_1, 0};
+    for (size_t i = 32; i < 160; i += 32)
+        acc = mix32B(acc, input + i - 32, input + i - 16, secret + i - 32);
+    acc = {xxh3Avalanche(acc.low64), xxh3Avalanche(acc.high64)};
+    for (size_t i = 160; i <= len; i += 32)
+        acc = mix32B(acc, input + i - 32, input + i - 16, secret + kXXHMidSizeStartOffset + i - 160);
+    acc = mix32B(acc, input + len - 16, input + len - 32, secret + kXXHSecretSizeMin - kXXHMidSizeLastOffset - 16);
+    return finalizeMidSize(acc, len);
+}
+
+// Stripe accumulation and scrambling kernels. Each accumulates nbStripes stripes of 64 bytes, advancing the secret by 8
+// bytes per stripe.
+
+void accumulateScalar(uint64_t* acc, const uint8_t* input, const uint8_t* secret, size_t nbStripes)
+{
+    for (size_t n = 0; n < nbStripes; n++, input += kXXHStripeLen, secret += kXXHSecretConsumeRate)
+    {
+        for (size_t lane = 0; lane < 8; lane++)
+        {
+            uint64_t dataVal = readLE64(input + lane * 8);
+            uint64_t dataKey = dataVal ^ readLE64(secret + lane * 8);
+            acc[lane ^ 1] += dataVal;
+            acc[lane] += (dataKey & 0xffffffff) * (dataKey >> 32);
+        }
+    }
+}
+
+void scrambleScalar(uint64_t* acc, const uint8_t* secret)
+{
+    for (size_t lane = 0; lane < 8; lane++)
+    {
+        uint64_t acc64 = xorShift64(acc[lane], 47);
+        acc64 ^= readLE64(secret + lane * 8);
+        acc[lane] = acc64 * kPrime32_1;
+    }
+}
+
+#if FALCOR_HASH_X86
+void accumulateSSE2(uint64_t* acc, const uint8_t* input, const uint8_t* secret, size_t nbStripes)
+{
+    __m128i* xacc = (__m128i*)acc;
+    for (size_t n = 0; n < nbStripes; n++, input += kXXHStripeLen, secret += kXXHSecretConsumeRate)
+    {
+        for (size_t i = 0; i < 4; i++)
+        {
+            __m128i dataVec = _mm_loadu_si128((const __m128i*)input + i);
+            __m128i dataKey = _mm_xor_si128(dataVec, _mm_loadu_si128((const __m128i*)secret + i));
+            __m128i product = _mm_mul_epu32(dataKey, _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1)));
+            __m128i dataSwap = _mm_shuffle_epi32(dataVec, _MM_SHUFFLE(1, 0, 3, 2));
+            xacc[i] = _mm_add_epi64(product, _mm_add_epi64(xacc[i], dataSwap));
+        }
+    }
+}
+
+void scrambleSSE2(uint64_t* acc, const uint8_t* secret)
+{
+    __m128i* xacc = (__m128i*)acc;
+    const __m128i prime32 = _mm_set1_epi32((int)kPrime32_1);
+    for (size_t i = 0; i < 4; i++)
+    {
+        __m128i accVec = xacc[i];
+        __m128i dataVec = _mm_xor_si128(accVec, _mm_srli_epi64(accVec, 47));
+        __m128i dataKey = _mm_xor_si128(dataVec, _mm_loadu_si128((const __m128i*)secret + i));
+        __m128i productLo = _mm_mul_epu32(dataKey, prime32);
+        __m128i productHi = _mm_mul_epu32(_mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1)), prime32);
+        xacc[i] = _mm_add_epi64(productLo, _mm_slli_epi64(productHi, 32));
+    }
+}
+
+FALCOR_HASH_TARGET("avx2")
+void accumulateAVX2(uint64_t* acc, const uint8_t* input, const uint8_t* secret, size_t nbStripes)
+{
+    __m256i* xacc = (__m256i*)acc;
+    for (size_t n = 0; n < nbStripes; n++, input += kXXHStripeLen, secret += kXXHSecretConsumeRate)
+    {
+        for (size_t i = 0; i < 2; i++)
+        {
+            __m256i dataVec = _mm256_loadu_si256((const __m256i*)input + i);
+            __m256i dataKey = _mm256_xor_si256(dataVec, _mm256_loadu_si256((const __m256i*)secret + i));
+            __m256i product = _mm256_mul_epu32(dataKey, _mm256_srli_epi64(dataKey, 32));
+            __m256i dataSwap = _mm256_shuffle_epi32(dataVec, _MM_SHUFFLE(1, 0, 3, 2));
+            xacc[i] = _mm256_add_epi64(product, _mm256_add_epi64(xacc[i], dataSwap));
+        }
+    }
+}
+
+FALCOR_HASH_TARGET("avx2")
+void scrambleAVX2(uint64_t* acc, const uint8_t* secret)
+{
+    __m256i* xacc = (__m256i*)acc;
+    const __m256i prime32 = _mm256_set1_epi32((int)kPrime32_1);
+    for (size_t i = 0; i < 2; i++)
+    {
+        __m256i accVec = _mm256_load_si256(xacc + i);
+        __m256i dataVec = _mm256_xor_si256(accVec, _mm256_srli_epi64(accVec, 47));
+        __m256i dataKey = _mm256_xor_si256(dataVec, _mm256_loadu_si256((const __m256i*)secret + i));
+        __m256i productLo = _mm256_mul_epu32(dataKey, prime32);
+        __m256i productHi = _mm256_mul_epu32(_mm256_srli_epi64(dataKey, 32), prime32);
+        _mm256_store_si256(xacc + i, _mm256_add_epi64(productLo, _mm256_slli_epi64(productHi, 32)));
+    }
+}
+#endif
+
+struct XXHKernels
+{
+    void (*accumulate)(uint64_t* acc, const uint8_t* input, const uint8_t* secret, size_t nbStripes);
+    void (*scramble)(uint64_t* acc, const uint8_t* secret);
+};
+
+XXHKernels getXXHKernels()
+{
+#if FALCOR_HASH_X86
+    if (useAVX2())
+        return {accumulateAVX2, scrambleAVX2};
+    if (gAccelerationEnabled.load(std::memory_order_relaxed))
+        return {accumulateSSE2, scrambleSSE2};
+#endif
+    return {accumulateScalar, scrambleScalar};
+}
+
+Hash128::Digest mergeAccs(const uint64_t* acc, size_t len)
+{
+    auto merge = [acc](const uint8_t* secret, uint64_t start)
+    {
+        uint64_t result = start;
+        for (size_t i = 0; i < 4; i++)
+            result += mul128Fold64(acc[2 * i] ^ readLE64(secret + 16 * i), acc[2 * i + 1] ^ readLE64(secret + 16 * i + 8));
+        return xxh3Avalanche(result);
+    };
+    return {
+        merge(kXXHSecret + kXXHSecretMergeAccsStart, (uint64_t)len * kPrime64_1),
+        merge(kXXHSecret + kXXHSecretSize - 64 - kXXHSecretMergeAccsStart, ~((uint64_t)len * kPrime64_2)),
+    };
+}
+
+Hash128::Digest hashLong(const uint8_t* input, size_t len)
+{
+    const XXHKernels kernels = getXXHKernels();
+    alignas(64) uint64_t acc[8];
+    std::memcpy(acc, kXXHInitAcc, sizeof(acc));
+
+    size_t blockCount = (len - 1) / kXXHBlockLen;
+    for (size_t n = 0; n < blockCount; n++)
+    {
+        kernels.accumulate(acc, input + n * kXXHBlockLen, kXXHSecret, kXXHStripesPerBlock);
+        kernels.scramble(acc, kXXHSecret + kXXHSecretLimit);
+    }
+
+    // Last partial block and the last stripe (which may overlap with already processed data).
+    size_t nbStripes = ((len - 1) - kXXHBlockLen * blockCount) / kXXHStripeLen;
+    kernels.accumulate(acc, input + blockCount * kXXHBlockLen, kXXHSecret, nbStripes);
+    kernels.accumulate(acc, input + len - kXXHStripeLen, kXXHSecret + kXXHSecretLimit - kXXHSecretLastAccStart, 1);
+
+    return mergeAccs(acc, len);
+}
+
+Hash128::Digest hashOneShot(const uint8_t* input, size_t len)
+{
+    if (len <= 16)
+        return hashLen0To16(input, len, kXXHSecret);
+    if (len <= 128)
+        return hashLen17To128(input, len, kXXHSecret);
+    if (len <= kXXHMidSizeMax)
+        return hashLen129To240(input, len, kXXHSecret);
+    return hashLong(input, len);
+}
+
+/**
+ * Accumulate stripes in streaming mode, scrambling the accumulators whenever a block is complete.
+ */
+const uint8_t* consumeStripes(
+    const XXHKernels& kernels,
+    uint64_t* acc,
+    size_t& stripesSoFar,
+    const uint8_t* input,
+    size_t nbStripes
+)
+{
+    while (nbStripes > 0)
+    {
+        size_t count = std::min(nbStripes, kXXHStripesPerBlock - stripesSoFar);
+        kernels.accumulate(acc, input, kXXHSecret + stripesSoFar * kXXHSecretConsumeRate, count);
+        input += count * kXXHStripeLen;
+        nbStripes -= count;
+        stripesSoFar += count;
+        if (stripesSoFar == kXXHStripesPerBlock)
+        {
+            kernels.scramble(acc, kXXHSecret + kXXHSecretLimit);
+            stripesSoFar = 0;
+        }
+    }
+    return input;
+}
+
+Hash128::Digest combineChunkDigests(const std::vector<Hash128::Digest>& digests, uint64_t len, uint64_t chunkSize)
+{
+    Hash128 hash;
+    for (const auto& digest : digests)
+    {
+        hash.update(digest.low64);
+        hash.update(digest.high64);
+    }
+    hash.update(len);
+    hash.update(chunkSize);
+    return hash.finalize();
+}
+} // namespace
+
+bool isHashAccelerationSupported()
+{
+    return getCpuFeatures().sha;
+}
+
+void setHashAccelerationEnabled(bool enabled)
+{
+    gAccelerationEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+// SHA1
+
+SHA1::SHA1() : mIndex(0), mBits(0)
+{
+    mState[0] = 0x67452301;
+    mState[1] = 0xefcdab89;
+    mState[2] = 0x98badcfe;
+    mState[3] = 0x10325476;
+    mState[4] = 0xc3d2e1f0;
+}
+
+void SHA1::update(uint8_t byte)
+{
+    update(&byte, 1);
+}
+
+void SHA1::update(const void* data, size_t len)
+{
+    if (!data)
+        return;
+
+    updateBlocks(
+        mBuf, mIndex, mBits, reinterpret_cast<const uint8_t*>(data), len, [this](const uint8_t* ptr, size_t count) { processBlocks(ptr, count); }
+    );
+}
+
+SHA1::MD SHA1::finalize()
+{
+    finalizeBlocks(mBuf, mIndex, mBits, [this](const uint8_t* ptr, size_t count) { processBlocks(ptr, count); });
+
+    MD md;
+    for (int i = 0; i < 5; i++)
+    {
+        for (int j = 3; j >= 0; j--)
+        {
+            md[i * 4 + j] = (mState[i] >> ((3 - j) * 8)) & 0xff;
+        }
+    }
+
+    return md;
+}
+
+SHA1::MD SHA1::compute(const void* data, size_t len)
+{
+    SHA1 sha1;
+    sha1.update(data, len);
+    return sha1.finalize();
+}
+
+std::string SHA1::toString(const SHA1::MD& sha1)
+{
+    return toHexString(sha1);
+}
+
+void SHA1::processBlocks(const uint8_t* ptr, size_t blockCount)
+{
+#if FALCOR_HASH_X86
+    if (useSHAExtensions())
+        return sha1BlocksSHAExt(mState, ptr, blockCount);
+#endif
+    for (size_t i = 0; i < blockCount; i++)
+        sha1BlockPortable(mState, ptr + i * 64);
+}
+
+// SHA256
+
+SHA256::SHA256() : mIndex(0), mBits(0)
+{
+    mState[0] = 0x6a09e667;
+    mState[1] = 0xbb67ae85;
+    mState[2] = 0x3c6ef372;
+    mState[3] = 0xa54ff53a;
+    mState[4] = 0x510e527f;
+    mState[5] = 0x9b05688c;
+    mState[6] = 0x1f83d9ab;
+    mState[7] = 0x5be0cd19;
+}
+
+void SHA256::update(const void* data, size_t len)
+{
+    if (!data)
+        return;
+
+    updateBlocks(
+        mBuf, mIndex, mBits, reinterpret_cast<const uint8_t*>(data), len, [this](const uint8_t* ptr, size_t count) { processBlocks(ptr, count); }
+    );
+}
+
+SHA256::MD SHA256::finalize()
+{
+    finalizeBlocks(mBuf, mIndex, mBits, [this](const uint8_t* ptr, size_t count) { processBlocks(ptr, count); });
+
+    MD md;
+    for (int i = 0; i < 8; i++)
+    {
+        for (int j = 3; j >= 0; j--)
+        {
+            md[i * 4 + j] = (mState[i] >> ((3 - j) * 8)) & 0xff;
+        }
+    }
+
+    return md;
+}
+
+SHA256::MD SHA256::compute(const void* data, size_t len)
+{
+    SHA256 sha256;
+    sha256.update(data, len);
+    return sha256.finalize();
+}
+
+std::string SHA256::toString(const SHA256::MD& sha256)
+{
+    return toHexString(sha256);
+}
+
+void SHA256::processBlocks(const uint8_t* ptr, size_t blockCount)
+{
+#if FALCOR_HASH_X86
+    if (useSHAExtensions())
+        return sha256BlocksSHAExt(mState, ptr, blockCount);
+#endif
+    for (size_t i = 0; i < blockCount; i++)
+        sha256BlockPortable(mState, ptr + i * 64);
+}
+
+// Hash128
+
+Hash128::Hash128()
+{
+    reset();
+}
+
+void Hash128::reset()
+{
+    std::memcpy(mAcc, kXXHInitAcc, sizeof(mAcc));
+    mBufferedSize = 0;
+    mStripesSoFar = 0;
+    mTotalLen = 0;
+}
+
+void Hash128::update(const void* data, size_t len)
+{
+    if (!data || len == 0)
+        return;
+
+    const uint8_t* input = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* const end = input + len;
+    mTotalLen += len;
+
+    // Buffer small inputs. Note that at least one byte is always kept in the buffer, so that the last stripe is processed in finalize().
+    if (len <= kBufferSize - mBufferedSize)
+    {
+        std::memcpy(mBuffer + mBufferedSize, input, len);
+        mBufferedSize += len;
+        return;
+    }
+
+    const XXHKernels kernels = getXXHKernels();
+    constexpr size_t kBufferStripes = kBufferSize / kXXHStripeLen;
+
+    if (mBufferedSize > 0)
+    {
+        size_t loadSize = kBufferSize - mBufferedSize;
+        std::memcpy(mBuffer + mBufferedSize, input, loadSize);
+        input += loadSize;
+        consumeStripes(kernels, mAcc, mStripesSoFar, mBuffer, kBufferStripes);
+        mBufferedSize = 0;
+    }
+
+    // Consume large inputs directly. The last stripe is kept in the end of the buffer as it is needed in finalize() if less than a
+    // stripe is buffered.
+    if ((size_t)(end - input) > kBufferSize)
+    {
+        size_t nbStripes = (size_t)(end - 1 - input) / kXXHStripeLen;
+        input = consumeStripes(kernels, mAcc, mStripesSoFar, input, nbStripes);
+        std::memcpy(mBuffer + kBufferSize - kXXHStripeLen, input - kXXHStripeLen, kXXHStripeLen);
+    }
+
+    std::memcpy(mBuffer, input, (size_t)(end - input));
+    mBufferedSize = (size_t)(end - input);
+}
+
+Hash128::Digest Hash128::finalize() const
+{
+    if (mTotalLen <= kXXHMidSizeMax)
+        return hashOneShot(mBuffer, (size_t)mTotalLen);
+
+    const XXHKernels kernels = getXXHKernels();
+    alignas(64) uint64_t acc[8];
+    std::memcpy(acc, mAcc, sizeof(acc));
+
+    uint8_t lastStripe[kXXHStripeLen];
+    const uint8_t* lastStripePtr;
+    if (mBufferedSize >= kXXHStripeLen)
+    {
+        size_t stripesSoFar = mStripesSoFar;
+        consumeStripes(kernels, acc, stripesSoFar, mBuffer, (mBufferedSize - 1) / kXXHStripeLen);
+        lastStripePtr = mBuffer + mBufferedSize - kXXHStripeLen;
+    }
+    else
+    {
+        // Assemble the last stripe from the end of the previously consumed data and the buffered bytes.
+        size_t catchupSize = kXXHStripeLen - mBufferedSize;
+        std::memcpy(lastStripe, mBuffer + kBufferSize - catchupSize, catchupSize);
+        std::memcpy(lastStripe + catchupSize, mBuffer, mBufferedSize);
+        lastStripePtr = lastStripe;
+    }
+    kernels.accumulate(acc, lastStripePtr, kXXHSecret + kXXHSecretLimit - kXXHSecretLastAccStart, 1);
+
+    return mergeAccs(acc, (size_t)mTotalLen);
+}
+
+Hash128::Digest Hash128::compute(const void* data, size_t len)
+{
+    if (!data)
+        len = 0;
+    return hashOneShot(reinterpret_cast<const uint8_t*>(data), len);
+}
+
+Hash128::Digest Hash128::computeTree(const void* data, size_t len, size_t chunkSize)
+{
+    FALCOR_CHECK(chunkSize > 0, "Chunk size must be non-zero.");
+    if (!data)
+        len = 0;
+
+    const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data);
+    std::vector<Digest> digests((len + chunkSize - 1) / chunkSize);
+    Threading::parallelFor(
+        0,
+        digests.size(),
+        [&](size_t i) { digests[i] = compute(ptr + i * chunkSize, std::min(chunkSize, len - i * chunkSize)); },
+        1
+    );
+
+    return combineChunkDigests(digests, len, chunkSize);
+}
+
+Hash128::Digest Hash128::computeFile(const std::filesystem::path& path, size_t chunkSize)
+{
+    FALCOR_CHECK(chunkSize > 0, "Chunk size must be non-zero.");
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        FALCOR_THROW("Failed to open file '{}'.", path);
+
+    // Read batches of chunks into two alternating buffers. While the chunks of one batch are hashed in parallel on the
+    // task scheduler, the next batch is read on the calling thread.
+    constexpr size_t kMaxBatchSize = 256 * 1024 * 1024;
+    const size_t batchChunks = std::clamp<size_t>(2 * Threading::getThreadCount(), 1, std::max<size_t>(1, kMaxBatchSize / chunkSize));
+    std::vector<uint8_t> buffers[2];
+
+    std::vector<Digest> digests;
+    uint64_t len = 0;
+    Threading::Task hashTask;
+
+    for (size_t batch = 0;; batch++)
+    {
+        std::vector<uint8_t>& buffer = buffers[batch % 2];
+        buffer.resize(batchChunks * chunkSize);
+        file.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+        if (file.bad())
+        {
+            hashTask.finish();
+            FALCOR_THROW("Failed to read file '{}'.", path);
+        }
+        const size_t readSize = (size_t)file.gcount();
+        if (readSize == 0)
+            break;
+
+        // The buffer of the previous batch is reused in the next iteration, so wait for its hashing to finish first.
+        hashTask.finish();
+
+        const size_t firstChunk = digests.size();
+        const size_t chunkCount = (readSize + chunkSize - 1) / chunkSize;
+        digests.resize(firstChunk + chunkCount);
+        len += readSize;
+
+        hashTask = Threading::dispatchTask(
+            [&digests, &buffer, firstChunk, chunkCount, readSize, chunkSize]()
+            {
+                Threading::parallelFor(
+                    0,
+                    chunkCount,
+                    [&](size_t i)
+                    {
+                        size_t offset = i * chunkSize;
+                        digests[firstChunk + i] = compute(buffer.data() + offset, std::min(chunkSize, readSize - offset));
+                    },
+                    1
+                );
+            }
+        );
+
+        if (readSize < buffer.size())
+            break;
+    }
+    hashTask.finish();
+
+    return combineChunkDigests(digests, len, chunkSize);
+}
+
+std::string Hash128::toString(const Digest& digest)
+{
+    std::array<uint8_t, 16> bytes;
+    for (int i = 0; i < 8; i++)
+    {
+        bytes[i] = (uint8_t)(digest.high64 >> ((7 - i) * 8));
+        bytes[8 + i] = (uint8_t)(digest.low64 >> ((7 - i) * 8));
+    }
+    return toHexString(bytes);
 }
 } // namespace Falcor
@@ -28,14 +28,29 @@
 #pragma once
 #include "Core/Macros.h"
 #include <array>
+#include <filesystem>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <cstdint>
 #include <cstdlib>
 
 namespace Falcor
 {
+/**
+ * Returns true if the CPU supports the instructions used by the accelerated hash paths (SHA extensions for SHA-1/SHA-256).
+ */
+FALCOR_API bool isHashAccelerationSupported();
+
+/**
+ * Enable/disable the accelerated hash paths (SHA extensions, AVX2).
+ * Enabled by default. This is mainly used for testing and benchmarking the portable fallbacks.
+ */
+FALCOR_API void setHashAccelerationEnabled(bool enabled);
+
 /**
  * Helper to compute SHA-1 hash.
+ * Uses the x86 SHA extensions if available.
  */
 class FALCOR_API SHA1
 {
@@ -92,12 +107,174 @@ public:
     static std::string toString(const MD& sha1);
 
 private:
-    void addByte(uint8_t x);
-    void processBlock(const uint8_t* ptr);
+    void processBlocks(const uint8_t* ptr, size_t blockCount);
 
     uint32_t mIndex;
     uint64_t mBits;
     uint32_t mState[5];
     uint8_t mBuf[64];
 };
+
+/**
+ * Helper to compute SHA-256 hash.
+ * Uses the x86 SHA extensions if available.
+ */
+class FALCOR_API SHA256
+{
+public:
+    using MD = std::array<uint8_t, 32>; ///< Message digest.
+
+    SHA256();
+
+    /**
+     * Update hash by adding the given data.
+     * @param[in] data Data to hash.
+     * @param[in] len Length of data in bytes.
+     */
+    void update(const void* data, size_t len);
+
+    /**
+     * Update hash by adding one value of fundamental type T.
+     * @param[in] Value to hash.
+     */
+    template<typename T, std::enable_if_t<std::is_fundamental<T>::value, bool> = true>
+    void update(const T& value)
+    {
+        update(&value, sizeof(value));
+    }
+
+    /**
+     * Update hash by adding the given string view.
+     */
+    void update(const std::string_view str) { update(str.data(), str.size()); }
+
+    /**
+     * Return final message digest.
+     * @return Returns the SHA-256 message digest.
+     */
+    MD finalize();
+
+    /**
+     * Compute SHA-256 hash over the given data.
+     * @param[in] data Data to hash.
+     * @param[in] len Length of data in bytes.
+     * @return Returns the SHA-256 message digest.
+     */
+    static MD compute(const void* data, size_t len);
+
+    /**
+     * Convert SHA-256 hash to 64-character string in hexadecimal notation.
+     */
+    static std::string toString(const MD& sha256);
+
+private:
+    void processBlocks(const uint8_t* ptr, size_t blockCount);
+
+    uint32_t mIndex;
+    uint64_t mBits;
+    uint32_t mState[8];
+    uint8_t mBuf[64];
+};
+
+/**
+ * Helper to compute a fast non-cryptographic 128-bit hash.
+ * The hash is bit-exact with XXH3-128 (default secret, seed 0), i.e. it matches the output of XXH3_128bits().
+ * Large inputs are processed with SSE2/AVX2 if available.
+ *
+ * In addition to the streaming interface, a tree hash mode is provided for hashing large inputs on multiple threads.
+ * The input is split into fixed size chunks, each chunk is hashed separately and the final digest is the hash over
+ * the chunk digests. The tree hash depends on the chunk size and is different from the streaming hash of the same data.
+ */
+class FALCOR_API Hash128
+{
+public:
+    struct Digest
+    {
+        uint64_t low64 = 0;
+        uint64_t high64 = 0;
+
+        bool operator==(const Digest& other) const { return low64 == other.low64 && high64 == other.high64; }
+        bool operator!=(const Digest& other) const { return !(*this == other); }
+    };
+
+    /// Default chunk size used in tree hash mode.
+    static constexpr size_t kDefaultChunkSize = 4 * 1024 * 1024;
+
+    Hash128();
+
+    /**
+     * Reset hash to the initial state.
+     */
+    void reset();
+
+    /**
+     * Update hash by adding the given data.
+     * @param[in] data Data to hash.
+     * @param[in] len Length of data in bytes.
+     */
+    void update(const void* data, size_t len);
+
+    /**
+     * Update hash by adding one value of fundamental type T.
+     * @param[in] Value to hash.
+     */
+    template<typename T, std::enable_if_t<std::is_fundamental<T>::value, bool> = true>
+    void update(const T& value)
+    {
+        update(&value, sizeof(value));
+    }
+
+    /**
+     * Update hash by adding the given string view.
+     */
+    void update(const std::string_view str) { update(str.data(), str.size()); }
+
+    /**
+     * Return final digest. The hash state is not modified, so more data can be added afterwards.
+     * @return Returns the 128-bit digest.
+     */
+    Digest finalize() const;
+
+    /**
+     * Compute hash over the given data.
+     * @param[in] data Data to hash.
+     * @param[in] len Length of data in bytes.
+     * @return Returns the 128-bit digest.
+     */
+    static Digest compute(const void* data, size_t len);
+
+    /**
+     * Compute tree hash over the given data. Chunks are hashed in parallel on the global task scheduler.
+     * @param[in] data Data to hash.
+     * @param[in] len Length of data in bytes.
+     * @param[in] chunkSize Chunk size in bytes (must be non-zero).
+     * @return Returns the 128-bit digest.
+     */
+    static Digest computeTree(const void* data, size_t len, size_t chunkSize = kDefaultChunkSize);
+
+    /**
+     * Compute tree hash over the content of a file.
+     * The file is read sequentially and chunks are hashed in parallel while the next batch of chunks is read.
+     * The result is identical to computeTree() over the file content with the same chunk size.
+     * Throws if the file cannot be read.
+     * @param[in] path File path.
+     * @param[in] chunkSize Chunk size in bytes (must be non-zero).
+     * @return Returns the 128-bit digest.
+     */
+    static Digest computeFile(const std::filesystem::path& path, size_t chunkSize = kDefaultChunkSize);
+
+    /**
+     * Convert digest to 32-character string in hexadecimal notation (canonical big-endian representation).
+     */
+    static std::string toString(const Digest& digest);
+
+private:
+    static constexpr size_t kBufferSize = 256;
+
+    alignas(64) uint64_t mAcc[8];
+    alignas(64) uint8_t mBuffer[kBufferSize];
+    size_t mBufferedSize;
+    size_t mStripesSoFar;
+    uint64_t mTotalLen;
+};
 }; // namespace Falcor
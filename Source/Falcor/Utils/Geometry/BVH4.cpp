@@ -0,0 +1,286 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BVH4.h"
+#include "Core/Error.h"
+#include <numeric>
+
+namespace Falcor
+{
+namespace
+{
+BVH4::Node createEmptyNode()
+{
+    BVH4::Node node = {};
+    std::fill(std::begin(node.childIndex), std::end(node.childIndex), BVH4::kInvalidIndex);
+    return node;
+}
+
+void setChild(BVH4::Node& node, uint32_t slot, const AABB& bounds, uint32_t index, uint32_t primitiveCount)
+{
+    node.minX[slot] = bounds.minPoint.x;
+    node.minY[slot] = bounds.minPoint.y;
+    node.minZ[slot] = bounds.minPoint.z;
+    node.maxX[slot] = bounds.maxPoint.x;
+    node.maxY[slot] = bounds.maxPoint.y;
+    node.maxZ[slot] = bounds.maxPoint.z;
+    node.childIndex[slot] = index;
+    node.primitiveCount[slot] = primitiveCount;
+}
+} // namespace
+
+void BVH4::build(const std::vector<AABB>& primitiveBounds)
+{
+    FALCOR_CHECK(primitiveBounds.size() < kInvalidIndex, "Too many primitives ({}).", primitiveBounds.size());
+
+    clear();
+
+    std::vector<float3> centroids(primitiveBounds.size());
+    for (uint32_t i = 0; i < (uint32_t)primitiveBounds.size(); i++)
+    {
+        if (!primitiveBounds[i].valid())
+            continue;
+        mPrimitiveIndices.push_back(i);
+        centroids[i] = primitiveBounds[i].center();
+        mBounds.include(primitiveBounds[i]);
+    }
+
+    if (mPrimitiveIndices.empty())
+        return;
+
+    std::vector<BuildNode> buildNodes;
+    buildNodes.reserve(2 * mPrimitiveIndices.size());
+    buildRecursive(buildNodes, primitiveBounds, centroids, 0, (uint32_t)mPrimitiveIndices.size(), 0);
+
+    // Compute the SAH cost with unit traversal and intersection costs.
+    float rootArea = buildNodes[0].bounds.area();
+    if (rootArea > 0.f)
+    {
+        for (const auto& node : buildNodes)
+            mStats.sahCost += node.bounds.area() / rootArea * (node.count > 0 ? (float)node.count : 1.f);
+    }
+
+    // Collapse the binary tree into 4-wide nodes.
+    if (buildNodes[0].count > 0)
+    {
+        Node root = createEmptyNode();
+        setChild(root, 0, buildNodes[0].bounds, buildNodes[0].first, buildNodes[0].count);
+        mNodes.push_back(root);
+        mStats.leafCount = 1;
+        mStats.maxLeafSize = buildNodes[0].count;
+    }
+    else
+    {
+        mNodes.reserve(buildNodes.size() / 2);
+        collapse(buildNodes, 0, 1);
+    }
+    mStats.nodeCount = (uint32_t)mNodes.size();
+}
+
+void BVH4::clear()
+{
+    mNodes.clear();
+    mPrimitiveIndices.clear();
+    mBounds.invalidate();
+    mStats = {};
+}
+
+uint32_t BVH4::buildRecursive(
+    std::vector<BuildNode>& buildNodes,
+    const std::vector<AABB>& primitiveBounds,
+    const std::vector<float3>& centroids,
+    uint32_t begin,
+    uint32_t end,
+    uint32_t depth
+)
+{
+    uint32_t nodeIndex = (uint32_t)buildNodes.size();
+    buildNodes.emplace_back();
+
+    AABB bounds;
+    AABB centroidBounds;
+    for (uint32_t i = begin; i < end; i++)
+    {
+        bounds.include(primitiveBounds[mPrimitiveIndices[i]]);
+        centroidBounds.include(centroids[mPrimitiveIndices[i]]);
+    }
+    buildNodes[nodeIndex].bounds = bounds;
+
+    const uint32_t count = end - begin;
+    auto makeLeaf = [&]()
+    {
+        buildNodes[nodeIndex].first = begin;
+        buildNodes[nodeIndex].count = count;
+        return nodeIndex;
+    };
+
+    if (count <= 1 || depth + 1 >= kMaxDepth)
+        return makeLeaf();
+
+    const float3 extent = centroidBounds.extent();
+    auto getBin = [&](uint32_t axis, uint32_t primitiveIndex)
+    {
+        float scale = (float)kBinCount / extent[axis];
+        uint32_t bin = (uint32_t)((centroids[primitiveIndex][axis] - centroidBounds.minPoint[axis]) * scale);
+        return std::min(bin, kBinCount - 1);
+    };
+
+    // Find the best split plane over all axes using binned SAH.
+    float bestCost = std::numeric_limits<float>::infinity();
+    uint32_t bestAxis = kInvalidIndex;
+    uint32_t bestBin = 0;
+    for (uint32_t axis = 0; axis < 3; axis++)
+    {
+        if (!(extent[axis] > 0.f))
+            continue;
+
+        AABB binBounds[kBinCount];
+        uint32_t binCounts[kBinCount] = {};
+        for (uint32_t i = begin; i < end; i++)
+        {
+            uint32_t bin = getBin(axis, mPrimitiveIndices[i]);
+            binBounds[bin].include(primitiveBounds[mPrimitiveIndices[i]]);
+            binCounts[bin]++;
+        }
+
+        // Sweep from the right to get the area and count to the right of each split plane.
+        float rightArea[kBinCount] = {};
+        uint32_t rightCount[kBinCount] = {};
+        AABB accumulated;
+        uint32_t accumulatedCount = 0;
+        for (uint32_t b = kBinCount - 1; b > 0; b--)
+        {
+            accumulated.include(binBounds[b]);
+            accumulatedCount += binCounts[b];
+            rightArea[b] = accumulatedCount > 0 ? accumulated.area() : 0.f;
+            rightCount[b] = accumulatedCount;
+        }
+
+        // Sweep from the left and evaluate the split planes between bins.
+        accumulated.invalidate();
+        accumulatedCount = 0;
+        for (uint32_t b = 1; b < kBinCount; b++)
+        {
+            accumulated.include(binBounds[b - 1]);
+            accumulatedCount += binCounts[b - 1];
+            if (accumulatedCount == 0 || rightCount[b] == 0)
+                continue;
+            float cost = accumulated.area() * accumulatedCount + rightArea[b] * rightCount[b];
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBin = b;
+            }
+        }
+    }
+
+    uint32_t mid;
+    if (bestAxis == kInvalidIndex)
+    {
+        // All centroids coincide. Split in the middle to keep the leaves small.
+        if (count <= kMaxLeafSize)
+            return makeLeaf();
+        mid = begin + count / 2;
+    }
+    else
+    {
+        // Compare with the cost of a leaf, using unit traversal and intersection costs.
+        float area = bounds.area();
+        float splitCost = area > 0.f ? 1.f + bestCost / area : (float)count;
+        if (count <= kMaxLeafSize && splitCost >= (float)count)
+            return makeLeaf();
+
+        auto it = std::partition(
+            mPrimitiveIndices.begin() + begin,
+            mPrimitiveIndices.begin() + end,
+            [&](uint32_t primitiveIndex) { return getBin(bestAxis, primitiveIndex) < bestBin; }
+        );
+        mid = (uint32_t)(it - mPrimitiveIndices.begin());
+    }
+    FALCOR_ASSERT(mid > begin && mid < end);
+
+    uint32_t left = buildRecursive(buildNodes, primitiveBounds, centroids, begin, mid, depth + 1);
+    uint32_t right = buildRecursive(buildNodes, primitiveBounds, centroids, mid, end, depth + 1);
+    buildNodes[nodeIndex].children[0] = left;
+    buildNodes[nodeIndex].children[1] = right;
+    return nodeIndex;
+}
+
+uint32_t BVH4::collapse(const std::vector<BuildNode>& buildNodes, uint32_t buildNodeIndex, uint32_t depth)
+{
+    const BuildNode& buildNode = buildNodes[buildNodeIndex];
+    FALCOR_ASSERT(buildNode.count == 0);
+
+    // Gather up to four children by repeatedly opening the internal child with the largest surface area.
+    uint32_t children[kWidth] = {buildNode.children[0], buildNode.children[1]};
+    uint32_t childCount = 2;
+    while (childCount < kWidth)
+    {
+        uint32_t bestChild = kInvalidIndex;
+        float bestArea = -1.f;
+        for (uint32_t c = 0; c < childCount; c++)
+        {
+            const BuildNode& child = buildNodes[children[c]];
+            if (child.count == 0 && child.bounds.area() > bestArea)
+            {
+                bestChild = c;
+                bestArea = child.bounds.area();
+            }
+        }
+        if (bestChild == kInvalidIndex)
+            break;
+
+        const BuildNode& opened = buildNodes[children[bestChild]];
+        children[bestChild] = opened.children[0];
+        children[childCount++] = opened.children[1];
+    }
+
+    uint32_t nodeIndex = (uint32_t)mNodes.size();
+    mNodes.push_back(createEmptyNode());
+    mStats.maxDepth = std::max(mStats.maxDepth, depth);
+
+    for (uint32_t c = 0; c < childCount; c++)
+    {
+        const BuildNode& child = buildNodes[children[c]];
+        uint32_t index = child.first;
+        if (child.count == 0)
+        {
+            index = collapse(buildNodes, children[c], depth + 1);
+        }
+        else
+        {
+            mStats.leafCount++;
+            mStats.maxLeafSize = std::max(mStats.maxLeafSize, child.count);
+        }
+        // Note that mNodes may have been reallocated by the recursion.
+        setChild(mNodes[nodeIndex], c, child.bounds, index, child.count);
+    }
+
+    return nodeIndex;
+}
+} // namespace Falcor
@@ -0,0 +1,293 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/AABB.h"
+#include "Utils/Math/Ray.h"
+#include "Utils/Math/Vector.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Four-wide bounding volume hierarchy over axis-aligned bounding boxes, built and traversed on the CPU.
+ *
+ * The hierarchy is built top-down with binned SAH into a binary tree, which is then collapsed into
+ * nodes with up to four children. The child bounds of a node are stored as structure-of-arrays, so a
+ * ray is tested against all children of a node in a single loop that the compiler can vectorize.
+ *
+ * The BVH only stores the order of the primitives in its leaves. Primitive data and intersection tests
+ * are provided through the callback passed to traverse(), see TriangleBVH for an example.
+ */
+class FALCOR_API BVH4
+{
+public:
+    static constexpr uint32_t kWidth = 4;        ///< Maximum number of children per node.
+    static constexpr uint32_t kBinCount = 16;    ///< Number of bins used for SAH evaluation.
+    static constexpr uint32_t kMaxLeafSize = 8;  ///< Leaves with more primitives are always split if possible.
+    static constexpr uint32_t kMaxDepth = 64;    ///< Maximum depth of the binary tree, deeper nodes are made leaves.
+    static constexpr uint32_t kInvalidIndex = 0xffffffff;
+
+    struct Node
+    {
+        float minX[kWidth];
+        float minY[kWidth];
+        float minZ[kWidth];
+        float maxX[kWidth];
+        float maxY[kWidth];
+        float maxZ[kWidth];
+        /// Node index of internal children, offset of the first primitive for leaves, or kInvalidIndex for unused slots.
+        uint32_t childIndex[kWidth];
+        /// Number of primitives for leaves, zero for internal children.
+        uint32_t primitiveCount[kWidth];
+    };
+
+    struct Stats
+    {
+        uint32_t nodeCount = 0;      ///< Number of 4-wide nodes.
+        uint32_t leafCount = 0;      ///< Number of leaves.
+        uint32_t maxDepth = 0;       ///< Maximum depth of the 4-wide tree.
+        uint32_t maxLeafSize = 0;    ///< Largest number of primitives in a leaf.
+        float sahCost = 0.f;         ///< SAH cost of the binary tree, relative to the root bounds.
+    };
+
+    /**
+     * Build the hierarchy.
+     * @param[in] primitiveBounds Bounding box of each primitive. Invalid boxes are excluded from the hierarchy.
+     */
+    void build(const std::vector<AABB>& primitiveBounds);
+
+    /**
+     * Remove all nodes.
+     */
+    void clear();
+
+    bool empty() const { return mNodes.empty(); }
+
+    /**
+     * Get the bounds of all primitives in the hierarchy.
+     */
+    const AABB& getBounds() const { return mBounds; }
+
+    /**
+     * Get the primitive indices in leaf order.
+     * Leaves reference ranges in this list, and traverse() reports positions in this list.
+     */
+    const std::vector<uint32_t>& getPrimitiveIndices() const { return mPrimitiveIndices; }
+
+    const std::vector<Node>& getNodes() const { return mNodes; }
+
+    const Stats& getStats() const { return mStats; }
+
+    /**
+     * Traverse the hierarchy with a ray, visiting children in approximate front-to-back order.
+     * @param[in] ray Ray. Only nodes that overlap the interval [ray.tMin, tMax] are visited.
+     * @param[in,out] tMax Maximum distance along the ray. The callback shrinks it when it finds a closer hit.
+     * @param[in] intersect Callback `bool(uint32_t primitiveOffset, float& tMax)` called for each primitive in the visited leaves.
+     *            The offset is the position in leaf order (see getPrimitiveIndices()). Return true to stop traversal.
+     * @return True if traversal was stopped by the callback.
+     */
+    template<typename IntersectFunc>
+    bool traverse(const Ray& ray, float& tMax, IntersectFunc&& intersect) const
+    {
+        if (mNodes.empty())
+            return false;
+
+        // Avoid infinities in the inverse direction, which produce NaNs when the origin lies on a slab plane.
+        float3 invDir;
+        for (int i = 0; i < 3; i++)
+            invDir[i] = 1.f / (std::abs(ray.dir[i]) > 1e-30f ? ray.dir[i] : std::copysign(1e-30f, ray.dir[i]));
+
+        uint32_t stack[kStackSize];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0)
+        {
+            const Node& node = mNodes[stack[--stackSize]];
+
+            float tEntry[kWidth];
+            bool hit[kWidth];
+            for (uint32_t i = 0; i < kWidth; i++)
+            {
+                float tx0 = (node.minX[i] - ray.origin.x) * invDir.x;
+                float tx1 = (node.maxX[i] - ray.origin.x) * invDir.x;
+                float ty0 = (node.minY[i] - ray.origin.y) * invDir.y;
+                float ty1 = (node.maxY[i] - ray.origin.y) * invDir.y;
+                float tz0 = (node.minZ[i] - ray.origin.z) * invDir.z;
+                float tz1 = (node.maxZ[i] - ray.origin.z) * invDir.z;
+                float tNear = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), std::max(std::min(tz0, tz1), ray.tMin));
+                float tFar = std::min(std::min(std::max(tx0, tx1), std::max(ty0, ty1)), std::min(std::max(tz0, tz1), tMax));
+                tEntry[i] = tNear;
+                hit[i] = tNear <= tFar;
+            }
+
+            // Intersect leaves right away, and push internal children sorted so that the nearest is popped first.
+            uint32_t order[kWidth];
+            uint32_t orderCount = 0;
+            for (uint32_t i = 0; i < kWidth; i++)
+            {
+                if (node.childIndex[i] == kInvalidIndex || !hit[i] || tEntry[i] > tMax)
+                    continue;
+
+                if (node.primitiveCount[i] > 0)
+                {
+                    for (uint32_t j = 0; j < node.primitiveCount[i]; j++)
+                    {
+                        if (intersect(node.childIndex[i] + j, tMax))
+                            return true;
+                    }
+                }
+                else
+                {
+                    uint32_t k = orderCount++;
+                    while (k > 0 && tEntry[order[k - 1]] < tEntry[i])
+                    {
+                        order[k] = order[k - 1];
+                        k--;
+                    }
+                    order[k] = i;
+                }
+            }
+
+            for (uint32_t k = 0; k < orderCount; k++)
+            {
+                uint32_t i = order[k];
+                if (tEntry[i] <= tMax)
+                    stack[stackSize++] = node.childIndex[i];
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Traverse the hierarchy with a point, visiting children in order of increasing distance.
+     * @param[in] point Query point.
+     * @param[in,out] maxDistanceSq Maximum squared distance from the point. The callback shrinks it when it finds a closer primitive.
+     * @param[in] visit Callback `void(uint32_t primitiveOffset, float& maxDistanceSq)` called for each primitive in the visited leaves.
+     *            The offset is the position in leaf order (see getPrimitiveIndices()).
+     */
+    template<typename VisitFunc>
+    void traverseNearest(const float3& point, float& maxDistanceSq, VisitFunc&& visit) const
+    {
+        if (mNodes.empty())
+            return;
+
+        uint32_t stack[kStackSize];
+        float stackDistanceSq[kStackSize];
+        uint32_t stackSize = 0;
+        stack[stackSize] = 0;
+        stackDistanceSq[stackSize++] = 0.f;
+
+        while (stackSize > 0)
+        {
+            --stackSize;
+            if (stackDistanceSq[stackSize] > maxDistanceSq)
+                continue;
+            const Node& node = mNodes[stack[stackSize]];
+
+            float distanceSq[kWidth];
+            for (uint32_t i = 0; i < kWidth; i++)
+            {
+                float dx = std::max(std::max(node.minX[i] - point.x, point.x - node.maxX[i]), 0.f);
+                float dy = std::max(std::max(node.minY[i] - point.y, point.y - node.maxY[i]), 0.f);
+                float dz = std::max(std::max(node.minZ[i] - point.z, point.z - node.maxZ[i]), 0.f);
+                distanceSq[i] = dx * dx + dy * dy + dz * dz;
+            }
+
+            // Sort the children by distance, nearest first.
+            uint32_t order[kWidth];
+            uint32_t orderCount = 0;
+            for (uint32_t i = 0; i < kWidth; i++)
+            {
+                if (node.childIndex[i] == kInvalidIndex || distanceSq[i] > maxDistanceSq)
+                    continue;
+                uint32_t k = orderCount++;
+                while (k > 0 && distanceSq[order[k - 1]] > distanceSq[i])
+                {
+                    order[k] = order[k - 1];
+                    k--;
+                }
+                order[k] = i;
+            }
+
+            // Visit leaves right away, and push internal children so that the nearest is popped first.
+            for (uint32_t k = 0; k < orderCount; k++)
+            {
+                uint32_t i = order[k];
+                if (node.primitiveCount[i] > 0 && distanceSq[i] <= maxDistanceSq)
+                {
+                    for (uint32_t j = 0; j < node.primitiveCount[i]; j++)
+                        visit(node.childIndex[i] + j, maxDistanceSq);
+                }
+            }
+            for (uint32_t k = orderCount; k > 0; k--)
+            {
+                uint32_t i = order[k - 1];
+                if (node.primitiveCount[i] == 0)
+                {
+                    stack[stackSize] = node.childIndex[i];
+                    stackDistanceSq[stackSize++] = distanceSq[i];
+                }
+            }
+        }
+    }
+
+private:
+    /// Each level of the 4-wide tree pushes at most kWidth - 1 entries that are not popped immediately.
+    static constexpr uint32_t kStackSize = kMaxDepth * (kWidth - 1) + 1;
+
+    struct BuildNode
+    {
+        AABB bounds;
+        uint32_t children[2] = {kInvalidIndex, kInvalidIndex};
+        uint32_t first = 0;
+        uint32_t count = 0; ///< Number of primitives for leaves, zero for internal nodes.
+    };
+
+    uint32_t buildRecursive(
+        std::vector<BuildNode>& buildNodes,
+        const std::vector<AABB>& primitiveBounds,
+        const std::vector<float3>& centroids,
+        uint32_t begin,
+        uint32_t end,
+        uint32_t depth
+    );
+    uint32_t collapse(const std::vector<BuildNode>& buildNodes, uint32_t buildNodeIndex, uint32_t depth);
+
+    std::vector<Node> mNodes;
+    std::vector<uint32_t> mPrimitiveIndices;
+    AABB mBounds;
+    Stats mStats;
+};
+} // namespace Falcor
@@ -0,0 +1,162 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TriangleBVH.h"
+#include "Core/Error.h"
+#include "Utils/Threading.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+void TriangleBVH::build(fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+{
+    FALCOR_CHECK(indices.size() % 3 == 0, "Index count ({}) must be a multiple of 3.", indices.size());
+
+    const size_t triangleCount = indices.size() / 3;
+    std::vector<AABB> bounds(triangleCount);
+    for (size_t i = 0; i < triangleCount; i++)
+    {
+        for (size_t j = 0; j < 3; j++)
+        {
+            uint32_t index = indices[3 * i + j];
+            FALCOR_CHECK(index < positions.size(), "Vertex index {} is out of range.", index);
+            bounds[i].include(positions[index]);
+        }
+    }
+
+    mBVH.build(bounds);
+
+    // Store the triangles in leaf order so that the triangles of a leaf are contiguous in memory.
+    const auto& order = mBVH.getPrimitiveIndices();
+    mV0.resize(order.size());
+    mEdge1.resize(order.size());
+    mEdge2.resize(order.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        const uint32_t* pIndices = &indices[3 * (size_t)order[i]];
+        mV0[i] = positions[pIndices[0]];
+        mEdge1[i] = positions[pIndices[1]] - mV0[i];
+        mEdge2[i] = positions[pIndices[2]] - mV0[i];
+    }
+}
+
+void TriangleBVH::clear()
+{
+    mBVH.clear();
+    mV0.clear();
+    mEdge1.clear();
+    mEdge2.clear();
+}
+
+TriangleBVH::Hit TriangleBVH::intersectClosest(const Ray& ray) const
+{
+    Hit hit;
+    float tMax = ray.tMax;
+    mBVH.traverse(
+        ray,
+        tMax,
+        [&](uint32_t offset, float& tFar)
+        {
+            float t;
+            float2 barycentrics;
+            if (intersectTriangle(ray, mV0[offset], mEdge1[offset], mEdge2[offset], tFar, t, barycentrics))
+            {
+                tFar = t;
+                hit.t = t;
+                hit.barycentrics = barycentrics;
+                hit.triangleIndex = offset;
+            }
+            return false;
+        }
+    );
+
+    // Map from leaf order back to the input triangle index.
+    if (hit.isValid())
+        hit.triangleIndex = mBVH.getPrimitiveIndices()[hit.triangleIndex];
+    return hit;
+}
+
+bool TriangleBVH::intersectAny(const Ray& ray) const
+{
+    float tMax = ray.tMax;
+    return mBVH.traverse(
+        ray,
+        tMax,
+        [&](uint32_t offset, float& tFar)
+        {
+            float t;
+            float2 barycentrics;
+            return intersectTriangle(ray, mV0[offset], mEdge1[offset], mEdge2[offset], tFar, t, barycentrics);
+        }
+    );
+}
+
+TriangleBVH::ClosestPoint TriangleBVH::findClosestPoint(const float3& point, float maxDistance) const
+{
+    ClosestPoint result;
+    float maxDistanceSq = maxDistance * maxDistance;
+    mBVH.traverseNearest(
+        point,
+        maxDistanceSq,
+        [&](uint32_t offset, float& maxDistSq)
+        {
+            float2 barycentrics;
+            float3 p = closestPointOnTriangle(point, mV0[offset], mEdge1[offset], mEdge2[offset], barycentrics);
+            float3 d = p - point;
+            float distanceSq = dot(d, d);
+            if (distanceSq <= maxDistSq)
+            {
+                maxDistSq = distanceSq;
+                result.point = p;
+                result.barycentrics = barycentrics;
+                result.triangleIndex = offset;
+            }
+        }
+    );
+
+    // Map from leaf order back to the input triangle index.
+    if (result.isValid())
+    {
+        result.distance = std::sqrt(maxDistanceSq);
+        result.triangleIndex = mBVH.getPrimitiveIndices()[result.triangleIndex];
+    }
+    return result;
+}
+
+void TriangleBVH::intersectClosest(fstd::span<const Ray> rays, fstd::span<Hit> hits) const
+{
+    FALCOR_CHECK(rays.size() == hits.size(), "Ray count ({}) and hit count ({}) don't match.", rays.size(), hits.size());
+    Threading::parallelFor(0, rays.size(), [&](size_t i) { hits[i] = intersectClosest(rays[i]); });
+}
+
+void TriangleBVH::intersectAny(fstd::span<const Ray> rays, fstd::span<uint8_t> hits) const
+{
+    FALCOR_CHECK(rays.size() == hits.size(), "Ray count ({}) and hit count ({}) don't match.", rays.size(), hits.size());
+    Threading::parallelFor(0, rays.size(), [&](size_t i) { hits[i] = intersectAny(rays[i]) ? 1 : 0; });
+}
+} // namespace Falcor
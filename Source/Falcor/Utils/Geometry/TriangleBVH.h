@@ -0,0 +1,286 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "BVH4.h"
+#include "Core/Macros.h"
+#include "Utils/Math/AABB.h"
+#include "Utils/Math/Ray.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * CPU ray queries against a triangle mesh.
+ *
+ * Triangles are stored in BVH leaf order as structure-of-arrays with precomputed edges,
+ * and are intersected with the Moller-Trumbore test without backface culling.
+ * The batch queries process rays in parallel.
+ */
+class FALCOR_API TriangleBVH
+{
+public:
+    static constexpr uint32_t kInvalidIndex = 0xffffffff;
+
+    struct Hit
+    {
+        float t = std::numeric_limits<float>::infinity(); ///< Hit distance along the ray.
+        float2 barycentrics = float2(0.f);                ///< Barycentric weights of vertices 1 and 2 (same convention as DXR).
+        uint32_t triangleIndex = kInvalidIndex;           ///< Index of the hit triangle, or kInvalidIndex if no hit.
+
+        bool isValid() const { return triangleIndex != kInvalidIndex; }
+    };
+
+    struct ClosestPoint
+    {
+        float distance = std::numeric_limits<float>::infinity(); ///< Distance from the query point.
+        float3 point = float3(0.f);                              ///< Closest point on the mesh.
+        float2 barycentrics = float2(0.f);                       ///< Barycentric weights of vertices 1 and 2 (same convention as Hit).
+        uint32_t triangleIndex = kInvalidIndex;                  ///< Index of the closest triangle, or kInvalidIndex if none was found.
+
+        bool isValid() const { return triangleIndex != kInvalidIndex; }
+    };
+
+    /**
+     * Build the BVH.
+     * @param[in] positions Vertex positions.
+     * @param[in] indices Vertex indices, three per triangle.
+     */
+    void build(fstd::span<const float3> positions, fstd::span<const uint32_t> indices);
+
+    /**
+     * Remove all triangles.
+     */
+    void clear();
+
+    bool empty() const { return mBVH.empty(); }
+
+    uint32_t getTriangleCount() const { return (uint32_t)mV0.size(); }
+
+    const AABB& getBounds() const { return mBVH.getBounds(); }
+
+    const BVH4& getBVH() const { return mBVH; }
+
+    /**
+     * Find the closest hit along a ray.
+     * @param[in] ray Ray. Hits are reported in the interval [ray.tMin, ray.tMax].
+     * @return Closest hit, invalid if the ray misses.
+     */
+    Hit intersectClosest(const Ray& ray) const;
+
+    /**
+     * Check whether a ray hits any triangle.
+     * @param[in] ray Ray. Hits are reported in the interval [ray.tMin, ray.tMax].
+     * @return True if the ray hits a triangle.
+     */
+    bool intersectAny(const Ray& ray) const;
+
+    /**
+     * Find the closest point on the mesh.
+     * @param[in] point Query point.
+     * @param[in] maxDistance Only points within this distance are reported.
+     * @return Closest point, invalid if no triangle is within maxDistance.
+     */
+    ClosestPoint findClosestPoint(const float3& point, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+    /**
+     * Find the closest hits along a batch of rays, processing the rays in parallel.
+     * @param[in] rays Rays.
+     * @param[out] hits Closest hit for each ray. Must have the same size as rays.
+     */
+    void intersectClosest(fstd::span<const Ray> rays, fstd::span<Hit> hits) const;
+
+    /**
+     * Check whether rays in a batch hit any triangle, processing the rays in parallel.
+     * @param[in] rays Rays.
+     * @param[out] hits 1 if the ray hits a triangle, 0 otherwise. Must have the same size as rays.
+     */
+    void intersectAny(fstd::span<const Ray> rays, fstd::span<uint8_t> hits) const;
+
+    /**
+     * Intersect a ray with a single triangle.
+     * @param[in] ray Ray.
+     * @param[in] v0 First vertex.
+     * @param[in] edge1 Edge from vertex 0 to vertex 1.
+     * @param[in] edge2 Edge from vertex 0 to vertex 2.
+     * @param[in] tMax Maximum hit distance.
+     * @param[out] t Hit distance.
+     * @param[out] barycentrics Barycentric weights of vertices 1 and 2.
+     * @return True if the ray hits the triangle in the interval [ray.tMin, tMax].
+     */
+    static bool intersectTriangle(
+        const Ray& ray,
+        const float3& v0,
+        const float3& edge1,
+        const float3& edge2,
+        float tMax,
+        float& t,
+        float2& barycentrics
+    )
+    {
+        float3 p = cross(ray.dir, edge2);
+        float det = dot(edge1, p);
+        if (det == 0.f)
+            return false;
+        float invDet = 1.f / det;
+
+        float3 s = ray.origin - v0;
+        float u = dot(s, p) * invDet;
+        if (u < 0.f || u > 1.f)
+            return false;
+
+        float3 q = cross(s, edge1);
+        float v = dot(ray.dir, q) * invDet;
+        if (v < 0.f || u + v > 1.f)
+            return false;
+
+        t = dot(edge2, q) * invDet;
+        if (!(t >= ray.tMin && t <= tMax))
+            return false;
+
+        barycentrics = float2(u, v);
+        return true;
+    }
+
+    /**
+     * Find the closest point on a single triangle.
+     * Points in the vertex and edge regions get barycentric weights that are exactly zero for the vertices
+     * not on the closest feature, which allows classifying the closest feature.
+     * See Ericson, "Real-Time Collision Detection", section 5.1.5.
+     * @param[in] point Query point.
+     * @param[in] v0 First vertex.
+     * @param[in] edge1 Edge from vertex 0 to vertex 1.
+     * @param[in] edge2 Edge from vertex 0 to vertex 2.
+     * @param[out] barycentrics Barycentric weights of vertices 1 and 2.
+     * @return Closest point on the triangle.
+     */
+    static float3 closestPointOnTriangle(const float3& point, const float3& v0, const float3& edge1, const float3& edge2, float2& barycentrics)
+    {
+        float3 ap = point - v0;
+        float d1 = dot(edge1, ap);
+        float d2 = dot(edge2, ap);
+        if (d1 <= 0.f && d2 <= 0.f)
+        {
+            barycentrics = float2(0.f, 0.f);
+            return v0;
+        }
+
+        float3 bp = ap - edge1;
+        float d3 = dot(edge1, bp);
+        float d4 = dot(edge2, bp);
+        if (d3 >= 0.f && d4 <= d3)
+        {
+            barycentrics = float2(1.f, 0.f);
+            return v0 + edge1;
+        }
+
+        float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+        {
+            float v = d1 / (d1 - d3);
+            barycentrics = float2(v, 0.f);
+            return v0 + v * edge1;
+        }
+
+        float3 cp = ap - edge2;
+        float d5 = dot(edge1, cp);
+        float d6 = dot(edge2, cp);
+        if (d6 >= 0.f && d5 <= d6)
+        {
+            barycentrics = float2(0.f, 1.f);
+            return v0 + edge2;
+        }
+
+        float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+        {
+            float w = d2 / (d2 - d6);
+            barycentrics = float2(0.f, w);
+            return v0 + w * edge2;
+        }
+
+        float va = d3 * d6 - d5 * d4;
+        if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f)
+        {
+            float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            barycentrics = float2(1.f - w, w);
+            return v0 + edge1 + w * (edge2 - edge1);
+        }
+
+        // The point projects inside the face.
+        float sum = va + vb + vc;
+        if (!(sum > 0.f))
+            return closestPointOnDegenerateTriangle(point, v0, edge1, edge2, barycentrics);
+        float denom = 1.f / sum;
+        barycentrics = float2(vb * denom, vc * denom);
+        return v0 + barycentrics.x * edge1 + barycentrics.y * edge2;
+    }
+
+private:
+    /// Fallback for triangles with zero area, returns the closest point on the three edges.
+    static float3 closestPointOnDegenerateTriangle(const float3& point, const float3& v0, const float3& edge1, const float3& edge2, float2& barycentrics)
+    {
+        auto closestOnSegment = [&](const float3& a, const float3& ab)
+        {
+            float len2 = dot(ab, ab);
+            return len2 > 0.f ? std::clamp(dot(point - a, ab) / len2, 0.f, 1.f) : 0.f;
+        };
+
+        float t01 = closestOnSegment(v0, edge1);
+        float t02 = closestOnSegment(v0, edge2);
+        float t12 = closestOnSegment(v0 + edge1, edge2 - edge1);
+        const float2 candidates[3] = {float2(t01, 0.f), float2(0.f, t02), float2(1.f - t12, t12)};
+
+        float bestDistanceSq = std::numeric_limits<float>::infinity();
+        float3 best = v0;
+        for (const float2& b : candidates)
+        {
+            float3 p = v0 + b.x * edge1 + b.y * edge2;
+            float3 d = p - point;
+            if (dot(d, d) < bestDistanceSq)
+            {
+                bestDistanceSq = dot(d, d);
+                best = p;
+                barycentrics = b;
+            }
+        }
+        return best;
+    }
+
+    BVH4 mBVH;
+
+    // Triangle data in BVH leaf order.
+    std::vector<float3> mV0;
+    std::vector<float3> mEdge1;
+    std::vector<float3> mEdge2;
+};
+} // namespace Falcor
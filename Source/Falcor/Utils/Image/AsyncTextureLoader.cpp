@@ -38,6 +38,10 @@ constexpr size_t kUploadsPerFlush = 16; ///< Number of texture uploads before is
 
 AsyncTextureLoader::AsyncTextureLoader(ref<Device> pDevice, size_t threadCount) : mpDevice(pDevice)
 {
+    // The loader uses dedicated threads since the workers block on each other for GPU flushes,
+    // but the thread count follows the global setting so that texture loading does not oversubscribe the CPU.
+    if (threadCount == 0)
+        threadCount = Threading::getThreadCount();
     runWorkers(threadCount);
 }
 
@@ -53,11 +57,12 @@ std::future<ref<Texture>> AsyncTextureLoader::loadMippedFromFiles(
     bool loadAsSrgb,
     ResourceBindFlags bindFlags,
     Bitmap::ImportFlags importFlags,
-    LoadCallback callback
+    LoadCallback callback,
+    bool analyze
 )
 {
     std::lock_guard<std::mutex> lock(mMutex);
-    mLoadRequestQueue.push(LoadRequest{{paths.begin(), paths.end()}, false, loadAsSrgb, bindFlags, importFlags, callback});
+    mLoadRequestQueue.push(LoadRequest{{paths.begin(), paths.end()}, false, loadAsSrgb, bindFlags, importFlags, callback, analyze});
     mCondition.notify_one();
     return mLoadRequestQueue.back().promise.get_future();
 }
@@ -68,15 +73,36 @@ std::future<ref<Texture>> AsyncTextureLoader::loadFromFile(
     bool loadAsSrgb,
     ResourceBindFlags bindFlags,
     Bitmap::ImportFlags importFlags,
-    LoadCallback callback
+    LoadCallback callback,
+    bool analyze
 )
 {
     std::lock_guard<std::mutex> lock(mMutex);
-    mLoadRequestQueue.push(LoadRequest{{path}, generateMipLevels, loadAsSrgb, bindFlags, importFlags, callback});
+    mLoadRequestQueue.push(LoadRequest{{path}, generateMipLevels, loadAsSrgb, bindFlags, importFlags, callback, analyze});
     mCondition.notify_one();
     return mLoadRequestQueue.back().promise.get_future();
 }
 
+ref<Texture> AsyncTextureLoader::loadTexture(
+    ref<Device> pDevice,
+    fstd::span<const std::filesystem::path> paths,
+    bool generateMipLevels,
+    bool loadAsSRGB,
+    ResourceBindFlags bindFlags,
+    Bitmap::ImportFlags importFlags,
+    std::optional<TextureAnalyzer::Result>* pAnalysis
+)
+{
+    FALCOR_ASSERT(!paths.empty());
+    if (paths.size() > 1)
+    {
+        if (pAnalysis)
+            *pAnalysis = std::nullopt;
+        return Texture::createMippedFromFiles(pDevice, paths, loadAsSRGB, bindFlags, importFlags);
+    }
+    return Texture::createFromFile(pDevice, paths[0], generateMipLevels, loadAsSRGB, bindFlags, importFlags, pAnalysis);
+}
+
 void AsyncTextureLoader::runWorkers(size_t threadCount)
 {
     // Create a barrier to synchronize worker threads before issuing a global flush.
@@ -133,23 +159,22 @@ void AsyncTextureLoader::runWorker()
         lock.unlock();
 
         // Load the textures (this part is running in parallel).
-        ref<Texture> pTexture;
-        if (request.paths.size() == 1)
-        {
-            pTexture = Texture::createFromFile(
-                mpDevice, request.paths[0], request.generateMipLevels, request.loadAsSRGB, request.bindFlags, request.importFlags
-            );
-        }
-        else
-        {
-            pTexture = Texture::createMippedFromFiles(mpDevice, request.paths, request.loadAsSRGB, request.bindFlags, request.importFlags);
-        }
+        std::optional<TextureAnalyzer::Result> analysis;
+        ref<Texture> pTexture = loadTexture(
+            mpDevice,
+            request.paths,
+            request.generateMipLevels,
+            request.loadAsSRGB,
+            request.bindFlags,
+            request.importFlags,
+            request.analyze ? &analysis : nullptr
+        );
 
         request.promise.set_value(pTexture);
 
         if (request.callback)
         {
-            request.callback(pTexture);
+            request.callback(pTexture, analysis);
         }
 
         lock.lock();
@@ -30,11 +30,13 @@
 #include "Core/API/fwd.h"
 #include "Core/API/Resource.h"
 #include "Core/API/Texture.h"
+#include "Utils/Image/TextureAnalyzer.h"
 #include <condition_variable>
 #include <filesystem>
 #include <functional>
 #include <future>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <thread>
 #include <vector>
@@ -50,13 +52,14 @@ class Barrier;
 class FALCOR_API AsyncTextureLoader
 {
 public:
-    using LoadCallback = std::function<void(ref<Texture> pTexture)>;
+    /// Callback with the loaded texture and its CPU analysis (std::nullopt if analysis was not requested or not possible).
+    using LoadCallback = std::function<void(ref<Texture> pTexture, const std::optional<TextureAnalyzer::Result>& analysis)>;
 
     /**
      * Constructor.
-     * @param[in] threadCount Number of worker threads.
+     * @param[in] threadCount Number of worker threads. 0 uses the global thread count (see Threading::getThreadCount()).
      */
-    AsyncTextureLoader(ref<Device> pDevice, size_t threadCount = std::thread::hardware_concurrency());
+    AsyncTextureLoader(ref<Device> pDevice, size_t threadCount = 0);
 
     /**
      * Destructor.
@@ -71,6 +74,7 @@ public:
      * @param[in] bindFlags The bind flags for the texture resource.
      * @param[in] importFlags Optional flags for the file import.
      * @param[in] callback Function called after the texture load has finished.
+     * @param[in] analyze Analyze the texture contents on the CPU while loading (see loadTexture()).
      * @return A future to a new texture, or nullptr if the texture failed to load.
      */
     std::future<ref<Texture>> loadMippedFromFiles(
@@ -78,7 +82,8 @@ public:
         bool loadAsSRGB,
         ResourceBindFlags bindFlags = ResourceBindFlags::ShaderResource,
         Bitmap::ImportFlags importFlags = Bitmap::ImportFlags::None,
-        LoadCallback callback = {}
+        LoadCallback callback = {},
+        bool analyze = false
     );
 
     /**
@@ -89,6 +94,7 @@ public:
      * @param[in] bindFlags The bind flags for the texture resource.
      * @param[in] importFlags Optional flags for the file import.
      * @param[in] callback Function called after the texture load has finished.
+     * @param[in] analyze Analyze the texture contents on the CPU while loading (see loadTexture()).
      * @return A future to a new texture, or nullptr if the texture failed to load.
      */
     std::future<ref<Texture>> loadFromFile(
@@ -97,7 +103,31 @@ public:
         bool loadAsSRGB,
         ResourceBindFlags bindFlags = ResourceBindFlags::ShaderResource,
         Bitmap::ImportFlags importFlags = Bitmap::ImportFlags::None,
-        LoadCallback callback = {}
+        LoadCallback callback = {},
+        bool analyze = false
+    );
+
+    /**
+     * Load a texture on the calling thread. This is the function executed by the worker threads.
+     * Single images are loaded with Texture::createFromFile(), which also computes the analysis if requested.
+     * Mipped textures are not analyzed, for these the analysis is std::nullopt.
+     * @param[in] pDevice GPU device.
+     * @param[in] paths File path of the texture, or list of full paths of all mips starting from mip0.
+     * @param[in] generateMipLevels Whether the full mip-chain should be generated (single path only).
+     * @param[in] loadAsSRGB Load the texture as sRGB format if supported, otherwise linear color.
+     * @param[in] bindFlags The bind flags for the texture resource.
+     * @param[in] importFlags Flags for the file import.
+     * @param[out] pAnalysis Optional analysis result. If nullptr, the texture is not analyzed.
+     * @return The loaded texture, or nullptr if the texture failed to load.
+     */
+    static ref<Texture> loadTexture(
+        ref<Device> pDevice,
+        fstd::span<const std::filesystem::path> paths,
+        bool generateMipLevels,
+        bool loadAsSRGB,
+        ResourceBindFlags bindFlags,
+        Bitmap::ImportFlags importFlags,
+        std::optional<TextureAnalyzer::Result>* pAnalysis = nullptr
     );
 
 private:
@@ -113,6 +143,7 @@ private:
         ResourceBindFlags bindFlags;
         Bitmap::ImportFlags importFlags;
         LoadCallback callback;
+        bool analyze;
         std::promise<ref<Texture>> promise;
     };
 
@@ -27,6 +27,15 @@
  **************************************************************************/
 #include "TextureAnalyzer.h"
 #include "Core/API/RenderContext.h"
+#include "Utils/Threading.h"
+#include "Utils/Math/Float16.h"
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#if defined(_M_X64) || defined(__x86_64__)
+#include <emmintrin.h>
+#define FALCOR_TEXTURE_ANALYZER_SSE2 1
+#endif
 
 namespace Falcor
 {
@@ -39,6 +48,345 @@ static_assert((uint32_t)TextureChannelFlags::Blue == 0x4);
 static_assert((uint32_t)TextureChannelFlags::Alpha == 0x8);
 
 const char kShaderFilename[] = "Utils/Image/TextureAnalyzer.cs.slang";
+
+/// Number of texels analyzed per task by the CPU analysis.
+constexpr size_t kCpuTexelsPerTask = 1 << 16;
+
+enum class TexelType
+{
+    Unorm8,
+    Unorm16,
+    Float16,
+    Float32,
+};
+
+/// Memory layout of the formats supported by the CPU analysis.
+struct TexelLayout
+{
+    TexelType type;
+    uint32_t channelCount; ///< Number of stored channels.
+    bool bgr = false;      ///< Stored channel order is BGR(A) instead of RGB(A).
+    bool srgb = false;     ///< Stored values are sRGB encoded.
+    bool noAlpha = false;  ///< Stored alpha channel is unused and reads as one (BGRX formats).
+
+    uint32_t getChannelSize() const
+    {
+        switch (type)
+        {
+        case TexelType::Unorm8:
+            return 1;
+        case TexelType::Unorm16:
+        case TexelType::Float16:
+            return 2;
+        default:
+            return 4;
+        }
+    }
+
+    uint32_t getTexelSize() const { return channelCount * getChannelSize(); }
+
+    /// Returns the RGBA channel index of a stored channel.
+    uint32_t getChannel(uint32_t storedChannel) const { return (bgr && storedChannel < 3) ? 2 - storedChannel : storedChannel; }
+};
+
+std::optional<TexelLayout> getTexelLayout(ResourceFormat format)
+{
+    switch (format)
+    {
+    case ResourceFormat::R8Unorm:
+        return TexelLayout{TexelType::Unorm8, 1};
+    case ResourceFormat::RG8Unorm:
+        return TexelLayout{TexelType::Unorm8, 2};
+    case ResourceFormat::RGBA8Unorm:
+        return TexelLayout{TexelType::Unorm8, 4};
+    case ResourceFormat::RGBA8UnormSrgb:
+        return TexelLayout{TexelType::Unorm8, 4, false, true};
+    case ResourceFormat::BGRA8Unorm:
+        return TexelLayout{TexelType::Unorm8, 4, true};
+    case ResourceFormat::BGRA8UnormSrgb:
+        return TexelLayout{TexelType::Unorm8, 4, true, true};
+    case ResourceFormat::BGRX8Unorm:
+        return TexelLayout{TexelType::Unorm8, 4, true, false, true};
+    case ResourceFormat::BGRX8UnormSrgb:
+        return TexelLayout{TexelType::Unorm8, 4, true, true, true};
+    case ResourceFormat::R16Unorm:
+        return TexelLayout{TexelType::Unorm16, 1};
+    case ResourceFormat::RG16Unorm:
+        return TexelLayout{TexelType::Unorm16, 2};
+    case ResourceFormat::RGBA16Unorm:
+        return TexelLayout{TexelType::Unorm16, 4};
+    case ResourceFormat::R16Float:
+        return TexelLayout{TexelType::Float16, 1};
+    case ResourceFormat::RG16Float:
+        return TexelLayout{TexelType::Float16, 2};
+    case ResourceFormat::RGBA16Float:
+        return TexelLayout{TexelType::Float16, 4};
+    case ResourceFormat::R32Float:
+        return TexelLayout{TexelType::Float32, 1};
+    case ResourceFormat::RG32Float:
+        return TexelLayout{TexelType::Float32, 2};
+    case ResourceFormat::RGB32Float:
+        return TexelLayout{TexelType::Float32, 3};
+    case ResourceFormat::RGBA32Float:
+        return TexelLayout{TexelType::Float32, 4};
+    default:
+        return std::nullopt;
+    }
+}
+
+float decodeUnorm8(uint8_t value, bool srgb)
+{
+    float c = value / 255.f;
+    if (!srgb)
+        return c;
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+/// Decode a texel to RGBA as seen by a shader reading the texture. Channels that are not stored read as (0, 0, 0, 1).
+float4 decodeTexel(const uint8_t* pTexel, const TexelLayout& layout)
+{
+    float4 texel(0.f, 0.f, 0.f, 1.f);
+    for (uint32_t i = 0; i < layout.channelCount; i++)
+    {
+        float value = 0.f;
+        switch (layout.type)
+        {
+        case TexelType::Unorm8:
+            value = decodeUnorm8(pTexel[i], layout.srgb);
+            break;
+        case TexelType::Unorm16:
+        {
+            uint16_t bits;
+            std::memcpy(&bits, pTexel + 2 * i, sizeof(bits));
+            value = bits / 65535.f;
+            break;
+        }
+        case TexelType::Float16:
+        {
+            uint16_t bits;
+            std::memcpy(&bits, pTexel + 2 * i, sizeof(bits));
+            value = math::float16ToFloat32(bits);
+            break;
+        }
+        case TexelType::Float32:
+            std::memcpy(&value, pTexel + 4 * i, sizeof(value));
+            break;
+        }
+        texel[layout.getChannel(i)] = value;
+    }
+    if (layout.noAlpha)
+        texel.a = 1.f;
+    return texel;
+}
+
+/// Partial result of the CPU analysis. Bit i of the masks refers to RGBA channel i.
+struct CpuStats
+{
+    uint32_t varying = 0;
+    uint32_t pos = 0;
+    uint32_t neg = 0;
+    uint32_t inf = 0;
+    uint32_t nan = 0;
+    float4 minValue = float4(FLT_MAX);
+    float4 maxValue = float4(-FLT_MAX);
+
+    static CpuStats combine(const CpuStats& a, const CpuStats& b)
+    {
+        CpuStats s;
+        s.varying = a.varying | b.varying;
+        s.pos = a.pos | b.pos;
+        s.neg = a.neg | b.neg;
+        s.inf = a.inf | b.inf;
+        s.nan = a.nan | b.nan;
+        s.minValue = min(a.minValue, b.minValue);
+        s.maxValue = max(a.maxValue, b.maxValue);
+        return s;
+    }
+};
+
+/**
+ * Analyze rows of 8-bit unorm texels.
+ * The texels are compared and reduced as raw bytes 16 at a time, which is valid since the decoding is monotonic.
+ * The byte statistics are decoded once at the end.
+ */
+CpuStats analyzeRowsUnorm8(
+    const uint8_t* pData,
+    size_t rowPitch,
+    uint32_t width,
+    uint32_t rowBegin,
+    uint32_t rowEnd,
+    const TexelLayout& layout
+)
+{
+    const uint32_t texelSize = layout.getTexelSize();
+    const size_t rowSize = (size_t)width * texelSize;
+
+    // Reference texel replicated to 16 bytes. The texel size divides 16 so byte i always holds stored channel i % texelSize.
+    uint8_t ref[16], diff[16], minBytes[16], maxBytes[16];
+    for (uint32_t i = 0; i < 16; i++)
+        ref[i] = pData[i % texelSize];
+    std::memset(diff, 0, sizeof(diff));
+    std::memset(minBytes, 0xff, sizeof(minBytes));
+    std::memset(maxBytes, 0, sizeof(maxBytes));
+
+#ifdef FALCOR_TEXTURE_ANALYZER_SSE2
+    __m128i vRef = _mm_loadu_si128((const __m128i*)ref);
+    __m128i vDiff = _mm_setzero_si128();
+    __m128i vMin = _mm_set1_epi8((char)0xff);
+    __m128i vMax = _mm_setzero_si128();
+#endif
+
+    for (uint32_t y = rowBegin; y < rowEnd; y++)
+    {
+        const uint8_t* pRow = pData + y * rowPitch;
+        size_t i = 0;
+#ifdef FALCOR_TEXTURE_ANALYZER_SSE2
+        for (; i + 16 <= rowSize; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(pRow + i));
+            vDiff = _mm_or_si128(vDiff, _mm_xor_si128(v, vRef));
+            vMin = _mm_min_epu8(vMin, v);
+            vMax = _mm_max_epu8(vMax, v);
+        }
+#endif
+        for (; i < rowSize; i++)
+        {
+            uint8_t v = pRow[i];
+            diff[i & 15] |= v ^ ref[i & 15];
+            minBytes[i & 15] = std::min(minBytes[i & 15], v);
+            maxBytes[i & 15] = std::max(maxBytes[i & 15], v);
+        }
+    }
+
+#ifdef FALCOR_TEXTURE_ANALYZER_SSE2
+    uint8_t vectorBytes[3][16];
+    _mm_storeu_si128((__m128i*)vectorBytes[0], vDiff);
+    _mm_storeu_si128((__m128i*)vectorBytes[1], vMin);
+    _mm_storeu_si128((__m128i*)vectorBytes[2], vMax);
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        diff[i] |= vectorBytes[0][i];
+        minBytes[i] = std::min(minBytes[i], vectorBytes[1][i]);
+        maxBytes[i] = std::max(maxBytes[i], vectorBytes[2][i]);
+    }
+#endif
+
+    // Reduce the byte lanes to stored channels and decode them.
+    CpuStats stats;
+    for (uint32_t c = 0; c < layout.channelCount; c++)
+    {
+        uint8_t channelDiff = 0, channelMin = 0xff, channelMax = 0;
+        for (uint32_t i = c; i < 16; i += texelSize)
+        {
+            channelDiff |= diff[i];
+            channelMin = std::min(channelMin, minBytes[i]);
+            channelMax = std::max(channelMax, maxBytes[i]);
+        }
+        uint32_t channel = layout.getChannel(c);
+        if (channel == 3 && layout.noAlpha)
+            continue;
+        if (channelDiff != 0)
+            stats.varying |= 1u << channel;
+        if (channelMax > 0)
+            stats.pos |= 1u << channel;
+        stats.minValue[channel] = decodeUnorm8(channelMin, layout.srgb);
+        stats.maxValue[channel] = decodeUnorm8(channelMax, layout.srgb);
+    }
+    return stats;
+}
+
+/**
+ * Analyze RGBA fp32 texels.
+ * Each texel is processed as one SIMD vector. NaNs are ignored by the min/max reduction, as on the GPU.
+ */
+void analyzeTexelsFloat4(const float4* pTexels, size_t count, const float4& ref, CpuStats& stats)
+{
+#ifdef FALCOR_TEXTURE_ANALYZER_SSE2
+    const __m128 vRef = _mm_loadu_ps(&ref.x);
+    const __m128 vZero = _mm_setzero_ps();
+    const __m128 vInf = _mm_set1_ps(INFINITY);
+    const __m128 vAbsMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 vVarying = _mm_setzero_ps(), vPos = _mm_setzero_ps(), vNeg = _mm_setzero_ps(), vIsInf = _mm_setzero_ps(),
+           vIsNaN = _mm_setzero_ps();
+    __m128 vMin = _mm_loadu_ps(&stats.minValue.x);
+    __m128 vMax = _mm_loadu_ps(&stats.maxValue.x);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        __m128 v = _mm_loadu_ps(&pTexels[i].x);
+        vVarying = _mm_or_ps(vVarying, _mm_cmpneq_ps(v, vRef));
+        vPos = _mm_or_ps(vPos, _mm_cmpgt_ps(v, vZero));
+        vNeg = _mm_or_ps(vNeg, _mm_cmplt_ps(v, vZero));
+        vIsInf = _mm_or_ps(vIsInf, _mm_cmpeq_ps(_mm_and_ps(v, vAbsMask), vInf));
+        vIsNaN = _mm_or_ps(vIsNaN, _mm_cmpunord_ps(v, v));
+        // MINPS/MAXPS return the second operand if either operand is NaN.
+        vMin = _mm_min_ps(v, vMin);
+        vMax = _mm_max_ps(v, vMax);
+    }
+
+    stats.varying |= _mm_movemask_ps(vVarying);
+    stats.pos |= _mm_movemask_ps(vPos);
+    stats.neg |= _mm_movemask_ps(vNeg);
+    stats.inf |= _mm_movemask_ps(vIsInf);
+    stats.nan |= _mm_movemask_ps(vIsNaN);
+    _mm_storeu_ps(&stats.minValue.x, vMin);
+    _mm_storeu_ps(&stats.maxValue.x, vMax);
+#else
+    for (size_t i = 0; i < count; i++)
+    {
+        for (uint32_t c = 0; c < 4; c++)
+        {
+            float v = pTexels[i][c];
+            if (v != ref[c])
+                stats.varying |= 1u << c;
+            if (v > 0.f)
+                stats.pos |= 1u << c;
+            if (v < 0.f)
+                stats.neg |= 1u << c;
+            if (std::isinf(v))
+                stats.inf |= 1u << c;
+            if (std::isnan(v))
+                stats.nan |= 1u << c;
+            if (v < stats.minValue[c])
+                stats.minValue[c] = v;
+            if (v > stats.maxValue[c])
+                stats.maxValue[c] = v;
+        }
+    }
+#endif
+}
+
+/**
+ * Analyze rows of texels of any supported format.
+ * RGBA fp32 rows are analyzed in place, all other formats are decoded to a temporary RGBA fp32 row first.
+ */
+CpuStats analyzeRows(const uint8_t* pData, size_t rowPitch, uint32_t width, uint32_t rowBegin, uint32_t rowEnd, const TexelLayout& layout)
+{
+    if (layout.type == TexelType::Unorm8)
+        return analyzeRowsUnorm8(pData, rowPitch, width, rowBegin, rowEnd, layout);
+
+    const float4 ref = decodeTexel(pData, layout);
+    const uint32_t texelSize = layout.getTexelSize();
+    const bool isFloat4 = layout.type == TexelType::Float32 && layout.channelCount == 4;
+
+    CpuStats stats;
+    std::vector<float4> row(isFloat4 ? 0 : width);
+    for (uint32_t y = rowBegin; y < rowEnd; y++)
+    {
+        const uint8_t* pRow = pData + y * rowPitch;
+        if (isFloat4)
+        {
+            analyzeTexelsFloat4(reinterpret_cast<const float4*>(pRow), width, ref, stats);
+        }
+        else
+        {
+            for (uint32_t x = 0; x < width; x++)
+                row[x] = decodeTexel(pRow + (size_t)x * texelSize, layout);
+            analyzeTexelsFloat4(row.data(), width, ref, stats);
+        }
+    }
+    return stats;
+}
 } // namespace
 
 // Verify that the result struct matches the size expected by the shader.
@@ -126,6 +474,85 @@ void TextureAnalyzer::clear(RenderContext* pRenderContext, ref<Buffer> pResult,
     mpClearPass->execute(pRenderContext, uint3(resultCount, 1, 1));
 }
 
+bool TextureAnalyzer::isImageFormatSupported(ResourceFormat format)
+{
+    return getTexelLayout(format).has_value();
+}
+
+std::optional<TextureAnalyzer::Result> TextureAnalyzer::analyzeImage(
+    const void* pData,
+    uint32_t width,
+    uint32_t height,
+    uint32_t rowPitch,
+    ResourceFormat format
+)
+{
+    auto layout = getTexelLayout(format);
+    if (!layout)
+        return std::nullopt;
+
+    FALCOR_CHECK(pData != nullptr && width > 0 && height > 0, "Invalid image");
+    FALCOR_CHECK(rowPitch >= width * layout->getTexelSize(), "Row pitch is too small");
+
+    // Analyze blocks of rows in parallel and combine the partial results.
+    // The reduction only uses bitwise or, min and max, so the result does not depend on the order.
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+    const uint32_t rowsPerTask = (uint32_t)std::max<size_t>(1, kCpuTexelsPerTask / width);
+    const size_t taskCount = (height + rowsPerTask - 1) / rowsPerTask;
+
+    CpuStats stats = Threading::parallelReduce(
+        0,
+        taskCount,
+        CpuStats{},
+        [&](size_t i)
+        {
+            uint32_t rowBegin = (uint32_t)i * rowsPerTask;
+            uint32_t rowEnd = std::min(height, rowBegin + rowsPerTask);
+            return analyzeRows(pBytes, rowPitch, width, rowBegin, rowEnd, *layout);
+        },
+        CpuStats::combine,
+        1
+    );
+
+    // Channels that are not stored read as zero (RGB) or one (alpha).
+    for (uint32_t c = 0; c < 4; c++)
+    {
+        bool isStored = false;
+        for (uint32_t i = 0; i < layout->channelCount; i++)
+            isStored |= layout->getChannel(i) == c;
+        if (c == 3 && layout->noAlpha)
+            isStored = false;
+        if (!isStored)
+        {
+            float value = c == 3 ? 1.f : 0.f;
+            stats.minValue[c] = stats.maxValue[c] = value;
+            if (value > 0.f)
+                stats.pos |= 1u << c;
+        }
+    }
+
+    // Pack the result in the same layout as the GPU analysis.
+    Result result = {};
+    result.mask = stats.varying;
+    for (uint32_t c = 0; c < 4; c++)
+    {
+        uint32_t range = 0;
+        if (stats.pos & (1u << c))
+            range |= (uint32_t)Result::RangeFlags::Pos;
+        if (stats.neg & (1u << c))
+            range |= (uint32_t)Result::RangeFlags::Neg;
+        if (stats.inf & (1u << c))
+            range |= (uint32_t)Result::RangeFlags::Inf;
+        if (stats.nan & (1u << c))
+            range |= (uint32_t)Result::RangeFlags::NaN;
+        result.mask |= range << (4 + 4 * c);
+    }
+    result.value = decodeTexel(pBytes, *layout);
+    result.minValue = max(stats.minValue, float4(0.f));
+    result.maxValue = max(stats.maxValue, float4(0.f));
+    return result;
+}
+
 void TextureAnalyzer::checkFormatSupport(const ref<Texture> pInput, uint32_t mipLevel, uint32_t arraySlice) const
 {
     // Validate that input is supported.
@@ -33,63 +33,67 @@
 #include "Core/Pass/ComputePass.h"
 #include "Utils/Math/Vector.h"
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace Falcor
 {
 class RenderContext;
 
-/**
- * A class for analyzing texture contents.
- */
-class FALCOR_API TextureAnalyzer
+/// Texture analysis result. Forward declared in Texture.h so texture loading can report the CPU analysis.
+struct TextureAnalysisResult
 {
-public:
-    /// Texture analysis result.
-    struct Result
+    uint32_t mask;        ///< Bits 0-3 indicate which color channels (RGBA) are varying (0 = constant, 1 = varying in i:th bit).
+                          ///< Bits 4-19 indicate numerical range of texture (4 bits per channel). Bits 20-31 are reserved.
+    uint32_t reserved[3]; ///< Reserved bits.
+
+    float4 value;    ///< The constant color value in RGBA fp32 format. Only valid for channels that are identified as constant.
+    float4 minValue; ///< The minimum color value in RGBA fp32 format. NOTE: Clamped to zero.
+    float4 maxValue; ///< The maximum color value in RGBA fp32 format. NOTE: Clamped to zero.
+
+    enum class RangeFlags : uint32_t
     {
-        uint32_t mask;        ///< Bits 0-3 indicate which color channels (RGBA) are varying (0 = constant, 1 = varying in i:th bit).
-                              ///< Bits 4-19 indicate numerical range of texture (4 bits per channel). Bits 20-31 are reserved.
-        uint32_t reserved[3]; ///< Reserved bits.
+        Pos = 0x1, ///< Texture channel has positive values > 0;
+        Neg = 0x2, ///< Texture channel has negative values < 0;
+        Inf = 0x4, ///< Texture channel has +/-inf values.
+        NaN = 0x8, ///< Texture channel has NaN values.
+    };
 
-        float4 value;    ///< The constant color value in RGBA fp32 format. Only valid for channels that are identified as constant.
-        float4 minValue; ///< The minimum color value in RGBA fp32 format. NOTE: Clamped to zero.
-        float4 maxValue; ///< The maximum color value in RGBA fp32 format. NOTE: Clamped to zero.
+    bool isConstant(uint32_t channelMask) const { return (mask & channelMask) == 0; }
+    bool isConstant(TextureChannelFlags channelMask) const { return isConstant((uint32_t)channelMask); }
 
-        enum class RangeFlags : uint32_t
-        {
-            Pos = 0x1, ///< Texture channel has positive values > 0;
-            Neg = 0x2, ///< Texture channel has negative values < 0;
-            Inf = 0x4, ///< Texture channel has +/-inf values.
-            NaN = 0x8, ///< Texture channel has NaN values.
-        };
-
-        bool isConstant(uint32_t channelMask) const { return (mask & channelMask) == 0; }
-        bool isConstant(TextureChannelFlags channelMask) const { return isConstant((uint32_t)channelMask); }
-
-        bool isPos(TextureChannelFlags channelMask) const { return getRange(channelMask) & (uint32_t)RangeFlags::Pos; }
-        bool isNeg(TextureChannelFlags channelMask) const { return getRange(channelMask) & (uint32_t)RangeFlags::Neg; }
-        bool isInf(TextureChannelFlags channelMask) const { return getRange(channelMask) & (uint32_t)RangeFlags::Inf; }
-        bool isNaN(TextureChannelFlags channelMask) const { return getRange(channelMask) & (uint32_t)RangeFlags::NaN; }
-
-        /**
-         * Returns the numerical range of texels in the given color channels.
-         * @param[in] channelMask Which color channels to look at.
-         * @return Union of 'RangeFlags' flags (0 = no texels, 1 = at least one texel).
-         */
-        uint32_t getRange(TextureChannelFlags channelMask) const
+    bool isPos(TextureChannelFlags channelMask) const { return getRange(channelMask) & (uint32_t)RangeFlags::Pos; }
+    bool isNeg(TextureChannelFlags channelMask) const { return getRange(channelMask) & (uint32_t)RangeFlags::Neg; }
+    bool isInf(TextureChannelFlags channelMask) const { return getRange(channelMask) & (uint32_t)RangeFlags::Inf; }
+    bool isNaN(TextureChannelFlags channelMask) const { return getRange(channelMask) & (uint32_t)RangeFlags::NaN; }
+
+    /**
+     * Returns the numerical range of texels in the given color channels.
+     * @param[in] channelMask Which color channels to look at.
+     * @return Union of 'RangeFlags' flags (0 = no texels, 1 = at least one texel).
+     */
+    uint32_t getRange(TextureChannelFlags channelMask) const
+    {
+        uint32_t range = 0;
+        for (int i = 0; i < 4; i++)
         {
-            uint32_t range = 0;
-            for (int i = 0; i < 4; i++)
+            if ((uint32_t)channelMask & (1 << i))
             {
-                if ((uint32_t)channelMask & (1 << i))
-                {
-                    range |= mask >> (4 + 4 * i);
-                }
+                range |= mask >> (4 + 4 * i);
             }
-            return range & 0xf;
         }
-    };
+        return range & 0xf;
+    }
+};
+
+/**
+ * A class for analyzing texture contents.
+ */
+class FALCOR_API TextureAnalyzer
+{
+public:
+    /// Texture analysis result.
+    using Result = TextureAnalysisResult;
 
     /**
      * Constructor. Throws an exception if creation failed.
@@ -145,6 +149,25 @@ public:
      */
     static size_t getResultSize();
 
+    /**
+     * Analyze an image in CPU memory.
+     * This computes the same result as analyzing a texture created from the data on the GPU, but without
+     * uploading it first. It is used to analyze textures while the decoded image is still in CPU memory.
+     * The analysis is vectorized and runs in parallel on the global thread pool.
+     * @param[in] pData Texel data of the image.
+     * @param[in] width Width of the image in texels.
+     * @param[in] height Height of the image in texels.
+     * @param[in] rowPitch Size of one row in bytes.
+     * @param[in] format Format of the texel data. For sRGB formats the result is computed on linear values.
+     * @return Analysis result, or std::nullopt if the format is not supported on the CPU (e.g. block compressed formats).
+     */
+    static std::optional<Result> analyzeImage(const void* pData, uint32_t width, uint32_t height, uint32_t rowPitch, ResourceFormat format);
+
+    /**
+     * Check if a format is supported by analyzeImage().
+     */
+    static bool isImageFormatSupported(ResourceFormat format);
+
 private:
     void checkFormatSupport(const ref<Texture> pInput, uint32_t mipLevel, uint32_t arraySlice) const;
 
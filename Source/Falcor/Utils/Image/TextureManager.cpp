@@ -28,10 +28,9 @@
 #include "TextureManager.h"
 #include "Core/AssetResolver.h"
 #include "Core/API/Device.h"
+#include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
-#include "Utils/NumericRange.h"
-
-#include <execution>
+#include "Utils/Threading.h"
 
 // Temporarily disable asynchronous texture loader until Falcor supports parallel GPU work submission.
 // Until then `TextureManager` should only called from the main thread.
@@ -43,6 +42,25 @@ namespace
 {
 const size_t kMaxTextureHandleCount = std::numeric_limits<uint32_t>::max();
 static_assert(TextureManager::CpuTextureHandle::kInvalidID >= kMaxTextureHandleCount);
+
+/// Decode an image file and analyze it on the CPU. Used when analysis is requested for a texture that was loaded without it.
+std::optional<TextureAnalyzer::Result> analyzeImageFile(
+    const std::vector<std::filesystem::path>& paths,
+    bool loadAsSRGB,
+    Bitmap::ImportFlags importFlags
+)
+{
+    // Mipped and DDS textures are not analyzed on the CPU, same as in Texture::createFromFile().
+    if (paths.size() != 1 || hasExtension(paths[0], "dds"))
+        return std::nullopt;
+
+    Bitmap::UniqueConstPtr pBitmap = Bitmap::createFromFile(paths[0], true /* topDown */, importFlags);
+    if (!pBitmap)
+        return std::nullopt;
+
+    ResourceFormat format = loadAsSRGB ? linearToSrgbFormat(pBitmap->getFormat()) : pBitmap->getFormat();
+    return TextureAnalyzer::analyzeImage(pBitmap->getData(), pBitmap->getWidth(), pBitmap->getHeight(), pBitmap->getRowPitch(), format);
+}
 } // namespace
 
 TextureManager::TextureManager(ref<Device> pDevice, size_t maxTextureCount, size_t threadCount)
@@ -113,7 +131,8 @@ TextureManager::CpuTextureHandle TextureManager::loadUdimTexture(
     bool async,
     Bitmap::ImportFlags importFlags,
     const AssetResolver* assetResolver,
-    size_t* loadedTextureCount
+    size_t* loadedTextureCount,
+    bool analyze
 )
 {
     std::string filename = path.filename().string();
@@ -125,7 +144,9 @@ TextureManager::CpuTextureHandle TextureManager::loadUdimTexture(
 
     auto pos = filename.find("<UDIM>");
     if (pos == std::string::npos)
-        return loadTexture(path, generateMipLevels, loadAsSRGB, bindFlags, async, importFlags, assetResolver, loadedTextureCount);
+        return loadTexture(
+            path, generateMipLevels, loadAsSRGB, bindFlags, async, importFlags, assetResolver, loadedTextureCount, nullptr, analyze
+        );
 
     std::filesystem::path dirpath = path.parent_path();
     filename.replace(pos, 6, "[1-9][0-9][0-9][0-9]");
@@ -168,7 +189,8 @@ TextureManager::CpuTextureHandle TextureManager::loadUdimTexture(
         maxIndex = std::max<size_t>(maxIndex, udim);
         udimIndices.push_back(udim);
         // Do not pass on assetResolver as paths are already resolved, nor loadedTextureCount as we've already set it above.
-        handles.push_back(loadTexture(it, generateMipLevels, loadAsSRGB, bindFlags, async, importFlags));
+        handles.push_back(loadTexture(it, generateMipLevels, loadAsSRGB, bindFlags, async, importFlags, nullptr, nullptr, nullptr, analyze)
+        );
 
         FALCOR_CHECK(udim >= 1001, "Texture {} is not a valid UDIM texture, as it violates the valid UDIM range of 1001-9999", it);
     }
@@ -194,13 +216,14 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
     Bitmap::ImportFlags importFlags,
     const AssetResolver* assetResolver,
     size_t* loadedTextureCount,
-    const Object* owner
+    const Object* owner,
+    bool analyze
 )
 {
     if (path.string().find("<UDIM>") != std::string::npos)
     {
         CpuTextureHandle handle =
-            loadUdimTexture(path, generateMipLevels, loadAsSRGB, bindFlags, async, importFlags, assetResolver, loadedTextureCount);
+            loadUdimTexture(path, generateMipLevels, loadAsSRGB, bindFlags, async, importFlags, assetResolver, loadedTextureCount, analyze);
 
         std::lock_guard<std::mutex> lock(mMutex);
         registerOwner(handle, owner);
@@ -266,6 +289,21 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
     {
         // Texture is already managed. Return its handle.
         handle = it->second;
+
+        // Upgrade the texture if analysis is requested now but was not when it was loaded.
+        // Textures that are still loading are analyzed by the loader, see endDeferredLoading() and the load callback below.
+        auto& desc = getDesc(handle);
+        if (analyze && !desc.analyze)
+        {
+            desc.analyze = true;
+            if (desc.state == TextureState::Loaded && desc.pTexture && !desc.analysis)
+            {
+                lock.unlock();
+                auto analysis = analyzeImageFile(paths, loadAsSRGB, importFlags);
+                lock.lock();
+                getDesc(handle).analysis = analysis;
+            }
+        }
     }
     else
     {
@@ -273,6 +311,7 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
         {
             // Add new texture desc.
             TextureDesc desc = {TextureState::Referenced, nullptr};
+            desc.analyze = analyze;
             handle = addDesc(desc);
             registerOwner(handle, owner);
 
@@ -288,6 +327,7 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
 
         // Texture is not already managed. Add new texture desc.
         TextureDesc desc = {TextureState::Referenced, nullptr};
+        desc.analyze = analyze;
         handle = addDesc(desc);
 
         // Add to key-to-handle map.
@@ -295,14 +335,23 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
 
         // Function called by the async texture loader when loading finishes.
         // It's called by a worker thread so needs to acquire the mutex before changing any state.
-        auto callback = [=](ref<Texture> pTexture)
+        auto callback = [=](ref<Texture> pTexture, std::optional<TextureAnalyzer::Result> analysis)
         {
             std::unique_lock<std::mutex> lock(mMutex);
 
+            // Analyze the texture if analysis was requested by another load while this one was in progress.
+            if (pTexture && !analysis && getDesc(handle).analyze)
+            {
+                lock.unlock();
+                analysis = analyzeImageFile(paths, loadAsSRGB, importFlags);
+                lock.lock();
+            }
+
             // Mark texture as loaded.
             auto& desc = getDesc(handle);
             desc.state = TextureState::Loaded;
             desc.pTexture = pTexture;
+            desc.analysis = analysis;
 
             // Add to texture-to-handle map.
             if (pTexture)
@@ -315,26 +364,21 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
         // Issue load request to texture loader.
         if (paths.size() > 1)
         {
-            mAsyncTextureLoader.loadMippedFromFiles(paths, loadAsSRGB, bindFlags, importFlags, callback);
+            mAsyncTextureLoader.loadMippedFromFiles(paths, loadAsSRGB, bindFlags, importFlags, callback, analyze);
         }
         else
         {
-            mAsyncTextureLoader.loadFromFile(paths[0], generateMipLevels, loadAsSRGB, bindFlags, importFlags, callback);
+            mAsyncTextureLoader.loadFromFile(paths[0], generateMipLevels, loadAsSRGB, bindFlags, importFlags, callback, analyze);
         }
 #else
         // Load texture from main thread.
-        ref<Texture> pTexture;
-        if (paths.size() > 1)
-        {
-            pTexture = Texture::createMippedFromFiles(mpDevice, paths, loadAsSRGB, bindFlags, importFlags);
-        }
-        else
-        {
-            pTexture = Texture::createFromFile(mpDevice, paths[0], generateMipLevels, loadAsSRGB, bindFlags, importFlags);
-        }
+        std::optional<TextureAnalyzer::Result> analysis;
+        ref<Texture> pTexture = AsyncTextureLoader::loadTexture(
+            mpDevice, paths, generateMipLevels, loadAsSRGB, bindFlags, importFlags, analyze ? &analysis : nullptr
+        );
 
         // Add new texture desc.
-        TextureDesc desc = {TextureState::Loaded, pTexture};
+        TextureDesc desc = {TextureState::Loaded, pTexture, analysis, analyze};
         handle = addDesc(desc);
 
         // Add to key-to-handle map.
@@ -409,35 +453,31 @@ void TextureManager::endDeferredLoading()
 
     // Load textures in parallel.
     std::atomic<size_t> texturesLoaded;
-    NumericRange<size_t> jobRange(0, jobs.size());
-    std::for_each(
-        std::execution::par_unseq,
-        jobRange.begin(),
-        jobRange.end(),
+    Threading::parallelFor(
+        0,
+        jobs.size(),
         [&](size_t i)
         {
             const auto& job = jobs[i];
             auto& desc = getDesc(job.handle);
-            if (job.key.fullPaths.size() == 1)
-            {
-                desc.pTexture = Texture::createFromFile(
-                    mpDevice, job.key.fullPaths[0], job.key.generateMipLevels, job.key.loadAsSRGB, job.key.bindFlags, job.key.importFlags
-                );
-                logDebug("Loading texture from '{}'", job.key.fullPaths[0]);
-            }
-            else
-            {
-                desc.pTexture =
-                    Texture::createMippedFromFiles(mpDevice, job.key.fullPaths, job.key.loadAsSRGB, job.key.bindFlags, job.key.importFlags);
-                logDebug("Loading mipped texture from '{}'", job.key.fullPaths[0]);
-            }
+            desc.pTexture = AsyncTextureLoader::loadTexture(
+                mpDevice,
+                job.key.fullPaths,
+                job.key.generateMipLevels,
+                job.key.loadAsSRGB,
+                job.key.bindFlags,
+                job.key.importFlags,
+                desc.analyze ? &desc.analysis : nullptr
+            );
+            logDebug("Loading {}texture from '{}'", job.key.fullPaths.size() > 1 ? "mipped " : "", job.key.fullPaths[0]);
             if (texturesLoaded.fetch_add(1) % 10 == 9)
             {
                 logDebug("Flush");
                 std::lock_guard<std::mutex> lock(mpDevice->getGlobalGfxMutex());
                 mpDevice->wait();
             }
-        }
+        },
+        1
     );
     mpDevice->wait();
 
@@ -550,6 +590,15 @@ TextureManager::TextureDesc TextureManager::getTextureDesc(const CpuTextureHandl
     return mTextureDescs[handle.getID()];
 }
 
+std::optional<TextureAnalyzer::Result> TextureManager::getTextureAnalysis(const Texture* pTexture) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mTextureToHandle.find(pTexture);
+    if (it == mTextureToHandle.end())
+        return std::nullopt;
+    return mTextureDescs[it->second.getID()].analysis;
+}
+
 size_t TextureManager::getTextureDescCount() const
 {
     std::lock_guard<std::mutex> lock(mMutex);
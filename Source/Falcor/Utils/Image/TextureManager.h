@@ -39,6 +39,7 @@
 #include <set>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <thread>
 
 namespace Falcor
@@ -132,8 +133,10 @@ public:
     /// Struct describing a managed texture.
     struct TextureDesc
     {
-        TextureState state = TextureState::Invalid; ///< Current state of the texture.
-        ref<Texture> pTexture;                      ///< Valid texture object when state is 'Loaded', or nullptr if loading failed.
+        TextureState state = TextureState::Invalid;      ///< Current state of the texture.
+        ref<Texture> pTexture;                           ///< Valid texture object when state is 'Loaded', or nullptr if loading failed.
+        std::optional<TextureAnalyzer::Result> analysis; ///< CPU analysis of the texture contents if requested when loading.
+        bool analyze = false;                            ///< True if CPU analysis was requested by any load of the texture.
 
         bool isValid() const { return state != TextureState::Invalid; }
     };
@@ -142,9 +145,9 @@ public:
      * Constructor.
      * @param[in] pDevice GPU device.
      * @param[in] maxTextureCount Maximum number of textures that can be simultaneously managed.
-     * @param[in] threadCount Number of worker threads.
+     * @param[in] threadCount Number of worker threads for asynchronous loading. 0 uses the global thread count (see Threading::getThreadCount()).
      */
-    TextureManager(ref<Device> pDevice, size_t maxTextureCount, size_t threadCount = std::thread::hardware_concurrency());
+    TextureManager(ref<Device> pDevice, size_t maxTextureCount, size_t threadCount = 0);
 
     ~TextureManager();
 
@@ -169,6 +172,10 @@ public:
      * @param[in] importFlags Optional flags for the file import.
      * @param[in] assetResolver Optional asset resolver for resolving file paths.
      * @param[out] loadedTextureCount Optionally can provided the number of actually loaded textures (2+ can happen with UDIMs)
+     * @param[in] owner Optional object owning the texture (see removeTextures()).
+     * @param[in] analyze Analyze the texture contents on the CPU while loading. The result is available from getTextureAnalysis().
+     * Textures that are constant in all channels are created with a single texel (see Texture::createFromFile()).
+     * If the texture was already loaded without analysis, the image is decoded again and analyzed on the CPU.
      * @return Unique handle to the texture, or an invalid handle if the texture can't be found.
      */
     CpuTextureHandle loadTexture(
@@ -180,7 +187,8 @@ public:
         Bitmap::ImportFlags importFlags = Bitmap::ImportFlags::None,
         const AssetResolver* assetResolver = nullptr,
         size_t* loadedTextureCount = nullptr,
-        const Object* owner = nullptr
+        const Object* owner = nullptr,
+        bool analyze = false
     );
 
     /**
@@ -249,6 +257,13 @@ public:
      */
     std::vector<uint32_t> getUdimIDs(const CpuTextureHandle& handle) const;
 
+    /**
+     * Get the CPU analysis of a managed texture computed when it was loaded.
+     * @param[in] pTexture Texture.
+     * @return Analysis result, or std::nullopt if the texture is not managed or was not analyzed when loaded.
+     */
+    std::optional<TextureAnalyzer::Result> getTextureAnalysis(const Texture* pTexture) const;
+
     /**
      * Get texture desc count.
      * @return Number of texture descs.
@@ -300,7 +315,8 @@ private:
         bool async = true,
         Bitmap::ImportFlags importFlags = Bitmap::ImportFlags::None,
         const AssetResolver* assetResolver = nullptr,
-        size_t* loadedTextureCount = nullptr
+        size_t* loadedTextureCount = nullptr,
+        bool analyze = false
     );
 
     /**
@@ -184,6 +184,31 @@ public:
         return result;
     }
 
+    /**
+     * Evaluate the spline at the same local parameter in a range of sections.
+     * Gives the same results as calling interpolate() per section, but the loop over sections can be vectorized.
+     * @param[in] firstSection First section to evaluate.
+     * @param[in] sectionCount Number of sections to evaluate.
+     * @param[in] point Local parameter within each section.
+     * @param[out] results Results, the i-th section is written to results[i * stride].
+     * @param[in] stride Stride between results (in elements).
+     */
+    void interpolateSections(uint32_t firstSection, uint32_t sectionCount, float point, T* results, size_t stride = 1) const
+    {
+        const CubicCoeff* coeffs = mCoefficient.data() + firstSection;
+        for (uint32_t i = 0; i < sectionCount; i++)
+            results[i * stride] = (((coeffs[i].d * point) + coeffs[i].c) * point + coeffs[i].b) * point + coeffs[i].a;
+    }
+
+    /**
+     * Evaluate the second derivative of the spline with respect to the local parameter.
+     */
+    T interpolateSecondDerivative(uint32_t section, float point) const
+    {
+        const CubicCoeff& coeff = mCoefficient[section];
+        return T(2.f) * coeff.c + T(6.f) * coeff.d * point;
+    }
+
 private:
     struct CubicCoeff
     {
@@ -0,0 +1,224 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AliasTableBuilder.h"
+#include "Core/Error.h"
+#include "Utils/Threading.h"
+#include "Utils/Math/Common.h"
+#include <algorithm>
+#include <limits>
+
+namespace Falcor
+{
+namespace
+{
+/// Block size for the parallel reductions and scans. Fixed so that results don't depend on the thread count.
+const size_t kBlockSize = 4096;
+
+/**
+ * Compute the exclusive prefix sum prefix[i] = sum_{t < i} value(items[t]) for i in [0, items.size()].
+ */
+template<typename ValueFunc>
+std::vector<double> computePrefixSum(const std::vector<uint32_t>& items, ValueFunc value)
+{
+    const size_t blockCount = div_round_up(items.size(), kBlockSize);
+    std::vector<double> blockOffsets(blockCount + 1, 0.0);
+    Threading::parallelFor(
+        0,
+        blockCount,
+        [&](size_t b)
+        {
+            double sum = 0.0;
+            for (size_t t = b * kBlockSize; t < std::min(items.size(), (b + 1) * kBlockSize); ++t)
+                sum += value(items[t]);
+            blockOffsets[b + 1] = sum;
+        },
+        1
+    );
+    for (size_t b = 0; b < blockCount; ++b)
+        blockOffsets[b + 1] += blockOffsets[b];
+
+    std::vector<double> prefix(items.size() + 1);
+    prefix[0] = 0.0;
+    Threading::parallelFor(
+        0,
+        blockCount,
+        [&](size_t b)
+        {
+            double sum = blockOffsets[b];
+            for (size_t t = b * kBlockSize; t < std::min(items.size(), (b + 1) * kBlockSize); ++t)
+            {
+                sum += value(items[t]);
+                prefix[t + 1] = sum;
+            }
+        },
+        1
+    );
+    return prefix;
+}
+} // namespace
+
+double AliasTableBuilder::computeWeightSum(fstd::span<const float> weights)
+{
+    return Threading::parallelReduce(
+        0,
+        weights.size(),
+        0.0,
+        [&](size_t i) { return (double)weights[i]; },
+        [](double a, double b) { return a + b; },
+        kBlockSize
+    );
+}
+
+AliasTableBuilder::Result AliasTableBuilder::build(fstd::span<const float> weights, size_t sectionSize)
+{
+    // Use < since we need to be able to represent the item count.
+    FALCOR_CHECK(weights.size() < std::numeric_limits<uint32_t>::max(), "Too many entries for alias table.");
+    FALCOR_CHECK(sectionSize > 0, "Section size must be larger than zero.");
+
+    const uint32_t n = (uint32_t)weights.size();
+    Result result;
+    result.weightSum = computeWeightSum(weights);
+    result.entries.resize(n);
+    if (n == 0)
+        return result;
+
+    // Normalize weights to an average of one. If all weights are zero, sample uniformly.
+    const double scale = result.weightSum > 0.0 ? double(n) / result.weightSum : 0.0;
+    auto getNormalizedWeight = [&](uint32_t index) { return scale > 0.0 ? double(weights[index]) * scale : 1.0; };
+
+    // Stable partition into light and heavy items.
+    const size_t blockCount = div_round_up(size_t(n), kBlockSize);
+    std::vector<uint32_t> blockLightOffsets(blockCount + 1, 0);
+    Threading::parallelFor(
+        0,
+        blockCount,
+        [&](size_t b)
+        {
+            uint32_t count = 0;
+            for (uint32_t t = uint32_t(b * kBlockSize); t < std::min<size_t>(n, (b + 1) * kBlockSize); ++t)
+                count += getNormalizedWeight(t) < 1.0 ? 1 : 0;
+            blockLightOffsets[b + 1] = count;
+        },
+        1
+    );
+    for (size_t b = 0; b < blockCount; ++b)
+        blockLightOffsets[b + 1] += blockLightOffsets[b];
+
+    const uint32_t lightCount = blockLightOffsets[blockCount];
+    const uint32_t heavyCount = n - lightCount;
+    std::vector<uint32_t> lightItems(lightCount);
+    std::vector<uint32_t> heavyItems(heavyCount);
+    Threading::parallelFor(
+        0,
+        blockCount,
+        [&](size_t b)
+        {
+            uint32_t lightOffset = blockLightOffsets[b];
+            uint32_t heavyOffset = uint32_t(b * kBlockSize) - lightOffset;
+            for (uint32_t t = uint32_t(b * kBlockSize); t < std::min<size_t>(n, (b + 1) * kBlockSize); ++t)
+            {
+                if (getNormalizedWeight(t) < 1.0)
+                    lightItems[lightOffset++] = t;
+                else
+                    heavyItems[heavyOffset++] = t;
+            }
+        },
+        1
+    );
+
+    const std::vector<double> lightPrefix = computePrefixSum(lightItems, getNormalizedWeight);
+    const std::vector<double> heavyPrefix = computePrefixSum(heavyItems, getNormalizedWeight);
+
+    // Residual weight of heavy item j after the first i light and j heavy buckets have been filled.
+    // Each filled bucket holds a mass of one, so the residual follows from the prefix sums alone.
+    auto getResidual = [&](uint32_t i, uint32_t j) { return heavyPrefix[j + 1] - double(i + j) + lightPrefix[i]; };
+
+    // The sweep fills the bucket of the next light item while the current heavy item has a residual above one.
+    auto isLightStep = [&](uint32_t i, uint32_t j)
+    {
+        if (i >= lightCount)
+            return false;
+        if (j >= heavyCount)
+            return true;
+        return getResidual(i, j) > 1.0;
+    };
+
+    auto& entries = result.entries;
+    const size_t sectionCount = div_round_up(size_t(n), sectionSize);
+    Threading::parallelFor(
+        0,
+        sectionCount,
+        [&](size_t s)
+        {
+            const uint32_t kBegin = uint32_t(s * sectionSize);
+            const uint32_t kEnd = uint32_t(std::min<size_t>(n, kBegin + sectionSize));
+
+            // Find the sweep position on the diagonal i + j = kBegin. The light step predicate is monotonic along
+            // the diagonal, so this is the largest i where the step into (i, kBegin - i) is a light step.
+            uint32_t lo = kBegin > heavyCount ? kBegin - heavyCount : 0;
+            uint32_t hi = std::min(kBegin, lightCount);
+            while (lo < hi)
+            {
+                uint32_t mid = lo + (hi - lo + 1) / 2;
+                if (isLightStep(mid - 1, kBegin - mid))
+                    lo = mid;
+                else
+                    hi = mid - 1;
+            }
+
+            uint32_t i = lo;
+            uint32_t j = kBegin - lo;
+            for (uint32_t k = kBegin; k < kEnd; ++k)
+            {
+                if (isLightStep(i, j))
+                {
+                    // Light item: keep its own weight, take the rest from the current heavy item.
+                    uint32_t item = lightItems[i++];
+                    if (j < heavyCount)
+                        entries[item] = {float(std::clamp(getNormalizedWeight(item), 0.0, 1.0)), heavyItems[j]};
+                    else
+                        entries[item] = {1.f, item}; // Only happens due to numerical precision.
+                }
+                else
+                {
+                    // Heavy item: its residual fills its own bucket, the rest is taken from the next heavy item.
+                    uint32_t item = heavyItems[j];
+                    if (j + 1 < heavyCount)
+                        entries[item] = {float(std::clamp(getResidual(i, j), 0.0, 1.0)), heavyItems[j + 1]};
+                    else
+                        entries[item] = {1.f, item};
+                    j++;
+                }
+            }
+        },
+        1
+    );
+
+    return result;
+}
+} // namespace Falcor
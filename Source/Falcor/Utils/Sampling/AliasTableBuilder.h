@@ -0,0 +1,83 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <fstd/span.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * CPU construction of alias tables for sampling from a discrete probability distribution.
+ *
+ * The table has one entry per weight. Sampling picks an entry i uniformly and returns i with probability
+ * entry.threshold, otherwise entry.alias.
+ *
+ * The table is built in parallel with the method from Huebschle-Schneider and Sanders 2019,
+ * "Parallel Weighted Random Sampling". Weights are normalized to an average of one and partitioned into
+ * light (< 1) and heavy (>= 1) items. A sweep over both lists fills each light item's bucket with mass from
+ * the current heavy item, and closes the heavy item's own bucket once its residual drops to one or below.
+ * The residual at sweep position (i, j) only depends on prefix sums of the light and heavy weights, so the
+ * sweep is split into independent sections whose start positions are found with a binary search along the
+ * diagonal i + j = k. The result does not depend on the section size or thread count.
+ */
+class FALCOR_API AliasTableBuilder
+{
+public:
+    static constexpr size_t kDefaultSectionSize = 16384;
+
+    struct Entry
+    {
+        float threshold; ///< Probability of selecting the entry's own index.
+        uint32_t alias;  ///< Index selected with probability 1 - threshold.
+    };
+
+    struct Result
+    {
+        std::vector<Entry> entries; ///< Table entries, one per weight.
+        double weightSum = 0.0;     ///< Sum of all weights.
+    };
+
+    /**
+     * Build an alias table.
+     * The weights don't need to be normalized. If all weights are zero, the table samples uniformly.
+     * @param[in] weights Non-negative weights, at most 2^32-2 entries.
+     * @param[in] sectionSize Number of table entries processed per parallel task (only affects performance).
+     * @return Table entries and the weight sum.
+     */
+    static Result build(fstd::span<const float> weights, size_t sectionSize = kDefaultSectionSize);
+
+    /**
+     * Compute the sum of weights in double precision.
+     * The sum is computed in parallel over fixed size blocks, so the result is deterministic.
+     */
+    static double computeWeightSum(fstd::span<const float> weights);
+};
+} // namespace Falcor
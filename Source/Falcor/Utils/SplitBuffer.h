@@ -152,6 +152,63 @@ public:
         return ((bufferIndex << kBufferIndexOffset) | elementIndex);
     }
 
+    /// Allocates a sequence of ranges at once, returning the index at which each range starts.
+    /// The ranges are placed exactly as consecutive calls to `insertEmpty` would place them, but each CPU buffer is
+    /// reserved once with its final size, and the memory is not touched until the ranges are committed.
+    /// Every range must be made accessible with `commitRange` before it is written, in the order in which the ranges
+    /// were allocated, and all ranges must be committed before inserting any other items.
+    std::vector<uint32_t> allocateRanges(const std::vector<size_t>& itemCounts)
+    {
+        FALCOR_ASSERT(mGpuBuffers.empty(), "Cannot insert after creating GPU buffers.");
+        std::vector<size_t> bufferSizes(mCpuBuffers.size());
+        for (size_t i = 0; i < mCpuBuffers.size(); ++i)
+            bufferSizes[i] = mCpuBuffers[i].size();
+
+        std::vector<uint32_t> result(itemCounts.size(), 0);
+        for (size_t i = 0; i < itemCounts.size(); ++i)
+        {
+            const size_t itemCount = itemCounts[i];
+            if (itemCount == 0)
+                continue;
+
+            // Same placement as in insert(): use the buffer with the fewest items, or a new buffer if the items don't fit.
+            auto it = std::min_element(bufferSizes.begin(), bufferSizes.end());
+            uint32_t bufferIndex = std::distance(bufferSizes.begin(), it);
+            if ((bufferSizes[bufferIndex] + itemCount) * sizeof(T) > kBufferSizeLimit)
+            {
+                bufferIndex = bufferSizes.size();
+                if (bufferIndex >= kMaxBufferCount)
+                    FALCOR_THROW("Buffers {} cannot accomodate all the date within the buffer limit.", mBufferName);
+                bufferSizes.push_back(0);
+            }
+
+            const uint32_t elementIndex = bufferSizes[bufferIndex];
+            FALCOR_ASSERT((((1 << kBufferIndexOffset) - 1) & elementIndex) == elementIndex, "Element index overflows into buffer index");
+            bufferSizes[bufferIndex] += itemCount;
+            result[i] = ((bufferIndex << kBufferIndexOffset) | elementIndex);
+        }
+
+        mCpuBuffers.resize(bufferSizes.size());
+        for (size_t i = 0; i < mCpuBuffers.size(); ++i)
+            mCpuBuffers[i].reserve(bufferSizes[i]);
+        return result;
+    }
+
+    /// Makes a range returned by `allocateRanges` accessible and returns a pointer to its first item.
+    /// The items are value initialized. Must not be called concurrently, but the returned ranges can be written concurrently.
+    T* commitRange(uint32_t index, size_t itemCount)
+    {
+        FALCOR_ASSERT(mGpuBuffers.empty(), "Cannot insert after creating GPU buffers.");
+        if (itemCount == 0)
+            return nullptr;
+        std::vector<T>& buffer = mCpuBuffers[getBufferIndex(index)];
+        const size_t end = size_t(getElementIndex(index)) + itemCount;
+        FALCOR_ASSERT(end <= buffer.capacity(), "Range was not allocated with allocateRanges().");
+        if (buffer.size() < end)
+            buffer.resize(end);
+        return buffer.data() + getElementIndex(index);
+    }
+
     /// Creates the GPU buffers, locking further inserts.
     /// Will clear any existing GPU buffers.
     void createGpuBuffers(const ref<Device>& mpDevice, ResourceBindFlags bindFlags)
@@ -26,21 +26,31 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "TaskManager.h"
+#include "Utils/Threading.h"
 
 namespace Falcor
 {
 
-TaskManager::TaskManager(bool startPaused)
+TaskManager::TaskManager(bool startPaused) : mPaused(startPaused) {}
+
+void TaskManager::addTask(CpuTask&& task)
 {
-    if (startPaused)
-        mThreadPool.pause();
+    {
+        std::lock_guard<std::mutex> l(mTaskMutex);
+        ++mCurrentlyScheduled;
+        if (mPaused)
+        {
+            mPausedCpuTasks.push_back(std::move(task));
+            return;
+        }
+    }
+    // Dispatch outside of the lock, the task may execute inline if the global scheduler is not running.
+    dispatchCpuTask(std::move(task));
 }
 
-void TaskManager::addTask(CpuTask&& task)
+void TaskManager::dispatchCpuTask(CpuTask&& task)
 {
-    std::lock_guard<std::mutex> l(mTaskMutex);
-    ++mCurrentlyScheduled;
-    mThreadPool.push_task(
+    Threading::dispatchTask(
         [task = std::move(task), this]() mutable
         {
             ++mCurrentlyRunning;
@@ -64,7 +74,16 @@ void TaskManager::addTask(GpuTask&& task)
 
 void TaskManager::finish(RenderContext* renderContext)
 {
-    mThreadPool.unpause();
+    std::vector<CpuTask> pausedCpuTasks;
+    {
+        std::lock_guard<std::mutex> l(mTaskMutex);
+        mPaused = false;
+        pausedCpuTasks = std::move(mPausedCpuTasks);
+        mPausedCpuTasks.clear();
+    }
+    for (auto& task : pausedCpuTasks)
+        dispatchCpuTask(std::move(task));
+
     while (true)
     {
         while (true)
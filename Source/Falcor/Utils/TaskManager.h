@@ -29,8 +29,6 @@
 
 #include "Core/Macros.h"
 
-#include <BS_thread_pool/BS_thread_pool.hpp>
-
 #include <functional>
 #include <mutex>
 #include <condition_variable>
@@ -69,7 +67,12 @@ private:
     void executeCpuTask(CpuTask&& task);
 
 private:
-    BS::thread_pool mThreadPool;
+    /// Dispatches a CPU task to the global task scheduler.
+    void dispatchCpuTask(CpuTask&& task);
+
+private:
+    bool mPaused = false;
+    std::vector<CpuTask> mPausedCpuTasks;
     std::atomic_size_t mCurrentlyRunning{0};
     std::atomic_size_t mCurrentlyScheduled{0};
 
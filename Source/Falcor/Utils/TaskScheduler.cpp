@@ -0,0 +1,406 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TaskScheduler.h"
+#include "Core/Error.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+namespace Falcor
+{
+namespace
+{
+/// Maximum number of chunks per thread that parallelFor() creates when no grain size is given.
+const size_t kChunksPerThread = 4;
+
+/// Time a thread waiting on a task sleeps before it looks for queued work again.
+const auto kHelpInterval = std::chrono::microseconds(100);
+
+/// Scheduler and worker index of the current thread.
+thread_local const TaskScheduler* tlsScheduler = nullptr;
+thread_local uint32_t tlsWorkerIndex = 0;
+} // namespace
+
+struct TaskScheduler::TaskState
+{
+    TaskScheduler* pScheduler = nullptr;
+    std::function<void()> func;
+    std::exception_ptr exception;
+    std::atomic<bool> done{false};
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::shared_ptr<TaskState>> continuations;
+};
+
+struct alignas(64) TaskScheduler::WorkerQueue
+{
+    std::mutex mutex;
+    std::deque<std::shared_ptr<TaskState>> tasks;
+};
+
+struct TaskScheduler::SyncData
+{
+    std::atomic<size_t> queuedCount{0};   ///< Number of tasks sitting in any queue.
+    std::atomic<size_t> pendingCount{0};  ///< Number of dispatched tasks that have not finished.
+    std::atomic<uint32_t> sleepingCount{0};
+    std::atomic<uint64_t> tasksExecuted{0};
+    std::atomic<uint64_t> tasksStolen{0};
+    bool terminate = false;
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+
+    std::mutex idleMutex;
+    std::condition_variable idleCondition;
+};
+
+// TaskScheduler::Task
+
+bool TaskScheduler::Task::isRunning() const
+{
+    return mpState && !mpState->done.load(std::memory_order_acquire);
+}
+
+void TaskScheduler::Task::finish()
+{
+    if (!mpState)
+        return;
+
+    TaskScheduler* pScheduler = mpState->pScheduler;
+    while (!mpState->done.load(std::memory_order_acquire))
+    {
+        // Help executing queued work. Only sleep if there is nothing to do, and wake up regularly since
+        // the awaited task may depend on work (e.g. continuations) that is queued later.
+        if (!pScheduler->runPendingTask())
+        {
+            std::unique_lock<std::mutex> lock(mpState->mutex);
+            mpState->condition.wait_for(lock, kHelpInterval, [&]() { return mpState->done.load(std::memory_order_acquire); });
+        }
+    }
+
+    if (mpState->exception)
+        std::rethrow_exception(mpState->exception);
+}
+
+TaskScheduler::Task TaskScheduler::Task::then(std::function<void()> func)
+{
+    FALCOR_CHECK(mpState, "Cannot add a continuation to an invalid task.");
+
+    auto pContinuation = std::make_shared<TaskState>();
+    pContinuation->pScheduler = mpState->pScheduler;
+    pContinuation->func = std::move(func);
+    mpState->pScheduler->mpSync->pendingCount++;
+
+    {
+        std::lock_guard<std::mutex> lock(mpState->mutex);
+        if (!mpState->done.load(std::memory_order_acquire))
+        {
+            mpState->continuations.push_back(pContinuation);
+            return Task(pContinuation);
+        }
+    }
+
+    // The task has already finished, schedule the continuation right away.
+    if (mpState->exception)
+        pContinuation->exception = mpState->exception;
+    mpState->pScheduler->schedule(pContinuation);
+    return Task(pContinuation);
+}
+
+// TaskScheduler
+
+TaskScheduler::TaskScheduler(uint32_t threadCount) : mpInjectionQueue(std::make_unique<WorkerQueue>()), mpSync(std::make_unique<SyncData>())
+{
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    // The calling thread is counted as one of the threads.
+    for (uint32_t i = 0; i + 1 < threadCount; ++i)
+        mWorkers.push_back(std::make_unique<WorkerQueue>());
+    for (uint32_t i = 0; i < (uint32_t)mWorkers.size(); ++i)
+        mThreads.emplace_back(&TaskScheduler::workerMain, this, i);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    waitIdle();
+
+    {
+        std::lock_guard<std::mutex> lock(mpSync->wakeMutex);
+        mpSync->terminate = true;
+    }
+    mpSync->wakeCondition.notify_all();
+
+    for (auto& thread : mThreads)
+        thread.join();
+}
+
+bool TaskScheduler::isWorkerThread() const
+{
+    return tlsScheduler == this;
+}
+
+TaskScheduler::Task TaskScheduler::dispatch(std::function<void()> func)
+{
+    auto pState = std::make_shared<TaskState>();
+    pState->pScheduler = this;
+    pState->func = std::move(func);
+    mpSync->pendingCount++;
+    schedule(pState);
+    return Task(pState);
+}
+
+void TaskScheduler::waitIdle()
+{
+    FALCOR_CHECK(!isWorkerThread(), "TaskScheduler::waitIdle() must not be called from a task.");
+
+    while (mpSync->pendingCount.load() > 0)
+    {
+        if (!runPendingTask())
+        {
+            std::unique_lock<std::mutex> lock(mpSync->idleMutex);
+            mpSync->idleCondition.wait_for(lock, kHelpInterval, [&]() { return mpSync->pendingCount.load() == 0; });
+        }
+    }
+}
+
+TaskScheduler::Stats TaskScheduler::getStats() const
+{
+    Stats stats;
+    stats.tasksExecuted = mpSync->tasksExecuted.load();
+    stats.tasksStolen = mpSync->tasksStolen.load();
+    return stats;
+}
+
+size_t TaskScheduler::getChunkSize(size_t count, size_t grainSize) const
+{
+    if (grainSize > 0)
+        return grainSize;
+    const size_t maxChunkCount = (size_t)getThreadCount() * kChunksPerThread;
+    return std::max<size_t>(1, (count + maxChunkCount - 1) / maxChunkCount);
+}
+
+void TaskScheduler::runChunks(size_t chunkCount, const std::function<void(size_t)>& func)
+{
+    if (chunkCount == 0)
+        return;
+
+    if (chunkCount == 1 || mWorkers.empty())
+    {
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+            func(chunk);
+        return;
+    }
+
+    // Chunks are claimed from a shared counter by the calling thread and a set of helper tasks.
+    // All helpers are waited on before returning, so it is safe to reference local state.
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr exception;
+    std::mutex exceptionMutex;
+
+    auto body = [&]()
+    {
+        size_t chunk;
+        while (!failed.load(std::memory_order_relaxed) && (chunk = nextChunk.fetch_add(1)) < chunkCount)
+        {
+            try
+            {
+                func(chunk);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!exception)
+                    exception = std::current_exception();
+                failed = true;
+            }
+        }
+    };
+
+    const size_t helperCount = std::min(mWorkers.size(), chunkCount - 1);
+    std::vector<Task> helpers;
+    helpers.reserve(helperCount);
+    for (size_t i = 0; i < helperCount; ++i)
+        helpers.push_back(dispatch(body));
+
+    body();
+
+    for (auto& helper : helpers)
+        helper.finish();
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void TaskScheduler::schedule(std::shared_ptr<TaskState> pState)
+{
+    // Without workers (or for continuations of failed tasks) execute right away.
+    if (mWorkers.empty() || pState->exception)
+    {
+        execute(pState);
+        return;
+    }
+
+    WorkerQueue& queue = isWorkerThread() ? *mWorkers[tlsWorkerIndex] : *mpInjectionQueue;
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(pState));
+        mpSync->queuedCount++;
+    }
+
+    // Wake up a sleeping worker. Workers increment the sleeping count before re-checking the queued count,
+    // so either the worker sees the new task or we see the sleeping worker.
+    if (mpSync->sleepingCount.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(mpSync->wakeMutex);
+        mpSync->wakeCondition.notify_one();
+    }
+}
+
+void TaskScheduler::execute(const std::shared_ptr<TaskState>& pState)
+{
+    if (!pState->exception)
+    {
+        try
+        {
+            pState->func();
+        }
+        catch (...)
+        {
+            pState->exception = std::current_exception();
+        }
+    }
+    pState->func = nullptr;
+    mpSync->tasksExecuted++;
+
+    std::vector<std::shared_ptr<TaskState>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(pState->mutex);
+        pState->done.store(true, std::memory_order_release);
+        continuations = std::move(pState->continuations);
+    }
+    pState->condition.notify_all();
+
+    for (auto& pContinuation : continuations)
+    {
+        pContinuation->exception = pState->exception;
+        schedule(std::move(pContinuation));
+    }
+
+    if (--mpSync->pendingCount == 0)
+    {
+        std::lock_guard<std::mutex> lock(mpSync->idleMutex);
+        mpSync->idleCondition.notify_all();
+    }
+}
+
+std::shared_ptr<TaskScheduler::TaskState> TaskScheduler::popTask()
+{
+    if (mpSync->queuedCount.load() == 0)
+        return nullptr;
+
+    auto tryPop = [&](WorkerQueue& queue, bool back) -> std::shared_ptr<TaskState>
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+            return nullptr;
+        std::shared_ptr<TaskState> pState;
+        if (back)
+        {
+            pState = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else
+        {
+            pState = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        mpSync->queuedCount--;
+        return pState;
+    };
+
+    // Own deque first (newest task), then the injection queue, then steal the oldest task from another worker.
+    const bool isWorker = isWorkerThread();
+    const uint32_t workerCount = (uint32_t)mWorkers.size();
+    if (isWorker)
+    {
+        if (auto pState = tryPop(*mWorkers[tlsWorkerIndex], true))
+            return pState;
+    }
+    if (auto pState = tryPop(*mpInjectionQueue, false))
+        return pState;
+    const uint32_t start = isWorker ? tlsWorkerIndex + 1 : 0;
+    for (uint32_t i = 0; i < workerCount; ++i)
+    {
+        const uint32_t victim = (start + i) % workerCount;
+        if (isWorker && victim == tlsWorkerIndex)
+            continue;
+        if (auto pState = tryPop(*mWorkers[victim], false))
+        {
+            mpSync->tasksStolen++;
+            return pState;
+        }
+    }
+    return nullptr;
+}
+
+bool TaskScheduler::runPendingTask()
+{
+    auto pState = popTask();
+    if (!pState)
+        return false;
+    execute(pState);
+    return true;
+}
+
+void TaskScheduler::workerMain(uint32_t workerIndex)
+{
+    tlsScheduler = this;
+    tlsWorkerIndex = workerIndex;
+
+    while (true)
+    {
+        if (runPendingTask())
+            continue;
+
+        std::unique_lock<std::mutex> lock(mpSync->wakeMutex);
+        mpSync->sleepingCount++;
+        mpSync->wakeCondition.wait(lock, [&]() { return mpSync->terminate || mpSync->queuedCount.load() > 0; });
+        mpSync->sleepingCount--;
+        if (mpSync->terminate && mpSync->queuedCount.load() == 0)
+            break;
+    }
+
+    tlsScheduler = nullptr;
+}
+
+} // namespace Falcor
@@ -0,0 +1,225 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+
+/**
+ * Work-stealing task scheduler.
+ *
+ * The scheduler owns (threadCount - 1) worker threads. The thread calling into parallelFor()/parallelReduce()
+ * or waiting on a task participates in executing work, so at most threadCount threads are busy at any time.
+ * Every worker has its own task deque. Tasks dispatched from a worker are pushed to the back of its own deque
+ * and popped from the back (LIFO, cache friendly for nested parallelism). Idle workers steal from the front
+ * of other workers' deques. Tasks dispatched from non-worker threads go to a shared injection queue.
+ *
+ * With a thread count of 1 there are no worker threads and all work executes on the calling thread.
+ */
+class FALCOR_API TaskScheduler
+{
+public:
+    struct TaskState;
+
+    /**
+     * Handle to a dispatched task.
+     */
+    class FALCOR_API Task
+    {
+    public:
+        Task() = default;
+
+        /// Check if the handle refers to a task.
+        bool isValid() const { return mpState != nullptr; }
+
+        /// Check if the task is still queued or executing.
+        bool isRunning() const;
+
+        /**
+         * Wait for the task to finish executing.
+         * The calling thread executes other queued tasks while waiting.
+         * Rethrows the exception if the task threw one.
+         */
+        void finish();
+
+        /**
+         * Add a continuation that is dispatched once this task has finished.
+         * If this task threw an exception, the continuation is not executed and its task rethrows the same exception.
+         * @param[in] func Function to execute.
+         * @return Handle to the continuation task.
+         */
+        Task then(std::function<void()> func);
+
+    private:
+        explicit Task(std::shared_ptr<TaskState> pState) : mpState(std::move(pState)) {}
+
+        std::shared_ptr<TaskState> mpState;
+
+        friend class TaskScheduler;
+    };
+
+    struct Stats
+    {
+        uint64_t tasksExecuted = 0; ///< Number of executed tasks.
+        uint64_t tasksStolen = 0;   ///< Number of tasks that were stolen from another worker's deque.
+    };
+
+    /**
+     * Create a scheduler.
+     * @param[in] threadCount Number of threads executing work, including the calling thread. 0 uses the number of logical cores.
+     */
+    explicit TaskScheduler(uint32_t threadCount = 0);
+
+    /// Waits for all dispatched tasks to finish and joins the worker threads.
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /// Returns the number of threads executing work, including the calling thread.
+    uint32_t getThreadCount() const { return (uint32_t)mWorkers.size() + 1; }
+
+    /// Returns true if the current thread is a worker thread of this scheduler.
+    bool isWorkerThread() const;
+
+    /**
+     * Dispatch a task.
+     * If the scheduler has no worker threads, the task is executed immediately on the calling thread.
+     * @param[in] func Function to execute.
+     * @return Handle to the task.
+     */
+    Task dispatch(std::function<void()> func);
+
+    /**
+     * Wait for all dispatched tasks (including tasks dispatched while waiting) to finish.
+     * Exceptions thrown by tasks are only reported through their task handles.
+     * Must not be called from a task.
+     */
+    void waitIdle();
+
+    /**
+     * Execute func(i) for all i in [begin, end) in parallel. Returns when all iterations are done.
+     * The range is split into chunks of grainSize iterations. Chunks are claimed dynamically, so uneven
+     * workloads are balanced across threads. If an iteration throws, remaining chunks are skipped and
+     * the first exception is rethrown on the calling thread.
+     * @param[in] begin First index.
+     * @param[in] end One past the last index.
+     * @param[in] func Function with signature void(size_t).
+     * @param[in] grainSize Number of iterations per chunk. 0 selects a size based on the thread count.
+     */
+    template<typename Func>
+    void parallelFor(size_t begin, size_t end, Func&& func, size_t grainSize = 0)
+    {
+        if (end <= begin)
+            return;
+        const size_t count = end - begin;
+        const size_t chunkSize = getChunkSize(count, grainSize);
+        const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+        runChunks(
+            chunkCount,
+            [&](size_t chunk)
+            {
+                const size_t chunkBegin = begin + chunk * chunkSize;
+                const size_t chunkEnd = std::min(chunkBegin + chunkSize, end);
+                for (size_t i = chunkBegin; i < chunkEnd; ++i)
+                    func(i);
+            }
+        );
+    }
+
+    /**
+     * Compute reduce(...reduce(reduce(identity, map(begin)), map(begin + 1))..., map(end - 1)) in parallel.
+     * Each chunk is reduced separately and the partial results are combined in chunk order,
+     * so the result is deterministic for a given grain size and thread count.
+     * @param[in] begin First index.
+     * @param[in] end One past the last index.
+     * @param[in] identity Identity element of the reduction.
+     * @param[in] map Function with signature T(size_t).
+     * @param[in] reduce Associative function with signature T(T, T).
+     * @param[in] grainSize Number of iterations per chunk. 0 selects a size based on the thread count.
+     * @return Reduced value.
+     */
+    template<typename T, typename MapFunc, typename ReduceFunc>
+    T parallelReduce(size_t begin, size_t end, T identity, MapFunc&& map, ReduceFunc&& reduce, size_t grainSize = 0)
+    {
+        if (end <= begin)
+            return identity;
+        const size_t count = end - begin;
+        const size_t chunkSize = getChunkSize(count, grainSize);
+        const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+        std::vector<T> partials(chunkCount, identity);
+        runChunks(
+            chunkCount,
+            [&](size_t chunk)
+            {
+                const size_t chunkBegin = begin + chunk * chunkSize;
+                const size_t chunkEnd = std::min(chunkBegin + chunkSize, end);
+                T value = identity;
+                for (size_t i = chunkBegin; i < chunkEnd; ++i)
+                    value = reduce(std::move(value), map(i));
+                partials[chunk] = std::move(value);
+            }
+        );
+        T result = std::move(identity);
+        for (T& partial : partials)
+            result = reduce(std::move(result), std::move(partial));
+        return result;
+    }
+
+    /// Returns scheduler statistics.
+    Stats getStats() const;
+
+private:
+    struct WorkerQueue;
+
+    size_t getChunkSize(size_t count, size_t grainSize) const;
+    void runChunks(size_t chunkCount, const std::function<void(size_t)>& func);
+
+    void schedule(std::shared_ptr<TaskState> pState);
+    void execute(const std::shared_ptr<TaskState>& pState);
+    std::shared_ptr<TaskState> popTask();
+    bool runPendingTask();
+    void workerMain(uint32_t workerIndex);
+
+    std::vector<std::unique_ptr<WorkerQueue>> mWorkers;
+    std::unique_ptr<WorkerQueue> mpInjectionQueue;
+    std::vector<std::thread> mThreads;
+
+    struct SyncData;
+    std::unique_ptr<SyncData> mpSync;
+};
+
+} // namespace Falcor
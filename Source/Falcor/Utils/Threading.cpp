@@ -27,6 +27,12 @@
  **************************************************************************/
 #include "Threading.h"
 #include "Core/Error.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <string>
 
 namespace Falcor
 {
@@ -34,23 +40,56 @@ namespace
 {
 struct ThreadingData
 {
-    bool initialized = false;
-    std::vector<std::thread> threads;
-    uint32_t current;
+    std::unique_ptr<TaskScheduler> pScheduler;
+    std::atomic<TaskScheduler*> pActiveScheduler{nullptr};
+    uint32_t threadCountSetting = 0;
 } gData; // TODO: REMOVEGLOBAL
-} // namespace
 
-static std::mutex sThreadingInitMutex;
-static uint32_t sThreadingInitCount = 0;
+std::mutex sThreadingInitMutex;
+uint32_t sThreadingInitCount = 0;
+
+uint32_t resolveThreadCount(uint32_t threadCount)
+{
+    if (threadCount == 0)
+        threadCount = gData.threadCountSetting;
+    if (threadCount == 0)
+    {
+        if (const char* env = std::getenv("FALCOR_THREAD_COUNT"))
+        {
+            try
+            {
+                threadCount = (uint32_t)std::stoul(env);
+            }
+            catch (const std::exception&)
+            {
+                logWarning("Ignoring invalid FALCOR_THREAD_COUNT value '{}'.", env);
+            }
+        }
+    }
+    if (threadCount == 0)
+        threadCount = std::max(1u, Threading::getLogicalThreadCount());
+    return threadCount;
+}
+
+void createScheduler(uint32_t threadCount)
+{
+    gData.pScheduler = std::make_unique<TaskScheduler>(threadCount);
+    gData.pActiveScheduler = gData.pScheduler.get();
+    logDebug("Started task scheduler with {} threads.", gData.pScheduler->getThreadCount());
+}
+
+void destroyScheduler()
+{
+    gData.pActiveScheduler = nullptr;
+    gData.pScheduler.reset();
+}
+} // namespace
 
 void Threading::start(uint32_t threadCount)
 {
     std::lock_guard<std::mutex> lock(sThreadingInitMutex);
     if (sThreadingInitCount++ == 0)
-    {
-        gData.threads.resize(threadCount);
-        gData.initialized = true;
-    }
+        createScheduler(resolveThreadCount(threadCount));
 }
 
 void Threading::shutdown()
@@ -58,47 +97,50 @@ void Threading::shutdown()
     std::lock_guard<std::mutex> lock(sThreadingInitMutex);
     uint32_t count = sThreadingInitCount--;
     if (count == 1)
-    {
-        for (auto& t : gData.threads)
-            if (t.joinable())
-                t.join();
-        gData.initialized = false;
-    }
+        destroyScheduler();
     else if (count == 0)
         FALCOR_THROW("Threading::stop() called more times than Threading::start().");
 }
 
-Threading::Task Threading::dispatchTask(const std::function<void(void)>& func)
+void Threading::setThreadCount(uint32_t threadCount)
 {
-    FALCOR_ASSERT(gData.initialized);
-
-    std::thread& t = gData.threads[gData.current];
-    if (t.joinable())
-        t.join();
-    t = std::thread(func);
-    gData.current = (gData.current + 1) % gData.threads.size();
-
-    return Task();
+    std::lock_guard<std::mutex> lock(sThreadingInitMutex);
+    gData.threadCountSetting = threadCount;
+    if (gData.pScheduler)
+    {
+        FALCOR_CHECK(!gData.pScheduler->isWorkerThread(), "Threading::setThreadCount() must not be called from a task.");
+        uint32_t newThreadCount = resolveThreadCount(0);
+        if (newThreadCount != gData.pScheduler->getThreadCount())
+        {
+            destroyScheduler();
+            createScheduler(newThreadCount);
+        }
+    }
 }
 
-void Threading::finish()
+uint32_t Threading::getThreadCount()
 {
-    for (auto& t : gData.threads)
-    {
-        if (t.joinable())
-            t.join();
-    }
+    TaskScheduler* pScheduler = getScheduler();
+    return pScheduler ? pScheduler->getThreadCount() : 1;
 }
 
-Threading::Task::Task() {}
+TaskScheduler* Threading::getScheduler()
+{
+    return gData.pActiveScheduler.load(std::memory_order_acquire);
+}
 
-bool Threading::Task::isRunning()
+Threading::Task Threading::dispatchTask(std::function<void(void)> func)
 {
-    FALCOR_UNIMPLEMENTED();
+    if (TaskScheduler* pScheduler = getScheduler())
+        return pScheduler->dispatch(std::move(func));
+
+    func();
+    return Task();
 }
 
-void Threading::Task::finish()
+void Threading::finish()
 {
-    FALCOR_UNIMPLEMENTED();
+    if (TaskScheduler* pScheduler = getScheduler())
+        pScheduler->waitIdle();
 }
 } // namespace Falcor
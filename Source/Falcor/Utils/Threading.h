@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "Core/Macros.h"
+#include "Utils/TaskScheduler.h"
 #include <condition_variable>
 #include <functional>
 #include <mutex>
@@ -35,56 +36,99 @@
 
 namespace Falcor
 {
+/**
+ * Falcor-wide task scheduling.
+ *
+ * Owns the global work-stealing TaskScheduler used for all CPU parallelism in Falcor.
+ * The number of threads is controlled by setThreadCount(), the FALCOR_THREAD_COUNT environment variable,
+ * or defaults to the number of logical cores (in that order of precedence).
+ * If the global scheduler has not been started, all work executes on the calling thread.
+ */
 class FALCOR_API Threading
 {
 public:
-    const static uint32_t kDefaultThreadCount = 16;
+    using Task = TaskScheduler::Task;
 
     /**
-     * Handle to a dispatched task
-     *
-     * TODO: Implementation
+     * Initializes the global thread pool.
+     * Calls are reference counted, only the first call creates the pool.
+     * @param[in] threadCount Number of threads executing work (including the calling thread). 0 uses the global thread count setting.
      */
-    class Task
-    {
-    public:
-        ///  Check if task is still executing
-        bool isRunning();
-
-        /// Wait for task to finish executing
-        void finish();
+    static void start(uint32_t threadCount = 0);
 
-    private:
-        Task();
-        friend class Threading;
-    };
+    /**
+     * Waits for all dispatched tasks to finish.
+     */
+    static void finish();
 
     /**
-     * Initializes the global thread pool
-     * @param[in] threadCount Number of threads in the pool
+     * Waits for all dispatched tasks to finish and shuts down the thread pool
      */
-    static void start(uint32_t threadCount = kDefaultThreadCount);
+    static void shutdown();
 
     /**
-     * Waits for all currently executing threads to finish
+     * Set the global thread count setting.
+     * If the thread pool is running, it is recreated with the new thread count after all dispatched tasks have finished.
+     * Must not be called while other threads are dispatching work.
+     * @param[in] threadCount Number of threads executing work (including the calling thread). 0 restores the default.
      */
-    static void finish();
+    static void setThreadCount(uint32_t threadCount);
 
     /**
-     * Waits for all currently executing threads to finish and shuts down the thread pool
+     * Returns the number of threads executing work. Returns 1 if the thread pool is not running.
      */
-    static void shutdown();
+    static uint32_t getThreadCount();
 
     /**
      * Returns the maximum number of concurrent threads supported by the hardware
      */
     static uint32_t getLogicalThreadCount() { return std::thread::hardware_concurrency(); }
 
+    /**
+     * Returns the global scheduler or nullptr if the thread pool is not running.
+     */
+    static TaskScheduler* getScheduler();
+
     /**
      * Starts a task on an available thread.
+     * If the thread pool is not running, the task is executed immediately on the calling thread.
      * @return Handle to the task
      */
-    static Task dispatchTask(const std::function<void(void)>& func);
+    static Task dispatchTask(std::function<void(void)> func);
+
+    /**
+     * Execute func(i) for all i in [begin, end) in parallel on the global scheduler.
+     * See TaskScheduler::parallelFor().
+     */
+    template<typename Func>
+    static void parallelFor(size_t begin, size_t end, Func&& func, size_t grainSize = 0)
+    {
+        if (TaskScheduler* pScheduler = getScheduler())
+        {
+            pScheduler->parallelFor(begin, end, std::forward<Func>(func), grainSize);
+        }
+        else
+        {
+            for (size_t i = begin; i < end; ++i)
+                func(i);
+        }
+    }
+
+    /**
+     * Parallel reduction over [begin, end) on the global scheduler.
+     * See TaskScheduler::parallelReduce().
+     */
+    template<typename T, typename MapFunc, typename ReduceFunc>
+    static T parallelReduce(size_t begin, size_t end, T identity, MapFunc&& map, ReduceFunc&& reduce, size_t grainSize = 0)
+    {
+        if (TaskScheduler* pScheduler = getScheduler())
+            return pScheduler->parallelReduce(begin, end, std::move(identity), map, reduce, grainSize);
+
+        T result = std::move(identity);
+        for (size_t i = begin; i < end; ++i)
+            result = reduce(std::move(result), map(i));
+        return result;
+    }
 };
 
 /**
@@ -26,8 +26,13 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "TimeReport.h"
+#include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <numeric>
 
 namespace Falcor
@@ -37,41 +42,144 @@ TimeReport::TimeReport()
     reset();
 }
 
+TimeReport::~TimeReport()
+{
+    stopSampler();
+}
+
+void TimeReport::enableMemoryTracking(uint32_t samplingIntervalMS)
+{
+    if (mMemoryTracking)
+        return;
+    mMemoryTracking = true;
+    mPhasePeakBytes = getCurrentRSS();
+    mStopSampler = false;
+
+    // Poll the resident set size. Short lived allocations between two calls to measure() are caught
+    // as long as they live for at least the sampling interval.
+    mpSampler = std::make_unique<std::thread>(
+        [this, samplingIntervalMS]()
+        {
+            while (!mStopSampler.load(std::memory_order_relaxed))
+            {
+                uint64_t current = getCurrentRSS();
+                uint64_t peak = mPhasePeakBytes.load(std::memory_order_relaxed);
+                while (current > peak && !mPhasePeakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+                    ;
+                std::this_thread::sleep_for(std::chrono::milliseconds(samplingIntervalMS));
+            }
+        }
+    );
+}
+
+void TimeReport::stopSampler()
+{
+    if (mpSampler)
+    {
+        mStopSampler = true;
+        mpSampler->join();
+        mpSampler.reset();
+    }
+}
+
+uint64_t TimeReport::takePhasePeak(uint64_t currentBytes)
+{
+    uint64_t peak = mPhasePeakBytes.exchange(currentBytes, std::memory_order_relaxed);
+    return std::max(peak, currentBytes);
+}
+
 void TimeReport::reset()
 {
     mLastMeasureTime = CpuTimer::getCurrentTimePoint();
     mMeasurements.clear();
     mTotal = 0.0;
+    if (mMemoryTracking)
+        mPhasePeakBytes = getCurrentRSS();
 }
 
 void TimeReport::resetTimer()
 {
     mLastMeasureTime = CpuTimer::getCurrentTimePoint();
     mTotal = 0.0;
+    if (mMemoryTracking)
+        mPhasePeakBytes = getCurrentRSS();
 }
 
 void TimeReport::printToLog()
 {
-    for (const auto& [task, duration] : mMeasurements)
+    for (const auto& record : mMeasurements)
     {
+        std::string memory;
+        if (mMemoryTracking)
+        {
+            memory = ", resident " + formatByteSize(record.residentBytes) + ", peak " + formatByteSize(record.peakResidentBytes);
+            if (record.trackedBytes > 0)
+                memory += ", tracked " + formatByteSize(record.trackedBytes);
+        }
         logInfo(
-            padStringToLength(task + ":", 25) + " " + std::to_string(duration) + " s" +
-            (mTotal > 0.0 && !mMeasurements.empty() ? ", " + std::to_string(100.0 * duration / mTotal) + "% of total" : "")
+            padStringToLength(record.name + ":", 25) + " " + std::to_string(record.seconds) + " s" +
+            (mTotal > 0.0 && !mMeasurements.empty() ? ", " + std::to_string(100.0 * record.seconds / mTotal) + "% of total" : "") + memory
         );
     }
 }
 
-void TimeReport::measure(const std::string& name)
+void TimeReport::measure(const std::string& name, uint64_t trackedBytes)
 {
     auto currentTime = CpuTimer::getCurrentTimePoint();
     std::chrono::duration<double> duration = currentTime - mLastMeasureTime;
-    mLastMeasureTime = currentTime;
-    mMeasurements.push_back({name, duration.count()});
+
+    Record record;
+    record.name = name;
+    record.seconds = duration.count();
+    record.trackedBytes = trackedBytes;
+    if (mMemoryTracking)
+    {
+        record.residentBytes = getCurrentRSS();
+        record.peakResidentBytes = takePhasePeak(record.residentBytes);
+    }
+    mMeasurements.push_back(std::move(record));
+
+    // Don't count the time spent sampling memory towards the next task.
+    mLastMeasureTime = mMemoryTracking ? CpuTimer::getCurrentTimePoint() : currentTime;
 }
 
 void TimeReport::addTotal(const std::string name)
 {
-    mTotal = std::accumulate(mMeasurements.begin(), mMeasurements.end(), 0.0, [](double t, auto&& m) { return t + m.second; });
-    mMeasurements.push_back({"Total", mTotal});
+    mTotal = std::accumulate(mMeasurements.begin(), mMeasurements.end(), 0.0, [](double t, const Record& r) { return t + r.seconds; });
+
+    Record total;
+    total.name = "Total";
+    total.seconds = mTotal;
+    for (const auto& record : mMeasurements)
+    {
+        total.residentBytes = record.residentBytes;
+        total.peakResidentBytes = std::max(total.peakResidentBytes, record.peakResidentBytes);
+        total.trackedBytes = std::max(total.trackedBytes, record.trackedBytes);
+    }
+    mMeasurements.push_back(std::move(total));
+}
+
+void TimeReport::writeJson(const std::filesystem::path& path) const
+{
+    nlohmann::json records = nlohmann::json::array();
+    for (const auto& record : mMeasurements)
+    {
+        records.push_back({
+            {"name", record.name},
+            {"seconds", record.seconds},
+            {"resident_bytes", record.residentBytes},
+            {"peak_resident_bytes", record.peakResidentBytes},
+            {"tracked_bytes", record.trackedBytes},
+        });
+    }
+
+    nlohmann::json json = {{"memory_tracking", mMemoryTracking}, {"records", std::move(records)}};
+    std::ofstream ofs(path);
+    if (!ofs)
+    {
+        logWarning("Failed to write time report to '{}'.", path);
+        return;
+    }
+    ofs << json.dump(4) << std::endl;
 }
 } // namespace Falcor
@@ -28,8 +28,12 @@
 #pragma once
 #include "CpuTimer.h"
 #include "Core/Macros.h"
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
 #include <string>
-#include <utility>
+#include <thread>
 #include <vector>
 
 namespace Falcor
@@ -37,11 +41,40 @@ namespace Falcor
 /**
  * Utility class to record a number of timing measurements and print them afterwards.
  * This is mainly intended for measuring longer running tasks on the CPU.
+ *
+ * Optionally, memory usage can be recorded alongside each measurement (see enableMemoryTracking()).
+ * The resident set size of the process is then sampled on a background thread so that each record
+ * also holds the peak resident size reached while the measured task was running.
  */
 class FALCOR_API TimeReport
 {
 public:
+    struct Record
+    {
+        std::string name;               ///< Name of the record.
+        double seconds = 0.0;           ///< Duration in seconds.
+        uint64_t residentBytes = 0;     ///< Resident set size at the end of the task (0 if memory tracking is disabled).
+        uint64_t peakResidentBytes = 0; ///< Peak resident set size while the task was running (0 if memory tracking is disabled).
+        uint64_t trackedBytes = 0;      ///< Caller provided number of bytes held by the tracked data structures.
+    };
+
     TimeReport();
+    ~TimeReport();
+
+    TimeReport(const TimeReport&) = delete;
+    TimeReport& operator=(const TimeReport&) = delete;
+
+    /**
+     * Enable recording of memory usage.
+     * This starts a background thread sampling the resident set size of the process.
+     * @param[in] samplingIntervalMS Sampling interval in milliseconds.
+     */
+    void enableMemoryTracking(uint32_t samplingIntervalMS = 1);
+
+    /**
+     * Returns true if memory usage is recorded.
+     */
+    bool isMemoryTrackingEnabled() const { return mMemoryTracking; }
 
     /**
      * Resets the recorded measurements and the internal timer.
@@ -62,8 +95,9 @@ public:
      * Records a time measurement.
      * Measures time since last call to reset() or measure(), whichever happened more recently.
      * @param[in] name Name of the record.
+     * @param[in] trackedBytes Optional number of bytes held by data structures the caller tracks itself.
      */
-    void measure(const std::string& name);
+    void measure(const std::string& name, uint64_t trackedBytes = 0);
 
     /**
      * Add a record containing the total of all measurements.
@@ -71,9 +105,28 @@ public:
      */
     void addTotal(const std::string name = "Total");
 
+    /**
+     * Returns the recorded measurements.
+     */
+    const std::vector<Record>& getRecords() const { return mMeasurements; }
+
+    /**
+     * Writes the recorded measurements to a JSON file.
+     * @param[in] path File path.
+     */
+    void writeJson(const std::filesystem::path& path) const;
+
 private:
+    void stopSampler();
+    uint64_t takePhasePeak(uint64_t currentBytes);
+
     CpuTimer::TimePoint mLastMeasureTime;
-    std::vector<std::pair<std::string, double>> mMeasurements;
+    std::vector<Record> mMeasurements;
     double mTotal = 0.0;
+
+    bool mMemoryTracking = false;
+    std::atomic<uint64_t> mPhasePeakBytes{0};
+    std::atomic<bool> mStopSampler{false};
+    std::unique_ptr<std::thread> mpSampler;
 };
 } // namespace Falcor
@@ -36,6 +36,7 @@
 #include "Utils/Scripting/Scripting.h"
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Settings/Settings.h"
+#include "Utils/Threading.h"
 
 #include <args.hxx>
 
@@ -851,6 +852,7 @@ int runMain(int argc, char** argv)
     args::Flag enableDebugLayerFlag(parser, "", "Enable debug layer (enabled by default in Debug build).", {"enable-debug-layer"});
     args::Flag preciseProgramFlag(parser, "", "Force all slang programs to run in precise mode", { "precise" });
     args::ValueFlag<std::string> attributesFlag(parser, "path", "JSON attributes file.", { 'a', "attributes" });
+    args::ValueFlag<uint32_t> threadsFlag(parser, "N", "Number of CPU threads (default: number of logical cores).", {"threads"});
     args::Flag rayTracingValidationFlag(parser, "", "Enable ray tracing validation (requires env-var NV_ALLOW_RAYTRACING_VALIDATION=1)", {"enable-raytracing-validation"});
 
     args::CompletionFlag completionFlag(parser, {"complete"});
@@ -898,6 +900,9 @@ int runMain(int argc, char** argv)
         Logger::setLogFilePath(logfile);
     }
 
+    if (threadsFlag)
+        Threading::setThreadCount(args::get(threadsFlag));
+
     if (attributesFlag)
     {
         std::filesystem::path attributesPath(args::get(attributesFlag));
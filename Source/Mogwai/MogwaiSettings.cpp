@@ -223,7 +223,7 @@ namespace Mogwai
         {
             g.text("Program compilation:\n");
 
-            const auto& s = mpRenderer->getDevice()->getProgramManager()->getCompilationStats();
+            const auto s = mpRenderer->getDevice()->getProgramManager()->getCompilationStats();
             double totalTime, downstreamTime;
             mpRenderer->getDevice()->getSlangGlobalSession()->getCompilerElapsedTime(&totalTime, &downstreamTime);
             std::ostringstream oss;
@@ -233,6 +233,8 @@ namespace Mogwai
                 << "Program kernels time (total): " << s.programKernelsTotalTime << " s" << std::endl
                 << "Program version time (max): " << s.programVersionMaxTime << " s" << std::endl
                 << "Program kernels time (max): " << s.programKernelsMaxTime << " s" << std::endl
+                << "Shader cache hits: " << s.shaderCacheHitCount << std::endl
+                << "Shader cache misses: " << s.shaderCacheMissCount << std::endl
                 << "Total shader code-gen time: " << totalTime << " s" << std::endl
                 << "Downstream compilation time: " << downstreamTime << " s" << std::endl;
             g.text(oss.str());
@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "Falcor.h"
 #include "RenderGraph/RenderPassStandardFlags.h"
+#include "Core/Program/ProgramManager.h"
 #include "GBufferRT.h"
 
 namespace
@@ -154,6 +155,20 @@ void GBufferRT::execute(RenderContext* pRenderContext, const RenderData& renderD
     mFrameCount++;
 }
 
+void GBufferRT::prewarmPrograms(RenderContext* pRenderContext, const RenderData& renderData)
+{
+    // Start compiling the ray tracing program in the background, it is needed at the first execute().
+    // The inline ray tracing path creates its program together with the compute pass vars and is not prewarmed.
+    if (!mpScene || mUseTraceRayInline || mRaytrace.pVars)
+        return;
+
+    mComputeDOF = mUseDOF && mpScene->getCamera()->getApertureRadius() > 0.f;
+    if (!mRaytrace.pProgram)
+        createRaytraceProgram(renderData);
+    mRaytrace.pProgram->addDefines(getShaderDefines(renderData));
+    mpDevice->getProgramManager()->enqueueProgramVersion(*mRaytrace.pProgram);
+}
+
 void GBufferRT::renderUI(Gui::Widgets& widget)
 {
     // Render the base class UI first.
@@ -216,63 +231,72 @@ void GBufferRT::parseProperties(const Properties& props)
 void GBufferRT::recreatePrograms()
 {
     mRaytrace.pProgram = nullptr;
+    mRaytrace.pBindingTable = nullptr;
     mRaytrace.pVars = nullptr;
     mpComputePass = nullptr;
 }
 
+void GBufferRT::createRaytraceProgram(const RenderData& renderData)
+{
+    DefineList defines;
+    defines.add(mpScene->getSceneDefines());
+    defines.add(mpSampleGenerator->getDefines());
+    defines.add(getShaderDefines(renderData));
+
+    // Create ray tracing program.
+    ProgramDesc desc;
+    desc.addShaderModules(mpScene->getShaderModules());
+    desc.addShaderLibrary(kProgramRaytraceFile);
+    desc.addTypeConformances(mpScene->getTypeConformances());
+    desc.setMaxPayloadSize(kMaxPayloadSizeBytes);
+    desc.setMaxAttributeSize(mpScene->getRaytracingMaxAttributeSize());
+    desc.setMaxTraceRecursionDepth(kMaxRecursionDepth);
+
+    mRaytrace.pBindingTable = RtBindingTable::create(1, 1, mpScene->getGeometryCount());
+    mRaytrace.pBindingTable->setRayGen(desc.addRayGen("rayGen"));
+    mRaytrace.pBindingTable->setMiss(0, desc.addMiss("miss"));
+    mRaytrace.pBindingTable->setHitGroup(
+        0, mpScene->getGeometryIDs(Scene::GeometryType::TriangleMesh), desc.addHitGroup("closestHit", "anyHit")
+    );
+
+    // Add hit group with intersection shader for displaced meshes.
+    if (mpScene->hasGeometryType(Scene::GeometryType::DisplacedTriangleMesh))
+    {
+        mRaytrace.pBindingTable->setHitGroup(
+            0,
+            mpScene->getGeometryIDs(Scene::GeometryType::DisplacedTriangleMesh),
+            desc.addHitGroup("displacedTriangleMeshClosestHit", "", "displacedTriangleMeshIntersection")
+        );
+    }
+
+    // Add hit group with intersection shader for curves (represented as linear swept spheres).
+    if (mpScene->hasGeometryType(Scene::GeometryType::Curve))
+    {
+        mRaytrace.pBindingTable->setHitGroup(
+            0, mpScene->getGeometryIDs(Scene::GeometryType::Curve), desc.addHitGroup("curveClosestHit", "", "curveIntersection")
+        );
+    }
+
+    // Add hit group with intersection shader for SDF grids.
+    if (mpScene->hasGeometryType(Scene::GeometryType::SDFGrid))
+    {
+        mRaytrace.pBindingTable->setHitGroup(
+            0, mpScene->getGeometryIDs(Scene::GeometryType::SDFGrid), desc.addHitGroup("sdfGridClosestHit", "", "sdfGridIntersection")
+        );
+    }
+
+    // Add hit groups for for other procedural primitives here.
+
+    mRaytrace.pProgram = Program::create(mpDevice, desc, defines);
+}
+
 void GBufferRT::executeRaytrace(RenderContext* pRenderContext, const RenderData& renderData)
 {
     if (!mRaytrace.pProgram || !mRaytrace.pVars)
     {
-        DefineList defines;
-        defines.add(mpScene->getSceneDefines());
-        defines.add(mpSampleGenerator->getDefines());
-        defines.add(getShaderDefines(renderData));
-
-        // Create ray tracing program.
-        ProgramDesc desc;
-        desc.addShaderModules(mpScene->getShaderModules());
-        desc.addShaderLibrary(kProgramRaytraceFile);
-        desc.addTypeConformances(mpScene->getTypeConformances());
-        desc.setMaxPayloadSize(kMaxPayloadSizeBytes);
-        desc.setMaxAttributeSize(mpScene->getRaytracingMaxAttributeSize());
-        desc.setMaxTraceRecursionDepth(kMaxRecursionDepth);
-
-        ref<RtBindingTable> sbt = RtBindingTable::create(1, 1, mpScene->getGeometryCount());
-        sbt->setRayGen(desc.addRayGen("rayGen"));
-        sbt->setMiss(0, desc.addMiss("miss"));
-        sbt->setHitGroup(0, mpScene->getGeometryIDs(Scene::GeometryType::TriangleMesh), desc.addHitGroup("closestHit", "anyHit"));
-
-        // Add hit group with intersection shader for displaced meshes.
-        if (mpScene->hasGeometryType(Scene::GeometryType::DisplacedTriangleMesh))
-        {
-            sbt->setHitGroup(
-                0,
-                mpScene->getGeometryIDs(Scene::GeometryType::DisplacedTriangleMesh),
-                desc.addHitGroup("displacedTriangleMeshClosestHit", "", "displacedTriangleMeshIntersection")
-            );
-        }
-
-        // Add hit group with intersection shader for curves (represented as linear swept spheres).
-        if (mpScene->hasGeometryType(Scene::GeometryType::Curve))
-        {
-            sbt->setHitGroup(
-                0, mpScene->getGeometryIDs(Scene::GeometryType::Curve), desc.addHitGroup("curveClosestHit", "", "curveIntersection")
-            );
-        }
-
-        // Add hit group with intersection shader for SDF grids.
-        if (mpScene->hasGeometryType(Scene::GeometryType::SDFGrid))
-        {
-            sbt->setHitGroup(
-                0, mpScene->getGeometryIDs(Scene::GeometryType::SDFGrid), desc.addHitGroup("sdfGridClosestHit", "", "sdfGridIntersection")
-            );
-        }
-
-        // Add hit groups for for other procedural primitives here.
-
-        mRaytrace.pProgram = Program::create(mpDevice, desc, defines);
-        mRaytrace.pVars = RtProgramVars::create(mpDevice, mRaytrace.pProgram, sbt);
+        if (!mRaytrace.pProgram)
+            createRaytraceProgram(renderData);
+        mRaytrace.pVars = RtProgramVars::create(mpDevice, mRaytrace.pProgram, mRaytrace.pBindingTable);
 
         // Bind static resources.
         ShaderVar var = mRaytrace.pVars->getRootVar();
@@ -47,6 +47,7 @@ public:
 
     RenderPassReflection reflect(const CompileData& compileData) override;
     void execute(RenderContext* pRenderContext, const RenderData& renderData) override;
+    void prewarmPrograms(RenderContext* pRenderContext, const RenderData& renderData) override;
     void renderUI(Gui::Widgets& widget) override;
     Properties getProperties() const override;
     void setScene(RenderContext* pRenderContext, const ref<Scene>& pScene) override;
@@ -54,6 +55,7 @@ public:
 private:
     void parseProperties(const Properties& props) override;
 
+    void createRaytraceProgram(const RenderData& renderData);
     void executeRaytrace(RenderContext* pRenderContext, const RenderData& renderData);
     void executeCompute(RenderContext* pRenderContext, const RenderData& renderData);
 
@@ -78,6 +80,7 @@ private:
     struct
     {
         ref<Program> pProgram;
+        ref<RtBindingTable> pBindingTable;
         ref<RtProgramVars> pVars;
     } mRaytrace;
 
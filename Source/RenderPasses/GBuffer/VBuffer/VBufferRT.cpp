@@ -28,6 +28,7 @@
 #include "VBufferRT.h"
 #include "Scene/HitInfo.h"
 #include "RenderGraph/RenderPassStandardFlags.h"
+#include "Core/Program/ProgramManager.h"
 #include "RenderGraph/RenderPassHelpers.h"
 
 namespace
@@ -127,6 +128,20 @@ void VBufferRT::execute(RenderContext* pRenderContext, const RenderData& renderD
     }
 }
 
+void VBufferRT::prewarmPrograms(RenderContext* pRenderContext, const RenderData& renderData)
+{
+    // Start compiling the ray tracing program in the background, it is needed at the first execute().
+    // The inline ray tracing path creates its program together with the compute pass vars and is not prewarmed.
+    if (!mpScene || mUseTraceRayInline || mRaytrace.pVars)
+        return;
+
+    mComputeDOF = mUseDOF && mpScene->getCamera()->getApertureRadius() > 0.f;
+    if (!mRaytrace.pProgram)
+        createRaytraceProgram(renderData);
+    mRaytrace.pProgram->addDefines(getShaderDefines(renderData));
+    mpDevice->getProgramManager()->enqueueProgramVersion(*mRaytrace.pProgram);
+}
+
 void VBufferRT::renderUI(Gui::Widgets& widget)
 {
     GBufferBase::renderUI(widget);
@@ -181,61 +196,70 @@ void VBufferRT::parseProperties(const Properties& props)
 void VBufferRT::recreatePrograms()
 {
     mRaytrace.pProgram = nullptr;
+    mRaytrace.pBindingTable = nullptr;
     mRaytrace.pVars = nullptr;
     mpComputePass = nullptr;
 }
 
-void VBufferRT::executeRaytrace(RenderContext* pRenderContext, const RenderData& renderData)
+void VBufferRT::createRaytraceProgram(const RenderData& renderData)
 {
-    if (!mRaytrace.pProgram || !mRaytrace.pVars)
-    {
-        DefineList defines;
-        defines.add(mpScene->getSceneDefines());
-        defines.add(mpSampleGenerator->getDefines());
-        defines.add(getShaderDefines(renderData));
-
-        // Create ray tracing program.
-        ProgramDesc desc;
-        desc.addShaderModules(mpScene->getShaderModules());
-        desc.addShaderLibrary(kProgramRaytraceFile);
-        desc.addTypeConformances(mpScene->getTypeConformances());
-        desc.setMaxPayloadSize(kMaxPayloadSizeBytes);
-        desc.setMaxAttributeSize(mpScene->getRaytracingMaxAttributeSize());
-        desc.setMaxTraceRecursionDepth(kMaxRecursionDepth);
+    DefineList defines;
+    defines.add(mpScene->getSceneDefines());
+    defines.add(mpSampleGenerator->getDefines());
+    defines.add(getShaderDefines(renderData));
+
+    // Create ray tracing program.
+    ProgramDesc desc;
+    desc.addShaderModules(mpScene->getShaderModules());
+    desc.addShaderLibrary(kProgramRaytraceFile);
+    desc.addTypeConformances(mpScene->getTypeConformances());
+    desc.setMaxPayloadSize(kMaxPayloadSizeBytes);
+    desc.setMaxAttributeSize(mpScene->getRaytracingMaxAttributeSize());
+    desc.setMaxTraceRecursionDepth(kMaxRecursionDepth);
+
+    mRaytrace.pBindingTable = RtBindingTable::create(1, 1, mpScene->getGeometryCount());
+    mRaytrace.pBindingTable->setRayGen(desc.addRayGen("rayGen"));
+    mRaytrace.pBindingTable->setMiss(0, desc.addMiss("miss"));
+    mRaytrace.pBindingTable->setHitGroup(
+        0, mpScene->getGeometryIDs(Scene::GeometryType::TriangleMesh), desc.addHitGroup("closestHit", "anyHit")
+    );
 
-        ref<RtBindingTable> sbt = RtBindingTable::create(1, 1, mpScene->getGeometryCount());
-        sbt->setRayGen(desc.addRayGen("rayGen"));
-        sbt->setMiss(0, desc.addMiss("miss"));
-        sbt->setHitGroup(0, mpScene->getGeometryIDs(Scene::GeometryType::TriangleMesh), desc.addHitGroup("closestHit", "anyHit"));
+    // Add hit group with intersection shader for triangle meshes with displacement maps.
+    if (mpScene->hasGeometryType(Scene::GeometryType::DisplacedTriangleMesh))
+    {
+        mRaytrace.pBindingTable->setHitGroup(
+            0,
+            mpScene->getGeometryIDs(Scene::GeometryType::DisplacedTriangleMesh),
+            desc.addHitGroup("displacedTriangleMeshClosestHit", "", "displacedTriangleMeshIntersection")
+        );
+    }
 
-        // Add hit group with intersection shader for triangle meshes with displacement maps.
-        if (mpScene->hasGeometryType(Scene::GeometryType::DisplacedTriangleMesh))
-        {
-            sbt->setHitGroup(
-                0,
-                mpScene->getGeometryIDs(Scene::GeometryType::DisplacedTriangleMesh),
-                desc.addHitGroup("displacedTriangleMeshClosestHit", "", "displacedTriangleMeshIntersection")
-            );
-        }
+    // Add hit group with intersection shader for curves (represented as linear swept spheres).
+    if (mpScene->hasGeometryType(Scene::GeometryType::Curve))
+    {
+        mRaytrace.pBindingTable->setHitGroup(
+            0, mpScene->getGeometryIDs(Scene::GeometryType::Curve), desc.addHitGroup("curveClosestHit", "", "curveIntersection")
+        );
+    }
 
-        // Add hit group with intersection shader for curves (represented as linear swept spheres).
-        if (mpScene->hasGeometryType(Scene::GeometryType::Curve))
-        {
-            sbt->setHitGroup(
-                0, mpScene->getGeometryIDs(Scene::GeometryType::Curve), desc.addHitGroup("curveClosestHit", "", "curveIntersection")
-            );
-        }
+    // Add hit group with intersection shader for SDF grids.
+    if (mpScene->hasGeometryType(Scene::GeometryType::SDFGrid))
+    {
+        mRaytrace.pBindingTable->setHitGroup(
+            0, mpScene->getGeometryIDs(Scene::GeometryType::SDFGrid), desc.addHitGroup("sdfGridClosestHit", "", "sdfGridIntersection")
+        );
+    }
 
-        // Add hit group with intersection shader for SDF grids.
-        if (mpScene->hasGeometryType(Scene::GeometryType::SDFGrid))
-        {
-            sbt->setHitGroup(
-                0, mpScene->getGeometryIDs(Scene::GeometryType::SDFGrid), desc.addHitGroup("sdfGridClosestHit", "", "sdfGridIntersection")
-            );
-        }
+    mRaytrace.pProgram = Program::create(mpDevice, desc, defines);
+}
 
-        mRaytrace.pProgram = Program::create(mpDevice, desc, defines);
-        mRaytrace.pVars = RtProgramVars::create(mpDevice, mRaytrace.pProgram, sbt);
+void VBufferRT::executeRaytrace(RenderContext* pRenderContext, const RenderData& renderData)
+{
+    if (!mRaytrace.pProgram || !mRaytrace.pVars)
+    {
+        if (!mRaytrace.pProgram)
+            createRaytraceProgram(renderData);
+        mRaytrace.pVars = RtProgramVars::create(mpDevice, mRaytrace.pProgram, mRaytrace.pBindingTable);
 
         // Bind static resources.
         ShaderVar var = mRaytrace.pVars->getRootVar();
@@ -1,5 +1,6 @@
 #include "IncomingLightPowerPass.h"
 #include "Utils/Math/FalcorMath.h"
+#include "Utils/Scripting/ndarray.h"
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
@@ -272,6 +273,33 @@ float4 IncomingLightPowerPass::CameraIncidentPower::compute(
 extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
 {
     registry.registerClass<RenderPass, IncomingLightPowerPass>();
+    ScriptBindings::registerBinding(IncomingLightPowerPass::registerBindings);
+}
+
+void IncomingLightPowerPass::registerBindings(pybind11::module& m)
+{
+    pybind11::class_<IncomingLightPowerPass, RenderPass, ref<IncomingLightPowerPass>> pass(m, "IncomingLightPowerPass");
+    pass.def_property_readonly("dataPointCount", &IncomingLightPowerPass::getCurrentDataPointCount);
+    pass.def_property_readonly("totalAccumulatedPower", &IncomingLightPowerPass::getTotalAccumulatedPower);
+
+    // Returns a zero-copy (N, 3) float32 view with the columns incident angle (deg), wavelength (nm) and power (W).
+    // The view shares ownership of the data points. While it is alive, new data is accumulated into a copy.
+    pass.def(
+        "getPowerData",
+        [](const IncomingLightPowerPass& self)
+        {
+            static_assert(sizeof(PowerDataPoint) == 3 * sizeof(float));
+            using SharedData = std::shared_ptr<const std::vector<PowerDataPoint>>;
+            SharedData pData = self.mpPowerDataPoints;
+            void* pFloats = const_cast<PowerDataPoint*>(pData->data());
+            pybind11::size_t shape[2] = {pData->size(), 3};
+            pybind11::capsule owner(new SharedData(std::move(pData)), [](void* p) noexcept { delete reinterpret_cast<SharedData*>(p); });
+            return pybind11::ndarray<pybind11::numpy>(
+                pFloats, 2, shape, owner, nullptr, pybind11::dtype<float>(), pybind11::device::cpu::value
+            );
+        },
+        pybind11::return_value_policy::reference
+    );
 }
 
 IncomingLightPowerPass::IncomingLightPowerPass(ref<Device> pDevice, const Properties& props) : RenderPass(pDevice)
@@ -976,12 +1004,12 @@ void IncomingLightPowerPass::renderUI(Gui::Widgets& widget)
         if (mEnablePhotodetectorAnalysis)
         {
             // Data storage information display
-            const float dataSizeMB = (mPowerDataPoints.size() * sizeof(PowerDataPoint)) / (1024.0f * 1024.0f);
+            const float dataSizeMB = (mpPowerDataPoints->size() * sizeof(PowerDataPoint)) / (1024.0f * 1024.0f);
             widget.text(fmt::format("Data Points: {} / {} ({:.2f}MB)",
-                                   mPowerDataPoints.size(), mMaxDataPoints, dataSizeMB));
+                                   mpPowerDataPoints->size(), mMaxDataPoints, dataSizeMB));
 
             // Storage status indicator
-            if (mPowerDataPoints.size() >= mMaxDataPoints)
+            if (mpPowerDataPoints->size() >= mMaxDataPoints)
             {
                 widget.text("WARNING: Maximum data points reached", true);
             }
@@ -2398,8 +2426,9 @@ void IncomingLightPowerPass::initializePowerData()
     try
     {
         // Clear existing data points
-        mPowerDataPoints.clear();
-        mPowerDataPoints.reserve(mMaxDataPoints);
+        std::vector<PowerDataPoint>& powerDataPoints = getWritablePowerDataPoints();
+        powerDataPoints.clear();
+        powerDataPoints.reserve(mMaxDataPoints);
 
         // Reset total accumulated power
         mTotalAccumulatedPower = 0.0f;
@@ -2427,9 +2456,10 @@ void IncomingLightPowerPass::initializePowerData()
         // Attempt recovery with smaller data size
         try
         {
-            mPowerDataPoints.clear();
+            std::vector<PowerDataPoint>& powerDataPoints = getWritablePowerDataPoints();
+            powerDataPoints.clear();
             mMaxDataPoints = 100000; // Fallback to smaller size
-            mPowerDataPoints.reserve(mMaxDataPoints);
+            powerDataPoints.reserve(mMaxDataPoints);
             logInfo("Recovery data storage initialized with {} data points", mMaxDataPoints);
         }
         catch (...)
@@ -2440,18 +2470,31 @@ void IncomingLightPowerPass::initializePowerData()
     }
 }
 
+std::vector<IncomingLightPowerPass::PowerDataPoint>& IncomingLightPowerPass::getWritablePowerDataPoints()
+{
+    // Python views share ownership of the data points. Copy them before modifying so that the views stay unchanged.
+    if (mpPowerDataPoints.use_count() > 1)
+    {
+        auto pCopy = std::make_shared<std::vector<PowerDataPoint>>();
+        pCopy->reserve(std::max<size_t>(mMaxDataPoints, mpPowerDataPoints->size()));
+        pCopy->assign(mpPowerDataPoints->begin(), mpPowerDataPoints->end());
+        mpPowerDataPoints = std::move(pCopy);
+    }
+    return *mpPowerDataPoints;
+}
+
 void IncomingLightPowerPass::resetPowerData()
 {
     try
     {
         // Clear all data points
-        mPowerDataPoints.clear();
+        getWritablePowerDataPoints().clear();
 
         // Reset accumulation counter
         mTotalAccumulatedPower = 0.0f;
 
         logInfo("Power data reset successfully - {} data points cleared",
-               mPowerDataPoints.size());
+               mpPowerDataPoints->size());
     }
     catch (const std::exception& e)
     {
@@ -2476,7 +2519,7 @@ bool IncomingLightPowerPass::exportPowerData()
     try
     {
         // Validate data before export
-        if (mPowerDataPoints.empty())
+        if (mpPowerDataPoints->empty())
         {
             logError("Power data is empty, cannot export");
             return false;
@@ -2495,13 +2538,13 @@ bool IncomingLightPowerPass::exportPowerData()
 
         // Write CSV header
         file << "# Photodetector Power Data Export\n";
-        file << "# Data points: " << mPowerDataPoints.size() << "\n";
+        file << "# Data points: " << mpPowerDataPoints->size() << "\n";
         file << "# Total accumulated power: " << mTotalAccumulatedPower << " W\n";
         file << "# Format: incident_angle_deg,wavelength_nm,power_w\n";
         file << "incident_angle,wavelength,power\n";
 
         // Write data points
-        for (const auto& dataPoint : mPowerDataPoints)
+        for (const auto& dataPoint : *mpPowerDataPoints)
         {
             file << dataPoint.incidentAngle << ","
                  << dataPoint.wavelength << ","
@@ -2509,7 +2552,7 @@ bool IncomingLightPowerPass::exportPowerData()
         }
 
         file.close();
-        logInfo("Power data exported to {} ({} data points)", filename, mPowerDataPoints.size());
+        logInfo("Power data exported to {} ({} data points)", filename, mpPowerDataPoints->size());
         return true;
     }
     catch (const std::exception& e)
@@ -2529,7 +2572,7 @@ void IncomingLightPowerPass::accumulatePowerData(RenderContext* pRenderContext)
     try
     {
         // Check if we're approaching data point limit
-        if (mPowerDataPoints.size() >= mMaxDataPoints)
+        if (mpPowerDataPoints->size() >= mMaxDataPoints)
         {
             logWarning("Maximum data points reached ({}), skipping accumulation", mMaxDataPoints);
             return;
@@ -2574,7 +2617,8 @@ void IncomingLightPowerPass::accumulatePowerData(RenderContext* pRenderContext)
         uint32_t invalidPixels = 0;
 
         // Process each pixel's power data
-        for (uint32_t i = 0; i < bufferSize && mPowerDataPoints.size() < mMaxDataPoints; i++)
+        std::vector<PowerDataPoint>& powerDataPoints = getWritablePowerDataPoints();
+        for (uint32_t i = 0; i < bufferSize && powerDataPoints.size() < mMaxDataPoints; i++)
         {
             uint32_t dataOffset = i * 4; // 4 floats per entry
 
@@ -2595,7 +2639,7 @@ void IncomingLightPowerPass::accumulatePowerData(RenderContext* pRenderContext)
                 dataPoint.wavelength = wavelength;
                 dataPoint.power = power;
 
-                mPowerDataPoints.push_back(dataPoint);
+                powerDataPoints.push_back(dataPoint);
                 mTotalAccumulatedPower += power;
                 validPixels++;
             }
@@ -2612,7 +2656,7 @@ void IncomingLightPowerPass::accumulatePowerData(RenderContext* pRenderContext)
         if (mDebugMode && (mFrameCount % mDebugLogFrequency == 0))
         {
             logInfo("Power data accumulation: {} valid pixels, {} invalid pixels, {} total data points, {:.6f} W total power",
-                    validPixels, invalidPixels, mPowerDataPoints.size(), mTotalAccumulatedPower);
+                    validPixels, invalidPixels, mpPowerDataPoints->size(), mTotalAccumulatedPower);
         }
 
         // Check for errors
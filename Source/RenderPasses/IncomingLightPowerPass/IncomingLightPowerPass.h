@@ -21,6 +21,8 @@ public:
 
     static ref<IncomingLightPowerPass> create(ref<Device> pDevice, const Properties& props) { return make_ref<IncomingLightPowerPass>(pDevice, props); }
 
+    static void registerBindings(pybind11::module& m);
+
     IncomingLightPowerPass(ref<Device> pDevice, const Properties& props);
 
     virtual Properties getProperties() const override;
@@ -95,7 +97,7 @@ public:
     uint32_t getMaxDataPoints() const { return mMaxDataPoints; }
     void setMaxDataPoints(uint32_t maxPoints) { mMaxDataPoints = maxPoints; }
 
-    uint32_t getCurrentDataPointCount() const { return static_cast<uint32_t>(mPowerDataPoints.size()); }
+    uint32_t getCurrentDataPointCount() const { return static_cast<uint32_t>(mpPowerDataPoints->size()); }
 
     float getTotalAccumulatedPower() const { return mTotalAccumulatedPower; }
 
@@ -235,7 +237,8 @@ private:
         float power;          ///< Power in watts
     };
 
-    std::vector<PowerDataPoint> mPowerDataPoints; ///< Direct storage of power data points
+    /// Direct storage of power data points. Shared with Python views, see getWritablePowerDataPoints().
+    std::shared_ptr<std::vector<PowerDataPoint>> mpPowerDataPoints = std::make_shared<std::vector<PowerDataPoint>>();
     float mTotalAccumulatedPower = 0.0f;          ///< Total accumulated power
     std::string mPowerDataExportPath = "./";      ///< Export path
     uint32_t mMaxDataPoints = 1000000;            ///< Maximum number of data points to store
@@ -305,6 +308,7 @@ private:
     // Photodetector matrix management functions
     void initializePowerData();
     void resetPowerData();
+    std::vector<PowerDataPoint>& getWritablePowerDataPoints();
     bool exportPowerData();
     void accumulatePowerData(RenderContext* pRenderContext);
 };
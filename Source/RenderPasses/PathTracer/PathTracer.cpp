@@ -28,6 +28,7 @@
 #include "PathTracer.h"
 #include "RenderGraph/RenderPassHelpers.h"
 #include "RenderGraph/RenderPassStandardFlags.h"
+#include "Core/Program/ProgramManager.h"
 #include "Rendering/Lights/EmissiveUniformSampler.h"
 
 
@@ -826,6 +827,12 @@ void PathTracer::TracePass::prepareProgram(ref<Device> pDevice, const DefineList
     FALCOR_ASSERT(pProgram != nullptr && pBindingTable != nullptr);
     pProgram->setDefines(defines);
     if (!passDefine.empty()) pProgram->addDefine(passDefine);
+    pDevice->getProgramManager()->enqueueProgramVersion(*pProgram);
+}
+
+void PathTracer::TracePass::prepareVars(ref<Device> pDevice)
+{
+    FALCOR_ASSERT(pProgram != nullptr && pBindingTable != nullptr);
     pVars = RtProgramVars::create(pDevice, pProgram, pBindingTable);
 }
 
@@ -840,12 +847,8 @@ void PathTracer::resetPrograms()
     mRecompile = true;
 }
 
-void PathTracer::updatePrograms()
+void PathTracer::createPrograms()
 {
-    FALCOR_ASSERT(mpScene);
-
-    if (mRecompile == false) return;
-
     // If we get here, a change that require recompilation of shader programs has occurred.
     // This may be due to change of scene defines, type conformances, shader modules, or other changes that require recompilation.
     // When type conformances and/or shader modules change, the programs need to be recreated. We assume programs have been reset upon such changes.
@@ -895,14 +898,34 @@ void PathTracer::updatePrograms()
     {
         // Note that we must use set instead of add defines to replace any stale state.
         pass->getProgram()->setDefines(defines);
-
-        // Recreate program vars. This may trigger recompilation if needed.
-        // Note that program versions are cached, so switching to a previously used specialization is faster.
-        pass->setVars(nullptr);
+        mpDevice->getProgramManager()->enqueueProgramVersion(*pass->getProgram());
     };
     preparePass(mpGeneratePaths);
     preparePass(mpResolvePass);
     preparePass(mpReflectTypes);
+}
+
+void PathTracer::updatePrograms()
+{
+    FALCOR_ASSERT(mpScene);
+
+    if (mRecompile == false) return;
+
+    // Create the programs and compile them in parallel.
+    // This runs after beginFrame() so that the defines from the emissive sampler, RTXDI, and other options are final.
+    createPrograms();
+
+    // Recreate program vars. This waits for the compilation of each program.
+    // Note that program versions are cached, so switching to a previously used specialization is faster.
+    mpTracePass->prepareVars(mpDevice);
+    if (mOutputNRDAdditionalData)
+    {
+        mpTraceDeltaReflectionPass->prepareVars(mpDevice);
+        mpTraceDeltaTransmissionPass->prepareVars(mpDevice);
+    }
+    mpGeneratePaths->setVars(nullptr);
+    mpResolvePass->setVars(nullptr);
+    mpReflectTypes->setVars(nullptr);
 
     // Get CIRPathData structure size via reflection
     if (mpTracePass && mpTracePass->pProgram)
@@ -86,11 +86,13 @@ private:
         }
 
         void prepareProgram(ref<Device> pDevice, const DefineList& defines);
+        void prepareVars(ref<Device> pDevice);
     };
 
     void parseProperties(const Properties& props);
     void validateOptions();
     void resetPrograms();
+    void createPrograms();
     void updatePrograms();
     void setFrameDim(const uint2 frameDim);
     void prepareResources(RenderContext* pRenderContext, const RenderData& renderData);
@@ -56,6 +56,20 @@ int runMain(int argc, char** argv)
     args::ValueFlag<std::string> tagFilterFlag(parser, "tags", "Filter test cases by tags.", {'t', "tags"});
     args::ValueFlag<std::string> xmlReportFlag(parser, "path", "XML report output file.", {'x', "xml-report"});
     args::ValueFlag<uint32_t> repeatFlag(parser, "N", "Number of times to repeat the test.", {'r', "repeat"});
+    args::ValueFlag<std::string> benchmarkJsonFlag(parser, "path", "Benchmark JSON report output file.", {"benchmark-json"});
+    args::ValueFlag<std::string> benchmarkBaselineFlag(
+        parser, "path", "Benchmark JSON report to compare against. Regressions fail the benchmark.", {"benchmark-baseline"}
+    );
+    args::ValueFlag<double> benchmarkThresholdFlag(
+        parser, "percent", "Median time regression that fails a benchmark (default: 10).", {"benchmark-threshold"}
+    );
+    args::ValueFlag<uint32_t> benchmarkSamplesFlag(
+        parser, "N", "Number of timed samples per benchmark (default: 10).", {"benchmark-samples"}
+    );
+    args::ValueFlag<double> benchmarkMinTimeFlag(parser, "ms", "Minimum time per benchmark sample (default: 10).", {"benchmark-min-time"});
+    args::ValueFlag<uint32_t> benchmarkAffinityFlag(
+        parser, "mask", "Pin benchmarks to the cores in the affinity mask.", {"benchmark-affinity"}
+    );
     args::Flag enableDebugLayerFlag(parser, "", "Enable debug layer (enabled by default in Debug build).", {"enable-debug-layer"});
     args::Flag enableAftermathFlag(parser, "", "Enable Aftermath GPU crash dump.", {"enable-aftermath"});
 
@@ -129,6 +143,18 @@ int runMain(int argc, char** argv)
         options.parallel = args::get(parallelFlag);
     if (repeatFlag)
         options.repeat = args::get(repeatFlag);
+    if (benchmarkJsonFlag)
+        options.benchmark.jsonReportPath = args::get(benchmarkJsonFlag);
+    if (benchmarkBaselineFlag)
+        options.benchmark.baselinePath = args::get(benchmarkBaselineFlag);
+    if (benchmarkThresholdFlag)
+        options.benchmark.regressionThreshold = args::get(benchmarkThresholdFlag) / 100.0;
+    if (benchmarkSamplesFlag)
+        options.benchmark.sampleCount = args::get(benchmarkSamplesFlag);
+    if (benchmarkMinTimeFlag)
+        options.benchmark.minSampleTimeMS = args::get(benchmarkMinTimeFlag);
+    if (benchmarkAffinityFlag)
+        options.benchmark.affinityMask = args::get(benchmarkAffinityFlag);
 
     if (listTestSuites || listTestCases || listTags)
     {
@@ -0,0 +1,216 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Utils/CIRAccumulator.h"
+#include <cmath>
+#include <cstring>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+std::vector<CIRPathData> createTestPaths(size_t count, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+    std::vector<CIRPathData> paths(count);
+    for (CIRPathData& p : paths)
+    {
+        std::memset(&p, 0, sizeof(p));
+        p.pathLength = 1.f + u(rng) * 30.f;
+        p.emissionAngle = u(rng) * 1.8f;  // Some paths are emitted backwards.
+        p.receptionAngle = u(rng) * 1.8f; // Some paths are outside the field of view.
+        p.reflectanceProduct = u(rng);
+        p.reflectionCount = rng() % 5;
+        p.flags = rng() & 0x3;
+        if (rng() % 100 == 0)
+            p.pathLength = -1.f;
+    }
+    return paths;
+}
+
+CIRStaticParameters getTestParameters()
+{
+    CIRStaticParameters params;
+    params.receiverArea = 1e-4f;
+    params.ledLambertianOrder = 1.5f;
+    params.receiverFOV = 1.2f;
+    return params;
+}
+
+/// Impulse response computed directly from the raw paths.
+std::vector<double> computeReferenceResponse(
+    const std::vector<std::vector<CIRPathData>>& frames,
+    const CIRStaticParameters& params,
+    double binWidth,
+    uint32_t binCount
+)
+{
+    std::vector<double> h(binCount, 0.0);
+    for (const auto& frame : frames)
+    {
+        for (const CIRPathData& p : frame)
+        {
+            double gain = computeCIRPathGain(p, params);
+            double index = std::floor((double)p.pathLength / params.lightSpeed / binWidth);
+            if (gain > 0.0 && index >= 0.0 && index < binCount)
+                h[(size_t)index] += gain;
+        }
+    }
+    for (double& value : h)
+        value /= (double)frames.size();
+    return h;
+}
+
+bool isClose(double a, double b, double relTol)
+{
+    return std::abs(a - b) <= relTol * std::max(std::abs(a), std::abs(b)) + 1e-300;
+}
+} // namespace
+
+CPU_TEST(CIRAccumulator_PathGain)
+{
+    CIRStaticParameters params = getTestParameters();
+    CIRPathData p = {};
+    p.pathLength = 2.f;
+    p.emissionAngle = 0.5f;
+    p.receptionAngle = 0.3f;
+    p.reflectanceProduct = 0.8f;
+
+    double m = params.ledLambertianOrder;
+    double expected = (m + 1.0) / (2.0 * 3.14159265358979323846) * std::pow(std::cos(0.5), m) * std::cos(0.3) * 1e-4 / 4.0 * 0.8;
+    EXPECT(isClose(computeCIRPathGain(p, params), expected, 1e-6));
+
+    p.receptionAngle = 1.3f; // Outside field of view.
+    EXPECT_EQ(computeCIRPathGain(p, params), 0.0);
+    p.receptionAngle = 0.3f;
+    p.emissionAngle = 2.f; // Emitted backwards.
+    EXPECT_EQ(computeCIRPathGain(p, params), 0.0);
+    p.emissionAngle = 0.5f;
+    p.pathLength = std::numeric_limits<float>::quiet_NaN();
+    EXPECT_EQ(computeCIRPathGain(p, params), 0.0);
+}
+
+CPU_TEST(CIRAccumulator_MergeMatchesRaw)
+{
+    std::mt19937 rng(1);
+    std::vector<std::vector<CIRPathData>> frames;
+    for (uint32_t i = 0; i < 8; i++)
+        frames.push_back(createTestPaths(20000 + i * 1000, rng));
+
+    CIRAccumulator::Desc desc;
+    desc.staticParams = getTestParameters();
+    desc.delayBinWidth = 1e-10;
+    desc.angleBinCount = 4;
+    CIRAccumulator accumulator(desc);
+
+    uint64_t pathCount = 0;
+    uint64_t storedPaths = 0;
+    double totalGain = 0.0;
+    for (const auto& frame : frames)
+    {
+        accumulator.addFrame(frame.data(), frame.size());
+        pathCount += frame.size();
+        for (const CIRPathData& p : frame)
+        {
+            double gain = computeCIRPathGain(p, desc.staticParams);
+            if (gain > 0.0)
+            {
+                storedPaths++;
+                totalGain += gain;
+            }
+        }
+    }
+
+    EXPECT_EQ(accumulator.getFrameCount(), frames.size());
+    EXPECT_EQ(accumulator.getPathCount(), pathCount);
+    EXPECT_EQ(accumulator.getSkippedPathCount(), pathCount - storedPaths);
+    EXPECT(isClose(accumulator.getTotalGain(), totalGain, 1e-12));
+
+    // Bins hold exact counts and are much fewer than the paths.
+    auto bins = accumulator.getBins();
+    uint64_t binnedPaths = 0;
+    for (const auto& bin : bins)
+    {
+        binnedPaths += bin.count;
+        EXPECT_LT(bin.angleBin, desc.angleBinCount);
+        EXPECT_GE(bin.getMeanDelay(), bin.delayBin * desc.delayBinWidth * (1.0 - 1e-9));
+        EXPECT_LE(bin.getMeanDelay(), (bin.delayBin + 1) * desc.delayBinWidth * (1.0 + 1e-9));
+    }
+    EXPECT_EQ(binnedPaths, storedPaths);
+    EXPECT_LT(bins.size(), storedPaths / 4);
+
+    // Histogram with aligned bins matches the raw computation.
+    const uint32_t binCount = 120;
+    for (double binWidth : {1e-10, 1e-9})
+    {
+        auto h = accumulator.computeImpulseResponse(binWidth, binCount);
+        auto ref = computeReferenceResponse(frames, desc.staticParams, binWidth, binCount);
+        for (uint32_t i = 0; i < binCount; i++)
+            EXPECT(isClose(h[i], ref[i], 1e-9)) << "bin " << i << " width " << binWidth;
+    }
+
+    accumulator.reset();
+    EXPECT_EQ(accumulator.getStoredCount(), 0u);
+    EXPECT_EQ(accumulator.getTotalGain(), 0.0);
+}
+
+CPU_TEST(CIRAccumulator_Records)
+{
+    std::mt19937 rng(2);
+    auto paths = createTestPaths(10000, rng);
+
+    CIRAccumulator::Desc desc;
+    desc.staticParams = getTestParameters();
+    desc.mergePaths = false;
+    CIRAccumulator accumulator(desc);
+    accumulator.addFrame(paths.data(), paths.size());
+
+    size_t r = 0;
+    for (const CIRPathData& p : paths)
+    {
+        double gain = computeCIRPathGain(p, desc.staticParams);
+        if (gain == 0.0)
+            continue;
+        ASSERT(r < accumulator.getRecords().size());
+        const CompactCIRRecord& record = accumulator.getRecords()[r++];
+        EXPECT(isClose(record.delay, p.pathLength / desc.staticParams.lightSpeed, 1e-6));
+        EXPECT(isClose(record.gain, gain, 1e-6));
+        EXPECT_LE(std::abs(CompactCIRRecord::dequantizeAngle(record.emissionAngle) - p.emissionAngle), 1e-4f);
+        EXPECT_LE(std::abs(CompactCIRRecord::dequantizeAngle(record.receptionAngle) - p.receptionAngle), 1e-4f);
+        EXPECT_EQ(record.bounceOrder, p.reflectionCount);
+        EXPECT_EQ(record.flags, p.flags);
+    }
+    EXPECT_EQ(r, accumulator.getStoredCount());
+
+    auto h = accumulator.computeImpulseResponse(1e-9, 120);
+    auto ref = computeReferenceResponse({paths}, desc.staticParams, 1e-9, 120);
+    for (uint32_t i = 0; i < 120; i++)
+        EXPECT(isClose(h[i], ref[i], 1e-5)) << "bin " << i;
+}
+} // namespace Falcor
@@ -0,0 +1,269 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Utils/CIRPathBatch.h"
+#include "Utils/Math/ScalarMath.h"
+#include <cmath>
+#include <cstring>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const float kErrorMarker = 0.666f;
+
+uint32_t randomHalf(std::mt19937& rng)
+{
+    // Mostly finite values in [-64, 64], with some denormals, infinities and NaNs.
+    uint32_t r = rng() % 100;
+    if (r == 0)
+        return 0x7c00 | (rng() & 0x8000); // +-inf
+    if (r == 1)
+        return 0x7c01 + (rng() % 0x3ff); // NaN
+    if (r == 2)
+        return rng() & 0x83ff; // Denormal
+    return math::f32tof16((std::uniform_real_distribution<float>(-64.f, 64.f))(rng));
+}
+
+std::vector<CIRPathData> createTestPaths(size_t count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+    std::vector<CIRPathData> paths(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        CIRPathData& p = paths[i];
+        std::memset(&p, 0, sizeof(p));
+        p.pathLength = u(rng) * 20.f;
+        p.emissionAngle = u(rng) * 1.5f;
+        p.receptionAngle = u(rng) * 1.5f;
+        p.reflectanceProduct = u(rng);
+        p.emittedPower = u(rng) * 10.f;
+        p.flags = rng() & 0x3;
+        p.vertexCount = (rng() % 50 == 0) ? 8 + rng() % 100 : rng() % 8;
+        p.basePosition = float3(u(rng) * 10.f - 5.f, u(rng) * 10.f - 5.f, u(rng) * 10.f - 5.f);
+        if (rng() % 200 == 0)
+            p.basePosition.y = std::numeric_limits<float>::quiet_NaN();
+        for (uint32_t v = 0; v < 7; v++)
+        {
+            p.compressedVertices[v].x = randomHalf(rng) | (randomHalf(rng) << 16);
+            p.compressedVertices[v].y = randomHalf(rng);
+        }
+    }
+    return paths;
+}
+
+/// Reference implementation following PixelStats::decompressVertex().
+float3 decompressVertexReference(const CIRPathData::CompressedVertex& c, const float3& base)
+{
+    float x = math::f16tof32(c.x & 0xffff);
+    float y = math::f16tof32(c.x >> 16);
+    float z = math::f16tof32(c.y & 0xffff);
+    if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z))
+        return float3(kErrorMarker);
+    return base + float3(x, y, z);
+}
+
+/// Reference implementation following PixelStats::validateCIRVertexData().
+bool isVertexDataValidReference(const CIRPathData& p)
+{
+    if (p.vertexCount > 7 || !std::isfinite(p.basePosition.x) || !std::isfinite(p.basePosition.y) || !std::isfinite(p.basePosition.z))
+        return false;
+    if (std::abs(p.basePosition.x) > 1e6f || std::abs(p.basePosition.y) > 1e6f || std::abs(p.basePosition.z) > 1e6f)
+        return false;
+    for (uint32_t v = 0; v < p.vertexCount; v++)
+    {
+        const CIRPathData::CompressedVertex& c = p.compressedVertices[v];
+        float3 relative(math::f16tof32(c.x & 0xffff), math::f16tof32(c.x >> 16), math::f16tof32(c.y & 0xffff));
+        if (!std::isfinite(relative.x) || !std::isfinite(relative.y) || !std::isfinite(relative.z))
+            return false;
+    }
+    return true;
+}
+
+bool bitEqual(float a, float b)
+{
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+void verifyBatch(
+    CPUUnitTestContext& ctx,
+    const std::vector<CIRPathData>& paths,
+    const CIRVertexBatch& batch,
+    const std::vector<uint32_t>& expectedIndices
+)
+{
+    ASSERT_EQ(batch.getPathCount(), expectedIndices.size());
+    for (size_t i = 0; i < batch.getPathCount(); i++)
+    {
+        const CIRPathData& p = paths[expectedIndices[i]];
+        EXPECT_EQ(batch.pathIndices[i], expectedIndices[i]);
+        EXPECT_EQ(batch.flags[i], p.flags);
+        EXPECT_EQ(batch.vertexCounts[i], std::min(p.vertexCount, 7u));
+        EXPECT_EQ(batch.vertexDataValid[i] != 0, isVertexDataValidReference(p)) << "path " << expectedIndices[i];
+
+        for (uint32_t v = 0; v < CIRVertexBatch::kVertexStride; v++)
+        {
+            float3 expected = v < batch.vertexCounts[i] ? decompressVertexReference(p.compressedVertices[v], p.basePosition) : float3(0.f);
+            float3 actual = batch.getVertex(i, v);
+            EXPECT(bitEqual(actual.x, expected.x) && bitEqual(actual.y, expected.y) && bitEqual(actual.z, expected.z))
+                << "path " << expectedIndices[i] << " vertex " << v;
+        }
+    }
+}
+} // namespace
+
+CPU_TEST(CIRPathBatch_Decompress)
+{
+    // Use a count that is not a multiple of the task size.
+    auto paths = createTestPaths(10000, 1);
+
+    CIRVertexBatch batch;
+    CIRBatchStats stats = decompressCIRPaths(paths.data(), paths.size(), CIRBatchFilter(), batch);
+
+    std::vector<uint32_t> indices(paths.size());
+    size_t invalidPaths = 0;
+    for (uint32_t i = 0; i < paths.size(); i++)
+    {
+        indices[i] = i;
+        if (!isVertexDataValidReference(paths[i]))
+            invalidPaths++;
+    }
+    verifyBatch(ctx, paths, batch, indices);
+    EXPECT_EQ(stats.inputPaths, paths.size());
+    EXPECT_EQ(stats.outputPaths, paths.size());
+    EXPECT_EQ(stats.invalidPaths, invalidPaths);
+    EXPECT_GT(stats.invalidPaths, 0u);
+
+    // Reusing the batch for a smaller input must not leave stale data.
+    stats = decompressCIRPaths(paths.data(), 10, CIRBatchFilter(), batch);
+    indices.resize(10);
+    verifyBatch(ctx, paths, batch, indices);
+
+    stats = decompressCIRPaths(nullptr, 0, CIRBatchFilter(), batch);
+    EXPECT_EQ(batch.getPathCount(), 0u);
+    EXPECT_EQ(stats.outputPaths, 0u);
+}
+
+CPU_TEST(CIRPathBatch_Filter)
+{
+    auto paths = createTestPaths(20000, 2);
+
+    auto runFilter = [&](const CIRBatchFilter& filter, auto select)
+    {
+        std::vector<uint32_t> expected;
+        for (uint32_t i = 0; i < paths.size(); i++)
+        {
+            if (select(paths[i]))
+                expected.push_back(i);
+        }
+
+        CIRVertexBatch batch;
+        CIRBatchStats stats = decompressCIRPaths(paths.data(), paths.size(), filter, batch);
+        EXPECT_EQ(stats.outputPaths, expected.size());
+        EXPECT_GT(expected.size(), 0u);
+        EXPECT_LT(expected.size(), paths.size());
+        verifyBatch(ctx, paths, batch, expected);
+    };
+
+    runFilter(CIRBatchFilter::neePaths(), [](const CIRPathData& p) { return p.getIsNEEPath(); });
+    runFilter(CIRBatchFilter::regularPaths(), [](const CIRPathData& p) { return !p.getIsNEEPath(); });
+
+    {
+        CIRBatchFilter filter;
+        filter.requiredFlags = 0x1;
+        filter.requireValidVertexData = true;
+        runFilter(filter, [](const CIRPathData& p) { return p.getHitEmissiveSurface() && isVertexDataValidReference(p); });
+    }
+
+    {
+        CIRBatchFilter filter;
+        filter.useRanges = true;
+        filter.minPathLength = 2.f;
+        filter.maxPathLength = 15.f;
+        filter.maxAngle = 1.2f;
+        filter.minReflectance = 0.1f;
+        filter.maxReflectance = 0.9f;
+        filter.maxEmittedPower = 8.f;
+        runFilter(
+            filter,
+            [&](const CIRPathData& p)
+            {
+                return p.isValid(
+                    filter.minPathLength,
+                    filter.maxPathLength,
+                    filter.minEmittedPower,
+                    filter.maxEmittedPower,
+                    filter.minAngle,
+                    filter.maxAngle,
+                    filter.minReflectance,
+                    filter.maxReflectance
+                );
+            }
+        );
+
+        filter.maxPathLength = 1.f;
+        CIRVertexBatch batch;
+        EXPECT_THROW(decompressCIRPaths(paths.data(), paths.size(), filter, batch));
+    }
+}
+
+CPU_BENCHMARK(CIRPathBatch_Throughput)
+{
+    auto paths = createTestPaths(1 << 18, 3);
+    ctx.setItemsPerIteration(paths.size());
+    ctx.setBytesPerIteration(paths.size() * sizeof(CIRPathData));
+
+    ctx.run(
+        "per path",
+        [&]()
+        {
+            // Same pattern as the per-path export: validate, then allocate and fill a vector per path.
+            size_t vertexCount = 0;
+            for (const CIRPathData& p : paths)
+            {
+                bool valid = isVertexDataValidReference(p);
+                std::vector<float3> vertices;
+                vertices.reserve(p.vertexCount);
+                for (uint32_t v = 0; v < p.vertexCount && v < 7; v++)
+                    vertices.push_back(decompressVertexReference(p.compressedVertices[v], p.basePosition));
+                vertexCount += valid ? vertices.size() : 0;
+            }
+            doNotOptimize(vertexCount);
+        }
+    );
+
+    CIRVertexBatch batch;
+    ctx.run("batch", [&]() { doNotOptimize(decompressCIRPaths(paths.data(), paths.size(), CIRBatchFilter(), batch).decodedVertices); });
+    ctx.run(
+        "batch NEE only",
+        [&]() { doNotOptimize(decompressCIRPaths(paths.data(), paths.size(), CIRBatchFilter::neePaths(), batch).decodedVertices); }
+    );
+}
+} // namespace Falcor
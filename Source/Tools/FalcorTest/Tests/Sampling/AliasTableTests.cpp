@@ -27,10 +27,14 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/Sampling/AliasTable.h"
+#include "Utils/Sampling/AliasTableBuilder.h"
 
 #include <hypothesis/hypothesis.h>
 
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <random>
 
 namespace Falcor
 {
@@ -56,7 +60,7 @@ void testAliasTable(GPUUnitTestContext& ctx, uint32_t N, std::vector<float> spec
     }
 
     // Create alias table.
-    AliasTable aliasTable(pDevice, weights, rng);
+    AliasTable aliasTable(pDevice, weights);
 
     // Compute weight sum.
     double weightSum = 0.0;
@@ -64,7 +68,8 @@ void testAliasTable(GPUUnitTestContext& ctx, uint32_t N, std::vector<float> spec
         weightSum += weight;
 
     EXPECT_EQ(aliasTable.getCount(), weights.size());
-    EXPECT_EQ(aliasTable.getWeightSum(), weightSum);
+    // The table sums the weights in parallel, so the summation order differs.
+    EXPECT_LE(std::abs(aliasTable.getWeightSum() - weightSum), 1e-12 * weightSum);
 
     // Test sampling the alias table.
     {
@@ -137,8 +142,115 @@ void testAliasTable(GPUUnitTestContext& ctx, uint32_t N, std::vector<float> spec
         }
     }
 }
+
+std::vector<float> createWeights(uint32_t N, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> uniform;
+    std::vector<float> weights(N);
+    for (uint32_t i = 0; i < N; ++i)
+    {
+        // Mix of uniform, zero and heavy-tailed weights.
+        float u = uniform(rng);
+        weights[i] = u < 0.1f ? 0.f : (u < 0.2f ? 1000.f * uniform(rng) : uniform(rng));
+    }
+    return weights;
+}
+
+/// Check that the table represents the distribution given by the weights exactly (up to float precision).
+void checkDistribution(CPUUnitTestContext& ctx, const std::vector<float>& weights, const AliasTableBuilder::Result& table)
+{
+    const uint32_t N = (uint32_t)weights.size();
+    EXPECT_EQ(table.entries.size(), N);
+
+    std::vector<double> probabilities(N, 0.0);
+    for (uint32_t i = 0; i < N; ++i)
+    {
+        const auto& entry = table.entries[i];
+        EXPECT(entry.threshold >= 0.f && entry.threshold <= 1.f);
+        EXPECT(entry.alias < N);
+        probabilities[i] += entry.threshold / (double)N;
+        probabilities[entry.alias] += (1.0 - entry.threshold) / (double)N;
+    }
+
+    double weightSum = 0.0;
+    for (float w : weights)
+        weightSum += w;
+    for (uint32_t i = 0; i < N; ++i)
+    {
+        double expected = weightSum > 0.0 ? weights[i] / weightSum : 1.0 / N;
+        EXPECT_LE(std::abs(probabilities[i] - expected) * N, 1e-5) << "i = " << i;
+    }
+}
 } // namespace
 
+CPU_TEST(AliasTableBuilder_Distribution)
+{
+    std::vector<std::vector<float>> weightSets = {
+        {1.f},
+        {1.f, 2.f},
+        {0.f, 0.f, 0.f},
+        {0.f, 5.f, 0.f},
+        {1.f, 1.f, 1.f, 1.f},
+        {1e-6f, 1e6f, 1.f, 3.f, 0.f},
+        createWeights(100, 1),
+        createWeights(10007, 2),
+        createWeights(200000, 3),
+    };
+
+    for (const auto& weights : weightSets)
+    {
+        auto table = AliasTableBuilder::build(weights);
+        EXPECT_EQ(table.weightSum, AliasTableBuilder::computeWeightSum(weights));
+        checkDistribution(ctx, weights, table);
+    }
+}
+
+CPU_TEST(AliasTableBuilder_SectionSize)
+{
+    // The table must not depend on how the sweep is split into sections.
+    for (uint32_t N : {1u, 2u, 17u, 1000u, 50000u})
+    {
+        auto weights = createWeights(N, N);
+        auto reference = AliasTableBuilder::build(weights, N);
+        for (size_t sectionSize : {1, 7, 64, 4096})
+        {
+            auto table = AliasTableBuilder::build(weights, sectionSize);
+            EXPECT_EQ(table.weightSum, reference.weightSum);
+            EXPECT(std::memcmp(table.entries.data(), reference.entries.data(), N * sizeof(AliasTableBuilder::Entry)) == 0)
+                << "N = " << N << ", sectionSize = " << sectionSize;
+        }
+    }
+}
+
+CPU_TEST(AliasTableBuilder_Sampling)
+{
+    const uint32_t N = 1000;
+    const uint32_t samplesPerWeight = 1000;
+    auto weights = createWeights(N, 4);
+    auto table = AliasTableBuilder::build(weights);
+
+    // Sample the table on the CPU and verify the histogram using a chi-square test.
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> uniform;
+    std::vector<double> obsFrequencies(N, 0.0);
+    for (uint32_t s = 0; s < N * samplesPerWeight; ++s)
+    {
+        uint32_t index = std::min(N - 1, (uint32_t)(uniform(rng) * N));
+        const auto& entry = table.entries[index];
+        obsFrequencies[uniform(rng) >= entry.threshold ? entry.alias : index] += 1.0;
+    }
+
+    std::vector<double> expFrequencies(N);
+    for (uint32_t i = 0; i < N; ++i)
+        expFrequencies[i] = (weights[i] / table.weightSum) * N * samplesPerWeight;
+
+    const auto& [success, report] = hypothesis::chi2_test(N, obsFrequencies.data(), expFrequencies.data(), N * samplesPerWeight, 5, 0.1);
+    if (!success)
+        std::cout << report << std::endl;
+    EXPECT(success);
+}
+
 GPU_TEST(AliasTable)
 {
     testAliasTable(ctx, 1, {1.f});
@@ -0,0 +1,142 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/CpuSceneRayQuery.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/TriangleMesh.h"
+#include "Scene/Material/StandardMaterial.h"
+#include "Utils/Math/MatrixMath.h"
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/**
+ * Create a scene with two instances of a 2x2 quad in the xz-plane and a unit cube.
+ * The quads are centered at x = -3 (unit scale) and x = 3 (scaled by 2), the cube is centered at (0, 5, 0).
+ * The cube has a single instance, so it is pre-transformed to world space by the scene builder.
+ */
+ref<Scene> createScene(ref<Device> pDevice)
+{
+    SceneBuilder builder(pDevice, {}, SceneBuilder::Flags::DontOptimizeGraph);
+    auto pMaterial = StandardMaterial::create(pDevice, "Material");
+
+    MeshID quadID = builder.addTriangleMesh(TriangleMesh::createQuad(float2(2.f)), pMaterial);
+    auto createNode = [](const std::string& name, const float4x4& transform)
+    { return SceneBuilder::Node{name, transform, float4x4::identity(), float4x4::identity()}; };
+
+    NodeID leftID = builder.addNode(createNode("Left", math::matrixFromTranslation(float3(-3.f, 0.f, 0.f))));
+    NodeID rightID = builder.addNode(
+        createNode("Right", mul(math::matrixFromTranslation(float3(3.f, 0.f, 0.f)), math::matrixFromScaling(float3(2.f))))
+    );
+    builder.addMeshInstance(leftID, quadID);
+    builder.addMeshInstance(rightID, quadID);
+
+    MeshID cubeID = builder.addTriangleMesh(TriangleMesh::createCube(), pMaterial);
+    NodeID cubeNodeID = builder.addNode(createNode("Cube", math::matrixFromTranslation(float3(0.f, 5.f, 0.f))));
+    builder.addMeshInstance(cubeNodeID, cubeID);
+
+    return builder.getScene();
+}
+
+Ray createDownRay(float x, float tMax = std::numeric_limits<float>::max())
+{
+    return Ray(float3(x, 10.f, 0.25f), float3(0.f, -1.f, 0.f), 0.f, tMax);
+}
+} // namespace
+
+GPU_TEST(CpuSceneRayQuery)
+{
+    ref<Scene> pScene = createScene(ctx.getDevice());
+    pScene->update(ctx.getRenderContext(), 0.0);
+
+    CpuSceneRayQuery query(*pScene);
+    EXPECT_EQ(query.getInstanceCount(), 3);
+    EXPECT_EQ(query.getTriangleCount(), 2 + 12);
+
+    auto checkHit = [&](const Ray& ray, float t)
+    {
+        auto hit = query.intersectClosest(ray);
+        EXPECT(hit.isValid()) << "x = " << ray.origin.x;
+        EXPECT(query.intersectAny(ray)) << "x = " << ray.origin.x;
+        EXPECT_LE(std::abs(hit.t - t), 1e-5f) << "x = " << ray.origin.x;
+        EXPECT_GE(hit.barycentrics.x, 0.f);
+        EXPECT_GE(hit.barycentrics.y, 0.f);
+        EXPECT_LE(hit.barycentrics.x + hit.barycentrics.y, 1.f + 1e-5f);
+        return hit;
+    };
+    auto checkMiss = [&](const Ray& ray)
+    {
+        EXPECT(!query.intersectClosest(ray).isValid()) << "x = " << ray.origin.x;
+        EXPECT(!query.intersectAny(ray)) << "x = " << ray.origin.x;
+    };
+
+    // Both quad instances are hit. The right instance is scaled, so it extends to x = 5.
+    auto left = checkHit(createDownRay(-3.f), 10.f);
+    auto leftEdge = checkHit(createDownRay(-3.9f), 10.f);
+    auto right = checkHit(createDownRay(4.5f), 10.f);
+    EXPECT_EQ(left.instanceID, leftEdge.instanceID);
+    EXPECT_NE(left.instanceID, right.instanceID);
+    EXPECT_LT(left.primitiveIndex, 2);
+    EXPECT_LT(right.primitiveIndex, 2);
+
+    // Both quads are instances of the same mesh.
+    const auto& leftInstance = pScene->getGeometryInstance(left.instanceID);
+    const auto& rightInstance = pScene->getGeometryInstance(right.instanceID);
+    EXPECT_EQ(leftInstance.geometryID, rightInstance.geometryID);
+
+    // The top face of the cube is at y = 5.5.
+    auto cube = checkHit(createDownRay(0.f), 4.5f);
+    EXPECT_NE(pScene->getGeometryInstance(cube.instanceID).geometryID, leftInstance.geometryID);
+    EXPECT_LT(cube.primitiveIndex, 12);
+
+    // Rays that pass beside the geometry or end before it miss.
+    checkMiss(createDownRay(-4.5f));
+    checkMiss(createDownRay(10.f));
+    checkMiss(createDownRay(0.f, 4.f));
+    checkMiss(Ray(float3(0.f, 10.f, 0.25f), float3(0.f, 1.f, 0.f)));
+
+    // The batched queries give the same results.
+    std::vector<Ray> rays;
+    for (int i = 0; i <= 100; i++)
+        rays.push_back(createDownRay(-6.f + 0.12f * i));
+    std::vector<CpuSceneRayQuery::Hit> hits(rays.size());
+    std::vector<uint8_t> anyHits(rays.size());
+    query.intersectClosest(rays, hits);
+    query.intersectAny(rays, anyHits);
+    for (size_t i = 0; i < rays.size(); i++)
+    {
+        auto hit = query.intersectClosest(rays[i]);
+        EXPECT_EQ(hits[i].instanceID, hit.instanceID) << "i = " << i;
+        EXPECT_EQ(hits[i].primitiveIndex, hit.primitiveIndex) << "i = " << i;
+        EXPECT_EQ(hits[i].t, hit.t) << "i = " << i;
+        EXPECT_EQ(anyHits[i] != 0, hit.isValid()) << "i = " << i;
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,610 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Curves/CurveTessellation.h"
+#include "Core/Error.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Math/CubicSpline.h"
+#include "Utils/Math/MathHelpers.h"
+#include "Utils/Math/Matrix.h"
+#include "Utils/Math/Quaternion.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+
+namespace
+{
+// Reference implementation: the serial tessellation used before strands were processed in parallel.
+// It is kept verbatim to check that the default (non-adaptive) path produces the same output.
+namespace reference
+{
+struct StrandArrays {
+    fast_vector<float3> controlPoints;
+    fast_vector<float>  widths;
+    fast_vector<float2> UVs;
+    uint32_t vertexCount { 0 };
+};
+
+struct CurveArrays {
+    const float3* controlPoints;
+    const float* widths;
+    const float2* UVs;
+
+    // Initializer
+    CurveArrays(const float3* paramControlPoints, const float* paramWidths, const float2* paramUVs)
+    {
+        controlPoints = paramControlPoints;
+        widths = paramWidths;
+        UVs = paramUVs;
+    }
+};
+
+struct CubicSplineCache
+{
+    CubicSpline<float3> optSplinePoints;
+    CubicSpline<float>  optSplineWidths;
+    CubicSpline<float2> optSplineUVs;
+
+    CubicSpline<float3> splinePoints;
+    CubicSpline<float>  splineWidths;
+    CubicSpline<float2> splineUVs;
+};
+
+// Curves tessellated to quad-tubes have the width somewhere between curveWidth and (curveWidth / sqrt(2)), depending on the viewing angle.
+// To achieve curveWidth on average, however, we need to scale the initial curveWidth by 1.11 (the number was deducted numerically).
+const float kMeshCompensationScale = 1.11f;
+
+float4 transformSphere(const float4x4& xform, const float4& sphere)
+{
+    // Spheres are represented as (center.x, center.y, center.z, radius).
+    // Assume the scaling is isotropic, i.e., the end points are still spheres after transformation.
+#if 1
+    float  scale = std::sqrt(xform[0][0] * xform[0][0] + xform[0][1] * xform[0][1] + xform[0][2] * xform[0][2]);
+    float3 xyz = transformPoint(xform, sphere.xyz());
+    return float4(xyz, sphere.w * scale);
+#else
+    float3 q = sphere.xyz() + float3(sphere.w, 0, 0);
+    float4 xp = xform * float4(sphere.xyz(), 1.f);
+    float4 xq = xform * float4(q, 1.f);
+    float xr = length(xq.xyz() - xp.xyz());
+    return float4(xp.xyz(), xr);
+#endif
+}
+
+/// Sanitize radius so it is never 0, as non-zero radius is used to distinguish
+/// between mesh-from-curves and native mesh, which is used intersection and epsilon calculations.
+inline float sanitizeWidth(float w)
+{
+    return std::max(w, (float)std::numeric_limits<float16_t>::min());
+}
+
+void optimizeStrandGeometry(CubicSplineCache& splineCache, const CurveArrays& curveArrays, StrandArrays& strandArrays, StrandArrays& optimizedStrandArrays, uint32_t pointOffset, uint32_t subdivPerSegment, uint32_t keepOneEveryXVerticesPerStrand, float widthScale)
+{
+    strandArrays.controlPoints.clear();
+    strandArrays.UVs.clear();
+    strandArrays.widths.clear();
+
+    // Optimize geometry by removing duplicates.
+    for (uint32_t j = 0; j < strandArrays.vertexCount - 1; j++)
+    {
+        if (any(curveArrays.controlPoints[pointOffset + j] != curveArrays.controlPoints[pointOffset + j + 1]))
+        {
+            strandArrays.controlPoints.push_back(curveArrays.controlPoints[pointOffset + j]);
+            strandArrays.widths.push_back(curveArrays.widths[pointOffset + j]);
+            if (curveArrays.UVs) strandArrays.UVs.push_back(curveArrays.UVs[pointOffset + j]);
+        }
+    }
+
+    // Add the last control point.
+    strandArrays.controlPoints.push_back(curveArrays.controlPoints[pointOffset + strandArrays.vertexCount - 1]);
+    strandArrays.widths.push_back(curveArrays.widths[pointOffset + strandArrays.vertexCount - 1]);
+    if (curveArrays.UVs) strandArrays.UVs.push_back(curveArrays.UVs[pointOffset + strandArrays.vertexCount - 1]);
+
+    optimizedStrandArrays.vertexCount = static_cast<uint32_t>(strandArrays.controlPoints.size());
+
+    const CubicSpline<float3>& splinePoints = splineCache.optSplinePoints.setup(strandArrays.controlPoints.data(), optimizedStrandArrays.vertexCount);
+    const CubicSpline<float>& splineWidths = splineCache.optSplineWidths.setup(strandArrays.widths.data(), optimizedStrandArrays.vertexCount);
+
+    uint32_t tmpCount = 0;
+    for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
+    {
+        for (uint32_t k = 0; k < subdivPerSegment; k++)
+        {
+            if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
+            {
+                float t = (float)k / (float)subdivPerSegment;
+                optimizedStrandArrays.controlPoints.push_back(splinePoints.interpolate(j, t));
+                optimizedStrandArrays.widths.push_back(sanitizeWidth(kMeshCompensationScale * widthScale * splineWidths.interpolate(j, t)));
+            }
+            tmpCount++;
+        }
+    }
+
+    // Always keep the last vertex.
+    optimizedStrandArrays.controlPoints.push_back(splinePoints.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
+    optimizedStrandArrays.widths.push_back(sanitizeWidth(kMeshCompensationScale * widthScale * splineWidths.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f)));
+
+    // Texture coordinates.
+    if (curveArrays.UVs)
+    {
+        const CubicSpline<float2>& splineUVs = splineCache.optSplineUVs.setup(strandArrays.UVs.data(), optimizedStrandArrays.vertexCount);
+        tmpCount = 0;
+        for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
+        {
+            for (uint32_t k = 0; k < subdivPerSegment; k++)
+            {
+                if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
+                {
+                    float t = (float)k / (float)subdivPerSegment;
+                    optimizedStrandArrays.UVs.push_back(splineUVs.interpolate(j, t));
+                }
+                tmpCount++;
+            }
+        }
+
+        // Always keep the last vertex.
+        optimizedStrandArrays.UVs.push_back(splineUVs.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
+    }
+}
+
+void updateCurveFrame(const StrandArrays& strandArrays, float3& fwd, float3& s, float3& t, uint32_t j)
+{
+    float3 prevFwd;
+
+    if (j <= 0 || j >= strandArrays.controlPoints.size() || strandArrays.controlPoints.size() == 2)
+    {
+        // The forward tangents should be the same, meaning s & t are also the same
+        prevFwd = fwd;
+    }
+    else if (j == 1)
+    {
+        prevFwd = normalize(strandArrays.controlPoints[j] - strandArrays.controlPoints[j - 1]);
+        fwd = normalize(strandArrays.controlPoints[j + 1] - strandArrays.controlPoints[j - 1]);
+    }
+    else if (j < strandArrays.controlPoints.size() - 2)
+    {
+        prevFwd = normalize(strandArrays.controlPoints[j] - strandArrays.controlPoints[j - 2]);
+        fwd = normalize(strandArrays.controlPoints[j + 1] - strandArrays.controlPoints[j - 1]);
+    }
+    else if (j == strandArrays.controlPoints.size() - 1)
+    {
+        prevFwd = normalize(strandArrays.controlPoints[j] - strandArrays.controlPoints[j - 2]);
+        fwd = normalize(strandArrays.controlPoints[j] - strandArrays.controlPoints[j - 1]);
+    }
+
+    // Use quaternions to smoothly rotate the other vectors and update s & t vectors.
+    quatf rotQuat = math::quatFromRotationBetweenVectors(prevFwd, fwd);
+    s = mul(rotQuat, s);
+    t = normalize(cross(fwd, s));
+    s = normalize(cross(t, fwd));
+
+    FALCOR_ASSERT_LT(std::abs(length(fwd) - 1.f), 1e-3f);
+    FALCOR_ASSERT_LT(std::abs(length(s) - 1.f), 1e-3f);
+    FALCOR_ASSERT_LT(std::abs(length(t) - 1.f), 1e-3f);
+}
+
+void updateMeshResultBuffers(CurveTessellation::MeshResult& result, const CurveArrays& curveArrays, StrandArrays& optimizedStrandArrays, const float3& fwd, const float3& s, const float3& t, uint32_t pointCountPerCrossSection, uint32_t j)
+{
+    // Mesh vertices, normals, tangents, and texCrds (if any).
+    for (uint32_t k = 0; k < pointCountPerCrossSection; k++)
+    {
+        float phi = (float)k / (float)pointCountPerCrossSection * (float)M_PI * 2.f;
+        float3 vNormal = std::cos(phi) * s + std::sin(phi) * t;
+
+        float curveRadius = 0.5f * optimizedStrandArrays.widths[j];
+        result.vertices.push_back(optimizedStrandArrays.controlPoints[j] + curveRadius * vNormal);
+        result.normals.push_back(vNormal);
+        result.tangents.push_back(float4(fwd.x, fwd.y, fwd.z, 1));
+        result.radii.push_back(curveRadius);
+
+        if (curveArrays.UVs)
+        {
+            result.texCrds.push_back(optimizedStrandArrays.UVs[j]);
+        }
+    }
+}
+
+void connectFaceVertices(CurveTessellation::MeshResult& result, uint32_t meshVertexOffset, uint32_t pointCountPerCrossSection, uint32_t quadCountLimit, uint32_t nextCrossSectionVertexOffset, uint32_t multiplier, uint32_t j)
+{
+    for (uint32_t k = 0; k < quadCountLimit; k++)
+    {
+        result.faceVertexCounts.push_back(3);
+        result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + k);
+        result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
+        result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
+
+        result.faceVertexCounts.push_back(3);
+        result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + k);
+        result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
+        result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + k);
+    }
+}
+
+CurveTessellation::SweptSphereResult convertToLinearSweptSphere(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t degree, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, const float4x4& xform)
+{
+    CurveTessellation::SweptSphereResult result;
+
+    // Only support linear tube segments now.
+    // TODO: Add quadratic or cubic tube segments if necessary.
+    FALCOR_ASSERT(degree == 1);
+    result.degree = degree;
+
+    uint32_t pointCounts = 0;
+    uint32_t segCounts = 0;
+    uint32_t maxVertexCountsPerStrand = 0;
+    for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
+    {
+        uint32_t tmpPointCount = div_round_up(subdivPerSegment * (vertexCountsPerStrand[i] - 1), keepOneEveryXVerticesPerStrand) + 1;
+        pointCounts += tmpPointCount;
+        segCounts += tmpPointCount - 1;
+        maxVertexCountsPerStrand = std::max(maxVertexCountsPerStrand, vertexCountsPerStrand[i]);
+    }
+    result.indices.reserve(segCounts);
+    result.points.reserve(pointCounts);
+    result.radius.reserve(pointCounts);
+    result.texCrds.reserve(pointCounts);
+
+    uint32_t pointOffset = 0;
+
+    StrandArrays strandArrays;
+    strandArrays.controlPoints.reserve(maxVertexCountsPerStrand);
+    strandArrays.widths.reserve(maxVertexCountsPerStrand);
+    strandArrays.UVs.reserve(maxVertexCountsPerStrand);
+    CurveArrays curveArrays(controlPoints, widths, UVs);
+
+    StrandArrays optimizedStrandArrays;
+    CubicSplineCache splineCache;
+    for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
+    {
+        optimizedStrandArrays.controlPoints.clear();
+        optimizedStrandArrays.UVs.clear();
+        optimizedStrandArrays.widths.clear();
+        optimizedStrandArrays.vertexCount = 0;
+        strandArrays.vertexCount = vertexCountsPerStrand[i];
+
+        optimizeStrandGeometry(splineCache, curveArrays, strandArrays, optimizedStrandArrays, pointOffset, subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
+
+        const CubicSpline<float3>& splinePoints = splineCache.splinePoints.setup(strandArrays.controlPoints.data(), optimizedStrandArrays.vertexCount);
+        const CubicSpline<float>& splineWidths = splineCache.splineWidths.setup(strandArrays.widths.data(), optimizedStrandArrays.vertexCount);
+
+        uint32_t tmpCount = 0;
+        for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
+        {
+            for (uint32_t k = 0; k < subdivPerSegment; k++)
+            {
+                if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
+                {
+                    float t = (float)k / (float)subdivPerSegment;
+                    result.indices.push_back((uint32_t)result.points.size());
+
+                    // Pre-transform curve points.
+                    float4 sph = transformSphere(xform, float4(splinePoints.interpolate(j, t), sanitizeWidth(splineWidths.interpolate(j, t) * 0.5f * widthScale)));
+
+                    result.points.push_back(sph.xyz());
+                    result.radius.push_back(sph.w);
+                }
+                tmpCount++;
+            }
+        }
+
+        // Always keep the last vertex.
+        float4 sph = transformSphere(xform, float4(splinePoints.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f), sanitizeWidth(splineWidths.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f) * 0.5f * widthScale)));
+        result.points.push_back(sph.xyz());
+        result.radius.push_back(sph.w);
+
+        // Texture coordinates.
+        if (UVs)
+        {
+            const CubicSpline<float2>& splineUVs = splineCache.splineUVs.setup(strandArrays.UVs.data(), optimizedStrandArrays.vertexCount);
+            tmpCount = 0;
+            for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
+            {
+                for (uint32_t k = 0; k < subdivPerSegment; k++)
+                {
+                    if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
+                    {
+                        float t = (float)k / (float)subdivPerSegment;
+                        result.texCrds.push_back(splineUVs.interpolate(j, t));
+                    }
+                    tmpCount++;
+                }
+            }
+
+            // Always keep the last vertex.
+            result.texCrds.push_back(splineUVs.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
+        }
+
+        for (uint32_t j = i; j < std::min(strandCount, i + keepOneEveryXStrands); j++) pointOffset += vertexCountsPerStrand[j];
+    }
+
+    return result;
+}
+
+CurveTessellation::MeshResult convertToPolytube(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, uint32_t pointCountPerCrossSection)
+{
+    CurveTessellation::MeshResult result;
+    uint32_t vertexCounts = 0;
+    uint32_t faceCounts = 0;
+    uint32_t maxVertexCountsPerStrand = 0;
+    for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
+    {
+        uint32_t tmpPointCount = div_round_up(subdivPerSegment * (vertexCountsPerStrand[i] - 1), keepOneEveryXVerticesPerStrand) + 1;
+        vertexCounts += pointCountPerCrossSection * tmpPointCount;
+        faceCounts += 2 * pointCountPerCrossSection * (tmpPointCount - 1);
+        maxVertexCountsPerStrand = std::max(maxVertexCountsPerStrand, vertexCountsPerStrand[i]);
+    }
+    result.vertices.reserve(vertexCounts);
+    result.normals.reserve(vertexCounts);
+    result.tangents.reserve(vertexCounts);
+    result.texCrds.reserve(vertexCounts);
+    result.radii.reserve(vertexCounts);
+    result.faceVertexCounts.reserve(faceCounts);
+    result.faceVertexIndices.reserve(faceCounts * 3);
+
+    uint32_t pointOffset = 0;
+    uint32_t meshVertexOffset = 0;
+
+    StrandArrays strandArrays;
+    strandArrays.controlPoints.reserve(maxVertexCountsPerStrand);
+    strandArrays.widths.reserve(maxVertexCountsPerStrand);
+    strandArrays.UVs.reserve(maxVertexCountsPerStrand);
+    CurveArrays curveArrays(controlPoints, widths, UVs);
+
+    StrandArrays optimizedStrandArrays;
+    CubicSplineCache splineCache;
+    for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
+    {
+        optimizedStrandArrays.controlPoints.clear();
+        optimizedStrandArrays.UVs.clear();
+        optimizedStrandArrays.widths.clear();
+        optimizedStrandArrays.vertexCount = 0;
+
+        strandArrays.vertexCount = vertexCountsPerStrand[i];
+
+        optimizeStrandGeometry(splineCache, curveArrays, strandArrays, optimizedStrandArrays, pointOffset, subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
+
+        for (uint32_t j = i; j < std::min(strandCount, i + keepOneEveryXStrands); j++) pointOffset += vertexCountsPerStrand[j];
+
+        // Build the initial frame.
+        float3 fwd, s, t;
+        fwd = normalize(optimizedStrandArrays.controlPoints[1] - optimizedStrandArrays.controlPoints[0]);
+        FALCOR_ASSERT_LT(std::abs(length(fwd) - 1.f), 1e-3f);
+        buildFrame(fwd, s, t);
+
+        // Create mesh.
+        for (uint32_t j = 0; j < optimizedStrandArrays.controlPoints.size(); j++)
+        {
+            // Update the curve's frame vectors: [fwd, s, t]
+            updateCurveFrame(optimizedStrandArrays, fwd, s, t, j);
+
+            // Mesh vertices, normals, tangents, and texCrds (if any).
+            updateMeshResultBuffers(result, curveArrays, optimizedStrandArrays, fwd, s, t, pointCountPerCrossSection, j);
+
+            // Mesh faces.
+            if (j < optimizedStrandArrays.controlPoints.size() - 1)
+            {
+                uint32_t quadCountLimit = pointCountPerCrossSection;
+                connectFaceVertices(result, meshVertexOffset, pointCountPerCrossSection, quadCountLimit, 1, 1, j);
+            }
+        }
+
+        meshVertexOffset += pointCountPerCrossSection * (uint32_t)optimizedStrandArrays.controlPoints.size();
+    }
+
+    return result;
+}
+} // namespace reference
+
+/// Random strands with varying vertex counts. Some control points are duplicated, which the tessellation removes.
+struct TestCurves
+{
+    std::vector<uint32_t> vertexCounts;
+    std::vector<float3> controlPoints;
+    std::vector<float> widths;
+    std::vector<float2> UVs;
+
+    TestCurves(uint32_t strandCount, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> dist(-1.f, 1.f);
+        for (uint32_t i = 0; i < strandCount; i++)
+        {
+            const uint32_t vertexCount = 2 + i % 9;
+            vertexCounts.push_back(vertexCount);
+            float3 p = float3(dist(rng), dist(rng), dist(rng)) * 10.f;
+            for (uint32_t j = 0; j < vertexCount; j++)
+            {
+                if (j == 0 || j + 1 == vertexCount || dist(rng) > -0.7f)
+                    p += float3(dist(rng), dist(rng), 1.5f);
+                controlPoints.push_back(p);
+                widths.push_back(0.1f + 0.05f * dist(rng));
+                UVs.push_back(float2(dist(rng), dist(rng)));
+            }
+        }
+    }
+
+    uint32_t strandCount() const { return (uint32_t)vertexCounts.size(); }
+};
+
+template<typename T>
+bool isIdentical(const fast_vector<T>& a, const fast_vector<T>& b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+float distanceToSegment(const float3& p, const float3& a, const float3& b)
+{
+    const float3 ab = b - a;
+    const float t = std::clamp(dot(p - a, ab) / std::max(dot(ab, ab), 1e-20f), 0.f, 1.f);
+    return length(p - (a + t * ab));
+}
+} // namespace
+
+CPU_TEST(CurveTessellation_MatchesReference)
+{
+    const TestCurves curves(100, 1);
+    const float4x4 xform = mul(math::matrixFromTranslation(float3(1.f, 2.f, 3.f)), math::matrixFromScaling(float3(2.f)));
+
+    for (uint32_t subdiv : {1u, 4u, 5u})
+    {
+        for (uint32_t keepStrands : {1u, 3u})
+        {
+            for (uint32_t keepVertices : {1u, 2u, 3u})
+            {
+                for (bool useUVs : {false, true})
+                {
+                    const float2* UVs = useUVs ? curves.UVs.data() : nullptr;
+
+                    auto spheres = CurveTessellation::convertToLinearSweptSphere(
+                        curves.strandCount(), curves.vertexCounts.data(), curves.controlPoints.data(), curves.widths.data(), UVs, 1, subdiv, keepStrands, keepVertices, 0.5f, xform
+                    );
+                    auto refSpheres = reference::convertToLinearSweptSphere(
+                        curves.strandCount(), curves.vertexCounts.data(), curves.controlPoints.data(), curves.widths.data(), UVs, 1, subdiv, keepStrands, keepVertices, 0.5f, xform
+                    );
+                    EXPECT_EQ(spheres.degree, refSpheres.degree);
+                    EXPECT(isIdentical(spheres.indices, refSpheres.indices)) << "subdiv " << subdiv << ", keep " << keepStrands << "/" << keepVertices;
+                    EXPECT(isIdentical(spheres.points, refSpheres.points)) << "subdiv " << subdiv << ", keep " << keepStrands << "/" << keepVertices;
+                    EXPECT(isIdentical(spheres.radius, refSpheres.radius)) << "subdiv " << subdiv << ", keep " << keepStrands << "/" << keepVertices;
+                    EXPECT(isIdentical(spheres.texCrds, refSpheres.texCrds)) << "subdiv " << subdiv << ", keep " << keepStrands << "/" << keepVertices;
+
+                    auto mesh = CurveTessellation::convertToPolytube(
+                        curves.strandCount(), curves.vertexCounts.data(), curves.controlPoints.data(), curves.widths.data(), UVs, subdiv, keepStrands, keepVertices, 0.5f, 4
+                    );
+                    auto refMesh = reference::convertToPolytube(
+                        curves.strandCount(), curves.vertexCounts.data(), curves.controlPoints.data(), curves.widths.data(), UVs, subdiv, keepStrands, keepVertices, 0.5f, 4
+                    );
+                    EXPECT(isIdentical(mesh.vertices, refMesh.vertices)) << "subdiv " << subdiv << ", keep " << keepStrands << "/" << keepVertices;
+                    EXPECT(isIdentical(mesh.normals, refMesh.normals)) << "subdiv " << subdiv << ", keep " << keepStrands << "/" << keepVertices;
+                    EXPECT(isIdentical(mesh.tangents, refMesh.tangents)) << "subdiv " << subdiv << ", keep " << keepStrands << "/" << keepVertices;
+                    EXPECT(isIdentical(mesh.texCrds, refMesh.texCrds)) << "subdiv " << subdiv << ", keep " << keepStrands << "/" << keepVertices;
+                    EXPECT(isIdentical(mesh.radii, refMesh.radii)) << "subdiv " << subdiv << ", keep " << keepStrands << "/" << keepVertices;
+                    EXPECT(isIdentical(mesh.faceVertexCounts, refMesh.faceVertexCounts)) << "subdiv " << subdiv << ", keep " << keepStrands << "/" << keepVertices;
+                    EXPECT(isIdentical(mesh.faceVertexIndices, refMesh.faceVertexIndices)) << "subdiv " << subdiv << ", keep " << keepStrands << "/" << keepVertices;
+                }
+            }
+        }
+    }
+}
+
+CPU_TEST(CurveTessellation_Adaptive)
+{
+    const TestCurves curves(100, 2);
+    const uint32_t kMaxSubdiv = 32;
+    const float kMaxError = 0.1f;
+    const float4x4 identity = float4x4::identity();
+
+    auto uniform = CurveTessellation::convertToLinearSweptSphere(
+        curves.strandCount(), curves.vertexCounts.data(), curves.controlPoints.data(), curves.widths.data(), nullptr, 1, kMaxSubdiv, 1, 1, 1.f, identity
+    );
+    auto adaptive = CurveTessellation::convertToLinearSweptSphere(
+        curves.strandCount(), curves.vertexCounts.data(), curves.controlPoints.data(), curves.widths.data(), nullptr, 1, kMaxSubdiv, 1, 1, 1.f, identity, kMaxError
+    );
+    EXPECT_LT(adaptive.points.size(), uniform.points.size());
+    ASSERT_EQ(adaptive.points.size(), adaptive.radius.size());
+
+    // Split both results into strands. Each strand is a run of consecutive segments.
+    auto getStrands = [](const CurveTessellation::SweptSphereResult& result)
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> strands; // Range of points per strand.
+        for (uint32_t i = 0; i < result.indices.size(); i++)
+        {
+            if (strands.empty() || strands.back().second != result.indices[i])
+                strands.push_back({result.indices[i], result.indices[i]});
+            strands.back().second = result.indices[i] + 1;
+        }
+        return strands;
+    };
+    const auto uniformStrands = getStrands(uniform);
+    const auto adaptiveStrands = getStrands(adaptive);
+    ASSERT_EQ(uniformStrands.size(), curves.strandCount());
+    ASSERT_EQ(adaptiveStrands.size(), curves.strandCount());
+
+    uint32_t inputOffset = 0;
+    for (uint32_t s = 0; s < curves.strandCount(); s++)
+    {
+        // The strands have the same end points.
+        const auto [uBegin, uEnd] = uniformStrands[s];
+        const auto [aBegin, aEnd] = adaptiveStrands[s];
+        EXPECT(all(uniform.points[uBegin] == adaptive.points[aBegin])) << "strand " << s;
+        EXPECT(all(uniform.points[uEnd] == adaptive.points[aEnd])) << "strand " << s;
+
+        // Widths of the control points that remain after removing duplicates.
+        std::vector<float> widths;
+        for (uint32_t i = 0; i < curves.vertexCounts[s]; i++)
+        {
+            const uint32_t index = inputOffset + i;
+            if (i + 1 == curves.vertexCounts[s] || any(curves.controlPoints[index] != curves.controlPoints[index + 1]))
+                widths.push_back(curves.widths[index]);
+        }
+        inputOffset += curves.vertexCounts[s];
+
+        // The same number of sub-segments is used for all segments of a strand.
+        const uint32_t segmentCount = (uint32_t)widths.size() - 1;
+        ASSERT_EQ((uEnd - uBegin), segmentCount * kMaxSubdiv);
+        ASSERT_EQ((aEnd - aBegin) % segmentCount, 0);
+        const uint32_t subdivCount = (aEnd - aBegin) / segmentCount;
+        EXPECT_LE(subdivCount, kMaxSubdiv);
+
+        // The finely sampled spline is within the error bound of the adaptive polyline of the same segment.
+        // The bound is relative to the smaller radius at the end points of the segment.
+        for (uint32_t i = uBegin; i <= uEnd; i++)
+        {
+            const uint32_t segment = std::min((i - uBegin) / kMaxSubdiv, segmentCount - 1);
+            const float tolerance = kMaxError * 0.5f * std::min(widths[segment], widths[segment + 1]);
+            float distance = std::numeric_limits<float>::max();
+            for (uint32_t j = aBegin + segment * subdivCount; j < aBegin + (segment + 1) * subdivCount; j++)
+                distance = std::min(distance, distanceToSegment(uniform.points[i], adaptive.points[j], adaptive.points[j + 1]));
+            EXPECT_LE(distance, tolerance * 1.01f) << "strand " << s << ", point " << i;
+        }
+    }
+
+    // Straight strands need a single sub-segment per segment.
+    const std::vector<uint32_t> lineCounts = {4};
+    const std::vector<float3> linePoints = {float3(0.f), float3(1.f, 0.f, 0.f), float3(2.f, 0.f, 0.f), float3(3.f, 0.f, 0.f)};
+    const std::vector<float> lineWidths(4, 0.1f);
+    auto line = CurveTessellation::convertToLinearSweptSphere(1, lineCounts.data(), linePoints.data(), lineWidths.data(), nullptr, 1, kMaxSubdiv, 1, 1, 1.f, identity, kMaxError);
+    EXPECT_EQ(line.points.size(), 4);
+    EXPECT_EQ(line.indices.size(), 3);
+
+    // Polytubes use the same sample count per strand.
+    const uint32_t kPointsPerCrossSection = 4;
+    auto mesh = CurveTessellation::convertToPolytube(
+        curves.strandCount(), curves.vertexCounts.data(), curves.controlPoints.data(), curves.widths.data(), nullptr, kMaxSubdiv, 1, 1, 1.f, kPointsPerCrossSection, kMaxError
+    );
+    EXPECT_EQ(mesh.vertices.size(), adaptive.points.size() * kPointsPerCrossSection);
+    EXPECT_EQ(mesh.faceVertexCounts.size(), adaptive.indices.size() * 2 * kPointsPerCrossSection);
+    for (uint32_t index : mesh.faceVertexIndices)
+        EXPECT_LT(index, mesh.vertices.size());
+}
+} // namespace Falcor
@@ -0,0 +1,181 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Platform/OS.h"
+#include "Scene/Material/MeasuredBRDFAlbedo.h"
+#include "Scene/Material/MERLFile.h"
+#include "Scene/Material/MERLMaterialData.slang"
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+const size_t kMERLSampleCount = 90 * 90 * 360 / 2;
+const uint32_t kBinCount = 32;
+
+/** Write a synthetic glossy MERL BRDF (diffuse base plus a Beckmann-like lobe with Schlick Fresnel) in the MERL binary format.
+ */
+void writeGlossyMERL(const std::filesystem::path& path, float alpha)
+{
+    const int dims[3] = {90, 90, 180};
+    const double scales[3] = {1.0 / 1500.0, 1.15 / 1500.0, 1.66 / 1500.0};
+    const float3 specular = float3(0.25f, 0.2f, 0.15f);
+
+    std::vector<double> data(3 * kMERLSampleCount);
+    for (int thetaH = 0; thetaH < dims[0]; thetaH++)
+    {
+        // Half-angles are stored with a square-root mapping.
+        const float t = (float)thetaH / dims[0];
+        const float cosH = std::cos(t * t * (float)M_PI_2);
+        const float tan2H = (1.f - cosH * cosH) / (cosH * cosH);
+        const float D = std::exp(-tan2H / (alpha * alpha)) / ((float)M_PI * alpha * alpha * cosH * cosH * cosH * cosH);
+
+        for (int thetaD = 0; thetaD < dims[1]; thetaD++)
+        {
+            const float F = 0.04f + 0.96f * std::pow(1.f - std::cos((float)thetaD / dims[1] * (float)M_PI_2), 5.f);
+            const float3 value = float3(0.2f * (float)M_1_PI) + specular * D * F;
+
+            for (int phiD = 0; phiD < dims[2]; phiD++)
+            {
+                const size_t i = ((size_t)thetaH * dims[1] + thetaD) * dims[2] + phiD;
+                for (int c = 0; c < 3; c++)
+                    data[i + c * kMERLSampleCount] = value[c] / scales[c];
+            }
+        }
+    }
+
+    std::ofstream ofs(path, std::ios::binary);
+    ofs.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+    ofs.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(double));
+}
+} // namespace
+
+CPU_TEST(MeasuredBRDFAlbedo_MERL)
+{
+    // A Lambertian BRDF with constant value albedo / pi integrates to the albedo for all incident directions.
+    const float3 albedo = float3(0.25f, 0.5f, 0.75f);
+    std::vector<float3> data(kMERLSampleCount, albedo * (float)M_1_PI);
+
+    auto lut = MeasuredBRDFAlbedo::computeMERL(data, kBinCount, 64);
+    ASSERT_EQ(lut.size(), kBinCount);
+    for (const float4& v : lut)
+    {
+        EXPECT_LE(std::abs(v.x - albedo.x), 1e-4f);
+        EXPECT_LE(std::abs(v.y - albedo.y), 1e-4f);
+        EXPECT_LE(std::abs(v.z - albedo.z), 1e-4f);
+        EXPECT_EQ(v.w, 1.f);
+    }
+
+    // A BRDF that is zero except for a band of half-angles has an albedo between zero and one.
+    for (size_t i = 0; i < kMERLSampleCount / 2; i++)
+        data[i] = float3(0.f);
+    lut = MeasuredBRDFAlbedo::computeMERL(data, kBinCount, 64);
+    for (const float4& v : lut)
+    {
+        EXPECT_GE(v.y, 0.f);
+        EXPECT_LT(v.y, albedo.y);
+    }
+
+    EXPECT_THROW(MeasuredBRDFAlbedo::computeMERL(std::vector<float3>(16), kBinCount));
+}
+
+GPU_TEST(MeasuredBRDFAlbedo_MatchesBSDFIntegrator)
+{
+    // The CPU tables use a coarser integration grid than BSDFIntegrator (see MeasuredBRDFAlbedo).
+    // Check that they agree with the GPU reference on a glossy BRDF.
+    const std::filesystem::path directory = getTempFilePath();
+    std::filesystem::create_directories(directory);
+    const std::filesystem::path path = directory / "glossy.binary";
+    writeGlossyMERL(path, 0.15f);
+
+    MERLFile merlFile;
+    ASSERT(merlFile.loadBRDF(path));
+
+    // No lookup table is stored beside the BRDF, so this integrates on the GPU.
+    const std::vector<float4> gpuLut = merlFile.prepareAlbedoLUT(ctx.getDevice());
+    const std::vector<float4> cpuLut = MeasuredBRDFAlbedo::computeMERL(merlFile.getData(), MERLMaterialData::kAlbedoLUTSize);
+    ASSERT_EQ(gpuLut.size(), MERLMaterialData::kAlbedoLUTSize);
+    ASSERT_EQ(cpuLut.size(), gpuLut.size());
+
+    for (size_t i = 0; i < cpuLut.size(); i++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            EXPECT_GT(gpuLut[i][c], 0.f);
+            EXPECT_LE(std::abs(cpuLut[i][c] - gpuLut[i][c]), 1e-2f * gpuLut[i][c]) << "bin " << i << ", channel " << c;
+        }
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+CPU_TEST(MeasuredBRDFAlbedo_Cache)
+{
+    const std::filesystem::path prevDirectory = MeasuredBRDFAlbedo::getCacheDirectory();
+    const std::filesystem::path directory = getTempFilePath();
+    MeasuredBRDFAlbedo::setCacheDirectory(directory);
+
+    std::vector<float4> lut(kBinCount);
+    for (uint32_t i = 0; i < kBinCount; i++)
+        lut[i] = float4((float)i, 0.5f, 1.f / (i + 1), 1.f);
+
+    const Hash128::Digest contentHash = Hash128::compute(lut.data(), lut.size() * sizeof(float4));
+    const std::string key = MeasuredBRDFAlbedo::computeCacheKey("Test", contentHash, kBinCount);
+    EXPECT_EQ(key.size(), 32);
+    EXPECT_NE(key, MeasuredBRDFAlbedo::computeCacheKey("Test2", contentHash, kBinCount));
+    EXPECT_NE(key, MeasuredBRDFAlbedo::computeCacheKey("Test", contentHash, kBinCount + 1));
+    EXPECT_NE(key, MeasuredBRDFAlbedo::computeCacheKey("Test", Hash128::compute("x", 1), kBinCount));
+
+    std::vector<float4> loaded;
+    EXPECT(!MeasuredBRDFAlbedo::loadFromCache(key, kBinCount, loaded));
+
+    MeasuredBRDFAlbedo::storeToCache(key, lut);
+    EXPECT(MeasuredBRDFAlbedo::loadFromCache(key, kBinCount, loaded));
+    ASSERT_EQ(loaded.size(), lut.size());
+    for (uint32_t i = 0; i < kBinCount; i++)
+        EXPECT(all(loaded[i] == lut[i]));
+
+    // Entries with a different table size are rejected.
+    EXPECT(!MeasuredBRDFAlbedo::loadFromCache(key, kBinCount * 2, loaded));
+
+    // Truncated entries are rejected.
+    const std::filesystem::path path = directory / (key + ".lut");
+    ASSERT(std::filesystem::is_regular_file(path));
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+    EXPECT(!MeasuredBRDFAlbedo::loadFromCache(key, kBinCount, loaded));
+
+    // An empty cache directory disables the cache.
+    MeasuredBRDFAlbedo::setCacheDirectory("");
+    MeasuredBRDFAlbedo::storeToCache(key, lut);
+    EXPECT(!MeasuredBRDFAlbedo::loadFromCache(key, kBinCount, loaded));
+
+    MeasuredBRDFAlbedo::setCacheDirectory(prevDirectory);
+    std::filesystem::remove_all(directory);
+}
+} // namespace Falcor
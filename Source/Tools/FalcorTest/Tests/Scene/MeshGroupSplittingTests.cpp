@@ -0,0 +1,162 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/MeshGroupSplitting.h"
+#include "Utils/Math/Common.h"
+#include <algorithm>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kLatticeSize = 16;
+const size_t kTrianglesPerMesh = 1000;
+
+/// Create the bounds of a lattice of separated unit-sized meshes.
+std::vector<AABB> createLattice()
+{
+    std::vector<AABB> bounds;
+    for (uint32_t z = 0; z < kLatticeSize; z++)
+        for (uint32_t y = 0; y < kLatticeSize; y++)
+            for (uint32_t x = 0; x < kLatticeSize; x++)
+                bounds.emplace_back(float3(x, y, z), float3(x, y, z) + 0.9f);
+    return bounds;
+}
+
+std::vector<AABB> computeGroupBounds(const std::vector<AABB>& bounds, const std::vector<std::vector<uint32_t>>& groups)
+{
+    std::vector<AABB> groupBounds(groups.size());
+    for (size_t i = 0; i < groups.size(); i++)
+        for (uint32_t index : groups[i])
+            groupBounds[i].include(bounds[index]);
+    return groupBounds;
+}
+
+/// Sum of the pairwise overlap volumes of the group bounds, relative to the volume of the union of all groups.
+float computeOverlap(const std::vector<AABB>& groupBounds)
+{
+    AABB sceneBounds;
+    float overlap = 0.f;
+    for (size_t i = 0; i < groupBounds.size(); i++)
+    {
+        sceneBounds.include(groupBounds[i]);
+        for (size_t j = i + 1; j < groupBounds.size(); j++)
+        {
+            AABB bb = groupBounds[i];
+            bb.intersection(groupBounds[j]);
+            if (bb.valid())
+                overlap += bb.volume();
+        }
+    }
+    return overlap / sceneBounds.volume();
+}
+
+void checkPartition(CPUUnitTestContext& ctx, const std::vector<std::vector<uint32_t>>& groups, size_t meshCount)
+{
+    std::vector<uint32_t> indices;
+    for (const auto& group : groups)
+    {
+        EXPECT(!group.empty());
+        indices.insert(indices.end(), group.begin(), group.end());
+    }
+    std::sort(indices.begin(), indices.end());
+    ASSERT_EQ(indices.size(), meshCount);
+    for (size_t i = 0; i < meshCount; i++)
+        EXPECT_EQ(indices[i], i);
+}
+} // namespace
+
+CPU_TEST(MeshGroupSplitting_Morton)
+{
+    std::vector<AABB> bounds = createLattice();
+    const size_t meshCount = bounds.size();
+
+    // Shuffle the meshes so that the input order carries no spatial information.
+    std::mt19937 rng(1234);
+    std::shuffle(bounds.begin(), bounds.end(), rng);
+
+    // Each group of 64 meshes is a 4x4x4 block of the lattice, so the groups don't overlap.
+    const std::vector<size_t> triangleCounts(meshCount, kTrianglesPerMesh);
+    const auto groups = MeshGroupSplitting::partitionMorton(bounds, triangleCounts, 64 * kTrianglesPerMesh);
+    checkPartition(ctx, groups, meshCount);
+    EXPECT_EQ(groups.size(), meshCount / 64);
+    for (const auto& group : groups)
+        EXPECT_EQ(group.size(), 64);
+    EXPECT_EQ(computeOverlap(computeGroupBounds(bounds, groups)), 0.f);
+
+    // For comparison, cutting the input order by triangle count makes every group span the whole scene,
+    // so all pairs of groups overlap almost completely.
+    std::vector<std::vector<uint32_t>> unsorted(groups.size());
+    for (uint32_t i = 0; i < meshCount; i++)
+        unsorted[i / 64].push_back(i);
+    const float unsortedOverlap = computeOverlap(computeGroupBounds(bounds, unsorted));
+    EXPECT_GT(unsortedOverlap, 0.5f * groups.size() * (groups.size() - 1) / 2);
+
+    // With a budget that is not a power of eight, groups stay within the budget and overlap little.
+    // The target size per group is rounded down, so there may be one group more than the minimum.
+    const auto groups2 = MeshGroupSplitting::partitionMorton(bounds, triangleCounts, 100 * kTrianglesPerMesh);
+    checkPartition(ctx, groups2, meshCount);
+    EXPECT_GE(groups2.size(), div_round_up(meshCount, size_t(100)));
+    EXPECT_LE(groups2.size(), div_round_up(meshCount, size_t(100)) + 1);
+    for (const auto& group : groups2)
+        EXPECT_LE(group.size(), 100);
+    EXPECT_LE(computeOverlap(computeGroupBounds(bounds, groups2)), 0.01f * unsortedOverlap);
+
+    // A single group is returned if the meshes fit.
+    EXPECT_EQ(MeshGroupSplitting::partitionMorton(bounds, triangleCounts, meshCount * kTrianglesPerMesh).size(), 1);
+    EXPECT(MeshGroupSplitting::partitionMorton({}, {}, 1).empty());
+}
+
+CPU_TEST(MeshGroupSplitting_LargeMesh)
+{
+    std::vector<AABB> bounds = createLattice();
+    EXPECT(!MeshGroupSplitting::hasLargeMesh(bounds));
+
+    // A mesh spanning the scene along the largest axis makes the group it is placed in overlap all others.
+    // SceneBuilder splits such groups at the midpoint instead.
+    bounds.emplace_back(float3(0.f, 7.f, 7.f), float3(kLatticeSize, 8.f, 8.f));
+    EXPECT(MeshGroupSplitting::hasLargeMesh(bounds));
+    EXPECT(!MeshGroupSplitting::hasLargeMesh(bounds, 1.f));
+
+    const std::vector<size_t> triangleCounts(bounds.size(), kTrianglesPerMesh);
+    const auto groups = MeshGroupSplitting::partitionMorton(bounds, triangleCounts, 64 * kTrianglesPerMesh);
+    checkPartition(ctx, groups, bounds.size());
+    const std::vector<AABB> groupBounds = computeGroupBounds(bounds, groups);
+    const auto it = std::find_if(groups.begin(), groups.end(), [&](const auto& group)
+                                 { return std::find(group.begin(), group.end(), uint32_t(bounds.size() - 1)) != group.end(); });
+    ASSERT(it != groups.end());
+    const AABB largeGroupBounds = groupBounds[it - groups.begin()];
+    EXPECT_EQ(largeGroupBounds.extent().x, (float)kLatticeSize);
+
+    // Meshes up to half the extent are not considered large.
+    bounds.back() = AABB(float3(4.f, 7.f, 7.f), float3(11.f, 8.f, 8.f));
+    EXPECT(!MeshGroupSplitting::hasLargeMesh(bounds));
+    EXPECT(!MeshGroupSplitting::hasLargeMesh({}));
+}
+} // namespace Falcor
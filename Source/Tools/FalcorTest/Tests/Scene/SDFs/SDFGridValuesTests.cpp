@@ -0,0 +1,146 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Platform/OS.h"
+#include "Scene/SDFs/SDFGridValues.h"
+#include "Utils/Math/Float16.h"
+#include "Utils/Math/MathConstants.slangh"
+#include <cstring>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kGridWidth = 64;
+
+std::vector<float> createValues(uint32_t gridWidth, uint32_t seed)
+{
+    // Distances cover the full range of the unit grid and beyond, so that clamping is exercised.
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-2.f, 2.f);
+    std::vector<float> values(SDFGridValues::getValueCount(gridWidth));
+    for (float& v : values)
+        v = dist(rng) * dist(rng) * dist(rng) / 4.f;
+    return values;
+}
+
+/// Reference quantization, as previously implemented by the SDF grid types.
+int8_t quantizeReference(float value, float normalizationMultiplier)
+{
+    float normalizedValue = std::clamp(value * normalizationMultiplier, -1.0f, 1.0f);
+    float integerScale = normalizedValue * float(INT8_MAX);
+    return integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f);
+}
+
+std::vector<int8_t> quantize(const std::vector<float>& values, uint32_t gridWidth)
+{
+    std::vector<int8_t> result(values.size());
+    SDFGridValues::quantizeSnorm8(values.data(), values.size(), 2.0f * gridWidth / float(M_SQRT3), result.data());
+    return result;
+}
+} // namespace
+
+CPU_TEST(SDFGridValues_Quantize)
+{
+    std::vector<float> values = createValues(kGridWidth, 1);
+    values[0] = 0.f;
+    values[1] = -0.f;
+    values[2] = 1e6f;
+    values[3] = -1e6f;
+
+    const float normalizationMultiplier = 2.0f * kGridWidth / float(M_SQRT3);
+    std::vector<int8_t> quantized(values.size());
+    SDFGridValues::quantizeSnorm8(values.data(), values.size(), normalizationMultiplier, quantized.data());
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < values.size(); i++)
+        mismatches += quantized[i] != quantizeReference(values[i], normalizationMultiplier);
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_EQ(quantized[2], INT8_MAX);
+    EXPECT_EQ(quantized[3], -INT8_MAX);
+}
+
+CPU_TEST(SDFGridValues_RoundTrip)
+{
+    const std::vector<float> values = createValues(kGridWidth, 2);
+    const std::vector<int8_t> expected = quantize(values, kGridWidth);
+    const std::filesystem::path path = getTempFilePath();
+
+    // Float32 is stored in the legacy layout and is lossless.
+    {
+        ASSERT(SDFGridValues::writeFile(path, values, kGridWidth, SDFGridValues::Encoding::Float32));
+        EXPECT_EQ(std::filesystem::file_size(path), sizeof(uint32_t) + values.size() * sizeof(float));
+
+        std::vector<float> loaded;
+        uint32_t gridWidth = 0;
+        ASSERT(SDFGridValues::readFile(path, loaded, gridWidth));
+        EXPECT_EQ(gridWidth, kGridWidth);
+        ASSERT_EQ(loaded.size(), values.size());
+        EXPECT(std::memcmp(loaded.data(), values.data(), values.size() * sizeof(float)) == 0);
+    }
+
+    // Float16 decodes to the nearest half precision value.
+    {
+        ASSERT(SDFGridValues::writeFile(path, values, kGridWidth, SDFGridValues::Encoding::Float16));
+
+        std::vector<float> loaded;
+        uint32_t gridWidth = 0;
+        ASSERT(SDFGridValues::readFile(path, loaded, gridWidth));
+        EXPECT_EQ(gridWidth, kGridWidth);
+        ASSERT_EQ(loaded.size(), values.size());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < values.size(); i++)
+            mismatches += loaded[i] != math::float16ToFloat32(math::float32ToFloat16(values[i]));
+        EXPECT_EQ(mismatches, 0);
+    }
+
+    // Snorm8 reproduces the quantized values of the sparse grid types exactly.
+    {
+        ASSERT(SDFGridValues::writeFile(path, values, kGridWidth, SDFGridValues::Encoding::Snorm8));
+        EXPECT_EQ(std::filesystem::file_size(path), sizeof(SDFGridValues::FileHeader) + values.size());
+
+        std::vector<float> loaded;
+        uint32_t gridWidth = 0;
+        ASSERT(SDFGridValues::readFile(path, loaded, gridWidth));
+        EXPECT_EQ(gridWidth, kGridWidth);
+        ASSERT_EQ(loaded.size(), values.size());
+        EXPECT(quantize(loaded, kGridWidth) == expected);
+    }
+
+    // Truncated files are rejected.
+    {
+        std::filesystem::resize_file(path, sizeof(SDFGridValues::FileHeader) + values.size() / 2);
+        std::vector<float> loaded;
+        uint32_t gridWidth = 0;
+        EXPECT(!SDFGridValues::readFile(path, loaded, gridWidth));
+    }
+
+    std::filesystem::remove(path);
+}
+} // namespace Falcor
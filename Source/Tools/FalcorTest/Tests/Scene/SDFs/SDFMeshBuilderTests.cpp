@@ -0,0 +1,170 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SDFs/SDFMeshBuilder.h"
+#include "Utils/Math/MathConstants.slangh"
+#include <random>
+#include <set>
+#include <tuple>
+
+namespace Falcor
+{
+namespace
+{
+const float3 kBoxHalfExtent = float3(0.3f, 0.2f, 0.25f);
+
+/// Box with separate vertices per face, as exported by typical CAD tools with flat shading.
+void createBox(std::vector<float3>& positions, std::vector<uint32_t>& indices)
+{
+    for (uint32_t axis = 0; axis < 3; axis++)
+    {
+        for (float side : {-1.f, 1.f})
+        {
+            uint32_t u = (axis + 1) % 3;
+            uint32_t v = (axis + 2) % 3;
+            uint32_t base = (uint32_t)positions.size();
+            for (uint32_t i = 0; i < 4; i++)
+            {
+                float3 p;
+                p[axis] = side * kBoxHalfExtent[axis];
+                p[u] = ((i & 1) ? 1.f : -1.f) * kBoxHalfExtent[u];
+                p[v] = ((i & 2) ? 1.f : -1.f) * kBoxHalfExtent[v];
+                positions.push_back(p);
+            }
+            // Counter-clockwise when seen from outside.
+            if (side > 0.f)
+                indices.insert(indices.end(), {base, base + 1, base + 3, base, base + 3, base + 2});
+            else
+                indices.insert(indices.end(), {base, base + 3, base + 1, base, base + 2, base + 3});
+        }
+    }
+}
+
+float boxDistance(const float3& p)
+{
+    float3 d = abs(p) - kBoxHalfExtent;
+    return length(max(d, float3(0.f))) + std::min(std::max(std::max(d.x, d.y), d.z), 0.f);
+}
+} // namespace
+
+CPU_TEST(SDFMeshBuilder_Evaluate)
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+    createBox(positions, indices);
+    SDFMeshBuilder builder(positions, indices);
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> u(-0.5f, 0.5f);
+    size_t errors = 0;
+    for (uint32_t i = 0; i < 10000; i++)
+    {
+        float3 p(u(rng), u(rng), u(rng));
+        errors += std::abs(builder.evaluate(p) - boxDistance(p)) > 1e-5f;
+    }
+    EXPECT_EQ(errors, 0);
+
+    // Points closest to edges and corners get their sign from the edge and vertex pseudonormals.
+    EXPECT_LT(builder.evaluate(float3(0.29f, 0.19f, 0.24f)), 0.f);
+    EXPECT_GT(builder.evaluate(float3(0.31f, 0.21f, 0.f)), 0.f);
+    EXPECT_GT(builder.evaluate(float3(0.31f, 0.21f, 0.26f)), 0.f);
+
+    std::vector<float> values = builder.buildValues(16);
+    ASSERT_EQ(values.size(), SDFGridValues::getValueCount(16));
+    EXPECT_LE(std::abs(values[0] - boxDistance(float3(-0.5f))), 1e-5f);
+}
+
+CPU_TEST(SDFMeshBuilder_Bricks)
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+    createBox(positions, indices);
+    SDFMeshBuilder builder(SDFMeshBuilder::fitToGrid(positions, 0.1f), indices);
+
+    const uint32_t gridWidth = 64;
+    const uint32_t brickWidth = 7;
+    SDFGridValues::SparseBricks bricks = builder.buildBricks(gridWidth, brickWidth);
+    ASSERT_EQ(bricks.values.size(), bricks.brickCoords.size() * bricks.getValuesPerBrick());
+    EXPECT_GT(bricks.getBrickCount(), 0);
+    EXPECT_LT(bricks.getBrickCount(), bricks.getBricksPerAxis() * bricks.getBricksPerAxis() * bricks.getBricksPerAxis());
+
+    // Reference: quantize dense values and select bricks that contain the surface.
+    std::vector<float> values = builder.buildValues(gridWidth);
+    std::vector<int8_t> quantized(values.size());
+    SDFGridValues::quantizeSnorm8(values.data(), values.size(), 2.0f * gridWidth / float(M_SQRT3), quantized.data());
+
+    const uint32_t w = gridWidth + 1;
+    auto at = [&](uint32_t x, uint32_t y, uint32_t z) { return quantized[x + w * (y + w * z)]; };
+    std::set<std::tuple<uint32_t, uint32_t, uint32_t>> expectedBricks;
+    for (uint32_t z = 0; z < gridWidth; z++)
+    {
+        for (uint32_t y = 0; y < gridWidth; y++)
+        {
+            for (uint32_t x = 0; x < gridWidth; x++)
+            {
+                bool hasNonPositive = false;
+                bool hasNonNegative = false;
+                for (uint32_t i = 0; i < 8; i++)
+                {
+                    int8_t v = at(x + (i & 1), y + ((i >> 1) & 1), z + (i >> 2));
+                    hasNonPositive |= v <= 0;
+                    hasNonNegative |= v >= 0;
+                }
+                if (hasNonPositive && hasNonNegative)
+                    expectedBricks.emplace(x / brickWidth, y / brickWidth, z / brickWidth);
+            }
+        }
+    }
+
+    std::set<std::tuple<uint32_t, uint32_t, uint32_t>> actualBricks;
+    size_t mismatches = 0;
+    const uint32_t bw = brickWidth + 1;
+    for (uint32_t b = 0; b < bricks.getBrickCount(); b++)
+    {
+        const uint3 coords = bricks.brickCoords[b];
+        actualBricks.emplace(coords.x, coords.y, coords.z);
+
+        const int8_t* pBrick = bricks.values.data() + b * bricks.getValuesPerBrick();
+        for (uint32_t z = 0; z < bw; z++)
+        {
+            for (uint32_t y = 0; y < bw; y++)
+            {
+                for (uint32_t x = 0; x < bw; x++)
+                {
+                    uint3 c = coords * brickWidth + uint3(x, y, z);
+                    if (any(c > uint3(gridWidth)))
+                        continue;
+                    mismatches += pBrick[x + bw * (y + bw * z)] != at(c.x, c.y, c.z);
+                }
+            }
+        }
+    }
+    EXPECT_EQ(mismatches, 0);
+    EXPECT(actualBricks == expectedBricks);
+}
+} // namespace Falcor
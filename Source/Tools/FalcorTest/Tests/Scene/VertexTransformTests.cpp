@@ -0,0 +1,155 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/VertexTransform.h"
+#include "Utils/Math/MatrixMath.h"
+#include "Utils/Math/VectorMath.h"
+#include "Utils/Threading.h"
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+std::vector<StaticVertexData> createVertices(size_t count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    std::vector<StaticVertexData> vertices(count);
+    for (auto& v : vertices)
+    {
+        v.position = float3(dist(rng), dist(rng), dist(rng)) * 10.f;
+        v.normal = normalize(float3(dist(rng), dist(rng), dist(rng)) + float3(0.f, 0.f, 2.f));
+        v.tangent = float4(normalize(float3(dist(rng), dist(rng), dist(rng)) + float3(2.f, 0.f, 0.f)), dist(rng) < 0.f ? -1.f : 1.f);
+        v.texCrd = float2(dist(rng), dist(rng));
+        v.curveRadius = dist(rng) < 0.f ? 0.f : 0.5f * (dist(rng) + 1.f);
+    }
+    return vertices;
+}
+
+float4x4 createTransform(bool mirror)
+{
+    float4x4 transform = mul(math::matrixFromTranslation(float3(1.f, -2.f, 3.f)), math::matrixFromRotationXYZ(0.3f, -1.1f, 2.f));
+    transform = mul(transform, math::matrixFromScaling(float3(mirror ? -2.f : 2.f, 0.5f, 3.f)));
+    return transform;
+}
+
+/// Reference transform, as previously implemented in SceneBuilder::pretransformStaticMeshes().
+/// The normal and tangent transforms are computed once per mesh.
+void transformReference(const float4x4& transform, std::vector<StaticVertexData>& vertices)
+{
+    float3x3 invTranspose3x3 = float3x3(transpose(inverse(transform)));
+    float3x3 transform3x3 = float3x3(transform);
+    for (auto& v : vertices)
+    {
+        v.position = transformPoint(transform, v.position);
+        v.normal = normalize(transformVector(invTranspose3x3, v.normal));
+        v.tangent = float4(normalize(transformVector(transform3x3, v.tangent.xyz())), v.tangent.w);
+        v.curveRadius = length(transformVector(transform3x3, float3(v.curveRadius, 0.f, 0.f)));
+    }
+}
+} // namespace
+
+CPU_TEST(VertexTransform_MatchesReference)
+{
+    for (bool mirror : {false, true})
+    {
+        const float4x4 transform = createTransform(mirror);
+        VertexTransform vertexTransform(transform);
+        EXPECT_EQ(vertexTransform.flipsWinding(), mirror);
+
+        const auto vertices = createVertices(1000, 1);
+        auto reference = vertices;
+        transformReference(transform, reference);
+
+        auto result = vertices;
+        vertexTransform.transform(result.data(), result.size());
+        auto resultScalar = vertices;
+        vertexTransform.transformScalar(resultScalar.data(), resultScalar.size());
+
+        for (size_t i = 0; i < vertices.size(); ++i)
+        {
+            const float kEpsilon = 1e-5f;
+            EXPECT_LE(length(result[i].position - reference[i].position), kEpsilon * 100.f) << "i = " << i;
+            EXPECT_LE(length(result[i].normal - reference[i].normal), kEpsilon) << "i = " << i;
+            EXPECT_LE(length(result[i].tangent - reference[i].tangent), kEpsilon) << "i = " << i;
+            EXPECT_LE(std::abs(result[i].curveRadius - reference[i].curveRadius), kEpsilon) << "i = " << i;
+            EXPECT(all(result[i].texCrd == vertices[i].texCrd)) << "i = " << i;
+
+            // The SIMD and scalar paths use the same order of operations.
+            EXPECT(all(result[i].position == resultScalar[i].position)) << "i = " << i;
+            EXPECT(all(result[i].normal == resultScalar[i].normal)) << "i = " << i;
+            EXPECT(all(result[i].tangent == resultScalar[i].tangent)) << "i = " << i;
+            EXPECT_EQ(result[i].curveRadius, resultScalar[i].curveRadius) << "i = " << i;
+        }
+    }
+}
+
+CPU_BENCHMARK(VertexTransform_Throughput)
+{
+    // Rigid transform, so that repeatedly transforming the same vertices stays well conditioned.
+    const float4x4 transform = mul(math::matrixFromTranslation(float3(1e-3f)), math::matrixFromRotationXYZ(0.3f, -1.1f, 2.f));
+    const VertexTransform vertexTransform(transform);
+    auto vertices = createVertices(1 << 20, 2);
+    ctx.setItemsPerIteration(vertices.size());
+    ctx.setBytesPerIteration(vertices.size() * sizeof(StaticVertexData));
+
+    auto reference = vertices;
+    ctx.run(
+        "reference",
+        [&]()
+        {
+            transformReference(transform, reference);
+            doNotOptimize(reference.data());
+        }
+    );
+
+    ctx.run("scalar", [&]() { vertexTransform.transformScalar(vertices.data(), vertices.size()); doNotOptimize(vertices.data()); });
+    ctx.run("simd", [&]() { vertexTransform.transform(vertices.data(), vertices.size()); doNotOptimize(vertices.data()); });
+
+    const size_t kChunkSize = 16384;
+    ctx.run(
+        "simd parallel",
+        [&]()
+        {
+            Threading::parallelFor(
+                0,
+                (vertices.size() + kChunkSize - 1) / kChunkSize,
+                [&](size_t chunk)
+                {
+                    size_t begin = chunk * kChunkSize;
+                    vertexTransform.transform(vertices.data() + begin, std::min(kChunkSize, vertices.size() - begin));
+                },
+                1
+            );
+            doNotOptimize(vertices.data());
+        }
+    );
+}
+} // namespace Falcor
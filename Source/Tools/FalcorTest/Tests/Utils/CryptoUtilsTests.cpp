@@ -26,11 +26,57 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "Testing/UnitTest.h"
+#include "Core/Platform/OS.h"
 #include "Utils/CryptoUtils.h"
+#include <fstream>
 #include <random>
 
 namespace Falcor
 {
+namespace
+{
+const std::string kLoremIpsum{
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua. "
+    "Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat. Duis aute irure "
+    "dolor in reprehenderit in voluptate velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint occaecat cupidatat non "
+    "proident, sunt in culpa qui officia deserunt mollit anim id est laborum."};
+
+std::vector<uint8_t> createTestData(size_t size)
+{
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++)
+        data[i] = (uint8_t)(i * 31 + (i >> 8));
+    return data;
+}
+
+/// Hash data in randomly sized pieces to exercise the buffering logic of the streaming interface.
+template<typename Hash>
+auto hashInPieces(const uint8_t* data, size_t len, uint32_t seed)
+{
+    Hash hash;
+    std::mt19937 rng(seed);
+    for (size_t offset = 0; offset < len;)
+    {
+        size_t count = std::min<size_t>(len - offset, rng() % 300);
+        hash.update(data + offset, count);
+        offset += count;
+    }
+    return hash.finalize();
+}
+
+/// Run test function with the portable and the accelerated hash paths.
+template<typename Func>
+void forEachHashPath(Func func)
+{
+    for (bool accelerated : {false, true})
+    {
+        setHashAccelerationEnabled(accelerated);
+        func(accelerated);
+    }
+    setHashAccelerationEnabled(true);
+}
+} // namespace
+
 CPU_TEST(SHA1)
 {
     {
@@ -50,13 +96,154 @@ CPU_TEST(SHA1)
     }
 
     {
-        std::string str{
-            "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua. "
-            "Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat. Duis aute irure "
-            "dolor in reprehenderit in voluptate velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint occaecat cupidatat non "
-            "proident, sunt in culpa qui officia deserunt mollit anim id est laborum."};
+        const std::string& str = kLoremIpsum;
         SHA1::MD md{0xcd, 0x36, 0xb3, 0x70, 0x75, 0x8a, 0x25, 0x9b, 0x34, 0x84, 0x50, 0x84, 0xa6, 0xcc, 0x38, 0x47, 0x3c, 0xb9, 0x5e, 0x27};
         EXPECT(SHA1::compute(str.data(), str.size()) == md);
     }
 }
+
+CPU_TEST(SHA1_Paths)
+{
+    EXPECT_EQ(SHA1::toString(SHA1::compute(nullptr, 0)), "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+
+    auto data = createTestData(1000000);
+    forEachHashPath(
+        [&](bool)
+        {
+            EXPECT_EQ(SHA1::toString(SHA1::compute("abc", 3)), "a9993e364706816aba3e25717850c26c9cd0d89d");
+            EXPECT_EQ(SHA1::toString(SHA1::compute(data.data(), data.size())), "3b228a7099ac3cfce53875b973b5c0e51590b902");
+            EXPECT_EQ(SHA1::toString(hashInPieces<SHA1>(data.data(), data.size(), 1)), "3b228a7099ac3cfce53875b973b5c0e51590b902");
+        }
+    );
+}
+
+CPU_TEST(SHA256)
+{
+    auto data = createTestData(1000000);
+    forEachHashPath(
+        [&](bool)
+        {
+            EXPECT_EQ(SHA256::toString(SHA256::compute("", 0)), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+            EXPECT_EQ(SHA256::toString(SHA256::compute("abc", 3)), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+            EXPECT_EQ(
+                SHA256::toString(SHA256::compute("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 56)),
+                "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"
+            );
+
+            SHA256 sha256;
+            sha256.update(std::string_view("Hello "));
+            sha256.update(std::string_view("World!"));
+            EXPECT_EQ(SHA256::toString(sha256.finalize()), "7f83b1657ff1fc53b92dc18148a1d65dfc2d4b1fa3d677284addd200126d9069");
+
+            const std::string expected = "b96047041d16fe8ee33b276f47c283a470181da2bbf923b84825c7612b086bde";
+            EXPECT_EQ(SHA256::toString(SHA256::compute(data.data(), data.size())), expected);
+            EXPECT_EQ(SHA256::toString(hashInPieces<SHA256>(data.data(), data.size(), 2)), expected);
+        }
+    );
+}
+
+CPU_TEST(Hash128)
+{
+    // Reference values computed with XXH3_128bits() from xxHash 0.8.
+    struct TestVector
+    {
+        std::string str;
+        Hash128::Digest digest;
+    };
+    const TestVector testVectors[] = {
+        {"", {0x6001c324468d497full, 0x99aa06d3014798d8ull}},
+        {"a", {0xe6c632b61e964e1full, 0xa96faf705af16834ull}},
+        {"abc", {0x78af5f94892f3950ull, 0x06b05ab6733a6185ull}},
+        {"Hello World!", {0xf56f7a348bed5898ull, 0xbbce2257f0cec895ull}},
+        {"0123456789abcdef0", {0x259d04103128b07bull, 0x4d011b9cf16c97fcull}},
+        {kLoremIpsum.substr(0, 200), {0xcff33cdfd6c30fb6ull, 0xf0d2c83a2f3b5d8eull}},
+        {kLoremIpsum, {0x5a164e0145351d01ull, 0x0b7155cf20619db8ull}},
+    };
+
+    auto data = createTestData(1000000);
+    const Hash128::Digest dataDigest = {0xfc96eebe894d5e1eull, 0xf39f7097fe564ba7ull};
+
+    forEachHashPath(
+        [&](bool)
+        {
+            for (const auto& v : testVectors)
+            {
+                EXPECT(Hash128::compute(v.str.data(), v.str.size()) == v.digest) << v.str.size();
+                EXPECT(hashInPieces<Hash128>((const uint8_t*)v.str.data(), v.str.size(), 3) == v.digest) << v.str.size();
+            }
+
+            EXPECT(Hash128::compute(data.data(), data.size()) == dataDigest);
+            EXPECT(hashInPieces<Hash128>(data.data(), data.size(), 4) == dataDigest);
+
+            // Streaming and one-shot hashing must agree for all the length classes and block boundaries.
+            for (size_t len = 0; len < 2100; len += 7)
+                EXPECT(hashInPieces<Hash128>(data.data(), len, (uint32_t)len) == Hash128::compute(data.data(), len)) << len;
+        }
+    );
+
+    EXPECT_EQ(Hash128::toString(testVectors[0].digest), "99aa06d3014798d86001c324468d497f");
+
+    // finalize() does not modify the state.
+    Hash128 hash;
+    hash.update(data.data(), 1000);
+    Hash128::Digest digest = hash.finalize();
+    EXPECT(hash.finalize() == digest);
+    hash.update(data.data() + 1000, data.size() - 1000);
+    EXPECT(hash.finalize() == dataDigest);
+    hash.reset();
+    EXPECT(hash.finalize() == testVectors[0].digest);
+}
+
+CPU_TEST(Hash128_Tree)
+{
+    auto data = createTestData(1000000);
+    const size_t chunkSize = 64 * 1024;
+
+    // The tree hash is the hash over the chunk digests followed by the total length and the chunk size.
+    Hash128 root;
+    for (size_t offset = 0; offset < data.size(); offset += chunkSize)
+    {
+        Hash128::Digest digest = Hash128::compute(data.data() + offset, std::min(chunkSize, data.size() - offset));
+        root.update(digest.low64);
+        root.update(digest.high64);
+    }
+    root.update((uint64_t)data.size());
+    root.update((uint64_t)chunkSize);
+    const Hash128::Digest expected = root.finalize();
+
+    EXPECT(Hash128::computeTree(data.data(), data.size(), chunkSize) == expected);
+    EXPECT(Hash128::computeTree(data.data(), data.size(), chunkSize / 2) != expected);
+    EXPECT(Hash128::computeTree(data.data(), data.size() - 1, chunkSize) != expected);
+    EXPECT(Hash128::computeTree(nullptr, 0, chunkSize) == Hash128::computeTree(nullptr, 0, chunkSize));
+
+    // Hashing a file gives the same result as hashing its content in memory.
+    std::filesystem::path path = getTempFilePath();
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+    EXPECT(Hash128::computeFile(path, chunkSize) == expected);
+    EXPECT(Hash128::computeFile(path, 1000) == Hash128::computeTree(data.data(), data.size(), 1000));
+    std::filesystem::remove(path);
+
+    EXPECT_THROW_AS(Hash128::computeFile(path), RuntimeError);
+}
+
+CPU_BENCHMARK(Hash_Throughput)
+{
+    auto data = createTestData(16 * 1024 * 1024);
+    ctx.setBytesPerIteration(data.size());
+
+    logInfo("Hash throughput (SHA extensions supported: {})", isHashAccelerationSupported());
+    forEachHashPath(
+        [&](bool accelerated)
+        {
+            const char* path = accelerated ? "accelerated" : "scalar";
+            ctx.run(fmt::format("SHA1 {}", path), [&]() { doNotOptimize(SHA1::compute(data.data(), data.size())); });
+            ctx.run(fmt::format("SHA256 {}", path), [&]() { doNotOptimize(SHA256::compute(data.data(), data.size())); });
+            ctx.run(fmt::format("Hash128 {}", path), [&]() { doNotOptimize(Hash128::compute(data.data(), data.size())); });
+            ctx.run(fmt::format("Hash128 tree {}", path), [&]() { doNotOptimize(Hash128::computeTree(data.data(), data.size())); });
+        }
+    );
+}
 } // namespace Falcor
@@ -0,0 +1,191 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Algorithm/IntervalPacking.h"
+
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+
+namespace
+{
+using Item = IntervalPacking::Item;
+
+bool overlaps(const Item& a, const Item& b)
+{
+    return a.begin <= b.end && b.begin <= a.end;
+}
+
+/// Brute-force peak memory: sum of sizes live at each time point.
+uint64_t referencePeakLiveBytes(const std::vector<Item>& items)
+{
+    uint32_t maxTime = 0;
+    for (const auto& item : items)
+        maxTime = std::max(maxTime, item.end);
+
+    uint64_t peak = 0;
+    for (uint32_t t = 0; t <= maxTime; ++t)
+    {
+        uint64_t live = 0;
+        for (const auto& item : items)
+            if (item.begin <= t && t <= item.end)
+                live += item.size;
+        peak = std::max(peak, live);
+    }
+    return peak;
+}
+
+/// Maximum number of items of a class that are live at the same time. This is the optimal slot count for that class.
+uint32_t referenceMaxOverlap(const std::vector<Item>& items, uint32_t compatibilityClass, uint32_t maxTime)
+{
+    uint32_t maxOverlap = 0;
+    for (uint32_t t = 0; t <= maxTime; ++t)
+    {
+        uint32_t live = 0;
+        for (const auto& item : items)
+            if (item.compatibilityClass == compatibilityClass && item.begin <= t && t <= item.end)
+                live++;
+        maxOverlap = std::max(maxOverlap, live);
+    }
+    return maxOverlap;
+}
+} // namespace
+
+CPU_TEST(IntervalPacking_Simple)
+{
+    // A chain of passes, each producing an output consumed by the next pass.
+    std::vector<Item> items = {
+        {0, 1, 0, 100},
+        {1, 2, 0, 100},
+        {2, 3, 0, 100},
+        {3, 4, 0, 100},
+    };
+
+    auto result = IntervalPacking::pack(items);
+    EXPECT_EQ(result.getSlotCount(), 2);
+    EXPECT_EQ(result.slots[0], result.slots[2]);
+    EXPECT_EQ(result.slots[1], result.slots[3]);
+    EXPECT_NE(result.slots[0], result.slots[1]);
+    EXPECT_EQ(result.bytesBefore, 400);
+    EXPECT_EQ(result.bytesAfter, 200);
+    EXPECT_EQ(result.peakLiveBytes, 200);
+}
+
+CPU_TEST(IntervalPacking_Incompatible)
+{
+    // Disjoint lifetimes but different classes can't share.
+    std::vector<Item> items = {
+        {0, 0, 0, 100},
+        {1, 1, 1, 100},
+        {2, 2, 0, 100},
+    };
+
+    auto result = IntervalPacking::pack(items);
+    EXPECT_EQ(result.getSlotCount(), 2);
+    EXPECT_EQ(result.slots[0], result.slots[2]);
+    EXPECT_NE(result.slots[0], result.slots[1]);
+    EXPECT_EQ(result.peakLiveBytes, 100);
+}
+
+CPU_TEST(IntervalPacking_NonAliasable)
+{
+    std::vector<Item> items = {
+        {0, 0, 0, 100, false},
+        {1, 1, 0, 100, true},
+        {2, 2, 0, 100, false},
+        {3, 3, 0, 100, true},
+    };
+
+    auto result = IntervalPacking::pack(items);
+    EXPECT_EQ(result.getSlotCount(), 3);
+    EXPECT_NE(result.slots[0], result.slots[1]);
+    EXPECT_NE(result.slots[0], result.slots[2]);
+    EXPECT_NE(result.slots[2], result.slots[3]);
+    EXPECT_EQ(result.slots[1], result.slots[3]);
+    EXPECT_EQ(result.bytesAfter, 300);
+}
+
+CPU_TEST(IntervalPacking_Randomized)
+{
+    const uint32_t kMaxTime = 32;
+    const uint32_t kClassCount = 3;
+
+    for (uint32_t run = 0; run < 50; ++run)
+    {
+        std::mt19937 r(1234 + run);
+        std::vector<Item> items(1 + r() % 64);
+        for (auto& item : items)
+        {
+            item.begin = r() % kMaxTime;
+            item.end = item.begin + r() % 6;
+            item.compatibilityClass = r() % kClassCount;
+            item.size = 1 + r() % 1000;
+            item.aliasable = (r() % 8) != 0;
+        }
+
+        auto result = IntervalPacking::pack(items);
+        ASSERT_EQ(result.slots.size(), items.size());
+
+        // No two items sharing a slot may overlap or be incompatible.
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            EXPECT_LT(result.slots[i], result.getSlotCount());
+            EXPECT_GE(result.slotSizes[result.slots[i]], items[i].size);
+            for (size_t j = i + 1; j < items.size(); ++j)
+            {
+                if (result.slots[i] != result.slots[j])
+                    continue;
+                EXPECT(items[i].aliasable && items[j].aliasable) << fmt::format("Run {}: items {} and {}", run, i, j);
+                EXPECT_EQ(items[i].compatibilityClass, items[j].compatibilityClass) << fmt::format("Run {}: items {} and {}", run, i, j);
+                EXPECT(!overlaps(items[i], items[j])) << fmt::format("Run {}: items {} and {}", run, i, j);
+            }
+        }
+
+        // Greedy packing by start time is optimal per class when all items are aliasable.
+        std::vector<Item> aliasable;
+        for (const auto& item : items)
+            if (item.aliasable)
+                aliasable.push_back(item);
+        auto aliasableResult = IntervalPacking::pack(aliasable);
+        uint32_t optimalSlotCount = 0;
+        for (uint32_t c = 0; c < kClassCount; ++c)
+            optimalSlotCount += referenceMaxOverlap(aliasable, c, kMaxTime + 8);
+        EXPECT_EQ(aliasableResult.getSlotCount(), optimalSlotCount) << fmt::format("Run {}", run);
+
+        uint64_t bytesBefore = 0;
+        for (const auto& item : items)
+            bytesBefore += item.size;
+        EXPECT_EQ(result.bytesBefore, bytesBefore);
+        EXPECT_LE(result.bytesAfter, result.bytesBefore);
+        EXPECT_EQ(result.peakLiveBytes, referencePeakLiveBytes(items));
+    }
+}
+
+} // namespace Falcor
@@ -0,0 +1,129 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Algorithm/MortonSort.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+
+namespace
+{
+/// Reference Morton code computed one bit at a time.
+uint64_t referenceInterleave(uint32_t x, uint32_t y, uint32_t z)
+{
+    uint64_t code = 0;
+    for (uint32_t bit = 0; bit < MortonSort::kBitsPerAxis; ++bit)
+    {
+        code |= uint64_t((x >> bit) & 1) << (3 * bit + 0);
+        code |= uint64_t((y >> bit) & 1) << (3 * bit + 1);
+        code |= uint64_t((z >> bit) & 1) << (3 * bit + 2);
+    }
+    return code;
+}
+
+std::vector<uint32_t> referenceSort(const std::vector<uint64_t>& keys)
+{
+    std::vector<uint32_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+    return order;
+}
+} // namespace
+
+CPU_TEST(MortonSort_Encode)
+{
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<uint32_t> dist(0, (1u << MortonSort::kBitsPerAxis) - 1);
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        uint32_t x = dist(rng), y = dist(rng), z = dist(rng);
+        EXPECT_EQ(MortonSort::expandBits(x) | (MortonSort::expandBits(y) << 1) | (MortonSort::expandBits(z) << 2), referenceInterleave(x, y, z));
+    }
+
+    // Corners of the bounding box map to the first and last cell, points outside are clamped.
+    AABB bounds(float3(-1.f, 0.f, 2.f), float3(1.f, 4.f, 3.f));
+    const uint64_t kMaxCode = (1ull << (3 * MortonSort::kBitsPerAxis)) - 1;
+    EXPECT_EQ(MortonSort::encode(bounds.minPoint, bounds), 0ull);
+    EXPECT_EQ(MortonSort::encode(bounds.maxPoint, bounds), kMaxCode);
+    EXPECT_EQ(MortonSort::encode(float3(-10.f), bounds), 0ull);
+    EXPECT_EQ(MortonSort::encode(float3(10.f), bounds), kMaxCode);
+
+    // The center is the first cell of the upper octant.
+    EXPECT_EQ(MortonSort::encode(bounds.center(), bounds), 7ull << (3 * (MortonSort::kBitsPerAxis - 1)));
+
+    // Degenerate axes and NaN map to zero.
+    AABB flat(float3(0.f), float3(1.f, 0.f, 1.f));
+    EXPECT_EQ(MortonSort::encode(float3(0.f, 5.f, 0.f), flat), 0ull);
+    EXPECT_EQ(MortonSort::encode(float3(std::numeric_limits<float>::quiet_NaN()), bounds), 0ull);
+}
+
+CPU_TEST(MortonSort_MatchesStableSort)
+{
+    std::mt19937_64 rng(11);
+
+    // Sizes around the block size, and key ranges with few distinct values to exercise stability and skipped digits.
+    for (size_t count : {0, 1, 2, 100, 16383, 16384, 16385, 100000})
+    {
+        for (uint64_t mask : {~0ull, 0xffull, 0xff00ff0000ull, 0ull})
+        {
+            std::vector<uint64_t> keys(count);
+            for (auto& key : keys)
+                key = rng() & mask;
+
+            std::vector<uint32_t> order = MortonSort::sort(keys);
+            EXPECT(order == referenceSort(keys)) << "count=" << count << " mask=" << mask;
+        }
+    }
+
+    // Points in Morton order visit the cells of a regular lattice along the Z-curve.
+    // The corner point extends the bounds to a power of two so that each lattice point starts a cell.
+    std::vector<float3> points;
+    for (uint32_t z = 0; z < 4; ++z)
+        for (uint32_t y = 0; y < 4; ++y)
+            for (uint32_t x = 0; x < 4; ++x)
+                points.push_back(float3(float(x), float(y), float(z)));
+    points.push_back(float3(4.f));
+    std::shuffle(points.begin(), points.end(), rng);
+
+    std::vector<uint32_t> order = MortonSort::sortPoints(points);
+    ASSERT_EQ(order.size(), points.size());
+    for (size_t i = 0; i + 1 < order.size(); ++i)
+    {
+        const float3& p = points[order[i]];
+        EXPECT_EQ(referenceInterleave(uint32_t(p.x), uint32_t(p.y), uint32_t(p.z)), i);
+    }
+    EXPECT(all(points[order.back()] == float3(4.f)));
+}
+
+} // namespace Falcor
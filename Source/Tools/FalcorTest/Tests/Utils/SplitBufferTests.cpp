@@ -652,4 +652,50 @@ GPU_TEST(SplitBuffer_StructuredBuffer_Many32B)
     }
 }
 
+CPU_TEST(SplitBuffer_AllocateRanges)
+{
+    std::mt19937 rng;
+    std::uniform_int_distribution<uint32_t> countDist(0, 1000);
+
+    std::vector<size_t> counts(200);
+    for (auto& count : counts)
+        count = countDist(rng);
+
+    // Reference: insert the ranges one by one.
+    SplitBuffer<uint32_t, true> reference;
+    reference.setBufferCount(4);
+    std::vector<uint32_t> referenceOffsets;
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        std::vector<uint32_t> data(counts[i], (uint32_t)i);
+        referenceOffsets.push_back(reference.insert(data.begin(), data.end()));
+    }
+
+    // Allocate all ranges at once and fill them after committing.
+    SplitBuffer<uint32_t, true> buffer;
+    buffer.setBufferCount(4);
+    std::vector<uint32_t> offsets = buffer.allocateRanges(counts);
+    ASSERT_EQ(offsets.size(), counts.size());
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        EXPECT_EQ(offsets[i], referenceOffsets[i]);
+        uint32_t* pData = buffer.commitRange(offsets[i], counts[i]);
+        EXPECT_EQ(pData == nullptr, counts[i] == 0);
+        std::fill(pData, pData + counts[i], (uint32_t)i);
+    }
+
+    ASSERT_EQ(buffer.getBufferCount(), reference.getBufferCount());
+    EXPECT_EQ(buffer.getByteSize(), reference.getByteSize());
+    for (uint32_t i = 0; i < buffer.getBufferCount(); ++i)
+    {
+        EXPECT(buffer.getCpuBuffer(i) == reference.getCpuBuffer(i));
+        // The buffers are allocated with their final size.
+        EXPECT_EQ(buffer.getCpuBuffer(i).capacity(), buffer.getCpuBuffer(i).size());
+    }
+
+    // Regular inserts continue after the allocated ranges.
+    std::vector<uint32_t> data(10, 7);
+    EXPECT_EQ(buffer.insert(data.begin(), data.end()), reference.insert(data.begin(), data.end()));
+}
+
 } // namespace Falcor
@@ -0,0 +1,200 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/TaskScheduler.h"
+#include "Utils/Timing/CpuTimer.h"
+
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace Falcor
+{
+
+namespace
+{
+/// Some arithmetic work per item so that scheduling overhead does not dominate.
+float work(size_t i)
+{
+    float x = (float)i;
+    for (uint32_t j = 0; j < 64; ++j)
+        x = std::sin(x) * 0.5f + std::cos(x * 0.25f);
+    return x;
+}
+} // namespace
+
+CPU_TEST(TaskScheduler_Dispatch)
+{
+    for (uint32_t threadCount : {1u, 4u})
+    {
+        TaskScheduler scheduler(threadCount);
+        EXPECT_EQ(scheduler.getThreadCount(), threadCount);
+
+        std::atomic<uint32_t> counter{0};
+        std::vector<TaskScheduler::Task> tasks;
+        for (uint32_t i = 0; i < 100; ++i)
+            tasks.push_back(scheduler.dispatch([&]() { counter++; }));
+        for (auto& task : tasks)
+        {
+            task.finish();
+            EXPECT(!task.isRunning());
+        }
+        EXPECT_EQ(counter.load(), 100u);
+
+        for (uint32_t i = 0; i < 100; ++i)
+            scheduler.dispatch([&]() { counter++; });
+        scheduler.waitIdle();
+        EXPECT_EQ(counter.load(), 200u);
+    }
+}
+
+CPU_TEST(TaskScheduler_Continuations)
+{
+    TaskScheduler scheduler(4);
+
+    std::vector<uint32_t> order;
+    auto task = scheduler.dispatch([&]() { order.push_back(0); });
+    auto last = task.then([&]() { order.push_back(1); }).then([&]() { order.push_back(2); });
+    last.finish();
+    EXPECT(order == std::vector<uint32_t>({0, 1, 2}));
+
+    // Continuation added after the task finished.
+    auto late = task.then([&]() { order.push_back(3); });
+    late.finish();
+    EXPECT_EQ(order.size(), 4);
+
+    // Exceptions propagate to continuations, which are then not executed.
+    bool executed = false;
+    auto failing = scheduler.dispatch([]() { throw std::runtime_error("fail"); });
+    auto skipped = failing.then([&]() { executed = true; });
+    EXPECT_THROW_AS(skipped.finish(), std::runtime_error);
+    EXPECT_THROW_AS(failing.finish(), std::runtime_error);
+    EXPECT(!executed);
+}
+
+CPU_TEST(TaskScheduler_ParallelFor)
+{
+    for (uint32_t threadCount : {1u, 3u, 8u})
+    {
+        TaskScheduler scheduler(threadCount);
+        for (size_t grainSize : {0, 1, 7, 1000})
+        {
+            const size_t count = 10007;
+            std::vector<std::atomic<uint32_t>> visited(count);
+            scheduler.parallelFor(5, count, [&](size_t i) { visited[i]++; }, grainSize);
+            for (size_t i = 0; i < count; ++i)
+                EXPECT_EQ(visited[i].load(), i < 5 ? 0u : 1u) << "i = " << i;
+        }
+
+        // Empty range.
+        scheduler.parallelFor(10, 10, [&](size_t) { EXPECT(false); });
+
+        // Nested parallelism.
+        std::atomic<size_t> sum{0};
+        scheduler.parallelFor(0, 16, [&](size_t i) { scheduler.parallelFor(0, 100, [&](size_t j) { sum += i * 100 + j; }); }, 1);
+        EXPECT_EQ(sum.load(), 1600ull * 1599ull / 2ull);
+
+        // Exceptions are rethrown on the calling thread.
+        EXPECT_THROW_AS(
+            scheduler.parallelFor(
+                0,
+                1000,
+                [](size_t i)
+                {
+                    if (i == 500)
+                        throw std::runtime_error("fail");
+                }
+            ),
+            std::runtime_error
+        );
+    }
+}
+
+CPU_TEST(TaskScheduler_ParallelReduce)
+{
+    for (uint32_t threadCount : {1u, 4u})
+    {
+        TaskScheduler scheduler(threadCount);
+        uint64_t sum = scheduler.parallelReduce(
+            0, 100000, uint64_t(0), [](size_t i) { return (uint64_t)i; }, [](uint64_t a, uint64_t b) { return a + b; }
+        );
+        EXPECT_EQ(sum, 100000ull * 99999ull / 2ull);
+
+        // Non-commutative reduction checks that partial results are combined in order.
+        std::vector<uint32_t> sequence = scheduler.parallelReduce(
+            0,
+            1000,
+            std::vector<uint32_t>(),
+            [](size_t i) { return std::vector<uint32_t>{(uint32_t)i}; },
+            [](std::vector<uint32_t> a, std::vector<uint32_t> b)
+            {
+                a.insert(a.end(), b.begin(), b.end());
+                return a;
+            }
+        );
+        std::vector<uint32_t> expected(1000);
+        std::iota(expected.begin(), expected.end(), 0);
+        EXPECT(sequence == expected);
+
+        EXPECT_EQ(scheduler.parallelReduce(3, 3, 42, [](size_t) { return 0; }, [](int a, int b) { return a + b; }), 42);
+    }
+}
+
+CPU_TEST(TaskScheduler_Scaling, TAGS("benchmark"))
+{
+    const size_t count = 1 << 16;
+    const float expected = TaskScheduler(1).parallelReduce(0, count, 0.f, work, [](float a, float b) { return a + b; }, 1024);
+
+    double baseTime = 0.0;
+    for (uint32_t threadCount : {1u, 2u, 4u, 8u, 16u, 32u, 64u})
+    {
+        TaskScheduler scheduler(threadCount);
+        auto t0 = CpuTimer::getCurrentTimePoint();
+        float result = scheduler.parallelReduce(0, count, 0.f, work, [](float a, float b) { return a + b; }, 1024);
+        double time = CpuTimer::calcDuration(t0, CpuTimer::getCurrentTimePoint());
+        if (threadCount == 1)
+            baseTime = time;
+
+        // Fixed grain size gives the same chunks and order of partial results, so the result is bit exact.
+        EXPECT_EQ(result, expected);
+
+        auto stats = scheduler.getStats();
+        logInfo(
+            "TaskScheduler scaling: {:2} threads: {:8.2f} ms, speedup {:5.2f}x, {} tasks, {} stolen",
+            threadCount,
+            time,
+            baseTime / time,
+            stats.tasksExecuted,
+            stats.tasksStolen
+        );
+    }
+}
+
+} // namespace Falcor
@@ -118,6 +118,45 @@ const TextureAnalyzer::Result kExpectedResult[] = {
         float4(0.f, 0.f, 0.f, 1 / 256.f),
     },
 };
+
+std::filesystem::path getTestTexturePath(size_t i)
+{
+    return getRuntimeDirectory() / fmt::format("data/tests/texture{}.{}", i + 1, i < kNumPNGs ? "png" : "exr");
+}
+
+void verifyResults(UnitTestContext& ctx, const std::vector<TextureAnalyzer::Result>& result)
+{
+    EXPECT_EQ(result.size(), kNumTests);
+    for (size_t i = 0; i < kNumTests; i++)
+    {
+        EXPECT_EQ(result[i].mask, kExpectedResult[i].mask) << "i = " << i;
+
+        uint32_t rangeFlags = 0;
+        for (int c = 0; c < 4; c++)
+        {
+            bool isConstant = (kExpectedResult[i].mask & (1u << c)) == 0;
+            rangeFlags |= kExpectedResult[i].mask >> (4 + 4 * c);
+
+            EXPECT_EQ(result[i].isConstant(1u << c), isConstant) << " c = " << c;
+            EXPECT_EQ(result[i].minValue[c], kExpectedResult[i].minValue[c]) << "i = " << i << " c = " << c;
+            EXPECT_EQ(result[i].maxValue[c], kExpectedResult[i].maxValue[c]) << "i = " << i << " c = " << c;
+
+            if (isConstant)
+            {
+                EXPECT_EQ(result[i].value[c], kExpectedResult[i].value[c]) << "i = " << i << " c = " << c;
+            }
+        }
+
+        EXPECT_EQ(result[i].isPos(TextureChannelFlags::RGBA), (rangeFlags & (uint32_t)TextureAnalyzer::Result::RangeFlags::Pos) != 0)
+            << "i = " << i;
+        EXPECT_EQ(result[i].isNeg(TextureChannelFlags::RGBA), (rangeFlags & (uint32_t)TextureAnalyzer::Result::RangeFlags::Neg) != 0)
+            << "i = " << i;
+        EXPECT_EQ(result[i].isInf(TextureChannelFlags::RGBA), (rangeFlags & (uint32_t)TextureAnalyzer::Result::RangeFlags::Inf) != 0)
+            << "i = " << i;
+        EXPECT_EQ(result[i].isNaN(TextureChannelFlags::RGBA), (rangeFlags & (uint32_t)TextureAnalyzer::Result::RangeFlags::NaN) != 0)
+            << "i = " << i;
+    }
+}
 } // namespace
 
 GPU_TEST(TextureAnalyzer)
@@ -130,7 +169,7 @@ GPU_TEST(TextureAnalyzer)
     std::vector<ref<Texture>> textures(kNumTests);
     for (size_t i = 0; i < kNumTests; i++)
     {
-        std::filesystem::path path = getRuntimeDirectory() / fmt::format("data/tests/texture{}.{}", i + 1, i < kNumPNGs ? "png" : "exr");
+        std::filesystem::path path = getTestTexturePath(i);
         textures[i] = Texture::createFromFile(pDevice, path, false, false);
         if (!textures[i])
             FALCOR_THROW("Failed to load {}", path);
@@ -146,47 +185,39 @@ GPU_TEST(TextureAnalyzer)
         textureAnalyzer.analyze(ctx.getRenderContext(), textures[i], 0, 0, pResult, i * kResultSize);
     }
 
-    auto verify = [&ctx](ref<Buffer> pResult)
-    {
-        // Verify results.
-        std::vector<TextureAnalyzer::Result> result = pResult->getElements<TextureAnalyzer::Result>();
-        for (size_t i = 0; i < kNumTests; i++)
-        {
-            EXPECT_EQ(result[i].mask, kExpectedResult[i].mask) << "i = " << i;
-
-            uint32_t rangeFlags = 0;
-            for (int c = 0; c < 4; c++)
-            {
-                bool isConstant = (kExpectedResult[i].mask & (1u << c)) == 0;
-                rangeFlags |= kExpectedResult[i].mask >> (4 + 4 * c);
+    verifyResults(ctx, pResult->getElements<TextureAnalyzer::Result>());
 
-                EXPECT_EQ(result[i].isConstant(1u << c), isConstant) << " c = " << c;
-                EXPECT_EQ(result[i].minValue[c], kExpectedResult[i].minValue[c]) << "i = " << i << " c = " << c;
-                EXPECT_EQ(result[i].maxValue[c], kExpectedResult[i].maxValue[c]) << "i = " << i << " c = " << c;
+    // Test the array version of the interface.
+    ctx.getRenderContext()->clearUAV(pResult->getUAV().get(), uint4(0xbabababa));
+    textureAnalyzer.analyze(ctx.getRenderContext(), textures, pResult);
 
-                if (isConstant)
-                {
-                    EXPECT_EQ(result[i].value[c], kExpectedResult[i].value[c]) << "i = " << i << " c = " << c;
-                }
-            }
+    verifyResults(ctx, pResult->getElements<TextureAnalyzer::Result>());
+}
 
-            EXPECT_EQ(result[i].isPos(TextureChannelFlags::RGBA), (rangeFlags & (uint32_t)TextureAnalyzer::Result::RangeFlags::Pos) != 0)
-                << "i = " << i;
-            EXPECT_EQ(result[i].isNeg(TextureChannelFlags::RGBA), (rangeFlags & (uint32_t)TextureAnalyzer::Result::RangeFlags::Neg) != 0)
-                << "i = " << i;
-            EXPECT_EQ(result[i].isInf(TextureChannelFlags::RGBA), (rangeFlags & (uint32_t)TextureAnalyzer::Result::RangeFlags::Inf) != 0)
-                << "i = " << i;
-            EXPECT_EQ(result[i].isNaN(TextureChannelFlags::RGBA), (rangeFlags & (uint32_t)TextureAnalyzer::Result::RangeFlags::NaN) != 0)
-                << "i = " << i;
-        }
-    };
+CPU_TEST(TextureAnalyzer_Image)
+{
+    // Analyze the decoded test images on the CPU. The result should match the GPU analysis.
+    std::vector<TextureAnalyzer::Result> results(kNumTests);
+    for (size_t i = 0; i < kNumTests; i++)
+    {
+        std::filesystem::path path = getTestTexturePath(i);
+        auto pBitmap = Bitmap::createFromFile(path, true);
+        if (!pBitmap)
+            FALCOR_THROW("Failed to load {}", path);
 
-    verify(pResult);
+        auto result = TextureAnalyzer::analyzeImage(
+            pBitmap->getData(), pBitmap->getWidth(), pBitmap->getHeight(), pBitmap->getRowPitch(), pBitmap->getFormat()
+        );
+        EXPECT(result.has_value()) << "i = " << i;
+        if (result)
+            results[i] = *result;
+    }
 
-    // Test the array version of the interface.
-    ctx.getRenderContext()->clearUAV(pResult->getUAV().get(), uint4(0xbabababa));
-    textureAnalyzer.analyze(ctx.getRenderContext(), textures, pResult);
+    verifyResults(ctx, results);
 
-    verify(pResult);
+    // Block compressed formats are not supported.
+    EXPECT(!TextureAnalyzer::isImageFormatSupported(ResourceFormat::BC1Unorm));
+    uint8_t block[8] = {};
+    EXPECT(!TextureAnalyzer::analyzeImage(block, 4, 4, 8, ResourceFormat::BC1Unorm).has_value());
 }
 } // namespace Falcor
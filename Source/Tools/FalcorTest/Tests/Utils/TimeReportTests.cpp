@@ -0,0 +1,118 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Timing/TimeReport.h"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <vector>
+
+namespace Falcor
+{
+CPU_TEST(TimeReport_Records)
+{
+    TimeReport report;
+    EXPECT(!report.isMemoryTrackingEnabled());
+
+    report.measure("A");
+    report.measure("B", 1234);
+    report.addTotal();
+
+    const auto& records = report.getRecords();
+    ASSERT_EQ(records.size(), 3);
+    EXPECT_EQ(records[0].name, "A");
+    EXPECT_EQ(records[1].name, "B");
+    EXPECT_EQ(records[2].name, "Total");
+    EXPECT_EQ(records[1].trackedBytes, 1234);
+    EXPECT_EQ(records[2].trackedBytes, 1234);
+    EXPECT_EQ(records[2].seconds, records[0].seconds + records[1].seconds);
+
+    // Without memory tracking no resident sizes are recorded.
+    for (const auto& record : records)
+    {
+        EXPECT_EQ(record.residentBytes, 0);
+        EXPECT_EQ(record.peakResidentBytes, 0);
+    }
+
+    report.reset();
+    EXPECT(report.getRecords().empty());
+}
+
+CPU_TEST(TimeReport_MemoryTracking)
+{
+    TimeReport report;
+    report.enableMemoryTracking();
+    EXPECT(report.isMemoryTrackingEnabled());
+
+    // The resident set size is process-wide and changes with other tests running in parallel,
+    // so only the tracked bytes are checked exactly.
+    const size_t kSize = 16ull << 20;
+    report.measure("Idle");
+    {
+        std::vector<uint8_t> data(kSize, 1);
+        report.measure("Temporary", data.size());
+    }
+    report.addTotal();
+
+    const auto& records = report.getRecords();
+    ASSERT_EQ(records.size(), 3);
+    for (const auto& record : records)
+    {
+        EXPECT_GT(record.residentBytes, 0);
+        EXPECT_GE(record.peakResidentBytes, record.residentBytes);
+    }
+    EXPECT_EQ(records[0].trackedBytes, 0);
+    EXPECT_EQ(records[1].trackedBytes, kSize);
+    EXPECT_EQ(records[2].trackedBytes, kSize);
+}
+
+CPU_TEST(TimeReport_WriteJson)
+{
+    TimeReport report;
+    report.enableMemoryTracking();
+    report.measure("Step", 42);
+
+    std::filesystem::path path = getTempFilePath();
+    report.writeJson(path);
+
+    nlohmann::json json;
+    {
+        std::ifstream ifs(path);
+        json = nlohmann::json::parse(ifs);
+    }
+    std::filesystem::remove(path);
+
+    EXPECT(json["memory_tracking"].get<bool>());
+    ASSERT_EQ(json["records"].size(), 1);
+    const auto& record = json["records"][0];
+    EXPECT_EQ(record["name"].get<std::string>(), "Step");
+    EXPECT_EQ(record["tracked_bytes"].get<uint64_t>(), 42);
+    EXPECT_EQ(record["resident_bytes"].get<uint64_t>(), report.getRecords()[0].residentBytes);
+    EXPECT_EQ(record["peak_resident_bytes"].get<uint64_t>(), report.getRecords()[0].peakResidentBytes);
+}
+} // namespace Falcor
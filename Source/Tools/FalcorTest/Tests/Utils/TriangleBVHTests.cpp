@@ -0,0 +1,212 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Geometry/TriangleBVH.h"
+
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+
+namespace
+{
+struct TriangleSoup
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+};
+
+/// Random small triangles in a 10^3 box.
+TriangleSoup createRandomTriangles(std::mt19937& rng, uint32_t triangleCount)
+{
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+    TriangleSoup soup;
+    for (uint32_t i = 0; i < triangleCount; ++i)
+    {
+        float3 center(10.f * u(rng), 10.f * u(rng), 10.f * u(rng));
+        for (uint32_t j = 0; j < 3; ++j)
+        {
+            soup.indices.push_back((uint32_t)soup.positions.size());
+            soup.positions.push_back(center + float3(u(rng), u(rng), u(rng)));
+        }
+    }
+    return soup;
+}
+
+/// Brute-force closest hit over all triangles.
+TriangleBVH::Hit referenceClosestHit(const TriangleSoup& soup, const Ray& ray)
+{
+    TriangleBVH::Hit hit;
+    float tMax = ray.tMax;
+    for (uint32_t i = 0; i < (uint32_t)soup.indices.size() / 3; ++i)
+    {
+        const float3& v0 = soup.positions[soup.indices[3 * i]];
+        const float3& v1 = soup.positions[soup.indices[3 * i + 1]];
+        const float3& v2 = soup.positions[soup.indices[3 * i + 2]];
+        float t;
+        float2 barycentrics;
+        if (TriangleBVH::intersectTriangle(ray, v0, v1 - v0, v2 - v0, tMax, t, barycentrics))
+        {
+            tMax = t;
+            hit.t = t;
+            hit.barycentrics = barycentrics;
+            hit.triangleIndex = i;
+        }
+    }
+    return hit;
+}
+
+std::vector<Ray> createRandomRays(std::mt19937& rng, uint32_t rayCount)
+{
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+    std::vector<Ray> rays;
+    for (uint32_t i = 0; i < rayCount; ++i)
+    {
+        float3 origin(14.f * u(rng) - 2.f, 14.f * u(rng) - 2.f, 14.f * u(rng) - 2.f);
+        float3 dir = normalize(float3(u(rng) - 0.5f, u(rng) - 0.5f, u(rng) - 0.5f));
+        // Include axis-aligned rays and rays with a limited interval.
+        if (i % 16 == 0)
+            dir = float3(0.f, 0.f, 1.f);
+        rays.emplace_back(origin, dir, 0.f, i % 3 == 0 ? 3.f : std::numeric_limits<float>::max());
+    }
+    return rays;
+}
+} // namespace
+
+CPU_TEST(TriangleBVH_Empty)
+{
+    TriangleBVH bvh;
+    bvh.build({}, {});
+    EXPECT(bvh.empty());
+    EXPECT(!bvh.intersectClosest(Ray(float3(0.f), float3(0.f, 0.f, 1.f))).isValid());
+    EXPECT(!bvh.intersectAny(Ray(float3(0.f), float3(0.f, 0.f, 1.f))));
+}
+
+CPU_TEST(TriangleBVH_SingleTriangle)
+{
+    std::vector<float3> positions = {float3(0.f, 0.f, 1.f), float3(1.f, 0.f, 1.f), float3(0.f, 1.f, 1.f)};
+    std::vector<uint32_t> indices = {0, 1, 2};
+    TriangleBVH bvh;
+    bvh.build(positions, indices);
+    EXPECT_EQ(bvh.getTriangleCount(), 1);
+
+    auto hit = bvh.intersectClosest(Ray(float3(0.25f, 0.5f, 0.f), float3(0.f, 0.f, 1.f)));
+    EXPECT(hit.isValid());
+    EXPECT_EQ(hit.triangleIndex, 0);
+    EXPECT_EQ(hit.t, 1.f);
+    EXPECT_EQ(hit.barycentrics.x, 0.25f);
+    EXPECT_EQ(hit.barycentrics.y, 0.5f);
+
+    // Miss beside the triangle, and hit outside of the ray interval.
+    EXPECT(!bvh.intersectClosest(Ray(float3(0.75f, 0.75f, 0.f), float3(0.f, 0.f, 1.f))).isValid());
+    EXPECT(!bvh.intersectAny(Ray(float3(0.25f, 0.5f, 0.f), float3(0.f, 0.f, 1.f), 0.f, 0.5f)));
+}
+
+CPU_TEST(TriangleBVH_Randomized)
+{
+    std::mt19937 rng(1234);
+    for (uint32_t triangleCount : {7u, 100u, 5000u})
+    {
+        TriangleSoup soup = createRandomTriangles(rng, triangleCount);
+        TriangleBVH bvh;
+        bvh.build(soup.positions, soup.indices);
+        EXPECT_EQ(bvh.getTriangleCount(), triangleCount);
+        EXPECT_LE(bvh.getBVH().getStats().maxDepth, BVH4::kMaxDepth);
+
+        std::vector<Ray> rays = createRandomRays(rng, 2000);
+        std::vector<TriangleBVH::Hit> hits(rays.size());
+        std::vector<uint8_t> anyHits(rays.size());
+        bvh.intersectClosest(rays, hits);
+        bvh.intersectAny(rays, anyHits);
+
+        for (size_t i = 0; i < rays.size(); ++i)
+        {
+            TriangleBVH::Hit ref = referenceClosestHit(soup, rays[i]);
+            EXPECT_EQ(hits[i].isValid(), ref.isValid()) << "ray " << i;
+            EXPECT_EQ(anyHits[i] != 0, ref.isValid()) << "ray " << i;
+            if (ref.isValid() && hits[i].isValid())
+            {
+                EXPECT_EQ(hits[i].t, ref.t) << "ray " << i;
+                EXPECT_EQ(hits[i].triangleIndex, ref.triangleIndex) << "ray " << i;
+            }
+        }
+    }
+}
+
+CPU_TEST(TriangleBVH_ClosestPoint)
+{
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+    for (uint32_t triangleCount : {1u, 100u, 5000u})
+    {
+        TriangleSoup soup = createRandomTriangles(rng, triangleCount);
+        TriangleBVH bvh;
+        bvh.build(soup.positions, soup.indices);
+
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            float3 point(14.f * u(rng) - 2.f, 14.f * u(rng) - 2.f, 14.f * u(rng) - 2.f);
+
+            // Brute-force reference.
+            float refDistance = std::numeric_limits<float>::infinity();
+            for (uint32_t t = 0; t < triangleCount; ++t)
+            {
+                const float3& v0 = soup.positions[soup.indices[3 * t]];
+                float2 barycentrics;
+                float3 p = TriangleBVH::closestPointOnTriangle(
+                    point, v0, soup.positions[soup.indices[3 * t + 1]] - v0, soup.positions[soup.indices[3 * t + 2]] - v0, barycentrics
+                );
+                refDistance = std::min(refDistance, length(p - point));
+            }
+
+            auto closest = bvh.findClosestPoint(point);
+            EXPECT(closest.isValid()) << "point " << i;
+            EXPECT_EQ(closest.distance, refDistance) << "point " << i;
+            EXPECT_LE(std::abs(length(closest.point - point) - closest.distance), 1e-5f) << "point " << i;
+
+            // A search radius below the closest distance finds nothing.
+            EXPECT(!bvh.findClosestPoint(point, 0.99f * refDistance).isValid()) << "point " << i;
+        }
+    }
+
+    // Barycentrics identify the closest feature.
+    float2 barycentrics;
+    const float3 v0(0.f), e1(1.f, 0.f, 0.f), e2(0.f, 1.f, 0.f);
+    EXPECT(all(TriangleBVH::closestPointOnTriangle(float3(-1.f, -1.f, 1.f), v0, e1, e2, barycentrics) == v0));
+    EXPECT(all(barycentrics == float2(0.f, 0.f)));
+    EXPECT(all(TriangleBVH::closestPointOnTriangle(float3(0.5f, -1.f, 0.f), v0, e1, e2, barycentrics) == float3(0.5f, 0.f, 0.f)));
+    EXPECT(all(barycentrics == float2(0.5f, 0.f)));
+    EXPECT(all(TriangleBVH::closestPointOnTriangle(float3(0.25f, 0.25f, 2.f), v0, e1, e2, barycentrics) == float3(0.25f, 0.25f, 0.f)));
+    EXPECT(all(barycentrics == float2(0.25f, 0.25f)));
+
+    // Degenerate triangles fall back to the closest edge.
+    EXPECT(all(TriangleBVH::closestPointOnTriangle(float3(2.f, 1.f, 0.f), v0, e1, e1, barycentrics) == float3(1.f, 0.f, 0.f)));
+}
+
+} // namespace Falcor
@@ -25,10 +25,15 @@
  # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Utils/Threading.h"
+
 #include <FreeImage.h>
 #include <args.hxx>
+#include <nlohmann/json.hpp>
 
 #include <iostream>
+#include <fstream>
 #include <memory>
 #include <string>
 #include <vector>
@@ -36,10 +41,23 @@
 #include <map>
 #include <functional>
 #include <filesystem>
+#include <algorithm>
+#include <atomic>
+#include <limits>
 
 #include <cmath>
 #include <cstring>
 
+#if defined(_M_X64) || defined(__x86_64__)
+#define IMAGE_COMPARE_SSE2 1
+#include <emmintrin.h>
+#else
+#define IMAGE_COMPARE_SSE2 0
+#endif
+
+/// Number of pixels per tile. Tiles are the unit of parallel work and of the early-out check.
+static const size_t kTileSize = 16384;
+
 template<typename T>
 T sqr(T x)
 {
@@ -76,17 +94,26 @@ public:
 
         auto pathStr = path.string();
 
+        // Read the file through a memory mapping if possible, which avoids copying it through the FreeImage IO callbacks.
+        Falcor::MemoryMappedFile file(path, Falcor::MemoryMappedFile::kWholeFile, Falcor::MemoryMappedFile::AccessHint::SequentialScan);
+        FIMEMORY* memory = file.isOpen() && file.getSize() > 0 ? FreeImage_OpenMemory((BYTE*)file.getData(), (DWORD)file.getSize()) : nullptr;
+
         // Determine file format.
-        fifFormat = FreeImage_GetFileType(pathStr.c_str(), 0);
+        fifFormat = memory ? FreeImage_GetFileTypeFromMemory(memory, 0) : FreeImage_GetFileType(pathStr.c_str(), 0);
         if (fifFormat == FIF_UNKNOWN)
             fifFormat = FreeImage_GetFIFFromFilename(pathStr.c_str());
-        if (fifFormat == FIF_UNKNOWN)
-            throw std::runtime_error("Unknown image format");
-        if (!FreeImage_FIFSupportsReading(fifFormat))
-            throw std::runtime_error("Unsupported image format");
+        if (fifFormat == FIF_UNKNOWN || !FreeImage_FIFSupportsReading(fifFormat))
+        {
+            if (memory)
+                FreeImage_CloseMemory(memory);
+            throw std::runtime_error(fifFormat == FIF_UNKNOWN ? "Unknown image format" : "Unsupported image format");
+        }
 
         // Read image.
-        FIBITMAP* srcBitmap = FreeImage_Load(fifFormat, pathStr.c_str());
+        FIBITMAP* srcBitmap = memory ? FreeImage_LoadFromMemory(fifFormat, memory) : FreeImage_Load(fifFormat, pathStr.c_str());
+        if (memory)
+            FreeImage_CloseMemory(memory);
+        file.close();
         if (!srcBitmap)
             throw std::runtime_error("Cannot read image");
 
@@ -188,75 +215,169 @@ private:
     std::unique_ptr<float[]> mData;
 };
 
+// Error metrics. Each metric defines the per channel error, the per pixel error is the mean over the channels times kScale.
+// The SSE2 variants must compute the same values as the scalar variants.
+
 struct MSE
 {
-    double operator()(const float* a, const float* b, size_t count) const
+    static constexpr float kScale = 1.f;
+    static float error(float a, float b) { return sqr(a - b); }
+#if IMAGE_COMPARE_SSE2
+    static __m128 error(__m128 a, __m128 b)
     {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i)
-            error += sqr(a[i] - b[i]);
-        return error / count;
+        __m128 d = _mm_sub_ps(a, b);
+        return _mm_mul_ps(d, d);
     }
+#endif
 };
 
 struct RMSE
 {
-    double operator()(const float* a, const float* b, size_t count) const
+    static constexpr float kScale = 1.f;
+    static float error(float a, float b) { return sqr(a - b) / (sqr(a) + 1e-3f); }
+#if IMAGE_COMPARE_SSE2
+    static __m128 error(__m128 a, __m128 b)
     {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i)
-            error += sqr(a[i] - b[i]) / (sqr(a[i]) + 1e-3);
-        return error / count;
+        __m128 d = _mm_sub_ps(a, b);
+        return _mm_div_ps(_mm_mul_ps(d, d), _mm_add_ps(_mm_mul_ps(a, a), _mm_set1_ps(1e-3f)));
     }
+#endif
 };
 
 struct MAE
 {
-    double operator()(const float* a, const float* b, size_t count) const
+    static constexpr float kScale = 1.f;
+    static float error(float a, float b) { return std::fabs(sqr(a - b)); }
+#if IMAGE_COMPARE_SSE2
+    static __m128 error(__m128 a, __m128 b)
     {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i)
-            error += std::fabs(sqr(a[i] - b[i]));
-        return error / count;
+        __m128 d = _mm_sub_ps(a, b);
+        return _mm_andnot_ps(_mm_set1_ps(-0.f), _mm_mul_ps(d, d));
     }
+#endif
 };
 
 struct MAPE
 {
-    double operator()(const float* a, const float* b, size_t count) const
+    static constexpr float kScale = 100.f;
+    static float error(float a, float b) { return std::fabs((a - b) / (a + 1e-3f)); }
+#if IMAGE_COMPARE_SSE2
+    static __m128 error(__m128 a, __m128 b)
     {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i)
-            error += std::fabs((a[i] - b[i]) / (a[i] + 1e-3));
-        return 100.0 * error / count;
+        return _mm_andnot_ps(_mm_set1_ps(-0.f), _mm_div_ps(_mm_sub_ps(a, b), _mm_add_ps(a, _mm_set1_ps(1e-3f))));
     }
+#endif
 };
 
+/// Sum of the per pixel errors of a range of RGBA pixels. Optionally writes the per pixel errors to errorMap.
 template<typename Metric>
-double compare(const Image& imageA, const Image& imageB, bool alpha, float* errorMap)
+double compareTile(const float* a, const float* b, size_t count, bool alpha, float* errorMap)
 {
-    Metric metric;
+    const float scale = Metric::kScale / (alpha ? 4.f : 3.f);
     double sum = 0.0;
-    const float* a = imageA.getData();
-    const float* b = imageB.getData();
-    size_t count = imageA.getWidth() * imageA.getHeight();
-    for (size_t i = 0; i < count; ++i)
+    size_t i = 0;
+
+#if IMAGE_COMPARE_SSE2
+    // Process 4 pixels at a time. The per channel errors are transposed so that the channels of each pixel can be summed vertically.
+    const __m128 channelMask = _mm_castsi128_ps(_mm_set_epi32(alpha ? -1 : 0, -1, -1, -1));
+    const __m128 scaleVec = _mm_set1_ps(scale);
+    __m128d sumVec = _mm_setzero_pd();
+    for (; i + 4 <= count; i += 4)
     {
-        double error = metric(a, b, alpha ? 4 : 3);
+        const float* pa = a + 4 * i;
+        const float* pb = b + 4 * i;
+        __m128 e0 = _mm_and_ps(Metric::error(_mm_loadu_ps(pa + 0), _mm_loadu_ps(pb + 0)), channelMask);
+        __m128 e1 = _mm_and_ps(Metric::error(_mm_loadu_ps(pa + 4), _mm_loadu_ps(pb + 4)), channelMask);
+        __m128 e2 = _mm_and_ps(Metric::error(_mm_loadu_ps(pa + 8), _mm_loadu_ps(pb + 8)), channelMask);
+        __m128 e3 = _mm_and_ps(Metric::error(_mm_loadu_ps(pa + 12), _mm_loadu_ps(pb + 12)), channelMask);
+        _MM_TRANSPOSE4_PS(e0, e1, e2, e3);
+        __m128 e = _mm_mul_ps(_mm_add_ps(_mm_add_ps(e0, e1), _mm_add_ps(e2, e3)), scaleVec);
         if (errorMap)
-            *errorMap++ = float(error);
-        sum += error;
-        a += 4;
-        b += 4;
+            _mm_storeu_ps(errorMap + i, e);
+        sumVec = _mm_add_pd(sumVec, _mm_add_pd(_mm_cvtps_pd(e), _mm_cvtps_pd(_mm_movehl_ps(e, e))));
     }
-    return sum / count;
+    double partialSums[2];
+    _mm_storeu_pd(partialSums, sumVec);
+    sum = partialSums[0] + partialSums[1];
+#endif
+
+    for (; i < count; ++i)
+    {
+        const float* pa = a + 4 * i;
+        const float* pb = b + 4 * i;
+        float alphaError = alpha ? Metric::error(pa[3], pb[3]) : 0.f;
+        float e = ((Metric::error(pa[0], pb[0]) + Metric::error(pa[1], pb[1])) + (Metric::error(pa[2], pb[2]) + alphaError)) * scale;
+        if (errorMap)
+            errorMap[i] = e;
+        sum += e;
+    }
+
+    return sum;
+}
+
+struct CompareResult
+{
+    double error = 0.0;
+    bool earlyOut = false; ///< True if the comparison stopped as soon as the error exceeded maxError. The error is a lower bound in that case.
+};
+
+/**
+ * Compare two images tile by tile in parallel.
+ * All metrics are non-negative, so the comparison stops once the partial error exceeds maxError.
+ * Tile sums are added in a fixed order, so the result does not depend on the number of threads.
+ */
+template<typename Metric>
+CompareResult compare(const Image& imageA, const Image& imageB, bool alpha, float* errorMap, double maxError)
+{
+    const size_t count = size_t(imageA.getWidth()) * imageA.getHeight();
+    const size_t tileCount = (count + kTileSize - 1) / kTileSize;
+    const bool allowEarlyOut = !errorMap && maxError < std::numeric_limits<double>::infinity();
+    const double maxSum = maxError * count;
+
+    std::vector<double> tileSums(tileCount, 0.0);
+    std::atomic<double> runningSum{0.0};
+    std::atomic<bool> exceeded{false};
+
+    Falcor::Threading::parallelFor(
+        0,
+        tileCount,
+        [&](size_t tile)
+        {
+            if (allowEarlyOut && exceeded.load(std::memory_order_relaxed))
+                return;
+
+            const size_t begin = tile * kTileSize;
+            const size_t tileSize = std::min(kTileSize, count - begin);
+            tileSums[tile] = compareTile<Metric>(
+                imageA.getData() + 4 * begin, imageB.getData() + 4 * begin, tileSize, alpha, errorMap ? errorMap + begin : nullptr
+            );
+
+            if (allowEarlyOut)
+            {
+                double sum = runningSum.load(std::memory_order_relaxed);
+                while (!runningSum.compare_exchange_weak(sum, sum + tileSums[tile], std::memory_order_relaxed))
+                    ;
+                if (sum + tileSums[tile] > maxSum)
+                    exceeded.store(true, std::memory_order_relaxed);
+            }
+        },
+        1
+    );
+
+    CompareResult result;
+    double sum = 0.0;
+    for (double tileSum : tileSums)
+        sum += tileSum;
+    result.error = count > 0 ? sum / count : 0.0;
+    result.earlyOut = exceeded.load();
+    return result;
 }
 
 struct ErrorMetric
 {
     std::string name;
     std::string desc;
-    std::function<double(const Image& imageA, const Image& imageB, bool alpha, float* errorMap)> compare;
+    std::function<CompareResult(const Image& imageA, const Image& imageB, bool alpha, float* errorMap, double maxError)> compare;
 };
 
 static const std::vector<ErrorMetric> errorMetrics = {
@@ -284,30 +405,68 @@ static std::shared_ptr<Image> generateHeatMap(uint32_t width, uint32_t height, c
         *dst++ = 1.f;
     };
 
-    const auto [minValue, maxValue] = std::minmax_element(errorMap, errorMap + width * height);
-    const float range = std::max(1e-5f, *maxValue - *minValue);
+    const size_t count = size_t(width) * height;
+    const size_t tileCount = (count + kTileSize - 1) / kTileSize;
+    if (count == 0)
+        return Image::create(width, height);
+
+    const auto [minValue, maxValue] = Falcor::Threading::parallelReduce(
+        0,
+        tileCount,
+        std::pair<float, float>(errorMap[0], errorMap[0]),
+        [&](size_t tile)
+        {
+            const float* begin = errorMap + tile * kTileSize;
+            const auto [tileMin, tileMax] = std::minmax_element(begin, begin + std::min(kTileSize, count - tile * kTileSize));
+            return std::pair<float, float>(*tileMin, *tileMax);
+        },
+        [](std::pair<float, float> a, std::pair<float, float> b)
+        { return std::pair<float, float>(std::min(a.first, b.first), std::max(a.second, b.second)); },
+        1
+    );
+    const float range = std::max(1e-5f, maxValue - minValue);
+
     auto image = Image::create(width, height);
     float* dst = image->getData();
-    for (size_t i = 0; i < width * height; ++i)
-    {
-        float t = clamp((errorMap[i] - *minValue) / range, 0.f, 1.f);
-        writeColor(t, dst);
-        dst += 4;
-    }
+    Falcor::Threading::parallelFor(
+        0,
+        tileCount,
+        [&](size_t tile)
+        {
+            const size_t end = std::min(count, (tile + 1) * kTileSize);
+            for (size_t i = tile * kTileSize; i < end; ++i)
+            {
+                float t = clamp((errorMap[i] - minValue) / range, 0.f, 1.f);
+                writeColor(t, dst + 4 * i);
+            }
+        },
+        1
+    );
 
     return image;
 }
 
-static bool compareImages(
-    const std::filesystem::path& pathA,
-    const std::filesystem::path& pathB,
-    ErrorMetric metric,
-    float threshold,
-    bool alpha,
-    const std::filesystem::path& heatMapPath
-)
+struct ComparePair
+{
+    std::filesystem::path pathA;
+    std::filesystem::path pathB;
+    std::filesystem::path heatMapPath;
+    float threshold = 0.f;
+};
+
+struct ComparePairResult
 {
-    auto loadImage = [](const std::filesystem::path& path)
+    bool success = false;
+    bool compared = false;    ///< False if the images could not be compared, see message.
+    CompareResult result;
+    std::string message;
+};
+
+static ComparePairResult compareImages(const ComparePair& pair, const ErrorMetric& metric, bool alpha, bool earlyOut)
+{
+    ComparePairResult pairResult;
+
+    auto loadImage = [&pairResult](const std::filesystem::path& path)
     {
         try
         {
@@ -315,12 +474,12 @@ static bool compareImages(
         }
         catch (const std::runtime_error& e)
         {
-            std::cerr << "Cannot load image from '" << path.string() << "' (Error: " << e.what() << ")." << std::endl;
+            pairResult.message = "Cannot load image from '" + path.string() + "' (Error: " + e.what() + ").";
             return std::shared_ptr<Image>{};
         }
     };
 
-    auto saveImage = [](const Image& image, const std::filesystem::path& path)
+    auto saveImage = [&pairResult](const Image& image, const std::filesystem::path& path)
     {
         try
         {
@@ -328,46 +487,136 @@ static bool compareImages(
         }
         catch (const std::runtime_error& e)
         {
-            std::cerr << "Cannot save image to '" << path.string() << "' (Error: " << e.what() << ")." << std::endl;
+            pairResult.message = "Cannot save image to '" + path.string() + "' (Error: " + e.what() + ").";
         }
     };
 
     // Load images.
-    auto imageA = loadImage(pathA);
+    auto imageA = loadImage(pair.pathA);
     if (!imageA)
-        return false;
-    auto imageB = loadImage(pathB);
+        return pairResult;
+    auto imageB = loadImage(pair.pathB);
     if (!imageB)
-        return false;
+        return pairResult;
 
     // Check resolution.
     if (imageA->getWidth() != imageB->getWidth() || imageA->getHeight() != imageB->getHeight())
     {
-        std::cerr << "Cannot compare images with different resolutions." << std::endl;
-        return false;
+        pairResult.message = "Cannot compare images with different resolutions.";
+        return pairResult;
     }
 
     uint32_t width = imageA->getWidth();
     uint32_t height = imageB->getHeight();
 
     // Compare images.
-    std::unique_ptr<float[]> errorMap = heatMapPath.empty() ? nullptr : std::make_unique<float[]>(width * height);
-    double error = metric.compare(*imageA, *imageB, alpha, errorMap.get());
+    std::unique_ptr<float[]> errorMap = pair.heatMapPath.empty() ? nullptr : std::make_unique<float[]>(size_t(width) * height);
+    double maxError = earlyOut ? pair.threshold : std::numeric_limits<double>::infinity();
+    pairResult.result = metric.compare(*imageA, *imageB, alpha, errorMap.get(), maxError);
+    pairResult.compared = true;
 
     // Generate heat map.
     if (errorMap)
     {
         auto heatMap = generateHeatMap(width, height, errorMap.get());
-        saveImage(*heatMap, heatMapPath);
+        saveImage(*heatMap, pair.heatMapPath);
     }
 
-    std::cout << error << std::endl;
-
     // Treat nans and infs as errors.
-    if (std::isnan(error) || std::isinf(error))
-        return false;
+    double error = pairResult.result.error;
+    pairResult.success = !std::isnan(error) && !std::isinf(error) && !pairResult.result.earlyOut && error <= pair.threshold;
+    return pairResult;
+}
+
+/**
+ * Read a batch manifest. The manifest is a JSON array of objects with the keys "image1", "image2" and optionally
+ * "heatmap" and "threshold". Relative paths are relative to the manifest.
+ */
+static std::vector<ComparePair> readManifest(const std::filesystem::path& path, float defaultThreshold)
+{
+    std::ifstream stream(path);
+    if (!stream)
+        throw std::runtime_error("Cannot open manifest '" + path.string() + "'");
+
+    nlohmann::json manifest = nlohmann::json::parse(stream);
+    if (!manifest.is_array())
+        throw std::runtime_error("Manifest must contain an array of image pairs");
+
+    const std::filesystem::path baseDir = path.parent_path();
+    auto resolve = [&baseDir](const std::string& str)
+    {
+        std::filesystem::path p(str);
+        return p.is_absolute() ? p : baseDir / p;
+    };
 
-    return error <= threshold;
+    std::vector<ComparePair> pairs;
+    pairs.reserve(manifest.size());
+    for (const auto& entry : manifest)
+    {
+        ComparePair pair;
+        pair.pathA = resolve(entry.at("image1").get<std::string>());
+        pair.pathB = resolve(entry.at("image2").get<std::string>());
+        if (entry.contains("heatmap"))
+            pair.heatMapPath = resolve(entry["heatmap"].get<std::string>());
+        pair.threshold = entry.value("threshold", defaultThreshold);
+        pairs.push_back(std::move(pair));
+    }
+    return pairs;
+}
+
+static bool compareBatch(
+    const std::vector<ComparePair>& pairs,
+    const ErrorMetric& metric,
+    bool alpha,
+    bool earlyOut,
+    const std::filesystem::path& summaryPath
+)
+{
+    // Pairs are compared in parallel, and so are the tiles of each pair.
+    std::vector<ComparePairResult> results(pairs.size());
+    Falcor::Threading::parallelFor(0, pairs.size(), [&](size_t i) { results[i] = compareImages(pairs[i], metric, alpha, earlyOut); }, 1);
+
+    nlohmann::json summary;
+    summary["metric"] = metric.name;
+    summary["count"] = pairs.size();
+    size_t passed = 0;
+    nlohmann::json jsonResults = nlohmann::json::array();
+    for (size_t i = 0; i < pairs.size(); ++i)
+    {
+        const ComparePairResult& r = results[i];
+        passed += r.success ? 1 : 0;
+
+        nlohmann::json jsonResult;
+        jsonResult["image1"] = pairs[i].pathA.string();
+        jsonResult["image2"] = pairs[i].pathB.string();
+        jsonResult["threshold"] = pairs[i].threshold;
+        jsonResult["success"] = r.success;
+        // NaN and inf are written as null.
+        jsonResult["error"] = r.compared ? nlohmann::json(r.result.error) : nlohmann::json(nullptr);
+        jsonResult["earlyOut"] = r.result.earlyOut;
+        if (!r.message.empty())
+            jsonResult["message"] = r.message;
+        else if (r.compared && !std::isfinite(r.result.error))
+            jsonResult["message"] = "Error is not finite.";
+        jsonResults.push_back(std::move(jsonResult));
+    }
+    summary["passed"] = passed;
+    summary["failed"] = pairs.size() - passed;
+    summary["results"] = std::move(jsonResults);
+
+    if (summaryPath.empty())
+    {
+        std::cout << summary.dump(4) << std::endl;
+    }
+    else
+    {
+        std::ofstream stream(summaryPath);
+        if (!stream)
+            throw std::runtime_error("Cannot write summary to '" + summaryPath.string() + "'");
+        stream << summary.dump(4) << std::endl;
+    }
+
+    return passed == pairs.size();
 }
 
 static void printMetrics(std::ostream& stream = std::cout)
@@ -386,11 +635,15 @@ int main(int argc, char** argv)
     args::HelpFlag helpFlag(parser, "help", "Display this help menu.", {'h', "help"});
     args::Flag listMetricsFlag(parser, "", "List available error metrics.", {'l'});
     args::ValueFlag<std::string> metricFlag(parser, "metric", "The error metric.", {'m'});
-    args::ValueFlag<float> thresholdFlag(parser, "threshold", "The error threshold.", {'t'});
+    args::ValueFlag<float> thresholdFlag(parser, "threshold", "The error threshold (default threshold in batch mode).", {'t'});
     args::Flag alphaFlag(parser, "", "Include alpha channel.", {'a'});
     args::ValueFlag<std::string> heatMapFlag(parser, "filename", "Generate error heat map.", {'e'});
-    args::Positional<std::string> image1(parser, "image1", "The first image.", args::Options::Required);
-    args::Positional<std::string> image2(parser, "image2", "The second image.", args::Options::Required);
+    args::ValueFlag<std::string> batchFlag(parser, "manifest", "Compare all image pairs listed in a JSON manifest.", {"batch"});
+    args::ValueFlag<std::string> outputFlag(parser, "filename", "Write the JSON summary of batch mode to a file instead of stdout.", {'o', "output"});
+    args::Flag earlyOutFlag(parser, "", "Stop comparing as soon as the error exceeds the threshold (the reported error is a lower bound).", {"early-out"});
+    args::ValueFlag<uint32_t> threadsFlag(parser, "count", "Number of threads, at most the number of logical cores (default: FALCOR_THREAD_COUNT or the number of logical cores).", {'j', "threads"});
+    args::Positional<std::string> image1(parser, "image1", "The first image.");
+    args::Positional<std::string> image2(parser, "image2", "The second image.");
     args::CompletionFlag completionFlag(parser, {"complete"});
 
     try
@@ -426,6 +679,13 @@ int main(int argc, char** argv)
         return 0;
     }
 
+    if (!batchFlag && (!image1 || !image2))
+    {
+        std::cerr << "Two images or a batch manifest are required." << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
     ErrorMetric metric = errorMetrics.front();
     if (metricFlag)
     {
@@ -441,13 +701,40 @@ int main(int argc, char** argv)
         metric = *it;
     }
 
-    bool success = compareImages(
-        args::get(image1),
-        args::get(image2),
-        metric,
-        thresholdFlag ? args::get(thresholdFlag) : 0.f,
-        alphaFlag ? args::get(alphaFlag) : false,
-        heatMapFlag ? args::get(heatMapFlag) : ""
-    );
+    float threshold = thresholdFlag ? args::get(thresholdFlag) : 0.f;
+    bool alpha = alphaFlag ? args::get(alphaFlag) : false;
+    bool earlyOut = earlyOutFlag ? args::get(earlyOutFlag) : false;
+
+    // The image test runner starts several instances concurrently and splits the cores between them with -j.
+    uint32_t threadCount = threadsFlag ? args::get(threadsFlag) : 0;
+    if (threadCount > 0)
+        threadCount = std::min(threadCount, std::max(1u, Falcor::Threading::getLogicalThreadCount()));
+    Falcor::Threading::start(threadCount);
+
+    bool success = false;
+    if (batchFlag)
+    {
+        try
+        {
+            auto pairs = readManifest(args::get(batchFlag), threshold);
+            success = compareBatch(pairs, metric, alpha, earlyOut, outputFlag ? args::get(outputFlag) : "");
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+    else
+    {
+        ComparePair pair{args::get(image1), args::get(image2), heatMapFlag ? args::get(heatMapFlag) : "", threshold};
+        ComparePairResult result = compareImages(pair, metric, alpha, earlyOut);
+        if (!result.message.empty())
+            std::cerr << result.message << std::endl;
+        if (result.compared)
+            std::cout << result.result.error << std::endl;
+        success = result.success;
+    }
+
+    Falcor::Threading::shutdown();
     return success ? 0 : 1;
 }
@@ -33,128 +33,259 @@
 
 #include "LoopSubdivide.h"
 #include "Core/Error.h"
+#include "Utils/Threading.h"
 
-#include <algorithm>
-#include <map>
-#include <memory>
-#include <memory_resource>
-#include <set>
+#include <limits>
+#include <vector>
 
 #include <cmath>
 
 namespace Falcor::pbrt
 {
 
-struct SDFace;
-struct SDVertex;
-
+namespace
+{
 #define NEXT(i) (((i) + 1) % 3)
 #define PREV(i) (((i) + 2) % 3)
 
-struct SDVertex
+constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+/**
+ * Index based subdivision mesh.
+ * This is a flat version of the pbrt SDVertex/SDFace representation. Faces and vertices are referenced by index
+ * and all data of one subdivision level is stored in a few arrays.
+ */
+struct SubdivMesh
 {
-    SDVertex(const float3& p = float3(0.f)) : p(p) {}
+    // Vertex data.
+    std::vector<float3> positions;
+    std::vector<uint32_t> startFaces; ///< One of the faces adjacent to the vertex.
+    std::vector<uint8_t> boundary;    ///< True if the vertex is on the boundary.
+    std::vector<uint8_t> regular;     ///< True if the vertex is regular (valence 6 interior or valence 4 boundary vertex).
 
-    int valence();
-    void oneRing(float3* p);
+    // Face data.
+    std::vector<uint32_t> faceVertices;  ///< Three vertex indices per face.
+    std::vector<uint32_t> faceNeighbors; ///< Three neighbor face indices per face. Neighbor k is adjacent to edge (k, NEXT(k)).
 
-    float3 p;
-    SDFace* startFace = nullptr;
-    SDVertex* child = nullptr;
-    bool regular = false;
-    bool boundary = false;
-};
+    uint32_t getVertexCount() const { return (uint32_t)positions.size(); }
+    uint32_t getFaceCount() const { return (uint32_t)(faceVertices.size() / 3); }
 
-struct SDFace
-{
-    SDFace()
+    void resize(uint32_t vertexCount, uint32_t faceCount)
+    {
+        positions.resize(vertexCount);
+        startFaces.resize(vertexCount);
+        boundary.resize(vertexCount);
+        regular.resize(vertexCount);
+        faceVertices.resize(3 * (size_t)faceCount);
+        faceNeighbors.resize(3 * (size_t)faceCount);
+    }
+
+    uint32_t vnum(uint32_t face, uint32_t vertex) const
     {
         for (uint32_t i = 0; i < 3; ++i)
         {
-            v[i] = nullptr;
-            f[i] = nullptr;
+            if (faceVertices[3 * face + i] == vertex)
+                return i;
         }
-        for (uint32_t i = 0; i < 4; ++i)
+        FALCOR_THROW("Basic logic error in SubdivMesh::vnum().");
+    }
+
+    uint32_t nextFace(uint32_t face, uint32_t vertex) const { return faceNeighbors[3 * face + vnum(face, vertex)]; }
+    uint32_t prevFace(uint32_t face, uint32_t vertex) const { return faceNeighbors[3 * face + PREV(vnum(face, vertex))]; }
+    uint32_t nextVert(uint32_t face, uint32_t vertex) const { return faceVertices[3 * face + NEXT(vnum(face, vertex))]; }
+    uint32_t prevVert(uint32_t face, uint32_t vertex) const { return faceVertices[3 * face + PREV(vnum(face, vertex))]; }
+    uint32_t otherVert(uint32_t face, uint32_t v0, uint32_t v1) const
+    {
+        for (uint32_t i = 0; i < 3; ++i)
         {
-            children[i] = nullptr;
+            uint32_t v = faceVertices[3 * face + i];
+            if (v != v0 && v != v1)
+                return v;
         }
+        FALCOR_THROW("Basic logic error in SubdivMesh::otherVert()");
     }
 
-    uint32_t vnum(SDVertex* vert) const
+    uint32_t valence(uint32_t vertex) const
     {
-        for (int i = 0; i < 3; ++i)
+        uint32_t startFace = startFaces[vertex];
+        if (startFace == kInvalidIndex)
+            return 0;
+
+        uint32_t f = startFace;
+        if (!boundary[vertex])
         {
-            if (v[i] == vert)
-                return i;
+            // Compute valence of interior vertex.
+            uint32_t nf = 1;
+            while ((f = nextFace(f, vertex)) != startFace)
+                ++nf;
+            return nf;
+        }
+        else
+        {
+            // Compute valence of boundary vertex.
+            uint32_t nf = 1;
+            while ((f = nextFace(f, vertex)) != kInvalidIndex)
+                ++nf;
+            f = startFace;
+            while ((f = prevFace(f, vertex)) != kInvalidIndex)
+                ++nf;
+            return nf + 1;
         }
-        FALCOR_THROW("Basic logic error in SDFace::vnum().");
     }
 
-    SDFace* nextFace(SDVertex* vert) const { return f[vnum(vert)]; }
-    SDFace* prevFace(SDVertex* vert) const { return f[PREV(vnum(vert))]; }
-    SDVertex* nextVert(SDVertex* vert) const { return v[NEXT(vnum(vert))]; }
-    SDVertex* prevVert(SDVertex* vert) const { return v[PREV(vnum(vert))]; }
-    SDVertex* otherVert(SDVertex* v0, SDVertex* v1)
+    void oneRing(uint32_t vertex, float3* p) const
     {
-        for (uint32_t i = 0; i < 3; ++i)
+        uint32_t startFace = startFaces[vertex];
+        if (!boundary[vertex])
+        {
+            // Get one-ring vertices for interior vertex.
+            uint32_t face = startFace;
+            do
+            {
+                *p++ = positions[nextVert(face, vertex)];
+                face = nextFace(face, vertex);
+            } while (face != startFace);
+        }
+        else
         {
-            if (v[i] != v0 && v[i] != v1)
-                return v[i];
+            // Get one-ring vertices for boundary vertex.
+            uint32_t face = startFace;
+            uint32_t f2;
+            while ((f2 = nextFace(face, vertex)) != kInvalidIndex)
+                face = f2;
+            *p++ = positions[nextVert(face, vertex)];
+            do
+            {
+                *p++ = positions[prevVert(face, vertex)];
+                face = prevFace(face, vertex);
+            } while (face != kInvalidIndex);
         }
-        FALCOR_THROW("Basic logic error in SDFace::otherVert()");
     }
 
-    SDVertex* v[3];
-    SDFace* f[3];
-    SDFace* children[4];
-};
-
-struct SDEdge
-{
-    SDEdge(SDVertex* v0 = nullptr, SDVertex* v1 = nullptr)
+    /**
+     * Call func(valence, ring) with the one-ring positions of a vertex.
+     * Small rings are gathered on the stack.
+     */
+    template<typename Func>
+    auto withOneRing(uint32_t vertex, Func func) const
     {
-        v[0] = std::min(v0, v1);
-        v[1] = std::max(v0, v1);
-        f[0] = f[1] = nullptr;
-        f0edgeNum = -1;
+        uint32_t valence = this->valence(vertex);
+        if (valence == 0)
+            return func(0u, static_cast<const float3*>(nullptr));
+
+        float3 stackRing[32];
+        std::vector<float3> heapRing;
+        float3* ring = stackRing;
+        if (valence > 32)
+        {
+            heapRing.resize(valence);
+            ring = heapRing.data();
+        }
+        oneRing(vertex, ring);
+        return func(valence, static_cast<const float3*>(ring));
     }
 
-    bool operator<(const SDEdge& e2) const
+    float3 weightOneRing(uint32_t vertex, float beta) const
     {
-        if (v[0] == e2.v[0])
-            return v[1] < e2.v[1];
-        return v[0] < e2.v[0];
+        return withOneRing(
+            vertex,
+            [&](uint32_t valence, const float3* ring)
+            {
+                float3 p = (1 - valence * beta) * positions[vertex];
+                for (uint32_t i = 0; i < valence; ++i)
+                    p += beta * ring[i];
+                return p;
+            }
+        );
     }
 
-    SDVertex* v[2];
-    SDFace* f[2];
-    int f0edgeNum;
+    float3 weightBoundary(uint32_t vertex, float beta) const
+    {
+        return withOneRing(
+            vertex,
+            [&](uint32_t valence, const float3* ring)
+            {
+                if (valence == 0)
+                    return positions[vertex];
+                float3 p = (1 - 2 * beta) * positions[vertex];
+                p += beta * ring[0];
+                p += beta * ring[valence - 1];
+                return p;
+            }
+        );
+    }
 };
 
-static float3 weightOneRing(SDVertex* vert, float beta);
-static float3 weightBoundary(SDVertex* vert, float beta);
+/**
+ * Edges of a subdivision mesh.
+ * Edges are identified by their (unordered) vertex pair, as in pbrt, and are numbered in the order in which they are
+ * first encountered when iterating over the face edges.
+ */
+struct EdgeTable
+{
+    std::vector<uint32_t> faceEdgeToEdge; ///< Edge index per face edge (3 per face).
+    std::vector<uint32_t> edgeToFaceEdge; ///< First face edge per edge.
+};
 
-inline int SDVertex::valence()
+void buildEdgeTable(const SubdivMesh& mesh, EdgeTable& edges)
 {
-    SDFace* f = startFace;
-    if (!boundary)
+    const uint32_t vertexCount = mesh.getVertexCount();
+    const size_t faceEdgeCount = mesh.faceVertices.size();
+    const auto& fv = mesh.faceVertices;
+
+    auto getEdgeVertices = [&fv](size_t faceEdge)
+    {
+        uint32_t v0 = fv[faceEdge];
+        uint32_t v1 = fv[faceEdge - faceEdge % 3 + NEXT(faceEdge % 3)];
+        return std::make_pair(std::min(v0, v1), std::max(v0, v1));
+    };
+
+    // Bucket the face edges by their smaller vertex index (stable counting sort).
+    std::vector<uint32_t> bucketOffsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < faceEdgeCount; ++i)
+        bucketOffsets[getEdgeVertices(i).first + 1]++;
+    for (uint32_t i = 0; i < vertexCount; ++i)
+        bucketOffsets[i + 1] += bucketOffsets[i];
+    std::vector<uint32_t> buckets(faceEdgeCount);
     {
-        // Compute valence of interior vertex.
-        int nf = 1;
-        while ((f = f->nextFace(this)) != startFace)
-            ++nf;
-        return nf;
+        std::vector<uint32_t> cursors(bucketOffsets.begin(), bucketOffsets.end() - 1);
+        for (size_t i = 0; i < faceEdgeCount; ++i)
+            buckets[cursors[getEdgeVertices(i).first]++] = (uint32_t)i;
     }
-    else
+
+    // Find the first face edge with the same vertex pair. Buckets are small (vertex valence), so a linear search is fine.
+    std::vector<uint32_t> firstFaceEdge(faceEdgeCount);
+    Threading::parallelFor(
+        0,
+        vertexCount,
+        [&](size_t v)
+        {
+            for (uint32_t i = bucketOffsets[v]; i < bucketOffsets[v + 1]; ++i)
+            {
+                uint32_t other = getEdgeVertices(buckets[i]).second;
+                uint32_t j = bucketOffsets[v];
+                while (getEdgeVertices(buckets[j]).second != other)
+                    ++j;
+                firstFaceEdge[buckets[i]] = buckets[j];
+            }
+        },
+        1024
+    );
+
+    // Number the edges in order of first occurrence.
+    edges.faceEdgeToEdge.resize(faceEdgeCount);
+    edges.edgeToFaceEdge.clear();
+    for (size_t i = 0; i < faceEdgeCount; ++i)
     {
-        // Compute valence of boundary vertex
-        int nf = 1;
-        while ((f = f->nextFace(this)) != nullptr)
-            ++nf;
-        f = startFace;
-        while ((f = f->prevFace(this)) != nullptr)
-            ++nf;
-        return nf + 1;
+        if (firstFaceEdge[i] == i)
+        {
+            edges.faceEdgeToEdge[i] = (uint32_t)edges.edgeToFaceEdge.size();
+            edges.edgeToFaceEdge.push_back((uint32_t)i);
+        }
+        else
+        {
+            edges.faceEdgeToEdge[i] = edges.faceEdgeToEdge[firstFaceEdge[i]];
+        }
     }
 }
 
@@ -171,372 +302,291 @@ inline float loopGamma(uint32_t valence)
     return 1.f / (valence + 3.f / (8.f * beta(valence)));
 }
 
-LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+/**
+ * Compute the next subdivision level.
+ * @param[in] mesh Current level.
+ * @param[in] edges Edge table of the current level.
+ * @param[out] child Next level.
+ */
+void subdivide(const SubdivMesh& mesh, const EdgeTable& edges, SubdivMesh& child)
 {
-    std::vector<SDVertex*> vertices;
-    std::vector<SDFace*> faces;
-
-    // Allocate vertices and faces.
-    std::unique_ptr<SDVertex[]> vertexBuffer = std::make_unique<SDVertex[]>(positions.size());
-    for (size_t i = 0; i < positions.size(); ++i)
-    {
-        vertexBuffer[i] = SDVertex(positions[i]);
-        vertices.push_back(&vertexBuffer[i]);
-    }
-    size_t faceCount = indices.size() / 3;
-    std::unique_ptr<SDFace[]> fs = std::make_unique<SDFace[]>(faceCount);
-    for (size_t i = 0; i < faceCount; ++i)
-    {
-        faces.push_back(&fs[i]);
-    }
-
-    // Set face to vertex pointers.
-    {
-        const uint32_t* vp = indices.data();
-        for (size_t i = 0; i < faceCount; ++i, vp += 3)
-        {
-            SDFace* f = faces[i];
-            for (uint32_t j = 0; j < 3; ++j)
-            {
-                SDVertex* v = vertices[vp[j]];
-                f->v[j] = v;
-                v->startFace = f;
-            }
-        }
-    }
-
-    // Set neighbor pointers in faces.
-    std::set<SDEdge> edges;
-    for (size_t i = 0; i < faceCount; ++i)
-    {
-        SDFace* f = faces[i];
-        for (uint32_t edgeNum = 0; edgeNum < 3; ++edgeNum)
-        {
-            // Update neighbor pointer for edgeNum.
-            int v0 = edgeNum, v1 = NEXT(edgeNum);
-            SDEdge e(f->v[v0], f->v[v1]);
-            if (edges.find(e) == edges.end())
-            {
-                // Handle new edge.
-                e.f[0] = f;
-                e.f0edgeNum = edgeNum;
-                edges.insert(e);
-            }
-            else
-            {
-                // Handle previously seen edge.
-                e = *edges.find(e);
-                e.f[0]->f[e.f0edgeNum] = f;
-                f->f[edgeNum] = e.f[0];
-                edges.erase(e);
-            }
-        }
-    }
-
-    // Finish vertex initialization.
-    for (size_t i = 0; i < positions.size(); ++i)
-    {
-        SDVertex* v = vertices[i];
-        SDFace* f = v->startFace;
-        do
-        {
-            f = f->nextFace(v);
-        } while ((f != nullptr) && f != v->startFace);
-        v->boundary = (f == nullptr);
-        if (!v->boundary && v->valence() == 6)
-            v->regular = true;
-        else if (v->boundary && v->valence() == 4)
-            v->regular = true;
-        else
-            v->regular = false;
-    }
-
-    // Refine LoopSubdiv into triangles.
-    std::vector<SDFace*> f = faces;
-    std::vector<SDVertex*> v = vertices;
-
-    std::pmr::monotonic_buffer_resource buffer;
-    std::pmr::polymorphic_allocator<SDVertex> vertexAllocator(&buffer);
-    std::pmr::polymorphic_allocator<SDFace> faceAllocator(&buffer);
-
-    for (size_t i = 0; i < levels; ++i)
-    {
-        // Update f and v for next level of subdivision.
-        std::vector<SDFace*> newFaces;
-        std::vector<SDVertex*> newVertices;
-
-        // Allocate next level of children in mesh tree.
-        for (SDVertex* vertex : v)
+    const uint32_t vertexCount = mesh.getVertexCount();
+    const uint32_t faceCount = mesh.getFaceCount();
+    const uint32_t edgeCount = (uint32_t)edges.edgeToFaceEdge.size();
+
+    // Even vertices are stored first (same order as the parent vertices), followed by the odd (edge) vertices.
+    // Every face is split into 4 child faces.
+    child.resize(vertexCount + edgeCount, 4 * faceCount);
+
+    // Update vertex positions for even vertices.
+    Threading::parallelFor(
+        0,
+        vertexCount,
+        [&](size_t i)
         {
-            vertex->child = vertexAllocator.allocate(1);
-            vertex->child->regular = vertex->regular;
-            vertex->child->boundary = vertex->boundary;
-            newVertices.push_back(vertex->child);
-        }
-        for (SDFace* face : f)
-        {
-            for (uint32_t k = 0; k < 4; ++k)
-            {
-                face->children[k] = faceAllocator.allocate(1);
-                newFaces.push_back(face->children[k]);
-            }
-        }
+            uint32_t v = (uint32_t)i;
+            child.boundary[v] = mesh.boundary[v];
+            child.regular[v] = mesh.regular[v];
 
-        // Update vertex positions and create new edge vertices.
+            uint32_t startFace = mesh.startFaces[v];
+            child.startFaces[v] = startFace != kInvalidIndex ? 4 * startFace + mesh.vnum(startFace, v) : kInvalidIndex;
 
-        // Update vertex positions for even vertices.
-        for (SDVertex* vertex : v)
-        {
-            if (!vertex->boundary)
+            if (!mesh.boundary[v])
             {
                 // Apply one-ring rule for even vertex.
-                if (vertex->regular)
-                    vertex->child->p = weightOneRing(vertex, 1.f / 16.f);
+                if (mesh.regular[v])
+                    child.positions[v] = mesh.weightOneRing(v, 1.f / 16.f);
                 else
-                    vertex->child->p = weightOneRing(vertex, beta(vertex->valence()));
+                    child.positions[v] = mesh.weightOneRing(v, beta(mesh.valence(v)));
             }
             else
             {
                 // Apply boundary rule for even vertex.
-                vertex->child->p = weightBoundary(vertex, 1.f / 8.f);
+                child.positions[v] = mesh.weightBoundary(v, 1.f / 8.f);
             }
-        }
-
-        // Compute new odd edge vertices.
-        std::map<SDEdge, SDVertex*> edgeVerts;
-        for (SDFace* face : f)
+        },
+        256
+    );
+
+    // Compute new odd edge vertices.
+    Threading::parallelFor(
+        0,
+        edgeCount,
+        [&](size_t e)
         {
-            for (uint32_t k = 0; k < 3; ++k)
+            const uint32_t faceEdge = edges.edgeToFaceEdge[e];
+            const uint32_t face = faceEdge / 3;
+            const uint32_t k = faceEdge % 3;
+            const uint32_t v0 = mesh.faceVertices[faceEdge];
+            const uint32_t v1 = mesh.faceVertices[3 * face + NEXT(k)];
+            const uint32_t neighbor = mesh.faceNeighbors[faceEdge];
+            const uint32_t v = vertexCount + (uint32_t)e;
+
+            child.regular[v] = true;
+            child.boundary[v] = neighbor == kInvalidIndex;
+            child.startFaces[v] = 4 * face + 3;
+
+            // Apply edge rules to compute new vertex position.
+            float3 p;
+            if (child.boundary[v])
             {
-                // Compute odd vertex on kth edge.
-                SDEdge edge(face->v[k], face->v[NEXT(k)]);
-                SDVertex* vert = edgeVerts[edge];
-                if (vert == nullptr)
-                {
-                    // Create and initialize new odd vertex
-                    vert = vertexAllocator.allocate(1);
-                    newVertices.push_back(vert);
-                    vert->regular = true;
-                    vert->boundary = (face->f[k] == nullptr);
-                    vert->startFace = face->children[3];
-
-                    // Apply edge rules to compute new vertex position
-                    if (vert->boundary)
-                    {
-                        vert->p = 0.5f * edge.v[0]->p;
-                        vert->p += 0.5f * edge.v[1]->p;
-                    }
-                    else
-                    {
-                        vert->p = 3.f / 8.f * edge.v[0]->p;
-                        vert->p += 3.f / 8.f * edge.v[1]->p;
-                        vert->p += 1.f / 8.f * face->otherVert(edge.v[0], edge.v[1])->p;
-                        vert->p += 1.f / 8.f * face->f[k]->otherVert(edge.v[0], edge.v[1])->p;
-                    }
-                    edgeVerts[edge] = vert;
-                }
+                p = 0.5f * mesh.positions[v0];
+                p += 0.5f * mesh.positions[v1];
             }
-        }
-
-        // Update new mesh topology.
-
-        // Update even vertex face pointers.
-        for (SDVertex* vertex : v)
-        {
-            int vertNum = vertex->startFace->vnum(vertex);
-            vertex->child->startFace = vertex->startFace->children[vertNum];
-        }
-
-        // Update face neighbor pointers.
-        for (SDFace* face : f)
-        {
-            for (uint32_t j = 0; j < 3; ++j)
+            else
             {
-                // Update children f pointers for siblings.
-                face->children[3]->f[j] = face->children[NEXT(j)];
-                face->children[j]->f[NEXT(j)] = face->children[3];
-
-                // Update children f pointers for neighbor children.
-                SDFace* f2 = face->f[j];
-                face->children[j]->f[j] = f2 != nullptr ? f2->children[f2->vnum(face->v[j])] : nullptr;
-                f2 = face->f[PREV(j)];
-                face->children[j]->f[PREV(j)] = f2 != nullptr ? f2->children[f2->vnum(face->v[j])] : nullptr;
+                p = 3.f / 8.f * mesh.positions[v0];
+                p += 3.f / 8.f * mesh.positions[v1];
+                p += 1.f / 8.f * mesh.positions[mesh.otherVert(face, v0, v1)];
+                p += 1.f / 8.f * mesh.positions[mesh.otherVert(neighbor, v0, v1)];
             }
-        }
-
-        // Update face vertex pointers.
-        for (SDFace* face : f)
+            child.positions[v] = p;
+        },
+        256
+    );
+
+    // Update new mesh topology.
+    Threading::parallelFor(
+        0,
+        faceCount,
+        [&](size_t i)
         {
+            const uint32_t face = (uint32_t)i;
+            const uint32_t* fv = &mesh.faceVertices[3 * face];
+            const uint32_t* fn = &mesh.faceNeighbors[3 * face];
+            uint32_t* childVertices = &child.faceVertices[12 * face];
+            uint32_t* childNeighbors = &child.faceNeighbors[12 * face];
+
             for (uint32_t j = 0; j < 3; ++j)
             {
-                // Update child vertex pointer to new even vertex
-                face->children[j]->v[j] = face->v[j]->child;
-
-                // Update child vertex pointer to new odd vertex
-                SDVertex* vert = edgeVerts[SDEdge(face->v[j], face->v[NEXT(j)])];
-                face->children[j]->v[NEXT(j)] = vert;
-                face->children[NEXT(j)]->v[j] = vert;
-                face->children[3]->v[j] = vert;
+                // Update children neighbors for siblings.
+                childNeighbors[3 * 3 + j] = 4 * face + NEXT(j);
+                childNeighbors[3 * j + NEXT(j)] = 4 * face + 3;
+
+                // Update children neighbors for neighbor children.
+                uint32_t f2 = fn[j];
+                childNeighbors[3 * j + j] = f2 != kInvalidIndex ? 4 * f2 + mesh.vnum(f2, fv[j]) : kInvalidIndex;
+                f2 = fn[PREV(j)];
+                childNeighbors[3 * j + PREV(j)] = f2 != kInvalidIndex ? 4 * f2 + mesh.vnum(f2, fv[j]) : kInvalidIndex;
+
+                // Update child vertex to new even vertex.
+                childVertices[3 * j + j] = fv[j];
+
+                // Update child vertices to new odd vertex.
+                uint32_t v = vertexCount + edges.faceEdgeToEdge[3 * face + j];
+                childVertices[3 * j + NEXT(j)] = v;
+                childVertices[3 * NEXT(j) + j] = v;
+                childVertices[3 * 3 + j] = v;
             }
-        }
-
-        // Prepare for next level of subdivision
-        f = newFaces;
-        v = newVertices;
-    }
+        },
+        256
+    );
+}
+} // namespace
 
-    // Push vertices to limit surface.
-    std::vector<float3> pLimit(v.size());
-    for (size_t i = 0; i < v.size(); ++i)
-    {
-        if (v[i]->boundary)
-            pLimit[i] = weightBoundary(v[i], 1.f / 5.f);
-        else
-            pLimit[i] = weightOneRing(v[i], loopGamma(v[i]->valence()));
-    }
-    for (size_t i = 0; i < v.size(); ++i)
+LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+{
+    SubdivMesh mesh;
+    EdgeTable edges;
+
+    const uint32_t vertexCount = (uint32_t)positions.size();
+    const uint32_t faceCount = (uint32_t)(indices.size() / 3);
+    mesh.resize(vertexCount, faceCount);
+    mesh.positions.assign(positions.begin(), positions.end());
+    mesh.faceVertices.assign(indices.begin(), indices.begin() + 3 * (size_t)faceCount);
+
+    // Set vertex to face references.
+    std::fill(mesh.startFaces.begin(), mesh.startFaces.end(), kInvalidIndex);
+    for (uint32_t i = 0; i < 3 * faceCount; ++i)
     {
-        v[i]->p = pLimit[i];
+        FALCOR_CHECK(mesh.faceVertices[i] < vertexCount, "Vertex index {} is out of bounds.", mesh.faceVertices[i]);
+        mesh.startFaces[mesh.faceVertices[i]] = i / 3;
     }
 
-    // Compute vertex tangents on limit surface.
-    std::vector<float3> Ns;
-    Ns.reserve(v.size());
-    std::vector<float3> pRing(16, float3());
-    for (SDVertex* vertex : v)
+    // Set neighbor references in faces. Face edges with the same vertex pair are linked pairwise in face order.
+    buildEdgeTable(mesh, edges);
     {
-        float3 S(0.f);
-        float3 T(0.f);
-        uint32_t valence = vertex->valence();
-        if (valence > pRing.size())
-            pRing.resize(valence);
-        vertex->oneRing(&pRing[0]);
-        if (!vertex->boundary)
-        {
-            // Compute tangents of interior face
-            for (uint32_t j = 0; j < valence; ++j)
-            {
-                S += std::cos(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
-                T += std::sin(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
-            }
-        }
-        else
+        std::fill(mesh.faceNeighbors.begin(), mesh.faceNeighbors.end(), kInvalidIndex);
+        std::vector<uint32_t> openFaceEdge(edges.edgeToFaceEdge.size(), kInvalidIndex);
+        for (uint32_t i = 0; i < 3 * faceCount; ++i)
         {
-            // Compute tangents of boundary face
-            S = pRing[valence - 1] - pRing[0];
-            if (valence == 2)
-            {
-                T = float3(pRing[0] + pRing[1] - 2.f * vertex->p);
-            }
-            else if (valence == 3)
+            uint32_t& other = openFaceEdge[edges.faceEdgeToEdge[i]];
+            if (other == kInvalidIndex)
             {
-                T = pRing[1] - vertex->p;
-            }
-            else if (valence == 4) // regular
-            {
-                T = float3(-1.f * pRing[0] + 2.f * pRing[1] + 2.f * pRing[2] + -1.f * pRing[3] + -2.f * vertex->p);
+                other = i;
             }
             else
             {
-                float theta = float(M_PI) / float(valence - 1);
-                T = float3(std::sin(theta) * (pRing[0] + pRing[valence - 1]));
-                for (uint32_t k = 1; k < valence - 1; ++k)
-                {
-                    float wt = (2 * std::cos(theta) - 2) * std::sin((k)*theta);
-                    T += float3(wt * pRing[k]);
-                }
-                T = -T;
+                mesh.faceNeighbors[other] = i / 3;
+                mesh.faceNeighbors[i] = other / 3;
+                other = kInvalidIndex;
             }
         }
-        Ns.push_back(cross(S, T));
     }
 
-    // Create triangle mesh from subdivision mesh
-    {
-        size_t ntris = f.size();
-        std::vector<uint32_t> verts(3 * ntris);
-        uint32_t* vp = verts.data();
-        uint32_t totVerts = (uint32_t)v.size();
-        std::map<SDVertex*, uint32_t> usedVerts;
-        for (uint32_t i = 0; i < totVerts; ++i)
-        {
-            usedVerts[v[i]] = i;
-        }
-        for (size_t i = 0; i < ntris; ++i)
+    // Finish vertex initialization.
+    Threading::parallelFor(
+        0,
+        vertexCount,
+        [&](size_t i)
         {
-            for (uint32_t j = 0; j < 3; ++j)
+            uint32_t v = (uint32_t)i;
+            uint32_t startFace = mesh.startFaces[v];
+            if (startFace == kInvalidIndex)
             {
-                *vp = usedVerts[f[i]->v[j]];
-                ++vp;
+                // Vertex is not referenced by any face.
+                mesh.boundary[v] = true;
+                mesh.regular[v] = false;
+                return;
             }
-        }
-
-        LoopSubdivideResult result;
-        result.positions = std::move(pLimit);
-        result.normals = std::move(Ns);
-        result.indices = std::move(verts);
-        return result;
-    }
-}
-
-static float3 weightOneRing(SDVertex* vert, float beta)
-{
-    // Put vert one-ring in pRing.
-    uint32_t valence = vert->valence();
-    FALCOR_ASSERT(valence < 16);
-    float3 pRing[16];
-
-    vert->oneRing(pRing);
-    float3 p = (1 - valence * beta) * vert->p;
-    for (uint32_t i = 0; i < valence; ++i)
+            uint32_t f = startFace;
+            do
+            {
+                f = mesh.nextFace(f, v);
+            } while (f != kInvalidIndex && f != startFace);
+            mesh.boundary[v] = f == kInvalidIndex;
+            uint32_t valence = mesh.valence(v);
+            mesh.regular[v] = mesh.boundary[v] ? valence == 4 : valence == 6;
+        },
+        256
+    );
+
+    // Refine into triangles. Every level has 4x the faces and (vertices + edges) vertices of the previous level.
+    // The two meshes are swapped after each level to reuse their allocations.
+    SubdivMesh childMesh;
+    for (uint32_t level = 0; level < levels; ++level)
     {
-        p += beta * pRing[i];
+        if (level > 0)
+            buildEdgeTable(mesh, edges);
+        subdivide(mesh, edges, childMesh);
+        std::swap(mesh, childMesh);
     }
-    return p;
-}
 
-void SDVertex::oneRing(float3* p_)
-{
-    if (!boundary)
-    {
-        // Get one-ring vertices for interior vertex.
-        SDFace* face = startFace;
-        do
-        {
-            *p_++ = face->nextVert(this)->p;
-            face = face->nextFace(this);
-        } while (face != startFace);
-    }
-    else
-    {
-        // Get one-ring vertices for boundary vertex.
-        SDFace* face = startFace;
-        SDFace* f2;
-        while ((f2 = face->nextFace(this)) != nullptr)
-        {
-            face = f2;
-        }
-        *p_++ = face->nextVert(this)->p;
-        do
+    // Push vertices to limit surface.
+    const uint32_t finalVertexCount = mesh.getVertexCount();
+    std::vector<float3> pLimit(finalVertexCount);
+    Threading::parallelFor(
+        0,
+        finalVertexCount,
+        [&](size_t i)
         {
-            *p_++ = face->prevVert(this)->p;
-            face = face->prevFace(this);
-        } while (face != nullptr);
-    }
-}
+            uint32_t v = (uint32_t)i;
+            if (mesh.boundary[v])
+                pLimit[v] = mesh.weightBoundary(v, 1.f / 5.f);
+            else
+                pLimit[v] = mesh.weightOneRing(v, loopGamma(mesh.valence(v)));
+        },
+        256
+    );
+    mesh.positions.swap(pLimit);
 
-static float3 weightBoundary(SDVertex* vert, float beta)
-{
-    // Put vert one-ring in pRing.
-    uint32_t valence = vert->valence();
-    FALCOR_ASSERT(valence < 16);
-    float3 pRing[16];
-
-    vert->oneRing(pRing);
-    float3 p = (1 - 2 * beta) * vert->p;
-    p += beta * pRing[0];
-    p += beta * pRing[valence - 1];
-    return p;
+    // Compute vertex tangents on limit surface.
+    std::vector<float3> Ns(finalVertexCount);
+    Threading::parallelFor(
+        0,
+        finalVertexCount,
+        [&](size_t i)
+        {
+            uint32_t v = (uint32_t)i;
+            const float3& p = mesh.positions[v];
+            Ns[v] = mesh.withOneRing(
+                v,
+                [&](uint32_t valence, const float3* pRing)
+                {
+                    float3 S(0.f);
+                    float3 T(0.f);
+                    if (valence == 0)
+                        return float3(0.f);
+                    if (!mesh.boundary[v])
+                    {
+                        // Compute tangents of interior face
+                        for (uint32_t j = 0; j < valence; ++j)
+                        {
+                            S += std::cos(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
+                            T += std::sin(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
+                        }
+                    }
+                    else
+                    {
+                        // Compute tangents of boundary face
+                        S = pRing[valence - 1] - pRing[0];
+                        if (valence == 2)
+                        {
+                            T = float3(pRing[0] + pRing[1] - 2.f * p);
+                        }
+                        else if (valence == 3)
+                        {
+                            T = pRing[1] - p;
+                        }
+                        else if (valence == 4) // regular
+                        {
+                            T = float3(-1.f * pRing[0] + 2.f * pRing[1] + 2.f * pRing[2] + -1.f * pRing[3] + -2.f * p);
+                        }
+                        else
+                        {
+                            float theta = float(M_PI) / float(valence - 1);
+                            T = float3(std::sin(theta) * (pRing[0] + pRing[valence - 1]));
+                            for (uint32_t k = 1; k < valence - 1; ++k)
+                            {
+                                float wt = (2 * std::cos(theta) - 2) * std::sin((k)*theta);
+                                T += float3(wt * pRing[k]);
+                            }
+                            T = -T;
+                        }
+                    }
+                    return cross(S, T);
+                }
+            );
+        },
+        256
+    );
+
+    // Create triangle mesh from subdivision mesh.
+    LoopSubdivideResult result;
+    result.positions = std::move(mesh.positions);
+    result.normals = std::move(Ns);
+    result.indices = std::move(mesh.faceVertices);
+    return result;
 }
 
 } // namespace Falcor::pbrt
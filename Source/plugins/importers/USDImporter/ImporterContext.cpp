@@ -38,8 +38,7 @@
 #include "USDUtils/USDScene1Utils.h"
 #include "USDUtils/Tessellator/Tessellation.h"
 #include "Utils/Settings/Settings.h"
-
-#include <tbb/parallel_for.h>
+#include "Utils/Threading.h"
 
 BEGIN_DISABLE_USD_WARNINGS
 #include <pxr/usd/usd/primRange.h>
@@ -82,6 +81,8 @@ namespace Falcor
         uint32_t kCurveKeepOneEveryXStrands = 1;
         // Skip some hair vertices, if necessary for memory/perf reasons.
         uint32_t kCurveKeepOneEveryXVerticesPerStrand = 1;
+        // Maximum deviation of the tessellation from the curve relative to its radius. If positive, the number of sub-segments is chosen per strand.
+        float kCurveAdaptiveMaxError = 0.f;
 
         // Default curve material parameters.
         const float kDefaultCurveIOR = 1.55f;
@@ -660,6 +661,7 @@ namespace Falcor
             uint32_t subdivPerSegment                = ctx.builder.getSettings().getAttribute(curveName, "curves:subdivPerSegment", kCurveSubdivPerSegment);
             uint32_t keepOneEveryXStrands            = ctx.builder.getSettings().getAttribute(curveName, "curves:keepOneEveryXStrands", kCurveKeepOneEveryXStrands);
             uint32_t keepOneEveryXVerticesPerStrand  = ctx.builder.getSettings().getAttribute(curveName, "curves:keepOneEveryXVerticesPerStrand", kCurveKeepOneEveryXVerticesPerStrand);
+            float adaptiveMaxError                   = ctx.builder.getSettings().getAttribute(curveName, "curves:adaptiveMaxError", kCurveAdaptiveMaxError);
 
             // Perceptually, it is a good practice to increase width of hair strands if we render less of them than anticipated.
             float widthScale = std::sqrt((float)keepOneEveryXStrands);
@@ -667,7 +669,7 @@ namespace Falcor
             // Convert to linear swept sphere segments.
             CurveTessellation::SweptSphereResult result = CurveTessellation::convertToLinearSweptSphere(strandCount, reinterpret_cast<const uint32_t*>(usdCurveVertexCounts.data()),
                 (float3*)usdPoints.data(), usdCurveWidths.data(), pUsdUVs, 1,
-                subdivPerSegment, keepOneEveryXStrands, keepOneEveryXVerticesPerStrand, widthScale, float4x4::identity());
+                subdivPerSegment, keepOneEveryXStrands, keepOneEveryXVerticesPerStrand, widthScale, float4x4::identity(), adaptiveMaxError);
 
             // Copy data.
             geomOut.id = curveName;
@@ -715,6 +717,7 @@ namespace Falcor
             uint32_t subdivPerSegment                = ctx.builder.getSettings().getAttribute(curveName, "curves:subdivPerSegment", kCurveSubdivPerSegment);
             uint32_t keepOneEveryXStrands            = ctx.builder.getSettings().getAttribute(curveName, "curves:keepOneEveryXStrands", kCurveKeepOneEveryXStrands);
             uint32_t keepOneEveryXVerticesPerStrand  = ctx.builder.getSettings().getAttribute(curveName, "curves:keepOneEveryXVerticesPerStrand", kCurveKeepOneEveryXVerticesPerStrand);
+            float adaptiveMaxError                   = ctx.builder.getSettings().getAttribute(curveName, "curves:adaptiveMaxError", kCurveAdaptiveMaxError);
 
             // Perceptually, it is a good practice to increase width of hair strands if we render less of them than anticipated.
             float widthScale = std::sqrt((float)keepOneEveryXStrands);
@@ -724,7 +727,7 @@ namespace Falcor
 
             if (tessellationMode == CurveTessellationMode::PolyTube)
             {
-                result = CurveTessellation::convertToPolytube(strandCount, reinterpret_cast<const uint32_t*>(usdCurveVertexCounts.data()), (float3*)usdPoints.data(), usdCurveWidths.data(), pUsdUVs, subdivPerSegment, keepOneEveryXStrands, keepOneEveryXVerticesPerStrand, widthScale, 4);
+                result = CurveTessellation::convertToPolytube(strandCount, reinterpret_cast<const uint32_t*>(usdCurveVertexCounts.data()), (float3*)usdPoints.data(), usdCurveWidths.data(), pUsdUVs, subdivPerSegment, keepOneEveryXStrands, keepOneEveryXVerticesPerStrand, widthScale, 4, adaptiveMaxError);
             }
             else
             {
@@ -1086,12 +1089,12 @@ namespace Falcor
         void addMeshesToSceneBuilder(ImporterContext& ctx, TimeReport& timeReport)
         {
             // Process collected mesh tasks.
-            tbb::parallel_for<size_t>(0, ctx.meshTasks.size(),
+            Threading::parallelFor(0, ctx.meshTasks.size(),
                 [&](size_t i)
                 {
                     FALCOR_ASSERT(ctx.meshTasks[i].sampleIdx == 0);
                     processMesh(ctx.meshes[ctx.meshTasks[i].meshId], ctx);
-                }
+                }, 1
             );
 
             // Add processed meshes to scene builder.
@@ -1121,12 +1124,12 @@ namespace Falcor
                 }
 
                 // Process time-sampled mesh keyframes
-                tbb::parallel_for<size_t>(0, ctx.meshKeyframeTasks.size(),
+                Threading::parallelFor(0, ctx.meshKeyframeTasks.size(),
                     [&](size_t i)
                     {
                         auto& task = ctx.meshKeyframeTasks[i];
                         processMeshKeyframe(ctx.meshes[task.meshId], task.meshId, task.sampleIdx, ctx);
-                    }
+                    }, 1
                 );
 
                 for (auto& m : ctx.meshes)
@@ -1263,8 +1266,8 @@ namespace Falcor
         void addCurvesToSceneBuilder(ImporterContext& ctx, TimeReport& timeReport)
         {
             // Process collected curves.
-            tbb::parallel_for<size_t>(0, ctx.curves.size(),
-                [&](size_t i) { processCurve(ctx.curves[i], ctx); }
+            Threading::parallelFor(0, ctx.curves.size(),
+                [&](size_t i) { processCurve(ctx.curves[i], ctx); }, 1
             );
 
             // Add processed curves or meshes (of the first keyframe) to scene builder.
@@ -1748,11 +1751,9 @@ namespace Falcor
                 break;
             }
 
-            tbb::parallel_for<size_t>(0, indexData.size(),
-                [&](size_t j)
-                {
-                    isSameTopology |= (indexData[j] == refIndexData[j]);
-                }
+            isSameTopology = Threading::parallelReduce(0, indexData.size(), true,
+                [&](size_t j) { return indexData[j] == refIndexData[j]; },
+                [](bool a, bool b) { return a && b; }
             );
             if (!isSameTopology) break;
         }
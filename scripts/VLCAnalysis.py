@@ -196,6 +196,12 @@ Output Files:
 - Visual rendering appears in the main viewport
 - Console output provides detailed statistics and debugging info
 
+In-Process Access (no CSV round trip):
+- pt = m.activeGraph.getPass("PathTracer")
+- cir = pt.pixelStats.getCIRRawData()  # zero-copy structured NumPy array, fields match CIRPathData
+- delays = cir["pathLength"] / 299792458.0
+- Arrays stay valid after later frames; new data is written to a new buffer while a view is alive
+
 Parameter Tuning:
 - Adjust 'timeResolution' for temporal precision vs. memory usage
 - Modify 'maxDelay' based on your scene size
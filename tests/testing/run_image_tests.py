@@ -271,40 +271,63 @@ class Test:
         image_reports = []
 
         # Compare every result image with the corresponding reference image and report missing references.
-        processes = {}
+        # All pairs are compared by a single ImageCompare process in batch mode.
+        manifest = []
         for image in result_images:
             if not image in ref_images:
                 result = Test.Result.FAILED
                 messages.append(f'Test has generated image "{image}" with no corresponding reference image.')
                 continue
 
-            ref_file = ref_dir / image
-            result_file = result_dir / image
-            error_file = result_dir / (str(image) + config.ERROR_IMAGE_SUFFIX)
-
-            args = [str(image_compare_exe), '-m', 'mse', '-t', str(self.tolerance), str(ref_file), str(result_file)]
-            if error_file:
-                args += ['-e', str(error_file)]
-            processes[image] = subprocess.Popen(args, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
-            if not self.process_controller.add_process(self.name + ":image:" + str(image), processes[image]):
-                return Test.Result.FAILED, ['Process killed due to global exit']
-
-        for image, process in processes.items():
+            manifest.append({
+                'image1': str((ref_dir / image).resolve()),
+                'image2': str((result_dir / image).resolve()),
+                'heatmap': str((result_dir / (str(image) + config.ERROR_IMAGE_SUFFIX)).resolve()),
+                'threshold': self.tolerance
+            })
 
-            output = process.communicate()[0]
-            compare_success =  process.returncode == 0
-            compare_error = float(output.strip())
+        if len(manifest) > 0:
+            manifest_file = result_dir / 'image_compare_manifest.json'
+            summary_file = result_dir / 'image_compare_summary.json'
+            with open(manifest_file, 'w') as f:
+                json.dump(manifest, f, indent=4)
 
-            if not compare_success:
-                result = Test.Result.FAILED
-                messages.append(f'Test image "{image}" failed with error {compare_error}.')
+            # Tests run concurrently, so each ImageCompare process only gets its share of the cores.
+            image_compare_threads = max(1, (os.cpu_count() or 1) // self.process_controller.thread_count)
 
-            image_reports.append({
-                'name': str(image),
-                'success': compare_success,
-                'error': compare_error,
-                'tolerance': self.tolerance
-            })
+            try:
+                args = [str(image_compare_exe), '-m', 'mse', '-t', str(self.tolerance), '-j', str(image_compare_threads), '--batch', str(manifest_file), '-o', str(summary_file)]
+                process = subprocess.Popen(args, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+                if not self.process_controller.add_process(self.name + ":images", process):
+                    return Test.Result.FAILED, ['Process killed due to global exit'], []
+                output = process.communicate()[0]
+
+                if not summary_file.exists():
+                    return Test.Result.FAILED, messages + [f'ImageCompare failed: {output.decode("utf-8").strip()}'], []
+                with open(summary_file) as f:
+                    summary = json.load(f)
+            finally:
+                manifest_file.unlink(missing_ok=True)
+                summary_file.unlink(missing_ok=True)
+
+            for entry in summary['results']:
+                image = Path(entry['image2']).relative_to(result_dir.resolve())
+                compare_success = entry['success']
+                compare_error = entry['error'] if entry['error'] is not None else float('nan')
+
+                if not compare_success:
+                    result = Test.Result.FAILED
+                    if entry['error'] is None:
+                        messages.append(f'Test image "{image}" failed: {entry.get("message", "unknown error")}')
+                    else:
+                        messages.append(f'Test image "{image}" failed with error {compare_error}.')
+
+                image_reports.append({
+                    'name': str(image),
+                    'success': compare_success,
+                    'error': compare_error,
+                    'tolerance': self.tolerance
+                })
 
         # Report missing result images for existing reference images.
         for image in ref_images: